@@ -28,6 +28,7 @@
 
 	#include "cinder/Capture.h"
 	#include "cinder/Surface.h"
+	#include "cinder/SurfacePool.h"
 
 	#include <gst/gst.h>
 	#include <gst/app/gstappsink.h>
@@ -119,8 +120,6 @@ class CaptureImplGStreamer {
 	};
 
   private:
-	class SurfaceCache;
-
 	// Initialize pipeline based on device capabilities and target dimensions
 	bool initializePipeline( int32_t width, int32_t height );
 
@@ -151,7 +150,7 @@ class CaptureImplGStreamer {
 
 	// Thread synchronization
 	mutable std::mutex			  mMutex;
-	std::unique_ptr<SurfaceCache> mSurfaceCache;
+	SurfacePoolRef				  mSurfacePool;
 	mutable Surface8uRef		  mCurrentFrame;
 	mutable bool				  mHasNewFrame;
 
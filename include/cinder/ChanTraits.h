@@ -99,6 +99,16 @@ struct CI_API CHANTRAIT<half_float>
 	static float inverse( float c ) { return 1.0f - c; }
 };
 
+//! Returns \a v as a CHANTRAIT<T>::Sum. half_float has no arithmetic of its own, so it is summed as float.
+template<typename T>
+typename CHANTRAIT<T>::Sum toChanSum( T v ) { return static_cast<typename CHANTRAIT<T>::Sum>( v ); }
+inline float toChanSum( half_float v ) { return halfToFloat( v ); }
+//! Returns a CHANTRAIT<T>::Sum \a v as a \a T
+template<typename T>
+T fromChanSum( typename CHANTRAIT<T>::Sum v ) { return static_cast<T>( v ); }
+template<>
+inline half_float fromChanSum<half_float>( float v ) { return floatToHalf( v ); }
+
 // Instantiated for ChannelT and SurfaceT
 #define CHANNEL_TYPES (uint8_t)(float)
 
@@ -295,5 +295,8 @@ typedef std::shared_ptr<Channel16u>	Channel16uRef;
 //! 32-bit floating point image channel
 typedef ChannelT<float>				Channel32f;
 typedef std::shared_ptr<Channel32f>	Channel32fRef;
+//! 16-bit floating point image channel. Like Channel16u, primarily a storage format for ImageIo.
+typedef ChannelT<half_float>		Channel16f;
+typedef std::shared_ptr<Channel16f>	Channel16fRef;
 
 } // namespace cinder
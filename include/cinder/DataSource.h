@@ -38,6 +38,8 @@ class CI_API DataSource {
   public:
 	virtual bool	isFilePath() = 0;
 	virtual bool	isUrl() = 0;
+	//! Returns whether getBuffer() and createStream() view a memory mapping of the file, in which case loaders should prefer them to reading getFilePath() themselves
+	virtual bool	isMapped() { return false; }
 	
 	const fs::path&		getFilePath();
 	const Url&			getUrl();
@@ -83,6 +85,34 @@ class CI_API DataSourcePath : public DataSource {
 };
 
 
+typedef std::shared_ptr<class DataSourceMapped>	DataSourceMappedRef;
+
+//! A DataSource for a file which is memory mapped rather than read. getBuffer() and every stream returned by createStream() view the same mapping, without copying the file.
+//! The mapping is read-only, so code that needs to modify the Buffer returned by getBuffer() must copy it first.
+class CI_API DataSourceMapped : public DataSource {
+  public:
+	//! The file is mapped on the first call to getBuffer() or createStream(), which throw StreamExc if it can't be mapped.
+	static DataSourceMappedRef	create( const fs::path &path, MappedFile::Access access = MappedFile::ACCESS_SEQUENTIAL );
+
+	virtual bool	isFilePath() { return true; }
+	virtual bool	isUrl() { return false; }
+	virtual bool	isMapped() { return true; }
+
+	virtual IStreamRef	createStream();
+
+	//! Returns the mapping of the file, mapping it first if necessary
+	const MappedFileRef&	getMappedFile();
+
+  protected:
+	DataSourceMapped( const fs::path &path, MappedFile::Access access );
+
+	virtual	void	createBuffer();
+
+	MappedFile::Access	mAccess;
+	MappedFileRef		mMappedFile;
+};
+
+
 #if defined( CINDER_ANDROID )
 typedef std::shared_ptr<class DataSourceAndroidAsset>	DataSourceAndroidAssetRef;
 
@@ -107,6 +137,10 @@ class DataSourceAndroidAsset : public DataSource {
 
 
 CI_API DataSourceRef loadFile( const fs::path &path );
+//! Returns a DataSourceMapped for the file at \a path, whose contents are viewed through a memory mapping instead of being read and copied
+CI_API DataSourceRef loadFileMapped( const fs::path &path, MappedFile::Access access = MappedFile::ACCESS_SEQUENTIAL );
+//! Returns the contents of \a dataSource, viewed through a memory mapping when it is a file which isn't mapped already
+CI_API std::shared_ptr<const Buffer> loadBufferMapped( const DataSourceRef &dataSource, MappedFile::Access access = MappedFile::ACCESS_SEQUENTIAL );
 
 typedef std::shared_ptr<class DataSourceUrl>	DataSourceUrlRef;
 
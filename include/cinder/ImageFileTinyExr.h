@@ -37,24 +37,76 @@ typedef std::shared_ptr<class ImageTargetFileTinyExr> ImageTargetFileTinyExrRef;
 
 typedef std::shared_ptr<class ImageSourceFileTinyExr>	ImageSourceFileTinyExrRef;
 
+/*! Reads scanline and tiled single-part EXR files, on as many threads as ImageSource::Options::threads() allows. Only the chunks of a scanline
+	file covering the rows of ImageSource::Options::area() are decoded, tiled files are decoded whole. Half and float samples are decoded straight into FLOAT16 and FLOAT32 targets such as Surface16f and Surface32f. */
 class ImageSourceFileTinyExr : public ImageSource {
   public:
+	//! Selects which channels of a file are read
+	class Format {
+	  public:
+		Format() {}
+
+		//! Reads the channels of \a layer, which are named "<layer>.R", "<layer>.G" and so on. Default is the unnamed layer, whose channels are named "R", "G", "B", "A" or "Y".
+		Format&		layer( const std::string &layer ) { mLayer = layer; return *this; }
+		//! Reads the channels named \a names instead, as Y, YA, RGB or RGBA according to their count. Overrides layer().
+		Format&		channels( const std::vector<std::string> &names ) { mChannels = names; return *this; }
+
+		const std::string&				getLayer() const { return mLayer; }
+		const std::vector<std::string>&	getChannels() const { return mChannels; }
+
+	  private:
+		std::string					mLayer;
+		std::vector<std::string>	mChannels;
+	};
+
 	static ImageSourceRef create( DataSourceRef dataSource, ImageSource::Options options = ImageSource::Options() );
+	static ImageSourceRef create( DataSourceRef dataSource, ImageSource::Options options, const Format &format );
 
 	void load( ImageTargetRef target ) override;
 
+	//! Returns the names of every channel in the file, of which up to four are read
+	const std::vector<std::string>&	getChannelNames() const { return mChannelNames; }
+
 	static void		registerSelf();
 
 protected:
-	ImageSourceFileTinyExr( DataSourceRef dataSourceRef, ImageSource::Options options );
+	ImageSourceFileTinyExr( DataSourceRef dataSourceRef, ImageSource::Options options, const Format &format );
+
+	void	selectChannels( const Format &format );
 
+	BufferRef                                                     mBuffer;
 	std::unique_ptr<EXRHeader, std::function<int( EXRHeader * )>> mExrHeader; // We're using the provided FreeEXRHeader function as a custom deleter
-	std::unique_ptr<EXRImage, std::function<int( EXRImage * )>>   mExrImage;  // We're using the provided FreeEXRImage function as a custom deleter
+	std::vector<std::string>                                      mChannelNames;
+	std::vector<int>                                              mFilePixelTypes;
+	std::vector<int>                                              mSelectedChannels; // indices into the file's channels, in the order of mChannelOrder
+	int                                                           mThreads;
 };
 
 class ImageTargetFileTinyExr : public ImageTarget {
   public:
+	enum Compression { COMPRESSION_NONE, COMPRESSION_RLE, COMPRESSION_ZIPS, COMPRESSION_ZIP, COMPRESSION_PIZ };
+
+	//! Options specific to writing EXR files
+	class Format {
+	  public:
+		Format() : mCompression( COMPRESSION_ZIP ), mHalfFloat( true ) {}
+
+		//! Sets the compression applied to each chunk of scanlines. Default is \c COMPRESSION_ZIP.
+		Format&		compression( Compression compression ) { mCompression = compression; return *this; }
+		//! Sets whether samples are stored as 16-bit half floats rather than 32-bit floats. Default is \c true.
+		Format&		halfFloat( bool halfFloat = true ) { mHalfFloat = halfFloat; return *this; }
+
+		Compression	getCompression() const { return mCompression; }
+		bool		isHalfFloat() const { return mHalfFloat; }
+
+	  private:
+		Compression	mCompression;
+		bool		mHalfFloat;
+	};
+
 	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
+	//! Creates a target which writes with \a format, compressing chunks on as many threads as ImageTarget::Options::threads() allows
+	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const Format &format );
 
 	void*	getRowPointer( int32_t row ) override;
 	void	finalize() override;
@@ -62,12 +114,16 @@ class ImageTargetFileTinyExr : public ImageTarget {
 	static void		registerSelf();
 	
   protected:
-	ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
+	ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const Format &format );
 
 	uint8_t                  mNumComponents;
+	size_t                   mSampleBytes;
+	DataTargetRef            mDataTarget;
 	fs::path                 mFilePath;
-	std::vector<float>       mData;
+	std::vector<uint8_t>     mData;
 	std::vector<std::string> mChannelNames;
+	Format                   mFormat;
+	int                      mThreads;
 };
 
 class ImageIoExceptionFailedLoadTinyExr : public ImageIoExceptionFailedLoad {
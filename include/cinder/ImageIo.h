@@ -33,6 +33,7 @@
 
 #include <vector>
 #include <map>
+#include <functional>
 #include <utility>
 
 namespace cinder {
@@ -85,27 +86,47 @@ class CI_API ImageIo {
 
 class CI_API ImageSource : public ImageIo {
   public:
-	ImageSource() : ImageIo(), mIsPremultiplied( false ), mPixelAspectRatio( 1 ), mCustomPixelInc( 0 ), mFrameCount( 1 ) {}
+	ImageSource() : ImageIo(), mIsPremultiplied( false ), mPixelAspectRatio( 1 ), mCustomPixelInc( 0 ), mFrameCount( 1 ), mRegionApplied( false ) {}
 	virtual ~ImageSource() {}  
 
 	//! Optional parameters passed when creating an Image. \see loadImage()
 	class Options {
 	  public:
-		Options() : mIndex( 0 ), mThrowOnFirstException( false ) {}
+		Options() : mIndex( 0 ), mThrowOnFirstException( false ), mHasArea( false ), mDownscale( 1 ), mThreads( 1 ) {}
 
 		//! Specifies an image index for multi-part images, like animated GIFs. 0-based index.
 		Options& index( int32_t index )						{ mIndex = index; return *this; }
 		//! If an exception occurs, enabling this will prevent any attempts at using other handlers to load the image. Default = false, all handlers are tried and if none succeed, the last exception is rethrown. \see ImageIoException
 		Options& throwOnFirstException( bool b = true )		{ mThrowOnFirstException = b; return *this; }
+		//! Restricts the image to \a area, in pixels of the full image. Decoders which support it skip the data outside \a area, others crop rows as they stream. Default is the whole image.
+		Options& area( const Area &area )					{ mArea = area; mHasArea = true; return *this; }
+		//! Reduces the image by \a factor in each dimension, averaging blocks of \a factor x \a factor pixels. Typically a power of two. Default is \c 1.
+		Options& downscale( int32_t factor )				{ mDownscale = ( factor > 1 ) ? factor : 1; return *this; }
+		//! Sets the number of threads decoders which support it may use for a single image. A value of \c 0 uses one thread per hardware thread. Default is \c 1.
+		Options& threads( int numThreads )					{ mThreads = numThreads; return *this; }
 
 		//! Returns image index. \see index()
 		int32_t				getIndex() const				{ return mIndex; }
 		//! Returns whether throwOnFirstException() is enabled or not.
 		bool				getThrowOnFirstException()		{ return mThrowOnFirstException; }
+		//! Returns whether area() has been set.
+		bool				hasArea() const					{ return mHasArea; }
+		//! Returns the area set by area(). Undefined unless hasArea().
+		const Area&			getArea() const					{ return mArea; }
+		//! Returns the downscale factor. \see downscale()
+		int32_t				getDownscale() const			{ return mDownscale; }
+		//! Returns whether area() or downscale() request anything other than the whole image at full resolution.
+		bool				hasRegion() const				{ return mHasArea || mDownscale > 1; }
+		//! Returns the number of threads requested. A value of \c 0 implies one thread per hardware thread.
+		int					getThreads() const				{ return mThreads; }
 		
 	  protected:
 		int32_t			mIndex;
 		bool			mThrowOnFirstException;
+		Area			mArea;
+		bool			mHasArea;
+		int32_t			mDownscale;
+		int				mThreads;
 	};
 
 	//! Returns the aspect ratio of individual pixels to accommodate non-square pixels
@@ -119,9 +140,47 @@ class CI_API ImageSource : public ImageIo {
 
 	virtual void	load( ImageTargetRef target ) = 0;
 
+	//! Returns whether the ImageSource already reflects Options::area() and Options::downscale(). loadImage() applies them to those which do not.
+	bool		isRegionApplied() const { return mRegionApplied; }
+
 	typedef void (ImageSource::*RowFunc)(ImageTargetRef, int32_t, const void*);
 
   protected:
+	//! Reduces the rows of a full image to the area and downscale factor requested by Options, one row at a time, by averaging blocks of pixels
+	class CI_API RowReducer {
+	  public:
+		RowReducer() : mDataType( DATA_UNKNOWN ), mPixelInc( 0 ), mFactor( 1 ), mWidth( 0 ), mHeight( 0 ), mIdentity( true ), mBlockRows( 0 ) {}
+		//! \a pixelInc is the number of samples per pixel of the rows passed to addRow(). Throws ImageIoExceptionFailedLoad if the area does not intersect the image.
+		RowReducer( int32_t fullWidth, int32_t fullHeight, const Options &options, DataType dataType, int pixelInc );
+
+		//! Returns whether rows pass through unchanged
+		bool			isIdentity() const { return mIdentity; }
+		//! Returns the area of the full image which contributes to the reduced image
+		const Area&		getArea() const { return mArea; }
+		int32_t			getWidth() const { return mWidth; }
+		int32_t			getHeight() const { return mHeight; }
+
+		//! Accumulates row \a sourceRow of the full image, whose pixels start at column \c 0, calling \a emit( row, data ) for each reduced row it completes. Rows must arrive in order; rows outside getArea() are ignored.
+		void			addRow( int32_t sourceRow, const void *data, const std::function<void( int32_t, const void* )> &emit );
+
+	  private:
+		DataType				mDataType;
+		int						mPixelInc;
+		int32_t					mFactor;
+		Area					mArea;
+		int32_t					mWidth, mHeight;
+		bool					mIdentity;
+		int32_t					mBlockRows;
+		std::vector<uint8_t>	mAccum, mResult;
+	};
+
+	//! Called by decoders which honor Options::area() and Options::downscale() natively, once the full size, data type and channel order are set. Sets the size to that of the reduced image.
+	void		setupRegion( const Options &options );
+	//! Passes row \a sourceRow of the full image through the reduction set up by setupRegion() to \a func. Rows outside getRegionArea() are ignored.
+	void		processRow( RowFunc func, const ImageTargetRef &target, int32_t sourceRow, const void *data );
+	//! Returns the area of the full image covered after setupRegion(). Data outside it need not be decoded.
+	const Area&	getRegionArea() const { return mRowReducer.getArea(); }
+
 	void		setPixelAspectRatio( float pixelAspectRatio ) { mPixelAspectRatio = pixelAspectRatio; }
 	void		setPremultiplied( bool premult = true ) { mIsPremultiplied = premult; }
 	//! Allows declaration of a pixel increment different from what its ColorModel would imply. For example a non-planar Channel.
@@ -147,6 +206,8 @@ class CI_API ImageSource : public ImageIo {
 	bool						mIsPremultiplied;
 	int8_t						mCustomPixelInc;
 	int32_t						mFrameCount;
+	bool						mRegionApplied;
+	RowReducer					mRowReducer;
 	
 	int8_t						mRowFuncSourceRed, mRowFuncSourceGreen, mRowFuncSourceBlue, mRowFuncSourceAlpha;
 	int8_t						mRowFuncTargetRed, mRowFuncTargetGreen, mRowFuncTargetBlue, mRowFuncTargetAlpha;
@@ -164,27 +225,59 @@ class CI_API ImageTarget : public ImageIo {
 	
 	class Options {
 	  public:
-		Options() : mQuality( 0.9f ), mColorModelDefault( true ) {}
+		Options() : mQuality( 0.9f ), mColorModelDefault( true ), mThreads( 1 ) {}
 		
 		Options& quality( float quality ) { mQuality = quality; return *this; }
 		Options& colorModel( ImageIo::ColorModel cm ) { mColorModelDefault = false; mColorModel = cm; return *this; }
+		//! Sets the number of threads encoders which support it may use for a single image. A value of \c 0 uses one thread per hardware thread. Default is \c 1.
+		Options& threads( int numThreads ) { mThreads = numThreads; return *this; }
 		
 		void	setColorModelDefault() { mColorModelDefault = true; }
 		
 		float				getQuality() const { return mQuality; }
 		bool				isColorModelDefault() const { return mColorModelDefault; }
 		ImageIo::ColorModel	getColorModel() const { return mColorModel; }
+		int					getThreads() const { return mThreads; }
 		
 	  protected:
 		float					mQuality;
 		bool					mColorModelDefault;
 		ImageIo::ColorModel		mColorModel;
+		int						mThreads;
 	};
 	
   protected:
 	ImageTarget() {}
 };
 
+typedef std::shared_ptr<class ImageTargetCallback>	ImageTargetCallbackRef;
+
+//! An ImageTarget which hands rows to a callback in bands of a fixed number of rows rather than storing the image, so that memory is bounded by one band. Rows must be written in order, as ImageSource::load() does.
+class CI_API ImageTargetCallback : public ImageTarget {
+  public:
+	//! Receives \a numRows rows starting at \a firstRow, \a rowBytes apart. \a data is only valid during the call.
+	typedef std::function<void( int32_t firstRow, int32_t numRows, const void *data, size_t rowBytes )>	BandFunc;
+
+	//! Creates a target of \a width x \a height in \a dataType and \a channelOrder, which must be RGB or gray.
+	static ImageTargetCallbackRef	create( int32_t width, int32_t height, DataType dataType, ChannelOrder channelOrder, const BandFunc &bandFunc, int32_t bandRows = 32 );
+	//! Creates a target matching the size, data type and channel order of \a imageSource.
+	static ImageTargetCallbackRef	create( const ImageSourceRef &imageSource, const BandFunc &bandFunc, int32_t bandRows = 32 );
+
+	void*	getRowPointer( int32_t row ) override;
+	void	finalize() override;
+
+  protected:
+	ImageTargetCallback( int32_t width, int32_t height, DataType dataType, ChannelOrder channelOrder, const BandFunc &bandFunc, int32_t bandRows );
+
+	void	flushBand();
+
+	BandFunc				mBandFunc;
+	int32_t					mBandRows;
+	size_t					mRowBytes;
+	std::vector<uint8_t>	mBand;
+	int32_t					mBandFirstRow, mBandNumRows;
+};
+
 
 //! Loads an image from the file path \a path. Optional \a extension parameter allows specification of a file type. For example, "jpg" would force the file to load as a JPEG
 CI_API ImageSourceRef	loadImage( const fs::path &path, ImageSource::Options options = ImageSource::Options(), std::string extension = "" );
@@ -0,0 +1,171 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+#include "cinder/SurfacePool.h"
+#include "cinder/ImageIo.h"
+#include "cinder/DataSource.h"
+#include "cinder/Exception.h"
+#include "cinder/Noncopyable.h"
+
+#include <condition_variable>
+#include <functional>
+#include <future>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageLoader> ImageLoaderRef;
+
+//! Decodes images into Surfaces on a pool of worker threads, returning futures.
+/** Requests are served highest priority first, and in submission order within a priority. Requests which have not started can be
+	canceled by group, in which case their futures throw ImageLoaderCanceledExc; decoding failures are rethrown by the future as well.
+	Before opening an image, each worker parses its header and reserves the size of the decoder's pixels and of the decoded Surface
+	from Format::maxInFlightBytes(), waiting while the reservation would exceed it, so that a handful of very large images do not
+	decode all at once. Formats whose header can't be parsed up front reserve the size of the Surface once opened. A single image
+	larger than the budget is decoded alone. Destroying the ImageLoader cancels pending requests and waits for those in progress. **/
+class CI_API ImageLoader : private Noncopyable {
+  public:
+	struct CI_API Format {
+		Format() : mNumThreads( 0 ), mMaxInFlightBytes( 1024 * 1024 * 1024 ) {}
+
+		//! Sets the number of worker threads. A value of \c 0 uses one thread per hardware thread. Default is \c 0.
+		Format&		threads( int numThreads ) { mNumThreads = numThreads; return *this; }
+		//! Sets the maximum number of bytes of images being decoded at once. Default is 1GB.
+		Format&		maxInFlightBytes( size_t maxInFlightBytes ) { mMaxInFlightBytes = maxInFlightBytes; return *this; }
+		//! Sets a SurfacePool from which decoded Surfaces are allocated. Default is \c nullptr, which allocates from the heap.
+		Format&		surfacePool( const SurfacePoolRef &surfacePool ) { mSurfacePool = surfacePool; return *this; }
+
+		int						getThreads() const { return mNumThreads; }
+		size_t					getMaxInFlightBytes() const { return mMaxInFlightBytes; }
+		const SurfacePoolRef&	getSurfacePool() const { return mSurfacePool; }
+
+	  private:
+		int				mNumThreads;
+		size_t			mMaxInFlightBytes;
+		SurfacePoolRef	mSurfacePool;
+	};
+
+	//! Per-request parameters
+	struct CI_API Request {
+		Request() : mPriority( 0 ), mGroup( 0 ) {}
+
+		//! Sets the priority of the request. Higher priorities are decoded first. Default is \c 0.
+		Request&	priority( int priority ) { mPriority = priority; return *this; }
+		//! Sets a group by which pending requests can be canceled with ImageLoader::cancel(). Default is \c 0.
+		Request&	group( uint32_t group ) { mGroup = group; return *this; }
+		//! Sets the ImageSource::Options passed to loadImage().
+		Request&	imageOptions( const ImageSource::Options &options ) { mImageOptions = options; return *this; }
+		//! Sets the file type passed to loadImage(), for example "png". Default is empty, which selects by path or mime type.
+		Request&	extension( const std::string &extension ) { mExtension = extension; return *this; }
+
+		int								getPriority() const { return mPriority; }
+		uint32_t						getGroup() const { return mGroup; }
+		const ImageSource::Options&		getImageOptions() const { return mImageOptions; }
+		const std::string&				getExtension() const { return mExtension; }
+
+	  private:
+		int						mPriority;
+		uint32_t				mGroup;
+		ImageSource::Options	mImageOptions;
+		std::string				mExtension;
+	};
+
+	static ImageLoaderRef	create( const Format &format = Format() )	{ return ImageLoaderRef( new ImageLoader( format ) ); }
+	~ImageLoader();
+
+	//! Queues the image at \a path for decoding.
+	template<typename T = uint8_t>
+	std::future<SurfaceT<T>>				load( const fs::path &path, const Request &request = Request() );
+	//! Queues the image in \a dataSource for decoding.
+	template<typename T = uint8_t>
+	std::future<SurfaceT<T>>				load( const DataSourceRef &dataSource, const Request &request = Request() );
+	//! Queues each of \a paths for decoding, returning futures in the same order.
+	template<typename T = uint8_t>
+	std::vector<std::future<SurfaceT<T>>>	load( const std::vector<fs::path> &paths, const Request &request = Request() );
+	//! Queues each of \a dataSources for decoding, returning futures in the same order.
+	template<typename T = uint8_t>
+	std::vector<std::future<SurfaceT<T>>>	load( const std::vector<DataSourceRef> &dataSources, const Request &request = Request() );
+
+	//! Cancels the pending requests of \a group, returning how many were canceled. Requests already decoding complete normally.
+	size_t		cancel( uint32_t group );
+	//! Cancels all pending requests, returning how many were canceled.
+	size_t		cancelAll();
+	//! Blocks until no requests are pending or decoding.
+	void		waitForIdle();
+
+	const Format&	getFormat() const { return mFormat; }
+	//! Returns the number of worker threads.
+	size_t		getNumThreads() const { return mThreads.size(); }
+	//! Returns the number of requests which have not started decoding.
+	size_t		getNumPending() const;
+	//! Returns the number of bytes reserved by the images currently decoding.
+	size_t		getInFlightBytes() const;
+
+  private:
+	ImageLoader( const Format &format );
+
+	struct Job {
+		uint32_t									mGroup;
+		std::function<void()>						mRun;
+		std::function<void( std::exception_ptr )>	mFail;
+	};
+
+	template<typename T>
+	std::future<SurfaceT<T>>	enqueue( const std::function<DataSourceRef()> &source, const Request &request );
+	template<typename T>
+	SurfaceT<T>					decode( const DataSourceRef &dataSource, const Request &request );
+	void						reserve( size_t bytes );
+	void						release( size_t bytes );
+
+	void		threadFn();
+	size_t		cancelIf( const std::function<bool( const Job& )> &predicate );
+
+	// ordered by descending priority, then by submission
+	struct JobOrder {
+		bool operator()( const std::pair<int, uint64_t> &a, const std::pair<int, uint64_t> &b ) const { return ( a.first != b.first ) ? ( a.first > b.first ) : ( a.second < b.second ); }
+	};
+	typedef std::map<std::pair<int, uint64_t>, Job, JobOrder>	JobQueue;
+
+	Format						mFormat;
+	std::vector<std::thread>	mThreads;
+	mutable std::mutex			mMutex;
+	std::condition_variable		mJobCondition, mBudgetCondition, mIdleCondition;
+	JobQueue					mJobs;
+	uint64_t					mNextSequence;
+	size_t						mNumActive, mInFlightBytes;
+	bool						mShutdown;
+};
+
+//! Thrown by the future of a request canceled before it started decoding.
+class CI_API ImageLoaderCanceledExc : public Exception {
+  public:
+	ImageLoaderCanceledExc() : Exception( "image load canceled" ) {}
+};
+
+} // namespace cinder
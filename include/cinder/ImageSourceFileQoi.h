@@ -31,10 +31,10 @@ namespace cinder {
 
 typedef std::shared_ptr<class ImageSourceFileQoi>	ImageSourceFileQoiRef;
 
+/*! Reads QOI images. Files written by ImageTargetFileQoi with more than one thread carry an index of independently decodable chunks,
+	which are decoded in parallel according to ImageSource::Options::threads(). */
 class ImageSourceFileQoi : public ImageSource {
   public:
-	~ImageSourceFileQoi();
-
 	static ImageSourceRef	create( DataSourceRef dataSourceRef, ImageSource::Options options ) { return ImageSourceFileQoiRef( new ImageSourceFileQoi( dataSourceRef, options ) ); }
 
 	static void		registerSelf();
@@ -44,8 +44,16 @@ class ImageSourceFileQoi : public ImageSource {
   protected:
 	ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource::Options options );
 
-	uint8_t		*mData;
-	size_t		mRowBytes;
+	void	readChunkIndex();
+	void	loadChunked( ImageSource::RowFunc func, const ImageTargetRef &target );
+
+	BufferRef				mData;
+	int32_t					mFullWidth, mFullHeight;
+	int						mChannels;
+	std::vector<uint32_t>	mChunkOffsets;
+	int32_t					mRowsPerChunk;
+	int						mChunksEnd;
+	int						mThreads;
 };
 
 } // namespace cinder
@@ -44,7 +44,7 @@ class ImageSourceFileRadiance : public ImageSource {
   protected:
 	ImageSourceFileRadiance( DataSourceRef dataSourceRef, ImageSource::Options options );
 	
-	void	loadStream( IStreamRef stream );
+	void	loadStream( IStreamRef stream, const ImageSource::Options &options );
 	
 	std::unique_ptr<float[]>		mRgbData;
 };
@@ -38,6 +38,8 @@ class ImageSourceFileStbImage : public ImageSource {
 	static ImageSourceRef	create( DataSourceRef dataSourceRef, ImageSource::Options options ) { return ImageSourceFileStbImageRef( new ImageSourceFileStbImage( dataSourceRef, options ) ); }
 
 	static void		registerSelf();
+	//! Parses only the header of \a dataSource, returning \c false if stb_image does not recognize it. \a isFloat is set for Radiance HDR images.
+	static bool		probe( const DataSourceRef &dataSource, int32_t *width, int32_t *height, int32_t *numComponents, bool *isFloat );
 
 	void	load( ImageTargetRef target ) override;
 
@@ -41,14 +41,22 @@ class ImageSourcePng : public ImageSource {
 	static ImageSourceRef		createSourceRef( DataSourceRef dataSourceRef, ImageSource::Options options = ImageSource::Options() ) { return createRef( dataSourceRef, options ); }
 	~ImageSourcePng();
 
+	//! Decodes rows in bands of getBandRows(). Images taller than one band are inflated on a second thread while the calling thread converts the previous band into \a target, so memory is bounded by two bands rather than the image. Interlaced images are decoded whole.
 	virtual void	load( ImageTargetRef target );
 
+	//! Sets the number of rows decoded per band by load(). Default is \c 32.
+	void			setBandRows( int32_t rows ) { mBandRows = std::max<int32_t>( 1, rows ); }
+	int32_t			getBandRows() const { return mBandRows; }
+
+	//! Registered by the Linux platform when libpng is found. Elsewhere PNGs are decoded natively unless this is called.
 	static void		registerSelf();
 
   protected:
 	ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Options options );
 	bool loadHeader();
+	bool loadPipelined( RowFunc func, const ImageTargetRef &target, size_t rowBytes, int32_t numRows );
 	
+	int32_t							mBandRows;
 	std::shared_ptr<ci_png_info>	mCiInfoPtr;
 	png_struct_def					*mPngPtr;
 	png_info						*mInfoPtr;
@@ -29,6 +29,8 @@ namespace cinder {
 
 typedef std::shared_ptr<class ImageTargetFileQoi> ImageTargetFileQoiRef;
 
+/*! Writes QOI images. When ImageTarget::Options::threads() is anything but \c 1, the image is encoded in independent chunks of rows in parallel.
+	The result remains a standard QOI stream, followed by an index of the chunk offsets which lets ImageSourceFileQoi decode the chunks in parallel too. */
 class ImageTargetFileQoi : public ImageTarget {
   public:
 	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
@@ -41,11 +43,14 @@ class ImageTargetFileQoi : public ImageTarget {
   protected:
 	ImageTargetFileQoi( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
 
+	std::vector<uint8_t>	encodeChunked() const;
+
 	uint8_t						mNumComponents;
 	size_t						mRowBytes;
 	fs::path					mFilePath;
 	std::unique_ptr<uint8_t[]>	mData;
 	DataTargetRef				mDataTarget;
+	int							mThreads;
 };
 
 } // namespace cinder
@@ -0,0 +1,65 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/ImageIo.h"
+
+struct png_struct_def;
+typedef struct png_info_def png_info;
+
+namespace cinder {
+
+typedef std::shared_ptr<class ImageTargetPng>	ImageTargetPngRef;
+
+//! Encodes PNGs through libpng one row at a time as the ImageSource delivers them, so the image is never held in memory. Writes 8-bit data for UINT8 sources and 16-bit data otherwise.
+class ImageTargetPng : public ImageTarget {
+  public:
+	static ImageTargetRef		create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData );
+	~ImageTargetPng();
+
+	void*	getRowPointer( int32_t row ) override;
+	void	finalize() override;
+
+	//! Registered by the Linux platform when libpng is found. Elsewhere PNGs are encoded natively unless this is called.
+	static void		registerSelf();
+
+  protected:
+	ImageTargetPng( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options );
+
+	void	writePendingRow();
+
+	OStreamRef					mStream;
+	png_struct_def				*mPngPtr;
+	png_info					*mInfoPtr;
+	std::unique_ptr<uint8_t[]>	mRow;
+	int32_t						mPendingRow, mNextRow;
+};
+
+class ImageTargetPngException : public ImageIoException {
+  public:
+	ImageTargetPngException( const std::string &description ) : ImageIoException( description ) {}
+};
+
+} // namespace cinder
@@ -31,6 +31,7 @@
 
 #include <tuple>
 #include <map>
+#include <unordered_map>
 
 namespace cinder {
 
@@ -43,10 +44,44 @@ namespace cinder {
  * myCubeRef = gl::Batch::create( loader, gl::getStockShader( gl::ShaderDef().color() ) );
  * myCubeRef->draw();
  * \endcode
+ *
+ * Large files load faster through the Options constructors, which parse on several threads and can cache the result:
+ * \code
+ * ObjLoader loader( loadFile( "myPath/scan.obj" ), ObjLoader::Options().threads( 0 ).cacheFile( getAppPath() / "scan.objcache" ) );
+ * \endcode
 **/
 
 class CI_API ObjLoader : public geom::Source {
   public:
+	//! Options which control how an ObjLoader loads its file
+	class CI_API Options {
+	  public:
+		Options() : mNormals( true ), mTexCoords( true ), mOptimize( true ), mThreads( 1 ) {}
+
+		//! Sets whether normals are loaded. Skipping them can provide a faster load time. Default is \c true.
+		Options&	normals( bool include = true ) { mNormals = include; return *this; }
+		//! Sets whether texture coordinates are loaded. Skipping them can provide a faster load time. Default is \c true.
+		Options&	texCoords( bool include = true ) { mTexCoords = include; return *this; }
+		//! Sets whether vertices which faces share are output once. Default is \c true.
+		Options&	optimize( bool optimize = true ) { mOptimize = optimize; return *this; }
+		//! Sets the number of threads the file is parsed on, in chunks split at line boundaries. A value of \c 0 uses one thread per hardware thread. The result doesn't depend on the number of threads. Default is \c 1.
+		Options&	threads( int numThreads ) { mThreads = numThreads; return *this; }
+		/** Sets a binary cache file for the loaded mesh. When it was written for the same file contents and options the mesh is copied from it rather than parsed, otherwise it is (re)written after parsing.
+			The cache includes the groups, so groupIndex() and groupName() work as after parsing. A cache that can't be written is logged and removed, the mesh is still loaded. Default is empty, which disables caching. **/
+		Options&	cacheFile( const fs::path &path ) { mCacheFile = path; return *this; }
+
+		bool				getNormals() const { return mNormals; }
+		bool				getTexCoords() const { return mTexCoords; }
+		bool				getOptimize() const { return mOptimize; }
+		int					getThreads() const { return mThreads; }
+		const fs::path&		getCacheFile() const { return mCacheFile; }
+
+	  private:
+		bool		mNormals, mTexCoords, mOptimize;
+		int			mThreads;
+		fs::path	mCacheFile;
+	};
+
 	/**Constructs and does the parsing of the file
 	 * \param includeNormals if false texture coordinates will be skipped, which can provide a faster load time
 	 * \param includeTexCoords if false normals will be skipped, which can provide a faster load time
@@ -62,6 +97,10 @@ class CI_API ObjLoader : public geom::Source {
 	 * \param includeTexCoords if false normals will be skipped, which can provide a faster load time
 	**/
 	ObjLoader( DataSourceRef dataSource, DataSourceRef materialSource, bool includeNormals = true, bool includeTexCoords = true,  bool optimize = true );
+	//! Constructs and does the parsing of the file, which is mapped into memory when \a dataSource is a file, according to \a options
+	ObjLoader( DataSourceRef dataSource, const Options &options );
+	//! Constructs and does the parsing of the file, which is mapped into memory when \a dataSource is a file, according to \a options
+	ObjLoader( DataSourceRef dataSource, DataSourceRef materialSource, const Options &options );
 
 	/**Loads a specific group index from the file**/
 	ObjLoader&	groupIndex( size_t groupIndex );
@@ -112,6 +151,8 @@ class CI_API ObjLoader : public geom::Source {
 	
 	//! Returns a vector<> of the Groups in the OBJ.
 	const std::vector<Group>&		getGroups() const { return mGroups; }
+	//! Returns whether the mesh was copied from the Options::cacheFile() rather than parsed.
+	bool							isLoadedFromCache() const { return mLoadedFromCache; }
 
 	size_t			getNumVertices() const override { load(); return mOutputVertices.size(); }
 	size_t			getNumIndices() const override { load(); return mOutputIndices.size(); }
@@ -125,16 +166,27 @@ class CI_API ObjLoader : public geom::Source {
 	typedef std::tuple<int,int> VertexPair;
 	typedef std::tuple<int,int,int> VertexTriple;
 
+	struct VertexHash {
+		size_t operator()( int v ) const { return std::hash<int>()( v ); }
+		size_t operator()( const VertexPair &v ) const { return (size_t)std::get<0>( v ) * 73856093 ^ (size_t)std::get<1>( v ) * 19349663; }
+		size_t operator()( const VertexTriple &v ) const { return (size_t)std::get<0>( v ) * 73856093 ^ (size_t)std::get<1>( v ) * 19349663 ^ (size_t)std::get<2>( v ) * 83492791; }
+	};
+
+	void	loadSource( const DataSourceRef &dataSource, const DataSourceRef &materialSource, const Options &options );
 	void	parse( bool includeNormals, bool includeTexCoords );
- 	void	parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords );
+	void	parse( const Buffer &buffer, const Options &options );
+ 	void	parseFace( Group *group, const Material *material, std::string_view s, bool includeNormals, bool includeTexCoords );
     void    parseMaterial( std::shared_ptr<IStreamCinder> material );
 
 	void	load() const;
+	bool	readCache( const fs::path &path, uint64_t hash );
+	void	writeCache( const fs::path &path, uint64_t hash ) const;
+	void	writeCache( OStream *stream, uint64_t hash ) const;
 
-	void	loadGroupNormalsTextures( const Group &group, std::map<VertexTriple,int> &uniqueVerts ) const;
-	void	loadGroupNormals( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroupTextures( const Group &group, std::map<VertexPair,int> &uniqueVerts ) const;
-	void	loadGroup( const Group &group, std::map<int,int> &uniqueVerts ) const;
+	void	loadGroupNormalsTextures( const Group &group, std::unordered_map<VertexTriple,int,VertexHash> &uniqueVerts ) const;
+	void	loadGroupNormals( const Group &group, std::unordered_map<VertexPair,int,VertexHash> &uniqueVerts ) const;
+	void	loadGroupTextures( const Group &group, std::unordered_map<VertexPair,int,VertexHash> &uniqueVerts ) const;
+	void	loadGroup( const Group &group, std::unordered_map<int,int,VertexHash> &uniqueVerts ) const;
 
 	std::shared_ptr<IStreamCinder>	mStream;
 
@@ -153,6 +205,7 @@ class CI_API ObjLoader : public geom::Source {
 
 	std::vector<Group>				mGroups;
 	std::map<std::string, Material>	mMaterials;
+	bool							mLoadedFromCache;
 
 };
 
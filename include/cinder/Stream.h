@@ -32,6 +32,7 @@
 #endif
 
 #include <string>
+#include <string_view>
 
 namespace cinder {
 
@@ -122,7 +123,11 @@ class CI_API IStreamCinder : public virtual StreamBase {
 	void		read( fs::path *p );
 	void		readFixedString( char *t, size_t maxSize, bool nullTerminate );
 	void		readFixedString( std::string *t, size_t size );
+	//! Reads up to the next LF, CR or CRLF, which is consumed but not returned
 	std::string	readLine();
+	/*! Reads the next line into \a line without its LF, CR or CRLF ending, and returns \c false once the stream is exhausted. \a line views memory owned by the stream,
+		usually its own read-ahead buffer, and remains valid until the stream is next read, seeked or destroyed. Streams with such a buffer never allocate per line. */
+	bool		readLine( std::string_view *line );
 	
 	void			readData( void *dest, size_t size );
 	virtual size_t	readDataAvailable( void *dest, size_t maxSize ) = 0;
@@ -134,8 +139,18 @@ class CI_API IStreamCinder : public virtual StreamBase {
 	IStreamCinder() = default;
 
 	virtual void		IORead( void *t, size_t size ) = 0;
+
+	//! Returns the bytes following the current position which can be read without copying, refilling any read-ahead buffer first. Doesn't advance the stream. An empty view means the stream is exhausted or has no such buffer.
+	virtual std::string_view	peekBuffered() { return std::string_view(); }
+	//! Advances the stream past the first \a size bytes returned by peekBuffered()
+	virtual void				skipBuffered( size_t size ) { seekRelative( static_cast<off_t>( size ) ); }
 		
 	static const int	MINIMUM_BUFFER_SIZE = 8; // minimum bytes of random access a stream must offer relative to the file start
+
+ private:
+	void		readLineUnbuffered( std::string *result );
+
+	std::string			mLineBuffer; // holds lines which span buffer refills, or which were read from streams without a buffer
 };
 typedef std::shared_ptr<IStreamCinder>		IStreamRef;
 
@@ -170,8 +185,10 @@ class CI_API IStreamFile : public IStreamCinder {
  protected:
 	IStreamFile( FILE *aFile, bool aOwnsFile = true, int32_t aDefaultBufferSize = 2048 );
 
-	virtual void		IORead( void *t, size_t size );
-	size_t				readDataImpl( void *dest, size_t maxSize );
+	virtual void				IORead( void *t, size_t size );
+	size_t						readDataImpl( void *dest, size_t maxSize );
+	virtual std::string_view	peekBuffered();
+	virtual void				skipBuffered( size_t size );
  
 	FILE						*mFile;
 	bool						mOwnsFile;
@@ -307,7 +324,9 @@ class CI_API IStreamMem : public IStreamCinder {
  protected:
  	IStreamMem( const void *aData, size_t aDataSize );
 
-	virtual void	IORead( void *t, size_t size );
+	virtual void				IORead( void *t, size_t size );
+	virtual std::string_view	peekBuffered();
+	virtual void				skipBuffered( size_t size );
  
 	const uint8_t	*mData;
 	size_t			mDataSize;
@@ -315,6 +334,63 @@ class CI_API IStreamMem : public IStreamCinder {
 };
 
 
+typedef std::shared_ptr<class MappedFile>	MappedFileRef;
+
+//! A read-only memory mapping of an entire file, which stays mapped until the last reference is released. Pages are read from the file on first access, without an intermediate copy.
+class CI_API MappedFile : public std::enable_shared_from_this<MappedFile>, private Noncopyable {
+ public:
+	//! How the mapping is expected to be read, passed on to the operating system as a read-ahead hint
+	enum Access { ACCESS_NORMAL, ACCESS_SEQUENTIAL, ACCESS_RANDOM };
+
+	//! Maps the file at \a path. Throws StreamExc if the file can't be opened or mapped.
+	static MappedFileRef	create( const fs::path &path, Access access = ACCESS_NORMAL );
+	~MappedFile();
+
+	//! Returns the first byte of the file, or \c nullptr for an empty file
+	const void*		getData() const { return mData; }
+	//! Returns the size of the file in bytes
+	size_t			getSize() const { return mSize; }
+	const fs::path&	getFilePath() const { return mFilePath; }
+
+	Access	getAccess() const { return mAccess; }
+	//! Changes the read-ahead hint for the whole mapping. Ignored where the platform offers no equivalent.
+	void	setAccess( Access access );
+
+	//! Returns a Buffer which views the mapping without copying it, and keeps it mapped for as long as the Buffer exists. The mapping is read-only, so code that needs to modify the contents must copy them.
+	std::shared_ptr<const Buffer>	createBuffer() const;
+
+ protected:
+	MappedFile( const fs::path &path, Access access );
+
+	const uint8_t	*mData;
+	size_t			mSize;
+	fs::path		mFilePath;
+	Access		mAccess;
+#if defined( CINDER_MSW )
+	void		*mFileHandle, *mMappingHandle;
+#endif
+};
+
+
+typedef std::shared_ptr<class IStreamMapped>	IStreamMappedRef;
+
+//! An IStreamMem reading from a MappedFile, which it keeps mapped for its lifetime
+class CI_API IStreamMapped : public IStreamMem {
+ public:
+	//! Maps the file at \a path and creates a stream reading from it. Throws StreamExc if the file can't be opened or mapped.
+	static IStreamMappedRef		create( const fs::path &path, MappedFile::Access access = MappedFile::ACCESS_SEQUENTIAL );
+	//! Creates a stream reading from \a mappedFile. Any number of streams may share one mapping.
+	static IStreamMappedRef		create( const MappedFileRef &mappedFile );
+
+	const MappedFileRef&	getMappedFile() const { return mMappedFile; }
+
+ protected:
+	IStreamMapped( const MappedFileRef &mappedFile );
+
+	MappedFileRef	mMappedFile;
+};
+
+
 typedef std::shared_ptr<class OStreamMem>		OStreamMemRef;
 
 class CI_API OStreamMem : public OStream {
@@ -376,7 +452,7 @@ IStreamAndroidAssetRef	loadAndroidAssetStream( const fs::path &path );
 // Stream exception
 class CI_API StreamExc : public Exception {
   public:
-	StreamExc() throw() {}
+	StreamExc() throw() { mMessage[0] = 0; }
 	StreamExc( const std::string &fontName ) throw();
 	virtual const char* what() const throw() { return mMessage; }	
   private:
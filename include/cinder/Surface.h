@@ -34,6 +34,8 @@
 #include "cinder/Filesystem.h"
 #include "cinder/Exception.h"
 
+#include <atomic>
+
 namespace cinder {
 
 template<typename T>
@@ -50,6 +52,9 @@ typedef std::shared_ptr<Surface16u>	Surface16uRef;
 //! 32-bit floating point image
 typedef SurfaceT<float> Surface32f;
 typedef std::shared_ptr<Surface32f>	Surface32fRef;
+//! 16-bit floating point image. Like Surface16u, primarily a storage format for ImageIo, such as half-float EXR files.
+typedef SurfaceT<half_float> Surface16f;
+typedef std::shared_ptr<Surface16f>	Surface16fRef;
 
 //! Specifies the in-memory ordering of the channels of a Surface.
 class CI_API SurfaceChannelOrder {
@@ -112,6 +117,8 @@ class CI_API SurfaceT {
 	SurfaceT( int32_t width, int32_t height, bool alpha, const SurfaceConstraints &constraints );
 	//! Constructs a surface from the memory pointed to by \a data. Does not assume ownership of the memory in \a data, which consequently should not be freed while the Surface is still in use.
 	SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder );
+	//! Constructs a surface from the memory pointed to by \a data, sharing ownership of it through \a dataStore, which is released when the Surface and its Channels are destroyed.
+	SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder, const std::shared_ptr<T> &dataStore );
 	//! Constructs a Surface from an \a imageSource and optional \a constraints. Includes alpha channel if one is present in the ImageSource.
 	SurfaceT( ImageSourceRef imageSource, const SurfaceConstraints &constraints = SurfaceConstraintsDefault() );
 	//! Constructs a Surface from an \a imageSource and optional \a constraints. Includes alpha channel based on \a alpha.
@@ -120,7 +127,7 @@ class CI_API SurfaceT {
 	//! Creates a clone of \a rhs. Matches rowBytes and channel order of \a rhs, but creates its own dataStore.
 	SurfaceT( const SurfaceT &rhs );
 	//! Surface move constructor.
-	SurfaceT( SurfaceT &&rhs );
+	SurfaceT( SurfaceT &&rhs ) noexcept;
 
 	//! Creates a SurfaceRef of size \a width X \a height, with an optional \a alpha channel. The default value for \a channelOrder selects a platform default.
 	static std::shared_ptr<SurfaceT<T>>	create( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder = SurfaceChannelOrder::UNSPECIFIED )
@@ -147,7 +154,7 @@ class CI_API SurfaceT {
 	{ return std::make_shared<SurfaceT<T>>( surface ); }
 
 	SurfaceT<T>&	operator=( const SurfaceT<T> &rhs );
-	SurfaceT<T>&	operator=( SurfaceT<T> &&rhs );
+	SurfaceT<T>&	operator=( SurfaceT<T> &&rhs ) noexcept;
 
 	operator ImageSourceRef() const;
 	operator ImageTargetRef();
@@ -170,6 +177,8 @@ class CI_API SurfaceT {
 	void			setPremultiplied( bool premult = true ) { mPremultiplied = premult; }
 	//! Returns the width of a row of the Surface measured in bytes, which is not necessarily getWidth() * getPixelInc()
 	ptrdiff_t		getRowBytes() const { return mRowBytes; }
+	//! Returns the width of a row of the Surface measured in bytes. Detaches first if the pixels are shared copy-on-write, as the copy's rows are packed, so that the result matches the pointers returned by getData().
+	ptrdiff_t		getRowBytes() { detachIfShared(); return mRowBytes; }
 	//! Returns the amount to increment a T* to increment by a pixel. Analogous to the number of channels, which is either 3 or 4
 	uint8_t			getPixelInc() const { return mChannelOrder.getPixelInc(); }
 	//! Returns the number of bytes to increment by a pixel. Analogous to the number of channels, (which is either 3 or 4) * sizeof(T)
@@ -180,10 +189,22 @@ class CI_API SurfaceT {
 	//! Returns a new Surface which is a duplicate of an Area \a area. If \a copyPixels the pixel values are copied, otherwise the clone's pixels remain uninitialized
 	SurfaceT			clone( const Area &area, bool copyPixels = true ) const;
 
+	//! Returns a Surface which aliases the pixels of \a area without copying them. Writes through either Surface are visible in the other, and the view keeps the data store alive. \a area is clipped to the bounds. Detaches \a this first if its pixels are shared copy-on-write.
+	SurfaceT			getView( const Area &area );
+	//! Returns a copy-on-write duplicate which shares the pixels of \a this. The non-const accessors of a sharer (getData(), getRowBytes(), setPixel(), getIter() and getChannel*()) give it its own copy first; const access never copies. If views alias the pixels, which write without detaching, the result is a copy instead.
+	SurfaceT			share() const;
+	//! Returns a copy-on-write duplicate of \a area which shares the pixels of \a this, clipped to the bounds. Detaching copies only \a area.
+	SurfaceT			share( const Area &area ) const;
+	//! Returns whether the pixels are currently shared copy-on-write with another Surface
+	bool				isShared() const { return mShareToken.isShared(); }
+	/*! Gives \a this its own copy of the pixels if they are shared copy-on-write. The copy's rows are packed, so rowBytes may shrink, and keep the alignment of the data up to a cache line.
+		The non-const accessors detach implicitly. Code which writes to one Surface from several threads calls it once beforehand, as the ip:: functions do, so that the threads don't race to detach. */
+	void				detach();
+
 	//! Retuns the raw data of an image as a pointer to either uin8t_t values in the case of a Surface8u or floats in the case of a Surface32f
-	T*					getData() { return mData; }
+	T*					getData() { detachIfShared(); return mData; }
 	const T*			getData() const { return mData; }
-	T*					getData( const ivec2 &offset ) { return reinterpret_cast<T*>( reinterpret_cast<unsigned char*>( mData + offset.x * getPixelInc() ) + offset.y * mRowBytes ); }
+	T*					getData( const ivec2 &offset ) { detachIfShared(); return reinterpret_cast<T*>( reinterpret_cast<unsigned char*>( mData + offset.x * getPixelInc() ) + offset.y * mRowBytes ); }
 	const T*			getData( const ivec2 &offset ) const { return reinterpret_cast<T*>( reinterpret_cast<unsigned char*>( mData + offset.x * getPixelInc() ) + offset.y * mRowBytes ); }
 	//! Returns a pointer to the red channel data of the pixel located at \a offset. Result is a uint8_t* for Surface8u and a float* for Surface32f.
 	T*					getDataRed( const ivec2 &offset ) { return getData( offset ) + getRedOffset(); }
@@ -215,18 +236,18 @@ class CI_API SurfaceT {
 	void					setChannelOrder( const SurfaceChannelOrder &aChannelOrder );
 
 	//! Returns a reference to a Channel \a channelIndex indexed according to how the channels are arranged per the SurfaceChannelOrder.
-	ChannelT<T>&			getChannel( uint8_t channelIndex ) { return mChannels[channelIndex]; }
+	ChannelT<T>&			getChannel( uint8_t channelIndex ) { detachIfShared(); return mChannels[channelIndex]; }
 	//! Returns a const reference to a Channel \a channelIndex indexed  according to how the channels are arranged per the SurfaceChannelOrder.
 	const ChannelT<T>&		getChannel( uint8_t channelIndex ) const { return mChannels[channelIndex]; }
 	
 	/*! Returns a reference to the red Channel of the Surface */
-	ChannelT<T>&		getChannelRed() { return mChannels[SurfaceChannelOrder::CHAN_RED]; }
+	ChannelT<T>&		getChannelRed() { detachIfShared(); return mChannels[SurfaceChannelOrder::CHAN_RED]; }
 	/*! Returns a reference to the green Channel of the Surface */
-	ChannelT<T>&		getChannelGreen() { return mChannels[SurfaceChannelOrder::CHAN_GREEN]; }
+	ChannelT<T>&		getChannelGreen() { detachIfShared(); return mChannels[SurfaceChannelOrder::CHAN_GREEN]; }
 	/*! Returns a reference to the blue Channel of the Surface */
-	ChannelT<T>&		getChannelBlue() { return mChannels[SurfaceChannelOrder::CHAN_BLUE]; }
+	ChannelT<T>&		getChannelBlue() { detachIfShared(); return mChannels[SurfaceChannelOrder::CHAN_BLUE]; }
 	/*! Returns a reference to the alpha Channel of the Surface. Undefined in the absence of an alpha channel. */
-	ChannelT<T>&		getChannelAlpha() { return mChannels[SurfaceChannelOrder::CHAN_ALPHA]; }
+	ChannelT<T>&		getChannelAlpha() { detachIfShared(); return mChannels[SurfaceChannelOrder::CHAN_ALPHA]; }
 
 	/*! Returns a const reference to the red Channel of the Surface */
 	const ChannelT<T>&	getChannelRed() const { return mChannels[SurfaceChannelOrder::CHAN_RED]; }
@@ -253,6 +274,9 @@ class CI_API SurfaceT {
   private:
 	void init( ImageSourceRef imageSource, const SurfaceConstraints &constraints, bool alpha );
 
+	SurfaceT	alias( const Area &area ) const;
+	void		detachIfShared() { if( mShareToken.isShared() ) detach(); }
+
 	void	copyRawSameChannelOrder( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
 	void	copyRawRgba( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
 	void 	copyRawRgbFullAlpha( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &absoluteOffset );
@@ -265,11 +289,52 @@ class CI_API SurfaceT {
 
 	void	initChannels();
 
+	//! Counts the Surfaces sharing pixels copy-on-write, and the views aliasing them. Every Surface holds one from construction, so share() only reads it. Counts are released and read with acquire/release ordering, so a Surface which finds itself the last sharer also sees every other sharer's reads as complete, whichever thread they ran on.
+	class ShareToken {
+	  public:
+		ShareToken() = default;
+		ShareToken( ShareToken &&rhs ) noexcept : mCounts( std::move( rhs.mCounts ) ), mView( rhs.mView ) {}
+		~ShareToken() { reset(); }
+
+		ShareToken& operator=( ShareToken &&rhs ) noexcept { if( this != &rhs ) { reset(); mCounts = std::move( rhs.mCounts ); mView = rhs.mView; } return *this; }
+
+		static ShareToken	create() { ShareToken result; result.mCounts = std::make_shared<Counts>(); return result; }
+
+		//! Returns a token for another Surface sharing the same pixels copy-on-write.
+		ShareToken	share() const	{ return join( false ); }
+		//! Returns a token for a view aliasing the same pixels.
+		ShareToken	view() const	{ return join( true ); }
+
+		bool	isShared() const { return mCounts && mCounts->mSharers.load( std::memory_order_acquire ) > 1; }
+		bool	hasViews() const { return mCounts && mCounts->mViews.load( std::memory_order_acquire ) > 0; }
+		void	reset() { if( mCounts ) { ( mView ? mCounts->mViews : mCounts->mSharers ).fetch_sub( 1, std::memory_order_release ); mCounts.reset(); } }
+
+	  private:
+		struct Counts {
+			std::atomic<int32_t>	mSharers{ 1 }, mViews{ 0 };
+		};
+
+		ShareToken	join( bool view ) const
+		{
+			ShareToken result;
+			if( mCounts ) {
+				( view ? mCounts->mViews : mCounts->mSharers ).fetch_add( 1, std::memory_order_relaxed );
+				result.mCounts = mCounts;
+				result.mView = view;
+			}
+			return result;
+		}
+
+		std::shared_ptr<Counts>	mCounts;
+		bool					mView = false;
+	};
+
 	int32_t						mWidth, mHeight;
 	ptrdiff_t					mRowBytes;
 	bool						mPremultiplied;
 	T							*mData;
 	std::shared_ptr<T>			mDataStore; // shared rather than unique because member Channels (r/g/b/a) share the same data store and may need to outlive their parent Surface
+	ShareToken					mShareToken;
 	SurfaceChannelOrder			mChannelOrder;
 	ChannelT<T>					mChannels[4];
 	
@@ -0,0 +1,103 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+#include "cinder/Noncopyable.h"
+
+#include <memory>
+
+namespace cinder {
+
+typedef std::shared_ptr<class SurfacePool> SurfacePoolRef;
+
+//! Recycles the pixel storage of Surfaces with the same size, channel order and data type, avoiding a heap allocation per Surface.
+/** A Surface acquired from the pool owns its pixels like any other Surface, and its storage returns to the pool automatically when
+	the last Surface, Channel or view referencing it is destroyed, which may happen on any thread and after the pool itself is gone.
+	Pixels and rows are aligned to Format::alignment(). Idle storage is released least recently used first once either cap in the Format
+	is exceeded. The pixels of a recycled Surface are uninitialized, as with a newly allocated one. All methods are thread-safe. **/
+class CI_API SurfacePool : private Noncopyable {
+  public:
+	struct CI_API Format {
+		Format() : mAlignment( 64 ), mMaxIdleBytes( 256 * 1024 * 1024 ), mMaxIdleSurfaces( 8 ) {}
+
+		//! Sets the alignment in bytes of the pixel data and of each row, which must be a power of two. Default is \c 64.
+		Format&		alignment( size_t alignment ) { mAlignment = alignment; return *this; }
+		//! Sets the maximum number of bytes held by idle storage across all sizes. Default is 256MB.
+		Format&		maxIdleBytes( size_t maxIdleBytes ) { mMaxIdleBytes = maxIdleBytes; return *this; }
+		//! Sets the maximum number of idle Surfaces kept for each combination of size, channel order and data type. Default is \c 8.
+		Format&		maxIdleSurfaces( size_t maxIdleSurfaces ) { mMaxIdleSurfaces = maxIdleSurfaces; return *this; }
+
+		size_t		getAlignment() const { return mAlignment; }
+		size_t		getMaxIdleBytes() const { return mMaxIdleBytes; }
+		size_t		getMaxIdleSurfaces() const { return mMaxIdleSurfaces; }
+
+	  private:
+		size_t		mAlignment, mMaxIdleBytes, mMaxIdleSurfaces;
+	};
+
+	static SurfacePoolRef	create( const Format &format = Format() )	{ return SurfacePoolRef( new SurfacePool( format ) ); }
+	//! Returns a process-wide pool with the default Format, suitable for sharing between subsystems.
+	static SurfacePoolRef	getDefault();
+
+	~SurfacePool();
+
+	//! Returns a Surface of size \a width X \a height, reusing idle storage when available. The default value for \a channelOrder selects a platform default.
+	template<typename T>
+	SurfaceT<T>						acquire( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder = SurfaceChannelOrder::UNSPECIFIED );
+	//! Returns a SurfaceRef of size \a width X \a height, reusing idle storage when available. The default value for \a channelOrder selects a platform default.
+	template<typename T>
+	std::shared_ptr<SurfaceT<T>>	acquireRef( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder = SurfaceChannelOrder::UNSPECIFIED )
+	{ return std::make_shared<SurfaceT<T>>( acquire<T>( width, height, alpha, channelOrder ) ); }
+	//! Returns a Surface loaded from \a imageSource into pooled storage. Includes an alpha channel if one is present in \a imageSource.
+	template<typename T>
+	SurfaceT<T>						load( const ImageSourceRef &imageSource );
+
+	//! Releases all idle storage. Surfaces still in use return their storage to the pool as usual.
+	void		clear();
+
+	const Format&	getFormat() const { return mFormat; }
+	//! Returns the number of acquisitions satisfied by idle storage.
+	size_t		getNumHits() const;
+	//! Returns the number of acquisitions which required a new allocation.
+	size_t		getNumMisses() const;
+	//! Returns the number of idle Surfaces released to honor the caps in the Format.
+	size_t		getNumEvictions() const;
+	//! Returns the number of idle Surfaces held by the pool.
+	size_t		getNumIdle() const;
+	//! Returns the number of bytes of idle storage held by the pool.
+	size_t		getIdleBytes() const;
+	//! Returns the number of pooled Surfaces currently in use.
+	size_t		getNumInUse() const;
+
+  private:
+	SurfacePool( const Format &format );
+
+	struct Shared;
+
+	Format					mFormat;
+	std::shared_ptr<Shared>	mShared; // shared with the data stores of acquired Surfaces, which return their storage to it
+};
+
+} // namespace cinder
@@ -43,6 +43,10 @@ class CI_API System {
 	static bool			hasSse4_1();
 	//! Returns whether the system supports the SSE4.2 instruction set.	Inaccurate on MSW x64.		
 	static bool			hasSse4_2();
+	//! Returns whether the system supports the AVX2 instruction set, including operating system support for the wider registers.
+	static bool			hasAvx2();
+	//! Returns whether the system supports the ARM NEON instruction set.
+	static bool			hasNeon();
 	//! Returns whether the system supports the x86-64 instruction set.	Inaccurate on MSW x64.
 	static bool			hasX86_64();
 	//! Returns whether the system supports the ARM instruction set.		
@@ -95,7 +99,7 @@ class CI_API System {
 	static std::string						getSubnetMask();
 	
   private:
-	 enum {	HAS_SSE2, HAS_SSE3, HAS_SSE4_1, HAS_SSE4_2, HAS_X86_64, HAS_ARM, PHYSICAL_CPUS, LOGICAL_CPUS, OS_MAJOR, OS_MINOR, OS_BUGFIX, MULTI_TOUCH, MAX_MULTI_TOUCH_POINTS, 
+	 enum {	HAS_SSE2, HAS_SSE3, HAS_SSE4_1, HAS_SSE4_2, HAS_AVX2, HAS_NEON, HAS_X86_64, HAS_ARM, PHYSICAL_CPUS, LOGICAL_CPUS, OS_MAJOR, OS_MINOR, OS_BUGFIX, MULTI_TOUCH, MAX_MULTI_TOUCH_POINTS, 
 #if defined( CINDER_COCOA_TOUCH)	 
 			IS_IPHONE, IS_IPAD,
 #endif	 
@@ -106,7 +110,7 @@ class CI_API System {
 	static std::shared_ptr<System>		sInstance;
 
 	bool				mCachedValues[TOTAL_CACHE_TYPES];
-	bool				mHasSSE2, mHasSSE3, mHasSSE4_1, mHasSSE4_2, mHasX86_64, mHasArm;
+	bool				mHasSSE2, mHasSSE3, mHasSSE4_1, mHasSSE4_2, mHasAVX2, mHasNeon, mHasX86_64, mHasArm;
 	int					mPhysicalCPUs, mLogicalCPUs;
 	int32_t				mOSMajorVersion, mOSMinorVersion, mOSBugFixVersion;
 	bool				mHasMultiTouch;
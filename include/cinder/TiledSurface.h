@@ -0,0 +1,192 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+#include "cinder/Exception.h"
+#include "cinder/Filesystem.h"
+#include "cinder/Noncopyable.h"
+
+#include <condition_variable>
+#include <deque>
+#include <fstream>
+#include <functional>
+#include <list>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace cinder {
+
+template<typename T>
+class TiledSurfaceT;
+
+typedef TiledSurfaceT<uint8_t>		TiledSurface;
+typedef TiledSurfaceT<uint8_t>		TiledSurface8u;
+typedef TiledSurfaceT<uint16_t>		TiledSurface16u;
+typedef TiledSurfaceT<float>		TiledSurface32f;
+typedef std::shared_ptr<TiledSurface8u>		TiledSurfaceRef;
+typedef std::shared_ptr<TiledSurface8u>		TiledSurface8uRef;
+typedef std::shared_ptr<TiledSurface16u>	TiledSurface16uRef;
+typedef std::shared_ptr<TiledSurface32f>	TiledSurface32fRef;
+
+//! An image too large to hold in memory, stored as fixed-size square tiles which are paged in on demand.
+/** Only the most recently used tiles are kept in memory, within the budget set by Format::memoryBudget(). Tiles evicted from memory are
+	written to a disk cache, by default a temporary file which is removed along with the TiledSurface. Tiles which have never been written
+	read as zero and occupy neither memory nor disk.
+
+	Pixels are accessed by Area, either by copying to and from a Surface with readArea() and writeArea(), or without copying by
+	forEachTile(), which passes each tile intersecting an Area to a callback as a Surface suitable for the ip:: functions.
+	prefetch() pages tiles in on a background thread ahead of their use. Apart from that background paging, a TiledSurface
+	should only be used from one thread at a time. **/
+template<typename T>
+class CI_API TiledSurfaceT : private Noncopyable {
+  public:
+	class CI_API Format {
+	  public:
+		Format() : mTileSize( 256 ), mMemoryBudget( 512 * 1024 * 1024 ), mChannelOrder( SurfaceChannelOrder::UNSPECIFIED ) {}
+
+		//! Sets the width and height of the tiles in pixels. Default is \c 256.
+		Format&		tileSize( int32_t size ) { mTileSize = size; return *this; }
+		//! Sets the number of bytes of tiles kept in memory. Tiles in use by forEachTile() may temporarily exceed it. Default is 512MB.
+		Format&		memoryBudget( size_t bytes ) { mMemoryBudget = bytes; return *this; }
+		//! Sets the file used as the disk cache. The file is created or truncated and is not removed. By default a temporary file is used and removed.
+		Format&		cachePath( const fs::path &path ) { mCachePath = path; return *this; }
+		//! Sets the channel order of the tiles. The default selects a platform default.
+		Format&		channelOrder( const SurfaceChannelOrder &channelOrder ) { mChannelOrder = channelOrder; return *this; }
+
+		int32_t						getTileSize() const { return mTileSize; }
+		size_t						getMemoryBudget() const { return mMemoryBudget; }
+		const fs::path&				getCachePath() const { return mCachePath; }
+		const SurfaceChannelOrder&	getChannelOrder() const { return mChannelOrder; }
+
+	  private:
+		int32_t				mTileSize;
+		size_t				mMemoryBudget;
+		fs::path			mCachePath;
+		SurfaceChannelOrder	mChannelOrder;
+	};
+
+	//! Creates a TiledSurface of \a width x \a height pixels, initially zero, with an optional \a alpha channel
+	TiledSurfaceT( int32_t width, int32_t height, bool alpha, const Format &format = Format() );
+	//! Creates a TiledSurface holding \a imageSource, which is decoded once, row by row, with tiles beyond the memory budget going to the disk cache. Includes an alpha channel if \a imageSource has one.
+	TiledSurfaceT( const ImageSourceRef &imageSource, const Format &format = Format() );
+	~TiledSurfaceT();
+
+	static std::shared_ptr<TiledSurfaceT>	create( int32_t width, int32_t height, bool alpha, const Format &format = Format() )
+	{ return std::make_shared<TiledSurfaceT>( width, height, alpha, format ); }
+	static std::shared_ptr<TiledSurfaceT>	create( const ImageSourceRef &imageSource, const Format &format = Format() )
+	{ return std::make_shared<TiledSurfaceT>( imageSource, format ); }
+
+	int32_t						getWidth() const { return mWidth; }
+	int32_t						getHeight() const { return mHeight; }
+	ivec2						getSize() const { return ivec2( mWidth, mHeight ); }
+	Area						getBounds() const { return Area( 0, 0, mWidth, mHeight ); }
+	bool						hasAlpha() const { return mChannelOrder.hasAlpha(); }
+	const SurfaceChannelOrder&	getChannelOrder() const { return mChannelOrder; }
+	int32_t						getTileSize() const { return mTileSize; }
+	//! Returns the number of tiles horizontally and vertically
+	ivec2						getNumTiles() const { return ivec2( mNumTilesX, mNumTilesY ); }
+	//! Returns the pixels covered by the tile at \a tile, clipped to getBounds()
+	Area						getTileBounds( const ivec2 &tile ) const;
+
+	//! Copies the pixels of \a area, clipped to getBounds(), into a new Surface
+	SurfaceT<T>		readArea( const Area &area );
+	//! Copies the pixels of \a area into \a dstSurface at \a dstLT, clipping to both
+	void			readArea( const Area &area, SurfaceT<T> *dstSurface, const ivec2 &dstLT = ivec2() );
+	//! Copies the \a srcArea of \a srcSurface into the TiledSurface at \a dstLT, clipping to both
+	void			writeArea( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT );
+	//! Copies all of \a srcSurface into the TiledSurface at \a dstLT
+	void			writeArea( const SurfaceT<T> &srcSurface, const ivec2 &dstLT = ivec2() ) { writeArea( srcSurface, srcSurface.getBounds(), dstLT ); }
+
+	//! Calls \a fn( tileSurface, tileArea ) for each tile intersecting \a area, in rows from the top. \a tileSurface refers directly to the part of the tile within \a area, which \a tileArea gives in TiledSurface coordinates.
+	/** Tiles stay in memory for the duration of each call. When \a writable is \c false, changes made to \a tileSurface may be lost. **/
+	void			forEachTile( const Area &area, bool writable, const std::function<void( SurfaceT<T> &tileSurface, const Area &tileArea )> &fn );
+
+	//! Hints that \a area will be accessed soon, so that its tiles are paged in on a background thread. Tiles beyond half of the memory budget are ignored.
+	void			prefetch( const Area &area );
+	//! Blocks until all prefetches have completed
+	void			waitForPrefetch();
+
+	//! Returns the number of tiles currently in memory
+	size_t			getNumResidentTiles() const;
+	//! Returns the number of bytes of tiles currently in memory
+	size_t			getResidentBytes() const;
+	//! Returns the number of tiles which have been read from the disk cache
+	size_t			getNumPageIns() const;
+	//! Returns the number of tiles which have been written to the disk cache
+	size_t			getNumPageOuts() const;
+
+  private:
+	enum TileState { TILE_EMPTY, TILE_RESIDENT, TILE_PAGED_OUT, TILE_LOADING };
+
+	struct Tile {
+		Tile() : mState( TILE_EMPTY ), mDirty( false ), mOnDisk( false ), mPinCount( 0 ) {}
+
+		TileState					mState;
+		bool						mDirty, mOnDisk;
+		int32_t						mPinCount;
+		std::unique_ptr<T[]>		mPixels;
+		std::list<int32_t>::iterator	mLruPos;
+	};
+
+	void		init( bool alpha, const Format &format );
+	void		loadImageSource( const ImageSourceRef &imageSource );
+	// returns the pixels of tile \a index, paging it in as needed. Requires mMutex to be held by \a lock.
+	T*			acquireTile( int32_t index, std::unique_lock<std::mutex> &lock, bool forWriting );
+	void		touch( int32_t index );
+	void		makeRoom( size_t bytes, std::unique_lock<std::mutex> &lock );
+	void		evict( int32_t index );
+	void		readTileFromDisk( int32_t index, T *pixels );
+	void		writeTileToDisk( int32_t index, const T *pixels );
+	void		prefetchThreadFn();
+
+	int32_t					mWidth, mHeight, mTileSize, mNumTilesX, mNumTilesY;
+	SurfaceChannelOrder		mChannelOrder;
+	ptrdiff_t				mTileRowBytes;
+	size_t					mTileBytes, mMemoryBudget, mResidentBytes;
+	size_t					mNumPageIns, mNumPageOuts;
+
+	std::vector<Tile>		mTiles;
+	std::list<int32_t>		mLru; // most recently used first
+
+	fs::path				mCachePath;
+	bool					mRemoveCacheFile;
+	std::fstream			mCacheFile;
+	std::mutex				mCacheFileMutex;
+
+	mutable std::mutex		mMutex;
+	std::condition_variable	mTileLoadedCv, mPrefetchCv;
+	std::deque<int32_t>		mPrefetchQueue;
+	int32_t					mNumPrefetching;
+	std::thread				mPrefetchThread;
+	bool					mStopPrefetch;
+};
+
+class CI_API TiledSurfaceExc : public Exception {
+  public:
+	TiledSurfaceExc( const std::string &description ) : Exception( description ) {}
+};
+
+} // namespace cinder
@@ -68,6 +68,53 @@ class CI_API TriMesh : public geom::Source {
 		uint8_t		mTexCoords0Dims, mTexCoords1Dims, mTexCoords2Dims, mTexCoords3Dims;
 	};
 
+	//! Controls how write() stores a TriMesh in the chunked binary format, which can quantize its attributes and compress its indices
+	class CI_API WriteOptions {
+	  public:
+		WriteOptions() : mQuantizePositions( false ), mQuantizeNormals( false ), mQuantizeTexCoords( false ), mCompressIndices( false ) {}
+
+		//! Sets the attributes which are written. Default is empty, which writes all of them.
+		WriteOptions&	attribs( const geom::AttribSet &attribs ) { mAttribs = attribs; return *this; }
+		//! Stores positions as 16-bit values relative to their bounding box, which are precise to 1/65535 of its size. Default is \c false.
+		WriteOptions&	quantizePositions( bool quantize = true ) { mQuantizePositions = quantize; return *this; }
+		//! Stores normals, tangents and bitangents as two 16-bit octahedral coordinates, which keep their direction but not their length. Default is \c false.
+		WriteOptions&	quantizeNormals( bool quantize = true ) { mQuantizeNormals = quantize; return *this; }
+		//! Stores texture coordinates as half floats. Default is \c false.
+		WriteOptions&	quantizeTexCoords( bool quantize = true ) { mQuantizeTexCoords = quantize; return *this; }
+		//! Stores each index as the variable-length difference to the previous one, which takes one or two bytes rather than four for most meshes. Default is \c false.
+		WriteOptions&	compressIndices( bool compress = true ) { mCompressIndices = compress; return *this; }
+		//! Enables all of the quantizations and index compression.
+		WriteOptions&	compact() { return quantizePositions().quantizeNormals().quantizeTexCoords().compressIndices(); }
+
+		const geom::AttribSet&	getAttribs() const { return mAttribs; }
+		bool					getQuantizePositions() const { return mQuantizePositions; }
+		bool					getQuantizeNormals() const { return mQuantizeNormals; }
+		bool					getQuantizeTexCoords() const { return mQuantizeTexCoords; }
+		bool					getCompressIndices() const { return mCompressIndices; }
+
+	  private:
+		geom::AttribSet		mAttribs;
+		bool				mQuantizePositions, mQuantizeNormals, mQuantizeTexCoords, mCompressIndices;
+	};
+
+	//! Controls which parts of a file in the chunked binary format read() decodes
+	class CI_API ReadOptions {
+	  public:
+		ReadOptions() : mLod( 0 ) {}
+
+		//! Sets the attributes which are read. The chunks of the others aren't touched. Default is empty, which reads all of them.
+		ReadOptions&	attribs( const geom::AttribSet &attribs ) { mAttribs = attribs; return *this; }
+		//! Sets the level of detail which is read, as written by write( dataTarget, lods, options ). Default is \c 0.
+		ReadOptions&	lod( size_t lod ) { mLod = lod; return *this; }
+
+		const geom::AttribSet&	getAttribs() const { return mAttribs; }
+		size_t					getLod() const { return mLod; }
+
+	  private:
+		geom::AttribSet		mAttribs;
+		size_t				mLod;
+	};
+
 	static TriMeshRef	create() { return TriMeshRef( new TriMesh( Format().positions().normals().texCoords() ) ); }
 	static TriMeshRef	create( const Format &format ) { return TriMeshRef( new TriMesh( format ) ); }
 	static TriMeshRef	create( const geom::Source &source ) { return TriMeshRef( new TriMesh( source ) ); }
@@ -325,13 +372,22 @@ class CI_API TriMesh : public geom::Source {
 	AxisAlignedBox	calcBoundingBox( const mat4 &transform ) const;
 
 	//! Fills this TriMesh with the data from a binary file, which was created with TriMesh::write().
-	void		read( const DataSourceRef &dataSource );
+	void		read( const DataSourceRef &dataSource ) { read( dataSource, ReadOptions() ); }
+	/** Fills this TriMesh with the parts of a binary file selected by \a options. Files are mapped into memory, and in the chunked format only the chunks of the selected attributes
+		and level of detail are touched. Those chunks are decoded into this TriMesh's own storage, rather than referenced from the mapping. Files written without WriteOptions are always read whole. **/
+	void		read( const DataSourceRef &dataSource, const ReadOptions &options );
+	//! Returns the number of levels of detail in a binary file, which is \c 1 unless it was written by write( dataTarget, lods, options ).
+	static size_t	readNumLods( const DataSourceRef &dataSource );
 	//! Writes this TriMesh out to a binary data file.
 	void		write( const DataTargetRef &dataTarget ) const { write( dataTarget, ~0u ); }
 	//! Writes this TriMesh out to a binary data file. If \a writeNormals or \a writeTangents is \c true, normals and/or tangents are written to the file.
 	void		write( const DataTargetRef &dataTarget, bool writeNormals, bool writeTangents ) const;
 	//! Writes this TriMesh out to a binary data file. You can specify which attributes to write by supplying a list of \a attribs.
 	void		write( const DataTargetRef &dataTarget, const std::set<geom::Attrib> &attribs ) const;
+	//! Writes this TriMesh out to a binary data file in the chunked format, quantized and compressed according to \a options.
+	void		write( const DataTargetRef &dataTarget, const WriteOptions &options ) const;
+	//! Writes \a lods out to one binary data file in the chunked format, as levels of detail that read() selects between with ReadOptions::lod().
+	static void	write( const DataTargetRef &dataTarget, const std::vector<TriMeshRef> &lods, const WriteOptions &options );
 
 	/*! Adds or replaces normals by calculating them from the vertices and faces. If \a smooth is TRUE,
 		similar vertices are grouped together to calculate their average. This will not change the mesh,
@@ -367,8 +423,10 @@ class CI_API TriMesh : public geom::Source {
 	//! Returns whether or not the vertex, color etc. at both indices is the same.
 	bool		verticesEqual( uint32_t indexA, uint32_t indexB ) const;
 
+	void		readImplV3( const Buffer &buffer, const ReadOptions &options );
 	void		readImplV2( const IStreamRef &in );
 	void		readImplV1( const IStreamRef &in );
+	static void	writeImplV3( const DataTargetRef &dataTarget, const std::vector<const TriMesh*> &lods, const WriteOptions &options );
 
 	/*! Writes this TriMesh out to a binary data file. The \a writeMask parameter can be used to specify
 	 * what data should be included (e.g. toMask(POSITION) | toMask(COLOR) )
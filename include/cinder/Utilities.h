@@ -25,6 +25,7 @@
 #pragma once
 
 #include <string>
+#include <string_view>
 #include <vector>
 #include <functional>
 #include <map>
@@ -59,6 +60,9 @@ CI_API void launchWebBrowser( const Url &url );
 CI_API std::vector<std::string> split( const std::string &str, char separator, bool compress = true );
 //! Returns a vector of substrings split by the characters in \a separators. <tt>split( "one, two, three", " ," ) -> [ "one", "two", "three" ]</tt> If \a compress is \c true, it will consider consecutive separators as one.
 CI_API std::vector<std::string> split( const std::string &str, const std::string &separators, bool compress = true );
+/*! Returns the next token of \a str delimited by any of the characters in \a separators, and advances \a str past it. Consecutive separators are skipped, and an empty view is returned once only separators remain.
+	Never allocates, so <tt>while( ! ( token = nextToken( &line ) ).empty() )</tt> walks the tokens of a line returned by IStreamCinder::readLine( std::string_view* ) for free. */
+CI_API std::string_view nextToken( std::string_view *str, std::string_view separators = " \t" );
 
 //! Loads the contents of \a dataSource and returns it as a std::string
 CI_API std::string loadString( const DataSourceRef &dataSource );
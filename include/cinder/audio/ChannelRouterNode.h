@@ -26,6 +26,7 @@
 #include "cinder/audio/Node.h"
 
 #include <list>
+#include <vector>
 
 namespace cinder { namespace audio {
 
@@ -88,9 +89,10 @@ class CI_API ChannelRouterNode : public Node {
   protected:
 	bool supportsInputNumChannels( size_t numChannels ) const	override;
 	bool supportsProcessInPlace() const							override;
-	void sumInputs()											override;
 	void disconnectInput( const NodeRef &input )				override;
 
+	std::vector<InputRoute> getInputRoutes() const				override;
+
 	struct Route {
 		NodeRef	mInput;
 		size_t	mInputChannelIndex, mOutputChannelIndex, mNumChannels;
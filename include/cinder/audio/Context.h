@@ -28,7 +28,11 @@
 #include "cinder/audio/OutputNode.h"
 #include "cinder/Timer.h"
 
+#include <atomic>
+#include <functional>
 #include <list>
+#include <map>
+#include <memory>
 #include <mutex>
 #include <set>
 #include <thread>
@@ -36,6 +40,8 @@
 namespace cinder { namespace audio {
 
 class DeviceManager;
+class Param;
+class RenderThreadPool;
 
 //! \brief Manages the creation, connections, and lifecycle of audio::Node's.
 
@@ -43,7 +49,9 @@ class DeviceManager;
 //! 'audio' (real-time) and 'user' (typically UI/main, but not limited to) threads. There is one 'master',
 //! which is the only hardware-facing Context.
 //!
-//! All Node's are created using the Context, which is necessary for thread synchronization.
+//! All Node's are created using the Context, which is necessary for thread synchronization. The audio thread never waits on the
+//! user thread: changes to Node state reach it through a lock-free command queue (see submitCommand()), and changes to connections
+//! are compiled into a render list that the audio thread swaps in at the start of a processing block (see ScopedGraphEdit).
 class CI_API Context : public std::enable_shared_from_this<Context> {
   public:
 	virtual ~Context();
@@ -106,10 +114,10 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	virtual void disconnectAllNodes();
 
 	//! Add \a node to the list of auto-pulled nodes, who will have their Node::pullInputs() method called after a OutputDeviceNode implementation finishes pulling its inputs.
-	//! \note Callers on the non-audio thread must synchronize with getMutex().
+	//! \note Should be called from a non-audio thread, takes effect with the next render list.
 	void addAutoPulledNode( const NodeRef &node );
 	//! Remove \a node from the list of auto-pulled nodes.
-	//! \note Callers on the non-audio thread must synchronize with getMutex().
+	//! \note Should be called from a non-audio thread, takes effect with the next render list.
 	void removeAutoPulledNode( const NodeRef &node );
 
 	//! Schedule \a node to be enabled or disabled with with \a func on the audio thread, to be called at \a when seconds measured against getNumProcessedSeconds().
@@ -121,19 +129,41 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	//! \deprecated  use scheduleEvent() instead.
 	void schedule( double when, const NodeRef &node, bool callFuncBeforeProcess, const std::function<void ()> &func )	{ scheduleEvent( when, node, callFuncBeforeProcess, func ); }
 
-	//! Returns the mutex used to synchronize the audio thread. This is also used internally by the Node class when making connections.
+	//! Queues \a command to be run on the audio thread at the start of the next processing block. Commands run in the order they were submitted.
+	//! If this Context isn't enabled, pending commands and \a command are run immediately on the calling thread instead.
+	//! Commands submitted from a render thread (see setNumRenderThreads()) are queued as well, even though render threads count as the audio thread.
+	//! \note Should be called from a non-audio thread. Commands are destroyed on a non-audio thread, so they can own resources that are expensive to release.
+	void submitCommand( std::function<void ()> command );
+
+	//! Keeps the audio thread from processing until the outermost ScopedGraphEdit on this thread ends, after waiting for any block in progress to finish.
+	//! Blocks that start in the meantime are rendered as silence. Only needed for edits that can't be published as commands or with the render list,
+	//! such as changing the channel count or resources of a Node that may be processing. \note Must be called within the scope of a ScopedGraphEdit.
+	void suspendProcessingForGraphEdit();
+
+	//! Returns the mutex that the audio thread try-locks for the duration of each processing block. Blocks that find it held are rendered as silence,
+	//! so the audio thread never waits on it. \see suspendProcessingForGraphEdit()
 	std::mutex& getMutex() const			{ return mMutex; }
-	//! Returns true if the current thread is the thread used for audio processing, false otherwise.
+	//! Returns true if the current thread is processing an audio block, false otherwise. Render threads count as well.
 	bool isAudioThread() const;
 
-	//! OutputNode implementations should call this before each rendering block.
+	//! \brief Sets the number of worker threads that help the audio thread render each block. Default is 0, which renders everything on the audio thread.
+	//!
+	//! When non-zero, inputs of a summing Node that share no Node's with the rest of the graph (ex. voices summed by a GainNode) are rendered
+	//! in parallel, with the audio thread waiting for all of them before summing their results in the same order as when rendered serially.
+	//! Node's with a Param driven by a processor are always rendered on the audio thread. The workers take the scheduling policy and
+	//! priority of the audio thread, where the platform allows it. \note A Node rendered by a worker must only touch its own state from process().
+	void	setNumRenderThreads( size_t numThreads );
+	//! Returns the number of worker threads that help the audio thread render each block. \see setNumRenderThreads()
+	size_t	getNumRenderThreads() const;
+
+	//! OutputNode implementations should call this before each rendering block, while holding getMutex(). Runs submitted commands and swaps in the most recently compiled render list.
 	void preProcess();
 	//! OutputNode implementations should call this after each rendering block.
 	void postProcess();
 	//! Returns the time in seconds spent during the last process loop.
 	double getTimeDuringLastProcessLoop() const	{ return mTimeDuringLastProcessLoop; }
 
-	//! Returns nodes that are pulled by the graph (not connected to the output)
+	//! Returns nodes that are pulled by the graph (not connected to the output), as seen by the audio thread.
 	const	std::vector<Node *>& getAutoPulledNodes();
 
 	//! Returns a string representation of the Node graph for debugging purposes.
@@ -143,6 +173,9 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	Context();
 
   private:
+	struct Command;
+	struct RenderList;
+
 	struct ScheduledEvent {
 		ScheduledEvent( uint64_t eventFrameThreshold, const NodeRef &node, bool callFuncBeforeProcess, const std::function<void ()> &fn )
 			: mEventFrameThreshold( eventFrameThreshold ), mNode( node ), mCallFuncBeforeProcess( callFuncBeforeProcess ), mFunc( fn ), mProcessingEvent( false )
@@ -159,10 +192,21 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 	void	initRecursisve( const NodeRef &node, std::set<NodeRef> &traversedNodes  );
 	void	uninitRecursive( const NodeRef &node, std::set<NodeRef> &traversedNodes  );
 	void	processAutoPulledNodes();
+	void	renderSchedule( const RenderSchedule *schedule, Buffer *buffer );
 	void	preProcessScheduledEvents();
 	void	postProcessScheduledEvents();
 	void	incrementFrameCount();
 
+	void	setParamProcessor( const Param *param, const NodeRef &node );
+	void	beginGraphEdit();
+	void	endGraphEdit();
+	void	compileRenderList();
+	void	adoptRenderList();
+	void	pushCommand( Command *command );
+	Command* popCommand();
+	void	processCommands();
+	void	releaseRetired();
+
 	static void registerClearStatics();
 
 	bool						mEnabled;
@@ -174,16 +218,40 @@ class CI_API Context : public std::enable_shared_from_this<Context> {
 
 	// other nodes that don't have any outputs and need to be explicitly pulled
 	std::set<NodeRef>		mAutoPulledNodes;
-	std::vector<Node *>		mAutoPullCache;
-	bool					mAutoPullRequired, mAutoPullCacheDirty;
-	BufferDynamic			mAutoPullBuffer;
+	// nodes pulled by a Param, which are rendered without being connected
+	std::map<const Param *, NodeRef>	mParamProcessors;
+
+	// commands are pushed by any thread and popped by the audio thread (lock-free, multiple producer / single consumer)
+	std::atomic<Command *>		mCommandsHead;
+	Command*					mCommandsTail;
+	std::unique_ptr<Command>	mCommandStub;
+
+	// render lists are compiled on the user thread and swapped in by the audio thread at the start of a block. Each holds a
+	// RenderSchedule for every Node in the graph, so that the audio thread renders any part of it by walking an array.
+	RenderList*					mRenderList;
+	std::atomic<RenderList *>	mPendingRenderList;
+	std::atomic<bool>			mRenderListDirty;
+	std::atomic<size_t>			mGraphEditDepth;
+	std::atomic<bool>			mGraphEditSuspended; // read by submitCommand() from threads other than the one editing
+	std::recursive_mutex		mGraphEditMutex; // serializes graph edits and disabled-context commands made on different user threads
+
+	// worker threads for rendering in parallel, if enabled with setNumRenderThreads()
+	std::unique_ptr<RenderThreadPool>	mRenderThreadPool;
 
-	mutable std::mutex		mMutex;
-	std::thread::id			mAudioThreadId;
+	// commands and render lists the audio thread is done with, released on the user thread
+	std::atomic<Command *>		mRetiredCommands;
+	std::atomic<RenderList *>	mRetiredRenderLists;
+
+	mutable std::mutex				mMutex;
+	std::atomic<std::thread::id>	mAudioThreadId;
 
 	// - Context is stored in Node classes as a weak_ptr, so it needs to (for now) be created as a shared_ptr
 	static std::shared_ptr<Context>			sMasterContext;
 	static std::unique_ptr<DeviceManager>	sDeviceManager; // TODO: consider turning DeviceManager into a HardwareContext class
+
+	friend class Node;
+	friend class Param;
+	friend struct ScopedGraphEdit;
 };
 
 template<typename NodeT>
@@ -210,6 +278,22 @@ std::shared_ptr<NodeT> Context::makeNode( Args&&... args )
 inline Context* master()	{ return Context::master(); }
 
 
+//! \brief RAII-style utility class that batches changes to the audio graph made on a non-audio thread.
+//!
+//! Connections made or broken within the scope of the outermost ScopedGraphEdit are compiled into a new render list when it ends,
+//! which the audio thread swaps in at the start of its next processing block. Node's connection methods open one themselves, so
+//! this is only needed to publish several changes together. Edits made on different threads are serialized, so one waits for an
+//! outermost ScopedGraphEdit open on another thread to end. Has no effect on the audio thread.
+struct CI_API ScopedGraphEdit {
+	//! Constructs an object that will publish the graph changes made to \a context within the current scope. \a context may be null.
+	ScopedGraphEdit( Context *context );
+	//! Constructs an object that will publish the graph changes made to \a context within the current scope. \a context may be null.
+	ScopedGraphEdit( const ContextRef &context ) : ScopedGraphEdit( context.get() )	{}
+	~ScopedGraphEdit();
+  private:
+	Context*	mContext;
+};
+
 //! RAII-style utility class to set a \a Context's enabled state and have it restored at the end of the current scope block.
 struct CI_API  ScopedEnableContext {
 	//! Constructs an object that will store \a context's enabled state and restore it at the end of the current scope.
@@ -29,13 +29,17 @@
 
 #include <memory>
 #include <atomic>
+#include <functional>
 #include <set>
+#include <vector>
 
 namespace cinder { namespace audio {
 
 typedef std::shared_ptr<class Context>			ContextRef;
 typedef std::shared_ptr<class Node>				NodeRef;
 
+struct RenderSchedule;
+
 //! \brief Fundamental building block for creating an audio processing graph.
 //!
 //!	Node's allow for flexible combinations of synthesis, analysis, effects, file reading/writing, etc, and are designed so that
@@ -46,9 +50,11 @@ typedef std::shared_ptr<class Node>				NodeRef;
 //!
 //! Audio Node's are designed to operate on two different threads: a 'user' thread (i.e. main / UI) and an audio thread. Specifically,
 //! methods for connecting and disconnecting are expected to come from the 'user' thread, while the Node's process() and internal pulling
-//! methods are called from a hard real-time thread. A mutex is used (Context::getMutex()) to synchronize connection changes and pulling
-//! the audio graph. Note that if the Node's initialize() method is heavy, it can be called before connected to anything, so as to not
-//! block the audio graph. This must be done throught the Context::initializeNode() interface.
+//! methods are called from a hard real-time thread. Connection changes are compiled into a render list that the audio thread swaps in
+//! at the start of a processing block, which flattens the graph into a schedule of process() calls and buffer mixes so that rendering
+//! doesn't recurse through the Node's, and subclasses hand other changes to the audio thread with submitCommand(), so that pulling the
+//! audio graph never waits on the user thread. Note that if the Node's initialize() method is heavy, it can be called before connected
+//! to anything, so as to not stall the user thread while connecting. This must be done throught the Context::initializeNode() interface.
 //!
 //! Subclassing: implement process( Buffer *buffer ) to perform audio processing. A Node does not have access to its owning Context until
 //! initialize() is called, uninitialize() is called before a Node is deallocated or channel counts change.
@@ -174,8 +180,11 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 	Buffer*			getInternalBuffer()			{ return &mInternalBuffer; }
 	//! Usually used internally by a Node subclass, returns a pointer to the internal buffer storage.
 	const Buffer*	getInternalBuffer() const	{ return &mInternalBuffer; }
-	//! Usually called internally by the Node, in special cases sub-classes may need to call this on other Node's.
-	void			pullInputs( Buffer *inPlaceBuffer );
+	//! \brief Renders this Node and everything connected to its inputs into \a buffer, which should have getNumChannels() channels.
+	//!
+	//! Any Node connected to what the Context pulls (its OutputNode, auto-pulled Node's and Param processors) has a compiled render schedule, so a Node
+	//! can pull another from within process(). Node's that aren't connected to any of those render silence. Usually called internally by an OutputDeviceNode, from the audio thread.
+	void			pullInputs( Buffer *buffer );
 
   protected:
 
@@ -190,9 +199,23 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 	virtual void disableProcessing()		{}
 	//! Override to perform audio processing on \t buffer. Default implementation is empty.
 	virtual void process( Buffer *buffer );
-	//! Override to customize how input Nodes are summed into the internal summing buffer. You usually don't need to do this.
+	//! Called once per processing block on a Node that doesn't process in-place, after its inputs have been rendered and summed into the summing buffer
+	//! as described by getInputRoutes(). Default implementation process()es the summing buffer if enabled, then mixes it into the internal buffer.
+	//! \deprecated Override getInputRoutes() to customize how inputs are summed. The inputs have already been rendered when this is called, so pulling them renders silence.
 	virtual void sumInputs();
 
+	//! Describes how an input is summed into the summing buffer of a Node that doesn't process in-place. \see getInputRoutes()
+	struct InputRoute {
+		Node*	mInput;
+		//! When true, all of the input's channels are summed with up or down mixing. Otherwise mNumChannels channels starting at mInputChannelIndex are added to the channels starting at mOutputChannelIndex.
+		bool	mSumAllChannels = true;
+		size_t	mInputChannelIndex = 0, mOutputChannelIndex = 0, mNumChannels = 0;
+	};
+
+	//! Override to customize how input Nodes are summed into the internal summing buffer. You usually don't need to do this. Default returns one route per input that sums all of its channels.
+	//! \note Called on a non-audio thread, whenever the Context compiles its render schedules. Routes from the same input should be consecutive.
+	virtual std::vector<InputRoute> getInputRoutes() const;
+
 	//! Default implementation returns true if numChannels matches our format.
 	virtual bool supportsInputNumChannels( size_t numChannels ) const	{ return mNumChannels == numChannels; }
 	//! Default implementation returns false, return true if it makes sense for the Node to be processed in a cycle (eg. Delay).
@@ -200,7 +223,7 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 	//! Default implementation returns true, subclasses should return false if they must process out-of-place (summing).
 	virtual bool supportsProcessInPlace() const							{ return true; }
 
-	//! \note Connection methods \must be called on a non-audio thread and synchronized with the Context's mutex.
+	//! \note Connection methods must be called on a non-audio thread. The changes they make reach the audio thread with the Context's next render list.
 	virtual void connectInput( const NodeRef &input );
 	virtual void disconnectInput( const NodeRef &input );
 	virtual void disconnectOutput( const NodeRef &output );
@@ -210,6 +233,9 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 	void notifyConnectionsDidChange();
 	bool inputChannelsAreUnequal() const;
 
+	//! Runs \a command on the audio thread at the start of the next processing block, keeping this Node alive until then. \see Context::submitCommand()
+	void submitCommand( std::function<void ()> command );
+
 	//! Only Node subclasses can specify num channels directly - users specify via Format at construction time.
 	void setNumChannels( size_t numChannels );
 	//! Only Node subclasses can specify channel mode directly - users specify via Format at construction time.
@@ -249,8 +275,12 @@ class CI_API Node : public std::enable_shared_from_this<Node>, private Noncopyab
 	std::set<std::shared_ptr<Node> >	mInputs;
 	std::vector<std::weak_ptr<Node> >	mOutputs;
 
+	// only used on the audio thread, set by the Context when it swaps in a render list
+	const RenderSchedule*				mRenderSchedule;
+
 	friend class Context;
 	friend class Param;
+	friend struct RenderSchedule;
 };
 
 //! Enable connection syntax: `input >> output`, which is equivelant to `input->connect( output )`. Enables chaining.  \return the connected \a output
@@ -0,0 +1,81 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/audio/Context.h"
+#include "cinder/audio/OutputNode.h"
+#include "cinder/audio/Target.h"
+
+#include <functional>
+
+namespace cinder { namespace audio {
+
+typedef std::shared_ptr<class OfflineContext>	OfflineContextRef;
+
+//! \brief Context that renders its graph without a device, as fast as the CPU allows.
+//!
+//! Its output is an OutputNodeOffline, which is only pulled when one of the render() methods is called, on the calling thread. As with a
+//! device Context, nothing is rendered until enable() is called. The clock only advances as frames are rendered, so a graph and its Param
+//! events render identically every time, which makes it suitable for batch rendering and for testing Node's. Use a FilePlayerNode that
+//! doesn't read asynchronously, its read thread can't keep up with faster than real-time rendering.
+//!
+//! \code
+//! auto ctx = audio::OfflineContext::create( 48000 );
+//! auto sine = ctx->makeNode( new audio::GenSineNode( 440 ) );
+//! sine >> ctx->getOutput();
+//! sine->enable();
+//! ctx->enable();
+//! ctx->render( 48000 * 10, audio::TargetFile::create( "sine.wav", 48000, 2 ).get() );
+//! \endcode
+class CI_API OfflineContext : public Context {
+  public:
+	//! Creates an OfflineContext whose output renders \a numChannels channels at \a sampleRate, in blocks of \a framesPerBlock frames.
+	static OfflineContextRef create( size_t sampleRate = 44100, size_t framesPerBlock = 512, size_t numChannels = 2 );
+
+	//! Throws AudioContextExc, there are no devices to render to.
+	OutputDeviceNodeRef	createOutputDeviceNode( const DeviceRef &device = Device::getDefaultOutput(), const Node::Format &format = Node::Format() ) override;
+	//! Throws AudioContextExc, there are no devices to capture from.
+	InputDeviceNodeRef	createInputDeviceNode( const DeviceRef &device = Device::getDefaultInput(), const Node::Format &format = Node::Format() ) override;
+
+	//! Sets the output, which must be an OutputNodeOffline. Frames left over from the previous output's last block are discarded.
+	void setOutput( const OutputNodeRef &output ) override;
+
+	//! Renders the next \a numFrames frames into \a buffer, which is resized to \a numFrames frames and the output's number of channels.
+	void render( size_t numFrames, BufferDynamic *buffer );
+	//! Renders the next \a numFrames frames and writes them to \a target, which must have as many channels as the output.
+	void render( size_t numFrames, TargetFile *target );
+
+  protected:
+	OfflineContext();
+
+  private:
+	// Renders numFrames frames, calling fn( block, frameOffset, numFrames ) for each part of a block that they span. When numFrames
+	// isn't a multiple of the block size, the rest of the last block is kept for the next call.
+	void renderImpl( size_t numFrames, const std::function<void ( const Buffer *, size_t, size_t )> &fn );
+
+	OutputNodeOfflineRef	mOutputOffline;
+	size_t					mNumFramesLeftInBlock;
+};
+
+} } // namespace cinder::audio
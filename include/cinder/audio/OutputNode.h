@@ -30,6 +30,7 @@ namespace cinder { namespace audio {
 
 typedef std::shared_ptr<class OutputNode>			OutputNodeRef;
 typedef std::shared_ptr<class OutputDeviceNode>		OutputDeviceNodeRef;
+typedef std::shared_ptr<class OutputNodeOffline>	OutputNodeOfflineRef;
 
 //! Base class for Node's that consume an audio signal, for example speakers. It cannot have any outputs.
 class CI_API OutputNode : public Node {
@@ -56,8 +57,8 @@ class CI_API OutputNode : public Node {
 	bool checkNotClipping();
 
 	std::atomic<uint64_t>		mLastClip;
-	bool						mClipDetectionEnabled;
-	float						mClipThreshold;
+	std::atomic<bool>			mClipDetectionEnabled;
+	std::atomic<float>			mClipThreshold;
 
   private:
 	// OutputNode does not have outputs, overridden to assert this method isn't called
@@ -94,4 +95,29 @@ class CI_API OutputDeviceNode : public OutputNode {
 	signals::ScopedConnection	mWillChangeConn, mDidChangeConn, mInterruptionBeganConn, mInterruptionEndedConn;
 };
 
+//! \brief OutputNode that renders a block whenever render() is called, rather than when a device asks for one. \see OfflineContext
+//!
+//! Blocks are rendered on the calling thread as fast as the CPU allows. Each one advances the Context's clock by exactly
+//! getOutputFramesPerBlock() frames, so Param events and Node's enabled with Node::enable( when ) land on the same frame every time a graph
+//! is rendered. If the number of channels hasn't been specified via Node::Format, defaults to 2. Clip detection is disabled by default.
+class CI_API OutputNodeOffline : public OutputNode {
+  public:
+	OutputNodeOffline( size_t sampleRate = 44100, size_t framesPerBlock = 512, const Format &format = Format() );
+
+	//! Returns the samplerate specified at construction.
+	size_t getOutputSampleRate() override		{ return mSampleRate; }
+	//! Returns the frames per block specified at construction.
+	size_t getOutputFramesPerBlock() override	{ return mFramesPerBlock; }
+
+	//! Renders the next block into the internal buffer, or silence if this Node isn't enabled. Unlike a device, this waits for graph edits in
+	//! progress on other threads to finish instead of rendering silence. \note Must not be called within the scope of a ScopedGraphEdit.
+	void render();
+
+  protected:
+	bool supportsProcessInPlace() const override	{ return false; }
+
+  private:
+	size_t	mSampleRate, mFramesPerBlock;
+};
+
 } } // namespace cinder::audio
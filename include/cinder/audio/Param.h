@@ -89,7 +89,8 @@ class CI_API Event {
 //! You can also set a Node as the 'processor' with Param::setProcessor(), enabling you to control it with an arbitrary signal.
 //!
 //! A Param is owned by a parent Node, from which it gains access to the current Context.  This is a necessary step in making it sample
-//! accurate yet still controllable in a thread-safe manager on the user thread.
+//! accurate yet still controllable in a thread-safe manager on the user thread: changes are submitted as commands that the audio thread
+//! applies at the start of its next processing block, while queries like getNumEvents() are answered from the Event's submitted so far.
 //!
 //! \note Ramp Events should not overlap, or you may get discontinuities in the evaluated curve. This could potentially happen when
 //! using multiple appendRamp() calls. Instead, use applyRamp() and set Options::beginTime() accordingly, which will remove any
@@ -127,6 +128,7 @@ class CI_API Param {
 
 	//! Constructs a Param with a pointer (weak reference) to the owning parent Node and an optional \a initialValue (default = 0).
 	Param( Node *parentNode, float initialValue = 0 );
+	~Param();
 
 	//! Sets the value of the Param, blowing away any scheduled Event's or processing Node. \note Must be called from a non-audio thread.
 	void	setValue( float value );
@@ -172,19 +174,36 @@ class CI_API Param {
 	std::pair<double, float> findEndTimeAndValue() const;
 
   protected:
+	//! Holds what a command takes off the audio thread, so that it is destroyed along with the command on a user thread.
+	struct Retired {
+		std::list<EventRef>	mEvents;
+		NodeRef				mProcessor;
+	};
+
+	// audio thread methods, called from within commands
+	void		resetImpl( Retired *retired );
+	void		removeEventsAt( double time, std::list<EventRef> *removedEvents );
 
-	// non-locking protected methods
+	// user thread methods
 	void		initInternalBuffer();
-	void		resetImpl();
-	void		removeEventsAt( double time );
+	//! Clears the Events and processor seen by the user thread. Returns whether there was a processor, which callers remove from the render list after submitting the command that stops pulling it.
+	bool		resetUserState();
+	void		submitEvent( const EventRef &event, bool replaceLaterEvents );
+	void		submitCommand( std::function<void ()> command );
+	const Event*	findLastEvent( double currentTime ) const;
+	static bool	isExpired( const Event &event, double currentTime );
 	ContextRef	getContext() const;
 
-	std::list<EventRef>	mEvents;
+	std::list<EventRef>	mEvents;			// only used on the audio thread
+	std::list<EventRef>	mSubmittedEvents;	// mirrors mEvents on the user thread, minus the Event's that have expired since
 	std::atomic<float>	mValue;
 	bool				mIsVaryingThisBlock;
 	Node*				mParentNode;
-	NodeRef				mProcessor;
+	NodeRef				mProcessor;			// user thread
+	NodeRef				mRenderProcessor;	// audio thread
 	BufferDynamic		mInternalBuffer;
+
+	friend class Context;
 };
 
 } } // namespace cinder::audio
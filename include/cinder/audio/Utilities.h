@@ -30,11 +30,11 @@
 
 namespace cinder { namespace audio {
 
-//! Scale \a gainLinear from linear (0-1) to decibel (0-100) scale
+//! Scale \a gainLinear from linear (0-1) to decibel (0-100) scale. Gains below -100 decibels, and NaN, return 0.
 CI_API float linearToDecibel( float gainLinear );
 //! Scale \a array of length \a length from linear (0-1) to decibel (0-100) scale
 CI_API void linearToDecibel( float *array, size_t length );
-//! Scale \a gainLinear from decibel (0-100) to linear (0-1) scale
+//! Scale \a gainDecibels from decibel (0-100) to linear (0-1) scale. Inaudible values, and NaN, return 0.
 CI_API float decibelToLinear( float gainDecibels );
 //! Scale \a array of length \a length from decibel (0-100) to linear (0-1) scale
 CI_API void decibelToLinear( float *array, size_t length );
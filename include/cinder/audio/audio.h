@@ -44,6 +44,7 @@
 #include "cinder/audio/MonitorNode.h"
 #include "cinder/audio/InputNode.h"
 #include "cinder/audio/OutputNode.h"
+#include "cinder/audio/OfflineContext.h"
 #include "cinder/audio/SamplePlayerNode.h"
 #include "cinder/audio/SampleRecorderNode.h"
 
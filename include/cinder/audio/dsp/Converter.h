@@ -70,6 +70,37 @@ CI_API void sumBuffers( const Buffer *sourceBuffer, Buffer *destBuffer, size_t n
 //! Sums \a sourceBuffer into \a destBuffer. Channel up or down mixing is applied if necessary. Unequal frame counts are permitted (the minimum size will be used).
 inline void sumBuffers( const Buffer *sourceBuffer, Buffer *destBuffer )	{ sumBuffers( sourceBuffer, destBuffer, std::min( sourceBuffer->getNumFrames(), destBuffer->getNumFrames() ) ); }
 
+// The float overloads below are vectorized and take precedence over the generic templates that follow. Conversions to int
+// clip samples that are out of range, and the interleaving routines have fast paths for stereo and quad layouts.
+
+//! Converts a float array to int16_t. \a length samples are converted.
+CI_API void convert( const float *sourceArray, int16_t *destArray, size_t length );
+//! Converts an int16_t array to float. \a length samples are converted.
+CI_API void convert( const int16_t *sourceArray, float *destArray, size_t length );
+//! Converts the 24-bit int \a sourceArray to float, placing the result in \a destArray. \a length samples are converted.
+CI_API void convertInt24ToFloat( const char *sourceArray, float *destArray, size_t length );
+//! Converts the float \a sourceArray to 24-bit int precision, placing the result in \a destArray. \a length samples are converted.
+CI_API void convertFloatToInt24( const float *sourceArray, char *destArray, size_t length );
+//! Interleaves \a numCopyFrames of \a nonInterleavedSourceArray, placing the result in \a interleavedDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
+CI_API void interleave( const float *nonInterleavedSourceArray, float *interleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+//! Interleaves \a numCopyFrames of \a nonInterleavedFloatSourceArray and converts to 16-bit int precision at the same time, placing the result in \a interleavedInt16DestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
+CI_API void interleave( const float *nonInterleavedFloatSourceArray, int16_t *interleavedInt16DestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+//! De-interleaves \a numCopyFrames of \a interleavedSourceArray, placing the result in \a nonInterleavedDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
+CI_API void deinterleave( const float *interleavedSourceArray, float *nonInterleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+//! De-interleaves \a numCopyFrames of \a interleavedInt16SourceArray and converts to float at the same time, placing the result in \a nonInterleavedFloatDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
+CI_API void deinterleave( const int16_t *interleavedInt16SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+//! De-interleaves \a numCopyFrames of \a interleavedInt24SourceArray and converts to float at the same time, placing the result in \a nonInterleavedFloatDestArray. \a numFramesPerChannel and \a numChannels describe the layout of the non-interleaved array.
+CI_API void deinterleaveInt24ToFloat( const char *interleavedInt24SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames );
+
+//! Scales \a sample by \a scale and clips the result to [\a minValue, \a maxValue], as the conversions to int do. NaN becomes \a minValue.
+template<typename FloatT>
+inline int32_t scaleAndClip( FloatT sample, FloatT scale, FloatT minValue, FloatT maxValue )
+{
+	// written so that NaN fails the first comparison, as casting it to int is undefined
+	const FloatT scaled = sample * scale;
+	return int32_t( scaled >= minValue ? ( scaled < maxValue ? scaled : maxValue ) : minValue );
+}
+
 //! Converts between two arrays of different precision (ex. float to double). \a length samples are converted.
 template <typename SourceT, typename DestT>
 void convert( const SourceT *sourceArray, DestT *destArray, size_t length )
@@ -82,10 +113,8 @@ void convert( const SourceT *sourceArray, DestT *destArray, size_t length )
 template<typename FloatT>
 void convert( const FloatT *sourceArray, int16_t *destArray, size_t length )
 {
-	const FloatT intNormalizer = 32768;
-
 	for( size_t i = 0; i < length; i++ )
-		destArray[i] = int16_t( sourceArray[i] * intNormalizer );
+		destArray[i] = int16_t( scaleAndClip<FloatT>( sourceArray[i], 32768, -32768, 32767 ) );
 }
 
 //! Converts an int16_t array to float or double
@@ -126,10 +155,8 @@ void convertInt24ToFloat( const char *sourceArray, FloatT *destArray, size_t len
 template<typename FloatT>
 void convertFloatToInt24( const FloatT *sourceArray, char *destArray, size_t length )
 {
-	const FloatT intNormalizer = 8388607;
-
 	for( size_t i = 0; i < length; i++ ) {
-		int32_t sample = int32_t( sourceArray[i] * intNormalizer );
+		int32_t sample = scaleAndClip<FloatT>( sourceArray[i], 8388607, -8388608, 8388607 );
 		*(destArray++) = (char)( sample & 255 );
 		*(destArray++) = (char)( ( sample >> 8 ) & 255 );
 		*(destArray++) = (char)( ( sample >> 16 ) & 255 );
@@ -154,13 +181,11 @@ void interleave( const T *nonInterleavedSourceArray, T *interleavedDestArray, si
 template<typename FloatT>
 void interleave( const FloatT *nonInterleavedFloatSourceArray, int16_t *interleavedInt16DestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
 {
-	const FloatT intNormalizer = 32768;
-
 	for( size_t ch = 0; ch < numChannels; ch++ ) {
 		size_t x = ch;
 		const FloatT *sourceChannel = &nonInterleavedFloatSourceArray[ch * numFramesPerChannel];
 		for( size_t i = 0; i < numCopyFrames; i++ ) {
-			interleavedInt16DestArray[x] = int16_t( sourceChannel[i] * intNormalizer );
+			interleavedInt16DestArray[x] = int16_t( scaleAndClip<FloatT>( sourceChannel[i], 32768, -32768, 32767 ) );
 			x += numChannels;
 		}
 	}
@@ -206,7 +231,8 @@ void deinterleaveInt24ToFloat( const char *interleavedInt24SourceArray, FloatT *
 		size_t x = ch;
 		FloatT *destChannel = &nonInterleavedFloatDestArray[ch * numFramesPerChannel];
 		for( size_t i = 0; i < numCopyFrames; i++ ) {
-			int32_t sample = (int32_t)( ( (int32_t)interleavedInt24SourceArray[2] ) << 16 ) | ( ( (int32_t)(uint8_t)interleavedInt24SourceArray[1] ) << 8 ) | ( (int32_t)(uint8_t)interleavedInt24SourceArray[0] );
+			const char *source = &interleavedInt24SourceArray[x * 3];
+			int32_t sample = (int32_t)( ( (int32_t)source[2] ) << 16 ) | ( ( (int32_t)(uint8_t)source[1] ) << 8 ) | ( (int32_t)(uint8_t)source[0] );
 			destChannel[i] = (FloatT)sample * floatNormalizer;
 			x += numChannels;
 		}
@@ -232,43 +258,24 @@ void deinterleaveBuffer( const BufferInterleavedT<T> *interleavedSource, BufferT
 	deinterleave( interleavedSource->getData(), nonInterleavedDest->getData(), nonInterleavedDest->getNumFrames(), nonInterleavedDest->getNumChannels(), nonInterleavedDest->getNumFrames() );
 }
 
-//! Interleaves \a nonInterleavedSource, placing the result in \a interleavedDest. This method is only slightly faster than interleaveBuffer(), which can handle an arbitrary number of channels.
+//! Interleaves \a nonInterleavedSource, placing the result in \a interleavedDest. Equivalent to interleaveBuffer() for two channels.
 template<typename T>
 void interleaveStereoBuffer( const BufferT<T> *nonInterleavedSource, BufferInterleavedT<T> *interleavedDest )
 {
 	CI_ASSERT( interleavedDest->getNumChannels() == 2 && nonInterleavedSource->getNumChannels() == 2 );
 	CI_ASSERT( interleavedDest->getSize() <= nonInterleavedSource->getSize() );
 
-	size_t numFrames = interleavedDest->getNumFrames();
-	const T *left = nonInterleavedSource->getChannel( 0 );
-	const T *right = nonInterleavedSource->getChannel( 1 );
-
-	T *mixed = interleavedDest->getData();
-
-	size_t i, j;
-	for( i = 0, j = 0; i < numFrames; i++, j += 2 ) {
-		mixed[j] = left[i];
-		mixed[j + 1] = right[i];
-	}
+	interleave( nonInterleavedSource->getData(), interleavedDest->getData(), nonInterleavedSource->getNumFrames(), 2, interleavedDest->getNumFrames() );
 }
 
-//! De-interleaves \a interleavedSource, placing the result in \a nonInterleavedDest. This method is only slightly faster than deinterleaveStereoBuffer(), which can handle an arbitrary number of channels.
+//! De-interleaves \a interleavedSource, placing the result in \a nonInterleavedDest. Equivalent to deinterleaveBuffer() for two channels.
 template<typename T>
 void deinterleaveStereoBuffer( const BufferInterleavedT<T> *interleavedSource, BufferT<T> *nonInterleavedDest )
 {
 	CI_ASSERT( interleavedSource->getNumChannels() == 2 && nonInterleavedDest->getNumChannels() == 2 );
 	CI_ASSERT( nonInterleavedDest->getSize() <= interleavedSource->getSize() );
 
-	size_t numFrames = nonInterleavedDest->getNumFrames();
-	T *left = nonInterleavedDest->getChannel( 0 );
-	T *right = nonInterleavedDest->getChannel( 1 );
-	const T *mixed = interleavedSource->getData();
-
-	size_t i, j;
-	for( i = 0, j = 0; i < numFrames; i++, j += 2 ) {
-		left[i] = mixed[j];
-		right[i] = mixed[j + 1];
-	}
+	deinterleave( interleavedSource->getData(), nonInterleavedDest->getData(), nonInterleavedDest->getNumFrames(), 2, nonInterleavedDest->getNumFrames() );
 }
 
 } } } // namespace cinder::audio::dsp
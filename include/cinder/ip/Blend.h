@@ -27,6 +27,9 @@
 #include "cinder/Area.h"
 #include "cinder/Vector.h"
 #include "cinder/Surface.h"
+#include "cinder/ip/Parallel.h"
+
+#include <vector>
 
 namespace cinder { namespace ip {
 
@@ -35,5 +38,10 @@ CI_API inline void blend( Surface *background, const Surface &foreground ) { ble
 CI_API void blend( Surface32f *background, const Surface32f &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset = ivec2() );
 CI_API inline void blend( Surface32f *background, const Surface32f &foreground ) { blend( background, foreground, background->getBounds(), ivec2() ); }
 
+//! Composites each of \a layers in order onto \a background, producing the same result as calling blend() once per layer. Works through \a background in cache-sized bands of rows, applying every layer to a band before moving to the next.
+CI_API void blend( Surface *background, const std::vector<const Surface*> &layers, const Options &options = Options() );
+//! Composites each of \a layers in order onto \a background, producing the same result as calling blend() once per layer. Works through \a background in cache-sized bands of rows, applying every layer to a band before moving to the next.
+CI_API void blend( Surface32f *background, const std::vector<const Surface32f*> &layers, const Options &options = Options() );
+
 
 } } // namespace cinder::ip
\ No newline at end of file
@@ -21,6 +21,8 @@
 */
 
 #include "cinder/Surface.h"
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Parallel.h"
 
 namespace cinder { namespace ip {
 
@@ -66,4 +68,46 @@ CI_API void			stackBlur( Channel32f *channel, const Area &area, int radius );
 //! Create a blurred copy of \a channel using "stackBlur", a Gaussian-approximating algorithm by Mario Klingemann.
 CI_API Channel32f	stackBlurCopy( const Channel32f &channel, int radius );
 
+//! Blurs \a surface in-place with a separable Gaussian of standard deviation \a sigma. From a \a sigma of 8 the Gaussian is approximated by 5 box passes, so the cost per pixel stops growing with \a sigma.
+template<typename T>
+CI_API void			gaussianBlur( SurfaceT<T> *surface, float sigma, const Options &options = Options() );
+//! Blurs \a surface in-place in \a area with a separable Gaussian of standard deviation \a sigma. Pixels outside \a area are neither read nor written.
+template<typename T>
+CI_API void			gaussianBlur( SurfaceT<T> *surface, const Area &area, float sigma, const Options &options = Options() );
+//! Creates a copy of \a surface blurred with a separable Gaussian of standard deviation \a sigma.
+template<typename T>
+CI_API SurfaceT<T>	gaussianBlurCopy( const SurfaceT<T> &surface, float sigma, const Options &options = Options() );
+//! Blurs \a channel in-place with a separable Gaussian of standard deviation \a sigma.
+template<typename T>
+CI_API void			gaussianBlur( ChannelT<T> *channel, float sigma, const Options &options = Options() );
+//! Blurs \a channel in-place in \a area with a separable Gaussian of standard deviation \a sigma.
+template<typename T>
+CI_API void			gaussianBlur( ChannelT<T> *channel, const Area &area, float sigma, const Options &options = Options() );
+//! Creates a copy of \a channel blurred with a separable Gaussian of standard deviation \a sigma.
+template<typename T>
+CI_API ChannelT<T>	gaussianBlurCopy( const ChannelT<T> &channel, float sigma, const Options &options = Options() );
+
+//! Blurs \a surface in-place with a box filter of width 2 * \a radius + 1, applied \a passes times. Costs O(1) per pixel regardless of \a radius; 3 passes closely approximate a Gaussian.
+template<typename T>
+CI_API void			boxBlur( SurfaceT<T> *surface, int radius, int passes = 1, const Options &options = Options() );
+//! Blurs \a surface in-place in \a area with a box filter of width 2 * \a radius + 1, applied \a passes times.
+template<typename T>
+CI_API void			boxBlur( SurfaceT<T> *surface, const Area &area, int radius, int passes = 1, const Options &options = Options() );
+//! Creates a copy of \a surface blurred with a box filter of width 2 * \a radius + 1, applied \a passes times.
+template<typename T>
+CI_API SurfaceT<T>	boxBlurCopy( const SurfaceT<T> &surface, int radius, int passes = 1, const Options &options = Options() );
+//! Blurs \a channel in-place with a box filter of width 2 * \a radius + 1, applied \a passes times.
+template<typename T>
+CI_API void			boxBlur( ChannelT<T> *channel, int radius, int passes = 1, const Options &options = Options() );
+//! Blurs \a channel in-place in \a area with a box filter of width 2 * \a radius + 1, applied \a passes times.
+template<typename T>
+CI_API void			boxBlur( ChannelT<T> *channel, const Area &area, int radius, int passes = 1, const Options &options = Options() );
+//! Creates a copy of \a channel blurred with a box filter of width 2 * \a radius + 1, applied \a passes times.
+template<typename T>
+CI_API ChannelT<T>	boxBlurCopy( const ChannelT<T> &channel, int radius, int passes = 1, const Options &options = Options() );
+//! Sets each pixel of \a dstChannel to the mean of the (2 * \a radius + 1)^2 window around it, read from \a integralImage so that a table built once can serve several filters.
+/** Unlike the boxBlur() above, windows are clipped at the image edges rather than extended, so pixels near the edges average fewer samples. The cost per pixel is constant in \a radius. **/
+template<typename T>
+CI_API void			boxBlur( const IntegralImageT<T> &integralImage, int radius, ChannelT<T> *dstChannel, const Options &options = Options() );
+
 } } // namespace cinder::ip
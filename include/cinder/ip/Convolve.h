@@ -0,0 +1,110 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Surface.h"
+#include "cinder/ip/Parallel.h"
+
+#include <initializer_list>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+//! Determines how pixels beyond the edges of the source image are sampled by convolve()
+enum class BorderMode {
+	CLAMP,		//!< The nearest edge pixel is repeated: aaa|abcd|ddd
+	MIRROR,		//!< The image is reflected about its edge pixels: dcb|abcd|cba
+	WRAP,		//!< The image is tiled: bcd|abcd|abc
+	ZERO		//!< Pixels beyond the edges are zero
+};
+
+//! A 2D convolution kernel with an odd width and height, whose center weight is applied to the pixel being computed.
+/** Kernels whose weights are the outer product of a row and a column vector are detected on construction and applied
+	by convolve() as two 1D passes, which costs width + height rather than width * height multiplies per pixel. **/
+class CI_API ConvolutionKernel {
+  public:
+	//! Constructs a \a width x \a height kernel from the row-major \a weights. \a bias is added to every result.
+	ConvolutionKernel( int32_t width, int32_t height, const std::vector<float> &weights, float bias = 0 );
+	//! Constructs a \a width x \a height kernel from the row-major \a weights. \a bias is added to every result.
+	ConvolutionKernel( int32_t width, int32_t height, std::initializer_list<float> weights, float bias = 0 );
+
+	//! Returns the separable kernel whose weights are the outer product of \a columnWeights and \a rowWeights
+	static ConvolutionKernel	separable( const std::vector<float> &rowWeights, const std::vector<float> &columnWeights, float bias = 0 );
+	//! Returns the 3x3 Sobel kernel responding to horizontal gradients
+	static ConvolutionKernel	sobelX();
+	//! Returns the 3x3 Sobel kernel responding to vertical gradients
+	static ConvolutionKernel	sobelY();
+
+	//! Scales the weights so that they sum to \c 1. Has no effect when the weights sum to \c 0.
+	ConvolutionKernel&	normalize();
+
+	int32_t		getWidth() const { return mWidth; }
+	int32_t		getHeight() const { return mHeight; }
+	//! Returns the number of pixels the kernel extends to either side of its center horizontally
+	int32_t		getRadiusX() const { return mWidth / 2; }
+	//! Returns the number of pixels the kernel extends above and below its center
+	int32_t		getRadiusY() const { return mHeight / 2; }
+	float		getBias() const { return mBias; }
+	//! Returns the row-major weights, getWidth() * getHeight() values
+	const std::vector<float>&	getWeights() const { return mWeights; }
+
+	//! Returns whether the kernel is the outer product of getColumnWeights() and getRowWeights()
+	bool		isSeparable() const { return mSeparable; }
+	//! Returns the horizontal factor of a separable kernel
+	const std::vector<float>&	getRowWeights() const { return mRowWeights; }
+	//! Returns the vertical factor of a separable kernel
+	const std::vector<float>&	getColumnWeights() const { return mColumnWeights; }
+
+  private:
+	void	detectSeparable();
+
+	int32_t				mWidth, mHeight;
+	float				mBias;
+	bool				mSeparable;
+	std::vector<float>	mWeights, mRowWeights, mColumnWeights;
+};
+
+//! Convolves \a srcChannel with \a kernel into \a dstChannel. Integer results are rounded and clamped to the range of \a T. \a srcChannel and \a dstChannel may be the same.
+/** 3x3, 5x5 and separable kernels use dedicated SIMD paths. Rows are processed in bands across the threads requested by \a options. **/
+template<typename T>
+CI_API void convolve( const ChannelT<T> &srcChannel, const ConvolutionKernel &kernel, ChannelT<T> *dstChannel, BorderMode border = BorderMode::CLAMP, const Options &options = Options() );
+//! Convolves the \a srcArea of \a srcChannel with \a kernel into \a dstChannel at \a dstLT. Pixels outside \a srcArea but within \a srcChannel are sampled normally; \a border only applies beyond the edges of \a srcChannel.
+template<typename T>
+CI_API void convolve( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernel, ChannelT<T> *dstChannel, BorderMode border = BorderMode::CLAMP, const Options &options = Options() );
+//! Convolves the color channels of \a srcSurface with \a kernel into \a dstSurface, as well as alpha when both have it. \a srcSurface and \a dstSurface may be the same.
+template<typename T>
+CI_API void convolve( const SurfaceT<T> &srcSurface, const ConvolutionKernel &kernel, SurfaceT<T> *dstSurface, BorderMode border = BorderMode::CLAMP, const Options &options = Options() );
+//! Convolves the \a srcArea of \a srcSurface with \a kernel into \a dstSurface at \a dstLT.
+template<typename T>
+CI_API void convolve( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernel, SurfaceT<T> *dstSurface, BorderMode border = BorderMode::CLAMP, const Options &options = Options() );
+
+//! Convolves \a srcChannel with both \a kernelA and \a kernelB, which must have the same size, and stores the magnitude sqrt( a^2 + b^2 ) of the two responses in \a dstChannel, clamped to CHANTRAIT<T>::max().
+/** Evaluating both kernels in a single pass is how edgeDetectSobel() computes the gradient magnitude. **/
+template<typename T>
+CI_API void convolveMagnitude( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernelA, const ConvolutionKernel &kernelB, ChannelT<T> *dstChannel, BorderMode border = BorderMode::CLAMP, const Options &options = Options() );
+//! Convolves the color channels of \a srcSurface, and alpha when both surfaces have it, with both \a kernelA and \a kernelB, and stores the magnitude of the two responses in \a dstSurface.
+template<typename T>
+CI_API void convolveMagnitude( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernelA, const ConvolutionKernel &kernelB, SurfaceT<T> *dstSurface, BorderMode border = BorderMode::CLAMP, const Options &options = Options() );
+
+} } // namespace cinder::ip
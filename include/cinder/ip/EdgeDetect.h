@@ -23,16 +23,21 @@
 #pragma once
 
 #include "cinder/Surface.h"
+#include "cinder/ip/Parallel.h"
 
 namespace cinder { namespace ip {
 
+//! Stores the Sobel gradient magnitude of the \a srcArea of \a srcChannel in \a dstChannel at \a dstLT, clamped to CHANTRAIT<T>::max(). Edge pixels are repeated beyond the bounds of \a srcChannel.
 template<typename T>
-CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstOffset, ChannelT<T> *dstChannel );
+CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, ChannelT<T> *dstChannel, const Options &options = Options() );
+//! Stores the Sobel gradient magnitude of the color channels of the \a srcArea of \a srcSurface, and of alpha when both surfaces have it, in \a dstSurface at \a dstLT.
 template<typename T>
-CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstOffset, SurfaceT<T> *dstSuface );
+CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, SurfaceT<T> *dstSuface, const Options &options = Options() );
+//! Stores the Sobel gradient magnitude of \a srcChannel in \a dstChannel
 template<typename T>
-CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel );
+CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const Options &options = Options() );
+//! Stores the Sobel gradient magnitude of \a srcSurface in \a dstSuface
 template<typename T>
-CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSuface );
+CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSuface, const Options &options = Options() );
 
 } } // namespace cinder::ip
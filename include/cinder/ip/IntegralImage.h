@@ -0,0 +1,115 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Area.h"
+#include "cinder/Channel.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/ip/Parallel.h"
+
+#include <algorithm>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+//! Accumulator types used by IntegralImageT. The 8-bit sums are unsigned and may wrap on very large images, but the sum of any rectangle of fewer than 2^24 pixels is still exact.
+template<typename T> struct IntegralImageTraits {};
+template<> struct IntegralImageTraits<uint8_t>	{ typedef uint32_t Sum; typedef uint64_t SquaredSum; };
+template<> struct IntegralImageTraits<uint16_t>	{ typedef uint64_t Sum; typedef uint64_t SquaredSum; };
+template<> struct IntegralImageTraits<float>	{ typedef double Sum; typedef double SquaredSum; };
+
+//! Summed-area tables of a Channel, answering the sum, mean and variance of any rectangle in constant time.
+/** The tables are (width + 1) x (height + 1), where entry (x, y) holds the sum of all pixels above and to the left of pixel (x, y).
+	Building is row-parallel: each row is prefix-summed independently, followed by a scan down the columns. A single IntegralImageT
+	can be built once per frame and shared between any number of queries, adaptiveThreshold(), boxBlur() and normalizeLocalContrast(). **/
+template<typename T>
+class CI_API IntegralImageT {
+  public:
+	typedef typename IntegralImageTraits<T>::Sum			SumT;
+	typedef typename IntegralImageTraits<T>::SquaredSum		SquaredSumT;
+
+	IntegralImageT() : mWidth( 0 ), mHeight( 0 ), mHasSquaredSums( false ) {}
+	//! Builds the summed-area table of \a channel. When \a squaredSums is \c true the table of squared values used by getSquaredSum() and getVariance() is built as well.
+	explicit IntegralImageT( const ChannelT<T> &channel, bool squaredSums = false, const Options &options = Options() );
+
+	//! Rebuilds the tables from \a channel, reusing the existing storage when possible
+	void		update( const ChannelT<T> &channel, bool squaredSums = false, const Options &options = Options() );
+
+	int32_t		getWidth() const { return mWidth; }
+	int32_t		getHeight() const { return mHeight; }
+	ivec2		getSize() const { return ivec2( mWidth, mHeight ); }
+	Area		getBounds() const { return Area( 0, 0, mWidth, mHeight ); }
+	bool		hasSquaredSums() const { return mHasSquaredSums; }
+
+	//! Returns the sum of the pixels in [\a x1, \a x2) x [\a y1, \a y2). The rectangle must lie within getBounds().
+	SumT		getSum( int32_t x1, int32_t y1, int32_t x2, int32_t y2 ) const
+	{
+		const size_t stride = mWidth + 1;
+		return mSums[y2 * stride + x2] - mSums[y1 * stride + x2] - mSums[y2 * stride + x1] + mSums[y1 * stride + x1];
+	}
+	//! Returns the sum of the squared pixels in [\a x1, \a x2) x [\a y1, \a y2). The rectangle must lie within getBounds() and the squared-sum table must have been built.
+	SquaredSumT	getSquaredSum( int32_t x1, int32_t y1, int32_t x2, int32_t y2 ) const
+	{
+		CI_ASSERT_MSG( mHasSquaredSums, "IntegralImage built without squared sums" );
+		const size_t stride = mWidth + 1;
+		return mSquaredSums[y2 * stride + x2] - mSquaredSums[y1 * stride + x2] - mSquaredSums[y2 * stride + x1] + mSquaredSums[y1 * stride + x1];
+	}
+
+	//! Returns the sum of the pixels in \a area, which is clipped to getBounds()
+	SumT		getSum( const Area &area ) const { Area a = area.getClipBy( getBounds() ); return ( a.getWidth() > 0 && a.getHeight() > 0 ) ? getSum( a.x1, a.y1, a.x2, a.y2 ) : SumT( 0 ); }
+	//! Returns the sum of the squared pixels in \a area, which is clipped to getBounds()
+	SquaredSumT	getSquaredSum( const Area &area ) const { Area a = area.getClipBy( getBounds() ); return ( a.getWidth() > 0 && a.getHeight() > 0 ) ? getSquaredSum( a.x1, a.y1, a.x2, a.y2 ) : SquaredSumT( 0 ); }
+	//! Returns the mean of the pixels in \a area, which is clipped to getBounds(). Returns \c 0 for an empty area.
+	double		getMean( const Area &area ) const;
+	//! Returns the population variance of the pixels in \a area, which is clipped to getBounds(). Requires the squared-sum table.
+	double		getVariance( const Area &area ) const;
+
+	//! Returns the summed-area table, (getWidth() + 1) x (getHeight() + 1) values in row-major order
+	const SumT*			getSums() const { return mSums.data(); }
+	//! Returns the squared-sum table, laid out like getSums(), or \c nullptr if it was not built
+	const SquaredSumT*	getSquaredSums() const { return mHasSquaredSums ? mSquaredSums.data() : nullptr; }
+
+  private:
+	int32_t						mWidth, mHeight;
+	bool						mHasSquaredSums;
+	std::vector<SumT>			mSums;
+	std::vector<SquaredSumT>	mSquaredSums;
+};
+
+typedef IntegralImageT<uint8_t>		IntegralImage;
+typedef IntegralImageT<uint8_t>		IntegralImage8u;
+typedef IntegralImageT<uint16_t>	IntegralImage16u;
+typedef IntegralImageT<float>		IntegralImage32f;
+
+//! Normalizes the local contrast of \a srcChannel into \a dstChannel, replacing each pixel by its z-score ( value - mean ) / stddev over the (2 * \a radius + 1)^2 window around it.
+/** \a integralImage must have been built from \a srcChannel with squared sums. Windows are clipped at the edges of the image. Float results are the z-score itself;
+	8-bit results are mapped to 128 + 32 * z and clamped, so +/-4 standard deviations span the full range. **/
+template<typename T>
+CI_API void normalizeLocalContrast( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int radius, ChannelT<T> *dstChannel, const Options &options = Options() );
+//! Normalizes the local contrast of \a srcChannel into \a dstChannel, building the required IntegralImageT internally.
+template<typename T>
+CI_API void normalizeLocalContrast( const ChannelT<T> &srcChannel, int radius, ChannelT<T> *dstChannel, const Options &options = Options() );
+
+} } // namespace cinder::ip
@@ -0,0 +1,62 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+
+#include <functional>
+#include <memory>
+
+namespace cinder {
+
+typedef std::shared_ptr<class SurfacePool> SurfacePoolRef;
+
+namespace ip {
+
+//! Options which control how the ip:: functions that support them distribute their work
+class CI_API Options {
+  public:
+	Options() : mNumThreads( 1 ) {}
+
+	//! Sets the number of threads used to process the destination in row bands. A value of \c 0 uses one thread per hardware thread. Default is \c 1.
+	Options&	threads( int numThreads ) { mNumThreads = numThreads; return *this; }
+	//! Returns the number of threads requested. A value of \c 0 implies one thread per hardware thread.
+	int			getThreads() const { return mNumThreads; }
+	//! Returns the number of threads that will actually be used to process \a numRows rows, which is at least \c 1.
+	int			getNumThreadsForRows( int32_t numRows ) const;
+
+	//! Sets a SurfacePool from which the \c *Copy functions allocate the Surfaces they return. Default is \c nullptr, which allocates from the heap.
+	Options&				pool( const SurfacePoolRef &pool ) { mPool = pool; return *this; }
+	//! Returns the SurfacePool used by the \c *Copy functions, or \c nullptr.
+	const SurfacePoolRef&	getPool() const { return mPool; }
+
+  private:
+	int				mNumThreads;
+	SurfacePoolRef	mPool;
+};
+
+//! Splits the rows [\a rowBegin, \a rowEnd) into contiguous bands and calls \a fn( bandBegin, bandEnd ) once per band, using the threads requested by \a options. Bands are processed by a persistent pool of worker threads shared by all calls, and by the calling thread, which returns once all bands are complete.
+CI_API void parallelForRows( int32_t rowBegin, int32_t rowEnd, const Options &options, const std::function<void( int32_t, int32_t )> &fn );
+
+} } // namespace cinder::ip
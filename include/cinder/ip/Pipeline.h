@@ -0,0 +1,89 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#pragma once
+
+#include "cinder/Cinder.h"
+#include "cinder/Color.h"
+#include "cinder/Surface.h"
+#include "cinder/ip/Parallel.h"
+
+#include <vector>
+
+namespace cinder { namespace ip {
+
+//! Records a chain of point-wise ip:: operations on a Surface and executes them fused in a single pass.
+/** The source is read and the destination written once, in tiles of rows sized to stay resident in the L2 cache, with every
+	recorded operation applied to a tile before moving on to the next. Each operation produces the same result as the equivalent
+	standalone ip:: function. Example: \code ip::Pipeline( src ).grayscale().threshold( 128 ).flipVertical().run( &dst ); \endcode
+	The source Surface is referenced rather than copied, so it must outlive the calls to run(). **/
+template<typename T>
+class CI_API PipelineT {
+  public:
+	explicit PipelineT( const SurfaceT<T> &source );
+
+	//! Replaces red, green and blue with their luminance, as in ip::grayscale()
+	PipelineT&	grayscale();
+	//! Sets red, green and blue to zero when they are less than or equal to \a value and to unity otherwise, as in ip::threshold()
+	PipelineT&	threshold( T value );
+	//! Premultiplies color by alpha, as in ip::premultiply()
+	PipelineT&	premultiply();
+	//! Divides color by alpha, as in ip::unpremultiply()
+	PipelineT&	unpremultiply();
+	//! Sets every pixel to \a color, as in ip::fill()
+	PipelineT&	fill( const ColorT<T> &color );
+	//! Sets every pixel to \a color, as in ip::fill()
+	PipelineT&	fill( const ColorAT<T> &color );
+	//! Flips the result upside-down, as in ip::flipVertical()
+	PipelineT&	flipVertical();
+	//! Mirrors the result left-to-right, as in ip::flipHorizontal()
+	PipelineT&	flipHorizontal();
+
+	//! Executes the recorded operations, writing the result into \a dstSurface, which may be the source itself. Only the region shared by the source and \a dstSurface is processed.
+	void		run( SurfaceT<T> *dstSurface, const Options &options = Options() ) const;
+	//! Executes the recorded operations, returning the result in a new Surface with the source's size and channel order
+	SurfaceT<T>	run( const Options &options = Options() ) const;
+
+	//! Returns the number of operations recorded, not counting flips
+	size_t		getNumOperations() const { return mOperations.size(); }
+
+  private:
+	enum OperationType { GRAYSCALE, THRESHOLD, PREMULTIPLY, UNPREMULTIPLY, FILL };
+	struct Operation {
+		OperationType	mType;
+		ColorAT<T>		mValue;
+	};
+
+	PipelineT&	addOperation( OperationType type, const ColorAT<T> &value = ColorAT<T>() );
+	void		processTile( const SurfaceT<T> &source, SurfaceT<T> *dstSurface, const ivec2 &size, int32_t rowBegin, int32_t rowEnd, std::vector<T> *tileBuffer ) const;
+
+	const SurfaceT<T>		*mSource;
+	std::vector<Operation>	mOperations;
+	bool					mFlipVertical, mFlipHorizontal;
+};
+
+typedef PipelineT<uint8_t>	Pipeline;
+typedef PipelineT<uint8_t>	Pipeline8u;
+typedef PipelineT<float>	Pipeline32f;
+
+} } // namespace cinder::ip
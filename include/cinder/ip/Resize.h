@@ -25,19 +25,21 @@
 #include "cinder/Surface.h"
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
+#include "cinder/ip/Parallel.h"
 
 namespace cinder { namespace ip {
 
+//! Scales \a srcSurface to fill \a dstSurface using filter \a filter. Use \a options to process the destination rows on multiple threads; the result is identical to the single-threaded path.
 template<typename T>
-CI_API void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const FilterBase &filter = FilterTriangle() );
+CI_API void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const FilterBase &filter = FilterTriangle(), const Options &options = Options() );
 template<typename T>
-CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter = FilterTriangle() );
+CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter = FilterTriangle(), const Options &options = Options() );
 template<typename T>
-CI_API void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter = FilterTriangle() );
+CI_API void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter = FilterTriangle(), const Options &options = Options() );
 //! Returns a new Surface which is a copy of \a srcSurface's area \a srcArea scaled to size \a dstSize using filter \a filter
 template<typename T>
-CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter = FilterTriangle() );
+CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter = FilterTriangle(), const Options &options = Options() );
 template<typename T>
-CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter = FilterTriangle() );
+CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter = FilterTriangle(), const Options &options = Options() );
 
 } } // namespace cinder::ip
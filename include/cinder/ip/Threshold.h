@@ -24,6 +24,8 @@
 
 #include "cinder/Cinder.h"
 #include "cinder/Surface.h"
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Parallel.h"
 
 #include <vector>
 
@@ -44,36 +46,37 @@ CI_API void threshold( const ChannelT<T> &srcSurface, T value, ChannelT<T> *dstS
 //! Thresholds \a srcChannel using an adaptive thresholding algorithm which considers a window of size \a windowSize pixels and stores the result in \a dstChannel.
 /** Implements the algorithm described in "Adaptive Thresholding Using the Integral Image" by Bradley & Roth. The srcSurface.getWidth() / 8 is a good default for \a windowSize and 0.15 is for \a percentageDelta **/
 template<typename T>
-CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
+CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options = Options() );
+//! Thresholds \a srcChannel using an adaptive thresholding algorithm which considers a window of size \a windowSize pixels, reading window sums from \a integralImage, which must have been built from \a srcChannel.
+template<typename T>
+CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options = Options() );
 //! Thresholds \a srcChannel using an adaptive thresholding algorithm which considers a window of size \a windowSize pixels.
 /** Implements the algorithm described in "Adaptive Thresholding Using the Integral Image" by Bradley & Roth. The srcSurface.getWidth() / 8 is a good default for \a windowSize and 0.15 is for \a percentageDelta **/
 template<typename T>
-CI_API void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta );
+CI_API void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta, const Options &options = Options() );
 //! Thresholds \a srcChannel using an adaptive thresholding algorithm which considers a window of size \a windowSize pixels. Equivalent to calling adaptiveThreshold with a 0 for percentageDelta
 /** Implements the algorithm described in "Adaptive Thresholding Using the Integral Image" by Bradley & Roth. The srcSurface.getWidth() / 8 is a good default for \a windowSize **/
 template<typename T>
-CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize );
+CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize, const Options &options = Options() );
 
 template<typename T>
-CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
+CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel, const Options &options = Options() );
 
 template<typename T>
 class CI_API AdaptiveThresholdT {
   public:
-	AdaptiveThresholdT()	{}
+	AdaptiveThresholdT() : mChannel( nullptr ) {}
 	//! Uses \a channel as source, but not assume ownership
-	AdaptiveThresholdT( const ChannelT<T> *channel );
+	AdaptiveThresholdT( const ChannelT<T> *channel, const Options &options = Options() );
 
-	void calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel );
+	void calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options = Options() );
 
- private:
-	typedef typename CHANTRAIT<T>::Accum SUMT;
+	//! Returns the integral image of the source, which may be shared with other window queries
+	const IntegralImageT<T>&	getIntegralImage() const { return mIntegralImage; }
 
+ private:
 	const ChannelT<T>*	mChannel;
-	int32_t				mImageWidth;
-	int32_t				mImageHeight;
-	uint8_t				mIncrement;
-	std::vector<SUMT>	mIntegralImage;
+	IntegralImageT<T>	mIntegralImage;
 };
 
 typedef AdaptiveThresholdT<uint8_t>		AdaptiveThreshold;
@@ -55,14 +55,17 @@ list( APPEND CINDER_INCLUDE_SYSTEM_PRIVATE
 
 # find cross-platform packages
 
-# TODO: this can cause a system include location to appear before cinder/include's,
-# we need to ensure that can't happen before using this
-#find_package( PNG )
+# libpng is optional; when found, ImageSourcePng and ImageTargetPng are built (MSW uses the copy in include/msw/png).
+# Its include dirs are appended after cinder/include's as system includes, the same as zlib's on Linux.
+if( NOT CINDER_MSW )
+	find_package( PNG )
+endif()
 
 if( PNG_FOUND )
 	list( APPEND CINDER_INCLUDE_SYSTEM_PRIVATE
 		${PNG_INCLUDE_DIRS}
 	)
+	list( APPEND CINDER_LIBS_DEPENDS ${PNG_LIBRARIES} )
 endif()
 
 if( CINDER_FREETYPE_USE_SYSTEM )
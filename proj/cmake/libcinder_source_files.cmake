@@ -30,6 +30,7 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/GeomIo.cpp
 	${CINDER_SRC_DIR}/cinder/ImageFileTinyExr.cpp
 	${CINDER_SRC_DIR}/cinder/ImageIo.cpp
+	${CINDER_SRC_DIR}/cinder/ImageLoader.cpp
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileRadiance.cpp
 	${CINDER_SRC_DIR}/cinder/ImageSourceFileStbImage.cpp
 	${CINDER_SRC_DIR}/cinder/ImageTargetFileStbImage.cpp
@@ -53,8 +54,10 @@ list( APPEND SRC_SET_CINDER
 	${CINDER_SRC_DIR}/cinder/Sphere.cpp
 	${CINDER_SRC_DIR}/cinder/Stream.cpp
 	${CINDER_SRC_DIR}/cinder/Surface.cpp
+	${CINDER_SRC_DIR}/cinder/SurfacePool.cpp
 	${CINDER_SRC_DIR}/cinder/System.cpp
 	${CINDER_SRC_DIR}/cinder/Text.cpp
+	${CINDER_SRC_DIR}/cinder/TiledSurface.cpp
 	${CINDER_SRC_DIR}/cinder/Timeline.cpp
 	${CINDER_SRC_DIR}/cinder/TimelineItem.cpp
 	${CINDER_SRC_DIR}/cinder/Timer.cpp
@@ -114,6 +117,7 @@ if( NOT CINDER_DISABLE_AUDIO )
 		${CINDER_SRC_DIR}/cinder/audio/Node.cpp
 		${CINDER_SRC_DIR}/cinder/audio/NodeMath.cpp
 		${CINDER_SRC_DIR}/cinder/audio/MonitorNode.cpp
+		${CINDER_SRC_DIR}/cinder/audio/OfflineContext.cpp
 		${CINDER_SRC_DIR}/cinder/audio/OutputNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/PanNode.cpp
 		${CINDER_SRC_DIR}/cinder/audio/Param.cpp
@@ -189,6 +193,7 @@ list( APPEND SRC_SET_CINDER_IP
 	${CINDER_SRC_DIR}/cinder/ip/Blend.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Blur.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Checkerboard.cpp
+	${CINDER_SRC_DIR}/cinder/ip/Convolve.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Fill.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Grayscale.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Premultiply.cpp
@@ -196,6 +201,9 @@ list( APPEND SRC_SET_CINDER_IP
 	${CINDER_SRC_DIR}/cinder/ip/EdgeDetect.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Flip.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Hdr.cpp
+	${CINDER_SRC_DIR}/cinder/ip/IntegralImage.cpp
+	${CINDER_SRC_DIR}/cinder/ip/Parallel.cpp
+	${CINDER_SRC_DIR}/cinder/ip/Pipeline.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Resize.cpp
 	${CINDER_SRC_DIR}/cinder/ip/Trim.cpp
 )
@@ -280,13 +288,14 @@ source_group( "thirdparty\\libtess" FILES   ${SRC_SET_LIBTESS} )
 # libpng
 # ----------------------------------------------------------------------------------------------------------------------
 
-# ImageSourcePng: always included on Windows (user must link against libpng to use it)
+# ImageSourcePng, ImageTargetPng: always included on Windows (user must link against libpng to use them)
 # On other platforms, only include if PNG_FOUND
 if( CINDER_MSW OR PNG_FOUND )
 	list( APPEND CINDER_SRC_FILES
 		${CINDER_SRC_DIR}/cinder/ImageSourcePng.cpp
+		${CINDER_SRC_DIR}/cinder/ImageTargetPng.cpp
 	)
-	source_group( "cinder" FILES ${CINDER_SRC_DIR}/cinder/ImageSourcePng.cpp )
+	source_group( "cinder" FILES ${CINDER_SRC_DIR}/cinder/ImageSourcePng.cpp ${CINDER_SRC_DIR}/cinder/ImageTargetPng.cpp )
 endif()
 
 if( CINDER_IMGUI_ENABLED )
@@ -24,6 +24,11 @@ target_link_libraries( cinder PUBLIC ${CINDER_LIBS_DEPENDS}  )
 
 target_compile_definitions( cinder PUBLIC ${CINDER_DEFINES} )
 
+# CINDER_PNG - lets the platforms that don't decode PNGs natively register ImageSourcePng and ImageTargetPng
+if( PNG_FOUND )
+	target_compile_definitions( cinder PRIVATE CINDER_PNG )
+endif()
+
 # DLL/Shared library support
 if( BUILD_SHARED_LIBS )
 	# CINDER_SHARED_BUILD - used when building the DLL (dllexport)
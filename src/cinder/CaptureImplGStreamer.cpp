@@ -146,52 +146,6 @@ std::pair<PipelineType, int> codecToPipeline( Capture::Mode::Codec codec )
 
 } // namespace
 
-// CaptureImplGStreamer::SurfaceCache
-
-class CaptureImplGStreamer::SurfaceCache {
-  public:
-	SurfaceCache( int32_t width, int32_t height, SurfaceChannelOrder sco, int numSurfaces )
-		: mWidth( width )
-		, mHeight( height )
-		, mSCO( sco )
-	{
-		mSurfaces.resize( numSurfaces );
-		allocateSurfaces();
-	}
-
-	Surface8uRef getNewSurface()
-	{
-		auto it = find_if( mSurfaces.begin(), mSurfaces.end(), []( const Surface8uRef& s ) { return s && s.use_count() == 1; } );
-		if( it == mSurfaces.end() ) {
-			mSurfaces.push_back( Surface8u::create( mWidth, mHeight, mSCO.hasAlpha(), mSCO ) );
-			it = prev( mSurfaces.end() );
-		}
-		return *it;
-	}
-
-	void resize( int32_t width, int32_t height )
-	{
-		if( ( width == mWidth ) && ( height == mHeight ) )
-			return;
-		mWidth = width;
-		mHeight = height;
-		allocateSurfaces();
-	}
-
-  private:
-	void allocateSurfaces()
-	{
-		for( auto& surface : mSurfaces ) {
-			surface = Surface8u::create( mWidth, mHeight, mSCO.hasAlpha(), mSCO );
-		}
-	}
-
-	vector<Surface8uRef> mSurfaces;
-	int32_t				 mWidth = 0;
-	int32_t				 mHeight = 0;
-	SurfaceChannelOrder	 mSCO;
-};
-
 // static
 void CaptureImplGStreamer::ensureGStreamerInitialized()
 {
@@ -521,7 +475,7 @@ std::vector<Capture::Mode> CaptureImplGStreamer::Device::getModes() const
 }
 
 CaptureImplGStreamer::CaptureImplGStreamer( int32_t width, int32_t height, const Capture::DeviceRef device )
-	: mSurfaceCache()
+	: mSurfacePool( SurfacePool::create( SurfacePool::Format().maxIdleSurfaces( 4 ) ) )
 	, mCurrentFrame()
 	, mHasNewFrame( false )
 	, mPipeline( nullptr )
@@ -558,7 +512,7 @@ CaptureImplGStreamer::CaptureImplGStreamer( int32_t width, int32_t height, const
 }
 
 CaptureImplGStreamer::CaptureImplGStreamer( const Capture::DeviceRef& device, const Capture::Mode& mode )
-	: mSurfaceCache()
+	: mSurfacePool( SurfacePool::create( SurfacePool::Format().maxIdleSurfaces( 4 ) ) )
 	, mCurrentFrame()
 	, mHasNewFrame( false )
 	, mPipeline( nullptr )
@@ -1174,12 +1128,8 @@ GstFlowReturn CaptureImplGStreamer::handleSample( GstSample* sample )
 	{
 		lock_guard<mutex> lock( mMutex );
 
-		if( ! mSurfaceCache )
-			mSurfaceCache = make_unique<SurfaceCache>( width, height, kCaptureChannelOrder, 4 );
-		else
-			mSurfaceCache->resize( width, height );
-
-		Surface8uRef   surface = mSurfaceCache->getNewSurface();
+		// frames still held by the application return to the pool when released; storage of a previous size ages out of it
+		Surface8uRef   surface = mSurfacePool->acquireRef<uint8_t>( width, height, kCaptureChannelOrder.hasAlpha(), kCaptureChannelOrder );
 		uint8_t*	   dst = surface->getData();
 		int32_t		   dstStride = surface->getRowBytes();
 		const uint8_t* src = mapInfo.data;
@@ -49,6 +49,8 @@ class ImageTargetChannel : public ImageTarget {
 			setDataType( ImageIo::UINT16 );
 		else if( std::is_same<T,uint8_t>::value )
 			setDataType( ImageIo::UINT8 );
+		else if( std::is_same<T,half_float>::value )
+			setDataType( ImageIo::FLOAT16 );
 		else 
 			throw; // what is this?
 
@@ -80,6 +82,9 @@ class ImageSourceChannel : public ImageSource {
 		else if( std::is_same<T,float>::value ) {
 			setDataType( ImageIo::FLOAT32 );
 		}
+		else if( std::is_same<T,half_float>::value ) {
+			setDataType( ImageIo::FLOAT16 );
+		}
 		else
 			throw; // this channel seems to be a type we've never met
 		mRowBytes = channel.getRowBytes();
@@ -253,7 +258,7 @@ T ChannelT<T>::areaAverage( const Area &area ) const
 	const Area clipped( area.getClipBy( getBounds() ) );
 	
 	if( ( clipped.getWidth() <= 0 ) || ( clipped.getHeight() <= 0 ) )
-		return 0;
+		return fromChanSum<T>( 0 );
 
 	uint8_t increment = mIncrement;
 	ptrdiff_t rowBytes = mRowBytes;
@@ -262,18 +267,19 @@ T ChannelT<T>::areaAverage( const Area &area ) const
 	for( int32_t y = clipped.y1; y < clipped.y2; ++y ) {
 		const T *d = line;
 		for( int32_t x = clipped.x1; x < clipped.x2; ++x ) {
-			sum += *d;
+			sum += toChanSum( *d );
 			d += increment;
 		}
 		
 		line = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( line ) + rowBytes );
 	} 
 	
-	return static_cast<T>( sum / ( clipped.getWidth() * clipped.getHeight() ) );
+	return fromChanSum<T>( sum / ( clipped.getWidth() * clipped.getHeight() ) );
 }
 
 template class CI_API ChannelT<uint8_t>;
 template class CI_API ChannelT<uint16_t>;
 template class CI_API ChannelT<float>;
+template class CI_API ChannelT<half_float>;
 
 } // namespace cinder
@@ -600,10 +600,11 @@ glm::tvec2<T, glm::defaultp> getClosestPointCubic( const glm::tvec2<T, glm::defa
 template CI_API glm::tvec2<float, glm::defaultp> getClosestPointCubic<float>( const glm::tvec2<float, glm::defaultp> *controlPoints, const glm::tvec2<float, glm::defaultp> & testPoint );
 template CI_API glm::tvec2<double, glm::defaultp> getClosestPointCubic<double>( const glm::tvec2<double, glm::defaultp> *controlPoints, const glm::tvec2<double, glm::defaultp> & testPoint );
 
+// the bit pattern comes first, so that brace initializers such as { 15 << 23 } set the bits rather than the value
 union float32_t
 {
-	float f;
 	uint u;
+	float f;
 	struct {
 		uint Mantissa : 23;
 		uint Exponent : 8;
@@ -647,7 +648,9 @@ static half_float float_to_half( float32_t f )
 
 cinder::half_float floatToHalf( float f )
 {
-	return float_to_half( float32_t( { f } ) );
+	float32_t v;
+	v.f = f;
+	return float_to_half( v );
 }
 
 // Algorithm due to Fabian "ryg" Giesen.
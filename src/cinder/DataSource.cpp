@@ -89,6 +89,38 @@ IStreamRef DataSourcePath::createStream()
 }
 
 
+/////////////////////////////////////////////////////////////////////////////
+// DataSourceMapped
+DataSourceMappedRef DataSourceMapped::create( const fs::path &path, MappedFile::Access access )
+{
+	return DataSourceMappedRef( new DataSourceMapped( path, access ) );
+}
+
+DataSourceMapped::DataSourceMapped( const fs::path &path, MappedFile::Access access )
+	: DataSource( path, Url() ), mAccess( access )
+{
+	setFilePathHint( path );
+}
+
+const MappedFileRef& DataSourceMapped::getMappedFile()
+{
+	if( ! mMappedFile )
+		mMappedFile = MappedFile::create( mFilePath, mAccess );
+
+	return mMappedFile;
+}
+
+void DataSourceMapped::createBuffer()
+{
+	// DataSource hands out mutable Buffers, this one views read-only memory as the class documents
+	mBuffer = std::const_pointer_cast<Buffer>( getMappedFile()->createBuffer() );
+}
+
+IStreamRef DataSourceMapped::createStream()
+{
+	return IStreamMapped::create( getMappedFile() );
+}
+
 #if defined( CINDER_ANDROID )
 /////////////////////////////////////////////////////////////////////////////
 // DataSourceAndroidAsset
@@ -136,6 +168,23 @@ DataSourceRef loadFile( const fs::path &path )
 #endif	
 }
 
+DataSourceRef loadFileMapped( const fs::path &path, MappedFile::Access access )
+{
+#if defined( CINDER_ANDROID )
+	// assets live inside the APK and have no path of their own to map
+	if( ci::app::PlatformAndroid::isAssetPath( path ) )
+		return DataSourceAndroidAsset::create( path );
+#endif
+	return DataSourceMapped::create( path, access );
+}
+
+std::shared_ptr<const Buffer> loadBufferMapped( const DataSourceRef &dataSource, MappedFile::Access access )
+{
+	if( dataSource->isFilePath() && ! dataSource->isMapped() )
+		return loadFileMapped( dataSource->getFilePath(), access )->getBuffer();
+	return dataSource->getBuffer();
+}
+
 
 /////////////////////////////////////////////////////////////////////////////
 // DataSourceUrl
@@ -22,8 +22,23 @@
 */
 
 #include "cinder/ImageFileTinyExr.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/ip/Parallel.h"
 #include "cinder/Log.h"
 
+#include <algorithm>
+#include <limits>
+
+// TinyEXR sizes its pool of chunk workers as std::min( hardware threads, TINYEXR_MAX_THREADS ). Defining the limit in terms of a
+// thread_local lets each load and save choose its own number of threads; the preprocessor sees ( 1 + 0 ), which enables the limit.
+// This and the partial scanline decode in ImageSourceFileTinyExr::load() rely on internals of the TinyEXR in include/tinyexr, which
+// carries no release number (its copyright reads 2014 - 2021). When updating it, check that DecodeChunk(), DecodeTiledLevel(),
+// EncodeChunk() and EncodeTiledLevel() still only use TINYEXR_MAX_THREADS in #if and std::min(), and that LoadEXRImageFromMemory()
+// still reads the offset table at header_len and sizes it from data_window when chunk_count is 0. ImageFileTinyExrTest covers both.
+static thread_local int sTinyExrExtraThreads = 0;
+#define TINYEXR_USE_THREAD 1
+#define TINYEXR_MAX_THREADS ( 1 + sTinyExrExtraThreads )
+
 #define TINYEXR_USE_MINIZ 0  // Use zlib instead of miniz
 #include <zlib.h>  // Required when TINYEXR_USE_MINIZ is 0
 #define TINYEXR_IMPLEMENTATION
@@ -33,13 +48,95 @@ using namespace std;
 
 namespace cinder {
 
+namespace {
+
+// limits TinyEXR to \a numThreads (0 meaning every hardware thread) for the lifetime of this object
+class ScopedTinyExrThreads {
+  public:
+	ScopedTinyExrThreads( int numThreads )
+		: mPrevious( sTinyExrExtraThreads )
+	{
+		sTinyExrExtraThreads = ip::Options().threads( numThreads ).getNumThreadsForRows( numeric_limits<int32_t>::max() ) - 1;
+	}
+	~ScopedTinyExrThreads() { sTinyExrExtraThreads = mPrevious; }
+
+  private:
+	int		mPrevious;
+};
+
+string tinyExrErrorMessage( const string &description, const char *error )
+{
+	string result = error ? description + "; Error message: " + error : description;
+	if( error )
+		FreeEXRErrorMessage( error );
+	return result;
+}
+
+// the number of scanlines TinyEXR stores per chunk for each compression type
+int scanlinesPerChunk( int compressionType )
+{
+	switch( compressionType ) {
+		case TINYEXR_COMPRESSIONTYPE_ZIP: return 16;
+		case TINYEXR_COMPRESSIONTYPE_PIZ: return 32;
+		case TINYEXR_COMPRESSIONTYPE_ZFP: return 16;
+		default: return 1;
+	}
+}
+
+// copies one row of planar samples into an interleaved row; slots without a plane are set to \a fill
+template<typename T>
+void interleaveRow( const T *const planes[4], const int8_t offsets[4], int8_t inc, int32_t width, T fill, T *dst )
+{
+	for( int slot = 0; slot < 4; ++slot ) {
+		if( offsets[slot] < 0 )
+			continue;
+		T *d = dst + offsets[slot];
+		if( planes[slot] ) {
+			const T *src = planes[slot];
+			for( int32_t x = 0; x < width; ++x, d += inc )
+				*d = src[x];
+		}
+		else {
+			for( int32_t x = 0; x < width; ++x, d += inc )
+				*d = fill;
+		}
+	}
+}
+
+// the planes of the selected channels for a range of rows, as decoded by TinyEXR
+struct DecodedRows {
+	DecodedRows()
+		: mImage( new EXRImage, FreeEXRImage ), mFirstRow( 0 )
+	{
+		InitEXRImage( mImage.get() );
+	}
+
+	// returns the start of \a row of the file in plane \a plane
+	const uint8_t* getRow( size_t plane, int32_t row, int32_t width, size_t sampleBytes ) const
+	{
+		return mPlanes[plane] + ( row - mFirstRow ) * width * sampleBytes;
+	}
+
+	unique_ptr<EXRImage, function<int( EXRImage * )>>	mImage;
+	vector<vector<uint8_t>>								mTilePlanes;
+	vector<const uint8_t*>								mPlanes;
+	int32_t												mFirstRow;
+};
+
+} // anonymous namespace
+
 // ----------------------------------------------------------------------------------------------------
 // ImageSourceFileTinyExr
 // ----------------------------------------------------------------------------------------------------
 
 ImageSourceRef ImageSourceFileTinyExr::create( DataSourceRef dataSourceRef, ImageSource::Options options )
 {
-	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, options ) );
+	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, options, Format() ) );
+}
+
+ImageSourceRef ImageSourceFileTinyExr::create( DataSourceRef dataSourceRef, ImageSource::Options options, const Format &format )
+{
+	return ImageSourceRef( new ImageSourceFileTinyExr( dataSourceRef, options, format ) );
 }
 
 void ImageSourceFileTinyExr::registerSelf()
@@ -48,17 +145,19 @@ void ImageSourceFileTinyExr::registerSelf()
 	ImageIoRegistrar::registerSourceType( "exr", sourceFunc, 1 ); // lower is higher priority
 }
 
-ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options /*options*/ )
+ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageSource::Options options, const Format &format )
 	: mExrHeader( new EXRHeader, FreeEXRHeader ) // We're using the provided FreeEXRHeader function as a custom deleter
-	, mExrImage( new EXRImage, FreeEXRImage )    // We're using the provided FreeEXRImage function as a custom deleter
+	, mThreads( options.getThreads() )
 {
 	InitEXRHeader( mExrHeader.get() );
-	InitEXRImage( mExrImage.get() );
 
-	int status = 0;
+	// only the header is parsed here; the pixels are decoded in load(), once the target's data type is known
+	mBuffer = dataSource->getBuffer();
+	const auto memory = static_cast<const unsigned char *>( mBuffer->getData() );
+	const size_t size = mBuffer->getSize();
 
 	EXRVersion version;
-	status = ParseEXRVersionFromFile( &version, dataSource->getFilePath().string().c_str() );
+	int status = ParseEXRVersionFromMemory( &version, memory, size );
 	if( status != TINYEXR_SUCCESS )
 		throw ImageIoExceptionFailedLoadTinyExr( string( "Failed to parse OpenEXR version" ) );
 
@@ -66,77 +165,68 @@ ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageS
 		throw ImageIoExceptionFailedLoadTinyExr( "Multi-part EXR not supported" );
 	if( version.non_image )
 		throw ImageIoExceptionFailedLoadTinyExr( "Deep image EXR not supported" );
-	if( version.tiled )
-		throw ImageIoExceptionFailedLoadTinyExr( "Tiled EXR not supported" );
-
-	if( dataSource->isFilePath() ) {
-		const string filename = dataSource->getFilePath().string();
-
-		const char *error = nullptr;
-		status = ParseEXRHeaderFromFile( mExrHeader.get(), &version, filename.c_str(), &error );
-		if( status != TINYEXR_SUCCESS ) {
-			string errorMsg = error ? string( "Failed to parse OpenEXR header; Error message: " ) + error : "Failed to parse OpenEXR header";
-			if( error )
-				FreeEXRErrorMessage( error );
-			throw ImageIoExceptionFailedLoadTinyExr( errorMsg );
-		}
 
-		status = LoadEXRImageFromFile( mExrImage.get(), mExrHeader.get(), filename.c_str(), &error );
-		if( status != TINYEXR_SUCCESS ) {
-			string errorMsg = error ? string( "Failed to parse OpenEXR file; Error message: " ) + error : "Failed to parse OpenEXR file";
-			if( error )
-				FreeEXRErrorMessage( error );
-			throw ImageIoExceptionFailedLoadTinyExr( errorMsg );
-		}
-	}
-	else {
-		const auto buffer = dataSource->getBuffer();
-		const auto memory = static_cast<const unsigned char *>( buffer->getData() );
-		const size_t size = buffer->getSize();
-
-		const char *error = nullptr;
-		status = ParseEXRHeaderFromMemory( mExrHeader.get(), &version, memory, size, &error );
-		if( status != TINYEXR_SUCCESS ) {
-			string errorMsg = error ? string( "Failed to parse OpenEXR header; Error message: " ) + error : "Failed to parse OpenEXR header";
-			if( error )
-				FreeEXRErrorMessage( error );
-			throw ImageIoExceptionFailedLoadTinyExr( errorMsg );
-		}
+	const char *error = nullptr;
+	status = ParseEXRHeaderFromMemory( mExrHeader.get(), &version, memory, size, &error );
+	if( status != TINYEXR_SUCCESS )
+		throw ImageIoExceptionFailedLoadTinyExr( tinyExrErrorMessage( "Failed to parse OpenEXR header", error ) );
 
-		status = LoadEXRImageFromMemory( mExrImage.get(), mExrHeader.get(), memory, size, &error );
-		if( status != TINYEXR_SUCCESS ) {
-			string errorMsg = error ? string( "Failed to parse OpenEXR file; Error message: " ) + error : "Failed to parse OpenEXR file";
-			if( error )
-				FreeEXRErrorMessage( error );
-			throw ImageIoExceptionFailedLoadTinyExr( errorMsg );
-		}
+	for( int c = 0; c < mExrHeader->num_channels; ++c ) {
+		mChannelNames.push_back( mExrHeader->channels[c].name );
+		mFilePixelTypes.push_back( mExrHeader->pixel_types[c] );
 	}
 
-	// verify that the channels are all the same size; currently we don't support variably sized channels
-	const int pixelType = mExrHeader->pixel_types[0];
-	for( int c = 1; c < mExrHeader->num_channels; ++c ) {
-		if( pixelType != mExrHeader->pixel_types[c] )
-			throw ImageIoExceptionFailedLoadTinyExr( "Mixed channel data types not supported (all channels must be HALF or all FLOAT)" );
-	}
+	selectChannels( format );
 
-	switch( pixelType ) {
-		case TINYEXR_PIXELTYPE_HALF:
-			setDataType( ImageIo::FLOAT16 );
-			break;
-		case TINYEXR_PIXELTYPE_FLOAT:
-			setDataType( ImageIo::FLOAT32 );
-			break;
-		case TINYEXR_PIXELTYPE_UINT:
+	// selected channels of a single type are passed on as they are; a mix of HALF and FLOAT is read as FLOAT
+	bool allHalf = true;
+	for( int c : mSelectedChannels ) {
+		if( mFilePixelTypes[c] == TINYEXR_PIXELTYPE_UINT )
 			throw ImageIoExceptionFailedLoadTinyExr( "UINT pixel type not supported" );
-			break;
-		default:
+		else if( mFilePixelTypes[c] != TINYEXR_PIXELTYPE_HALF && mFilePixelTypes[c] != TINYEXR_PIXELTYPE_FLOAT )
 			throw ImageIoExceptionFailedLoadTinyExr( "Unsupported pixel type" );
-			break;
+		allHalf = allHalf && mFilePixelTypes[c] == TINYEXR_PIXELTYPE_HALF;
 	}
+	setDataType( allHalf ? ImageIo::FLOAT16 : ImageIo::FLOAT32 );
 
-	setSize( mExrImage->width, mExrImage->height );
+	const EXRBox2i &dataWindow = mExrHeader->data_window;
+	if( dataWindow.max_x < dataWindow.min_x || dataWindow.max_y < dataWindow.min_y )
+		throw ImageIoExceptionFailedLoadTinyExr( "Invalid data window" );
+	setSize( dataWindow.max_x - dataWindow.min_x + 1, dataWindow.max_y - dataWindow.min_y + 1 );
 
-	switch( mExrImage->num_channels ) {
+	setupRegion( options );
+}
+
+void ImageSourceFileTinyExr::selectChannels( const Format &format )
+{
+	auto findChannel = [&]( const string &name ) {
+		auto it = find( mChannelNames.begin(), mChannelNames.end(), name );
+		return ( it == mChannelNames.end() ) ? -1 : (int)( it - mChannelNames.begin() );
+	};
+
+	if( ! format.getChannels().empty() ) {
+		for( const auto &name : format.getChannels() ) {
+			int index = findChannel( name );
+			if( index < 0 )
+				throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channel \"" + name + "\"" );
+			mSelectedChannels.push_back( index );
+		}
+	}
+	else {
+		const string prefix = format.getLayer().empty() ? string() : format.getLayer() + ".";
+		const int red = findChannel( prefix + "R" ), green = findChannel( prefix + "G" ), blue = findChannel( prefix + "B" );
+		const int alpha = findChannel( prefix + "A" ), gray = findChannel( prefix + "Y" );
+		if( gray >= 0 )
+			mSelectedChannels = { gray };
+		else if( red >= 0 && green >= 0 && blue >= 0 )
+			mSelectedChannels = { red, green, blue };
+		else
+			throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for Y or RGB" );
+		if( alpha >= 0 )
+			mSelectedChannels.push_back( alpha );
+	}
+
+	switch( mSelectedChannels.size() ) {
 		case 1:
 			setColorModel( ImageIo::CM_GRAY );
 			setChannelOrder( ImageIo::ChannelOrder::Y );
@@ -154,7 +244,7 @@ ImageSourceFileTinyExr::ImageSourceFileTinyExr( DataSourceRef dataSource, ImageS
 			setChannelOrder( ImageIo::ChannelOrder::RGBA );
 			break;
 		default:
-			throw ImageIoExceptionFailedLoadTinyExr( "Unsupported channel count (" + to_string( mExrImage->num_channels ) + "); expected 1-4 channels" );
+			throw ImageIoExceptionFailedLoadTinyExr( "Unsupported channel count (" + to_string( mSelectedChannels.size() ) + "); expected 1-4 channels" );
 	}
 }
 
@@ -162,83 +252,109 @@ void ImageSourceFileTinyExr::load( ImageTargetRef target )
 {
 	ImageSource::RowFunc rowFunc = setupRowFunc( target );
 
-	const size_t numChannels = mExrHeader->num_channels;
-	const void * red = nullptr, *green = nullptr, *blue = nullptr, *alpha = nullptr;
-	const void * gray = nullptr;
-
-	for( size_t c = 0; c < numChannels; ++c ) {
-		if( strcmp( mExrHeader->channels[c].name, "R" ) == 0 )
-			red = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "G" ) == 0 )
-			green = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "B" ) == 0 )
-			blue = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "A" ) == 0 )
-			alpha = mExrImage->images[c];
-		else if( strcmp( mExrHeader->channels[c].name, "Y" ) == 0 )
-			gray = mExrImage->images[c];
+	const int32_t fullWidth = mExrHeader->data_window.max_x - mExrHeader->data_window.min_x + 1;
+	const Area &area = getRegionArea();
+	const size_t numSelected = mSelectedChannels.size();
+	const bool sourceGray = getColorModel() == ImageIo::CM_GRAY;
+
+	// without a region, samples are written straight into targets of either float type, letting TinyEXR convert halves to floats as it decodes
+	const ImageIo::DataType targetType = target->getDataType();
+	const bool direct = mRowReducer.isIdentity() && target->getChannelOrder() != ImageIo::CUSTOM
+		&& ( targetType == ImageIo::FLOAT32 || ( targetType == ImageIo::FLOAT16 && getDataType() == ImageIo::FLOAT16 ) )
+		&& ( target->getColorModel() == ImageIo::CM_RGB || ( target->getColorModel() == ImageIo::CM_GRAY && sourceGray ) );
+	const ImageIo::DataType decodeType = direct ? targetType : getDataType();
+	const size_t sampleBytes = ( decodeType == ImageIo::FLOAT16 ) ? 2 : 4;
+
+	for( int c = 0; c < mExrHeader->num_channels; ++c )
+		mExrHeader->requested_pixel_types[c] = ( decodeType == ImageIo::FLOAT32 && mFilePixelTypes[c] == TINYEXR_PIXELTYPE_HALF ) ? TINYEXR_PIXELTYPE_FLOAT : mFilePixelTypes[c];
+
+	DecodedRows decoded;
+	{
+		ScopedTinyExrThreads threads( mThreads );
+		const auto memory = static_cast<const unsigned char *>( mBuffer->getData() );
+		const char *error = nullptr;
+		int status;
+		if( mExrHeader->tiled ) {
+			status = LoadEXRImageFromMemory( decoded.mImage.get(), mExrHeader.get(), memory, mBuffer->getSize(), &error );
+		}
+		else {
+			// a scanline file is decoded from the first to the last chunk covering the region, by presenting TinyEXR with a header for just those rows
+			const int chunkRows = scanlinesPerChunk( mExrHeader->compression_type );
+			const int32_t firstChunk = area.y1 / chunkRows, lastChunk = ( area.y2 + chunkRows - 1 ) / chunkRows;
+			EXRHeader rows = *mExrHeader;
+			rows.data_window.min_y = mExrHeader->data_window.min_y + firstChunk * chunkRows;
+			rows.data_window.max_y = std::min( mExrHeader->data_window.max_y, mExrHeader->data_window.min_y + lastChunk * chunkRows - 1 );
+			rows.header_len = mExrHeader->header_len + firstChunk * (unsigned int)sizeof(tinyexr::tinyexr_uint64); // skips the offsets of the preceding chunks
+			rows.chunk_count = 0;
+			decoded.mFirstRow = firstChunk * chunkRows;
+			status = LoadEXRImageFromMemory( decoded.mImage.get(), &rows, memory, mBuffer->getSize(), &error );
+		}
+		if( status != TINYEXR_SUCCESS )
+			throw ImageIoExceptionFailedLoadTinyExr( tinyExrErrorMessage( "Failed to parse OpenEXR file", error ) );
 	}
 
-	if( ( !gray ) && ( ( !red ) || ( !green ) || ( !blue ) ) )
-		throw ImageIoExceptionFailedLoadTinyExr( "Unable to locate channels for Y or RGB" );
-
-	if( gray ) {
-		if( getDataType() == ImageIo::FLOAT32 ) {
-			vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( gray )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 1 ) = static_cast<const float *>( alpha )[row * mWidth + col];
-				}
-
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
-			}
-		}
-		else { // float16
-			vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( gray )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( alpha )[row * mWidth + col];
-				}
-
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
+	if( mExrHeader->tiled ) {
+		// reassemble the selected channels of the full resolution tiles
+		const EXRImage &image = *decoded.mImage;
+		decoded.mTilePlanes.assign( numSelected, vector<uint8_t>( (size_t)fullWidth * area.y2 * sampleBytes ) );
+		for( int t = 0; t < image.num_tiles; ++t ) {
+			const EXRTile &tile = image.tiles[t];
+			const int32_t x0 = tile.offset_x * mExrHeader->tile_size_x, y0 = tile.offset_y * mExrHeader->tile_size_y;
+			const int32_t numRows = std::min( tile.height, area.y2 - y0 );
+			for( size_t s = 0; s < numSelected; ++s ) {
+				const uint8_t *src = tile.images[mSelectedChannels[s]];
+				for( int32_t row = 0; row < numRows; ++row )
+					memcpy( &decoded.mTilePlanes[s][( ( y0 + row ) * fullWidth + x0 ) * sampleBytes], src + row * mExrHeader->tile_size_x * sampleBytes, tile.width * sampleBytes );
 			}
 		}
+		for( const auto &plane : decoded.mTilePlanes )
+			decoded.mPlanes.push_back( plane.data() );
 	}
 	else {
-		// load one interleaved row at a time
-		if( getDataType() == ImageIo::FLOAT32 ) {
-			vector<float> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const float *>( red )[row * mWidth + col];
-					rowData.at( col * numChannels + 1 ) = static_cast<const float *>( green )[row * mWidth + col];
-					rowData.at( col * numChannels + 2 ) = static_cast<const float *>( blue )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 3 ) = static_cast<const float *>( alpha )[row * mWidth + col];
-				}
-
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
-			}
-		}
-		else { // float16
-			vector<uint16_t> rowData( mWidth * mExrImage->num_channels, 0 );
-			for( int32_t row = 0; row < mHeight; row++ ) {
-				for( int32_t col = 0; col < mWidth; col++ ) {
-					rowData.at( col * numChannels + 0 ) = static_cast<const uint16_t *>( red )[row * mWidth + col];
-					rowData.at( col * numChannels + 1 ) = static_cast<const uint16_t *>( green )[row * mWidth + col];
-					rowData.at( col * numChannels + 2 ) = static_cast<const uint16_t *>( blue )[row * mWidth + col];
-					if( alpha )
-						rowData.at( col * numChannels + 3 ) = static_cast<const uint16_t *>( alpha )[row * mWidth + col];
-				}
-
-				( ( *this ).*rowFunc )( target, row, rowData.data() );
-			}
+		for( int c : mSelectedChannels )
+			decoded.mPlanes.push_back( decoded.mImage->images[c] );
+	}
+
+	// the interleaved position of each channel of the destination, in the order R, G, B, A (or Y, A), and the selected channel which feeds it
+	int8_t offsets[4] = { -1, -1, -1, -1 }, inc;
+	int sources[4] = { -1, -1, -1, -1 };
+	const int alphaSource = ( numSelected == 2 || numSelected == 4 ) ? (int)numSelected - 1 : -1;
+	if( ! direct ) {
+		inc = (int8_t)numSelected;
+		for( size_t s = 0; s < numSelected; ++s ) {
+			offsets[s] = (int8_t)s;
+			sources[s] = (int)s;
 		}
 	}
+	else if( target->getColorModel() == ImageIo::CM_GRAY ) {
+		ImageIo::translateGrayColorModelToOffsets( target->getChannelOrder(), &offsets[0], &offsets[1], &inc );
+		sources[0] = 0;
+		sources[1] = alphaSource;
+	}
+	else {
+		ImageIo::translateRgbColorModelToOffsets( target->getChannelOrder(), &offsets[0], &offsets[1], &offsets[2], &offsets[3], &inc );
+		// a gray source fills red, green and blue
+		for( int slot = 0; slot < 3; ++slot )
+			sources[slot] = sourceGray ? 0 : slot;
+		sources[3] = alphaSource;
+	}
+
+	// channels without a source, such as a missing alpha, are filled with the maximum
+	vector<uint8_t> rowData( direct ? 0 : fullWidth * numSelected * sampleBytes );
+	const uint8_t *planes[4];
+	for( int32_t row = area.y1; row < area.y2; ++row ) {
+		for( int slot = 0; slot < 4; ++slot )
+			planes[slot] = ( sources[slot] >= 0 ) ? decoded.getRow( sources[slot], row, fullWidth, sampleBytes ) : nullptr;
+
+		void *dst = direct ? target->getRowPointer( row ) : rowData.data();
+		if( decodeType == ImageIo::FLOAT16 )
+			interleaveRow<half_float>( reinterpret_cast<const half_float *const *>( planes ), offsets, inc, fullWidth, CHANTRAIT<half_float>::max(), static_cast<half_float*>( dst ) );
+		else
+			interleaveRow<float>( reinterpret_cast<const float *const *>( planes ), offsets, inc, fullWidth, 1.0f, static_cast<float*>( dst ) );
+
+		if( ! direct )
+			processRow( rowFunc, target, row, rowData.data() );
+	}
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -259,18 +375,23 @@ void ImageTargetFileTinyExr::registerSelf()
 	ImageIoRegistrar::registerTargetType( "exr", func, PRIORITY, "exr" );
 }
 
-ImageTargetRef ImageTargetFileTinyExr::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData )
+ImageTargetRef ImageTargetFileTinyExr::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
 {
-	return ImageTargetRef( new ImageTargetFileTinyExr( dataTarget, imageSource, options, extensionData ) );
+	return ImageTargetRef( new ImageTargetFileTinyExr( dataTarget, imageSource, options, Format() ) );
 }
 
-ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
+ImageTargetRef ImageTargetFileTinyExr::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const Format &format )
 {
-	if( ! dataTarget->providesFilePath() ) {
-		throw ImageIoExceptionFailedWrite( "ImageTargetFileTinyExr only supports writing to files." );
-	}
+	return ImageTargetRef( new ImageTargetFileTinyExr( dataTarget, imageSource, options, format ) );
+}
 
-	mFilePath = dataTarget->getFilePath();
+ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const Format &format )
+	: mDataTarget( dataTarget ), mFormat( format ), mThreads( options.getThreads() )
+{
+	if( dataTarget->providesFilePath() )
+		mFilePath = dataTarget->getFilePath();
+	else if( ! dataTarget->getStream() )
+		throw ImageIoExceptionFailedWrite( "No file path or stream provided" );
 
 	setSize( imageSource->getWidth(), imageSource->getHeight() );
 	ImageIo::ColorModel cm = options.isColorModelDefault() ? imageSource->getColorModel() : options.getColorModel();
@@ -298,35 +419,38 @@ ImageTargetFileTinyExr::ImageTargetFileTinyExr( DataTargetRef dataTarget, ImageS
 			throw ImageIoExceptionIllegalColorModel();
 	}
 
-	// TODO: consider supporting half float and uint types as well
-	setDataType( ImageIo::DataType::FLOAT32 );
-	mData.resize( mHeight * mWidth * mNumComponents );
+	// half float sources written as half floats are passed through without conversion
+	const bool halfSource = imageSource->getDataType() == ImageIo::DataType::FLOAT16 && mFormat.isHalfFloat();
+	setDataType( halfSource ? ImageIo::DataType::FLOAT16 : ImageIo::DataType::FLOAT32 );
+	mSampleBytes = halfSource ? 2 : 4;
+	mData.resize( mHeight * mWidth * mNumComponents * mSampleBytes );
 }
 
 void *ImageTargetFileTinyExr::getRowPointer( int32_t row )
 {
-	return &mData[row * mWidth * mNumComponents];
+	return &mData[row * mWidth * mNumComponents * mSampleBytes];
 }
 
 void ImageTargetFileTinyExr::finalize()
 {
 	// turn interleaved data into a series of planar channels
-	vector<Channel32f> channels;
-	channels.reserve( mNumComponents );
-	unsigned char *    imagePtr[4];
-	for( int c = 0; c < mNumComponents; ++c ) {
-		channels.emplace_back( getWidth(), getHeight() );
-		Channel32f srcChannel( getWidth(), getHeight(), mNumComponents * mWidth * sizeof(float), mNumComponents, mData.data() + c );
-		channels.back().copyFrom( srcChannel, srcChannel.getBounds() );
-
-		imagePtr[c] = reinterpret_cast<unsigned char *>( channels[c].getData() );
-	}
+	vector<vector<uint8_t>> channels( mNumComponents, vector<uint8_t>( mWidth * mHeight * mSampleBytes ) );
+	vector<unsigned char *> imagePtr( mNumComponents );
+	ip::parallelForRows( 0, mHeight, ip::Options().threads( mThreads ), [&]( int32_t rowBegin, int32_t rowEnd ) {
+		for( int c = 0; c < mNumComponents; ++c ) {
+			for( int32_t row = rowBegin; row < rowEnd; ++row ) {
+				const uint8_t *src = &mData[( row * mWidth * mNumComponents + c ) * mSampleBytes];
+				uint8_t *dst = &channels[c][row * mWidth * mSampleBytes];
+				for( int32_t x = 0; x < mWidth; ++x, src += mNumComponents * mSampleBytes, dst += mSampleBytes )
+					memcpy( dst, src, mSampleBytes );
+			}
+		}
+	} );
+	for( int c = 0; c < mNumComponents; ++c )
+		imagePtr[c] = channels[c].data();
 
-	int pixelTypes[4], requested_pixel_types[4];
-	for( int i = 0; i < mNumComponents; i++ ) {
-		pixelTypes[i] = TINYEXR_PIXELTYPE_FLOAT;
-		requested_pixel_types[i] = TINYEXR_PIXELTYPE_HALF; // export as half-floats to reduce file size
-	}
+	vector<int> pixelTypes( mNumComponents, ( mSampleBytes == 2 ) ? TINYEXR_PIXELTYPE_HALF : TINYEXR_PIXELTYPE_FLOAT );
+	vector<int> requestedPixelTypes( mNumComponents, mFormat.isHalfFloat() ? TINYEXR_PIXELTYPE_HALF : TINYEXR_PIXELTYPE_FLOAT );
 
 	std::vector<EXRChannelInfo> info( mNumComponents );
 
@@ -337,7 +461,7 @@ void ImageTargetFileTinyExr::finalize()
 	exrImage.num_channels = mNumComponents;
 	exrImage.width = mWidth;
 	exrImage.height = mHeight;
-	exrImage.images = imagePtr;
+	exrImage.images = imagePtr.data();
 
 	// create header descriptor
 	EXRHeader exrHeader;
@@ -348,19 +472,31 @@ void ImageTargetFileTinyExr::finalize()
 	for( int i = 0; i < mNumComponents; ++i ) {
 		strncpy( exrHeader.channels[i].name, mChannelNames[i].data(), mChannelNames[i].size() );
 	}
-	exrHeader.pixel_types = pixelTypes;
-	exrHeader.requested_pixel_types = requested_pixel_types;
-	// Use ZIP compression by default for better file sizes while maintaining good performance
-	exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_ZIP;
+	exrHeader.pixel_types = pixelTypes.data();
+	exrHeader.requested_pixel_types = requestedPixelTypes.data();
+	switch( mFormat.getCompression() ) {
+		case COMPRESSION_NONE: exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_NONE; break;
+		case COMPRESSION_RLE: exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_RLE; break;
+		case COMPRESSION_ZIPS: exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_ZIPS; break;
+		case COMPRESSION_ZIP: exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_ZIP; break;
+		case COMPRESSION_PIZ: exrHeader.compression_type = TINYEXR_COMPRESSIONTYPE_PIZ; break;
+	}
 
+	// TinyEXR compresses the chunks of scanlines in parallel
+	ScopedTinyExrThreads threads( mThreads );
 	const char *error = nullptr;
-
-	const int status = SaveEXRImageToFile( &exrImage, &exrHeader, mFilePath.string().c_str(), &error );
-	if( status != TINYEXR_SUCCESS ) {
-		string errorMsg = error ? string( "TinyExr: failed to write. Error: " ) + error : "TinyExr: failed to write";
-		if( error )
-			FreeEXRErrorMessage( error );
-		throw ImageIoExceptionFailedWriteTinyExr( errorMsg );
+	if( ! mFilePath.empty() ) {
+		const int status = SaveEXRImageToFile( &exrImage, &exrHeader, mFilePath.string().c_str(), &error );
+		if( status != TINYEXR_SUCCESS )
+			throw ImageIoExceptionFailedWriteTinyExr( tinyExrErrorMessage( "TinyExr: failed to write", error ) );
+	}
+	else {
+		unsigned char *memory = nullptr;
+		const size_t size = SaveEXRImageToMemory( &exrImage, &exrHeader, &memory, &error );
+		if( size == 0 )
+			throw ImageIoExceptionFailedWriteTinyExr( tinyExrErrorMessage( "TinyExr: failed to write", error ) );
+		mDataTarget->getStream()->writeData( memory, size );
+		free( memory );
 	}
 
 	// Note: since header and image descriptors do not own any data, we explicitely do not call FreeEXRHeader and FreeEXRImage here!
@@ -24,6 +24,9 @@
 
 #include "cinder/ImageIo.h"
 #include "cinder/Utilities.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/Simd.h"
+#include "cinder/System.h"
 
 #include <iterator>
 #include <cctype>
@@ -158,6 +161,358 @@ size_t ImageSource::getRowBytes() const
 	return getWidth() * ImageIo::channelOrderNumChannels( getChannelOrder() ) * ImageIo::dataTypeBytes( getDataType() );
 }
 
+namespace {
+
+// integer sums are 64 bit, a block of 256x256 UINT16 or 4096x4096 UINT8 samples would overflow 32 bits
+template<typename T>
+struct ReduceTraits {
+	typedef uint64_t Accum;
+	static Accum	load( T v )							{ return v; }
+	static T		store( Accum sum, uint64_t count )	{ return static_cast<T>( ( sum + count / 2 ) / count ); }
+};
+
+template<>
+struct ReduceTraits<float> {
+	typedef float Accum;
+	static Accum	load( float v )						{ return v; }
+	static float	store( Accum sum, uint64_t count )	{ return sum / count; }
+};
+
+template<>
+struct ReduceTraits<half_float> {
+	typedef float Accum;
+	static Accum		load( half_float v )				{ return halfToFloat( v ); }
+	static half_float	store( Accum sum, uint64_t count )	{ return floatToHalf( sum / count ); }
+};
+
+// adds the pixels [x1,x2) of a row to the per-block sums in 'accum'
+template<typename T>
+void accumulateRow( std::vector<uint8_t> *accum, const void *data, int32_t x1, int32_t x2, int32_t factor, int pixelInc )
+{
+	typedef typename ReduceTraits<T>::Accum A;
+	A *sums = reinterpret_cast<A*>( accum->data() );
+	const T *row = reinterpret_cast<const T*>( data ) + x1 * pixelInc;
+	for( int32_t x = 0; x < x2 - x1; ++x ) {
+		A *block = sums + ( x / factor ) * pixelInc;
+		for( int c = 0; c < pixelInc; ++c )
+			block[c] += ReduceTraits<T>::load( row[c] );
+		row += pixelInc;
+	}
+}
+
+template<typename T>
+void averageRow( std::vector<uint8_t> *accum, std::vector<uint8_t> *result, int32_t width, int32_t areaWidth, int32_t factor, int32_t blockRows, int pixelInc )
+{
+	typedef typename ReduceTraits<T>::Accum A;
+	A *sums = reinterpret_cast<A*>( accum->data() );
+	T *out = reinterpret_cast<T*>( result->data() );
+	for( int32_t x = 0; x < width; ++x ) {
+		// blocks on the right edge may be narrower than 'factor'
+		const uint64_t count = static_cast<uint64_t>( std::min( factor, areaWidth - x * factor ) ) * blockRows;
+		for( int c = 0; c < pixelInc; ++c, ++sums ) {
+			*out++ = ReduceTraits<T>::store( *sums, count );
+			*sums = 0;
+		}
+	}
+}
+
+} // anonymous namespace
+
+ImageSource::RowReducer::RowReducer( int32_t fullWidth, int32_t fullHeight, const Options &options, DataType dataType, int pixelInc )
+	: mDataType( dataType ), mPixelInc( pixelInc ), mFactor( options.getDownscale() ), mBlockRows( 0 )
+{
+	mArea = Area( 0, 0, fullWidth, fullHeight );
+	if( options.hasArea() )
+		mArea = options.getArea().getClipBy( mArea );
+	if( mArea.getWidth() <= 0 || mArea.getHeight() <= 0 )
+		throw ImageIoExceptionFailedLoad( "Requested area does not intersect the image." );
+
+	mWidth = ( mArea.getWidth() + mFactor - 1 ) / mFactor;
+	mHeight = ( mArea.getHeight() + mFactor - 1 ) / mFactor;
+	mIdentity = ( mFactor == 1 ) && ( mArea == Area( 0, 0, fullWidth, fullHeight ) );
+
+	if( mFactor > 1 ) {
+		const size_t samples = (size_t)mWidth * mPixelInc;
+		switch( mDataType ) {
+			case UINT8: case UINT16: mAccum.resize( samples * sizeof(ReduceTraits<uint16_t>::Accum) ); break;
+			case FLOAT32: case FLOAT16: mAccum.resize( samples * sizeof(ReduceTraits<float>::Accum) ); break;
+			default: throw ImageIoExceptionIllegalDataType( "Unknown data type." );
+		}
+		mResult.resize( samples * dataTypeBytes( mDataType ) );
+	}
+}
+
+void ImageSource::RowReducer::addRow( int32_t sourceRow, const void *data, const std::function<void( int32_t, const void* )> &emit )
+{
+	if( sourceRow < mArea.y1 || sourceRow >= mArea.y2 )
+		return;
+
+	if( mFactor == 1 ) {
+		emit( sourceRow - mArea.y1, reinterpret_cast<const uint8_t*>( data ) + (size_t)mArea.x1 * mPixelInc * dataTypeBytes( mDataType ) );
+		return;
+	}
+
+	// restart cleanly if a previous load() was abandoned mid-block
+	if( sourceRow == mArea.y1 && mBlockRows > 0 ) {
+		std::fill( mAccum.begin(), mAccum.end(), (uint8_t)0 );
+		mBlockRows = 0;
+	}
+
+	switch( mDataType ) {
+		case UINT8: accumulateRow<uint8_t>( &mAccum, data, mArea.x1, mArea.x2, mFactor, mPixelInc ); break;
+		case UINT16: accumulateRow<uint16_t>( &mAccum, data, mArea.x1, mArea.x2, mFactor, mPixelInc ); break;
+		case FLOAT32: accumulateRow<float>( &mAccum, data, mArea.x1, mArea.x2, mFactor, mPixelInc ); break;
+		case FLOAT16: accumulateRow<half_float>( &mAccum, data, mArea.x1, mArea.x2, mFactor, mPixelInc ); break;
+		default: break;
+	}
+
+	// a reduced row is complete at the end of its block, or at the end of the area for a partial last block
+	if( ++mBlockRows < mFactor && sourceRow != mArea.y2 - 1 )
+		return;
+
+	switch( mDataType ) {
+		case UINT8: averageRow<uint8_t>( &mAccum, &mResult, mWidth, mArea.getWidth(), mFactor, mBlockRows, mPixelInc ); break;
+		case UINT16: averageRow<uint16_t>( &mAccum, &mResult, mWidth, mArea.getWidth(), mFactor, mBlockRows, mPixelInc ); break;
+		case FLOAT32: averageRow<float>( &mAccum, &mResult, mWidth, mArea.getWidth(), mFactor, mBlockRows, mPixelInc ); break;
+		case FLOAT16: averageRow<half_float>( &mAccum, &mResult, mWidth, mArea.getWidth(), mFactor, mBlockRows, mPixelInc ); break;
+		default: break;
+	}
+	mBlockRows = 0;
+	emit( ( sourceRow - mArea.y1 ) / mFactor, mResult.data() );
+}
+
+void ImageSource::setupRegion( const Options &options )
+{
+	const int pixelInc = mCustomPixelInc ? mCustomPixelInc : channelOrderNumChannels( mChannelOrder );
+	mRowReducer = RowReducer( mWidth, mHeight, options, mDataType, pixelInc );
+	setSize( mRowReducer.getWidth(), mRowReducer.getHeight() );
+	mRegionApplied = true;
+}
+
+void ImageSource::processRow( RowFunc func, const ImageTargetRef &target, int32_t sourceRow, const void *data )
+{
+	if( ! mRegionApplied || mRowReducer.isIdentity() )
+		((*this).*func)( target, sourceRow, data );
+	else
+		mRowReducer.addRow( sourceRow, data, [&]( int32_t row, const void *rowData ) { ((*this).*func)( target, row, rowData ); } );
+}
+
+namespace {
+
+// Describes the conversion of a row of pixels with 1-4 samples into pixels with 3 or 4 samples as a byte shuffle of four pixels at a time
+struct RowShuffle {
+	// 'channels' holds, for each sample of a target pixel, the source sample it is copied from or -1 for the maximum value
+	RowShuffle( int8_t srcInc, int8_t dstInc, const int8_t channels[4] )
+		: srcInc( srcInc ), dstInc( dstInc ), valid( srcInc >= 1 && srcInc <= 4 && dstInc >= 3 && dstInc <= 4 )
+	{
+		for( int i = 0; i < 16; ++i ) {
+			mask[i] = 0x80;
+			fill[i] = 0;
+		}
+		for( int p = 0; valid && p < 4; ++p ) {
+			for( int c = 0; c < dstInc; ++c ) {
+				if( channels[c] >= srcInc )
+					valid = false;
+				else if( channels[c] >= 0 )
+					mask[p * dstInc + c] = (uint8_t)( p * srcInc + channels[c] );
+				else
+					fill[p * dstInc + c] = 0xFF;
+			}
+		}
+	}
+
+	int8_t	srcInc, dstInc;
+	bool	valid;
+	uint8_t	mask[16], fill[16];
+};
+
+template<typename SD, typename TD>
+struct HasSimdRowConversion { static const bool value = false; };
+template<> struct HasSimdRowConversion<uint8_t,uint8_t> { static const bool value = true; };
+template<> struct HasSimdRowConversion<uint16_t,uint8_t> { static const bool value = true; };
+template<> struct HasSimdRowConversion<uint8_t,float> { static const bool value = true; };
+
+#if defined( CINDER_SIMD_SSE2 )
+
+CI_SIMD_TARGET_SSE4_1 int32_t convertRowSse4_1( const uint8_t *src, uint8_t *dst, int32_t width, const RowShuffle &s )
+{
+	const __m128i mask = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.mask ) );
+	const __m128i fill = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.fill ) );
+	const int32_t srcBytes = width * s.srcInc, dstBytes = width * s.dstInc;
+	int32_t x = 0;
+	// 3 sample targets store 4 bytes past the 4th pixel, which the next pixels overwrite
+	for( ; x * s.srcInc + 16 <= srcBytes && x * s.dstInc + 16 <= dstBytes; x += 4 ) {
+		__m128i pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * s.srcInc ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * s.dstInc ), _mm_or_si128( _mm_shuffle_epi8( pixels, mask ), fill ) );
+	}
+	return x;
+}
+
+CI_SIMD_TARGET_SSE4_1 int32_t convertRowSse4_1( const uint16_t *src, uint8_t *dst, int32_t width, const RowShuffle &s )
+{
+	const __m128i mask = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.mask ) );
+	const __m128i fill = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.fill ) );
+	// v / 257 == ( v * 65281 ) >> 24 for all 16-bit v, matching CHANTRAIT<uint8_t>::convert()
+	const __m128i div257 = _mm_set1_epi16( (short)65281 );
+	const int32_t srcSamples = width * s.srcInc, dstBytes = width * s.dstInc;
+	int32_t x = 0;
+	for( ; x * s.srcInc + 16 <= srcSamples && x * s.dstInc + 16 <= dstBytes; x += 4 ) {
+		__m128i lo = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * s.srcInc ) );
+		__m128i hi = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * s.srcInc + 8 ) );
+		lo = _mm_srli_epi16( _mm_mulhi_epu16( lo, div257 ), 8 );
+		hi = _mm_srli_epi16( _mm_mulhi_epu16( hi, div257 ), 8 );
+		__m128i pixels = _mm_packus_epi16( lo, hi );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + x * s.dstInc ), _mm_or_si128( _mm_shuffle_epi8( pixels, mask ), fill ) );
+	}
+	return x;
+}
+
+CI_SIMD_TARGET_SSE4_1 int32_t convertRowSse4_1( const uint8_t *src, float *dst, int32_t width, const RowShuffle &s )
+{
+	const __m128i mask = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.mask ) );
+	const __m128i fill = _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.fill ) );
+	// a division rather than a multiply by the reciprocal, to match CHANTRAIT<float>::convert() exactly
+	const __m128 max = _mm_set1_ps( 255.0f );
+	const int32_t srcBytes = width * s.srcInc;
+	int32_t x = 0;
+	for( ; x * s.srcInc + 16 <= srcBytes && x + 4 <= width; x += 4 ) {
+		__m128i pixels = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * s.srcInc ) );
+		__m128i bytes = _mm_or_si128( _mm_shuffle_epi8( pixels, mask ), fill );
+		float *out = dst + x * s.dstInc;
+		_mm_storeu_ps( out, _mm_div_ps( _mm_cvtepi32_ps( _mm_cvtepu8_epi32( bytes ) ), max ) );
+		_mm_storeu_ps( out + 4, _mm_div_ps( _mm_cvtepi32_ps( _mm_cvtepu8_epi32( _mm_srli_si128( bytes, 4 ) ) ), max ) );
+		_mm_storeu_ps( out + 8, _mm_div_ps( _mm_cvtepi32_ps( _mm_cvtepu8_epi32( _mm_srli_si128( bytes, 8 ) ) ), max ) );
+		if( s.dstInc == 4 )
+			_mm_storeu_ps( out + 12, _mm_div_ps( _mm_cvtepi32_ps( _mm_cvtepu8_epi32( _mm_srli_si128( bytes, 12 ) ) ), max ) );
+	}
+	return x;
+}
+
+CI_SIMD_TARGET_AVX2 int32_t convertRowAvx2( const uint8_t *src, uint8_t *dst, int32_t width, const RowShuffle &s )
+{
+	// vpshufb works within 128-bit lanes, so each lane holds four pixels
+	const __m256i mask = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.mask ) ) );
+	const __m256i fill = _mm256_broadcastsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>( s.fill ) ) );
+	const int32_t srcBytes = width * s.srcInc, dstBytes = width * s.dstInc;
+	int32_t x = 0;
+	for( ; ( x + 4 ) * s.srcInc + 16 <= srcBytes && ( x + 4 ) * s.dstInc + 16 <= dstBytes; x += 8 ) {
+		const uint8_t *in = src + x * s.srcInc;
+		__m256i pixels = _mm256_inserti128_si256( _mm256_castsi128_si256( _mm_loadu_si128( reinterpret_cast<const __m128i*>( in ) ) ),
+													_mm_loadu_si128( reinterpret_cast<const __m128i*>( in + 4 * s.srcInc ) ), 1 );
+		__m256i result = _mm256_or_si256( _mm256_shuffle_epi8( pixels, mask ), fill );
+		uint8_t *out = dst + x * s.dstInc;
+		if( s.dstInc == 4 )
+			_mm256_storeu_si256( reinterpret_cast<__m256i*>( out ), result );
+		else {
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( out ), _mm256_castsi256_si128( result ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( out + 12 ), _mm256_extracti128_si256( result, 1 ) );
+		}
+	}
+	return x;
+}
+
+#elif defined( CINDER_SIMD_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+
+int32_t convertRowNeon( const uint8_t *src, uint8_t *dst, int32_t width, const RowShuffle &s )
+{
+	// out of range indices (0x80) produce zero, as with pshufb
+	const uint8x16_t mask = vld1q_u8( s.mask ), fill = vld1q_u8( s.fill );
+	const int32_t srcBytes = width * s.srcInc, dstBytes = width * s.dstInc;
+	int32_t x = 0;
+	for( ; x * s.srcInc + 16 <= srcBytes && x * s.dstInc + 16 <= dstBytes; x += 4 )
+		vst1q_u8( dst + x * s.dstInc, vorrq_u8( vqtbl1q_u8( vld1q_u8( src + x * s.srcInc ), mask ), fill ) );
+	return x;
+}
+
+int32_t convertRowNeon( const uint16_t *src, uint8_t *dst, int32_t width, const RowShuffle &s )
+{
+	const uint8x16_t mask = vld1q_u8( s.mask ), fill = vld1q_u8( s.fill );
+	const uint16x4_t div257 = vdup_n_u16( 65281 );
+	const int32_t srcSamples = width * s.srcInc, dstBytes = width * s.dstInc;
+	int32_t x = 0;
+	for( ; x * s.srcInc + 16 <= srcSamples && x * s.dstInc + 16 <= dstBytes; x += 4 ) {
+		uint16x8_t lo = vld1q_u16( src + x * s.srcInc ), hi = vld1q_u16( src + x * s.srcInc + 8 );
+		// v / 257 == ( v * 65281 ) >> 24 for all 16-bit v
+		uint16x8_t lo16 = vcombine_u16( vshrn_n_u32( vmull_u16( vget_low_u16( lo ), div257 ), 16 ), vshrn_n_u32( vmull_u16( vget_high_u16( lo ), div257 ), 16 ) );
+		uint16x8_t hi16 = vcombine_u16( vshrn_n_u32( vmull_u16( vget_low_u16( hi ), div257 ), 16 ), vshrn_n_u32( vmull_u16( vget_high_u16( hi ), div257 ), 16 ) );
+		uint8x16_t pixels = vcombine_u8( vshrn_n_u16( lo16, 8 ), vshrn_n_u16( hi16, 8 ) );
+		vst1q_u8( dst + x * s.dstInc, vorrq_u8( vqtbl1q_u8( pixels, mask ), fill ) );
+	}
+	return x;
+}
+
+int32_t convertRowNeon( const uint8_t *src, float *dst, int32_t width, const RowShuffle &s )
+{
+	const uint8x16_t mask = vld1q_u8( s.mask ), fill = vld1q_u8( s.fill );
+	const float32x4_t max = vdupq_n_f32( 255.0f );
+	const int32_t srcBytes = width * s.srcInc;
+	int32_t x = 0;
+	for( ; x * s.srcInc + 16 <= srcBytes && x + 4 <= width; x += 4 ) {
+		uint8x16_t bytes = vorrq_u8( vqtbl1q_u8( vld1q_u8( src + x * s.srcInc ), mask ), fill );
+		uint16x8_t lo = vmovl_u8( vget_low_u8( bytes ) ), hi = vmovl_u8( vget_high_u8( bytes ) );
+		float *out = dst + x * s.dstInc;
+		vst1q_f32( out, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ) ) ), max ) );
+		vst1q_f32( out + 4, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ) ) ), max ) );
+		vst1q_f32( out + 8, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ) ) ), max ) );
+		if( s.dstInc == 4 )
+			vst1q_f32( out + 12, vdivq_f32( vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ) ) ), max ) );
+	}
+	return x;
+}
+
+#endif
+
+// Converts as many leading pixels of a row as the SIMD kernels handle, returning their count; the caller converts the rest
+template<typename SD, typename TD>
+int32_t convertRowSimd( const SD * /*src*/, TD * /*dst*/, int32_t /*width*/, const RowShuffle & /*shuffle*/ )
+{
+	return 0;
+}
+
+template<>
+int32_t convertRowSimd( const uint8_t *src, uint8_t *dst, int32_t width, const RowShuffle &shuffle )
+{
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasSse4_1 = System::hasSse4_1();
+	static const bool sHasAvx2 = System::hasAvx2();
+	if( sHasAvx2 )
+		return convertRowAvx2( src, dst, width, shuffle );
+	else if( sHasSse4_1 )
+		return convertRowSse4_1( src, dst, width, shuffle );
+#elif defined( CINDER_SIMD_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+	return convertRowNeon( src, dst, width, shuffle );
+#endif
+	return 0;
+}
+
+template<>
+int32_t convertRowSimd( const uint16_t *src, uint8_t *dst, int32_t width, const RowShuffle &shuffle )
+{
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasSse4_1 = System::hasSse4_1();
+	if( sHasSse4_1 )
+		return convertRowSse4_1( src, dst, width, shuffle );
+#elif defined( CINDER_SIMD_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+	return convertRowNeon( src, dst, width, shuffle );
+#endif
+	return 0;
+}
+
+template<>
+int32_t convertRowSimd( const uint8_t *src, float *dst, int32_t width, const RowShuffle &shuffle )
+{
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasSse4_1 = System::hasSse4_1();
+	if( sHasSse4_1 )
+		return convertRowSse4_1( src, dst, width, shuffle );
+#elif defined( CINDER_SIMD_NEON ) && ( defined( __aarch64__ ) || defined( _M_ARM64 ) )
+	return convertRowNeon( src, dst, width, shuffle );
+#endif
+	return 0;
+}
+
+} // anonymous namespace
+
 /* SD - source data type, TD - target data type, TCM - target color model */
 template<typename SD, typename TD, ImageIo::ColorModel TCM, bool ALPHA>
 void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const void *data )
@@ -165,10 +520,26 @@ void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const vo
 	const SD *sourceData = reinterpret_cast<const SD*>( data );
 	TD *targetData = reinterpret_cast<TD*>( target->getRowPointer( row ) );
 	int32_t width = getWidth();
+	int32_t c = 0;
 	
 	if( TCM == CM_RGB ) {
+		if( HasSimdRowConversion<SD,TD>::value && mRowFuncTargetInc >= 3 && mRowFuncTargetInc <= 4 ) {
+			int8_t channels[4] = { -1, -1, -1, -1 };
+			channels[mRowFuncTargetRed] = mRowFuncSourceRed;
+			channels[mRowFuncTargetGreen] = mRowFuncSourceGreen;
+			channels[mRowFuncTargetBlue] = mRowFuncSourceBlue;
+			if( ALPHA )
+				channels[mRowFuncTargetAlpha] = mRowFuncSourceAlpha;
+			RowShuffle shuffle( mRowFuncSourceInc, mRowFuncTargetInc, channels );
+			if( shuffle.valid ) {
+				c = convertRowSimd( sourceData, targetData, width, shuffle );
+				sourceData += c * mRowFuncSourceInc;
+				targetData += c * mRowFuncTargetInc;
+			}
+		}
+
 		if( ALPHA ) {
-			for( int32_t c = 0; c < width; c++ ) { // both source and target have alpha
+			for( ; c < width; c++ ) { // both source and target have alpha
 				targetData[mRowFuncTargetRed]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceRed] );
 				targetData[mRowFuncTargetGreen]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceGreen] );
 				targetData[mRowFuncTargetBlue]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceBlue] );
@@ -179,7 +550,7 @@ void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const vo
 		}
 		else {
 			if( mRowFuncTargetAlpha >= 0 ) { // target has alpha but source does not; force 'max' value for target alpha
-				for( int32_t c = 0; c < width; c++ ) {
+				for( ; c < width; c++ ) {
 					targetData[mRowFuncTargetRed]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceRed] );
 					targetData[mRowFuncTargetGreen]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceGreen] );
 					targetData[mRowFuncTargetBlue]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceBlue] );
@@ -189,7 +560,7 @@ void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const vo
 				}
 			}
 			else {
-				for( int32_t c = 0; c < width; c++ ) { // neither source nor target have alpha
+				for( ; c < width; c++ ) { // neither source nor target have alpha
 					targetData[mRowFuncTargetRed]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceRed] );
 					targetData[mRowFuncTargetGreen]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceGreen] );
 					targetData[mRowFuncTargetBlue]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceBlue] );
@@ -201,7 +572,7 @@ void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const vo
 	}
 	else if( TCM == CM_GRAY ) {
 		if( ALPHA ) {
-			for( int32_t c = 0; c < width; c++ ) {
+			for( ; c < width; c++ ) {
 				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( CHANTRAIT<SD>::grayscale( sourceData[mRowFuncSourceRed], sourceData[mRowFuncSourceGreen], sourceData[mRowFuncSourceBlue] ) );
 				targetData[mRowFuncTargetAlpha]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceAlpha] );
 				targetData += mRowFuncTargetInc;
@@ -209,7 +580,7 @@ void ImageSource::rowFuncSourceRgb( ImageTargetRef target, int32_t row, const vo
 			}
 		}
 		else {
-			for( int32_t c = 0; c < width; c++ ) {
+			for( ; c < width; c++ ) {
 				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( CHANTRAIT<SD>::grayscale( sourceData[mRowFuncSourceRed], sourceData[mRowFuncSourceGreen], sourceData[mRowFuncSourceBlue] ) );
 				targetData += mRowFuncTargetInc;
 				sourceData += mRowFuncSourceInc;
@@ -228,10 +599,26 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 	const SD *sourceData = reinterpret_cast<const SD*>( data );
 	TD *targetData = reinterpret_cast<TD*>( target->getRowPointer( row ) );
 	int32_t width = getWidth();
+	int32_t c = 0;
 	
 	if( TCM == CM_RGB ) {
+		if( HasSimdRowConversion<SD,TD>::value && mRowFuncTargetInc >= 3 && mRowFuncTargetInc <= 4 ) {
+			int8_t channels[4] = { -1, -1, -1, -1 };
+			channels[mRowFuncTargetRed] = mRowFuncSourceGray;
+			channels[mRowFuncTargetGreen] = mRowFuncSourceGray;
+			channels[mRowFuncTargetBlue] = mRowFuncSourceGray;
+			if( ALPHA )
+				channels[mRowFuncTargetAlpha] = mRowFuncSourceAlpha;
+			RowShuffle shuffle( mRowFuncSourceInc, mRowFuncTargetInc, channels );
+			if( shuffle.valid ) {
+				c = convertRowSimd( sourceData, targetData, width, shuffle );
+				sourceData += c * mRowFuncSourceInc;
+				targetData += c * mRowFuncTargetInc;
+			}
+		}
+
 		if( ALPHA ) {
-			for( int32_t c = 0; c < width; c++ ) {
+			for( ; c < width; c++ ) {
 				TD convertedData = CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceGray] );
 				targetData[mRowFuncTargetRed]	= convertedData;
 				targetData[mRowFuncTargetGreen]	= convertedData;
@@ -242,11 +629,13 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 			}
 		}
 		else {
-			for( int32_t c = 0; c < width; c++ ) {
+			for( ; c < width; c++ ) {
 				TD convertedData = CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceGray] );
 				targetData[mRowFuncTargetRed]	= convertedData;
 				targetData[mRowFuncTargetGreen]	= convertedData;
 				targetData[mRowFuncTargetBlue]	= convertedData;
+				if( mRowFuncTargetAlpha >= 0 ) // target has alpha but source does not; force 'max' value for target alpha, as the SIMD path does
+					targetData[mRowFuncTargetAlpha] = CHANTRAIT<TD>::max();
 				targetData += mRowFuncTargetInc;
 				sourceData += mRowFuncSourceInc;
 			}			
@@ -254,7 +643,7 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 	}
 	else if( TCM == CM_GRAY ) {
 		if( ALPHA ) {
-			for( int32_t c = 0; c < width; c++ ) {
+			for( ; c < width; c++ ) {
 				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncTargetGray] );
 				targetData[mRowFuncTargetAlpha]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncSourceAlpha] );
 				targetData += mRowFuncTargetInc;
@@ -262,7 +651,7 @@ void ImageSource::rowFuncSourceGray( ImageTargetRef target, int32_t row, const v
 			}
 		}
 		else {
-			for( int32_t c = 0; c < width; c++ ) {
+			for( ; c < width; c++ ) {
 				targetData[mRowFuncTargetGray]	= CHANTRAIT<TD>::convert( sourceData[mRowFuncTargetGray] );
 				targetData += mRowFuncTargetInc;
 				sourceData += mRowFuncSourceInc;
@@ -383,6 +772,132 @@ ImageSource::RowFunc ImageSource::setupRowFunc( ImageTargetRef target )
 	}
 }
 
+///////////////////////////////////////////////////////////////////////////////
+// ImageTargetCallback
+ImageTargetCallbackRef ImageTargetCallback::create( int32_t width, int32_t height, DataType dataType, ChannelOrder channelOrder, const BandFunc &bandFunc, int32_t bandRows )
+{
+	return ImageTargetCallbackRef( new ImageTargetCallback( width, height, dataType, channelOrder, bandFunc, bandRows ) );
+}
+
+ImageTargetCallbackRef ImageTargetCallback::create( const ImageSourceRef &imageSource, const BandFunc &bandFunc, int32_t bandRows )
+{
+	return create( imageSource->getWidth(), imageSource->getHeight(), imageSource->getDataType(), imageSource->getChannelOrder(), bandFunc, bandRows );
+}
+
+ImageTargetCallback::ImageTargetCallback( int32_t width, int32_t height, DataType dataType, ChannelOrder channelOrder, const BandFunc &bandFunc, int32_t bandRows )
+	: mBandFunc( bandFunc ), mBandRows( std::max<int32_t>( 1, bandRows ) ), mBandFirstRow( 0 ), mBandNumRows( 0 )
+{
+	switch( channelOrder ) {
+		case Y: case YA:
+			setColorModel( CM_GRAY );
+		break;
+		case CUSTOM:
+			throw ImageIoExceptionIllegalChannelOrder( "ImageTargetCallback requires an RGB or gray channel order." );
+		default:
+			setColorModel( CM_RGB );
+	}
+	setSize( width, height );
+	setDataType( dataType );
+	setChannelOrder( channelOrder );
+
+	mRowBytes = (size_t)width * channelOrderNumChannels( channelOrder ) * dataTypeBytes( dataType );
+	mBand.resize( mRowBytes * std::min( mBandRows, std::max<int32_t>( 1, height ) ) );
+}
+
+void* ImageTargetCallback::getRowPointer( int32_t row )
+{
+	// a row is complete once the next one is requested
+	if( mBandNumRows == 0 || row != mBandFirstRow + mBandNumRows - 1 ) {
+		CI_ASSERT_MSG( mBandNumRows == 0 || row == mBandFirstRow + mBandNumRows, "ImageTargetCallback rows must be written in order" );
+		if( mBandNumRows == mBandRows )
+			flushBand();
+		if( mBandNumRows == 0 )
+			mBandFirstRow = row;
+		++mBandNumRows;
+	}
+
+	return mBand.data() + ( row - mBandFirstRow ) * mRowBytes;
+}
+
+void ImageTargetCallback::finalize()
+{
+	flushBand();
+}
+
+void ImageTargetCallback::flushBand()
+{
+	if( mBandNumRows > 0 )
+		mBandFunc( mBandFirstRow, mBandNumRows, mBand.data(), mRowBytes );
+	mBandFirstRow += mBandNumRows;
+	mBandNumRows = 0;
+}
+
+namespace {
+
+// Applies ImageSource::Options::area() and downscale() to a source whose decoder does not support them, by reducing its rows as they stream
+class ImageSourceRegion : public ImageSource {
+  public:
+	ImageSourceRegion( const ImageSourceRef &source, const Options &options )
+		: ImageSource(), mSource( source )
+	{
+		setSize( source->getWidth(), source->getHeight() );
+		setColorModel( source->getColorModel() );
+		setDataType( source->getDataType() );
+		setChannelOrder( source->getChannelOrder() );
+		setPremultiplied( source->isPremultiplied() );
+		setPixelAspectRatio( source->getPixelAspectRatio() );
+		setFrameCount( source->getCount() );
+		setupRegion( options );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		RowFunc func = setupRowFunc( target );
+		auto rowTarget = std::make_shared<RowTarget>( *mSource, [&]( int32_t row, const void *data ) { processRow( func, target, row, data ); } );
+		mSource->load( rowTarget );
+		rowTarget->flush();
+	}
+
+  private:
+	// Receives the full rows of the wrapped source in its own format. A row is complete once the next one is requested.
+	class RowTarget : public ImageTarget {
+	  public:
+		RowTarget( const ImageSource &source, const std::function<void( int32_t, const void* )> &rowFn )
+			: mRowFn( rowFn ), mPendingRow( -1 )
+		{
+			setSize( source.getWidth(), source.getHeight() );
+			setColorModel( source.getColorModel() );
+			setDataType( source.getDataType() );
+			setChannelOrder( source.getChannelOrder() );
+			mRow.resize( source.getRowBytes() );
+		}
+
+		void* getRowPointer( int32_t row ) override
+		{
+			if( row != mPendingRow )
+				flush();
+			mPendingRow = row;
+			return mRow.data();
+		}
+
+		void flush()
+		{
+			if( mPendingRow >= 0 )
+				mRowFn( mPendingRow, mRow.data() );
+			mPendingRow = -1;
+		}
+
+	  private:
+		std::function<void( int32_t, const void* )>	mRowFn;
+		std::vector<uint8_t>						mRow;
+		int32_t										mPendingRow;
+	};
+
+	ImageSourceRef	mSource;
+};
+
+} // anonymous namespace
+
 ImageSourceRef loadImage( const fs::path &path, ImageSource::Options options, string extension )
 {
 #if defined( CINDER_ANDROID )
@@ -405,7 +920,12 @@ ImageSourceRef loadImage( DataSourceRef dataSource, ImageSource::Options options
 
 	if( extension.empty() ) // this is necessary to limit the lifetime of the objc-based loader's allocations
 		extension = dataSource->getFilePathHint().extension().string();
-	return ImageIoRegistrar::createSource( dataSource, options, extension );
+	ImageSourceRef result = ImageIoRegistrar::createSource( dataSource, options, extension );
+
+	// decoders which cannot skip data natively are reduced as their rows stream
+	if( result && options.hasRegion() && ! result->isRegionApplied() && result->getColorModel() != ImageIo::CM_UNKNOWN )
+		result = std::make_shared<ImageSourceRegion>( result, options );
+	return result;
 }
 
 void writeImage( const fs::path &path, const ImageSourceRef &imageSource, ImageTarget::Options options, std::string extension )
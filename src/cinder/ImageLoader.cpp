@@ -0,0 +1,268 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageLoader.h"
+#include "cinder/ImageSourceFileStbImage.h"
+#include "cinder/Thread.h"
+
+#if defined( CINDER_ANDROID )
+	#include "cinder/app/android/PlatformAndroid.h"
+#endif
+
+namespace cinder {
+
+ImageLoader::ImageLoader( const Format &format )
+	: mFormat( format ), mNextSequence( 0 ), mNumActive( 0 ), mInFlightBytes( 0 ), mShutdown( false )
+{
+	int numThreads = mFormat.getThreads();
+	if( numThreads <= 0 )
+		numThreads = std::max<int>( 1, std::thread::hardware_concurrency() );
+
+	for( int t = 0; t < numThreads; ++t )
+		mThreads.emplace_back( &ImageLoader::threadFn, this );
+}
+
+ImageLoader::~ImageLoader()
+{
+	cancelAll();
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mShutdown = true;
+	}
+	mJobCondition.notify_all();
+
+	for( auto &thread : mThreads )
+		thread.join();
+}
+
+template<typename T>
+std::future<SurfaceT<T>> ImageLoader::load( const fs::path &path, const Request &request )
+{
+	return enqueue<T>( [path] {
+#if defined( CINDER_ANDROID )
+		if( ci::app::PlatformAndroid::isAssetPath( path ) )
+			return (DataSourceRef)DataSourceAndroidAsset::create( path );
+#endif
+		return (DataSourceRef)DataSourcePath::create( path );
+	}, request );
+}
+
+template<typename T>
+std::future<SurfaceT<T>> ImageLoader::load( const DataSourceRef &dataSource, const Request &request )
+{
+	return enqueue<T>( [dataSource] { return dataSource; }, request );
+}
+
+template<typename T>
+std::vector<std::future<SurfaceT<T>>> ImageLoader::load( const std::vector<fs::path> &paths, const Request &request )
+{
+	std::vector<std::future<SurfaceT<T>>> result;
+	result.reserve( paths.size() );
+	for( const auto &path : paths )
+		result.push_back( load<T>( path, request ) );
+
+	return result;
+}
+
+template<typename T>
+std::vector<std::future<SurfaceT<T>>> ImageLoader::load( const std::vector<DataSourceRef> &dataSources, const Request &request )
+{
+	std::vector<std::future<SurfaceT<T>>> result;
+	result.reserve( dataSources.size() );
+	for( const auto &dataSource : dataSources )
+		result.push_back( load<T>( dataSource, request ) );
+
+	return result;
+}
+
+template<typename T>
+std::future<SurfaceT<T>> ImageLoader::enqueue( const std::function<DataSourceRef()> &source, const Request &request )
+{
+	// std::function requires copyable callables, so the promise is shared between the run and fail paths
+	auto promise = std::make_shared<std::promise<SurfaceT<T>>>();
+	std::future<SurfaceT<T>> result = promise->get_future();
+
+	Job job;
+	job.mGroup = request.getGroup();
+	job.mRun = [this, promise, source, request] {
+		try {
+			promise->set_value( decode<T>( source(), request ) );
+		}
+		catch( ... ) {
+			promise->set_exception( std::current_exception() );
+		}
+	};
+	job.mFail = [promise]( std::exception_ptr exc ) { promise->set_exception( exc ); };
+
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mJobs.emplace( std::make_pair( request.getPriority(), mNextSequence++ ), std::move( job ) );
+	}
+	mJobCondition.notify_one();
+
+	return result;
+}
+
+template<typename T>
+SurfaceT<T> ImageLoader::decode( const DataSourceRef &dataSource, const Request &request )
+{
+	// Most decoders hold the whole image from the moment they are opened (stb_image decodes every pixel in its constructor),
+	// so when the header can be parsed up front the reservation covers that buffer as well as the Surface, and is made before
+	// opening. Formats stb_image does not recognize are reserved once opened, at the size of the Surface.
+	size_t bytes = 0;
+	int32_t width, height, numComponents;
+	bool isFloat;
+	if( ImageSourceFileStbImage::probe( dataSource, &width, &height, &numComponents, &isFloat ) ) {
+		const size_t numPixels = (size_t)width * height;
+		bytes = numPixels * numComponents * ( isFloat ? sizeof(float) : 1 ) + numPixels * ( ( numComponents % 2 == 0 ) ? 4 : 3 ) * sizeof(T);
+		reserve( bytes );
+	}
+
+	try {
+		ImageSourceRef imageSource = loadImage( dataSource, request.getImageOptions(), request.getExtension() );
+		if( ! imageSource )
+			throw ImageIoExceptionUnknownExtension( "no ImageSource handler for the requested image" );
+
+		if( bytes == 0 ) {
+			bytes = (size_t)imageSource->getWidth() * imageSource->getHeight() * ( imageSource->hasAlpha() ? 4 : 3 ) * sizeof(T);
+			reserve( bytes );
+		}
+
+		SurfaceT<T> result = ( mFormat.getSurfacePool() ) ? mFormat.getSurfacePool()->load<T>( imageSource ) : SurfaceT<T>( imageSource );
+		// the ImageSource's own pixels are counted until it is destroyed
+		imageSource.reset();
+		release( bytes );
+		return result;
+	}
+	catch( ... ) {
+		if( bytes )
+			release( bytes );
+		throw;
+	}
+}
+
+void ImageLoader::reserve( size_t bytes )
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	mBudgetCondition.wait( lock, [&] { return mInFlightBytes == 0 || mInFlightBytes + bytes <= mFormat.getMaxInFlightBytes(); } );
+	mInFlightBytes += bytes;
+}
+
+void ImageLoader::release( size_t bytes )
+{
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		mInFlightBytes -= bytes;
+	}
+	mBudgetCondition.notify_all();
+}
+
+void ImageLoader::threadFn()
+{
+	ThreadSetup threadSetup;
+
+	while( true ) {
+		Job job;
+		{
+			std::unique_lock<std::mutex> lock( mMutex );
+			mJobCondition.wait( lock, [this] { return mShutdown || ! mJobs.empty(); } );
+			if( mShutdown )
+				return;
+
+			job = std::move( mJobs.begin()->second );
+			mJobs.erase( mJobs.begin() );
+			++mNumActive;
+		}
+
+		job.mRun();
+
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			--mNumActive;
+		}
+		mIdleCondition.notify_all();
+	}
+}
+
+size_t ImageLoader::cancel( uint32_t group )
+{
+	return cancelIf( [group]( const Job &job ) { return job.mGroup == group; } );
+}
+
+size_t ImageLoader::cancelAll()
+{
+	return cancelIf( []( const Job & ) { return true; } );
+}
+
+size_t ImageLoader::cancelIf( const std::function<bool( const Job& )> &predicate )
+{
+	std::vector<Job> canceled;
+	{
+		std::lock_guard<std::mutex> lock( mMutex );
+		for( auto it = mJobs.begin(); it != mJobs.end(); ) {
+			if( predicate( it->second ) ) {
+				canceled.push_back( std::move( it->second ) );
+				it = mJobs.erase( it );
+			}
+			else
+				++it;
+		}
+	}
+	mIdleCondition.notify_all();
+
+	// fulfilled outside the lock, since continuations of the futures may submit new requests
+	for( auto &job : canceled )
+		job.mFail( std::make_exception_ptr( ImageLoaderCanceledExc() ) );
+
+	return canceled.size();
+}
+
+void ImageLoader::waitForIdle()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	mIdleCondition.wait( lock, [this] { return mJobs.empty() && mNumActive == 0; } );
+}
+
+size_t ImageLoader::getNumPending() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mJobs.size();
+}
+
+size_t ImageLoader::getInFlightBytes() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mInFlightBytes;
+}
+
+#define IMAGELOADER_PROTOTYPES(T)\
+	template CI_API std::future<SurfaceT<T>> ImageLoader::load<T>( const fs::path &path, const Request &request );\
+	template CI_API std::future<SurfaceT<T>> ImageLoader::load<T>( const DataSourceRef &dataSource, const Request &request );\
+	template CI_API std::vector<std::future<SurfaceT<T>>> ImageLoader::load<T>( const std::vector<fs::path> &paths, const Request &request );\
+	template CI_API std::vector<std::future<SurfaceT<T>>> ImageLoader::load<T>( const std::vector<DataSourceRef> &dataSources, const Request &request );
+
+IMAGELOADER_PROTOTYPES(uint8_t)
+IMAGELOADER_PROTOTYPES(uint16_t)
+IMAGELOADER_PROTOTYPES(float)
+
+} // namespace cinder
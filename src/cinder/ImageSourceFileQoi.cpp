@@ -22,10 +22,12 @@
 */
 
 #include "cinder/ImageSourceFileQoi.h"
+#include "cinder/ip/Parallel.h"
 #define QOI_NO_STDIO
 #define QOI_IMPLEMENTATION
 #include "qoi/qoi.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
 
@@ -33,8 +35,8 @@ namespace cinder {
 
 namespace {
 
-// Cross-platform wrapper for qoi_read that handles Unicode paths properly
-void* qoiReadPath( const fs::path &path, qoi_desc *desc, int channels )
+// Cross-platform file read that handles Unicode paths properly
+BufferRef qoiReadPath( const fs::path &path )
 {
 #if defined( CINDER_MSW )
 	FILE *f = _wfopen( path.wstring().c_str(), L"rb" );
@@ -46,26 +48,90 @@ void* qoiReadPath( const fs::path &path, qoi_desc *desc, int channels )
 		return nullptr;
 
 	fseek( f, 0, SEEK_END );
-	int size = ftell( f );
+	long size = ftell( f );
 	if( size <= 0 || fseek( f, 0, SEEK_SET ) != 0 ) {
 		fclose( f );
 		return nullptr;
 	}
 
-	void *data = malloc( size );
-	if( ! data ) {
-		fclose( f );
-		return nullptr;
-	}
-
-	int bytesRead = (int)fread( data, 1, size, f );
+	BufferRef result = Buffer::create( (size_t)size );
+	size_t bytesRead = fread( result->getData(), 1, (size_t)size, f );
 	fclose( f );
 
-	void *pixels = ( bytesRead != size ) ? nullptr : qoi_decode( data, bytesRead, desc, channels );
-	free( data );
-	return pixels;
+	return ( bytesRead != (size_t)size ) ? nullptr : result;
 }
 
+// the decoder state carried from one row to the next, starting over at the beginning of each chunk
+struct QoiDecoder {
+	QoiDecoder( int pos )
+		: mPos( pos ), mRun( 0 )
+	{
+		QOI_ZEROARR( mIndex );
+		mPx.rgba.r = 0;
+		mPx.rgba.g = 0;
+		mPx.rgba.b = 0;
+		mPx.rgba.a = 255;
+	}
+
+	// decodes \a width pixels into \a out, reading no further than \a chunksLen
+	void decodeRow( const unsigned char *bytes, int chunksLen, uint8_t *out, int32_t width, int channels )
+	{
+		for( int32_t x = 0; x < width; ++x, out += channels ) {
+			if( mRun > 0 ) {
+				mRun--;
+			}
+			else if( mPos < chunksLen ) {
+				int b1 = bytes[mPos++];
+
+				if( b1 == QOI_OP_RGB ) {
+					mPx.rgba.r = bytes[mPos++];
+					mPx.rgba.g = bytes[mPos++];
+					mPx.rgba.b = bytes[mPos++];
+				}
+				else if( b1 == QOI_OP_RGBA ) {
+					mPx.rgba.r = bytes[mPos++];
+					mPx.rgba.g = bytes[mPos++];
+					mPx.rgba.b = bytes[mPos++];
+					mPx.rgba.a = bytes[mPos++];
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_INDEX ) {
+					mPx = mIndex[b1];
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_DIFF ) {
+					mPx.rgba.r += ( ( b1 >> 4 ) & 0x03 ) - 2;
+					mPx.rgba.g += ( ( b1 >> 2 ) & 0x03 ) - 2;
+					mPx.rgba.b += ( b1 & 0x03 ) - 2;
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_LUMA ) {
+					int b2 = bytes[mPos++];
+					int vg = ( b1 & 0x3f ) - 32;
+					mPx.rgba.r += vg - 8 + ( ( b2 >> 4 ) & 0x0f );
+					mPx.rgba.g += vg;
+					mPx.rgba.b += vg - 8 + ( b2 & 0x0f );
+				}
+				else if( ( b1 & QOI_MASK_2 ) == QOI_OP_RUN ) {
+					mRun = ( b1 & 0x3f );
+				}
+
+				mIndex[QOI_COLOR_HASH( mPx ) & ( 64 - 1 )] = mPx;
+			}
+
+			out[0] = mPx.rgba.r;
+			out[1] = mPx.rgba.g;
+			out[2] = mPx.rgba.b;
+			if( channels == 4 )
+				out[3] = mPx.rgba.a;
+		}
+	}
+
+	qoi_rgba_t	mIndex[64];
+	qoi_rgba_t	mPx;
+	int			mPos, mRun;
+};
+
+const int QOI_CHUNKED_TRAILER_SIZE = 12; // chunk count, rows per chunk and magic, preceded by the chunk offsets
+const unsigned char QOI_CHUNKED_MAGIC[4] = { 'q', 'o', 'i', 'c' };
+
 } // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////
@@ -86,34 +152,30 @@ void ImageSourceFileQoi::registerSelf()
 
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSourceFileQoi
-ImageSourceFileQoi::ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
-	: mData( nullptr ), mRowBytes( 0 )
+ImageSourceFileQoi::ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource::Options options )
+	: mFullWidth( 0 ), mFullHeight( 0 ), mChannels( 0 ), mRowsPerChunk( 0 ), mChunksEnd( 0 ), mThreads( options.getThreads() )
 {
-	qoi_desc desc;
-	int channels = 0;
+	// only the header is parsed here; pixels are decoded row by row in load()
+	mData = ( dataSourceRef->isFilePath() && ! dataSourceRef->isMapped() ) ? qoiReadPath( dataSourceRef->getFilePath() ) : dataSourceRef->getBuffer();
+	if( ! mData || mData->getSize() < QOI_HEADER_SIZE + sizeof(qoi_padding) )
+		throw ImageIoExceptionFailedLoad( "Failed to load QOI image" );
 
-	if( dataSourceRef->isFilePath() ) {
-		mData = (uint8_t*)qoiReadPath( dataSourceRef->getFilePath(), &desc, 0 );
-		if( ! mData )
-			throw ImageIoExceptionFailedLoad( "Failed to load QOI image" );
-
-		channels = desc.channels;
-		mRowBytes = desc.width * channels;
-	}
-	else { // we'll use a dataref from the buffer
-		BufferRef buffer = dataSourceRef->getBuffer();
-		mData = (uint8_t*)qoi_decode( buffer->getData(), (int)buffer->getSize(), &desc, 0 );
-		if( ! mData )
-			throw ImageIoExceptionFailedLoad( "Failed to decode QOI image" );
-
-		channels = desc.channels;
-		mRowBytes = desc.width * channels;
-	}
+	const unsigned char *bytes = (const unsigned char*)mData->getData();
+	int p = 0;
+	unsigned int magic = qoi_read_32( bytes, &p );
+	unsigned int width = qoi_read_32( bytes, &p );
+	unsigned int height = qoi_read_32( bytes, &p );
+	mChannels = bytes[p++];
+	unsigned int colorspace = bytes[p++];
+	if( magic != QOI_MAGIC || width == 0 || height == 0 || colorspace > 1 || height >= QOI_PIXELS_MAX / width )
+		throw ImageIoExceptionFailedLoad( "Failed to decode QOI image" );
 
 	setDataType( ImageIo::UINT8 );
-	setSize( desc.width, desc.height );
+	mFullWidth = (int32_t)width;
+	mFullHeight = (int32_t)height;
+	setSize( mFullWidth, mFullHeight );
 
-	switch( channels ) {
+	switch( mChannels ) {
 		case 3:
 			setColorModel( ImageIo::CM_RGB );
 			setChannelOrder( ImageIo::ChannelOrder::RGB );
@@ -123,23 +185,95 @@ ImageSourceFileQoi::ImageSourceFileQoi( DataSourceRef dataSourceRef, ImageSource
 			setChannelOrder( ImageIo::ChannelOrder::RGBA );
 		break;
 		default:
-			free( mData );
 			throw ImageIoException( "QOI: Unsupported number of channels" );
 	}
-}
 
+	readChunkIndex();
+	setupRegion( options );
+}
 
-ImageSourceFileQoi::~ImageSourceFileQoi()
+void ImageSourceFileQoi::readChunkIndex()
 {
-	if( mData )
-		free( mData );
+	// a chunked file as written by ImageTargetFileQoi has an index of its chunks after the end marker; anything unexpected is read as a plain QOI stream
+	const unsigned char *bytes = (const unsigned char*)mData->getData();
+	const int size = (int)mData->getSize();
+	if( size < QOI_HEADER_SIZE + (int)sizeof(qoi_padding) + QOI_CHUNKED_TRAILER_SIZE || memcmp( bytes + size - 4, QOI_CHUNKED_MAGIC, 4 ) != 0 )
+		return;
+
+	int p = size - QOI_CHUNKED_TRAILER_SIZE;
+	const unsigned int numChunks = qoi_read_32( bytes, &p );
+	const unsigned int rowsPerChunk = qoi_read_32( bytes, &p );
+	if( rowsPerChunk == 0 || numChunks != ( (unsigned int)mFullHeight + rowsPerChunk - 1 ) / rowsPerChunk )
+		return;
+	const int64_t indexPos = (int64_t)size - QOI_CHUNKED_TRAILER_SIZE - 4 * (int64_t)numChunks;
+	const int64_t chunksEnd = indexPos - (int64_t)sizeof(qoi_padding);
+	if( chunksEnd < QOI_HEADER_SIZE || memcmp( bytes + chunksEnd, qoi_padding, sizeof(qoi_padding) ) != 0 )
+		return;
+
+	std::vector<uint32_t> offsets( numChunks );
+	p = (int)indexPos;
+	for( size_t c = 0; c < offsets.size(); ++c ) {
+		offsets[c] = qoi_read_32( bytes, &p );
+		const int64_t previous = ( c > 0 ) ? offsets[c - 1] : QOI_HEADER_SIZE;
+		if( offsets[c] < previous || offsets[c] > chunksEnd )
+			return;
+	}
+
+	mChunkOffsets = std::move( offsets );
+	mRowsPerChunk = (int32_t)rowsPerChunk;
+	mChunksEnd = (int)chunksEnd;
 }
 
 void ImageSourceFileQoi::load( ImageTargetRef target )
 {
 	ImageSource::RowFunc func = setupRowFunc( target );
-	for( int32_t row = 0; row < mHeight; ++row ) {
-		((*this).*func)( target, row, mData + row * mRowBytes );
+
+	if( ! mChunkOffsets.empty() ) {
+		loadChunked( func, target );
+		return;
+	}
+
+	const unsigned char *bytes = (const unsigned char*)mData->getData();
+	const int chunksLen = (int)mData->getSize() - (int)sizeof(qoi_padding);
+	std::vector<uint8_t> rowData( (size_t)mFullWidth * mChannels );
+	QoiDecoder decoder( QOI_HEADER_SIZE );
+
+	// QOI is a single sequential stream, so rows above the region must be decoded but rows below it are never touched
+	const int32_t lastRow = getRegionArea().y2;
+	for( int32_t row = 0; row < lastRow; ++row ) {
+		decoder.decodeRow( bytes, chunksLen, rowData.data(), mFullWidth, mChannels );
+		processRow( func, target, row, rowData.data() );
+	}
+}
+
+void ImageSourceFileQoi::loadChunked( ImageSource::RowFunc func, const ImageTargetRef &target )
+{
+	const unsigned char *bytes = (const unsigned char*)mData->getData();
+	const size_t rowBytes = (size_t)mFullWidth * mChannels;
+
+	// only the chunks overlapping the region are decoded, a batch of one chunk per thread at a time
+	const Area &area = getRegionArea();
+	const int32_t firstChunk = area.y1 / mRowsPerChunk, lastChunk = ( area.y2 - 1 ) / mRowsPerChunk + 1;
+	const int batchChunks = ip::Options().threads( mThreads ).getNumThreadsForRows( lastChunk - firstChunk );
+	std::vector<uint8_t> batchData( rowBytes * mRowsPerChunk * batchChunks );
+
+	for( int32_t batchBegin = firstChunk; batchBegin < lastChunk; batchBegin += batchChunks ) {
+		const int32_t batchEnd = std::min( batchBegin + batchChunks, lastChunk );
+		ip::parallelForRows( batchBegin, batchEnd, ip::Options().threads( mThreads ), [&]( int32_t chunkBegin, int32_t chunkEnd ) {
+			for( int32_t chunk = chunkBegin; chunk < chunkEnd; ++chunk ) {
+				const int chunkLen = ( chunk + 1 < (int32_t)mChunkOffsets.size() ) ? (int)mChunkOffsets[chunk + 1] : mChunksEnd;
+				QoiDecoder decoder( (int)mChunkOffsets[chunk] );
+				uint8_t *out = &batchData[( chunk - batchBegin ) * mRowsPerChunk * rowBytes];
+				const int32_t numRows = std::min( mRowsPerChunk, mFullHeight - chunk * mRowsPerChunk );
+				for( int32_t row = 0; row < numRows; ++row, out += rowBytes )
+					decoder.decodeRow( bytes, chunkLen, out, mFullWidth, mChannels );
+			}
+		} );
+
+		const int32_t firstRow = std::max( area.y1, batchBegin * mRowsPerChunk );
+		const int32_t lastRow = std::min( area.y2, batchEnd * mRowsPerChunk );
+		for( int32_t row = firstRow; row < lastRow; ++row )
+			processRow( func, target, row, &batchData[( row - batchBegin * mRowsPerChunk ) * rowBytes] );
 	}
 }
 
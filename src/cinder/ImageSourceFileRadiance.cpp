@@ -24,6 +24,11 @@
 
 #include "cinder/ImageSourceFileRadiance.h"
 #include "cinder/Stream.h"
+#include "cinder/ip/Parallel.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
 
 namespace cinder {
 
@@ -36,7 +41,6 @@ void ImageSourceFileRadiance::load( ImageTargetRef target )
 {
 	// get a pointer to the ImageSource function appropriate for handling our data configuration
 	ImageSource::RowFunc func = setupRowFunc( target );
-	//int number_passes = png_set_interlace_handling( mPngPtr );
 	for( int32_t row = 0; row < mHeight; ++row ) {
 		((*this).*func)( target, row, mRgbData.get() + ( row * mWidth * 3 ) );
 	}
@@ -48,11 +52,11 @@ void ImageSourceFileRadiance::registerSelf()
 	ImageIoRegistrar::registerSourceType( "hdr", sourceFunc, 1 );
 }
 
-ImageSourceFileRadiance::ImageSourceFileRadiance( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
+ImageSourceFileRadiance::ImageSourceFileRadiance( DataSourceRef dataSourceRef, ImageSource::Options options )
 {
 	IStreamRef stream = dataSourceRef->createStream();
 
-	loadStream( stream );
+	loadStream( stream, options );
 }
 
 namespace {
@@ -63,12 +67,13 @@ const int MAXELEN = 0x7fff;			// maximum scanline length for encoding
 
 enum { R, G, B, E };
 
-void workOnRgbeScanline( RgbePixel *scan, int len, float *cols );
-bool decrunchScanline( RgbePixel *scanline, int len, IStreamCinder *stream );
-bool oldStyleDecrunch( RgbePixel *scanline, int len, IStreamCinder *stream );
+void workOnRgbeScanline( const RgbePixel *scan, int len, float *cols );
+// decodes one scanline starting at \a *p, advancing it past the scanline; when \a scanline is null the scanline is only skipped
+bool decrunchScanline( RgbePixel *scanline, int len, const uint8_t **p, const uint8_t *end );
+bool oldStyleDecrunch( RgbePixel *scanline, int len, bool first, const uint8_t **p, const uint8_t *end );
 }
 
-void ImageSourceFileRadiance::loadStream( IStreamRef stream )
+void ImageSourceFileRadiance::loadStream( IStreamRef stream, const ImageSource::Options &options )
 {
 	setDataType( ImageIo::FLOAT32 );
 	setColorModel( ImageIo::CM_RGB );
@@ -113,118 +118,164 @@ void ImageSourceFileRadiance::loadStream( IStreamRef stream )
 	if( ! sscanf( resolution, "-Y %d +X %d", &height, &width ) )
 		throw ImageSourceFileRadianceException( "Unable to parse size" );
 	setSize( width, height );
-
-	mRgbData = std::unique_ptr<float[]>( new float[width * height * 3] );
-	std::unique_ptr<RgbePixel[]> scanline( new RgbePixel[width] );
-
-	// convert image
-	float *cols = mRgbData.get();
-	for( int y = height - 1; y >= 0; y-- ) {
-		if( ! decrunchScanline( scanline.get(), width, stream.get() ) )
+	setupRegion( options );
+
+	// the scanlines are decoded from memory so that they can be located up front and converted independently
+	std::vector<uint8_t> pixels( (size_t)std::max<off_t>( 0, stream->size() - stream->tell() ) );
+	pixels.resize( stream->readDataAvailable( pixels.data(), pixels.size() ) );
+	const uint8_t *end = pixels.data() + pixels.size();
+
+	// locating a scanline only walks its run codes, so this pass is cheap next to the conversion; scanlines below the region are never touched
+	const Area &area = getRegionArea();
+	std::vector<const uint8_t*> scanlineStarts;
+	scanlineStarts.reserve( area.getHeight() );
+	const uint8_t *p = pixels.data();
+	for( int32_t y = 0; y < area.y2; ++y ) {
+		const uint8_t *start = p;
+		if( ! decrunchScanline( nullptr, width, &p, end ) )
 			break;
-		workOnRgbeScanline( scanline.get(), width, cols );
-		cols += width * 3;
+		if( y >= area.y1 )
+			scanlineStarts.push_back( start );
 	}
+
+	// only the reduced image is stored; rows of a truncated file are left black
+	mRgbData = std::unique_ptr<float[]>( new float[mWidth * mHeight * 3]() );
+	const int32_t factor = options.getDownscale();
+	const int32_t numScanlines = (int32_t)scanlineStarts.size();
+
+	// each band covers whole downscale blocks, so it can reduce its rows without sharing state with its neighbors
+	ip::parallelForRows( 0, mHeight, ip::Options().threads( options.getThreads() ), [&]( int32_t bandBegin, int32_t bandEnd ) {
+		RowReducer rowReducer = mRowReducer;
+		std::unique_ptr<RgbePixel[]> scanline( new RgbePixel[width] );
+		std::unique_ptr<float[]> cols( new float[width * 3] );
+		const int32_t lastScanline = std::min( bandEnd * factor, numScanlines );
+		for( int32_t s = bandBegin * factor; s < lastScanline; ++s ) {
+			const uint8_t *scanlineData = scanlineStarts[s];
+			decrunchScanline( scanline.get(), width, &scanlineData, end );
+			workOnRgbeScanline( scanline.get() + area.x1, area.getWidth(), cols.get() + area.x1 * 3 );
+			rowReducer.addRow( area.y1 + s, cols.get(), [&]( int32_t row, const void *data ) {
+				memcpy( mRgbData.get() + row * mWidth * 3, data, mWidth * 3 * sizeof(float) );
+			} );
+		}
+	} );
 }
 
 namespace {
-// this should be optimized
-float convertComponent( int expo, int val )
-{
-	float v = val / 256.0f;
-	float d = powf( 2.0f, static_cast<float>( expo ) );
-	return v * d;
-}
+// 2^(e - 128) / 256 for each exponent byte, which is exact and replaces a powf() per component
+struct ExponentTable {
+	ExponentTable()
+	{
+		for( int e = 0; e < 256; ++e )
+			mScale[e] = ldexpf( 1.0f, e - 136 );
+	}
+
+	float mScale[256];
+};
 
-void workOnRgbeScanline( RgbePixel *scan, int len, float *cols )
+void workOnRgbeScanline( const RgbePixel *scan, int len, float *cols )
 {
+	static const ExponentTable sExponents;
+
 	while( len-- > 0 ) {
-		int expo = scan[0][E] - 128;
-		cols[0] = convertComponent( expo, scan[0][R] );
-		cols[1] = convertComponent( expo, scan[0][G] );
-		cols[2] = convertComponent( expo, scan[0][B] );
+		const float scale = sExponents.mScale[scan[0][E]];
+		cols[0] = scan[0][R] * scale;
+		cols[1] = scan[0][G] * scale;
+		cols[2] = scan[0][B] * scale;
 		cols += 3;
 		scan++;
 	}
 }
 
-bool decrunchScanline( RgbePixel *scanline, int len, IStreamCinder *stream )
+bool decrunchScanline( RgbePixel *scanline, int len, const uint8_t **p, const uint8_t *end )
 {
-	char i;
-
-	// Early out if there's nothing more to read from the stream
- 	if ( stream->isEof() )
- 		 return false;
-
-	if( len < MINELEN || len > MAXELEN )
-		return oldStyleDecrunch(scanline, len, stream );
-
-	stream->read( &i );
-	if( i != 2 ) { // old style
-		stream->seekRelative( -1 );
-		return oldStyleDecrunch( scanline, len, stream );
-	}
-
-	stream->read( &scanline[0][G] );
-	stream->read( &scanline[0][B] );
-	stream->read( &i );
-
-	if( scanline[0][G] != 2 || scanline[0][B] & 128 ) {
-		scanline[0][R] = 2;
-		scanline[0][E] = i;
-		return oldStyleDecrunch( scanline + 1, len - 1, stream );
+	const uint8_t *&in = *p;
+
+	// Early out if there's nothing more to read
+	if( in >= end )
+		return false;
+
+	if( len < MINELEN || len > MAXELEN || in[0] != 2 ) // old style
+		return oldStyleDecrunch( scanline, len, true, p, end );
+
+	if( end - in < 4 )
+		return false;
+	if( in[1] != 2 || in[2] & 128 ) {
+		if( scanline )
+			memcpy( &scanline[0][0], in, 4 );
+		in += 4;
+		return oldStyleDecrunch( scanline ? scanline + 1 : nullptr, len - 1, false, p, end );
 	}
+	in += 4;
 
 	// read each component
-	for( i = 0; i < 4; i++ ) {
-	    for( int j = 0; j < len; ) {
-			unsigned char code;
-			stream->read( &code );
+	for( int i = 0; i < 4; i++ ) {
+		for( int j = 0; j < len; ) {
+			if( in >= end )
+				return false;
+			int code = *in++;
 			if( code > 128 ) { // run
-			    code &= 127;
-			    unsigned char val;
-				stream->read( &val );
-			    while( code-- )
-					scanline[j++][i] = val;
+				code &= 127;
+				if( in >= end || code > len - j )
+					return false;
+				const uint8_t val = *in++;
+				if( scanline ) {
+					while( code-- )
+						scanline[j++][i] = val;
+				}
+				else
+					j += code;
 			}
 			else {	// non-run
-				while( code-- )
-					stream->read( &scanline[j++][i] );
+				if( code > end - in || code > len - j )
+					return false;
+				if( scanline ) {
+					while( code-- )
+						scanline[j++][i] = *in++;
+				}
+				else {
+					j += code;
+					in += code;
+				}
 			}
 		}
-    }
+	}
 
-	// NOTE: at this point on the **LAST** scanline, the stream
-	// should be EOF, but we still want to process that last scanline!
 	return true;
 }
 
-bool oldStyleDecrunch( RgbePixel *scanline, int len, IStreamCinder *stream )
+// \a first is false when the scanline's first pixel has already been read, and so can be repeated by a run
+bool oldStyleDecrunch( RgbePixel *scanline, int len, bool first, const uint8_t **p, const uint8_t *end )
 {
-	int i;
+	const uint8_t *&in = *p;
 	int rshift = 0;
 	
 	while( len > 0 ) {
-		stream->read( &scanline[0][R] );
-		stream->read( &scanline[0][G] );
-		stream->read( &scanline[0][B] );
-		stream->read( &scanline[0][E] );
-		if( stream->isEof() )
+		if( end - in < 4 )
 			return false;
-
-		if( scanline[0][R] == 1 &&
-			scanline[0][G] == 1 &&
-			scanline[0][B] == 1) {
-			for( i = scanline[0][E] << rshift; i > 0; i-- ) {
-				memcpy( &scanline[0][0], &scanline[-1][0], 4 );
-				scanline++;
-				len--;
+		const uint8_t *pixel = in;
+		in += 4;
+
+		if( pixel[R] == 1 && pixel[G] == 1 && pixel[B] == 1 ) {
+			// a run repeats the previous pixel, so it can't begin the scanline or extend past its end
+			const int64_t count = (int64_t)pixel[E] << std::min( rshift, 32 );
+			if( first || count > len )
+				return false;
+			if( scanline ) {
+				for( int64_t i = 0; i < count; i++ ) {
+					memcpy( &scanline[0][0], &scanline[-1][0], 4 );
+					scanline++;
+				}
 			}
+			len -= (int)count;
 			rshift += 8;
 		}
 		else {
-			scanline++;
+			if( scanline ) {
+				memcpy( &scanline[0][0], pixel, 4 );
+				scanline++;
+			}
 			len--;
+			first = false;
 			rshift = 0;
 		}
 	}
@@ -233,4 +284,4 @@ bool oldStyleDecrunch( RgbePixel *scanline, int len, IStreamCinder *stream )
 }
 } // anonymous namespace
 
-} // namespace cinder
\ No newline at end of file
+} // namespace cinder
@@ -57,12 +57,34 @@ void ImageSourceFileStbImage::registerSelf()
 
 ///////////////////////////////////////////////////////////////////////////////
 // ImageSourceFileStbImage
+bool ImageSourceFileStbImage::probe( const DataSourceRef &dataSource, int32_t *width, int32_t *height, int32_t *numComponents, bool *isFloat )
+{
+	int w = 0, h = 0, components = 0;
+	if( dataSource->isFilePath() && ! dataSource->isMapped() ) {
+		const std::string path = dataSource->getFilePath().string();
+		if( ! stbi_info( path.c_str(), &w, &h, &components ) )
+			return false;
+		*isFloat = stbi_is_hdr( path.c_str() ) != 0;
+	}
+	else {
+		BufferRef buffer = dataSource->getBuffer();
+		if( ! stbi_info_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize(), &w, &h, &components ) )
+			return false;
+		*isFloat = stbi_is_hdr_from_memory( (unsigned char*)buffer->getData(), (int)buffer->getSize() ) != 0;
+	}
+
+	*width = w;
+	*height = h;
+	*numComponents = components;
+	return true;
+}
+
 ImageSourceFileStbImage::ImageSourceFileStbImage( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
 	: mData8u( nullptr ), mData32f( nullptr ), mRowBytes( 0 )
 {
 	int width = 0, height = 0, components = 0;
 
-	if( dataSourceRef->isFilePath() ) {
+	if( dataSourceRef->isFilePath() && ! dataSourceRef->isMapped() ) {
 		if( stbi_is_hdr( dataSourceRef->getFilePath().string().c_str() ) ) {
 			mData32f = stbi_loadf( dataSourceRef->getFilePath().string().c_str(), &width, &height, &components, 0 /*any # of components*/ );
 			if( ! mData32f )
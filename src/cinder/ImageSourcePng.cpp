@@ -24,6 +24,12 @@
 #include "cinder/Log.h"
 #include <png.h>
 
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
 using namespace std;
 
 namespace cinder {
@@ -37,13 +43,17 @@ extern "C" {
 
 static void ci_PNG_stream_reader( png_structp mPngPtr, png_bytep data, png_size_t length )
 {
+	// the exception has to be released before jumping out, so the jump happens after its handler
+	bool failed = false;
 	try {
 		((ci_png_info*)png_get_io_ptr(mPngPtr))->srcStreamRef->readData( data, (size_t)length );
 	}
 	catch( std::exception &exc ) {
 		CI_LOG_W( "failed to read png, what: " << exc.what() );
-		longjmp( png_jmpbuf(mPngPtr), 1 );
+		failed = true;
 	}
+	if( failed )
+		longjmp( png_jmpbuf(mPngPtr), 1 );
 }
 
 static void ci_png_warning( png_structp /*mPngPtr*/, png_const_charp /*message*/ )
@@ -61,6 +71,30 @@ static void ci_png_error( png_structp mPngPtr, png_const_charp message )
 
 } // extern "C"
 
+namespace {
+
+// separated from its callers because setjmp() can't share a frame with objects that have destructors
+bool readPngRows( png_structp pngPtr, uint8_t *data, size_t rowBytes, int32_t numRows )
+{
+	if( setjmp( png_jmpbuf(pngPtr) ) )
+		return false;
+
+	for( int32_t row = 0; row < numRows; ++row )
+		png_read_row( pngPtr, data + row * rowBytes, NULL );
+	return true;
+}
+
+bool readPngImage( png_structp pngPtr, png_bytepp rowPointers )
+{
+	if( setjmp( png_jmpbuf(pngPtr) ) )
+		return false;
+
+	png_read_image( pngPtr, rowPointers );
+	return true;
+}
+
+} // anonymous namespace
+
 ///////////////////////////////////////////////////////////////////////////////
 // Registrar
 void ImageSourcePng::registerSelf()
@@ -76,8 +110,8 @@ ImageSourcePngRef ImageSourcePng::createRef( DataSourceRef dataSourceRef, ImageS
 	return ImageSourcePngRef( new ImageSourcePng( dataSourceRef, options ) );
 }
 
-ImageSourcePng::ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Options /*options*/ )
-	: ImageSource(), mInfoPtr( 0 ), mPngPtr( 0 )
+ImageSourcePng::ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Options options )
+	: ImageSource(), mBandRows( 32 ), mInfoPtr( 0 ), mPngPtr( 0 )
 {
 	mPngPtr = png_create_read_struct( PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, NULL );
 	if( ! mPngPtr ) {
@@ -98,6 +132,10 @@ ImageSourcePng::ImageSourcePng( DataSourceRef dataSourceRef, ImageSource::Option
 	
 	if( ! loadHeader() )
 		throw ImageSourcePngException( "Could not load png header." );
+
+	// interlaced rows are only complete after the last pass, so those are left to loadImage() to crop
+	if( png_get_interlace_type( mPngPtr, mInfoPtr ) == PNG_INTERLACE_NONE )
+		setupRegion( options );
 }
 
 // part of this being separated allows for us to play nicely with the setjmp of libpng
@@ -152,6 +190,7 @@ bool ImageSourcePng::loadHeader()
 		png_set_expand_gray_1_2_4_to_8( mPngPtr );
 		png_set_palette_to_rgb( mPngPtr );
 		png_set_tRNS_to_alpha( mPngPtr );
+		png_set_interlace_handling( mPngPtr );
 		
 		png_read_update_info( mPngPtr, mInfoPtr );
 	}
@@ -167,25 +206,125 @@ ImageSourcePng::~ImageSourcePng()
 
 void ImageSourcePng::load( ImageTargetRef target )
 {
-	bool success = true;
-	if( setjmp( png_jmpbuf(mPngPtr) ) ) {
+	if( ! mPngPtr )
+		throw ImageSourcePngException( "Failure during load." );
+
+	// get a pointer to the ImageSource function appropriate for handling our data configuration
+	ImageSource::RowFunc func = setupRowFunc( target );
+	const size_t rowBytes = png_get_rowbytes( mPngPtr, mInfoPtr );
+	// rows below the region are never inflated
+	const int32_t numRows = isRegionApplied() ? getRegionArea().y2 : mHeight;
+
+	bool success;
+	if( png_get_interlace_type( mPngPtr, mInfoPtr ) != PNG_INTERLACE_NONE ) {
+		// every pass revisits every band, so interlaced images are decoded whole
+		unique_ptr<png_byte[]> rows( new png_byte[rowBytes * numRows] );
+		vector<png_bytep> rowPointers( numRows );
+		for( int32_t row = 0; row < numRows; ++row )
+			rowPointers[row] = rows.get() + row * rowBytes;
+		success = readPngImage( mPngPtr, rowPointers.data() );
+		for( int32_t row = 0; success && row < numRows; ++row )
+			processRow( func, target, row, rowPointers[row] );
+	}
+	else if( numRows > mBandRows )
+		success = loadPipelined( func, target, rowBytes, numRows );
+	else {
+		unique_ptr<png_byte[]> rows( new png_byte[rowBytes * numRows] );
+		success = readPngRows( mPngPtr, rows.get(), rowBytes, numRows );
+		for( int32_t row = 0; success && row < numRows; ++row )
+			processRow( func, target, row, rows.get() + row * rowBytes );
+	}
+
+	if( ! success ) {
 		png_destroy_read_struct( &mPngPtr, &mInfoPtr, (png_infopp)NULL );
 		mPngPtr = 0;
-		success = false;
+		throw ImageSourcePngException( "Failure during load." );
 	}
-	else {
-		// get a pointer to the ImageSource function appropriate for handling our data configuration
-		ImageSource::RowFunc func = setupRowFunc( target );
-		//int number_passes = png_set_interlace_handling( mPngPtr );
-		unique_ptr<png_byte[]> row_pointer( new png_byte[png_get_rowbytes( mPngPtr, mInfoPtr )] );
-		for( int32_t row = 0; row < mHeight; ++row ) {
-			png_read_row( mPngPtr, row_pointer.get(), NULL );
-			((*this).*func)( target, row, row_pointer.get() );
+}
+
+bool ImageSourcePng::loadPipelined( RowFunc func, const ImageTargetRef &target, size_t rowBytes, int32_t numRows )
+{
+	struct Band {
+		unique_ptr<png_byte[]>	data;
+		int32_t					firstRow, numRows;
+	};
+
+	// two bands: libpng fills one while the other is converted
+	Band bands[2];
+	deque<Band*> freeBands, fullBands;
+	for( Band &band : bands ) {
+		band.data.reset( new png_byte[rowBytes * mBandRows] );
+		freeBands.push_back( &band );
+	}
+	mutex bandMutex;
+	condition_variable bandCond;
+	bool decodeFailed = false, canceled = false;
+
+	thread decoder( [&] {
+		for( int32_t firstRow = 0; firstRow < numRows; firstRow += mBandRows ) {
+			Band *band;
+			{
+				unique_lock<mutex> lock( bandMutex );
+				bandCond.wait( lock, [&] { return canceled || ! freeBands.empty(); } );
+				if( canceled )
+					return;
+				band = freeBands.front();
+				freeBands.pop_front();
+			}
+
+			band->firstRow = firstRow;
+			band->numRows = std::min( mBandRows, numRows - firstRow );
+			bool success = readPngRows( mPngPtr, band->data.get(), rowBytes, band->numRows );
+			{
+				lock_guard<mutex> lock( bandMutex );
+				if( ! success ) {
+					decodeFailed = true;
+					band->numRows = 0;
+				}
+				fullBands.push_back( band );
+			}
+			bandCond.notify_all();
+			if( ! success )
+				return;
+		}
+	} );
+
+	try {
+		for( int32_t converted = 0; converted < numRows; ) {
+			Band *band;
+			{
+				unique_lock<mutex> lock( bandMutex );
+				bandCond.wait( lock, [&] { return ! fullBands.empty(); } );
+				band = fullBands.front();
+				fullBands.pop_front();
+			}
+			if( band->numRows == 0 )
+				break;
+
+			for( int32_t row = 0; row < band->numRows; ++row )
+				processRow( func, target, band->firstRow + row, band->data.get() + row * rowBytes );
+			converted += band->numRows;
+
+			{
+				lock_guard<mutex> lock( bandMutex );
+				freeBands.push_back( band );
+			}
+			bandCond.notify_all();
 		}
 	}
-	
-	if( ! success )
-		throw ImageSourcePngException( "Failure during load." );
+	catch( ... ) {
+		// the target failed; stop the decoder before its bands go out of scope
+		{
+			lock_guard<mutex> lock( bandMutex );
+			canceled = true;
+		}
+		bandCond.notify_all();
+		decoder.join();
+		throw;
+	}
+
+	decoder.join();
+	return ! decodeFailed;
 }
 
 } // namespace cinder
\ No newline at end of file
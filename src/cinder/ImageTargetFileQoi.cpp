@@ -22,22 +22,28 @@
 */
 
 #include "cinder/ImageTargetFileQoi.h"
+#include "cinder/ip/Parallel.h"
 #include "cinder/Log.h"
+#include "cinder/CinderAssert.h"
 
 // Note: QOI_IMPLEMENTATION is defined in ImageSourceFileQoi.cpp
 // to avoid multiple definition errors
 #define QOI_NO_STDIO
 #include "qoi/qoi.h"
 
+#include <algorithm>
 #include <cstdio>
 #include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <vector>
 
 namespace cinder {
 
 namespace {
 
-// Cross-platform wrapper for qoi_write that handles Unicode paths properly
-int qoiWritePath( const fs::path &path, const void *data, const qoi_desc *desc )
+// Cross-platform file write that handles Unicode paths properly
+bool qoiWriteFile( const fs::path &path, const void *encoded, size_t size )
 {
 #if defined( CINDER_MSW )
 	FILE *f = _wfopen( path.wstring().c_str(), L"wb" );
@@ -46,22 +52,128 @@ int qoiWritePath( const fs::path &path, const void *data, const qoi_desc *desc )
 #endif
 
 	if( ! f )
-		return 0;
-
-	int size;
-	void *encoded = qoi_encode( data, desc, &size );
-	if( ! encoded ) {
-		fclose( f );
-		return 0;
-	}
+		return false;
 
 	fwrite( encoded, 1, size, f );
 	fflush( f );
 	int err = ferror( f );
 	fclose( f );
 
+	return err == 0;
+}
+
+// Cross-platform wrapper for qoi_write that handles Unicode paths properly
+int qoiWritePath( const fs::path &path, const void *data, const qoi_desc *desc )
+{
+	int size;
+	void *encoded = qoi_encode( data, desc, &size );
+	if( ! encoded )
+		return 0;
+
+	bool written = qoiWriteFile( path, encoded, (size_t)size );
 	free( encoded );
-	return err ? 0 : size;
+	return written ? size : 0;
+}
+
+// qoi.h only defines its op codes alongside QOI_IMPLEMENTATION, which lives in ImageSourceFileQoi.cpp
+const uint8_t QOI_CHUNK_OP_INDEX	= 0x00;
+const uint8_t QOI_CHUNK_OP_DIFF		= 0x40;
+const uint8_t QOI_CHUNK_OP_LUMA		= 0x80;
+const uint8_t QOI_CHUNK_OP_RUN		= 0xc0;
+const uint8_t QOI_CHUNK_OP_RGB		= 0xfe;
+const uint8_t QOI_CHUNK_OP_RGBA		= 0xff;
+
+// writes \a v at \a out and returns the position after it
+uint8_t* writeBigEndian32( uint8_t *out, uint32_t v )
+{
+	out[0] = (uint8_t)( v >> 24 );
+	out[1] = (uint8_t)( v >> 16 );
+	out[2] = (uint8_t)( v >> 8 );
+	out[3] = (uint8_t)v;
+	return out + 4;
+}
+
+// copies \a size bytes to \a out and returns the position after them
+uint8_t* writeBytes( uint8_t *out, const uint8_t *data, size_t size )
+{
+	if( size > 0 )
+		memcpy( out, data, size );
+	return out + size;
+}
+
+/* Encodes \a numPixels pixels as standard QOI ops which decode identically whatever state a decoder starts in:
+	the first pixel is a literal, OP_INDEX only refers to slots written within the chunk, and a trailing run is flushed. */
+void encodeQoiChunk( const uint8_t *pixels, size_t numPixels, int channels, std::vector<uint8_t> *out )
+{
+	struct Pixel {
+		bool operator==( const Pixel &rhs ) const { return r == rhs.r && g == rhs.g && b == rhs.b && a == rhs.a; }
+		uint8_t r, g, b, a;
+	};
+
+	Pixel index[64] = {};
+	uint64_t written = 0;
+	Pixel prev = { 0, 0, 0, 255 };
+	int run = 0;
+
+	out->reserve( numPixels * channels / 2 );
+	for( size_t i = 0; i < numPixels; ++i, pixels += channels ) {
+		const Pixel px = { pixels[0], pixels[1], pixels[2], ( channels == 4 ) ? pixels[3] : (uint8_t)255 };
+
+		if( i > 0 && px == prev ) {
+			if( ++run == 62 || i == numPixels - 1 ) {
+				out->push_back( QOI_CHUNK_OP_RUN | ( run - 1 ) );
+				run = 0;
+			}
+		}
+		else {
+			if( run > 0 ) {
+				out->push_back( QOI_CHUNK_OP_RUN | ( run - 1 ) );
+				run = 0;
+			}
+
+			const int indexPos = ( px.r * 3 + px.g * 5 + px.b * 7 + px.a * 11 ) % 64;
+			if( ( written >> indexPos & 1 ) && index[indexPos] == px ) {
+				out->push_back( QOI_CHUNK_OP_INDEX | indexPos );
+			}
+			else {
+				index[indexPos] = px;
+				written |= uint64_t( 1 ) << indexPos;
+
+				if( i == 0 || px.a != prev.a ) {
+					// a 3 channel decoder's alpha is always 255, so only 4 channel chunks need an RGBA literal up front
+					const bool rgba = ( i == 0 ) ? ( channels == 4 ) : true;
+					out->push_back( rgba ? QOI_CHUNK_OP_RGBA : QOI_CHUNK_OP_RGB );
+					out->push_back( px.r );
+					out->push_back( px.g );
+					out->push_back( px.b );
+					if( rgba )
+						out->push_back( px.a );
+				}
+				else {
+					const int8_t vr = (int8_t)( px.r - prev.r );
+					const int8_t vg = (int8_t)( px.g - prev.g );
+					const int8_t vb = (int8_t)( px.b - prev.b );
+					const int8_t vgr = (int8_t)( vr - vg );
+					const int8_t vgb = (int8_t)( vb - vg );
+
+					if( vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2 ) {
+						out->push_back( QOI_CHUNK_OP_DIFF | ( vr + 2 ) << 4 | ( vg + 2 ) << 2 | ( vb + 2 ) );
+					}
+					else if( vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8 ) {
+						out->push_back( QOI_CHUNK_OP_LUMA | ( vg + 32 ) );
+						out->push_back( ( vgr + 8 ) << 4 | ( vgb + 8 ) );
+					}
+					else {
+						out->push_back( QOI_CHUNK_OP_RGB );
+						out->push_back( px.r );
+						out->push_back( px.g );
+						out->push_back( px.b );
+					}
+				}
+			}
+		}
+		prev = px;
+	}
 }
 
 } // anonymous namespace
@@ -85,7 +197,7 @@ ImageTargetRef ImageTargetFileQoi::create( DataTargetRef dataTarget, ImageSource
 }
 
 ImageTargetFileQoi::ImageTargetFileQoi( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string &extensionData )
-	: mDataTarget( dataTarget )
+	: mDataTarget( dataTarget ), mThreads( options.getThreads() )
 {
 	if( ! ( mDataTarget->providesFilePath() || mDataTarget->getStream() ) ) {
 		throw ImageIoExceptionFailedWrite( "No file path or stream provided" );
@@ -121,6 +233,17 @@ void* ImageTargetFileQoi::getRowPointer( int32_t row )
 
 void ImageTargetFileQoi::finalize()
 {
+	if( mThreads != 1 ) {
+		std::vector<uint8_t> encoded = encodeChunked();
+		if( ! mFilePath.empty() ) {
+			if( ! qoiWriteFile( mFilePath, encoded.data(), encoded.size() ) )
+				throw ImageIoExceptionFailedWrite( "Failed to write QOI image" );
+		}
+		else
+			mDataTarget->getStream()->writeData( encoded.data(), encoded.size() );
+		return;
+	}
+
 	qoi_desc desc;
 	desc.width = (unsigned int)mWidth;
 	desc.height = (unsigned int)mHeight;
@@ -147,4 +270,58 @@ void ImageTargetFileQoi::finalize()
 	}
 }
 
+std::vector<uint8_t> ImageTargetFileQoi::encodeChunked() const
+{
+	const int32_t rowsPerChunk = std::max<int32_t>( 8, ( mHeight + 63 ) / 64 );
+	const int32_t numChunks = ( mHeight + rowsPerChunk - 1 ) / rowsPerChunk;
+
+	std::vector<std::vector<uint8_t>> chunks( numChunks );
+	ip::parallelForRows( 0, numChunks, ip::Options().threads( mThreads ), [&]( int32_t chunkBegin, int32_t chunkEnd ) {
+		for( int32_t chunk = chunkBegin; chunk < chunkEnd; ++chunk ) {
+			const int32_t firstRow = chunk * rowsPerChunk, numRows = std::min( rowsPerChunk, mHeight - firstRow );
+			encodeQoiChunk( &mData.get()[firstRow * mRowBytes], (size_t)numRows * mWidth, mNumComponents, &chunks[chunk] );
+		}
+	} );
+
+	// header, end marker and chunk index, plus the chunks themselves
+	size_t encodedSize = 14 + 8 + (size_t)numChunks * 4 + 12;
+	for( const auto &chunk : chunks )
+		encodedSize += chunk.size();
+	// the chunk offsets are 32 bit and ImageSourceFileQoi addresses the stream with an int, as qoi.h does
+	if( encodedSize > (size_t)std::numeric_limits<int>::max() )
+		throw ImageIoExceptionFailedWrite( "QOI image too large to encode in chunks" );
+
+	std::vector<uint8_t> result( encodedSize );
+	uint8_t *out = result.data();
+
+	// the standard header, so that any QOI decoder reads the chunks as one stream
+	const uint8_t magic[4] = { 'q', 'o', 'i', 'f' };
+	out = writeBytes( out, magic, sizeof(magic) );
+	out = writeBigEndian32( out, (uint32_t)mWidth );
+	out = writeBigEndian32( out, (uint32_t)mHeight );
+	*out++ = (uint8_t)mNumComponents;
+	*out++ = QOI_SRGB;
+
+	std::vector<uint32_t> offsets;
+	offsets.reserve( numChunks );
+	for( const auto &chunk : chunks ) {
+		offsets.push_back( (uint32_t)( out - result.data() ) );
+		out = writeBytes( out, chunk.data(), chunk.size() );
+	}
+
+	const uint8_t padding[8] = { 0, 0, 0, 0, 0, 0, 0, 1 };
+	out = writeBytes( out, padding, sizeof(padding) );
+
+	// the chunk index follows the end marker, where decoders unaware of it never look
+	for( uint32_t offset : offsets )
+		out = writeBigEndian32( out, offset );
+	out = writeBigEndian32( out, (uint32_t)numChunks );
+	out = writeBigEndian32( out, (uint32_t)rowsPerChunk );
+	const uint8_t chunkedMagic[4] = { 'q', 'o', 'i', 'c' };
+	out = writeBytes( out, chunkedMagic, sizeof(chunkedMagic) );
+	CI_ASSERT( out == result.data() + result.size() );
+
+	return result;
+}
+
 } // namespace cinder
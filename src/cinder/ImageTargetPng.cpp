@@ -0,0 +1,199 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ImageTargetPng.h"
+#include "cinder/Stream.h"
+#include "cinder/Log.h"
+#include <png.h>
+
+using namespace std;
+
+namespace cinder {
+
+extern "C" {
+
+static void ci_png_stream_writer( png_structp pngPtr, png_bytep data, png_size_t length )
+{
+	// the exception has to be released before jumping out, so the jump happens after its handler
+	bool failed = false;
+	try {
+		((OStream*)png_get_io_ptr( pngPtr ))->writeData( data, (size_t)length );
+	}
+	catch( std::exception &exc ) {
+		CI_LOG_W( "failed to write png, what: " << exc.what() );
+		failed = true;
+	}
+	if( failed )
+		longjmp( png_jmpbuf(pngPtr), 1 );
+}
+
+static void ci_png_stream_flush( png_structp /*pngPtr*/ )
+{
+}
+
+} // extern "C"
+
+namespace {
+
+// these are separated from their callers because setjmp() can't share a frame with objects that have destructors
+bool writePngHeader( png_structp pngPtr, png_infop infoPtr, int32_t width, int32_t height, int bitDepth, int colorType )
+{
+	if( setjmp( png_jmpbuf(pngPtr) ) )
+		return false;
+
+	png_set_IHDR( pngPtr, infoPtr, (png_uint_32)width, (png_uint_32)height, bitDepth, colorType, PNG_INTERLACE_NONE, PNG_COMPRESSION_TYPE_DEFAULT, PNG_FILTER_TYPE_DEFAULT );
+	png_write_info( pngPtr, infoPtr );
+#ifdef CINDER_LITTLE_ENDIAN
+	if( bitDepth == 16 )
+		png_set_swap( pngPtr );
+#endif
+	return true;
+}
+
+bool writePngRow( png_structp pngPtr, const uint8_t *row )
+{
+	if( setjmp( png_jmpbuf(pngPtr) ) )
+		return false;
+
+	png_write_row( pngPtr, (png_const_bytep)row );
+	return true;
+}
+
+bool writePngEnd( png_structp pngPtr, png_infop infoPtr )
+{
+	if( setjmp( png_jmpbuf(pngPtr) ) )
+		return false;
+
+	png_write_end( pngPtr, infoPtr );
+	return true;
+}
+
+} // anonymous namespace
+
+///////////////////////////////////////////////////////////////////////////////
+// Registrar
+void ImageTargetPng::registerSelf()
+{
+	static bool alreadyRegistered = false;
+	const int32_t PRIORITY = 1;
+
+	if( alreadyRegistered )
+		return;
+	alreadyRegistered = true;
+
+	ImageIoRegistrar::TargetCreationFunc func = ImageTargetPng::create;
+	ImageIoRegistrar::registerTargetType( "png", func, PRIORITY, "png" );
+}
+
+///////////////////////////////////////////////////////////////////////////////
+// ImageTargetPng
+ImageTargetRef ImageTargetPng::create( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options, const std::string & /*extensionData*/ )
+{
+	return ImageTargetRef( new ImageTargetPng( dataTarget, imageSource, options ) );
+}
+
+ImageTargetPng::ImageTargetPng( DataTargetRef dataTarget, ImageSourceRef imageSource, ImageTarget::Options options )
+	: mPngPtr( 0 ), mInfoPtr( 0 ), mPendingRow( -1 ), mNextRow( 0 )
+{
+	mStream = dataTarget->getStream();
+	if( ! mStream )
+		throw ImageIoExceptionFailedWrite( "No file path or stream provided" );
+
+	setSize( imageSource->getWidth(), imageSource->getHeight() );
+	setDataType( ( imageSource->getDataType() == ImageIo::UINT8 ) ? ImageIo::UINT8 : ImageIo::UINT16 );
+
+	int colorType;
+	ImageIo::ColorModel cm = options.isColorModelDefault() ? imageSource->getColorModel() : options.getColorModel();
+	switch( cm ) {
+		case ImageIo::CM_RGB:
+			setColorModel( ImageIo::CM_RGB );
+			setChannelOrder( imageSource->hasAlpha() ? ImageIo::RGBA : ImageIo::RGB );
+			colorType = imageSource->hasAlpha() ? PNG_COLOR_TYPE_RGB_ALPHA : PNG_COLOR_TYPE_RGB;
+		break;
+		case ImageIo::CM_GRAY:
+			setColorModel( ImageIo::CM_GRAY );
+			setChannelOrder( imageSource->hasAlpha() ? ImageIo::YA : ImageIo::Y );
+			colorType = imageSource->hasAlpha() ? PNG_COLOR_TYPE_GRAY_ALPHA : PNG_COLOR_TYPE_GRAY;
+		break;
+		default:
+			throw ImageIoExceptionIllegalColorModel( "PNG only supports RGB and gray color models" );
+	}
+
+	mPngPtr = png_create_write_struct( PNG_LIBPNG_VER_STRING, (png_voidp)NULL, NULL, NULL );
+	if( ! mPngPtr )
+		throw ImageTargetPngException( "Could not create png struct." );
+	mInfoPtr = png_create_info_struct( mPngPtr );
+	if( ! mInfoPtr ) {
+		png_destroy_write_struct( &mPngPtr, (png_infopp)NULL );
+		throw ImageTargetPngException( "Could not create png info struct." );
+	}
+
+	png_set_write_fn( mPngPtr, reinterpret_cast<void*>( mStream.get() ), ci_png_stream_writer, ci_png_stream_flush );
+	if( ! writePngHeader( mPngPtr, mInfoPtr, mWidth, mHeight, ( getDataType() == ImageIo::UINT8 ) ? 8 : 16, colorType ) ) {
+		png_destroy_write_struct( &mPngPtr, &mInfoPtr );
+		throw ImageTargetPngException( "Could not write png header." );
+	}
+
+	mRow.reset( new uint8_t[(size_t)mWidth * channelOrderNumChannels( getChannelOrder() ) * dataTypeBytes( getDataType() )] );
+}
+
+ImageTargetPng::~ImageTargetPng()
+{
+	if( mPngPtr )
+		png_destroy_write_struct( &mPngPtr, &mInfoPtr );
+}
+
+void* ImageTargetPng::getRowPointer( int32_t row )
+{
+	// a row is complete once the next one is requested, and libpng needs them in order
+	if( row != mPendingRow ) {
+		writePendingRow();
+		if( row != mNextRow )
+			throw ImageTargetPngException( "PNG rows must be written in order." );
+		mPendingRow = row;
+	}
+
+	return mRow.get();
+}
+
+void ImageTargetPng::finalize()
+{
+	writePendingRow();
+	if( mNextRow != mHeight )
+		throw ImageTargetPngException( "Not all png rows were written." );
+	if( ! writePngEnd( mPngPtr, mInfoPtr ) )
+		throw ImageTargetPngException( "Failure during write." );
+}
+
+void ImageTargetPng::writePendingRow()
+{
+	if( mPendingRow < 0 )
+		return;
+
+	if( ! writePngRow( mPngPtr, mRow.get() ) )
+		throw ImageTargetPngException( "Failure during write." );
+	mPendingRow = -1;
+	++mNextRow;
+}
+
+} // namespace cinder
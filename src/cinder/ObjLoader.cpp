@@ -24,36 +24,49 @@
 */
 
 #include "cinder/ObjLoader.h"
+#include "cinder/Log.h"
+#include "cinder/Utilities.h"
+#include "cinder/ip/Parallel.h"
 
+#include <charconv>
+#include <cstring>
+#include <locale>
 #include <sstream>
 using namespace std;
 
-// For stoi
-#if defined( CINDER_ANDROID )
-	#include "cinder/android/CinderAndroid.h"
-#endif
-
 namespace cinder {
 
 ObjLoader::ObjLoader( shared_ptr<IStreamCinder> stream, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( stream ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mStream( stream ), mOptimizeVertices( optimize ), mOutputCached( false ), mGroupIndex( numeric_limits<size_t>::max() ), mLoadedFromCache( false )
 {
 	parse( includeNormals, includeTexCoords );
 }
 
 ObjLoader::ObjLoader( DataSourceRef dataSource, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( dataSource->createStream() ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mStream( dataSource->createStream() ), mOptimizeVertices( optimize ), mOutputCached( false ), mGroupIndex( numeric_limits<size_t>::max() ), mLoadedFromCache( false )
 {
 	parse( includeNormals, includeTexCoords );
 }
 
 ObjLoader::ObjLoader( DataSourceRef dataSource, DataSourceRef materialSource, bool includeNormals, bool includeTexCoords, bool optimize )
-	: mStream( dataSource->createStream() ), mOutputCached( false ), mOptimizeVertices( optimize ), mGroupIndex( numeric_limits<size_t>::max() )
+	: mStream( dataSource->createStream() ), mOptimizeVertices( optimize ), mOutputCached( false ), mGroupIndex( numeric_limits<size_t>::max() ), mLoadedFromCache( false )
 {
 	parseMaterial( materialSource->createStream() );
 	parse( includeNormals, includeTexCoords );
 }
 
+ObjLoader::ObjLoader( DataSourceRef dataSource, const Options &options )
+	: mOptimizeVertices( options.getOptimize() ), mOutputCached( false ), mGroupIndex( numeric_limits<size_t>::max() ), mLoadedFromCache( false )
+{
+	loadSource( dataSource, nullptr, options );
+}
+
+ObjLoader::ObjLoader( DataSourceRef dataSource, DataSourceRef materialSource, const Options &options )
+	: mOptimizeVertices( options.getOptimize() ), mOutputCached( false ), mGroupIndex( numeric_limits<size_t>::max() ), mLoadedFromCache( false )
+{
+	loadSource( dataSource, materialSource, options );
+}
+
 ObjLoader& ObjLoader::groupIndex( size_t groupIndex )
 {
 	if ( groupIndex < mGroups.size() ) {
@@ -143,38 +156,400 @@ geom::AttribSet	ObjLoader::getAvailableAttribs() const
 	return result;
 }
 
+namespace {
+
+// reads the next line, joining lines which end in a backslash into \a joined
+bool readJoinedLine( IStreamCinder *stream, std::string_view *line, std::string *joined )
+{
+	if( ! stream->readLine( line ) )
+		return false;
+
+	if( ! line->empty() && line->back() == '\\' ) {
+		joined->assign( *line );
+		std::string_view next;
+		while( ! joined->empty() && joined->back() == '\\' && stream->readLine( &next ) ) {
+			joined->pop_back();
+			joined->append( next );
+		}
+		*line = *joined;
+	}
+
+	return true;
+}
+
+// parses a float from [\a first, \a last), leaving \a result as it is if there is none. Unlike strtof(), both paths ignore the C locale, which may use a decimal comma.
+void parseFloat( const char *first, const char *last, float *result )
+{
+#if defined( __cpp_lib_to_chars )
+	if( *first == '+' ) // unlike strtof(), from_chars() rejects an explicit plus sign
+		++first;
+	from_chars( first, last, *result );
+#else
+	// older libc++ (notably Apple's) lacks from_chars() for floating point
+	thread_local std::istringstream stream = [] { std::istringstream result; result.imbue( std::locale::classic() ); return result; }();
+	stream.clear();
+	stream.str( string( first, last ) );
+	float value;
+	if( stream >> value )
+		*result = value;
+#endif
+}
+
+// parses up to \a count whitespace separated floats from \a str; values which are missing are left as they are
+void parseFloats( std::string_view str, float *result, int count )
+{
+	for( int i = 0; i < count; ++i ) {
+		std::string_view token = nextToken( &str );
+		if( token.empty() )
+			return;
+		parseFloat( token.data(), token.data() + token.size(), &result[i] );
+	}
+}
+
+// parses a face index, throwing like stoi() when there is none
+int parseIndex( std::string_view str )
+{
+	int result = 0;
+	auto parsed = from_chars( str.data(), str.data() + str.size(), result );
+	if( parsed.ec != errc() )
+		throw invalid_argument( "ObjLoader: invalid face index \"" + string( str ) + "\"" );
+	return result;
+}
+
+// Flags returned by parseFaceIndices(), which record how the face updates the mHasTexCoords and mHasNormals of its group
+enum : uint8_t {
+	FACE_LAST_TEX_COORD		= 1,	// the last vertex has a tex coord index
+	FACE_EMPTY_TEX_COORD	= 2,	// some vertex has an empty tex coord index, as in "1//1"
+	FACE_LAST_NORMAL		= 4,	// the last vertex has a normal index
+	FACE_ANY_NORMAL			= 8,	// some vertex has a normal index
+	FACE_INHERITS_MATERIAL	= 16	// used by ParsedChunk for faces preceding the chunk's first "usemtl"
+};
+
+// parses the "v/vt/vn" triples of a face line following its "f" into \a face. Relative (negative) indices are left for resolveRelativeIndices().
+uint8_t parseFaceIndices( std::string_view s, bool includeNormals, bool includeTexCoords, ObjLoader::Face *face )
+{
+	uint8_t flags = 0;
+	face->mNumVertices = 0;
+
+	size_t offset = 0;
+	size_t length = s.length();
+	while( offset < length ) {
+		while( offset < length && ( s[offset] == ' ' || s[offset] == '\t' ) )
+			++offset;
+		if( offset == length ) // trailing spaces
+			break;
+
+		// find the end of this triple "v/vt/vn"
+		size_t endOfTriple = s.find_first_of( " \t", offset );
+		if( endOfTriple == std::string_view::npos ) endOfTriple = length;
+		size_t firstSlashOffset = s.find( '/', offset ), secondSlashOffset = std::string_view::npos;
+		if( firstSlashOffset > endOfTriple )
+			firstSlashOffset = std::string_view::npos;
+		if( firstSlashOffset != std::string_view::npos ) {
+			secondSlashOffset = s.find( '/', firstSlashOffset + 1 );
+			if( secondSlashOffset > endOfTriple ) secondSlashOffset = std::string_view::npos;
+		}
+
+		// process the vertex index
+		int vertexIndex = parseIndex( s.substr( offset, std::min( firstSlashOffset, endOfTriple ) - offset ) );
+		face->mVertexIndices.push_back( vertexIndex < 0 ? vertexIndex : vertexIndex - 1 );
+
+		// process the tex coord index
+		bool hasTexCoord = false;
+		if( includeTexCoords && ( firstSlashOffset != std::string_view::npos ) ) {
+			size_t numSize = ( secondSlashOffset == std::string_view::npos ) ? ( endOfTriple - firstSlashOffset - 1 ) : secondSlashOffset - firstSlashOffset - 1;
+			if( numSize > 0 ) {
+				int texCoordIndex = parseIndex( s.substr( firstSlashOffset + 1, numSize ) );
+				face->mTexCoordIndices.push_back( texCoordIndex < 0 ? texCoordIndex : texCoordIndex - 1 );
+				hasTexCoord = true;
+			}
+			else
+				flags |= FACE_EMPTY_TEX_COORD;
+		}
+
+		// process the normal index
+		bool hasNormal = false;
+		if( includeNormals && ( secondSlashOffset != std::string_view::npos ) ) {
+			int normalIndex = parseIndex( s.substr( secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ) );
+			face->mNormalIndices.push_back( normalIndex < 0 ? normalIndex : normalIndex - 1 );
+			hasNormal = true;
+		}
+
+		flags &= ~( FACE_LAST_TEX_COORD | FACE_LAST_NORMAL );
+		flags |= ( hasTexCoord ? FACE_LAST_TEX_COORD : 0 ) | ( hasNormal ? FACE_LAST_NORMAL | FACE_ANY_NORMAL : 0 );
+
+		offset = endOfTriple + 1;
+		face->mNumVertices++;
+	}
+
+	return flags;
+}
+
+// resolves the relative indices of \a face, which count back from the offsets at the start of \a group
+void resolveRelativeIndices( const ObjLoader::Group &group, ObjLoader::Face *face )
+{
+	for( int32_t &index : face->mVertexIndices )
+		if( index < 0 ) index += group.mBaseVertexOffset;
+	for( int32_t &index : face->mTexCoordIndices )
+		if( index < 0 ) index += group.mBaseTexCoordOffset;
+	for( int32_t &index : face->mNormalIndices )
+		if( index < 0 ) index += group.mBaseNormalOffset;
+}
+
+// the first face of a group decides whether it has tex coords and normals; later faces can only clear the former or set the latter
+void applyFaceFlags( uint8_t flags, int numVertices, ObjLoader::Group *group )
+{
+	if( numVertices == 0 )
+		return;
+
+	if( group->mFaces.empty() ) {
+		group->mHasTexCoords = ( flags & FACE_LAST_TEX_COORD ) != 0;
+		group->mHasNormals = ( flags & FACE_LAST_NORMAL ) != 0;
+	}
+	else {
+		if( flags & FACE_EMPTY_TEX_COORD )
+			group->mHasTexCoords = false;
+		if( flags & FACE_ANY_NORMAL )
+			group->mHasNormals = true;
+	}
+}
+
+// returns the line at \a *pos, which ends at a LF, CR or CRLF, and advances \a *pos past its ending
+std::string_view nextLine( const char **pos, const char *end )
+{
+	const char *begin = *pos, *lineEnd = *pos;
+	while( lineEnd < end && *lineEnd != '\n' && *lineEnd != '\r' )
+		++lineEnd;
+
+	*pos = lineEnd;
+	if( *pos < end && *(*pos)++ == '\r' && *pos < end && **pos == '\n' )
+		++*pos;
+
+	return std::string_view( begin, lineEnd - begin );
+}
+
+// returns the start of the first line after \a pos which doesn't continue the line before it, or \a end
+const char* findChunkStart( const char *begin, const char *pos, const char *end )
+{
+	while( pos < end ) {
+		const char *newline = static_cast<const char*>( memchr( pos, '\n', end - pos ) );
+		if( ! newline )
+			return end;
+
+		const char *lineEnd = ( newline > begin && newline[-1] == '\r' ) ? newline - 1 : newline;
+		if( lineEnd == begin || lineEnd[-1] != '\\' )
+			return newline + 1;
+		pos = newline + 1;
+	}
+
+	return end;
+}
+
+// The faces of a chunk between "g" lines, which are appended to the current group when mStartsGroup is false
+struct ParsedSegment {
+	bool							mStartsGroup = false;
+	std::string						mName;
+	int32_t							mVertexOffset = 0, mTexCoordOffset = 0, mNormalOffset = 0; // the chunk's counts at the "g" line
+	std::vector<ObjLoader::Face>	mFaces;
+	std::vector<uint8_t>			mFaceFlags;
+};
+
+// The result of parsing part of a file, with indices and offsets relative to the chunk
+struct ParsedChunk {
+	std::vector<vec3>			mVertices, mNormals;
+	std::vector<vec2>			mTexCoords;
+	std::vector<ParsedSegment>	mSegments;
+	bool						mMaterialChanged = false;
+	const ObjLoader::Material*	mMaterial = nullptr;
+};
+
+void parseChunk( const char *pos, const char *end, bool includeNormals, bool includeTexCoords, const std::map<std::string, ObjLoader::Material> &materials, ParsedChunk *chunk )
+{
+	chunk->mSegments.emplace_back();
+	ParsedSegment *segment = &chunk->mSegments.back();
+
+	string joined;
+	while( pos < end ) {
+		std::string_view line = nextLine( &pos, end );
+		if( ! line.empty() && line.back() == '\\' ) {
+			joined.assign( line );
+			while( ! joined.empty() && joined.back() == '\\' && pos < end ) {
+				joined.pop_back();
+				joined.append( nextLine( &pos, end ) );
+			}
+			line = joined;
+		}
+
+		if( line.empty() || line[0] == '#' )
+			continue;
+
+		std::string_view rest = line;
+		std::string_view tag = nextToken( &rest );
+		if( tag == "v" ) {
+			vec3 v;
+			parseFloats( rest, &v.x, 3 );
+			chunk->mVertices.push_back( v );
+		}
+		else if( tag == "vt" ) {
+			if( includeTexCoords ) {
+				vec2 tex;
+				parseFloats( rest, &tex.x, 2 );
+				chunk->mTexCoords.push_back( tex );
+			}
+		}
+		else if( tag == "vn" ) {
+			if( includeNormals ) {
+				vec3 v;
+				parseFloats( rest, &v.x, 3 );
+				chunk->mNormals.push_back( normalize( v ) );
+			}
+		}
+		else if( tag == "f" ) {
+			segment->mFaces.emplace_back();
+			ObjLoader::Face &face = segment->mFaces.back();
+			uint8_t flags = parseFaceIndices( rest, includeNormals, includeTexCoords, &face );
+			face.mMaterial = chunk->mMaterial;
+			if( ! chunk->mMaterialChanged )
+				flags |= FACE_INHERITS_MATERIAL;
+			segment->mFaceFlags.push_back( flags );
+		}
+		else if( tag == "g" ) {
+			chunk->mSegments.emplace_back();
+			segment = &chunk->mSegments.back();
+			segment->mStartsGroup = true;
+			segment->mName = string( line.substr( line.find( ' ' ) + 1 ) );
+			segment->mVertexOffset = (int32_t)chunk->mVertices.size();
+			segment->mTexCoordOffset = (int32_t)chunk->mTexCoords.size();
+			segment->mNormalOffset = (int32_t)chunk->mNormals.size();
+		}
+		else if( tag == "usemtl" ) {
+			auto m = materials.find( string( nextToken( &rest ) ) );
+			if( m != materials.end() ) {
+				chunk->mMaterial = &m->second;
+				chunk->mMaterialChanged = true;
+			}
+		}
+	}
+}
+
+// 64-bit FNV-1a, consuming eight bytes per step
+uint64_t hashBytes( const void *data, size_t size, uint64_t hash )
+{
+	const uint64_t prime = 0x100000001b3ULL;
+	const uint8_t *bytes = static_cast<const uint8_t*>( data );
+	size_t i = 0;
+	for( ; i + 8 <= size; i += 8 ) {
+		uint64_t word;
+		memcpy( &word, bytes + i, 8 );
+		hash = ( hash ^ word ) * prime;
+		hash ^= hash >> 29;
+	}
+	for( ; i < size; ++i )
+		hash = ( hash ^ bytes[i] ) * prime;
+
+	return hash;
+}
+
+// The header of an ObjLoader cache file, which is followed by its output arrays, its internal arrays, and then its materials and
+// groups, all in the native byte order. The groups let groupIndex() and groupName() select from a cached mesh as from a parsed one.
+struct CacheHeader {
+	char		mMagic[4];
+	uint32_t	mVersion;
+	uint64_t	mHash;
+	uint64_t	mNumVertices, mNumNormals, mNumTexCoords, mNumColors, mNumIndices;
+	uint64_t	mNumInternalVertices, mNumInternalNormals, mNumInternalTexCoords;
+	uint64_t	mNumMaterials, mNumGroups;
+};
+
+const char		sCacheMagic[4] = { 'C', 'O', 'B', 'J' };
+const uint32_t	sCacheVersion = 2;
+
+// Reads a cache file front to back, failing rather than reading past its end
+class CacheReader {
+  public:
+	CacheReader( const void *data, size_t size ) : mData( static_cast<const uint8_t*>( data ) ), mEnd( mData + size ) {}
+
+	bool	read( void *dst, size_t bytes )
+	{
+		if( (size_t)( mEnd - mData ) < bytes )
+			return false;
+		memcpy( dst, mData, bytes );
+		mData += bytes;
+		return true;
+	}
+
+	template<typename T>
+	bool	read( T *value )	{ return read( value, sizeof( T ) ); }
+
+	template<typename T>
+	bool	readArray( std::vector<T> *values, uint64_t count )
+	{
+		if( count > (uint64_t)( mEnd - mData ) / sizeof( T ) )
+			return false;
+		values->resize( (size_t)count );
+		return read( values->data(), values->size() * sizeof( T ) );
+	}
+
+	bool	readString( string *value )
+	{
+		uint32_t size;
+		if( ! read( &size ) || size > (size_t)( mEnd - mData ) )
+			return false;
+		value->assign( reinterpret_cast<const char*>( mData ), size );
+		mData += size;
+		return true;
+	}
+
+	bool	isAtEnd() const	{ return mData == mEnd; }
+
+  private:
+	const uint8_t	*mData, *mEnd;
+};
+
+template<typename T>
+void writeCacheArray( OStream *stream, const std::vector<T> &values )
+{
+	stream->writeData( values.data(), values.size() * sizeof( T ) );
+}
+
+void writeCacheString( OStream *stream, const string &value )
+{
+	const uint32_t size = (uint32_t)value.size();
+	stream->writeData( &size, sizeof( size ) );
+	stream->writeData( value.data(), value.size() );
+}
+// files are parsed in chunks of at least this many bytes, so that small files don't pay for threads
+const size_t	sMinChunkBytes = 256 * 1024;
+
+} // anonymous namespace
+
 void ObjLoader::parseMaterial( std::shared_ptr<IStreamCinder> material )
 {
     Material m;
     m.Ka[0] = m.Ka[1] = m.Ka[2] = 1.0f;
     m.Kd[0] = m.Kd[1] = m.Kd[2] = 1.0f;
 
-    while( ! material->isEof() ) {
-        string line = material->readLine();
+	std::string_view line;
+	string joined;
+    while( readJoinedLine( material.get(), &line, &joined ) ) {
         if( line.empty() || line[0] == '#' )
             continue;
 
-		while( line.back() == '\\' && ! material->isEof() ) {
-			auto next = material->readLine();
-			line = line.substr( 0, line.size() - 1 ) + next;
-		}
-
-        string tag;
-        stringstream ss( line );
-        ss >> tag;
+        std::string_view rest = line;
+        std::string_view tag = nextToken( &rest );
         if( tag == "newmtl" ) {
             if( m.mName.length() > 0 )
                 mMaterials[m.mName] = m;
 
-            ss >> m.mName;
+            m.mName = string( nextToken( &rest ) );
             m.Ka[0] = m.Ka[1] = m.Ka[2] = 1.0f;
             m.Kd[0] = m.Kd[1] = m.Kd[2] = 1.0f;
         }
         else if( tag == "Ka" ) {
-            ss >> m.Ka[0] >> m.Ka[1] >> m.Ka[2];
+            parseFloats( rest, m.Ka, 3 );
         }
         else if( tag == "Kd" ) {
-            ss >> m.Kd[0] >> m.Kd[1] >> m.Kd[2];
+            parseFloats( rest, m.Kd, 3 );
         }
     }
     if( m.mName.length() > 0 )
@@ -190,41 +565,36 @@ void ObjLoader::parse( bool includeNormals, bool includeTexCoords )
 
     const Material *currentMaterial = 0;
 
-	size_t lineNumber = 0;
-	while( ! mStream->isEof() ) {
-		lineNumber++;
-		string line = mStream->readLine(), tag;
+	// lines are views into the stream's buffer, so that nothing is allocated per line
+	std::string_view line;
+	string joined;
+	while( readJoinedLine( mStream.get(), &line, &joined ) ) {
         if( line.empty() || line[0] == '#' )
             continue;
 
-		while( line.back() == '\\' && ! mStream->isEof() ) {
-			auto next = mStream->readLine();
-			line = line.substr( 0, line.size() - 1 ) + next;
-		}
-
-		stringstream ss( line );
-		ss >> tag;
+		std::string_view rest = line;
+		std::string_view tag = nextToken( &rest );
 		if( tag == "v" ) { // vertex
 			vec3 v;
-			ss >> v.x >> v.y >> v.z;
+			parseFloats( rest, &v.x, 3 );
 			mInternalVertices.push_back( v );
 		}
 		else if( tag == "vt" ) { // vertex texture coordinates
 			if( includeTexCoords ) {
 				vec2 tex;
-				ss >> tex.x >> tex.y;
+				parseFloats( rest, &tex.x, 2 );
 				mInternalTexCoords.push_back( tex );
 			}
 		}
 		else if( tag == "vn" ) { // vertex normals
 			if ( includeNormals ) {
 				vec3 v;
-				ss >> v.x >> v.y >> v.z;
+				parseFloats( rest, &v.x, 3 );
 				mInternalNormals.push_back( normalize( v ) );
 			}
 		}
 		else if( tag == "f" ) { // face
-			parseFace( currentGroup, currentMaterial, line, includeNormals, includeTexCoords );
+			parseFace( currentGroup, currentMaterial, rest, includeNormals, includeTexCoords );
 		}
 		else if( tag == "g" ) { // group
 			if( ! currentGroup->mFaces.empty() )
@@ -233,12 +603,10 @@ void ObjLoader::parse( bool includeNormals, bool includeTexCoords )
 			currentGroup->mBaseVertexOffset = (int32_t)mInternalVertices.size();
 			currentGroup->mBaseTexCoordOffset = (int32_t)mInternalTexCoords.size();
 			currentGroup->mBaseNormalOffset = (int32_t)mInternalNormals.size();
-			currentGroup->mName = line.substr( line.find( ' ' ) + 1 );
+			currentGroup->mName = string( line.substr( line.find( ' ' ) + 1 ) );
 		}
         else if( tag == "usemtl") { // material
-            string tag;
-            ss >> tag;
-            std::map<std::string, Material>::const_iterator m = mMaterials.find(tag);
+            std::map<std::string, Material>::const_iterator m = mMaterials.find( string( nextToken( &rest ) ) );
             if( m != mMaterials.end() ) {
                 currentMaterial = &m->second;
             }
@@ -246,76 +614,276 @@ void ObjLoader::parse( bool includeNormals, bool includeTexCoords )
 	}
 }
 
-void ObjLoader::parseFace( Group *group, const Material *material, const std::string &s, bool includeNormals, bool includeTexCoords )
+void ObjLoader::parseFace( Group *group, const Material *material, std::string_view s, bool includeNormals, bool includeTexCoords )
 {
 	ObjLoader::Face result;
-	result.mNumVertices = 0;
-    result.mMaterial = material;
+	result.mMaterial = material;
+	uint8_t flags = parseFaceIndices( s, includeNormals, includeTexCoords, &result );
+	resolveRelativeIndices( *group, &result );
+	applyFaceFlags( flags, result.mNumVertices, group );
 
-	size_t offset = 2; // account for "f "
-	size_t length = s.length();
-	while( offset < length ) {
-		size_t endOfTriple, firstSlashOffset, secondSlashOffset;
+	group->mFaces.push_back( std::move( result ) );
+}
 
-		while( s[offset] == ' ' )
-			++offset;
+void ObjLoader::loadSource( const DataSourceRef &dataSource, const DataSourceRef &materialSource, const Options &options )
+{
+	std::shared_ptr<const Buffer> buffer = loadBufferMapped( dataSource );
+	std::shared_ptr<const Buffer> materialBuffer = materialSource ? loadBufferMapped( materialSource ) : nullptr;
+
+	uint64_t hash = 0;
+	if( ! options.getCacheFile().empty() ) {
+		// the options which change the output are part of the hash, the number of threads isn't
+		hash = 0xcbf29ce484222325ULL ^ ( options.getNormals() ? 1 : 0 ) ^ ( options.getTexCoords() ? 2 : 0 ) ^ ( options.getOptimize() ? 4 : 0 );
+		hash = hashBytes( buffer->getData(), buffer->getSize(), hash ^ buffer->getSize() );
+		if( materialBuffer )
+			hash = hashBytes( materialBuffer->getData(), materialBuffer->getSize(), hash ^ materialBuffer->getSize() );
+		if( readCache( options.getCacheFile(), hash ) ) {
+			mLoadedFromCache = true;
+			return;
+		}
+	}
 
-		// find the end of this triple "v/vt/vn"
-		endOfTriple = s.find( ' ', offset );
-		if( endOfTriple == string::npos ) endOfTriple = length;
-		firstSlashOffset = s.find( '/', offset );
-		if( firstSlashOffset != string::npos ) {
-			secondSlashOffset = s.find( '/', firstSlashOffset + 1 );
-			if( secondSlashOffset > endOfTriple ) secondSlashOffset = string::npos;
+	if( materialBuffer )
+		parseMaterial( IStreamMem::create( materialBuffer->getData(), materialBuffer->getSize() ) );
+	parse( *buffer, options );
+
+	if( ! options.getCacheFile().empty() ) {
+		load();
+		writeCache( options.getCacheFile(), hash );
+	}
+}
+
+void ObjLoader::parse( const Buffer &buffer, const Options &options )
+{
+	const char *data = static_cast<const char*>( buffer.getData() );
+	const char *dataEnd = data + buffer.getSize();
+
+	// split the file into a chunk per thread, at line boundaries which aren't line continuations
+	const int32_t maxChunks = (int32_t)std::min<size_t>( buffer.getSize() / sMinChunkBytes + 1, numeric_limits<int32_t>::max() );
+	const int numChunks = ip::Options().threads( options.getThreads() ).getNumThreadsForRows( maxChunks );
+	vector<const char*> chunkStarts( numChunks + 1 );
+	chunkStarts[0] = data;
+	chunkStarts[numChunks] = dataEnd;
+	for( int c = 1; c < numChunks; ++c )
+		chunkStarts[c] = findChunkStart( data, std::max( chunkStarts[c - 1], data + buffer.getSize() / numChunks * c ), dataEnd );
+
+	vector<ParsedChunk> chunks( numChunks );
+	ip::parallelForRows( 0, numChunks, ip::Options().threads( numChunks ), [&]( int32_t chunkBegin, int32_t chunkEnd ) {
+		for( int32_t c = chunkBegin; c < chunkEnd; ++c )
+			parseChunk( chunkStarts[c], chunkStarts[c + 1], options.getNormals(), options.getTexCoords(), mMaterials, &chunks[c] );
+	} );
+
+	// merge the chunks in order, exactly as parse( bool, bool ) builds its groups from consecutive lines
+	size_t numVertices = 0, numTexCoords = 0, numNormals = 0;
+	for( const ParsedChunk &chunk : chunks ) {
+		numVertices += chunk.mVertices.size();
+		numTexCoords += chunk.mTexCoords.size();
+		numNormals += chunk.mNormals.size();
+	}
+	mInternalVertices.reserve( numVertices );
+	mInternalTexCoords.reserve( numTexCoords );
+	mInternalNormals.reserve( numNormals );
+
+	mGroups.push_back( Group() );
+	const Material *currentMaterial = nullptr;
+	for( ParsedChunk &chunk : chunks ) {
+		const int32_t vertexOffset = (int32_t)mInternalVertices.size();
+		const int32_t texCoordOffset = (int32_t)mInternalTexCoords.size();
+		const int32_t normalOffset = (int32_t)mInternalNormals.size();
+		mInternalVertices.insert( mInternalVertices.end(), chunk.mVertices.begin(), chunk.mVertices.end() );
+		mInternalTexCoords.insert( mInternalTexCoords.end(), chunk.mTexCoords.begin(), chunk.mTexCoords.end() );
+		mInternalNormals.insert( mInternalNormals.end(), chunk.mNormals.begin(), chunk.mNormals.end() );
+
+		for( ParsedSegment &segment : chunk.mSegments ) {
+			if( segment.mStartsGroup ) {
+				if( ! mGroups.back().mFaces.empty() )
+					mGroups.push_back( Group() );
+				Group &group = mGroups.back();
+				group.mBaseVertexOffset = vertexOffset + segment.mVertexOffset;
+				group.mBaseTexCoordOffset = texCoordOffset + segment.mTexCoordOffset;
+				group.mBaseNormalOffset = normalOffset + segment.mNormalOffset;
+				group.mName = std::move( segment.mName );
+			}
+
+			Group &group = mGroups.back();
+			group.mFaces.reserve( group.mFaces.size() + segment.mFaces.size() );
+			for( size_t f = 0; f < segment.mFaces.size(); ++f ) {
+				Face &face = segment.mFaces[f];
+				if( segment.mFaceFlags[f] & FACE_INHERITS_MATERIAL )
+					face.mMaterial = currentMaterial;
+				resolveRelativeIndices( group, &face );
+				applyFaceFlags( segment.mFaceFlags[f], face.mNumVertices, &group );
+				group.mFaces.push_back( std::move( face ) );
+			}
 		}
-		else
-			secondSlashOffset = string::npos;
 
-		// process the vertex index
-		int vertexIndex = (firstSlashOffset != string::npos) ?
-            stoi( s.substr( offset, firstSlashOffset - offset ) ) :
-            stoi( s.substr( offset, endOfTriple - offset));
+		if( chunk.mMaterialChanged )
+			currentMaterial = chunk.mMaterial;
+	}
+}
+
+bool ObjLoader::readCache( const fs::path &path, uint64_t hash )
+{
+	if( ! fs::exists( path ) )
+		return false;
 
-		if( vertexIndex < 0 )
-			result.mVertexIndices.push_back( group->mBaseVertexOffset + vertexIndex );
-		else
-			result.mVertexIndices.push_back( vertexIndex - 1 );
+	std::shared_ptr<const Buffer> buffer;
+	try {
+		buffer = MappedFile::create( path, MappedFile::ACCESS_SEQUENTIAL )->createBuffer();
+	}
+	catch( const StreamExc & ) {
+		return false;
+	}
 
-		// process the tex coord index
-		if( includeTexCoords && ( firstSlashOffset != string::npos ) ) {
-			size_t numSize = ( secondSlashOffset == string::npos ) ? ( endOfTriple - firstSlashOffset - 1 ) : secondSlashOffset - firstSlashOffset - 1;
-			if( numSize > 0 ) {
-				int texCoordIndex = stoi( s.substr( firstSlashOffset + 1, numSize ) );
-				if( texCoordIndex < 0 )
-					result.mTexCoordIndices.push_back( group->mBaseTexCoordOffset + texCoordIndex );
-				else
-					result.mTexCoordIndices.push_back( texCoordIndex - 1 );
-				if( group->mFaces.empty() )
-					group->mHasTexCoords = true;
+	CacheReader reader( buffer->getData(), buffer->getSize() );
+	CacheHeader header;
+	if( ! reader.read( &header ) )
+		return false;
+	if( memcmp( header.mMagic, sCacheMagic, sizeof( sCacheMagic ) ) != 0 || header.mVersion != sCacheVersion || header.mHash != hash )
+		return false;
+
+	bool valid = reader.readArray( &mOutputVertices, header.mNumVertices ) && reader.readArray( &mOutputNormals, header.mNumNormals )
+				&& reader.readArray( &mOutputTexCoords, header.mNumTexCoords ) && reader.readArray( &mOutputColors, header.mNumColors )
+				&& reader.readArray( &mOutputIndices, header.mNumIndices ) && reader.readArray( &mInternalVertices, header.mNumInternalVertices )
+				&& reader.readArray( &mInternalNormals, header.mNumInternalNormals ) && reader.readArray( &mInternalTexCoords, header.mNumInternalTexCoords );
+
+	// faces refer to their materials by index in the order written, or -1 for none
+	vector<const Material*> materials;
+	for( uint64_t m = 0; valid && m < header.mNumMaterials; ++m ) {
+		Material material;
+		valid = reader.readString( &material.mName ) && reader.read( material.Ka, sizeof( material.Ka ) ) && reader.read( material.Kd, sizeof( material.Kd ) );
+		if( valid )
+			materials.push_back( &( mMaterials[material.mName] = material ) );
+	}
+
+	for( uint64_t g = 0; valid && g < header.mNumGroups; ++g ) {
+		Group group;
+		uint8_t hasTexCoords = 0, hasNormals = 0;
+		uint64_t numFaces = 0;
+		valid = reader.readString( &group.mName ) && reader.read( &group.mBaseVertexOffset ) && reader.read( &group.mBaseTexCoordOffset )
+				&& reader.read( &group.mBaseNormalOffset ) && reader.read( &hasTexCoords ) && reader.read( &hasNormals ) && reader.read( &numFaces );
+		group.mHasTexCoords = hasTexCoords != 0;
+		group.mHasNormals = hasNormals != 0;
+		for( uint64_t f = 0; valid && f < numFaces; ++f ) {
+			Face face;
+			int32_t materialIndex;
+			uint32_t numVertexIndices, numTexCoordIndices, numNormalIndices;
+			valid = reader.read( &face.mNumVertices ) && reader.read( &materialIndex ) && materialIndex >= -1 && materialIndex < (int32_t)materials.size()
+					&& reader.read( &numVertexIndices ) && reader.read( &numTexCoordIndices ) && reader.read( &numNormalIndices )
+					&& reader.readArray( &face.mVertexIndices, numVertexIndices ) && reader.readArray( &face.mTexCoordIndices, numTexCoordIndices )
+					&& reader.readArray( &face.mNormalIndices, numNormalIndices );
+			if( valid ) {
+				face.mMaterial = ( materialIndex >= 0 ) ? materials[materialIndex] : nullptr;
+				group.mFaces.push_back( std::move( face ) );
 			}
-			else
-				group->mHasTexCoords = false;
 		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no tex coords
-			group->mHasTexCoords = false;
+		if( valid )
+			mGroups.push_back( std::move( group ) );
+	}
 
-		// process the normal index
-		if( includeNormals && ( secondSlashOffset != string::npos ) ) {
-			int normalIndex = stoi( s.substr( secondSlashOffset + 1, endOfTriple - secondSlashOffset - 1 ) );
-			if( normalIndex < 0 )
-				result.mNormalIndices.push_back( group->mBaseNormalOffset + normalIndex );
-			else
-				result.mNormalIndices.push_back( normalIndex - 1 );
-			group->mHasNormals = true;
+	if( ! valid || ! reader.isAtEnd() ) {
+		// a truncated or corrupt cache is parsed afresh, so leave nothing of it behind
+		mOutputVertices.clear();
+		mOutputNormals.clear();
+		mOutputTexCoords.clear();
+		mOutputColors.clear();
+		mOutputIndices.clear();
+		mInternalVertices.clear();
+		mInternalNormals.clear();
+		mInternalTexCoords.clear();
+		mMaterials.clear();
+		mGroups.clear();
+		return false;
+	}
+
+	mOutputCached = true;
+	return true;
+}
+
+void ObjLoader::writeCache( const fs::path &path, uint64_t hash ) const
+{
+	// the cache only saves time on the next load, so failing to write it doesn't fail this one
+	bool opened = false, written = false;
+	try {
+		OStreamFileRef stream = writeFileStream( path );
+		opened = stream != nullptr;
+		if( opened ) {
+			writeCache( stream.get(), hash );
+			// a full disk may only show once the buffered data is flushed
+			written = fflush( stream->getFILE() ) == 0;
 		}
-		else if( group->mFaces.empty() ) // if this is the first face, let's note that this group has no normals
-			group->mHasNormals = false;
+	}
+	catch( const std::exception & ) {
+	}
 
-		offset = endOfTriple + 1;
-		result.mNumVertices++;
+	if( ! written ) {
+		CI_LOG_W( "Failed to write OBJ cache file " << path );
+		// a partial cache would be rejected by readCache() anyway, but needn't linger
+		if( opened ) {
+			std::error_code ec;
+			fs::remove( path, ec );
+		}
+	}
+}
+
+void ObjLoader::writeCache( OStream *stream, uint64_t hash ) const
+{
+	CacheHeader header;
+	memcpy( header.mMagic, sCacheMagic, sizeof( sCacheMagic ) );
+	header.mVersion = sCacheVersion;
+	header.mHash = hash;
+	header.mNumVertices = mOutputVertices.size();
+	header.mNumNormals = mOutputNormals.size();
+	header.mNumTexCoords = mOutputTexCoords.size();
+	header.mNumColors = mOutputColors.size();
+	header.mNumIndices = mOutputIndices.size();
+	header.mNumInternalVertices = mInternalVertices.size();
+	header.mNumInternalNormals = mInternalNormals.size();
+	header.mNumInternalTexCoords = mInternalTexCoords.size();
+	header.mNumMaterials = mMaterials.size();
+	header.mNumGroups = mGroups.size();
+
+	stream->writeData( &header, sizeof( header ) );
+	writeCacheArray( stream, mOutputVertices );
+	writeCacheArray( stream, mOutputNormals );
+	writeCacheArray( stream, mOutputTexCoords );
+	writeCacheArray( stream, mOutputColors );
+	writeCacheArray( stream, mOutputIndices );
+	writeCacheArray( stream, mInternalVertices );
+	writeCacheArray( stream, mInternalNormals );
+	writeCacheArray( stream, mInternalTexCoords );
+
+	map<const Material*, int32_t> materialIndices;
+	for( const auto &material : mMaterials ) {
+		const int32_t materialIndex = (int32_t)materialIndices.size();
+		materialIndices[&material.second] = materialIndex;
+		writeCacheString( stream, material.second.mName );
+		stream->writeData( material.second.Ka, sizeof( material.second.Ka ) );
+		stream->writeData( material.second.Kd, sizeof( material.second.Kd ) );
 	}
 
-	group->mFaces.push_back( result );
+	for( const Group &group : mGroups ) {
+		const uint8_t hasTexCoords = group.mHasTexCoords ? 1 : 0, hasNormals = group.mHasNormals ? 1 : 0;
+		const uint64_t numFaces = group.mFaces.size();
+		writeCacheString( stream, group.mName );
+		stream->writeData( &group.mBaseVertexOffset, sizeof( group.mBaseVertexOffset ) );
+		stream->writeData( &group.mBaseTexCoordOffset, sizeof( group.mBaseTexCoordOffset ) );
+		stream->writeData( &group.mBaseNormalOffset, sizeof( group.mBaseNormalOffset ) );
+		stream->writeData( &hasTexCoords, sizeof( hasTexCoords ) );
+		stream->writeData( &hasNormals, sizeof( hasNormals ) );
+		stream->writeData( &numFaces, sizeof( numFaces ) );
+		for( const Face &face : group.mFaces ) {
+			auto materialIt = materialIndices.find( face.mMaterial );
+			const int32_t materialIndex = ( materialIt != materialIndices.end() ) ? materialIt->second : -1;
+			const uint32_t numIndices[3] = { (uint32_t)face.mVertexIndices.size(), (uint32_t)face.mTexCoordIndices.size(), (uint32_t)face.mNormalIndices.size() };
+			stream->writeData( &face.mNumVertices, sizeof( face.mNumVertices ) );
+			stream->writeData( &materialIndex, sizeof( materialIndex ) );
+			stream->writeData( numIndices, sizeof( numIndices ) );
+			writeCacheArray( stream, face.mVertexIndices );
+			writeCacheArray( stream, face.mTexCoordIndices );
+			writeCacheArray( stream, face.mNormalIndices );
+		}
+	}
 }
 
 void ObjLoader::load() const
@@ -361,44 +929,44 @@ void ObjLoader::load() const
 
 	if( normals && texCoords ) {
 		if( hasGroupIndex ) {
-			map<VertexTriple,int> uniqueVerts;
+			unordered_map<VertexTriple,int,VertexHash> uniqueVerts;
 			loadGroupNormalsTextures( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexTriple,int> uniqueVerts;
+			unordered_map<VertexTriple,int,VertexHash> uniqueVerts;
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupNormalsTextures( *groupIt, uniqueVerts );
 		}
 	}
 	else if( normals ) {
 		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
+			unordered_map<VertexPair,int,VertexHash> uniqueVerts;
 			loadGroupNormals( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexPair,int> uniqueVerts;
+			unordered_map<VertexPair,int,VertexHash> uniqueVerts;
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupNormals( *groupIt, uniqueVerts );
 		}
 	}
 	else if( texCoords ) {
 		if( hasGroupIndex ) {
-			map<VertexPair,int> uniqueVerts;
+			unordered_map<VertexPair,int,VertexHash> uniqueVerts;
 			loadGroupTextures( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<VertexPair,int> uniqueVerts;
+			unordered_map<VertexPair,int,VertexHash> uniqueVerts;
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroupTextures( *groupIt, uniqueVerts );
 		}
 	}
 	else {
 		if( hasGroupIndex ) {
-			map<int,int> uniqueVerts;
+			unordered_map<int,int,VertexHash> uniqueVerts;
 			loadGroup( mGroups[mGroupIndex], uniqueVerts );
 		}
 		else {
-			map<int,int> uniqueVerts;
+			unordered_map<int,int,VertexHash> uniqueVerts;
 			for( vector<Group>::const_iterator groupIt = mGroups.begin(); groupIt != mGroups.end(); ++groupIt )
 				loadGroup( *groupIt, uniqueVerts );
 		}
@@ -407,7 +975,7 @@ void ObjLoader::load() const
 	mOutputCached = true;
 }
 
-void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,int> &uniqueVerts ) const
+void ObjLoader::loadGroupNormalsTextures( const Group &group, unordered_map<VertexTriple,int,VertexHash> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -442,7 +1010,7 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
 				VertexTriple vTriple = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexTriple,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vTriple, mOutputVertices.size() ) );
+				auto result = uniqueVerts.insert( make_pair( vTriple, mOutputVertices.size() ) );
 				if( result.second ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
@@ -477,7 +1045,7 @@ void ObjLoader::loadGroupNormalsTextures( const Group &group, map<VertexTriple,i
 	}
 }
 
-void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqueVerts ) const
+void ObjLoader::loadGroupNormals( const Group &group, unordered_map<VertexPair,int,VertexHash> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -509,7 +1077,7 @@ void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqu
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
 				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mNormalIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
+				auto result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
 				if( result.second ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputNormals.push_back( mInternalNormals[group.mFaces[f].mNormalIndices[v]] );
@@ -539,7 +1107,7 @@ void ObjLoader::loadGroupNormals( const Group &group, map<VertexPair,int> &uniqu
 	}
 }
 
-void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniqueVerts ) const
+void ObjLoader::loadGroupTextures( const Group &group, unordered_map<VertexPair,int,VertexHash> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -566,7 +1134,7 @@ void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniq
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
 			if( ! forceUnique ) {
 				VertexPair vPair = make_tuple( group.mFaces[f].mVertexIndices[v], group.mFaces[f].mTexCoordIndices[v] );
-				pair<map<VertexPair,int>::iterator,bool> result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
+				auto result = uniqueVerts.insert( make_pair( vPair, mOutputVertices.size() ) );
 				if( result.second ) { // we've got a new, unique vertex here, so let's append it
 					mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
 					mOutputTexCoords.push_back( mInternalTexCoords[group.mFaces[f].mTexCoordIndices[v]] );
@@ -596,7 +1164,7 @@ void ObjLoader::loadGroupTextures( const Group &group, map<VertexPair,int> &uniq
 	}
 }
 
-void ObjLoader::loadGroup( const Group &group, map<int,int> &uniqueVerts ) const
+void ObjLoader::loadGroup( const Group &group, unordered_map<int,int,VertexHash> &uniqueVerts ) const
 {
     bool hasColors = mMaterials.size() > 0;
 	for( size_t f = 0; f < group.mFaces.size(); ++f ) {
@@ -617,7 +1185,7 @@ void ObjLoader::loadGroup( const Group &group, map<int,int> &uniqueVerts ) const
 		vector<int> faceIndices;
 		faceIndices.reserve( group.mFaces[f].mNumVertices );
 		for( int v = 0; v < group.mFaces[f].mNumVertices; ++v ) {
-			pair<map<int,int>::iterator,bool> result = uniqueVerts.insert( make_pair( group.mFaces[f].mVertexIndices[v], mOutputVertices.size() ) );
+			auto result = uniqueVerts.insert( make_pair( group.mFaces[f].mVertexIndices[v], mOutputVertices.size() ) );
 			if( result.second ) { // we've got a new, unique vertex here, so let's append it
 				mOutputVertices.push_back( mInternalVertices[group.mFaces[f].mVertexIndices[v]] );
                 if( hasColors )
@@ -676,6 +1244,7 @@ void ObjWriteTarget::writeData( const std::string &typeSpecifier, uint8_t dims,
 	for( size_t v = 0; v < count; ++v ) {
 		const float *data = (const float*)(((const uint8_t*)srcData) + v * strideBytes);
 		ostringstream os;
+		os.imbue( std::locale::classic() ); // OBJ numbers use '.' whatever the global locale
 		os << typeSpecifier << " ";
 		for( uint8_t d = 0; d < dims; ++d ) {
 			os << data[d];
@@ -726,6 +1295,7 @@ void ObjWriteTarget::copyIndices( geom::Primitive /*primitive*/, const uint32_t
 {
 	for( size_t i = 0; i < numIndices; i += 3 ) {
 		ostringstream os;
+		os.imbue( std::locale::classic() ); // no digit grouping
 		os << "f ";
 		if( mHasNormals && mHasTexCoords ) {
 			os << source[i+0]+1 << "/" << source[i+0]+1 << "/" << source[i+0]+1 << " ";
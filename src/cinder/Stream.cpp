@@ -28,6 +28,14 @@
 
 #include <stdio.h>
 #include <limits>
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <fcntl.h>
+	#include <unistd.h>
+#endif
 #include <iostream>
 #include <string>
 #include <cstring>
@@ -121,23 +129,80 @@ void IStreamCinder::readFixedString( std::string *t, size_t size )
 
 std::string IStreamCinder::readLine()
 {
-	string result;
+	std::string_view line;
+	readLine( &line );
+	return string( line );
+}
+
+bool IStreamCinder::readLine( std::string_view *line )
+{
+	mLineBuffer.clear();
+	bool spansRefills = false;
+	while( true ) {
+		std::string_view available = peekBuffered();
+		if( available.empty() ) {
+			if( ! spansRefills && ! isEof() ) { // a stream without a buffer of its own
+				readLineUnbuffered( &mLineBuffer );
+				*line = mLineBuffer;
+				return true;
+			}
+			// the last line has no ending
+			*line = mLineBuffer;
+			return spansRefills;
+		}
+
+		const size_t end = available.find_first_of( "\r\n" );
+		if( end == std::string_view::npos ) {
+			// the line continues past the buffer, whose next refill would overwrite it
+			mLineBuffer.append( available );
+			skipBuffered( available.size() );
+			spansRefills = true;
+			continue;
+		}
+
+		const bool carriageReturn = available[end] == '\r';
+		if( spansRefills ) {
+			mLineBuffer.append( available.substr( 0, end ) );
+			*line = mLineBuffer;
+		}
+		else
+			*line = available.substr( 0, end );
+
+		if( carriageReturn && end + 1 == available.size() ) {
+			// the LF of a CRLF may only arrive with the next refill
+			if( ! spansRefills ) {
+				mLineBuffer.assign( *line );
+				*line = mLineBuffer;
+			}
+			skipBuffered( end + 1 );
+			std::string_view next = peekBuffered();
+			if( ! next.empty() && next[0] == '\n' )
+				skipBuffered( 1 );
+		}
+		else
+			skipBuffered( ( carriageReturn && available[end + 1] == '\n' ) ? end + 2 : end + 1 );
+		return true;
+	}
+}
+
+void IStreamCinder::readLineUnbuffered( std::string *result )
+{
 	int8_t ch;
 	while( ! isEof() ) {
 		read( &ch );
 		if( ch == 0x0A )
 			break;
 		else if( ch == 0x0D ) {
+			if( isEof() )
+				break;
 			read( &ch );
 			if( ch != 0x0A )
 				seekRelative( -1 );
 			break;
 		}
 		else
-			result += ch;
+			*result += ch;
 	}
-
-	return result;
 }
 
 void IStreamCinder::readData( void *t, size_t size )
@@ -213,6 +278,23 @@ size_t IStreamFile::readDataImpl( void *t, size_t size )
 	}
 }
 
+std::string_view IStreamFile::peekBuffered()
+{
+	if( ( mBufferOffset < mBufferFileOffset ) || ( mBufferOffset >= mBufferFileOffset + (off_t)mBufferSize ) ) {
+		fseek( mFile, static_cast<long>( mBufferOffset ), SEEK_SET );
+		mBufferFileOffset = mBufferOffset;
+		mBufferSize = fread( mBuffer.get(), 1, mDefaultBufferSize, mFile );
+	}
+
+	const size_t offset = static_cast<size_t>( mBufferOffset - mBufferFileOffset );
+	return std::string_view( reinterpret_cast<const char*>( mBuffer.get() ) + offset, mBufferSize - offset );
+}
+
+void IStreamFile::skipBuffered( size_t size )
+{
+	mBufferOffset += static_cast<off_t>( size );
+}
+
 void IStreamFile::seekAbsolute( off_t absoluteOffset )
 {
 	int dir = ( absoluteOffset >= 0 ) ? SEEK_SET : SEEK_END;
@@ -612,6 +694,131 @@ void IStreamMem::IORead( void *t, size_t size )
 	mOffset += size;
 }
 
+std::string_view IStreamMem::peekBuffered()
+{
+	if( mOffset >= mDataSize )
+		return std::string_view();
+
+	return std::string_view( reinterpret_cast<const char*>( mData ) + mOffset, mDataSize - mOffset );
+}
+
+void IStreamMem::skipBuffered( size_t size )
+{
+	mOffset += size;
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// MappedFile
+MappedFileRef MappedFile::create( const fs::path &path, Access access )
+{
+	return MappedFileRef( new MappedFile( path, access ) );
+}
+
+MappedFile::MappedFile( const fs::path &path, Access access )
+	: mData( nullptr ), mSize( 0 ), mFilePath( path ), mAccess( access )
+{
+#if defined( CINDER_MSW )
+	mFileHandle = mMappingHandle = nullptr;
+	HANDLE file = ::CreateFileW( path.wstring().c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING,
+		( access == ACCESS_SEQUENTIAL ) ? FILE_FLAG_SEQUENTIAL_SCAN : ( ( access == ACCESS_RANDOM ) ? FILE_FLAG_RANDOM_ACCESS : FILE_ATTRIBUTE_NORMAL ), NULL );
+	if( file == INVALID_HANDLE_VALUE )
+		throw StreamExc( "(MappedFile) couldn't open: " + path.string() );
+	mFileHandle = file;
+
+	LARGE_INTEGER size;
+	if( ! ::GetFileSizeEx( file, &size ) ) {
+		::CloseHandle( file );
+		throw StreamExc( "(MappedFile) couldn't determine the size of: " + path.string() );
+	}
+	mSize = static_cast<size_t>( size.QuadPart );
+	if( mSize == 0 ) // empty files can't be mapped
+		return;
+
+	mMappingHandle = ::CreateFileMappingW( file, NULL, PAGE_READONLY, 0, 0, NULL );
+	if( mMappingHandle )
+		mData = static_cast<const uint8_t*>( ::MapViewOfFile( mMappingHandle, FILE_MAP_READ, 0, 0, 0 ) );
+	if( ! mData ) {
+		if( mMappingHandle )
+			::CloseHandle( mMappingHandle );
+		::CloseHandle( file );
+		throw StreamExc( "(MappedFile) couldn't map: " + path.string() );
+	}
+#else
+	int fd = ::open( path.string().c_str(), O_RDONLY );
+	if( fd < 0 )
+		throw StreamExc( "(MappedFile) couldn't open: " + path.string() );
+
+	struct stat info;
+	if( ::fstat( fd, &info ) != 0 ) {
+		::close( fd );
+		throw StreamExc( "(MappedFile) couldn't determine the size of: " + path.string() );
+	}
+	mSize = static_cast<size_t>( info.st_size );
+	if( mSize > 0 ) { // empty files can't be mapped
+		void *data = ::mmap( nullptr, mSize, PROT_READ, MAP_PRIVATE, fd, 0 );
+		if( data == MAP_FAILED ) {
+			::close( fd );
+			throw StreamExc( "(MappedFile) couldn't map: " + path.string() );
+		}
+		mData = static_cast<const uint8_t*>( data );
+	}
+	// the mapping outlives the descriptor
+	::close( fd );
+	setAccess( access );
+#endif
+}
+
+MappedFile::~MappedFile()
+{
+#if defined( CINDER_MSW )
+	if( mData )
+		::UnmapViewOfFile( mData );
+	if( mMappingHandle )
+		::CloseHandle( mMappingHandle );
+	if( mFileHandle )
+		::CloseHandle( mFileHandle );
+#else
+	if( mData )
+		::munmap( const_cast<uint8_t*>( mData ), mSize );
+#endif
+}
+
+void MappedFile::setAccess( Access access )
+{
+	mAccess = access;
+#if ! defined( CINDER_MSW )
+	if( mData ) {
+		int advice = ( access == ACCESS_SEQUENTIAL ) ? MADV_SEQUENTIAL : ( ( access == ACCESS_RANDOM ) ? MADV_RANDOM : MADV_NORMAL );
+		::madvise( const_cast<uint8_t*>( mData ), mSize, advice );
+	}
+#endif
+}
+
+std::shared_ptr<const Buffer> MappedFile::createBuffer() const
+{
+	// the deleter holds a reference to the mapping, which keeps it alive for as long as the Buffer
+	std::shared_ptr<const MappedFile> mapping = shared_from_this();
+	return std::shared_ptr<const Buffer>( new Buffer( const_cast<uint8_t*>( mData ), mSize ), [mapping]( const Buffer *buffer ) { delete buffer; } );
+}
+
+////////////////////////////////////////////////////////////////////////////////////////
+// IStreamMapped
+IStreamMappedRef IStreamMapped::create( const fs::path &path, MappedFile::Access access )
+{
+	return create( MappedFile::create( path, access ) );
+}
+
+IStreamMappedRef IStreamMapped::create( const MappedFileRef &mappedFile )
+{
+	return IStreamMappedRef( new IStreamMapped( mappedFile ) );
+}
+
+IStreamMapped::IStreamMapped( const MappedFileRef &mappedFile )
+	: IStreamMem( mappedFile->getData(), mappedFile->getSize() ), mMappedFile( mappedFile )
+{
+	setFileName( mappedFile->getFilePath() );
+}
+
 ////////////////////////////////////////////////////////////////////////////////////////
 // OStreamMem
 OStreamMem::OStreamMem( size_t bufferSizeHint )
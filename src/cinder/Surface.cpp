@@ -28,6 +28,9 @@
 #include "cinder/ImageIo.h"
 #include "cinder/ip/Fill.h"
 
+#include <algorithm>
+#include <cstring>
+#include <new>
 #include <type_traits>
 
 namespace cinder {
@@ -66,6 +69,9 @@ class ImageSourceSurface : public ImageSource {
 		else if( std::is_same<T,float>::value ) {
 			setDataType( ImageIo::FLOAT32 );
 		}
+		else if( std::is_same<T,half_float>::value ) {
+			setDataType( ImageIo::FLOAT16 );
+		}
 		else
 			throw; // this surface seems to be a type we've never met
 		mRowBytes = surface.getRowBytes();
@@ -190,13 +196,13 @@ void SurfaceT<T>::setChannelOrder( const SurfaceChannelOrder &aChannelOrder )
 
 template<typename T>
 SurfaceT<T>::SurfaceT()
-	: mWidth( 0 ), mHeight( 0 ), mChannelOrder( SurfaceChannelOrder::UNSPECIFIED ), mRowBytes( 0 ), mData( nullptr ), mPremultiplied( false )
+	: mWidth( 0 ), mHeight( 0 ), mChannelOrder( SurfaceChannelOrder::UNSPECIFIED ), mRowBytes( 0 ), mData( nullptr ), mPremultiplied( false ), mShareToken( ShareToken::create() )
 {
 }
 
 template<typename T>
 SurfaceT<T>::SurfaceT( const SurfaceT<T> &rhs )
-	: mWidth( rhs.mWidth ), mHeight( rhs.mHeight ), mChannelOrder( rhs.mChannelOrder ), mRowBytes( rhs.mRowBytes ), mPremultiplied( rhs.mPremultiplied )
+	: mWidth( rhs.mWidth ), mHeight( rhs.mHeight ), mChannelOrder( rhs.mChannelOrder ), mRowBytes( rhs.mRowBytes ), mPremultiplied( rhs.mPremultiplied ), mShareToken( ShareToken::create() )
 {
 	mDataStore = std::shared_ptr<T>( new T[mHeight * mRowBytes], std::default_delete<T[]>() );
 	mData = mDataStore.get();
@@ -205,18 +211,19 @@ SurfaceT<T>::SurfaceT( const SurfaceT<T> &rhs )
 }
 
 template<typename T>
-SurfaceT<T>::SurfaceT( SurfaceT<T> &&rhs )
+SurfaceT<T>::SurfaceT( SurfaceT<T> &&rhs ) noexcept
 	: mWidth( rhs.mWidth ), mHeight( rhs.mHeight ), mChannelOrder( rhs.mChannelOrder ), mRowBytes( rhs.mRowBytes ), mPremultiplied( rhs.mPremultiplied )
 {
-	mDataStore = rhs.mDataStore;
-	rhs.mDataStore = nullptr;
-	mData = mDataStore.get();
+	mDataStore = std::move( rhs.mDataStore );
+	mShareToken = std::move( rhs.mShareToken );
+	mData = rhs.mData;
+	rhs.mData = nullptr;
 	initChannels();
 }
 
 template<typename T>
 SurfaceT<T>::SurfaceT( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder )
-	: mWidth( width ), mHeight( height ), mChannelOrder( channelOrder )
+	: mWidth( width ), mHeight( height ), mShareToken( ShareToken::create() ), mChannelOrder( channelOrder )
 {
 	if( mChannelOrder == SurfaceChannelOrder::UNSPECIFIED )
 		mChannelOrder = ( alpha ) ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB;
@@ -229,7 +236,7 @@ SurfaceT<T>::SurfaceT( int32_t width, int32_t height, bool alpha, SurfaceChannel
 
 template<typename T>
 SurfaceT<T>::SurfaceT( int32_t width, int32_t height, bool alpha, const SurfaceConstraints &constraints )
-	: mWidth( width ), mHeight( height )
+	: mWidth( width ), mHeight( height ), mShareToken( ShareToken::create() )
 {
 	mChannelOrder = constraints.getChannelOrder( alpha );
 	mPremultiplied = false;
@@ -241,7 +248,15 @@ SurfaceT<T>::SurfaceT( int32_t width, int32_t height, bool alpha, const SurfaceC
 
 template<typename T>
 SurfaceT<T>::SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder )
-	: mData( data ), mWidth( width ), mHeight( height ), mRowBytes( rowBytes ), mChannelOrder( channelOrder )
+	: mData( data ), mWidth( width ), mHeight( height ), mRowBytes( rowBytes ), mShareToken( ShareToken::create() ), mChannelOrder( channelOrder )
+{
+	mPremultiplied = false;
+	initChannels();
+}
+
+template<typename T>
+SurfaceT<T>::SurfaceT( T *data, int32_t width, int32_t height, ptrdiff_t rowBytes, SurfaceChannelOrder channelOrder, const std::shared_ptr<T> &dataStore )
+	: mWidth( width ), mHeight( height ), mRowBytes( rowBytes ), mData( data ), mDataStore( dataStore ), mShareToken( ShareToken::create() ), mChannelOrder( channelOrder )
 {
 	mPremultiplied = false;
 	initChannels();
@@ -268,6 +283,7 @@ SurfaceT<T>& SurfaceT<T>::operator=( const SurfaceT<T> &rhs )
 	mRowBytes = rhs.mRowBytes;
 	mPremultiplied = rhs.mPremultiplied;
 	mDataStore = std::shared_ptr<T>( new T[mHeight * mRowBytes], std::default_delete<T[]>() );
+	mShareToken = ShareToken::create();
 	
 	mData = mDataStore.get();
 	initChannels();
@@ -278,14 +294,15 @@ SurfaceT<T>& SurfaceT<T>::operator=( const SurfaceT<T> &rhs )
 }
 
 template<typename T>
-SurfaceT<T>& SurfaceT<T>::operator=( SurfaceT<T> &&rhs )
+SurfaceT<T>& SurfaceT<T>::operator=( SurfaceT<T> &&rhs ) noexcept
 {
 	mWidth = rhs.mWidth;
 	mHeight = rhs.mHeight;
 	mChannelOrder = rhs.mChannelOrder;
 	mRowBytes = rhs.mRowBytes;
 	mPremultiplied = rhs.mPremultiplied;
-	mDataStore = rhs.mDataStore;	
+	mDataStore = std::move( rhs.mDataStore );
+	mShareToken = std::move( rhs.mShareToken );
 	mData = rhs.mData;
 	rhs.mDataStore = nullptr;
 	rhs.mData = nullptr;
@@ -304,6 +321,7 @@ SurfaceT<T>::operator ImageSourceRef() const
 template<typename T>
 SurfaceT<T>::operator ImageTargetRef()
 {
+	detach();
 	return ImageTargetSurface<T>::createRef( this );
 }
 
@@ -327,6 +345,67 @@ SurfaceT<T> SurfaceT<T>::clone( const Area &area, bool copyPixels ) const
 	return result;
 }
 
+template<typename T>
+SurfaceT<T> SurfaceT<T>::getView( const Area &area )
+{
+	// a writable alias must not leak writes into Surfaces sharing our pixels copy-on-write
+	detach();
+	SurfaceT result = alias( area );
+	result.mShareToken = mShareToken.view();
+	return result;
+}
+
+template<typename T>
+SurfaceT<T> SurfaceT<T>::share() const
+{
+	return share( getBounds() );
+}
+
+template<typename T>
+SurfaceT<T> SurfaceT<T>::share( const Area &area ) const
+{
+	// views write without detaching, so sharing pixels they alias would leak their writes into the result
+	if( mShareToken.hasViews() )
+		return clone( area.getClipBy( getBounds() ) );
+
+	SurfaceT result = alias( area );
+	result.mShareToken = mShareToken.share();
+	return result;
+}
+
+template<typename T>
+SurfaceT<T> SurfaceT<T>::alias( const Area &area ) const
+{
+	const Area clipped = area.getClipBy( getBounds() );
+	SurfaceT result( const_cast<T*>( getData( clipped.getUL() ) ), clipped.getWidth(), clipped.getHeight(), mRowBytes, mChannelOrder );
+	result.mPremultiplied = mPremultiplied;
+	result.mDataStore = mDataStore;
+	result.initChannels();
+	return result;
+}
+
+template<typename T>
+void SurfaceT<T>::detach()
+{
+	if( ! mShareToken.isShared() )
+		return;
+
+	// keep the alignment of the data and its rows up to a cache line, which SIMD paths and SurfacePool reuse rely on
+	const uintptr_t addressBits = reinterpret_cast<uintptr_t>( mData ) | static_cast<uintptr_t>( mRowBytes );
+	const size_t alignment = std::min<size_t>( 64, std::max<size_t>( alignof(T), addressBits & ( ~addressBits + 1 ) ) );
+	// a shared area may be a narrow strip of a much wider parent, so the copy gets packed rows, rounded up to the alignment, rather than the parent's stride
+	const size_t lineBytes = mWidth * getPixelBytes();
+	const ptrdiff_t rowBytes = ( lineBytes + alignment - 1 ) & ~( alignment - 1 );
+	T *data = static_cast<T*>( ::operator new( std::max<size_t>( mHeight * rowBytes, 1 ), std::align_val_t( alignment ) ) );
+	for( int32_t y = 0; y < mHeight; ++y )
+		std::memcpy( reinterpret_cast<uint8_t*>( data ) + y * rowBytes, reinterpret_cast<const uint8_t*>( mData ) + y * mRowBytes, lineBytes );
+	mDataStore = std::shared_ptr<T>( data, [alignment]( T *data ) { ::operator delete( data, std::align_val_t( alignment ) ); } );
+	mData = data;
+	mRowBytes = rowBytes;
+	mShareToken = ShareToken::create();
+	initChannels();
+}
+
 template<typename T>
 void SurfaceT<T>::init( ImageSourceRef imageSource, const SurfaceConstraints &constraints, bool alpha )
 {
@@ -338,6 +417,7 @@ void SurfaceT<T>::init( ImageSourceRef imageSource, const SurfaceConstraints &co
 	
 	mDataStore = std::shared_ptr<T>( new T[mHeight * mRowBytes], std::default_delete<T[]>() );
 	mData = mDataStore.get();
+	mShareToken = ShareToken::create();
 
 	mPremultiplied = imageSource->isPremultiplied();
 	
@@ -353,6 +433,7 @@ void SurfaceT<T>::init( ImageSourceRef imageSource, const SurfaceConstraints &co
 template<typename T>
 void SurfaceT<T>::copyFrom( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &relativeOffset )
 {
+	detach();
 	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcSurface.getBounds(), srcArea, getBounds(), srcArea.getUL() + relativeOffset );
 	
 	if( getChannelOrder() == srcSurface.getChannelOrder() )
@@ -368,6 +449,7 @@ void SurfaceT<T>::copyFrom( const SurfaceT<T> &srcSurface, const Area &srcArea,
 template<typename T>
 void SurfaceT<T>::copyFromFlipped( const SurfaceT<T>& srcSurface, const Area& srcArea, const ivec2& relativeOffset )
 {
+	detach();
 	std::pair<Area, ivec2> srcDst = clippedSrcDst( srcSurface.getBounds(), srcArea, getBounds(), srcArea.getUL() + relativeOffset );
 
 	if( getChannelOrder() == srcSurface.getChannelOrder() )
@@ -595,7 +677,7 @@ ColorT<T> SurfaceT<T>::areaAverage( const Area &area ) const
 	const Area clipped( area.getClipBy( getBounds() ) );
 	
 	if( ( clipped.getWidth() <= 0 ) || ( clipped.getHeight() <= 0 ) )
-		return ColorT<T>( 0, 0, 0 );
+		return ColorT<T>( fromChanSum<T>( 0 ), fromChanSum<T>( 0 ), fromChanSum<T>( 0 ) );
 
 	uint8_t red = getRedOffset(), green = getGreenOffset(), blue = getBlueOffset();
 	uint8_t inc = getPixelInc();
@@ -603,16 +685,16 @@ ColorT<T> SurfaceT<T>::areaAverage( const Area &area ) const
 	for( int32_t y = clipped.y1; y < clipped.y2; ++y ) {
 		const T *d = line;
 		for( int32_t x = clipped.x1; x < clipped.x2; ++x ) {
-			redSum += d[red];
-			greenSum += d[green];
-			blueSum += d[blue];						
+			redSum += toChanSum( d[red] );
+			greenSum += toChanSum( d[green] );
+			blueSum += toChanSum( d[blue] );
 			d += inc;
 		}
 		
 		line = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( line ) + getRowBytes() );
 	} 
 	
-	return ColorT<T>( (T)(redSum / ( clipped.getWidth() * clipped.getHeight() )), (T)(greenSum / ( clipped.getWidth() * clipped.getHeight() )), (T)(blueSum / ( clipped.getWidth() * clipped.getHeight() )) );
+	return ColorT<T>( fromChanSum<T>( redSum / ( clipped.getWidth() * clipped.getHeight() ) ), fromChanSum<T>( greenSum / ( clipped.getWidth() * clipped.getHeight() ) ), fromChanSum<T>( blueSum / ( clipped.getWidth() * clipped.getHeight() ) ) );
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -627,6 +709,8 @@ ImageTargetSurface<T>::ImageTargetSurface( SurfaceT<T> *aSurface )
 		setDataType( ImageIo::UINT16 );
 	else if( std::is_same<T,uint8_t>::value )
 		setDataType( ImageIo::UINT8 );
+	else if( std::is_same<T,half_float>::value )
+		setDataType( ImageIo::FLOAT16 );
 	else 
 		throw; // what is this?
 
@@ -685,5 +769,6 @@ void* ImageTargetSurface<T>::getRowPointer( int32_t row )
 template class CI_API SurfaceT<uint8_t>;
 template class CI_API SurfaceT<uint16_t>;
 template class CI_API SurfaceT<float>;
+template class CI_API SurfaceT<half_float>;
 
 } // namespace cinder
@@ -0,0 +1,247 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/SurfacePool.h"
+#include "cinder/ImageIo.h"
+#include "cinder/CinderAssert.h"
+
+#include <algorithm>
+#include <list>
+#include <mutex>
+#include <memory>
+#include <new>
+#include <tuple>
+
+namespace cinder {
+
+namespace {
+
+// width, height, channel order code, element size
+typedef std::tuple<int32_t, int32_t, int, size_t>	PoolKey;
+
+void* allocateAligned( size_t bytes, size_t alignment )
+{
+	return ::operator new( std::max<size_t>( bytes, 1 ), std::align_val_t( alignment ) );
+}
+
+void freeAligned( void *data, size_t alignment )
+{
+	::operator delete( data, std::align_val_t( alignment ) );
+}
+
+} // anonymous namespace
+
+struct SurfacePool::Shared {
+	struct Buffer {
+		PoolKey		mKey;
+		void		*mData;
+		size_t		mBytes;
+	};
+
+	Shared( const Format &format )
+		: mFormat( format ), mIdleBytes( 0 ), mNumInUse( 0 ), mNumHits( 0 ), mNumMisses( 0 ), mNumEvictions( 0 )
+	{}
+
+	~Shared()
+	{
+		for( auto &buffer : mIdle )
+			freeAligned( buffer.mData, mFormat.getAlignment() );
+	}
+
+	void* take( const PoolKey &key, size_t bytes )
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			// the most recently returned storage is the most likely to still be in cache
+			for( auto it = mIdle.rbegin(); it != mIdle.rend(); ++it ) {
+				if( it->mKey == key ) {
+					void *data = it->mData;
+					mIdleBytes -= it->mBytes;
+					mIdle.erase( std::next( it ).base() );
+					++mNumHits;
+					++mNumInUse;
+					return data;
+				}
+			}
+			++mNumMisses;
+		}
+
+		// allocateAligned() may throw, so the storage only counts as in use once it exists
+		void *data = allocateAligned( bytes, mFormat.getAlignment() );
+		std::lock_guard<std::mutex> lock( mMutex );
+		++mNumInUse;
+		return data;
+	}
+
+	void give( const PoolKey &key, void *data, size_t bytes )
+	{
+		std::list<Buffer> evicted;
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			--mNumInUse;
+			mIdle.push_back( Buffer{ key, data, bytes } );
+			mIdleBytes += bytes;
+
+			size_t numSameKey = std::count_if( mIdle.begin(), mIdle.end(), [&]( const Buffer &buffer ) { return buffer.mKey == key; } );
+			for( auto it = mIdle.begin(); it != mIdle.end() && numSameKey > mFormat.getMaxIdleSurfaces(); ) {
+				if( it->mKey == key ) {
+					--numSameKey;
+					evict( it++, &evicted );
+				}
+				else
+					++it;
+			}
+			while( mIdleBytes > mFormat.getMaxIdleBytes() )
+				evict( mIdle.begin(), &evicted );
+		}
+
+		for( auto &buffer : evicted )
+			freeAligned( buffer.mData, mFormat.getAlignment() );
+	}
+
+	void evict( std::list<Buffer>::iterator it, std::list<Buffer> *evicted )
+	{
+		mIdleBytes -= it->mBytes;
+		++mNumEvictions;
+		evicted->splice( evicted->end(), mIdle, it );
+	}
+
+	const Format		mFormat;
+	mutable std::mutex	mMutex;
+	std::list<Buffer>	mIdle; // least recently returned first
+	size_t				mIdleBytes, mNumInUse;
+	size_t				mNumHits, mNumMisses, mNumEvictions;
+};
+
+SurfacePool::SurfacePool( const Format &format )
+	: mFormat( format ), mShared( std::make_shared<Shared>( format ) )
+{
+	CI_ASSERT_MSG( mFormat.getAlignment() > 0 && ( mFormat.getAlignment() & ( mFormat.getAlignment() - 1 ) ) == 0, "SurfacePool alignment must be a power of two" );
+}
+
+SurfacePool::~SurfacePool()
+{
+}
+
+SurfacePoolRef SurfacePool::getDefault()
+{
+	static SurfacePoolRef sDefault = SurfacePool::create();
+	return sDefault;
+}
+
+template<typename T>
+SurfaceT<T> SurfacePool::acquire( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder )
+{
+	if( channelOrder == SurfaceChannelOrder::UNSPECIFIED )
+		channelOrder = ( alpha ) ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB;
+
+	const size_t alignment = mFormat.getAlignment();
+	const ptrdiff_t rowBytes = ( width * channelOrder.getPixelInc() * sizeof(T) + alignment - 1 ) & ~( alignment - 1 );
+	const size_t bytes = rowBytes * height;
+	const PoolKey key( width, height, channelOrder.getCode(), sizeof(T) );
+
+	// the deleter holds the pool weakly so that storage outliving the pool is simply freed
+	std::weak_ptr<Shared> weakShared = mShared;
+	auto returnToPool = [weakShared, key, bytes, alignment]( T *data ) {
+		if( auto shared = weakShared.lock() )
+			shared->give( key, data, bytes );
+		else
+			freeAligned( data, alignment );
+	};
+
+	// the buffer is owned from the moment it's taken, so it goes back to the pool if anything below throws
+	std::unique_ptr<T, decltype(returnToPool)> held( static_cast<T*>( mShared->take( key, bytes ) ), returnToPool );
+	T *data = held.get();
+	std::shared_ptr<T> dataStore( std::move( held ) );
+
+	return SurfaceT<T>( data, width, height, rowBytes, channelOrder, dataStore );
+}
+
+template<typename T>
+SurfaceT<T> SurfacePool::load( const ImageSourceRef &imageSource )
+{
+	const bool alpha = imageSource->hasAlpha();
+	SurfaceT<T> result = acquire<T>( imageSource->getWidth(), imageSource->getHeight(), alpha, SurfaceConstraintsDefault().getChannelOrder( alpha ) );
+	result.setPremultiplied( imageSource->isPremultiplied() );
+	imageSource->load( (ImageTargetRef)result );
+	return result;
+}
+
+void SurfacePool::clear()
+{
+	std::list<Shared::Buffer> idle;
+	{
+		std::lock_guard<std::mutex> lock( mShared->mMutex );
+		idle.swap( mShared->mIdle );
+		mShared->mIdleBytes = 0;
+	}
+
+	for( auto &buffer : idle )
+		freeAligned( buffer.mData, mFormat.getAlignment() );
+}
+
+size_t SurfacePool::getNumHits() const
+{
+	std::lock_guard<std::mutex> lock( mShared->mMutex );
+	return mShared->mNumHits;
+}
+
+size_t SurfacePool::getNumMisses() const
+{
+	std::lock_guard<std::mutex> lock( mShared->mMutex );
+	return mShared->mNumMisses;
+}
+
+size_t SurfacePool::getNumEvictions() const
+{
+	std::lock_guard<std::mutex> lock( mShared->mMutex );
+	return mShared->mNumEvictions;
+}
+
+size_t SurfacePool::getNumIdle() const
+{
+	std::lock_guard<std::mutex> lock( mShared->mMutex );
+	return mShared->mIdle.size();
+}
+
+size_t SurfacePool::getIdleBytes() const
+{
+	std::lock_guard<std::mutex> lock( mShared->mMutex );
+	return mShared->mIdleBytes;
+}
+
+size_t SurfacePool::getNumInUse() const
+{
+	std::lock_guard<std::mutex> lock( mShared->mMutex );
+	return mShared->mNumInUse;
+}
+
+#define SURFACEPOOL_PROTOTYPES(T)\
+	template CI_API SurfaceT<T> SurfacePool::acquire<T>( int32_t width, int32_t height, bool alpha, SurfaceChannelOrder channelOrder );\
+	template CI_API SurfaceT<T> SurfacePool::load<T>( const ImageSourceRef &imageSource );
+
+SURFACEPOOL_PROTOTYPES(uint8_t)
+SURFACEPOOL_PROTOTYPES(uint16_t)
+SURFACEPOOL_PROTOTYPES(float)
+
+} // namespace cinder
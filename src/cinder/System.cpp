@@ -59,6 +59,15 @@
 	#include <cxxabi.h>
 #endif
 
+// GCC and Clang can query x86 CPU features directly on platforms without a native mechanism
+#if ! defined( CINDER_COCOA ) && ! defined( CINDER_MSW ) && ( defined( __clang__ ) || defined( __GNUC__ ) ) && ( defined( __x86_64__ ) || defined( __i386__ ) )
+	#define CINDER_SYSTEM_CPU_BUILTINS
+#endif
+
+#if defined( CINDER_MSW_DESKTOP ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+	#include <intrin.h>
+#endif
+
 #include <string>
 
 using namespace std;
@@ -253,6 +262,8 @@ bool System::hasSse2()
 		instance()->mHasSSE2 = true;
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE2 = ( instance()->mCPUID_EDX & 0x04000000 ) != 0;
+#elif defined( CINDER_SYSTEM_CPU_BUILTINS )
+		instance()->mHasSSE2 = __builtin_cpu_supports( "sse2" ) != 0;
 #else
 	throw Exception( "Not implemented" );
 #endif
@@ -271,6 +282,8 @@ bool System::hasSse3()
 		instance()->mHasSSE3 = true;
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE3 = ( instance()->mCPUID_ECX & 0x00000001 ) != 0;
+#elif defined( CINDER_SYSTEM_CPU_BUILTINS )
+		instance()->mHasSSE3 = __builtin_cpu_supports( "sse3" ) != 0;
 #else
 		throw Exception( "Not implemented" );
 #endif
@@ -289,6 +302,8 @@ bool System::hasSse4_1()
 		instance()->mHasSSE4_1 = true; // TODO: this is not being tested
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE4_1 = ( instance()->mCPUID_ECX & ( 1 << 19 ) ) != 0;
+#elif defined( CINDER_SYSTEM_CPU_BUILTINS )
+		instance()->mHasSSE4_1 = __builtin_cpu_supports( "sse4.1" ) != 0;
 #else
 		throw Exception( "Not implemented" );
 #endif
@@ -307,6 +322,8 @@ bool System::hasSse4_2()
 		instance()->mHasSSE4_2 = true; // TODO: this is not being tested
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasSSE4_2 = ( instance()->mCPUID_ECX & ( 1 << 20 ) ) != 0;
+#elif defined( CINDER_SYSTEM_CPU_BUILTINS )
+		instance()->mHasSSE4_2 = __builtin_cpu_supports( "sse4.2" ) != 0;
 #else
 		throw Exception( "Not implemented" );
 #endif		
@@ -316,6 +333,51 @@ bool System::hasSse4_2()
 	return instance()->mHasSSE4_2;
 }
 
+bool System::hasAvx2()
+{
+	if( ! instance()->mCachedValues[HAS_AVX2] ) {
+#if defined( CINDER_COCOA )
+		instance()->mHasAVX2 = ( getSysCtlValue<int>( "hw.optional.avx2_0" ) == 1 );
+#elif defined( CINDER_MSW_DESKTOP ) && ( defined( _M_X64 ) || defined( _M_IX86 ) )
+		// AVX2 requires both the CPU feature bit (leaf 7, EBX bit 5) and OS support for saving the YMM registers
+		int info[4];
+		__cpuid( info, 0 );
+		bool result = false;
+		if( info[0] >= 7 ) {
+			__cpuid( info, 1 );
+			const bool osxsave = ( info[2] & ( 1 << 27 ) ) != 0;
+			const bool avx = ( info[2] & ( 1 << 28 ) ) != 0;
+			if( osxsave && avx && ( ( _xgetbv( 0 ) & 0x6 ) == 0x6 ) ) {
+				__cpuidex( info, 7, 0 );
+				result = ( info[1] & ( 1 << 5 ) ) != 0;
+			}
+		}
+		instance()->mHasAVX2 = result;
+#elif defined( CINDER_SYSTEM_CPU_BUILTINS )
+		instance()->mHasAVX2 = __builtin_cpu_supports( "avx2" ) != 0;
+#else
+		instance()->mHasAVX2 = false;
+#endif
+		instance()->mCachedValues[HAS_AVX2] = true;
+	}
+
+	return instance()->mHasAVX2;
+}
+
+bool System::hasNeon()
+{
+	if( ! instance()->mCachedValues[HAS_NEON] ) {
+#if defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+		instance()->mHasNeon = true;
+#else
+		instance()->mHasNeon = false;
+#endif
+		instance()->mCachedValues[HAS_NEON] = true;
+	}
+
+	return instance()->mHasNeon;
+}
+
 bool System::hasArm()
 {
 	if( ! instance()->mCachedValues[HAS_ARM] ) {
@@ -338,6 +400,10 @@ bool System::hasX86_64()
 		instance()->mHasX86_64 = true;
 #elif defined( CINDER_MSW_DESKTOP )
 		instance()->mHasX86_64 = ( instance()->mCPUID_EDX & ( 1 << 29 ) ) != 0;
+#elif defined( __x86_64__ )
+		instance()->mHasX86_64 = true;
+#elif defined( CINDER_SYSTEM_CPU_BUILTINS )
+		instance()->mHasX86_64 = false;
 #else
 		throw Exception( "Not implemented" );
 #endif		
@@ -0,0 +1,489 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/TiledSurface.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/ImageIo.h"
+#include "cinder/ip/Fill.h"
+
+#include <algorithm>
+#include <random>
+
+namespace cinder {
+
+namespace {
+
+// Receives the rows of an ImageSource one band of tiles at a time, and writes each band to the TiledSurface once complete
+template<typename T>
+class ImageTargetTiledSurface : public ImageTarget {
+  public:
+	ImageTargetTiledSurface( TiledSurfaceT<T> *tiledSurface, bool fillAlpha )
+		: mTiledSurface( tiledSurface ), mFillAlpha( fillAlpha ), mBand( -1 ),
+		mBandSurface( tiledSurface->getWidth(), tiledSurface->getTileSize(), tiledSurface->hasAlpha(), tiledSurface->getChannelOrder() ),
+		mBandWritten( tiledSurface->getNumTiles().y, false )
+	{
+		if( std::is_same<T,float>::value )
+			setDataType( ImageIo::FLOAT32 );
+		else if( std::is_same<T,uint16_t>::value )
+			setDataType( ImageIo::UINT16 );
+		else
+			setDataType( ImageIo::UINT8 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( ImageIo::ChannelOrder( tiledSurface->getChannelOrder().getImageIoChannelOrder() ) );
+	}
+
+	bool hasAlpha() const override { return mTiledSurface->hasAlpha(); }
+
+	void* getRowPointer( int32_t row ) override
+	{
+		const int32_t band = row / mTiledSurface->getTileSize();
+		if( band != mBand ) {
+			flush();
+			mBand = band;
+			// sources normally deliver rows in order, but a band revisited is read back so that its earlier rows survive
+			if( mBandWritten[band] )
+				mTiledSurface->readArea( getBandArea(), &mBandSurface );
+			else if( mFillAlpha )
+				ip::fill( &mBandSurface.getChannelAlpha(), CHANTRAIT<T>::max() );
+		}
+
+		return mBandSurface.getData( ivec2( 0, row - band * mTiledSurface->getTileSize() ) );
+	}
+
+	void finalize() override { flush(); }
+
+	void flush()
+	{
+		if( mBand < 0 )
+			return;
+		const Area area = getBandArea();
+		mTiledSurface->writeArea( mBandSurface, Area( 0, 0, area.getWidth(), area.getHeight() ), area.getUL() );
+		mBandWritten[mBand] = true;
+		mBand = -1;
+	}
+
+  private:
+	Area getBandArea() const
+	{
+		const int32_t tileSize = mTiledSurface->getTileSize();
+		return Area( 0, mBand * tileSize, mTiledSurface->getWidth(), std::min( mTiledSurface->getHeight(), ( mBand + 1 ) * tileSize ) );
+	}
+
+	TiledSurfaceT<T>	*mTiledSurface;
+	bool				mFillAlpha;
+	int32_t				mBand;
+	SurfaceT<T>			mBandSurface;
+	std::vector<bool>	mBandWritten;
+};
+
+fs::path createTemporaryCachePath()
+{
+	std::random_device rd;
+	return fs::temp_directory_path() / ( "cinder_tiles_" + std::to_string( rd() ) + std::to_string( rd() ) + ".cache" );
+}
+
+} // anonymous namespace
+
+template<typename T>
+TiledSurfaceT<T>::TiledSurfaceT( int32_t width, int32_t height, bool alpha, const Format &format )
+	: mWidth( width ), mHeight( height )
+{
+	init( alpha, format );
+}
+
+template<typename T>
+TiledSurfaceT<T>::TiledSurfaceT( const ImageSourceRef &imageSource, const Format &format )
+	: mWidth( imageSource->getWidth() ), mHeight( imageSource->getHeight() )
+{
+	init( imageSource->hasAlpha(), format );
+	loadImageSource( imageSource );
+}
+
+template<typename T>
+TiledSurfaceT<T>::~TiledSurfaceT()
+{
+	if( mPrefetchThread.joinable() ) {
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mStopPrefetch = true;
+		}
+		mPrefetchCv.notify_all();
+		mPrefetchThread.join();
+	}
+
+	if( mCacheFile.is_open() )
+		mCacheFile.close();
+	if( mRemoveCacheFile ) {
+		std::error_code ec;
+		fs::remove( mCachePath, ec );
+	}
+}
+
+template<typename T>
+void TiledSurfaceT<T>::init( bool alpha, const Format &format )
+{
+	mTileSize = std::max<int32_t>( 1, format.getTileSize() );
+	mChannelOrder = format.getChannelOrder();
+	if( mChannelOrder == SurfaceChannelOrder::UNSPECIFIED || mChannelOrder.hasAlpha() != alpha )
+		mChannelOrder = alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB;
+	mTileRowBytes = mTileSize * mChannelOrder.getPixelInc() * sizeof(T);
+	mTileBytes = mTileRowBytes * mTileSize;
+	mMemoryBudget = format.getMemoryBudget();
+	mResidentBytes = 0;
+	mNumPageIns = mNumPageOuts = 0;
+
+	mNumTilesX = ( mWidth + mTileSize - 1 ) / mTileSize;
+	mNumTilesY = ( mHeight + mTileSize - 1 ) / mTileSize;
+	mTiles = std::vector<Tile>( (size_t)mNumTilesX * mNumTilesY );
+
+	mRemoveCacheFile = format.getCachePath().empty();
+	mCachePath = mRemoveCacheFile ? createTemporaryCachePath() : format.getCachePath();
+
+	mNumPrefetching = 0;
+	mStopPrefetch = false;
+}
+
+template<typename T>
+void TiledSurfaceT<T>::loadImageSource( const ImageSourceRef &imageSource )
+{
+	auto target = std::make_shared<ImageTargetTiledSurface<T>>( this, hasAlpha() && ! imageSource->hasAlpha() );
+	imageSource->load( target );
+	// not every ImageSource calls finalize()
+	target->flush();
+}
+
+template<typename T>
+Area TiledSurfaceT<T>::getTileBounds( const ivec2 &tile ) const
+{
+	return Area( tile.x * mTileSize, tile.y * mTileSize, std::min( mWidth, ( tile.x + 1 ) * mTileSize ), std::min( mHeight, ( tile.y + 1 ) * mTileSize ) );
+}
+
+template<typename T>
+SurfaceT<T> TiledSurfaceT<T>::readArea( const Area &area )
+{
+	const Area clipped = area.getClipBy( getBounds() );
+	SurfaceT<T> result( std::max( 0, clipped.getWidth() ), std::max( 0, clipped.getHeight() ), hasAlpha(), mChannelOrder );
+	readArea( clipped, &result );
+	return result;
+}
+
+template<typename T>
+void TiledSurfaceT<T>::readArea( const Area &area, SurfaceT<T> *dstSurface, const ivec2 &dstLT )
+{
+	std::pair<Area,ivec2> srcDst = clippedSrcDst( getBounds(), area, dstSurface->getBounds(), dstLT );
+	const Area &clipped = srcDst.first;
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return;
+	const ivec2 offset = srcDst.second - clipped.getUL();
+
+	std::unique_lock<std::mutex> lock( mMutex );
+	std::unique_ptr<T[]> zeroTile;
+	for( int32_t ty = clipped.y1 / mTileSize; ty <= ( clipped.y2 - 1 ) / mTileSize; ++ty ) {
+		for( int32_t tx = clipped.x1 / mTileSize; tx <= ( clipped.x2 - 1 ) / mTileSize; ++tx ) {
+			const int32_t index = ty * mNumTilesX + tx;
+			// tiles never written read as zero without being allocated
+			const T *pixels;
+			if( mTiles[index].mState == TILE_EMPTY ) {
+				if( ! zeroTile )
+					zeroTile.reset( new T[mTileBytes / sizeof(T)]() );
+				pixels = zeroTile.get();
+			}
+			else
+				pixels = acquireTile( index, lock, false );
+
+			const SurfaceT<T> tileSurface( const_cast<T*>( pixels ), mTileSize, mTileSize, mTileRowBytes, mChannelOrder );
+			const ivec2 tileUL( tx * mTileSize, ty * mTileSize );
+			const Area tileArea = getTileBounds( ivec2( tx, ty ) ).getClipBy( clipped );
+			dstSurface->copyFrom( tileSurface, Area( tileArea.getUL() - tileUL, tileArea.getLR() - tileUL ), tileUL + offset );
+		}
+	}
+}
+
+template<typename T>
+void TiledSurfaceT<T>::writeArea( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT )
+{
+	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcSurface.getBounds(), srcArea, getBounds(), dstLT );
+	if( srcDst.first.getWidth() <= 0 || srcDst.first.getHeight() <= 0 )
+		return;
+	const Area clipped( srcDst.second, srcDst.second + srcDst.first.getSize() );
+	// source pixel = destination pixel + offset
+	const ivec2 offset = srcDst.first.getUL() - srcDst.second;
+
+	std::unique_lock<std::mutex> lock( mMutex );
+	for( int32_t ty = clipped.y1 / mTileSize; ty <= ( clipped.y2 - 1 ) / mTileSize; ++ty ) {
+		for( int32_t tx = clipped.x1 / mTileSize; tx <= ( clipped.x2 - 1 ) / mTileSize; ++tx ) {
+			T *pixels = acquireTile( ty * mNumTilesX + tx, lock, true );
+			SurfaceT<T> tileSurface( pixels, mTileSize, mTileSize, mTileRowBytes, mChannelOrder );
+			const ivec2 tileUL( tx * mTileSize, ty * mTileSize );
+			const Area tileArea = getTileBounds( ivec2( tx, ty ) ).getClipBy( clipped );
+			tileSurface.copyFrom( srcSurface, Area( tileArea.getUL() + offset, tileArea.getLR() + offset ), -offset - tileUL );
+		}
+	}
+}
+
+template<typename T>
+void TiledSurfaceT<T>::forEachTile( const Area &area, bool writable, const std::function<void( SurfaceT<T> &tileSurface, const Area &tileArea )> &fn )
+{
+	const Area clipped = area.getClipBy( getBounds() );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return;
+
+	for( int32_t ty = clipped.y1 / mTileSize; ty <= ( clipped.y2 - 1 ) / mTileSize; ++ty ) {
+		for( int32_t tx = clipped.x1 / mTileSize; tx <= ( clipped.x2 - 1 ) / mTileSize; ++tx ) {
+			const int32_t index = ty * mNumTilesX + tx;
+			std::unique_lock<std::mutex> lock( mMutex );
+			T *pixels = acquireTile( index, lock, writable );
+			// pinned tiles are never evicted, so the callback can run without the lock
+			++mTiles[index].mPinCount;
+			lock.unlock();
+
+			const ivec2 tileUL( tx * mTileSize, ty * mTileSize );
+			const Area tileArea = getTileBounds( ivec2( tx, ty ) ).getClipBy( clipped );
+			SurfaceT<T> tileSurface( pixels, mTileSize, mTileSize, mTileRowBytes, mChannelOrder );
+			SurfaceT<T> view( tileSurface.getData( tileArea.getUL() - tileUL ), tileArea.getWidth(), tileArea.getHeight(), mTileRowBytes, mChannelOrder );
+			try {
+				fn( view, tileArea );
+			}
+			catch( ... ) {
+				lock.lock();
+				--mTiles[index].mPinCount;
+				throw;
+			}
+			lock.lock();
+			--mTiles[index].mPinCount;
+		}
+	}
+}
+
+template<typename T>
+void TiledSurfaceT<T>::prefetch( const Area &area )
+{
+	const Area clipped = area.getClipBy( getBounds() );
+	if( clipped.getWidth() <= 0 || clipped.getHeight() <= 0 )
+		return;
+
+	std::lock_guard<std::mutex> lock( mMutex );
+	if( ! mPrefetchThread.joinable() )
+		mPrefetchThread = std::thread( &TiledSurfaceT<T>::prefetchThreadFn, this );
+
+	const size_t maxQueued = std::max<size_t>( 1, mMemoryBudget / 2 / mTileBytes );
+	for( int32_t ty = clipped.y1 / mTileSize; ty <= ( clipped.y2 - 1 ) / mTileSize; ++ty ) {
+		for( int32_t tx = clipped.x1 / mTileSize; tx <= ( clipped.x2 - 1 ) / mTileSize; ++tx ) {
+			const int32_t index = ty * mNumTilesX + tx;
+			// only tiles on disk are worth prefetching; empty tiles cost nothing to create
+			if( mTiles[index].mState == TILE_PAGED_OUT && mPrefetchQueue.size() < maxQueued )
+				mPrefetchQueue.push_back( index );
+		}
+	}
+	mPrefetchCv.notify_one();
+}
+
+template<typename T>
+void TiledSurfaceT<T>::waitForPrefetch()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	mTileLoadedCv.wait( lock, [this] { return mPrefetchQueue.empty() && mNumPrefetching == 0; } );
+}
+
+template<typename T>
+size_t TiledSurfaceT<T>::getNumResidentTiles() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mLru.size();
+}
+
+template<typename T>
+size_t TiledSurfaceT<T>::getResidentBytes() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mResidentBytes;
+}
+
+template<typename T>
+size_t TiledSurfaceT<T>::getNumPageIns() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumPageIns;
+}
+
+template<typename T>
+size_t TiledSurfaceT<T>::getNumPageOuts() const
+{
+	std::lock_guard<std::mutex> lock( mMutex );
+	return mNumPageOuts;
+}
+
+template<typename T>
+T* TiledSurfaceT<T>::acquireTile( int32_t index, std::unique_lock<std::mutex> &lock, bool forWriting )
+{
+	Tile &tile = mTiles[index];
+	mTileLoadedCv.wait( lock, [&tile] { return tile.mState != TILE_LOADING; } );
+
+	if( tile.mState != TILE_RESIDENT ) {
+		makeRoom( mTileBytes, lock );
+		std::unique_ptr<T[]> pixels( new T[mTileBytes / sizeof(T)]() );
+		if( tile.mState == TILE_PAGED_OUT ) {
+			readTileFromDisk( index, pixels.get() );
+			++mNumPageIns;
+		}
+		tile.mPixels = std::move( pixels );
+		tile.mState = TILE_RESIDENT;
+		tile.mLruPos = mLru.insert( mLru.begin(), index );
+		mResidentBytes += mTileBytes;
+	}
+	else
+		touch( index );
+
+	if( forWriting )
+		tile.mDirty = true;
+	return tile.mPixels.get();
+}
+
+template<typename T>
+void TiledSurfaceT<T>::touch( int32_t index )
+{
+	mLru.splice( mLru.begin(), mLru, mTiles[index].mLruPos );
+}
+
+template<typename T>
+void TiledSurfaceT<T>::makeRoom( size_t bytes, std::unique_lock<std::mutex> &/*lock*/ )
+{
+	while( mResidentBytes + bytes > mMemoryBudget ) {
+		auto victim = std::find_if( mLru.rbegin(), mLru.rend(), [this]( int32_t i ) { return mTiles[i].mPinCount == 0; } );
+		if( victim == mLru.rend() )
+			break;
+		evict( *victim );
+	}
+}
+
+template<typename T>
+void TiledSurfaceT<T>::evict( int32_t index )
+{
+	Tile &tile = mTiles[index];
+	CI_ASSERT( tile.mState == TILE_RESIDENT && tile.mPinCount == 0 );
+
+	// a tile which is neither dirty nor on disk was only ever read, so it still holds zeros
+	if( tile.mDirty ) {
+		writeTileToDisk( index, tile.mPixels.get() );
+		tile.mOnDisk = true;
+		++mNumPageOuts;
+	}
+	tile.mState = tile.mOnDisk ? TILE_PAGED_OUT : TILE_EMPTY;
+	tile.mDirty = false;
+	tile.mPixels.reset();
+	mLru.erase( tile.mLruPos );
+	mResidentBytes -= mTileBytes;
+}
+
+template<typename T>
+void TiledSurfaceT<T>::readTileFromDisk( int32_t index, T *pixels )
+{
+	std::lock_guard<std::mutex> lock( mCacheFileMutex );
+	mCacheFile.seekg( (std::streamoff)index * mTileBytes );
+	mCacheFile.read( reinterpret_cast<char*>( pixels ), mTileBytes );
+	if( ! mCacheFile ) {
+		mCacheFile.clear();
+		throw TiledSurfaceExc( "Failed to read tile from cache file " + mCachePath.string() );
+	}
+}
+
+template<typename T>
+void TiledSurfaceT<T>::writeTileToDisk( int32_t index, const T *pixels )
+{
+	std::lock_guard<std::mutex> lock( mCacheFileMutex );
+	if( ! mCacheFile.is_open() ) {
+		// slots are addressed by tile index, so the file is sparse where tiles were never evicted
+		mCacheFile.open( mCachePath, std::ios::in | std::ios::out | std::ios::binary | std::ios::trunc );
+		if( ! mCacheFile.is_open() )
+			throw TiledSurfaceExc( "Failed to create cache file " + mCachePath.string() );
+	}
+
+	mCacheFile.seekp( (std::streamoff)index * mTileBytes );
+	mCacheFile.write( reinterpret_cast<const char*>( pixels ), mTileBytes );
+	mCacheFile.flush();
+	if( ! mCacheFile ) {
+		mCacheFile.clear();
+		throw TiledSurfaceExc( "Failed to write tile to cache file " + mCachePath.string() );
+	}
+}
+
+template<typename T>
+void TiledSurfaceT<T>::prefetchThreadFn()
+{
+	std::unique_lock<std::mutex> lock( mMutex );
+	while( true ) {
+		mPrefetchCv.wait( lock, [this] { return mStopPrefetch || ! mPrefetchQueue.empty(); } );
+		if( mStopPrefetch )
+			break;
+
+		const int32_t index = mPrefetchQueue.front();
+		mPrefetchQueue.pop_front();
+		Tile &tile = mTiles[index];
+		if( tile.mState == TILE_PAGED_OUT ) {
+			try {
+				makeRoom( mTileBytes, lock );
+			}
+			catch( ... ) {
+				// evicting failed to write to the cache; skip the hint and let a later access report the error
+				mTileLoadedCv.notify_all();
+				continue;
+			}
+			// the tile's memory is reserved while it loads; loading tiles are not in the LRU list and can't be evicted
+			tile.mState = TILE_LOADING;
+			mResidentBytes += mTileBytes;
+			++mNumPrefetching;
+			lock.unlock();
+
+			std::unique_ptr<T[]> pixels;
+			try {
+				pixels.reset( new T[mTileBytes / sizeof(T)] );
+				readTileFromDisk( index, pixels.get() );
+			}
+			catch( ... ) {
+				// leave the tile paged out; a later access will read it and report the error
+				pixels.reset();
+			}
+
+			lock.lock();
+			--mNumPrefetching;
+			if( pixels ) {
+				tile.mPixels = std::move( pixels );
+				tile.mState = TILE_RESIDENT;
+				tile.mLruPos = mLru.insert( mLru.begin(), index );
+				++mNumPageIns;
+			}
+			else {
+				tile.mState = TILE_PAGED_OUT;
+				mResidentBytes -= mTileBytes;
+			}
+		}
+		mTileLoadedCv.notify_all();
+	}
+}
+
+template class CI_API TiledSurfaceT<uint8_t>;
+template class CI_API TiledSurfaceT<uint16_t>;
+template class CI_API TiledSurfaceT<float>;
+
+} // namespace cinder
@@ -489,13 +489,24 @@ AxisAlignedBox TriMesh::calcBoundingBox( const mat4 &transform ) const
 	return AxisAlignedBox( min, max );
 }
 
-void TriMesh::read( const DataSourceRef &dataSource )
+void TriMesh::read( const DataSourceRef &dataSource, const ReadOptions &options )
 {
-	IStreamRef in = dataSource->createStream();
+	std::shared_ptr<const Buffer> buffer = loadBufferMapped( dataSource, MappedFile::ACCESS_RANDOM );
+	if( buffer->getSize() == 0 )
+		throw Exception( "TriMesh::read() error: empty file." );
 
-	uint8_t versionNumber;
-	in->read( &versionNumber );
+	const uint8_t versionNumber = *static_cast<const uint8_t*>( buffer->getData() );
+	if( versionNumber == 3 ) {
+		clear();
+		readImplV3( *buffer, options );
+		return;
+	}
+
+	if( options.getLod() > 0 )
+		throw Exception( "TriMesh::read() error: level of detail " + std::to_string( options.getLod() ) + " requested from a file with one level of detail." );
 
+	IStreamRef in = IStreamMem::create( buffer->getData(), buffer->getSize() );
+	in->seekAbsolute( 1 );
 	if( versionNumber == 1 ) {
 		clear();
 		readImplV1( in );
@@ -505,7 +516,7 @@ void TriMesh::read( const DataSourceRef &dataSource )
 		readImplV2( in );
 	}
 	else {
-		throw Exception( "TriMesh::read() error: wrong version number. expected version = 1 or 2, version read: " + std::to_string( versionNumber ) );
+		throw Exception( "TriMesh::read() error: wrong version number. expected version = 1, 2 or 3, version read: " + std::to_string( versionNumber ) );
 	}
 }
 
@@ -560,6 +571,397 @@ void TriMesh::write( const DataTargetRef &dataTarget, uint32_t writeMask ) const
 	writeAttrib( toMask( geom::BONE_WEIGHT ), mBoneWeightsDims, mBoneWeights.size() * 4, mBoneWeights.data() );
 }
 
+namespace {
+
+// Version 3 files begin with a ChunkedHeader, followed by a table of the Chunks which locate the attributes and indices of each level of detail.
+// Chunks are aligned to 8 bytes, and all values are stored in native byte order, so files are only portable between machines of the same endianness.
+struct ChunkedHeader {
+	uint8_t		mVersion;
+	uint8_t		mReserved[3];
+	uint32_t	mNumChunks;
+	uint32_t	mNumLods;
+	uint32_t	mReserved2;
+};
+
+enum ChunkEncoding : uint8_t {
+	ENCODING_FLOAT32,		// raw floats
+	ENCODING_UNORM16,		// 16-bit fractions of the chunk's bounds
+	ENCODING_OCT16,			// unit vectors as two 16-bit octahedral coordinates
+	ENCODING_FLOAT16,		// half floats
+	ENCODING_UINT32,		// raw indices
+	ENCODING_DELTA_VARINT	// indices as zigzagged LEB128 differences to the previous index
+};
+
+struct Chunk {
+	uint32_t	mAttrib;			// TriMesh::toMask() of the attribute, or 0 for the indices
+	uint16_t	mLod;
+	uint8_t		mDims;
+	uint8_t		mEncoding;
+	uint64_t	mCount;				// the number of vertices, or of indices
+	uint64_t	mOffset, mSize;		// in bytes from the start of the file
+	float		mMin[4], mExtent[4];	// the bounds of ENCODING_UNORM16 values
+};
+
+static_assert( sizeof( ChunkedHeader ) == 16 && sizeof( Chunk ) == 64, "TriMesh chunked format structs must be packed" );
+
+template<typename T>
+void appendValue( std::vector<uint8_t> *payload, const T &value )
+{
+	const size_t offset = payload->size();
+	payload->resize( offset + sizeof( T ) );
+	memcpy( payload->data() + offset, &value, sizeof( T ) );
+}
+
+template<typename T>
+T loadValue( const uint8_t *data )
+{
+	T result;
+	memcpy( &result, data, sizeof( T ) );
+	return result;
+}
+
+vec2 octahedralEncode( vec3 n )
+{
+	const float sum = fabs( n.x ) + fabs( n.y ) + fabs( n.z );
+	if( sum == 0 )
+		return vec2( 0 );
+
+	n /= sum;
+	vec2 result( n.x, n.y );
+	if( n.z < 0 )
+		result = ( vec2( 1 ) - abs( vec2( n.y, n.x ) ) ) * vec2( n.x >= 0 ? 1.0f : -1.0f, n.y >= 0 ? 1.0f : -1.0f );
+	return result;
+}
+
+vec3 octahedralDecode( const vec2 &p )
+{
+	vec3 n( p.x, p.y, 1 - fabs( p.x ) - fabs( p.y ) );
+	if( n.z < 0 ) {
+		n.x = ( 1 - fabs( p.y ) ) * ( p.x >= 0 ? 1.0f : -1.0f );
+		n.y = ( 1 - fabs( p.x ) ) * ( p.y >= 0 ? 1.0f : -1.0f );
+	}
+	return normalize( n );
+}
+
+std::vector<uint8_t> encodeVertices( const float *data, size_t numFloats, Chunk *chunk )
+{
+	std::vector<uint8_t> result;
+	const size_t count = (size_t)chunk->mCount;
+	switch( chunk->mEncoding ) {
+		case ENCODING_FLOAT32:
+			result.resize( numFloats * sizeof( float ) );
+			memcpy( result.data(), data, result.size() );
+		break;
+		case ENCODING_UNORM16:
+			for( uint8_t d = 0; d < chunk->mDims; ++d ) {
+				float minValue = numeric_limits<float>::max(), maxValue = numeric_limits<float>::lowest();
+				for( size_t v = 0; v < count; ++v ) {
+					minValue = std::min( minValue, data[v * chunk->mDims + d] );
+					maxValue = std::max( maxValue, data[v * chunk->mDims + d] );
+				}
+				chunk->mMin[d] = minValue;
+				chunk->mExtent[d] = maxValue - minValue;
+			}
+			result.reserve( numFloats * sizeof( uint16_t ) );
+			for( size_t i = 0; i < numFloats; ++i ) {
+				const uint8_t d = i % chunk->mDims;
+				const float unorm = chunk->mExtent[d] > 0 ? ( data[i] - chunk->mMin[d] ) / chunk->mExtent[d] : 0;
+				appendValue( &result, (uint16_t)lround( glm::clamp( unorm, 0.0f, 1.0f ) * 65535 ) );
+			}
+		break;
+		case ENCODING_OCT16:
+			result.reserve( count * 2 * sizeof( int16_t ) );
+			for( size_t v = 0; v < count; ++v ) {
+				const vec2 p = octahedralEncode( vec3( data[v * 3], data[v * 3 + 1], data[v * 3 + 2] ) );
+				appendValue( &result, (int16_t)lround( glm::clamp( p.x, -1.0f, 1.0f ) * 32767 ) );
+				appendValue( &result, (int16_t)lround( glm::clamp( p.y, -1.0f, 1.0f ) * 32767 ) );
+			}
+		break;
+		case ENCODING_FLOAT16:
+			result.reserve( numFloats * sizeof( uint16_t ) );
+			for( size_t i = 0; i < numFloats; ++i )
+				appendValue( &result, floatToHalf( data[i] ).u );
+		break;
+	}
+
+	return result;
+}
+
+// returns false when the chunk's size doesn't match its encoding
+bool decodeVertices( const uint8_t *data, const Chunk &chunk, float *result )
+{
+	const size_t numFloats = (size_t)chunk.mCount * chunk.mDims;
+	switch( chunk.mEncoding ) {
+		case ENCODING_FLOAT32:
+			if( chunk.mSize != numFloats * sizeof( float ) )
+				return false;
+			memcpy( result, data, numFloats * sizeof( float ) );
+		break;
+		case ENCODING_UNORM16:
+			if( chunk.mSize != numFloats * sizeof( uint16_t ) )
+				return false;
+			for( size_t i = 0; i < numFloats; ++i ) {
+				const uint8_t d = i % chunk.mDims;
+				result[i] = chunk.mMin[d] + loadValue<uint16_t>( data + i * 2 ) * ( chunk.mExtent[d] / 65535 );
+			}
+		break;
+		case ENCODING_OCT16:
+			if( chunk.mDims != 3 || chunk.mSize != chunk.mCount * 2 * sizeof( int16_t ) )
+				return false;
+			for( size_t v = 0; v < chunk.mCount; ++v ) {
+				const vec2 p( loadValue<int16_t>( data + v * 4 ) / 32767.0f, loadValue<int16_t>( data + v * 4 + 2 ) / 32767.0f );
+				const vec3 n = octahedralDecode( p );
+				result[v * 3] = n.x;
+				result[v * 3 + 1] = n.y;
+				result[v * 3 + 2] = n.z;
+			}
+		break;
+		case ENCODING_FLOAT16:
+			if( chunk.mSize != numFloats * sizeof( uint16_t ) )
+				return false;
+			for( size_t i = 0; i < numFloats; ++i ) {
+				half_float h;
+				h.u = loadValue<uint16_t>( data + i * 2 );
+				result[i] = halfToFloat( h );
+			}
+		break;
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+std::vector<uint8_t> encodeIndices( const std::vector<uint32_t> &indices, ChunkEncoding encoding )
+{
+	std::vector<uint8_t> result;
+	if( encoding == ENCODING_UINT32 ) {
+		result.resize( indices.size() * sizeof( uint32_t ) );
+		memcpy( result.data(), indices.data(), result.size() );
+		return result;
+	}
+
+	result.reserve( indices.size() * 2 );
+	int64_t previous = 0;
+	for( uint32_t index : indices ) {
+		const int64_t delta = (int64_t)index - previous;
+		uint64_t zigzag = ( (uint64_t)delta << 1 ) ^ (uint64_t)( delta >> 63 );
+		while( zigzag >= 0x80 ) {
+			result.push_back( (uint8_t)( zigzag | 0x80 ) );
+			zigzag >>= 7;
+		}
+		result.push_back( (uint8_t)zigzag );
+		previous = index;
+	}
+
+	return result;
+}
+
+bool decodeIndices( const uint8_t *data, const Chunk &chunk, uint32_t *result )
+{
+	if( chunk.mEncoding == ENCODING_UINT32 ) {
+		if( chunk.mSize != chunk.mCount * sizeof( uint32_t ) )
+			return false;
+		memcpy( result, data, (size_t)chunk.mSize );
+		return true;
+	}
+	else if( chunk.mEncoding != ENCODING_DELTA_VARINT )
+		return false;
+
+	const uint8_t *end = data + chunk.mSize;
+	int64_t previous = 0;
+	for( size_t i = 0; i < chunk.mCount; ++i ) {
+		uint64_t zigzag = 0;
+		for( int shift = 0; ; shift += 7 ) {
+			if( data == end || shift > 63 )
+				return false;
+			const uint8_t byte = *data++;
+			zigzag |= (uint64_t)( byte & 0x7f ) << shift;
+			if( ! ( byte & 0x80 ) )
+				break;
+		}
+		previous += (int64_t)( zigzag >> 1 ) ^ -(int64_t)( zigzag & 1 );
+		result[i] = (uint32_t)previous;
+	}
+
+	return data == end;
+}
+
+// reads the header and chunk table of a version 3 file, throwing if they don't fit in \a buffer
+const Chunk* readChunkTable( const Buffer &buffer, ChunkedHeader *header )
+{
+	const uint8_t *data = static_cast<const uint8_t*>( buffer.getData() );
+	if( buffer.getSize() < sizeof( ChunkedHeader ) )
+		throw Exception( "TriMesh::read() error: Invalid file contents." );
+	*header = loadValue<ChunkedHeader>( data );
+	if( ( buffer.getSize() - sizeof( ChunkedHeader ) ) / sizeof( Chunk ) < header->mNumChunks )
+		throw Exception( "TriMesh::read() error: Invalid file contents." );
+
+	return reinterpret_cast<const Chunk*>( data + sizeof( ChunkedHeader ) );
+}
+
+} // anonymous namespace
+
+void TriMesh::write( const DataTargetRef &dataTarget, const WriteOptions &options ) const
+{
+	writeImplV3( dataTarget, { this }, options );
+}
+
+void TriMesh::write( const DataTargetRef &dataTarget, const std::vector<TriMeshRef> &lods, const WriteOptions &options )
+{
+	std::vector<const TriMesh*> meshes;
+	for( const TriMeshRef &lod : lods )
+		meshes.push_back( lod.get() );
+	writeImplV3( dataTarget, meshes, options );
+}
+
+void TriMesh::writeImplV3( const DataTargetRef &dataTarget, const std::vector<const TriMesh*> &lods, const WriteOptions &options )
+{
+	std::vector<Chunk> chunks;
+	std::vector<std::vector<uint8_t>> payloads;
+
+	for( size_t lod = 0; lod < lods.size(); ++lod ) {
+		const TriMesh &mesh = *lods[lod];
+		auto addChunk = [&]( uint32_t attrib, uint8_t dims, ChunkEncoding encoding, size_t count ) -> Chunk* {
+			Chunk chunk = {};
+			chunk.mAttrib = attrib;
+			chunk.mLod = (uint16_t)lod;
+			chunk.mDims = dims;
+			chunk.mEncoding = encoding;
+			chunk.mCount = count;
+			chunks.push_back( chunk );
+			return &chunks.back();
+		};
+
+		if( ! mesh.mIndices.empty() ) {
+			const ChunkEncoding encoding = options.getCompressIndices() ? ENCODING_DELTA_VARINT : ENCODING_UINT32;
+			addChunk( 0, 1, encoding, mesh.mIndices.size() );
+			payloads.push_back( encodeIndices( mesh.mIndices, encoding ) );
+		}
+
+		const std::tuple<geom::Attrib, uint8_t, const float*, size_t> attribs[] = {
+			{ geom::POSITION, mesh.mPositionsDims, mesh.mPositions.data(), mesh.mPositions.size() },
+			{ geom::COLOR, mesh.mColorsDims, mesh.mColors.data(), mesh.mColors.size() },
+			{ geom::NORMAL, mesh.mNormalsDims, (const float*)mesh.mNormals.data(), mesh.mNormals.size() * 3 },
+			{ geom::TEX_COORD_0, mesh.mTexCoords0Dims, mesh.mTexCoords0.data(), mesh.mTexCoords0.size() },
+			{ geom::TEX_COORD_1, mesh.mTexCoords1Dims, mesh.mTexCoords1.data(), mesh.mTexCoords1.size() },
+			{ geom::TEX_COORD_2, mesh.mTexCoords2Dims, mesh.mTexCoords2.data(), mesh.mTexCoords2.size() },
+			{ geom::TEX_COORD_3, mesh.mTexCoords3Dims, mesh.mTexCoords3.data(), mesh.mTexCoords3.size() },
+			{ geom::TANGENT, mesh.mTangentsDims, (const float*)mesh.mTangents.data(), mesh.mTangents.size() * 3 },
+			{ geom::BITANGENT, mesh.mBitangentsDims, (const float*)mesh.mBitangents.data(), mesh.mBitangents.size() * 3 },
+			{ geom::BONE_INDEX, mesh.mBoneIndicesDims, (const float*)mesh.mBoneIndices.data(), mesh.mBoneIndices.size() * 4 },
+			{ geom::BONE_WEIGHT, mesh.mBoneWeightsDims, (const float*)mesh.mBoneWeights.data(), mesh.mBoneWeights.size() * 4 }
+		};
+
+		for( const auto &[attrib, dims, data, numFloats] : attribs ) {
+			if( numFloats == 0 || dims == 0 || dims > 4 )
+				continue;
+			if( ! options.getAttribs().empty() && ! options.getAttribs().count( attrib ) )
+				continue;
+
+			ChunkEncoding encoding = ENCODING_FLOAT32;
+			if( attrib == geom::POSITION && options.getQuantizePositions() )
+				encoding = ENCODING_UNORM16;
+			else if( ( attrib == geom::NORMAL || attrib == geom::TANGENT || attrib == geom::BITANGENT ) && options.getQuantizeNormals() )
+				encoding = ENCODING_OCT16;
+			else if( ( attrib == geom::TEX_COORD_0 || attrib == geom::TEX_COORD_1 || attrib == geom::TEX_COORD_2 || attrib == geom::TEX_COORD_3 ) && options.getQuantizeTexCoords() )
+				encoding = ENCODING_FLOAT16;
+
+			Chunk *chunk = addChunk( toMask( attrib ), dims, encoding, numFloats / dims );
+			payloads.push_back( encodeVertices( data, chunk->mCount * dims, chunk ) );
+		}
+	}
+
+	// lay the chunks out after the table
+	uint64_t offset = sizeof( ChunkedHeader ) + chunks.size() * sizeof( Chunk );
+	for( size_t c = 0; c < chunks.size(); ++c ) {
+		offset = ( offset + 7 ) & ~7ull;
+		chunks[c].mOffset = offset;
+		chunks[c].mSize = payloads[c].size();
+		offset += chunks[c].mSize;
+	}
+
+	ChunkedHeader header = {};
+	header.mVersion = 3;
+	header.mNumChunks = (uint32_t)chunks.size();
+	header.mNumLods = (uint32_t)lods.size();
+
+	OStreamRef out = dataTarget->getStream();
+	out->writeData( &header, sizeof( header ) );
+	out->writeData( chunks.data(), chunks.size() * sizeof( Chunk ) );
+	const uint8_t padding[8] = {};
+	offset = sizeof( ChunkedHeader ) + chunks.size() * sizeof( Chunk );
+	for( size_t c = 0; c < chunks.size(); ++c ) {
+		out->writeData( padding, (size_t)( chunks[c].mOffset - offset ) );
+		out->writeData( payloads[c].data(), payloads[c].size() );
+		offset = chunks[c].mOffset + chunks[c].mSize;
+	}
+}
+
+size_t TriMesh::readNumLods( const DataSourceRef &dataSource )
+{
+	std::shared_ptr<const Buffer> buffer = loadBufferMapped( dataSource, MappedFile::ACCESS_RANDOM );
+	if( buffer->getSize() == 0 || *static_cast<const uint8_t*>( buffer->getData() ) != 3 )
+		return 1;
+
+	ChunkedHeader header;
+	readChunkTable( *buffer, &header );
+	return header.mNumLods;
+}
+
+// chunked and optionally quantized
+void TriMesh::readImplV3( const Buffer &buffer, const ReadOptions &options )
+{
+	ChunkedHeader header;
+	const Chunk *chunks = readChunkTable( buffer, &header );
+	if( options.getLod() >= header.mNumLods )
+		throw Exception( "TriMesh::read() error: level of detail " + std::to_string( options.getLod() ) + " requested from a file with " + std::to_string( header.mNumLods ) + "." );
+
+	initFromFormat( Format() );
+
+	const uint8_t *data = static_cast<const uint8_t*>( buffer.getData() );
+	for( uint32_t c = 0; c < header.mNumChunks; ++c ) {
+		const Chunk chunk = loadValue<Chunk>( reinterpret_cast<const uint8_t*>( chunks + c ) );
+		if( chunk.mLod != options.getLod() )
+			continue;
+		// every encoding takes at least a byte per element, which bounds the allocations below
+		if( chunk.mOffset > buffer.getSize() || chunk.mSize > buffer.getSize() - chunk.mOffset || chunk.mCount > chunk.mSize || chunk.mDims == 0 || chunk.mDims > 4 )
+			throw Exception( "TriMesh::read() error: Invalid file contents." );
+
+		bool valid;
+		if( chunk.mAttrib == 0 ) {
+			mIndices.resize( (size_t)chunk.mCount );
+			valid = decodeIndices( data + chunk.mOffset, chunk, mIndices.data() );
+		}
+		else {
+			const geom::Attrib attrib = fromMask( chunk.mAttrib );
+			if( ! options.getAttribs().empty() && ! options.getAttribs().count( attrib ) )
+				continue;
+
+			const size_t numFloats = (size_t)chunk.mCount * chunk.mDims;
+			float *result = nullptr;
+			switch( attrib ) {
+				case geom::POSITION:	mPositionsDims = chunk.mDims; mPositions.resize( numFloats ); result = mPositions.data(); break;
+				case geom::COLOR:		mColorsDims = chunk.mDims; mColors.resize( numFloats ); result = mColors.data(); break;
+				case geom::TEX_COORD_0:	mTexCoords0Dims = chunk.mDims; mTexCoords0.resize( numFloats ); result = mTexCoords0.data(); break;
+				case geom::TEX_COORD_1:	mTexCoords1Dims = chunk.mDims; mTexCoords1.resize( numFloats ); result = mTexCoords1.data(); break;
+				case geom::TEX_COORD_2:	mTexCoords2Dims = chunk.mDims; mTexCoords2.resize( numFloats ); result = mTexCoords2.data(); break;
+				case geom::TEX_COORD_3:	mTexCoords3Dims = chunk.mDims; mTexCoords3.resize( numFloats ); result = mTexCoords3.data(); break;
+				case geom::NORMAL:		if( chunk.mDims == 3 ) { mNormalsDims = 3; mNormals.resize( chunk.mCount ); result = (float*)mNormals.data(); } break;
+				case geom::TANGENT:		if( chunk.mDims == 3 ) { mTangentsDims = 3; mTangents.resize( chunk.mCount ); result = (float*)mTangents.data(); } break;
+				case geom::BITANGENT:	if( chunk.mDims == 3 ) { mBitangentsDims = 3; mBitangents.resize( chunk.mCount ); result = (float*)mBitangents.data(); } break;
+				case geom::BONE_INDEX:	if( chunk.mDims == 4 ) { mBoneIndicesDims = 4; mBoneIndices.resize( chunk.mCount ); result = (float*)mBoneIndices.data(); } break;
+				case geom::BONE_WEIGHT:	if( chunk.mDims == 4 ) { mBoneWeightsDims = 4; mBoneWeights.resize( chunk.mCount ); result = (float*)mBoneWeights.data(); } break;
+				default: break;
+			}
+			valid = result && decodeVertices( data + chunk.mOffset, chunk, result );
+		}
+
+		if( ! valid )
+			throw Exception( "TriMesh::read() error: Invalid file contents." );
+	}
+}
+
 // used in 0.9.0
 void TriMesh::readImplV2( const IStreamRef &in )
 {
@@ -139,6 +139,22 @@ std::vector<std::string> split( const std::string &str, const std::string &separ
 	return result;
 }
 
+std::string_view nextToken( std::string_view *str, std::string_view separators )
+{
+	const size_t begin = str->find_first_not_of( separators );
+	if( begin == std::string_view::npos ) {
+		*str = std::string_view();
+		return std::string_view();
+	}
+
+	size_t end = str->find_first_of( separators, begin );
+	if( end == std::string_view::npos )
+		end = str->size();
+	std::string_view result = str->substr( begin, end - begin );
+	str->remove_prefix( end );
+	return result;
+}
+
 string loadString( const DataSourceRef &dataSource )
 {
 	auto buffer = dataSource->getBuffer();
@@ -29,6 +29,10 @@
 #include "cinder/ImageSourceFileQoi.h"
 #include "cinder/ImageTargetFileQoi.h"
 #include "cinder/ImageFileTinyExr.h"
+#if defined( CINDER_PNG )
+	#include "cinder/ImageSourcePng.h"
+	#include "cinder/ImageTargetPng.h"
+#endif
 #include "cinder/Utilities.h"
 #include "cinder/Log.h"
 
@@ -64,6 +68,11 @@ PlatformLinux::PlatformLinux()
 	ImageTargetFileQoi::registerSelf();
 	ImageSourceFileTinyExr::registerSelf();
 	ImageTargetFileTinyExr::registerSelf();
+#if defined( CINDER_PNG )
+	// libpng decodes and encodes PNGs in bands, which takes priority over stb's whole-image codec
+	ImageSourcePng::registerSelf();
+	ImageTargetPng::registerSelf();
+#endif
 }
 
 PlatformLinux::~PlatformLinux()
@@ -84,55 +84,58 @@ void ChannelRouterNode::addInputRoute( const NodeRef &input, size_t inputChannel
 	route.mOutputChannelIndex = outputChannelIndex;
 	route.mNumChannels = numChannels;
 
+	// the route is compiled into the render schedule along with the connection
+	ScopedGraphEdit edit( getContext() );
 	input->connect( shared_from_this() );
-
-	lock_guard<mutex> lock( getContext()->getMutex() );
 	mRoutes.push_back( route );
 }
 
 void ChannelRouterNode::disconnectInput( const NodeRef &input )
 {
-	Node::disconnectInput( input );
-
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	ScopedGraphEdit edit( getContext() );
+	mRoutes.remove_if( [&input]( const Route &route ) { return route.mInput == input; } );
 
-	for( auto it = mRoutes.begin(); it != mRoutes.end(); ++it ) {
-		if( it->mInput == input ) {
-			mRoutes.erase( it );
-			return;
-		}
-	}
+	Node::disconnectInput( input );
 }
 
 void ChannelRouterNode::disconnectAllInputs()
 {
-	Node::disconnectAllInputs();
-
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	ScopedGraphEdit edit( getContext() );
 	mRoutes.clear();
+
+	Node::disconnectAllInputs();
 }
 
-void ChannelRouterNode::sumInputs()
+vector<Node::InputRoute> ChannelRouterNode::getInputRoutes() const
 {
-	BufferDynamic *summingBuffer = getSummingBuffer();
-	Buffer *internalBuffer = getInternalBuffer();
-
-	const size_t numFrames = internalBuffer->getNumFrames();
-	internalBuffer->zero(); // TODO: this will wipe out any feedback data. Avoid if possible.
-
-	for( auto &route : mRoutes ) {
-		NodeRef &input = route.mInput;
-
-		summingBuffer->setNumChannels( input->getNumChannels() );
-		input->pullInputs( summingBuffer );
-
-		const Buffer *processedBuffer = input->getProcessesInPlace() ? summingBuffer : input->getInternalBuffer();
-
-		for( size_t ch = 0; ch < route.mNumChannels; ch++ ) {
-			float *destChannel = internalBuffer->getChannel( ch + route.mOutputChannelIndex );
-			dsp::add( destChannel, processedBuffer->getChannel( ch + route.mInputChannelIndex ), destChannel, numFrames );
+	// routes from the same input are grouped, so that the input is only rendered once
+	vector<InputRoute> result;
+	for( auto it = mRoutes.begin(); it != mRoutes.end(); ++it ) {
+		bool grouped = false;
+		for( auto prevIt = mRoutes.begin(); prevIt != it; ++prevIt ) {
+			if( prevIt->mInput == it->mInput ) {
+				grouped = true;
+				break;
+			}
+		}
+		if( grouped )
+			continue;
+
+		for( auto routeIt = it; routeIt != mRoutes.end(); ++routeIt ) {
+			if( routeIt->mInput != it->mInput )
+				continue;
+
+			InputRoute inputRoute;
+			inputRoute.mInput = routeIt->mInput.get();
+			inputRoute.mSumAllChannels = false;
+			inputRoute.mInputChannelIndex = routeIt->mInputChannelIndex;
+			inputRoute.mOutputChannelIndex = routeIt->mOutputChannelIndex;
+			inputRoute.mNumChannels = routeIt->mNumChannels;
+			result.push_back( inputRoute );
 		}
 	}
+
+	return result;
 }
 
 } } // namespace cinder::audio
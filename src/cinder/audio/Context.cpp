@@ -25,11 +25,21 @@
 #include "cinder/audio/InputNode.h"
 #include "cinder/audio/Utilities.h"
 #include "cinder/audio/dsp/Converter.h"
+#include "cinder/audio/dsp/Dsp.h"
 
 #include "cinder/Cinder.h"
 #include "cinder/app/AppBase.h"
 
+#include <map>
 #include <sstream>
+#include <unordered_map>
+#include <unordered_set>
+
+#if defined( CINDER_MSW )
+	#include <windows.h>
+#else
+	#include <pthread.h>
+#endif
 
 #if defined( CINDER_COCOA )
 	#include "cinder/audio/cocoa/ContextAudioUnit.h"
@@ -61,6 +71,578 @@ namespace cinder { namespace audio {
 std::shared_ptr<Context>		Context::sMasterContext;
 std::unique_ptr<DeviceManager>	Context::sDeviceManager;
 
+// ----------------------------------------------------------------------------------------------------
+// RenderThreadPool (private)
+// ----------------------------------------------------------------------------------------------------
+
+namespace {
+
+// The Context whose tasks the current thread renders, if it is a RenderThreadPool worker.
+thread_local const Context *sRenderThreadContext = nullptr;
+
+// Gives \a thread the scheduling policy and priority of the calling thread. Best effort, without the privileges for real-time
+// scheduling the thread keeps its default priority.
+void copyThreadPriority( std::thread *thread )
+{
+#if defined( CINDER_MSW )
+	::SetThreadPriority( thread->native_handle(), ::GetThreadPriority( ::GetCurrentThread() ) );
+#else
+	int policy;
+	::sched_param param;
+	if( ::pthread_getschedparam( ::pthread_self(), &policy, &param ) == 0 )
+		::pthread_setschedparam( thread->native_handle(), policy, &param );
+#endif
+}
+
+} // anonymous namespace
+
+//! \brief Worker threads that help the audio thread render the independent tasks of a RenderSchedule.
+//!
+//! Each run() splits the tasks into one contiguous range per thread. Threads take tasks from the front of their own range and, once that
+//! is empty, steal from the back of the others', so that a few expensive tasks don't leave the remaining threads idle. run() returns once
+//! every task has finished, which is the barrier between the parallel part of a block and the summing that follows it.
+class RenderThreadPool {
+  public:
+	RenderThreadPool( const Context *context, size_t numThreads );
+	~RenderThreadPool();
+
+	size_t	getNumThreads() const	{ return mThreads.size(); }
+
+	//! Calls \a fn( \a data, i ) for i in [0, numTasks), on the worker threads and the calling thread.
+	void	run( size_t numTasks, void (*fn)( void *, size_t ), void *data );
+
+  private:
+	// A range of task indices [begin, end), packed so that the owner and thieves can take from either end with a single CAS.
+	struct alignas( 64 ) TaskRange {
+		std::atomic<uint64_t>	mRange { 0 };
+	};
+
+	void	workerLoop( size_t rangeIndex );
+	bool	runTasks( size_t rangeIndex );
+	bool	takeFront( TaskRange *range, size_t *task );
+	bool	takeBack( TaskRange *range, size_t *task );
+	void	runTask( size_t task );
+
+	static uint64_t	pack( uint64_t begin, uint64_t end )	{ return ( begin << 32 ) | end; }
+
+	std::vector<std::thread>				mThreads;
+	std::unique_ptr<TaskRange[]>			mRanges; // the calling thread's is last
+	const Context*							mContext;
+	std::atomic<void (*)( void *, size_t )>	mFn;
+	std::atomic<void *>						mData;
+	std::atomic<size_t>						mNumRemaining;
+	std::atomic<uint64_t>					mGeneration;
+	std::atomic<uint32_t>					mNumSleeping; // workers that may be blocked in mGeneration.wait()
+	std::atomic<bool>						mQuit;
+	std::thread::id							mPriorityThreadId; // the thread whose priority the workers were last given
+};
+
+RenderThreadPool::RenderThreadPool( const Context *context, size_t numThreads )
+	: mRanges( new TaskRange[numThreads + 1] ), mContext( context ), mFn( nullptr ), mData( nullptr ), mNumRemaining( 0 ), mGeneration( 0 ), mNumSleeping( 0 ), mQuit( false )
+{
+	for( size_t i = 0; i < numThreads; i++ )
+		mThreads.emplace_back( &RenderThreadPool::workerLoop, this, i );
+}
+
+RenderThreadPool::~RenderThreadPool()
+{
+	mQuit = true;
+	mGeneration.fetch_add( 1 );
+	mGeneration.notify_all();
+
+	for( auto &thread : mThreads )
+		thread.join();
+}
+
+void RenderThreadPool::run( size_t numTasks, void (*fn)( void *, size_t ), void *data )
+{
+	// the workers are created on a user thread, they take the priority of the device thread once it is known (and again if it changes)
+	if( mPriorityThreadId != std::this_thread::get_id() ) {
+		mPriorityThreadId = std::this_thread::get_id();
+		for( auto &thread : mThreads )
+			copyThreadPriority( &thread );
+	}
+
+	// The job is published by the range stores below, a thread that takes a task from them sees it.
+	mFn.store( fn, memory_order_relaxed );
+	mData.store( data, memory_order_relaxed );
+	mNumRemaining.store( numTasks, memory_order_relaxed );
+
+	const size_t numRanges = mThreads.size() + 1;
+	for( size_t i = 0; i < numRanges; i++ )
+		mRanges[i].mRange.store( pack( i * numTasks / numRanges, ( i + 1 ) * numTasks / numRanges ), memory_order_release );
+
+	// notifying is a system call, which is skipped while every worker is still spinning. Both sides are sequentially consistent, so
+	// either a worker about to sleep sees the new generation, or this thread sees that it is sleeping.
+	mGeneration.fetch_add( 1, memory_order_seq_cst );
+	if( mNumSleeping.load( memory_order_seq_cst ) != 0 )
+		mGeneration.notify_all();
+
+	runTasks( mThreads.size() );
+
+	// barrier: tasks stolen from this thread may still be running elsewhere
+	while( mNumRemaining.load( memory_order_acquire ) != 0 )
+		std::this_thread::yield();
+}
+
+void RenderThreadPool::workerLoop( size_t rangeIndex )
+{
+	sRenderThreadContext = mContext;
+
+	uint64_t generation = 0;
+	while( true ) {
+		// spin briefly, as the next block usually follows shortly, then sleep until it is published
+		for( int i = 0; i < 1000 && mGeneration.load( memory_order_acquire ) == generation; i++ )
+			std::this_thread::yield();
+
+		mNumSleeping.fetch_add( 1, memory_order_seq_cst );
+		mGeneration.wait( generation, memory_order_seq_cst );
+		mNumSleeping.fetch_sub( 1, memory_order_relaxed );
+		generation = mGeneration.load( memory_order_acquire );
+		if( mQuit )
+			break;
+
+		runTasks( rangeIndex );
+	}
+}
+
+// Returns once there are no tasks left to take, which may be before all have finished.
+bool RenderThreadPool::runTasks( size_t rangeIndex )
+{
+	const size_t numRanges = mThreads.size() + 1;
+	bool ranAny = false;
+	size_t task;
+	while( takeFront( &mRanges[rangeIndex], &task ) ) {
+		runTask( task );
+		ranAny = true;
+	}
+
+	for( size_t i = 1; i < numRanges; i++ ) {
+		TaskRange *victim = &mRanges[( rangeIndex + i ) % numRanges];
+		while( takeBack( victim, &task ) ) {
+			runTask( task );
+			ranAny = true;
+		}
+	}
+
+	return ranAny;
+}
+
+bool RenderThreadPool::takeFront( TaskRange *range, size_t *task )
+{
+	uint64_t current = range->mRange.load( memory_order_acquire );
+	while( true ) {
+		const uint64_t begin = current >> 32, end = current & 0xFFFFFFFF;
+		if( begin >= end )
+			return false;
+
+		if( range->mRange.compare_exchange_weak( current, pack( begin + 1, end ), memory_order_acq_rel, memory_order_acquire ) ) {
+			*task = (size_t)begin;
+			return true;
+		}
+	}
+}
+
+bool RenderThreadPool::takeBack( TaskRange *range, size_t *task )
+{
+	uint64_t current = range->mRange.load( memory_order_acquire );
+	while( true ) {
+		const uint64_t begin = current >> 32, end = current & 0xFFFFFFFF;
+		if( begin >= end )
+			return false;
+
+		if( range->mRange.compare_exchange_weak( current, pack( begin, end - 1 ), memory_order_acq_rel, memory_order_acquire ) ) {
+			*task = (size_t)end - 1;
+			return true;
+		}
+	}
+}
+
+void RenderThreadPool::runTask( size_t task )
+{
+	mFn.load( memory_order_relaxed )( mData.load( memory_order_relaxed ), task );
+	mNumRemaining.fetch_sub( 1, memory_order_acq_rel );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// RenderSchedule (private)
+// ----------------------------------------------------------------------------------------------------
+
+//! \brief The graph below a Node, flattened into an array of operations.
+//!
+//! Operations are in the order that a recursive pull of the graph would perform them. In-place chains that are summed into a Node render
+//! into buffer slots owned by the schedule, which are handed to the next chain as soon as the previous one has been summed, so that the
+//! same few buffers are reused across the entire graph.
+//!
+//! When compiled for parallel rendering, the inputs of a summing Node that share no Node's with the rest of the schedule become tasks,
+//! which render into buffers of their own on a RenderThreadPool. Their results are summed afterwards in the order of the inputs, so the
+//! output doesn't depend on which thread rendered what.
+struct RenderSchedule {
+	struct Op {
+		enum Type : uint8_t {
+			ZERO,			// zero mBuffer
+			PROCESS,		// mNode->process( mBuffer ) if mNode is enabled
+			MIX_INTERNAL,	// mix mNode's internal buffer into mBuffer
+			SUM_BEGIN,		// skip to mSkipTo if mNode was already processed this block, otherwise zero its summing buffer
+			SUM_INPUT,		// sum mBuffer into mNode's summing buffer, up or down mixing channels as needed
+			ROUTE_INPUT,	// add mNumChannels channels of mBuffer into mNode's summing buffer
+			SUM_END,		// mNode->sumInputs(), which by default process()es its summing buffer and mixes that into its internal buffer
+			RESULT,			// mix mNode's internal buffer into the rendered buffer, if they aren't the same
+			PARALLEL		// render mNumChannels tasks starting at mInputChannelIndex, then skip to mSkipTo
+		};
+
+		Type	mType;
+		Node*	mNode;
+		Buffer*	mBuffer; // nullptr stands for the buffer passed to render()
+		size_t	mSkipTo;
+		size_t	mInputChannelIndex, mOutputChannelIndex, mNumChannels;
+	};
+
+	//! A range of mOps that renders one input of a summing Node, without touching anything outside of it.
+	struct Task {
+		size_t	mBegin, mEnd;
+	};
+
+	//! Compiles the schedule for \a root. If \a parallel is true, inputs that don't reach any of \a serialNodes may be rendered as tasks.
+	RenderSchedule( Node *root, size_t framesPerBlock, bool parallel = false, const std::unordered_set<Node *> &serialNodes = {} );
+
+	void render( Buffer *buffer, uint64_t numProcessedFrames, RenderThreadPool *threadPool ) const;
+
+	std::vector<Op>							mOps;
+	std::vector<Task>						mTasks;
+	std::vector<std::unique_ptr<Buffer>>	mSlots;
+
+  private:
+	typedef std::map<size_t, std::vector<Buffer *>>	SlotPool; // by number of channels
+
+	struct CompileState {
+		size_t								mFramesPerBlock;
+		bool								mParallel, mInTask;
+		const std::unordered_set<Node *>*	mSerialNodes;
+		std::unordered_set<Node *>			mSummed, mInPlaceInProgress;
+		SlotPool							mFreeSlots;
+	};
+
+	void	renderOps( size_t begin, size_t end, Buffer *buffer, uint64_t numProcessedFrames, RenderThreadPool *threadPool ) const;
+	void	emitInPlace( Node *node, Buffer *buffer, CompileState *state );
+	void	emitSumming( Node *node, CompileState *state );
+	void	emitInput( Node *input, Buffer *slot );
+	void	emit( Op::Type type, Node *node, Buffer *buffer );
+	Buffer*	acquireSlot( size_t numChannels, CompileState *state );
+
+	std::vector<bool>	findParallelInputs( const std::vector<Node *> &inputs, const CompileState &state ) const;
+};
+
+RenderSchedule::RenderSchedule( Node *root, size_t framesPerBlock, bool parallel, const std::unordered_set<Node *> &serialNodes )
+{
+	CompileState state;
+	state.mFramesPerBlock = framesPerBlock;
+	state.mParallel = parallel;
+	state.mInTask = false;
+	state.mSerialNodes = &serialNodes;
+
+	if( root->mProcessInPlace )
+		emitInPlace( root, nullptr, &state );
+	else {
+		emitSumming( root, &state );
+		emit( Op::RESULT, root, nullptr );
+	}
+}
+
+// Renders node, and the in-place chain below it, into buffer.
+void RenderSchedule::emitInPlace( Node *node, Buffer *buffer, CompileState *state )
+{
+	if( ! node->mProcessInPlace ) {
+		emitSumming( node, state );
+		emit( Op::MIX_INTERNAL, node, buffer );
+		return;
+	}
+
+	// in-place Node's can't be part of a cycle, render silence rather than recursing forever if one is anyway
+	if( ! state->mInPlaceInProgress.insert( node ).second ) {
+		emit( Op::ZERO, nullptr, buffer );
+		return;
+	}
+
+	// in-place Node's have at most one input, which renders into the same buffer
+	if( node->mInputs.empty() )
+		emit( Op::ZERO, nullptr, buffer );
+	else
+		emitInPlace( node->mInputs.begin()->get(), buffer, state );
+
+	emit( Op::PROCESS, node, buffer );
+	state->mInPlaceInProgress.erase( node );
+}
+
+// Renders node into its internal buffer. Each input is rendered and then summed before moving on to the next, so that one slot serves all
+// in-place inputs. Inputs that are rendered as tasks are all rendered up front instead, each into a buffer of its own.
+void RenderSchedule::emitSumming( Node *node, CompileState *state )
+{
+	// Already summed earlier in this schedule, or this is a feedback loop that reads what node rendered last block.
+	if( ! state->mSummed.insert( node ).second )
+		return;
+
+	const size_t beginIndex = mOps.size();
+	emit( Op::SUM_BEGIN, node, nullptr );
+
+	// consecutive routes from the same input share its render
+	const auto routes = node->getInputRoutes();
+	std::vector<Node *> inputs;
+	std::vector<size_t> firstRoutes;
+	for( size_t i = 0; i < routes.size(); i++ ) {
+		if( inputs.empty() || routes[i].mInput != inputs.back() ) {
+			inputs.push_back( routes[i].mInput );
+			firstRoutes.push_back( i );
+		}
+	}
+	firstRoutes.push_back( routes.size() );
+
+	const auto parallelInputs = findParallelInputs( inputs, *state );
+	std::vector<Buffer *> inputBuffers( inputs.size(), nullptr );
+	SlotPool taskSlots;
+	if( ! parallelInputs.empty() ) {
+		const size_t parallelIndex = mOps.size();
+		emit( Op::PARALLEL, nullptr, nullptr );
+		mOps.back().mInputChannelIndex = mTasks.size();
+
+		// tasks render at the same time, so each gets a pool of slots that is only returned once all of them have been summed
+		SlotPool freeSlots;
+		freeSlots.swap( state->mFreeSlots );
+		state->mInTask = true;
+		for( size_t i = 0; i < inputs.size(); i++ ) {
+			if( ! parallelInputs[i] )
+				continue;
+
+			Task task;
+			task.mBegin = mOps.size();
+			if( inputs[i]->mProcessInPlace ) {
+				inputBuffers[i] = acquireSlot( inputs[i]->getNumChannels(), state );
+				emitInPlace( inputs[i], inputBuffers[i], state );
+				state->mFreeSlots[inputBuffers[i]->getNumChannels()].push_back( inputBuffers[i] );
+			}
+			else {
+				emitSumming( inputs[i], state );
+				inputBuffers[i] = &inputs[i]->mInternalBuffer;
+			}
+			task.mEnd = mOps.size();
+			mTasks.push_back( task );
+
+			for( auto &slots : state->mFreeSlots )
+				taskSlots[slots.first].insert( taskSlots[slots.first].end(), slots.second.begin(), slots.second.end() );
+			state->mFreeSlots.clear();
+		}
+		state->mInTask = false;
+		state->mFreeSlots.swap( freeSlots );
+
+		mOps[parallelIndex].mNumChannels = mTasks.size() - mOps[parallelIndex].mInputChannelIndex;
+		mOps[parallelIndex].mSkipTo = mOps.size();
+	}
+
+	for( size_t i = 0; i < inputs.size(); i++ ) {
+		Node *input = inputs[i];
+		Buffer *slot = nullptr;
+		Buffer *inputBuffer = inputBuffers[i];
+		if( ! inputBuffer ) {
+			if( input->mProcessInPlace ) {
+				slot = acquireSlot( input->getNumChannels(), state );
+				emitInPlace( input, slot, state );
+				inputBuffer = slot;
+			}
+			else {
+				emitSumming( input, state );
+				inputBuffer = &input->mInternalBuffer;
+			}
+		}
+
+		for( size_t r = firstRoutes[i]; r < firstRoutes[i + 1]; r++ ) {
+			const auto &route = routes[r];
+			emit( route.mSumAllChannels ? Op::SUM_INPUT : Op::ROUTE_INPUT, node, inputBuffer );
+			mOps.back().mInputChannelIndex = route.mInputChannelIndex;
+			mOps.back().mOutputChannelIndex = route.mOutputChannelIndex;
+			mOps.back().mNumChannels = route.mNumChannels;
+		}
+
+		if( slot )
+			state->mFreeSlots[slot->getNumChannels()].push_back( slot );
+	}
+
+	for( auto &slots : taskSlots )
+		state->mFreeSlots[slots.first].insert( state->mFreeSlots[slots.first].end(), slots.second.begin(), slots.second.end() );
+
+	emit( Op::SUM_END, node, nullptr );
+	mOps[beginIndex].mSkipTo = mOps.size();
+}
+
+// Returns which of inputs can be rendered as tasks, or an empty vector if fewer than two can. An input qualifies if none of the Node's it
+// reaches are reached by the other inputs or have been emitted already, and none of them are serial, such as those whose Params are
+// driven by a processor that other parts of the graph may evaluate as well. Parallel parts don't nest, tasks are rendered serially inside.
+std::vector<bool> RenderSchedule::findParallelInputs( const std::vector<Node *> &inputs, const CompileState &state ) const
+{
+	if( ! state.mParallel || state.mInTask || inputs.size() < 2 )
+		return {};
+
+	std::vector<std::unordered_set<Node *>> reached( inputs.size() );
+	std::unordered_map<Node *, size_t> numInputsReaching;
+	for( size_t i = 0; i < inputs.size(); i++ ) {
+		std::vector<Node *> stack = { inputs[i] };
+		while( ! stack.empty() ) {
+			Node *node = stack.back();
+			stack.pop_back();
+			if( ! reached[i].insert( node ).second )
+				continue;
+
+			numInputsReaching[node]++;
+			for( const auto &input : node->mInputs )
+				stack.push_back( input.get() );
+		}
+	}
+
+	std::vector<bool> result( inputs.size(), false );
+	size_t numParallel = 0;
+	for( size_t i = 0; i < inputs.size(); i++ ) {
+		bool independent = true;
+		for( Node *node : reached[i] ) {
+			if( numInputsReaching[node] > 1 || state.mSummed.count( node ) || state.mInPlaceInProgress.count( node ) || state.mSerialNodes->count( node ) ) {
+				independent = false;
+				break;
+			}
+		}
+
+		result[i] = independent;
+		if( independent )
+			numParallel++;
+	}
+
+	if( numParallel < 2 )
+		return {};
+
+	return result;
+}
+
+void RenderSchedule::emit( Op::Type type, Node *node, Buffer *buffer )
+{
+	Op op;
+	op.mType = type;
+	op.mNode = node;
+	op.mBuffer = buffer;
+	op.mSkipTo = 0;
+	op.mInputChannelIndex = op.mOutputChannelIndex = op.mNumChannels = 0;
+	mOps.push_back( op );
+}
+
+Buffer* RenderSchedule::acquireSlot( size_t numChannels, CompileState *state )
+{
+	auto &freeSlots = state->mFreeSlots[numChannels];
+	if( ! freeSlots.empty() ) {
+		Buffer *result = freeSlots.back();
+		freeSlots.pop_back();
+		return result;
+	}
+
+	mSlots.emplace_back( new Buffer( state->mFramesPerBlock, numChannels ) );
+	return mSlots.back().get();
+}
+
+void RenderSchedule::render( Buffer *buffer, uint64_t numProcessedFrames, RenderThreadPool *threadPool ) const
+{
+	renderOps( 0, mOps.size(), buffer, numProcessedFrames, threadPool );
+}
+
+void RenderSchedule::renderOps( size_t begin, size_t end, Buffer *buffer, uint64_t numProcessedFrames, RenderThreadPool *threadPool ) const
+{
+	for( size_t i = begin; i < end; i++ ) {
+		const Op &op = mOps[i];
+		Node *node = op.mNode;
+		Buffer *opBuffer = op.mBuffer ? op.mBuffer : buffer;
+
+		switch( op.mType ) {
+			case Op::ZERO:
+				opBuffer->zero();
+				break;
+			case Op::PROCESS:
+				if( node->mEnabled )
+					node->process( opBuffer );
+				break;
+			case Op::MIX_INTERNAL:
+				dsp::mixBuffers( &node->mInternalBuffer, opBuffer );
+				break;
+			case Op::SUM_BEGIN:
+				// Only process once per block, as the Node may have more than one output or be part of more than one schedule.
+				if( node->mLastProcessedFrame == numProcessedFrames ) {
+					i = op.mSkipTo - 1;
+					break;
+				}
+				node->mLastProcessedFrame = numProcessedFrames;
+				node->mSummingBuffer.zero();
+				break;
+			case Op::SUM_INPUT:
+				dsp::sumBuffers( opBuffer, &node->mSummingBuffer );
+				break;
+			case Op::ROUTE_INPUT: {
+				const size_t numFrames = node->mSummingBuffer.getNumFrames();
+				for( size_t ch = 0; ch < op.mNumChannels; ch++ ) {
+					float *destChannel = node->mSummingBuffer.getChannel( ch + op.mOutputChannelIndex );
+					dsp::add( destChannel, opBuffer->getChannel( ch + op.mInputChannelIndex ), destChannel, numFrames );
+				}
+				break;
+			}
+			case Op::SUM_END:
+				node->sumInputs();
+				break;
+			case Op::RESULT:
+				if( buffer != &node->mInternalBuffer )
+					dsp::mixBuffers( &node->mInternalBuffer, buffer );
+				break;
+			case Op::PARALLEL: {
+				// tasks only render into their own buffers, so they don't need the one passed in
+				const Task *tasks = &mTasks[op.mInputChannelIndex];
+				if( threadPool ) {
+					struct Job {
+						const RenderSchedule*	mSchedule;
+						const Task*				mTasks;
+						uint64_t				mNumProcessedFrames;
+					} job = { this, tasks, numProcessedFrames };
+
+					threadPool->run( op.mNumChannels, []( void *data, size_t index ) {
+						const Job *job = static_cast<const Job *>( data );
+						job->mSchedule->renderOps( job->mTasks[index].mBegin, job->mTasks[index].mEnd, nullptr, job->mNumProcessedFrames, nullptr );
+					}, &job );
+				}
+				else {
+					for( size_t t = 0; t < op.mNumChannels; t++ )
+						renderOps( tasks[t].mBegin, tasks[t].mEnd, nullptr, numProcessedFrames, nullptr );
+				}
+
+				i = op.mSkipTo - 1;
+				break;
+			}
+		}
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Context::Command, Context::RenderList (private)
+// ----------------------------------------------------------------------------------------------------
+
+struct Context::Command {
+	std::function<void ()>	mFunc;
+	std::atomic<Command *>	mNext { nullptr };
+};
+
+//! Everything the audio thread needs to know about the graph's connections, compiled on the user thread whenever they change.
+struct Context::RenderList {
+	struct Scheduled {
+		Node*							mNode;
+		std::unique_ptr<RenderSchedule>	mSchedule;
+	};
+
+	std::vector<NodeRef>	mNodes; // keeps the Node's alive for as long as the audio thread may render them
+	std::vector<Scheduled>	mSchedules; // one for each of mNodes, the directly pulled ones first
+	std::vector<Node *>		mAutoPulledNodes;
+	BufferDynamic			mAutoPullBuffer;
+	RenderList*				mNextRetired = nullptr;
+};
+
 bool sIsRegisteredForCleanup = false;
 
 // static
@@ -126,8 +708,12 @@ void Context::setMaster( Context *masterContext, DeviceManager *deviceManager )
 }
 
 Context::Context()
-	: mEnabled( false ), mAutoPullRequired( false ), mAutoPullCacheDirty( false ), mNumProcessedFrames( 0 ), mTimeDuringLastProcessLoop( -1.0 )
+	: mEnabled( false ), mNumProcessedFrames( 0 ), mTimeDuringLastProcessLoop( -1.0 ), mCommandStub( new Command ),
+		mRenderList( nullptr ), mPendingRenderList( nullptr ), mRenderListDirty( false ), mGraphEditDepth( 0 ), mGraphEditSuspended( false ),
+		mRetiredCommands( nullptr ), mRetiredRenderLists( nullptr )
 {
+	mCommandsHead = mCommandsTail = mCommandStub.get();
+
 	if( ! sIsRegisteredForCleanup )
 		registerClearStatics();
 }
@@ -135,8 +721,20 @@ Context::Context()
 Context::~Context()
 {
 	disable();
-	lock_guard<mutex> lock( mMutex );
-	uninitializeAllNodes();
+
+	{
+		ScopedGraphEdit edit( this );
+		suspendProcessingForGraphEdit();
+		uninitializeAllNodes();
+	}
+
+	// commands that never ran are discarded
+	while( Command *command = popCommand() )
+		delete command;
+
+	delete mRenderList;
+	delete mPendingRenderList.exchange( nullptr );
+	releaseRetired();
 }
 
 void Context::enable()
@@ -150,6 +748,13 @@ void Context::enable()
 	if( ! output->isInitialized() )
 		output->initializeImpl();
 
+	// connections made while disabled haven't been compiled yet
+	{
+		lock_guard<recursive_mutex> lock( mGraphEditMutex );
+		if( mRenderListDirty )
+			compileRenderList();
+	}
+
 	mEnabled = true;
 	getOutput()->enable();
 }
@@ -179,6 +784,7 @@ void Context::connectionsDidChange( const NodeRef & /*node*/ )
 
 void Context::initializeAllNodes()
 {
+	ScopedGraphEdit edit( this );
 	set<NodeRef> traversedNodes;
 	initRecursisve( mOutput, traversedNodes );
 
@@ -188,6 +794,9 @@ void Context::initializeAllNodes()
 
 void Context::uninitializeAllNodes()
 {
+	ScopedGraphEdit edit( this );
+	suspendProcessingForGraphEdit();
+
 	set<NodeRef> traversedNodes;
 	uninitRecursive( mOutput, traversedNodes );
 
@@ -197,6 +806,7 @@ void Context::uninitializeAllNodes()
 
 void Context::disconnectAllNodes()
 {
+	ScopedGraphEdit edit( this );
 	set<NodeRef> traversedNodes;
 	disconnectRecursive( mOutput, traversedNodes );
 
@@ -206,6 +816,9 @@ void Context::disconnectAllNodes()
 
 void Context::setOutput( const OutputNodeRef &output )
 {
+	ScopedGraphEdit edit( this );
+	suspendProcessingForGraphEdit();
+
 	if( mOutput ) {
 		if( output && mOutput->getOutputFramesPerBlock() != output->getOutputFramesPerBlock() || mOutput->getOutputSampleRate() != output->getOutputSampleRate() ) {
 			// params changed used in sizing buffers, uninit all connected nodes so they can reconfigure
@@ -282,7 +895,26 @@ void Context::uninitRecursive( const NodeRef &node, set<NodeRef> &traversedNodes
 
 bool Context::isAudioThread() const
 {
-	return mAudioThreadId == std::this_thread::get_id();
+	return mAudioThreadId.load() == std::this_thread::get_id() || sRenderThreadContext == this;
+}
+
+void Context::setNumRenderThreads( size_t numThreads )
+{
+	if( getNumRenderThreads() == numThreads )
+		return;
+
+	// the audio thread may be waiting on the current workers, and schedules are recompiled for the new ones when the edit ends
+	ScopedGraphEdit edit( this );
+	suspendProcessingForGraphEdit();
+
+	mRenderThreadPool.reset();
+	if( numThreads > 0 )
+		mRenderThreadPool.reset( new RenderThreadPool( this, numThreads ) );
+}
+
+size_t Context::getNumRenderThreads() const
+{
+	return mRenderThreadPool ? mRenderThreadPool->getNumThreads() : 0;
 }
 
 void Context::preProcess()
@@ -290,6 +922,8 @@ void Context::preProcess()
 	mProcessTimer.start();
 	mAudioThreadId = std::this_thread::get_id();
 
+	processCommands();
+	adoptRenderList();
 	preProcessScheduledEvents();
 }
 
@@ -301,6 +935,9 @@ void Context::postProcess()
 
 	mProcessTimer.stop();
 	mTimeDuringLastProcessLoop = mProcessTimer.getSeconds();
+
+	// between blocks the rendering thread counts as a user thread, which matters when it also makes the edits (ex. offline rendering)
+	mAudioThreadId = std::thread::id();
 }
 
 void Context::incrementFrameCount()
@@ -314,47 +951,316 @@ void Context::incrementFrameCount()
 
 void Context::addAutoPulledNode( const NodeRef &node )
 {
+	ScopedGraphEdit edit( this );
 	mAutoPulledNodes.insert( node );
-	mAutoPullRequired = true;
-	mAutoPullCacheDirty = true;
-
-	// if not done already, allocate a buffer for auto-pulling that is large enough for stereo processing
-	size_t framesPerBlock = getFramesPerBlock();
-	if( mAutoPullBuffer.getNumFrames() < framesPerBlock )
-		mAutoPullBuffer.setSize( framesPerBlock, 2 );
 }
 
 void Context::removeAutoPulledNode( const NodeRef &node )
 {
+	ScopedGraphEdit edit( this );
 	size_t result = mAutoPulledNodes.erase( node );
 	CI_VERIFY( result );
-
-	mAutoPullCacheDirty = true;
-	if( mAutoPulledNodes.empty() )
-		mAutoPullRequired = false;
 }
 
 void Context::processAutoPulledNodes()
 {
-	if( ! mAutoPullRequired )
+	if( ! mRenderList || mRenderList->mAutoPulledNodes.empty() )
 		return;
 
-	for( Node *node : getAutoPulledNodes() ) {
-		mAutoPullBuffer.setNumChannels( node->getNumChannels() );
-		node->pullInputs( &mAutoPullBuffer );
-		if( ! node->getProcessesInPlace() )
-			dsp::mixBuffers( node->getInternalBuffer(), &mAutoPullBuffer );
+	BufferDynamic *buffer = &mRenderList->mAutoPullBuffer;
+	for( Node *node : mRenderList->mAutoPulledNodes ) {
+		buffer->setNumChannels( node->getNumChannels() );
+		renderSchedule( node->mRenderSchedule, buffer );
 	}
 }
 
+void Context::renderSchedule( const RenderSchedule *schedule, Buffer *buffer )
+{
+	// Node's without a schedule aren't connected to the output, an auto-pulled Node or a Param
+	if( schedule )
+		schedule->render( buffer, mNumProcessedFrames, mRenderThreadPool.get() );
+	else
+		buffer->zero();
+}
+
 const std::vector<Node *>& Context::getAutoPulledNodes()
 {
-	if( mAutoPullCacheDirty ) {
-		mAutoPullCache.clear();
-		for( const NodeRef &node : mAutoPulledNodes )
-			mAutoPullCache.push_back( node.get() );
+	static const std::vector<Node *> sNoNodes;
+	return mRenderList ? mRenderList->mAutoPulledNodes : sNoNodes;
+}
+
+void Context::setParamProcessor( const Param *param, const NodeRef &node )
+{
+	ScopedGraphEdit edit( this );
+	if( node )
+		mParamProcessors[param] = node;
+	else
+		mParamProcessors.erase( param );
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Commands
+// ----------------------------------------------------------------------------------------------------
+
+void Context::submitCommand( std::function<void ()> command )
+{
+	// render threads count as the audio thread, but run alongside it in the middle of a block, so their commands are queued
+	const bool renderThread = sRenderThreadContext == this;
+	if( isAudioThread() && ! renderThread ) {
+		command();
+		return;
+	}
+
+	if( ! mEnabled && ! renderThread ) {
+		// Nothing should be processing, but a block may still be finishing as the output is disabled. Other user threads are kept
+		// out by the edit mutex, so mGraphEditSuspended can only have been set by this one. Earlier commands that are still pending
+		// run first, so that the order is kept.
+		lock_guard<recursive_mutex> editLock( mGraphEditMutex );
+		unique_lock<mutex> lock( mMutex, defer_lock );
+		if( ! mGraphEditSuspended )
+			lock.lock();
+
+		processCommands();
+		command();
+		return;
+	}
+
+	auto result = new Command;
+	result->mFunc = std::move( command );
+	pushCommand( result );
+
+	// retired commands are left for a user thread to destroy
+	if( ! renderThread )
+		releaseRetired();
+}
+
+// Commands form an intrusive multiple producer / single consumer queue (see Dmitry Vyukov's 'Intrusive MPSC node-based queue'),
+// so pushing never waits and popping never allocates. mCommandStub keeps the queue non-empty.
+void Context::pushCommand( Command *command )
+{
+	command->mNext.store( nullptr, memory_order_relaxed );
+	Command *prev = mCommandsHead.exchange( command, memory_order_acq_rel );
+	prev->mNext.store( command, memory_order_release );
+}
+
+Context::Command* Context::popCommand()
+{
+	Command *tail = mCommandsTail;
+	Command *next = tail->mNext.load( memory_order_acquire );
+	if( tail == mCommandStub.get() ) {
+		if( ! next )
+			return nullptr;
+
+		mCommandsTail = tail = next;
+		next = next->mNext.load( memory_order_acquire );
+	}
+
+	if( next ) {
+		mCommandsTail = next;
+		return tail;
+	}
+
+	// a producer is between swapping the head and linking its command, which will be picked up next time
+	if( tail != mCommandsHead.load( memory_order_acquire ) )
+		return nullptr;
+
+	pushCommand( mCommandStub.get() );
+	next = tail->mNext.load( memory_order_acquire );
+	if( next ) {
+		mCommandsTail = next;
+		return tail;
+	}
+
+	return nullptr;
+}
+
+// Runs on the audio thread, or on a user thread holding mGraphEditMutex and mMutex when this Context is disabled.
+void Context::processCommands()
+{
+	const bool audioThread = isAudioThread();
+	while( Command *command = popCommand() ) {
+		command->mFunc();
+
+		if( audioThread ) {
+			// hand the command back to the user thread to be destroyed, along with anything it owns
+			Command *retired = mRetiredCommands.load( memory_order_relaxed );
+			do {
+				command->mNext.store( retired, memory_order_relaxed );
+			} while( ! mRetiredCommands.compare_exchange_weak( retired, command, memory_order_release, memory_order_relaxed ) );
+		}
+		else
+			delete command;
+	}
+}
+
+void Context::releaseRetired()
+{
+	Command *command = mRetiredCommands.exchange( nullptr, memory_order_acquire );
+	while( command ) {
+		Command *next = command->mNext.load( memory_order_relaxed );
+		delete command;
+		command = next;
+	}
+
+	RenderList *renderList = mRetiredRenderLists.exchange( nullptr, memory_order_acquire );
+	while( renderList ) {
+		RenderList *next = renderList->mNextRetired;
+		delete renderList;
+		renderList = next;
+	}
+}
+
+// ----------------------------------------------------------------------------------------------------
+// Render List
+// ----------------------------------------------------------------------------------------------------
+
+// Edits from different user threads are serialized by mGraphEditMutex, which is held until the outermost ScopedGraphEdit ends.
+// The audio thread never takes it, so it can't be silenced by an edit that doesn't suspend processing.
+void Context::beginGraphEdit()
+{
+	mGraphEditMutex.lock();
+	mGraphEditDepth++;
+}
+
+void Context::endGraphEdit()
+{
+	CI_ASSERT( mGraphEditDepth > 0 );
+	if( --mGraphEditDepth > 0 ) {
+		mGraphEditMutex.unlock();
+		return;
+	}
+
+	// while disabled, compiling waits until enable() so that building a large graph doesn't compile it once per connection
+	if( mEnabled )
+		compileRenderList();
+	else
+		mRenderListDirty = true;
+
+	if( mGraphEditSuspended ) {
+		mGraphEditSuspended = false;
+		mMutex.unlock();
+	}
+
+	releaseRetired();
+	mGraphEditMutex.unlock();
+}
+
+void Context::suspendProcessingForGraphEdit()
+{
+	CI_ASSERT_MSG( mGraphEditDepth > 0 || isAudioThread(), "must be called within the scope of a ScopedGraphEdit" );
+
+	// the audio thread already holds the mutex while processing
+	if( mGraphEditSuspended || isAudioThread() )
+		return;
+
+	mMutex.lock();
+	mGraphEditSuspended = true;
+}
+
+void Context::compileRenderList()
+{
+	mRenderListDirty = false;
+
+	unique_ptr<RenderList> renderList( new RenderList );
+
+	// the Node's that the audio thread pulls directly
+	vector<NodeRef> roots;
+	if( mOutput )
+		roots.push_back( mOutput );
+	for( const auto &node : mAutoPulledNodes ) {
+		roots.push_back( node );
+		renderList->mAutoPulledNodes.push_back( node.get() );
+	}
+	for( const auto &processor : mParamProcessors )
+		roots.push_back( processor.second );
+
+	unordered_set<Node *> visited;
+	vector<NodeRef> stack = roots;
+	while( ! stack.empty() ) {
+		NodeRef node = std::move( stack.back() );
+		stack.pop_back();
+		if( ! visited.insert( node.get() ).second )
+			continue;
+
+		for( const auto &input : node->mInputs )
+			stack.push_back( input );
+
+		renderList->mNodes.push_back( std::move( node ) );
+	}
+
+	// A Param processor is rendered by whichever thread evaluates its Param, so Node's with such Params and the processors themselves
+	// are rendered on the audio thread.
+	unordered_set<Node *> serialNodes;
+	if( mRenderThreadPool ) {
+		for( const auto &processor : mParamProcessors ) {
+			serialNodes.insert( processor.first->mParentNode );
+
+			vector<Node *> processorStack = { processor.second.get() };
+			while( ! processorStack.empty() ) {
+				Node *node = processorStack.back();
+				processorStack.pop_back();
+				if( serialNodes.insert( node ).second ) {
+					for( const auto &input : node->mInputs )
+						processorStack.push_back( input.get() );
+				}
+			}
+		}
+	}
+
+	// buffers are sized by the output, without which nothing is rendered
+	if( mOutput ) {
+		const size_t framesPerBlock = mOutput->getOutputFramesPerBlock();
+
+		// only the output's schedule is rendered in parallel, the others are small in comparison
+		unordered_set<Node *> scheduled;
+		for( const auto &root : roots ) {
+			if( scheduled.insert( root.get() ).second ) {
+				const bool parallel = mRenderThreadPool && root == mOutput;
+				renderList->mSchedules.push_back( { root.get(), unique_ptr<RenderSchedule>( new RenderSchedule( root.get(), framesPerBlock, parallel, serialNodes ) ) } );
+			}
+		}
+
+		// the rest of the graph is scheduled as well, for Node's that pull some part of it themselves from within process()
+		for( const auto &node : renderList->mNodes ) {
+			if( scheduled.insert( node.get() ).second )
+				renderList->mSchedules.push_back( { node.get(), unique_ptr<RenderSchedule>( new RenderSchedule( node.get(), framesPerBlock ) ) } );
+		}
+
+		// allocate a buffer for auto-pulling that is large enough for stereo processing
+		if( ! renderList->mAutoPulledNodes.empty() ) {
+			size_t numChannels = 2;
+			for( Node *node : renderList->mAutoPulledNodes )
+				numChannels = max( numChannels, node->getNumChannels() );
+
+			renderList->mAutoPullBuffer.setSize( framesPerBlock, numChannels );
+		}
+	}
+
+	// a list the audio thread hasn't swapped in yet is replaced
+	delete mPendingRenderList.exchange( renderList.release(), memory_order_acq_rel );
+}
+
+void Context::adoptRenderList()
+{
+	RenderList *renderList = mPendingRenderList.exchange( nullptr, memory_order_acquire );
+	if( ! renderList )
+		return;
+
+	if( mRenderList ) {
+		// Node's that were dropped from the graph lose their schedule
+		for( auto &scheduled : mRenderList->mSchedules )
+			scheduled.mNode->mRenderSchedule = nullptr;
+
+		RenderList *retired = mRetiredRenderLists.load( memory_order_relaxed );
+		do {
+			mRenderList->mNextRetired = retired;
+		} while( ! mRetiredRenderLists.compare_exchange_weak( retired, mRenderList, memory_order_release, memory_order_relaxed ) );
 	}
-	return mAutoPullCache;
+
+	for( auto &scheduled : renderList->mSchedules )
+		scheduled.mNode->mRenderSchedule = scheduled.mSchedule.get();
+
+	mRenderList = renderList;
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -375,30 +1281,36 @@ void Context::scheduleEvent( double when, const NodeRef &node, bool callFuncBefo
 		cancelScheduledEvents( node );
 	}
 
-	lock_guard<mutex> lock( mMutex );
 	node->mEventScheduled = true;
-	mScheduledEvents.push_back( ScheduledEvent( eventFrameThreshold, node, callFuncBeforeProcess, func ) );
+
+	// the list node is allocated here, so that the audio thread only needs to splice it in
+	list<ScheduledEvent> event;
+	event.push_back( ScheduledEvent( eventFrameThreshold, node, callFuncBeforeProcess, func ) );
+	submitCommand( [this, event]() mutable {
+		mScheduledEvents.splice( mScheduledEvents.end(), event );
+	} );
 }
 
 void Context::cancelScheduledEvents( const NodeRef &node )
 {
-	lock_guard<mutex> lock( mMutex );
-
-	for( auto eventIt = mScheduledEvents.begin(); eventIt != mScheduledEvents.end(); ++eventIt ) {
-		if( eventIt->mNode == node ) {
-			// reset process frame range to an entire block
-			auto &range = eventIt->mNode->mProcessFramesRange;
-			range.first = 0;
-			range.second = getFramesPerBlock();
-
-			eventIt->mNode->mEventScheduled = false;
-			mScheduledEvents.erase( eventIt );
-			break;
+	node->mEventScheduled = false;
+
+	submitCommand( [this, node] {
+		for( auto eventIt = mScheduledEvents.begin(); eventIt != mScheduledEvents.end(); ++eventIt ) {
+			if( eventIt->mNode == node ) {
+				// reset process frame range to an entire block
+				auto &range = eventIt->mNode->mProcessFramesRange;
+				range.first = 0;
+				range.second = getFramesPerBlock();
+
+				mScheduledEvents.erase( eventIt );
+				break;
+			}
 		}
-	}
+	} );
 }
 
-// note: we should be synchronized with mMutex by the OutputDeviceNode impl, so mScheduledEvents is safe to modify
+// note: mScheduledEvents is only modified on the audio thread, by commands and while processing
 void Context::preProcessScheduledEvents()
 {
 	const uint64_t framesPerBlock = (uint64_t)getFramesPerBlock();
@@ -495,6 +1407,23 @@ string Context::printGraphToString()
 	return stream.str();
 }
 
+// ----------------------------------------------------------------------------------------------------
+// ScopedGraphEdit
+// ----------------------------------------------------------------------------------------------------
+
+ScopedGraphEdit::ScopedGraphEdit( Context *context )
+	: mContext( context && ! context->isAudioThread() ? context : nullptr )
+{
+	if( mContext )
+		mContext->beginGraphEdit();
+}
+
+ScopedGraphEdit::~ScopedGraphEdit()
+{
+	if( mContext )
+		mContext->endGraphEdit();
+}
+
 // ----------------------------------------------------------------------------------------------------
 // ScopedEnableContext
 // ----------------------------------------------------------------------------------------------------
@@ -78,9 +78,9 @@ void DelayNode::setMaxDelaySeconds( float seconds )
 
 void DelayNode::clearBuffer()
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-
-	mDelayBuffer.zero();
+	submitCommand( [this] {
+		mDelayBuffer.zero();
+	} );
 }
 
 void DelayNode::initialize()
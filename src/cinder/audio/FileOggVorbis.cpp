@@ -65,7 +65,7 @@ void SourceFileOggVorbis::init()
 {
 	CI_ASSERT( mDataSource );
 #if ! defined( CINDER_ANDROID )
-	if( mDataSource->isFilePath() ) {
+	if( mDataSource->isFilePath() && ! mDataSource->isMapped() ) {
 		int status = ov_fopen( mDataSource->getFilePath().string().c_str(), &mOggVorbisFile );
 		if( status )
 			throw AudioFileExc( string( "Failed to open Ogg Vorbis file with error: " ), (int32_t)status );
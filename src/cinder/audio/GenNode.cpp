@@ -63,9 +63,9 @@ void GenNode::initialize()
 
 void GenNode::setPhase( float phase )
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-
-	mPhase = phase;
+	submitCommand( [this, phase] {
+		mPhase = phase;
+	} );
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -262,11 +262,14 @@ void GenOscNode::setWaveform( WaveformType waveformType )
 	if( ! isInitialized() )
 		getContext()->initializeNode( shared_from_this() );
 
-	// TODO: to prevent the entire graph from blocking, use our own lock and tryLock / fail when blocked in process()
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	// fill a new table here and swap it in on the audio thread, the old table is destroyed along with the command.
+	WaveTable2dRef waveTable( new WaveTable2d( mWaveTable->getSampleRate(), mWaveTable->getTableSize(), mWaveTable->getNumTables() ) );
+	waveTable->fillBandlimited( waveformType );
 
 	mWaveformType = waveformType;
-	mWaveTable->fillBandlimited( waveformType );
+	submitCommand( [this, waveTable]() mutable {
+		mWaveTable.swap( waveTable );
+	} );
 }
 
 void GenOscNode::process( Buffer *buffer )
@@ -42,7 +42,8 @@ namespace cinder { namespace audio {
 
 Node::Node( const Format &format )
 	: mInitialized( false ), mEnabled( false ), mEventScheduled( false ), mChannelMode( format.getChannelMode() ),
-		mNumChannels( 1 ), mAutoEnabled( true ), mProcessInPlace( true ), mLastProcessedFrame( numeric_limits<uint64_t>::max() )
+		mNumChannels( 1 ), mAutoEnabled( true ), mProcessInPlace( true ), mLastProcessedFrame( numeric_limits<uint64_t>::max() ),
+		mRenderSchedule( nullptr )
 {
 	if( format.getChannels() ) {
 		mNumChannels = format.getChannels();
@@ -62,6 +63,7 @@ void Node::connect( const NodeRef &output )
 	// make a reference to ourselves so that we aren't deallocated in the case of the last owner
 	// disconnecting us, which we may need later anyway
 	NodeRef thisRef = shared_from_this();
+	ScopedGraphEdit edit( getContext() );
 
 	if( ! output || ! output->canConnectToInput( thisRef ) )
 		return;
@@ -80,6 +82,8 @@ void Node::disconnect( const NodeRef &output )
 	if( ! output )
 		return;
 
+	ScopedGraphEdit edit( getContext() );
+
 	for( auto weakOutIt = mOutputs.begin(); weakOutIt != mOutputs.end(); ++weakOutIt ) {
 		if( weakOutIt->lock() == output ) {
 			mOutputs.erase( weakOutIt );
@@ -100,6 +104,7 @@ void Node::disconnectAll()
 void Node::disconnectAllOutputs()
 {
 	NodeRef thisRef = shared_from_this();
+	ScopedGraphEdit edit( getContext() );
 
 	auto outputs = getOutputs(); // first make a copy of only the still-alive NodeRef's
 	for( const auto &output : outputs )
@@ -109,6 +114,7 @@ void Node::disconnectAllOutputs()
 void Node::disconnectAllInputs()
 {
 	NodeRef thisRef = shared_from_this();
+	ScopedGraphEdit edit( getContext() );
 
 	for( auto &input : mInputs )
 		input->disconnectOutput( thisRef );
@@ -123,7 +129,7 @@ void Node::connectInput( const NodeRef &input )
 	if( ! ctx )
 		return;
 
-	lock_guard<mutex> lock( ctx->getMutex() );
+	ScopedGraphEdit edit( ctx );
 
 	mInputs.insert( input );
 	configureConnections();
@@ -135,7 +141,7 @@ void Node::disconnectInput( const NodeRef &input )
 	if( ! ctx )
 		return;
 
-	lock_guard<mutex> lock( ctx->getMutex() );
+	ScopedGraphEdit edit( ctx );
 
 	for( auto inIt = mInputs.begin(); inIt != mInputs.end(); ++inIt ) {
 		if( *inIt == input ) {
@@ -151,8 +157,6 @@ void Node::disconnectOutput( const NodeRef &output )
 	if( ! ctx )
 		return;
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
 	for( auto outIt = mOutputs.begin(); outIt != mOutputs.end(); ++outIt ) {
 		if( outIt->lock() == output ) {
 			mOutputs.erase( outIt );
@@ -299,6 +303,12 @@ void Node::setNumChannels( size_t numChannels )
 	if( mNumChannels == numChannels )
 		return;
 
+	// an initialized Node may be processing, so the audio thread has to wait for the new channel count until the Node is reconfigured.
+	auto ctx = getContext();
+	ScopedGraphEdit edit( ctx );
+	if( mInitialized && ctx )
+		ctx->suspendProcessingForGraphEdit();
+
 	uninitializeImpl();
 	mNumChannels = numChannels;
 }
@@ -352,6 +362,7 @@ void Node::configureConnections()
 {
 	CI_ASSERT( getContext() );
 
+	ScopedGraphEdit edit( getContext() );
 	mProcessInPlace = supportsProcessInPlace();
 
 	if( getNumConnectedInputs() > 1 || getNumConnectedOutputs() > 1 )
@@ -415,40 +426,11 @@ void Node::configureConnections()
 	initializeImpl();
 }
 
-void Node::pullInputs( Buffer *inPlaceBuffer )
+void Node::pullInputs( Buffer *buffer )
 {
 	CI_ASSERT( getContext() );
 
-	if( mProcessInPlace ) {
-		if( mInputs.empty() ) {
-			// Fastest route: no inputs and process in-place. inPlaceBuffer must be cleared so that samples left over
-			// from InputNode's that aren't filling the entire buffer are zero.
-			inPlaceBuffer->zero();
-			if( mEnabled )
-				process( inPlaceBuffer );
-		}
-		else {
-			// First pull the input (can only be one when in-place), then run process() if input did any processing.
-			const NodeRef &input = *mInputs.begin();
-			input->pullInputs( inPlaceBuffer );
-
-			if( ! input->getProcessesInPlace() )
-				dsp::mixBuffers( input->getInternalBuffer(), inPlaceBuffer );
-
-			if( mEnabled )
-				process( inPlaceBuffer );
-		}
-	}
-	else {
-		// Pull and sum all enabled inputs. Only do this once per processing block, which is checked by the current number of processed frames.
-		uint64_t numProcessedFrames = getContext()->getNumProcessedFrames();
-		if( mLastProcessedFrame != numProcessedFrames ) {
-			mLastProcessedFrame = numProcessedFrames;
-
-			mSummingBuffer.zero();
-			sumInputs();
-		}
-	}
+	getContext()->renderSchedule( mRenderSchedule, buffer );
 }
 
 void Node::process( Buffer * /*buffer*/ )
@@ -457,15 +439,6 @@ void Node::process( Buffer * /*buffer*/ )
 
 void Node::sumInputs()
 {
-	// Pull all inputs, summing the results from the buffer that input used for processing.
-	// mInternalBuffer is not zero'ed before pulling inputs to allow for feedback.
-	for( auto &input : mInputs ) {
-		input->pullInputs( &mInternalBuffer );
-		const Buffer *processedBuffer = input->getProcessesInPlace() ? &mInternalBuffer : input->getInternalBuffer();
-		dsp::sumBuffers( processedBuffer, &mSummingBuffer );
-	}
-
-	// Process the summed results if enabled.
 	if( mEnabled )
 		process( &mSummingBuffer );
 
@@ -473,13 +446,44 @@ void Node::sumInputs()
 	dsp::mixBuffers( &mSummingBuffer, &mInternalBuffer );
 }
 
+void Node::submitCommand( function<void ()> command )
+{
+	auto ctx = getContext();
+	if( ! ctx ) {
+		command();
+		return;
+	}
+
+	ctx->submitCommand( [thisRef = shared_from_this(), command = std::move( command )] { command(); } );
+}
+
+vector<Node::InputRoute> Node::getInputRoutes() const
+{
+	vector<InputRoute> result;
+	for( const auto &input : mInputs ) {
+		InputRoute route;
+		route.mInput = input.get();
+		result.push_back( route );
+	}
+
+	return result;
+}
+
 void Node::setupProcessWithSumming()
 {
 	CI_ASSERT( getContext() );
 
+	auto ctx = getContext();
+	ScopedGraphEdit edit( ctx );
 	mProcessInPlace = false;
 	size_t framesPerBlock = getFramesPerBlock();
 
+	if( mSummingBuffer.getNumFrames() == framesPerBlock && mSummingBuffer.getNumChannels() == mNumChannels && mInternalBuffer.getSize() == mSummingBuffer.getSize() )
+		return;
+
+	// the buffers may be in use on the audio thread if this Node is already summing
+	ctx->suspendProcessingForGraphEdit();
+
 	mInternalBuffer.setSize( framesPerBlock, mNumChannels );
 	mSummingBuffer.setSize( framesPerBlock, mNumChannels );
 }
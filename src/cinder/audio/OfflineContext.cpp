@@ -0,0 +1,111 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/audio/OfflineContext.h"
+#include "cinder/audio/Exception.h"
+
+#include <algorithm>
+#include <cstring>
+
+using namespace std;
+
+namespace cinder { namespace audio {
+
+OfflineContextRef OfflineContext::create( size_t sampleRate, size_t framesPerBlock, size_t numChannels )
+{
+	OfflineContextRef result( new OfflineContext );
+	result->setOutput( result->makeNode( new OutputNodeOffline( sampleRate, framesPerBlock, Node::Format().channels( numChannels ) ) ) );
+
+	return result;
+}
+
+OfflineContext::OfflineContext()
+	: mNumFramesLeftInBlock( 0 )
+{
+}
+
+OutputDeviceNodeRef OfflineContext::createOutputDeviceNode( const DeviceRef & /*device*/, const Node::Format & /*format*/ )
+{
+	throw AudioContextExc( "OfflineContext can not create device Node's." );
+}
+
+InputDeviceNodeRef OfflineContext::createInputDeviceNode( const DeviceRef & /*device*/, const Node::Format & /*format*/ )
+{
+	throw AudioContextExc( "OfflineContext can not create device Node's." );
+}
+
+void OfflineContext::setOutput( const OutputNodeRef &output )
+{
+	auto outputOffline = dynamic_pointer_cast<OutputNodeOffline>( output );
+	if( ! outputOffline )
+		throw AudioContextExc( "OfflineContext requires an OutputNodeOffline." );
+
+	Context::setOutput( output );
+
+	mOutputOffline = outputOffline;
+	mNumFramesLeftInBlock = 0;
+}
+
+void OfflineContext::render( size_t numFrames, BufferDynamic *buffer )
+{
+	buffer->setSize( numFrames, mOutputOffline->getNumChannels() );
+
+	size_t bufferFrame = 0;
+	renderImpl( numFrames, [buffer, &bufferFrame]( const Buffer *block, size_t frameOffset, size_t blockFrames ) {
+		for( size_t ch = 0; ch < buffer->getNumChannels(); ch++ )
+			memcpy( buffer->getChannel( ch ) + bufferFrame, block->getChannel( ch ) + frameOffset, blockFrames * sizeof( float ) );
+
+		bufferFrame += blockFrames;
+	} );
+}
+
+void OfflineContext::render( size_t numFrames, TargetFile *target )
+{
+	if( target->getNumChannels() != mOutputOffline->getNumChannels() )
+		throw AudioFormatExc( "TargetFile has " + to_string( target->getNumChannels() ) + " channels, the output renders " + to_string( mOutputOffline->getNumChannels() ) + "." );
+
+	renderImpl( numFrames, [target]( const Buffer *block, size_t frameOffset, size_t blockFrames ) {
+		target->write( block, blockFrames, frameOffset );
+	} );
+}
+
+void OfflineContext::renderImpl( size_t numFrames, const function<void ( const Buffer *, size_t, size_t )> &fn )
+{
+	const size_t framesPerBlock = mOutputOffline->getOutputFramesPerBlock();
+	const Buffer *block = mOutputOffline->getInternalBuffer();
+
+	while( numFrames > 0 ) {
+		if( mNumFramesLeftInBlock == 0 ) {
+			mOutputOffline->render();
+			mNumFramesLeftInBlock = framesPerBlock;
+		}
+
+		const size_t blockFrames = min( numFrames, mNumFramesLeftInBlock );
+		fn( block, framesPerBlock - mNumFramesLeftInBlock, blockFrames );
+
+		mNumFramesLeftInBlock -= blockFrames;
+		numFrames -= blockFrames;
+	}
+}
+
+} } // namespace cinder::audio
@@ -26,6 +26,7 @@
 #include "cinder/audio/Utilities.h"
 #include "cinder/audio/Exception.h"
 
+#include <mutex>
 #include <string>
 
 using namespace std;
@@ -57,8 +58,6 @@ uint64_t OutputNode::getLastClip()
 
 void OutputNode::enableClipDetection( bool enable, float threshold )
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-
 	mClipDetectionEnabled = enable;
 	mClipThreshold = threshold;
 }
@@ -141,4 +140,46 @@ string OutputDeviceNode::getName() const
 	return Node::getName() + " (" + getDevice()->getName() + ")";
 }
 
+// ----------------------------------------------------------------------------------------------------
+// OutputNodeOffline
+// ----------------------------------------------------------------------------------------------------
+
+OutputNodeOffline::OutputNodeOffline( size_t sampleRate, size_t framesPerBlock, const Format &format )
+	: OutputNode( format ), mSampleRate( sampleRate ), mFramesPerBlock( framesPerBlock )
+{
+	if( getChannelMode() != ChannelMode::SPECIFIED ) {
+		setChannelMode( ChannelMode::SPECIFIED );
+		setNumChannels( 2 );
+	}
+
+	// there are no speakers to protect, and a block silenced because of a loud transient would be baked into the render
+	mClipDetectionEnabled = false;
+}
+
+void OutputNodeOffline::render()
+{
+	auto ctx = getContext();
+	CI_ASSERT( ctx );
+
+	// the internal buffer is allocated when initialized, which only happens on connecting or enabling
+	if( ! isInitialized() )
+		ctx->initializeNode( shared_from_this() );
+
+	Buffer *internalBuffer = getInternalBuffer();
+	internalBuffer->zero();
+
+	// checked under the lock, so that a disable() made during a graph edit is seen before rendering rather than after
+	lock_guard<mutex> lock( ctx->getMutex() );
+	if( ! isEnabled() )
+		return;
+
+	ctx->preProcess();
+	pullInputs( internalBuffer );
+
+	if( checkNotClipping() )
+		internalBuffer->zero();
+
+	ctx->postProcess();
+}
+
 } } // namespace cinder::audio
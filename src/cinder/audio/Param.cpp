@@ -69,11 +69,27 @@ Param::Param( Node *parentNode, float initialValue )
 {
 }
 
+Param::~Param()
+{
+	if( mProcessor ) {
+		auto ctx = getContext();
+		if( ctx )
+			ctx->setParamProcessor( this, nullptr );
+	}
+}
+
 void Param::setValue( float value )
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-	resetImpl();
+	bool hadProcessor = resetUserState();
 	mValue = value;
+
+	submitCommand( [this, value, retired = Retired()]() mutable {
+		resetImpl( &retired );
+		mValue = value;
+	} );
+
+	if( hadProcessor )
+		getContext()->setParamProcessor( this, nullptr );
 }
 
 EventRef Param::applyRamp( float valueEnd, double rampSeconds, const Options &options )
@@ -89,13 +105,7 @@ EventRef Param::applyRamp( float valueEnd, double rampSeconds, const Options &op
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	removeEventsAt( timeBegin );
-	if( mProcessor )
-		mProcessor.reset();
-
-	mEvents.push_back( event );
+	submitEvent( event, true );
 	return event;
 }
 
@@ -112,13 +122,7 @@ EventRef Param::applyRamp( float valueBegin, float valueEnd, double rampSeconds,
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	removeEventsAt( timeBegin );
-	if( mProcessor )
-		mProcessor.reset();
-
-	mEvents.push_back( event );
+	submitEvent( event, true );
 	return event;
 }
 
@@ -126,7 +130,6 @@ EventRef Param::appendRamp( float valueEnd, double rampSeconds, const Options &o
 {
 	initInternalBuffer();
 
-	auto ctx = getContext();
 	auto endTimeAndValue = findEndTimeAndValue();
 	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : endTimeAndValue.first + options.getDelay() );
 	double timeEnd = timeBegin + rampSeconds;
@@ -136,8 +139,7 @@ EventRef Param::appendRamp( float valueEnd, double rampSeconds, const Options &o
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-	mEvents.push_back( event );
+	submitEvent( event, false );
 	return event;
 }
 
@@ -145,7 +147,6 @@ EventRef Param::appendRamp( float valueBegin, float valueEnd, double rampSeconds
 {
 	initInternalBuffer();
 
-	auto ctx = getContext();
 	auto endTimeAndValue = findEndTimeAndValue();
 	double timeBegin = ( options.getBeginTime() >= 0 ? options.getBeginTime() : endTimeAndValue.first + options.getDelay() );
 	double timeEnd = timeBegin + rampSeconds;
@@ -155,8 +156,7 @@ EventRef Param::appendRamp( float valueBegin, float valueEnd, double rampSeconds
 	if( ! options.getLabel().empty() )
 		event->mLabel = options.getLabel();
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-	mEvents.push_back( event );
+	submitEvent( event, false );
 	return event;
 }
 
@@ -167,55 +167,72 @@ void Param::setProcessor( const NodeRef &node )
 
 	initInternalBuffer();
 
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	auto ctx = getContext();
+	resetUserState();
 
-	resetImpl();
+	{
+		// force node to be mono and initialize it, then have the Context's render list include it
+		ScopedGraphEdit edit( ctx );
+		node->setNumChannels( 1 );
+		node->initializeImpl();
 
-	// force node to be mono and initialize it
-	node->setNumChannels( 1 );
-	node->initializeImpl();
+		mProcessor = node;
+		ctx->setParamProcessor( this, node );
+	}
 
-	mProcessor = node;
-	mIsVaryingThisBlock = true; // stays true until there is no more processor and eval() sets this to false.
+	// submitted after the render list that includes node, so that it has been published by the time the command runs
+	submitCommand( [this, processor = node, retired = Retired()]() mutable {
+		resetImpl( &retired );
+		mRenderProcessor.swap( processor );
+		mIsVaryingThisBlock = true; // stays true until there is no more processor and eval() sets this to false.
+	} );
 }
 
 void Param::reset()
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-	resetImpl();
-}
+	bool hadProcessor = resetUserState();
+
+	submitCommand( [this, retired = Retired()]() mutable {
+		resetImpl( &retired );
+	} );
 
+	if( hadProcessor )
+		getContext()->setParamProcessor( this, nullptr );
+}
 
 size_t Param::getNumEvents() const
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
-	return mEvents.size();
+	const double currentTime = getContext()->getNumProcessedSeconds();
+
+	size_t result = 0;
+	for( const auto &event : mSubmittedEvents ) {
+		if( ! isExpired( *event, currentTime ) )
+			result++;
+	}
+
+	return result;
 }
 
 float Param::findDuration() const
 {
 	auto ctx = getContext();
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	if( mEvents.empty() )
+	const double currentTime = ctx->getNumProcessedSeconds();
+	const Event *event = findLastEvent( currentTime );
+	if( ! event )
 		return 0;
-	else {
-		const EventRef &event = mEvents.back();
-		return static_cast<float>(event->mTimeEnd - ctx->getNumProcessedSeconds());
-	}
+	else
+		return static_cast<float>( event->mTimeEnd - currentTime );
 }
 
 pair<double, float> Param::findEndTimeAndValue() const
 {
 	auto ctx = getContext();
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	if( mEvents.empty() )
-		return make_pair( ctx->getNumProcessedSeconds(), mValue.load() );
-	else {
-		const EventRef &event = mEvents.back();
+	const double currentTime = ctx->getNumProcessedSeconds();
+	const Event *event = findLastEvent( currentTime );
+	if( ! event )
+		return make_pair( currentTime, mValue.load() );
+	else
 		return make_pair( event->mTimeEnd, event->mValueEnd );
-	}
 }
 
 const float* Param::getValueArray()
@@ -230,8 +247,8 @@ const float* Param::getValueArray()
 
 bool Param::eval()
 {
-	if( mProcessor ) {
-		mProcessor->pullInputs( &mInternalBuffer );
+	if( mRenderProcessor ) {
+		mRenderProcessor->pullInputs( &mInternalBuffer );
 		mValue = mInternalBuffer[mInternalBuffer.getNumFrames() - 1];
 		return true;
 	}
@@ -331,19 +348,86 @@ bool Param::eval( double timeBegin, float *array, size_t arrayLength, size_t sam
 // Protected
 // ----------------------------------------------------------------------------------------------------
 
-void Param::resetImpl()
+void Param::resetImpl( Retired *retired )
 {
 	if( ! mEvents.empty() ) {
 		for( auto &event : mEvents )
 			event->cancel();
 
-		mEvents.clear();
+		retired->mEvents.splice( retired->mEvents.end(), mEvents );
 	}
 
+	mRenderProcessor.swap( retired->mProcessor );
+}
+
+bool Param::resetUserState()
+{
+	mSubmittedEvents.clear();
+
+	if( ! mProcessor )
+		return false;
+
 	mProcessor.reset();
+	return true;
+}
+
+void Param::submitEvent( const EventRef &event, bool replaceLaterEvents )
+{
+	auto ctx = getContext();
+	const double currentTime = ctx->getNumProcessedSeconds();
+	mSubmittedEvents.remove_if( [currentTime]( const EventRef &submitted ) { return isExpired( *submitted, currentTime ); } );
+
+	// the list node is allocated here, so that the audio thread only needs to splice it in
+	list<EventRef> events;
+	events.push_back( event );
+
+	if( replaceLaterEvents ) {
+		// mimic removeEventsAt() for the Events that findEndTimeAndValue() considers
+		const double time = event->mTimeBegin;
+		mSubmittedEvents.remove_if( [time]( const EventRef &submitted ) { return submitted->mTimeBegin >= time; } );
+
+		bool hadProcessor = ( mProcessor != nullptr );
+		mProcessor.reset();
+
+		submitCommand( [this, time, events = std::move( events ), retired = Retired()]() mutable {
+			removeEventsAt( time, &retired.mEvents );
+			mRenderProcessor.swap( retired.mProcessor );
+			mEvents.splice( mEvents.end(), events );
+		} );
+
+		if( hadProcessor )
+			ctx->setParamProcessor( this, nullptr );
+	}
+	else {
+		submitCommand( [this, events = std::move( events )]() mutable {
+			mEvents.splice( mEvents.end(), events );
+		} );
+	}
+
+	mSubmittedEvents.push_back( event );
+}
+
+void Param::submitCommand( std::function<void ()> command )
+{
+	mParentNode->submitCommand( std::move( command ) );
+}
+
+const Event* Param::findLastEvent( double currentTime ) const
+{
+	for( auto eventIt = mSubmittedEvents.rbegin(); eventIt != mSubmittedEvents.rend(); ++eventIt ) {
+		if( ! isExpired( **eventIt, currentTime ) )
+			return eventIt->get();
+	}
+
+	return nullptr;
 }
 
-void Param::removeEventsAt( double time )
+bool Param::isExpired( const Event &event, double currentTime )
+{
+	return event.mIsCanceled || event.mIsComplete || event.mTimeEnd <= currentTime;
+}
+
+void Param::removeEventsAt( double time, list<EventRef> *removedEvents )
 {
 	auto context = mParentNode->getContext();
 	bool contextDisabled = ! context || ! context->isEnabled();
@@ -351,7 +435,9 @@ void Param::removeEventsAt( double time )
 		Event &event = **eventIt;
 		if( event.getTimeBegin() >= time ) {
 			if( contextDisabled ) {
-				eventIt = mEvents.erase( eventIt );
+				auto next = std::next( eventIt );
+				removedEvents->splice( removedEvents->end(), mEvents, eventIt );
+				eventIt = next;
 				continue;
 			}
 			else {
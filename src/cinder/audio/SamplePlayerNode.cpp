@@ -148,7 +148,10 @@ void BufferPlayerNode::seek( size_t readPositionFrames )
 
 void BufferPlayerNode::setBuffer( const BufferRef &buffer )
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	// the audio thread may be reading the current buffer or channel count, so it stays out until they are replaced
+	auto ctx = getContext();
+	ScopedGraphEdit edit( ctx );
+	ctx->suspendProcessingForGraphEdit();
 
 	if( buffer ) {
 		if( getNumChannels() != buffer->getNumChannels() ) {
@@ -293,15 +296,10 @@ void FilePlayerNode::stop()
 		stopImpl();
 	}
 	else {
-		auto ctx = getContext();
-		if( ! ctx->isAudioThread() ) {
-			lock_guard<mutex> lock( ctx->getMutex() );
+		// runs right away when called from the audio thread
+		submitCommand( [this] {
 			stopImpl();
-		}
-		else {
-			// called from audio thread, lock is already held for the duration of this block
-			stopImpl();
-		}
+		} );
 	}
 }
 
@@ -312,21 +310,19 @@ void FilePlayerNode::seek( size_t readPositionFrames )
 		seekImpl( readPositionFrames );
 	}
 	else {
-		auto ctx = getContext();
-		if( ! ctx->isAudioThread() ) {
-			lock_guard<mutex> lock( ctx->getMutex() );
+		// runs right away when called from the audio thread
+		submitCommand( [this, readPositionFrames] {
 			seekImpl( readPositionFrames );
-		}
-		else {
-			// called from audio thread, lock is already held for the duration of this block
-			seekImpl( readPositionFrames );
-		}
+		} );
 	}
 }
 
 void FilePlayerNode::setSourceFile( const SourceFileRef &sourceFile )
 {
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	// the audio thread may be reading from the current source file, so it stays out until it is replaced
+	auto ctx = getContext();
+	ScopedGraphEdit edit( ctx );
+	ctx->suspendProcessingForGraphEdit();
 
 	bool wasEnabled = isEnabled();
 	disable();
@@ -141,7 +141,10 @@ void BufferRecorderNode::setNumFrames( size_t numFrames, bool shrinkToFit )
 	if( mRecorderBuffer.getNumFrames() == numFrames )
 		return;
 
-	lock_guard<mutex> lock( getContext()->getMutex() );
+	// the audio thread may be writing to the recorder buffer, so it stays out until the buffer is resized
+	auto ctx = getContext();
+	ScopedGraphEdit edit( ctx );
+	ctx->suspendProcessingForGraphEdit();
 
 	if( mWritePos != 0 )
 		resizeBufferAndShuffleChannels( &mRecorderBuffer, numFrames );
@@ -23,6 +23,7 @@
 
 #include "cinder/audio/Utilities.h"
 #include "cinder/CinderMath.h"
+#include "cinder/Simd.h"
 
 using namespace std;
 
@@ -31,9 +32,107 @@ namespace cinder { namespace audio {
 const float kGainNegative100Decibels = 0.00001f; // linear gain equal to -100db
 const float kGainNegative100DecibelsInverse = 1.0f / kGainNegative100Decibels;
 
+namespace {
+
+#if defined( CINDER_SIMD_SSE2 )
+
+// Natural log of 4 positive, normal floats, using the Cephes logf polynomial (accurate to a couple of ulps)
+__m128 logSse2( __m128 x )
+{
+	const __m128 one = _mm_set1_ps( 1.0f );
+	__m128i exponentBits = _mm_srli_epi32( _mm_castps_si128( x ), 23 );
+	// mantissa in [0.5, 1)
+	x = _mm_or_ps( _mm_and_ps( x, _mm_castsi128_ps( _mm_set1_epi32( ~0x7f800000 ) ) ), _mm_set1_ps( 0.5f ) );
+	__m128 e = _mm_add_ps( _mm_cvtepi32_ps( _mm_sub_epi32( exponentBits, _mm_set1_epi32( 0x7f ) ) ), one );
+
+	// shift the mantissa to [sqrt( 0.5 ), sqrt( 2 ) ) - 1
+	const __m128 mask = _mm_cmplt_ps( x, _mm_set1_ps( 0.707106781186547524f ) );
+	const __m128 tmp = _mm_and_ps( x, mask );
+	x = _mm_add_ps( _mm_sub_ps( x, one ), tmp );
+	e = _mm_sub_ps( e, _mm_and_ps( one, mask ) );
+
+	const __m128 z = _mm_mul_ps( x, x );
+	__m128 y = _mm_set1_ps( 7.0376836292e-2f );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( -1.1514610310e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 1.1676998740e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( -1.2420140846e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 1.4249322787e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( -1.6668057665e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 2.0000714765e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( -2.4999993993e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 3.3333331174e-1f ) );
+	y = _mm_mul_ps( _mm_mul_ps( y, x ), z );
+
+	y = _mm_add_ps( y, _mm_mul_ps( e, _mm_set1_ps( -2.12194440e-4f ) ) );
+	y = _mm_sub_ps( y, _mm_mul_ps( z, _mm_set1_ps( 0.5f ) ) );
+	return _mm_add_ps( _mm_add_ps( x, y ), _mm_mul_ps( e, _mm_set1_ps( 0.693359375f ) ) );
+}
+
+// e raised to 4 floats, using the Cephes expf polynomial. Inputs are clamped to the range of normal results.
+__m128 expSse2( __m128 x )
+{
+	const __m128 one = _mm_set1_ps( 1.0f );
+	x = _mm_max_ps( _mm_min_ps( x, _mm_set1_ps( 88.3762626647949f ) ), _mm_set1_ps( -87.3365478515625f ) );
+
+	// x = n * ln( 2 ) + r, with n rounded down
+	__m128 n = _mm_add_ps( _mm_mul_ps( x, _mm_set1_ps( 1.44269504088896341f ) ), _mm_set1_ps( 0.5f ) );
+	const __m128 truncated = _mm_cvtepi32_ps( _mm_cvttps_epi32( n ) );
+	n = _mm_sub_ps( truncated, _mm_and_ps( _mm_cmpgt_ps( truncated, n ), one ) );
+	x = _mm_sub_ps( x, _mm_mul_ps( n, _mm_set1_ps( 0.693359375f ) ) );
+	x = _mm_sub_ps( x, _mm_mul_ps( n, _mm_set1_ps( -2.12194440e-4f ) ) );
+
+	const __m128 z = _mm_mul_ps( x, x );
+	__m128 y = _mm_set1_ps( 1.9875691500e-4f );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 1.3981999507e-3f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 8.3334519073e-3f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 4.1665795894e-2f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 1.6666665459e-1f ) );
+	y = _mm_add_ps( _mm_mul_ps( y, x ), _mm_set1_ps( 5.0000001201e-1f ) );
+	y = _mm_add_ps( _mm_add_ps( _mm_mul_ps( y, z ), x ), one );
+
+	const __m128i pow2n = _mm_slli_epi32( _mm_add_epi32( _mm_cvttps_epi32( n ), _mm_set1_epi32( 0x7f ) ), 23 );
+	return _mm_mul_ps( y, _mm_castsi128_ps( pow2n ) );
+}
+
+// Returns the number of samples converted
+size_t linearToDecibelSse2( float *array, size_t length )
+{
+	const __m128 threshold = _mm_set1_ps( kGainNegative100Decibels );
+	const __m128 scale = _mm_set1_ps( 20.0f / 2.302585092994046f ); // 20 / ln( 10 )
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 ) {
+		const __m128 gain = _mm_loadu_ps( array + i );
+		const __m128 audible = _mm_cmpge_ps( gain, threshold );
+		// inaudible lanes are replaced with 1 before taking the log, then zeroed
+		const __m128 safeGain = _mm_or_ps( _mm_and_ps( audible, gain ), _mm_andnot_ps( audible, _mm_set1_ps( 1.0f ) ) );
+		const __m128 db = _mm_mul_ps( logSse2( _mm_mul_ps( safeGain, _mm_set1_ps( kGainNegative100DecibelsInverse ) ) ), scale );
+		_mm_storeu_ps( array + i, _mm_and_ps( audible, db ) );
+	}
+	return i;
+}
+
+size_t decibelToLinearSse2( float *array, size_t length )
+{
+	const __m128 threshold = _mm_set1_ps( kGainNegative100Decibels );
+	const __m128 scale = _mm_set1_ps( 0.05f * 2.302585092994046f ); // 10^( db / 20 ) = e^( db * ln( 10 ) / 20 )
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 ) {
+		const __m128 db = _mm_loadu_ps( array + i );
+		const __m128 audible = _mm_cmpge_ps( db, threshold );
+		const __m128 gain = _mm_mul_ps( expSse2( _mm_mul_ps( db, scale ) ), threshold );
+		_mm_storeu_ps( array + i, _mm_and_ps( audible, gain ) );
+	}
+	return i;
+}
+
+#endif
+
+} // anonymous namespace
+
+// The comparisons are written so that NaN is inaudible, matching the SIMD kernels, whose masks are false for NaN.
 float linearToDecibel( float gainLinear )
 {
-	if( gainLinear < kGainNegative100Decibels )
+	if( ! ( gainLinear >= kGainNegative100Decibels ) )
 		return 0.0f;
 	else
 		return 20.0f * log10f( gainLinear * kGainNegative100DecibelsInverse );
@@ -41,13 +140,17 @@ float linearToDecibel( float gainLinear )
 
 void linearToDecibel( float *array, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = linearToDecibelSse2( array, length );
+#endif
+	for( ; i < length; i++ )
 		array[i] = linearToDecibel( array[i] );
 }
 
 float decibelToLinear( float gainDecibels )
 {
-	if( gainDecibels < kGainNegative100Decibels )
+	if( ! ( gainDecibels >= kGainNegative100Decibels ) )
 		return 0.0f;
 	else
 		return( kGainNegative100Decibels * powf( 10.0f, gainDecibels * 0.05f ) );
@@ -55,7 +158,11 @@ float decibelToLinear( float gainDecibels )
 
 void decibelToLinear( float *array, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = decibelToLinearSse2( array, length );
+#endif
+	for( ; i < length; i++ )
 		array[i] = decibelToLinear( array[i] );
 }
 
@@ -236,21 +236,21 @@ void OutputDeviceNodeOpenSl::renderToBufferFromInputs()
 	if( ! ctx )
 		return;
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	// verify context still exists, since its destructor may have been holding the lock
-	ctx = getContext();
-	if( ! ctx )
-		return;
-
-	ctx->preProcess();
+	// the lock is only held on the user thread while it replaces resources that processing depends on, output silence meanwhile
+	unique_lock<mutex> lock( ctx->getMutex(), try_to_lock );
 
 	auto internalBuffer = getInternalBuffer();
 	internalBuffer->zero();
-	pullInputs( internalBuffer );
 
-	if( checkNotClipping() )
-		internalBuffer->zero();
+	// verify context still exists, since its destructor may have been holding the lock
+	ctx = lock.owns_lock() ? getContext() : nullptr;
+	if( ctx ) {
+		ctx->preProcess();
+		pullInputs( internalBuffer );
+
+		if( checkNotClipping() )
+			internalBuffer->zero();
+	}
 
 	// copy samples to opensl output buffer.
 	int16_t *destInt16Samples = &mImpl->mSampleBuffer[mImpl->mNumSamplesBuffered];
@@ -259,7 +259,8 @@ void OutputDeviceNodeOpenSl::renderToBufferFromInputs()
 
 	mImpl->mNumSamplesBuffered += internalBuffer->getSize();
 
-	ctx->postProcess();
+	if( ctx )
+		ctx->postProcess();
 }
 
 // ----------------------------------------------------------------------------------------------------
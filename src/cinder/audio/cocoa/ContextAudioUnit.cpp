@@ -131,7 +131,12 @@ OSStatus OutputDeviceNodeAudioUnit::renderCallback( void *data, ::AudioUnitRende
 		return noErr;
 	}
 
-	lock_guard<mutex> lock( ctx->getMutex() );
+	// the lock is only held on the user thread while it replaces resources that processing depends on, output silence meanwhile
+	unique_lock<mutex> lock( ctx->getMutex(), try_to_lock );
+	if( ! lock.owns_lock() ) {
+		zeroBufferList( bufferList );
+		return noErr;
+	}
 
 	// verify associated context still exists, which may not be true if we blocked in ~Context() and were then deallocated.
 	ctx = renderData->node->getContext();
@@ -25,12 +25,15 @@
 #include "cinder/audio/dsp/Dsp.h"
 #include "cinder/audio/dsp/ConverterR8brain.h"
 #include "cinder/CinderAssert.h"
+#include "cinder/Simd.h"
+#include "cinder/System.h"
 
 #if defined( CINDER_COCOA )
 	#include "cinder/audio/cocoa/CinderCoreAudio.h"
 #endif
 
 #include <algorithm>
+#include <cstring>
 
 using namespace ci;
 using namespace std;
@@ -134,4 +137,336 @@ void sumBuffers( const Buffer *sourceBuffer, Buffer *destBuffer, size_t numFrame
 		CI_ASSERT_NOT_REACHABLE();
 }
 
+// ----------------------------------------------------------------------------------------------------
+// Sample format conversion and interleaving
+// ----------------------------------------------------------------------------------------------------
+
+namespace {
+
+const float kInt16ToFloat = 3.0517578125e-05f;	// 1.0 / 32768.0
+const float kInt24ToFloat = 1.0f / 8388607.0f;
+
+inline int16_t floatToInt16( float sample )
+{
+	return int16_t( scaleAndClip( sample, 32768.0f, -32768.0f, 32767.0f ) );
+}
+
+inline int32_t floatToInt24( float sample )
+{
+	return scaleAndClip( sample, 8388607.0f, -8388608.0f, 8388607.0f );
+}
+
+inline float int24ToFloat( const char *source )
+{
+	int32_t sample = (int32_t)( ( (int32_t)source[2] ) << 16 ) | ( ( (int32_t)(uint8_t)source[1] ) << 8 ) | ( (int32_t)(uint8_t)source[0] );
+	return (float)sample * kInt24ToFloat;
+}
+
+inline void writeInt24( int32_t sample, char *dest )
+{
+	dest[0] = (char)( sample & 255 );
+	dest[1] = (char)( ( sample >> 8 ) & 255 );
+	dest[2] = (char)( ( sample >> 16 ) & 255 );
+}
+
+// Interleaves frames [beginFrame, endFrame), converting each sample with \a convertFn. Used for the frames that the SIMD kernels don't handle.
+template<typename SourceT, typename DestT, typename ConvertFn>
+void interleaveFrames( const SourceT *source, DestT *dest, size_t numFramesPerChannel, size_t numChannels, size_t beginFrame, size_t endFrame, ConvertFn convertFn )
+{
+	for( size_t ch = 0; ch < numChannels; ch++ ) {
+		const SourceT *sourceChannel = &source[ch * numFramesPerChannel];
+		for( size_t i = beginFrame; i < endFrame; i++ )
+			dest[i * numChannels + ch] = convertFn( sourceChannel[i] );
+	}
+}
+
+// De-interleaves frames [beginFrame, endFrame), where \a readFn returns the float value of the interleaved sample at the given index.
+template<typename ReadFn>
+void deinterleaveFrames( float *dest, size_t numFramesPerChannel, size_t numChannels, size_t beginFrame, size_t endFrame, ReadFn readFn )
+{
+	for( size_t ch = 0; ch < numChannels; ch++ ) {
+		float *destChannel = &dest[ch * numFramesPerChannel];
+		for( size_t i = beginFrame; i < endFrame; i++ )
+			destChannel[i] = readFn( i * numChannels + ch );
+	}
+}
+
+#if defined( CINDER_SIMD_SSE2 )
+
+// The SIMD kernels below return the number of samples or frames that they processed, the rest is left for the scalar loops.
+
+// Scales and clips 4 samples to 16-bit int range, leaving them as 32-bit ints. _mm_max_ps() returns its second operand when either is
+// NaN, so NaN becomes the minimum like it does in scaleAndClip().
+inline __m128i floatToInt16Sse2( __m128 samples )
+{
+	const __m128 scaled = _mm_mul_ps( samples, _mm_set1_ps( 32768.0f ) );
+	return _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( scaled, _mm_set1_ps( -32768.0f ) ), _mm_set1_ps( 32767.0f ) ) );
+}
+
+inline __m128i floatToInt24Sse2( __m128 samples )
+{
+	const __m128 scaled = _mm_mul_ps( samples, _mm_set1_ps( 8388607.0f ) );
+	return _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( scaled, _mm_set1_ps( -8388608.0f ) ), _mm_set1_ps( 8388607.0f ) ) );
+}
+
+// Converts the 16-bit ints in the low (or high) half of \a samples to float
+template<bool HIGH>
+inline __m128 int16ToFloatSse2( __m128i samples )
+{
+	const __m128i widened = _mm_srai_epi32( HIGH ? _mm_unpackhi_epi16( samples, samples ) : _mm_unpacklo_epi16( samples, samples ), 16 );
+	return _mm_mul_ps( _mm_cvtepi32_ps( widened ), _mm_set1_ps( kInt16ToFloat ) );
+}
+
+size_t convertSse2( const float *source, int16_t *dest, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m128i packed = _mm_packs_epi32( floatToInt16Sse2( _mm_loadu_ps( source + i ) ), floatToInt16Sse2( _mm_loadu_ps( source + i + 4 ) ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dest + i ), packed );
+	}
+	return i;
+}
+
+size_t convertSse2( const int16_t *source, float *dest, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m128i samples = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i ) );
+		_mm_storeu_ps( dest + i, int16ToFloatSse2<false>( samples ) );
+		_mm_storeu_ps( dest + i + 4, int16ToFloatSse2<true>( samples ) );
+	}
+	return i;
+}
+
+size_t interleaveSse2( const float *source, float *dest, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+	if( numChannels == 2 ) {
+		const float *left = source, *right = source + numFramesPerChannel;
+		for( ; i + 4 <= numCopyFrames; i += 4 ) {
+			const __m128 l = _mm_loadu_ps( left + i ), r = _mm_loadu_ps( right + i );
+			_mm_storeu_ps( dest + i * 2, _mm_unpacklo_ps( l, r ) );
+			_mm_storeu_ps( dest + i * 2 + 4, _mm_unpackhi_ps( l, r ) );
+		}
+	}
+	else if( numChannels == 4 ) {
+		for( ; i + 4 <= numCopyFrames; i += 4 ) {
+			__m128 c0 = _mm_loadu_ps( source + i ), c1 = _mm_loadu_ps( source + numFramesPerChannel + i );
+			__m128 c2 = _mm_loadu_ps( source + numFramesPerChannel * 2 + i ), c3 = _mm_loadu_ps( source + numFramesPerChannel * 3 + i );
+			_MM_TRANSPOSE4_PS( c0, c1, c2, c3 );
+			_mm_storeu_ps( dest + i * 4, c0 );
+			_mm_storeu_ps( dest + i * 4 + 4, c1 );
+			_mm_storeu_ps( dest + i * 4 + 8, c2 );
+			_mm_storeu_ps( dest + i * 4 + 12, c3 );
+		}
+	}
+	return i;
+}
+
+size_t interleaveSse2( const float *source, int16_t *dest, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+	if( numChannels == 2 ) {
+		const float *left = source, *right = source + numFramesPerChannel;
+		for( ; i + 8 <= numCopyFrames; i += 8 ) {
+			const __m128i l = _mm_packs_epi32( floatToInt16Sse2( _mm_loadu_ps( left + i ) ), floatToInt16Sse2( _mm_loadu_ps( left + i + 4 ) ) );
+			const __m128i r = _mm_packs_epi32( floatToInt16Sse2( _mm_loadu_ps( right + i ) ), floatToInt16Sse2( _mm_loadu_ps( right + i + 4 ) ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( dest + i * 2 ), _mm_unpacklo_epi16( l, r ) );
+			_mm_storeu_si128( reinterpret_cast<__m128i*>( dest + i * 2 + 8 ), _mm_unpackhi_epi16( l, r ) );
+		}
+	}
+	return i;
+}
+
+size_t deinterleaveSse2( const float *source, float *dest, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+	if( numChannels == 2 ) {
+		float *left = dest, *right = dest + numFramesPerChannel;
+		for( ; i + 4 <= numCopyFrames; i += 4 ) {
+			const __m128 a = _mm_loadu_ps( source + i * 2 ), b = _mm_loadu_ps( source + i * 2 + 4 );
+			_mm_storeu_ps( left + i, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) );
+			_mm_storeu_ps( right + i, _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) );
+		}
+	}
+	else if( numChannels == 4 ) {
+		for( ; i + 4 <= numCopyFrames; i += 4 ) {
+			__m128 f0 = _mm_loadu_ps( source + i * 4 ), f1 = _mm_loadu_ps( source + i * 4 + 4 );
+			__m128 f2 = _mm_loadu_ps( source + i * 4 + 8 ), f3 = _mm_loadu_ps( source + i * 4 + 12 );
+			_MM_TRANSPOSE4_PS( f0, f1, f2, f3 );
+			_mm_storeu_ps( dest + i, f0 );
+			_mm_storeu_ps( dest + numFramesPerChannel + i, f1 );
+			_mm_storeu_ps( dest + numFramesPerChannel * 2 + i, f2 );
+			_mm_storeu_ps( dest + numFramesPerChannel * 3 + i, f3 );
+		}
+	}
+	return i;
+}
+
+size_t deinterleaveSse2( const int16_t *source, float *dest, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+	if( numChannels == 2 ) {
+		const __m128 normalizer = _mm_set1_ps( kInt16ToFloat );
+		float *left = dest, *right = dest + numFramesPerChannel;
+		for( ; i + 4 <= numCopyFrames; i += 4 ) {
+			// each 32-bit lane holds one frame, with the left sample in the low half
+			const __m128i frames = _mm_loadu_si128( reinterpret_cast<const __m128i*>( source + i * 2 ) );
+			_mm_storeu_ps( left + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_srai_epi32( _mm_slli_epi32( frames, 16 ), 16 ) ), normalizer ) );
+			_mm_storeu_ps( right + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_srai_epi32( frames, 16 ) ), normalizer ) );
+		}
+	}
+	return i;
+}
+
+// Reads 4 packed 24-bit samples into 32-bit lanes, sign extended. Reads 16 bytes, the last 4 are ignored.
+CI_SIMD_TARGET_SSE4_1 inline __m128i loadInt24Sse4_1( const char *source )
+{
+	const __m128i shuffle = _mm_setr_epi8( -1, 0, 1, 2, -1, 3, 4, 5, -1, 6, 7, 8, -1, 9, 10, 11 );
+	return _mm_srai_epi32( _mm_shuffle_epi8( _mm_loadu_si128( reinterpret_cast<const __m128i*>( source ) ), shuffle ), 8 );
+}
+
+CI_SIMD_TARGET_SSE4_1 size_t convertInt24ToFloatSse4_1( const char *source, float *dest, size_t length )
+{
+	const __m128 normalizer = _mm_set1_ps( kInt24ToFloat );
+	size_t i = 0;
+	for( ; i + 6 <= length; i += 4 )
+		_mm_storeu_ps( dest + i, _mm_mul_ps( _mm_cvtepi32_ps( loadInt24Sse4_1( source + i * 3 ) ), normalizer ) );
+	return i;
+}
+
+CI_SIMD_TARGET_SSE4_1 size_t convertFloatToInt24Sse4_1( const float *source, char *dest, size_t length )
+{
+	const __m128i shuffle = _mm_setr_epi8( 0, 1, 2, 4, 5, 6, 8, 9, 10, 12, 13, 14, -1, -1, -1, -1 );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 ) {
+		const __m128i packed = _mm_shuffle_epi8( floatToInt24Sse2( _mm_loadu_ps( source + i ) ), shuffle );
+		_mm_storel_epi64( reinterpret_cast<__m128i*>( dest + i * 3 ), packed );
+		const int32_t last = _mm_cvtsi128_si32( _mm_srli_si128( packed, 8 ) );
+		memcpy( dest + i * 3 + 8, &last, sizeof( last ) );
+	}
+	return i;
+}
+
+CI_SIMD_TARGET_SSE4_1 size_t deinterleaveInt24ToFloatSse4_1( const char *source, float *dest, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+	if( numChannels == 2 ) {
+		const __m128 normalizer = _mm_set1_ps( kInt24ToFloat );
+		float *left = dest, *right = dest + numFramesPerChannel;
+		for( ; i + 5 <= numCopyFrames; i += 4 ) {
+			const __m128 a = _mm_castsi128_ps( loadInt24Sse4_1( source + i * 6 ) ), b = _mm_castsi128_ps( loadInt24Sse4_1( source + i * 6 + 12 ) );
+			_mm_storeu_ps( left + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 2, 0, 2, 0 ) ) ) ), normalizer ) );
+			_mm_storeu_ps( right + i, _mm_mul_ps( _mm_cvtepi32_ps( _mm_castps_si128( _mm_shuffle_ps( a, b, _MM_SHUFFLE( 3, 1, 3, 1 ) ) ) ), normalizer ) );
+		}
+	}
+	return i;
+}
+
+#endif
+
+} // anonymous namespace
+
+void convert( const float *sourceArray, int16_t *destArray, size_t length )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = convertSse2( sourceArray, destArray, length );
+#endif
+	for( ; i < length; i++ )
+		destArray[i] = floatToInt16( sourceArray[i] );
+}
+
+void convert( const int16_t *sourceArray, float *destArray, size_t length )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = convertSse2( sourceArray, destArray, length );
+#endif
+	for( ; i < length; i++ )
+		destArray[i] = (float)sourceArray[i] * kInt16ToFloat;
+}
+
+void convertInt24ToFloat( const char *sourceArray, float *destArray, size_t length )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasSse4_1 = System::hasSse4_1();
+	if( sHasSse4_1 )
+		i = convertInt24ToFloatSse4_1( sourceArray, destArray, length );
+#endif
+	for( ; i < length; i++ )
+		destArray[i] = int24ToFloat( sourceArray + i * 3 );
+}
+
+void convertFloatToInt24( const float *sourceArray, char *destArray, size_t length )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasSse4_1 = System::hasSse4_1();
+	if( sHasSse4_1 )
+		i = convertFloatToInt24Sse4_1( sourceArray, destArray, length );
+#endif
+	for( ; i < length; i++ )
+		writeInt24( floatToInt24( sourceArray[i] ), destArray + i * 3 );
+}
+
+void interleave( const float *nonInterleavedSourceArray, float *interleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = interleaveSse2( nonInterleavedSourceArray, interleavedDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+#endif
+	interleaveFrames( nonInterleavedSourceArray, interleavedDestArray, numFramesPerChannel, numChannels, i, numCopyFrames, []( float sample ) { return sample; } );
+}
+
+void interleave( const float *nonInterleavedFloatSourceArray, int16_t *interleavedInt16DestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = interleaveSse2( nonInterleavedFloatSourceArray, interleavedInt16DestArray, numFramesPerChannel, numChannels, numCopyFrames );
+#endif
+	interleaveFrames( nonInterleavedFloatSourceArray, interleavedInt16DestArray, numFramesPerChannel, numChannels, i, numCopyFrames, &floatToInt16 );
+}
+
+void deinterleave( const float *interleavedSourceArray, float *nonInterleavedDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = deinterleaveSse2( interleavedSourceArray, nonInterleavedDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+#endif
+	deinterleaveFrames( nonInterleavedDestArray, numFramesPerChannel, numChannels, i, numCopyFrames, [interleavedSourceArray]( size_t index ) {
+		return interleavedSourceArray[index];
+	} );
+}
+
+void deinterleave( const int16_t *interleavedInt16SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	i = deinterleaveSse2( interleavedInt16SourceArray, nonInterleavedFloatDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+#endif
+	deinterleaveFrames( nonInterleavedFloatDestArray, numFramesPerChannel, numChannels, i, numCopyFrames, [interleavedInt16SourceArray]( size_t index ) {
+		return (float)interleavedInt16SourceArray[index] * kInt16ToFloat;
+	} );
+}
+
+void deinterleaveInt24ToFloat( const char *interleavedInt24SourceArray, float *nonInterleavedFloatDestArray, size_t numFramesPerChannel, size_t numChannels, size_t numCopyFrames )
+{
+	if( numChannels == 1 ) {
+		convertInt24ToFloat( interleavedInt24SourceArray, nonInterleavedFloatDestArray, numCopyFrames );
+		return;
+	}
+
+	size_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasSse4_1 = System::hasSse4_1();
+	if( sHasSse4_1 )
+		i = deinterleaveInt24ToFloatSse4_1( interleavedInt24SourceArray, nonInterleavedFloatDestArray, numFramesPerChannel, numChannels, numCopyFrames );
+#endif
+	deinterleaveFrames( nonInterleavedFloatDestArray, numFramesPerChannel, numChannels, i, numCopyFrames, [interleavedInt24SourceArray]( size_t index ) {
+		return int24ToFloat( interleavedInt24SourceArray + index * 3 );
+	} );
+}
+
 } } } // namespace cinder::audio::dsp
@@ -27,8 +27,14 @@
 
 #if defined( CINDER_AUDIO_VDSP )
 	#include <Accelerate/Accelerate.h>
+#else
+	#include "cinder/Simd.h"
+	#include "cinder/System.h"
 #endif
 
+#include <algorithm>
+#include <limits>
+
 using namespace ci;
 
 namespace cinder { namespace audio { namespace dsp {
@@ -164,15 +170,96 @@ void addMul( const float *arrayA, const float *arrayB, float scalar, float *resu
 	vDSP_vasm( const_cast<float *>( arrayA ), 1, const_cast<float *>( arrayB ), 1, &scalar, result, 1, length );
 }
 
+void normalize( float *array, size_t length, float maxValue )
+{
+	float max = 0;
+	for( size_t i = 0; i < length; i++ ) {
+		if( max < array[i] )
+			max = array[i];
+	}
+
+	if( max > 0.00001f ) {
+		mul( array, maxValue / max, array, length );
+	}
+}
+
+float spectralCentroid( const float *magArray, size_t magArrayLength, size_t sampleRate )
+{
+	float binToFreq = (float)sampleRate / (float)(magArrayLength * 2 ); // sr / fft size
+	float FA = 0;	// f(n) * x(n)
+	float A = 0;	// x(n)
+
+	for( size_t n = 0; n < magArrayLength; n++ ) {
+		float freq = n * binToFreq;
+		float mag = magArray[n];
+
+		FA += freq * mag;
+		A += mag;
+	}
+
+	if( A < EPSILON )
+		return 0;
+
+	return FA / A;
+}
+
 #else // ! defined( CINDER_AUDIO_VDSP )
 
-void fill( float value, float *array, size_t length )
+namespace {
+
+// ----------------------------------------------------------------------------------------------------
+// Generic kernels, also used for the tails of the SIMD kernels
+// ----------------------------------------------------------------------------------------------------
+
+void fillGeneric( float value, float *array, size_t length )
 {
 	for( size_t i = 0; i < length; i++ )
 		array[i] = value;
 }
 
-float sum( const float *array, size_t length )
+void addGeneric( const float *array, float scalar, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = array[i] + scalar;
+}
+
+void addGeneric( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] + arrayB[i];
+}
+
+void subGeneric( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] - arrayB[i];
+}
+
+void mulGeneric( const float *array, float scalar, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = array[i] * scalar;
+}
+
+void mulGeneric( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] * arrayB[i];
+}
+
+void divideGeneric( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = arrayA[i] / arrayB[i];
+}
+
+void addMulGeneric( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	for( size_t i = 0; i < length; i++ )
+		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;
+}
+
+float sumGeneric( const float *array, size_t length )
 {
 	float result( 0.0f );
 	for( size_t i = 0; i < length; i++ )
@@ -180,51 +267,396 @@ float sum( const float *array, size_t length )
 	return result;
 }
 
-void add( const float *array, float scalar, float *result, size_t length )
+float sumSquaresGeneric( const float *array, size_t length )
 {
+	float result( 0.0f );
 	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] + scalar;
+		result += array[i] * array[i];
+	return result;
+}
+
+float maxGeneric( const float *array, size_t length )
+{
+	float result = std::numeric_limits<float>::lowest();
+	for( size_t i = 0; i < length; i++ ) {
+		if( result < array[i] )
+			result = array[i];
+	}
+	return result;
+}
+
+// Sums array[i] * ( i + firstIndex ) into \a weighted and array[i] into \a total
+void weightedSumGeneric( const float *array, size_t length, size_t firstIndex, float *weighted, float *total )
+{
+	for( size_t i = 0; i < length; i++ ) {
+		*weighted += float( i + firstIndex ) * array[i];
+		*total += array[i];
+	}
+}
+
+#if defined( CINDER_SIMD_SSE2 )
+
+// ----------------------------------------------------------------------------------------------------
+// SSE2 and AVX2 kernels
+// ----------------------------------------------------------------------------------------------------
+
+inline float horizontalSumSse2( __m128 v )
+{
+	v = _mm_add_ps( v, _mm_movehl_ps( v, v ) );
+	v = _mm_add_ss( v, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	return _mm_cvtss_f32( v );
+}
+
+inline float horizontalMaxSse2( __m128 v )
+{
+	v = _mm_max_ps( v, _mm_movehl_ps( v, v ) );
+	v = _mm_max_ss( v, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ) );
+	return _mm_cvtss_f32( v );
+}
+
+void fillSse2( float value, float *array, size_t length )
+{
+	const __m128 v = _mm_set1_ps( value );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( array + i, v );
+	fillGeneric( value, array + i, length - i );
+}
+
+void addSse2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m128 s = _mm_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_add_ps( _mm_loadu_ps( array + i ), s ) );
+	addGeneric( array + i, scalar, result + i, length - i );
+}
+
+void addSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_add_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+	addGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void subSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_sub_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+	subGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void mulSse2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m128 s = _mm_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_mul_ps( _mm_loadu_ps( array + i ), s ) );
+	mulGeneric( array + i, scalar, result + i, length - i );
+}
+
+void mulSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_mul_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+	mulGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void divideSse2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_div_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ) );
+	divideGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+void addMulSse2( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	const __m128 s = _mm_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		_mm_storeu_ps( result + i, _mm_mul_ps( _mm_add_ps( _mm_loadu_ps( arrayA + i ), _mm_loadu_ps( arrayB + i ) ), s ) );
+	addMulGeneric( arrayA + i, arrayB + i, scalar, result + i, length - i );
+}
+
+float sumSse2( const float *array, size_t length )
+{
+	__m128 acc = _mm_setzero_ps();
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		acc = _mm_add_ps( acc, _mm_loadu_ps( array + i ) );
+	return horizontalSumSse2( acc ) + sumGeneric( array + i, length - i );
+}
+
+float sumSquaresSse2( const float *array, size_t length )
+{
+	__m128 acc = _mm_setzero_ps();
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 ) {
+		const __m128 v = _mm_loadu_ps( array + i );
+		acc = _mm_add_ps( acc, _mm_mul_ps( v, v ) );
+	}
+	return horizontalSumSse2( acc ) + sumSquaresGeneric( array + i, length - i );
+}
+
+float maxSse2( const float *array, size_t length )
+{
+	__m128 acc = _mm_set1_ps( std::numeric_limits<float>::lowest() );
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 )
+		acc = _mm_max_ps( acc, _mm_loadu_ps( array + i ) );
+	return std::max( horizontalMaxSse2( acc ), maxGeneric( array + i, length - i ) );
+}
+
+void weightedSumSse2( const float *array, size_t length, size_t firstIndex, float *weighted, float *total )
+{
+	__m128 index = _mm_add_ps( _mm_set1_ps( float( firstIndex ) ), _mm_setr_ps( 0, 1, 2, 3 ) );
+	const __m128 step = _mm_set1_ps( 4 );
+	__m128 accWeighted = _mm_setzero_ps(), accTotal = _mm_setzero_ps();
+	size_t i = 0;
+	for( ; i + 4 <= length; i += 4 ) {
+		const __m128 v = _mm_loadu_ps( array + i );
+		accWeighted = _mm_add_ps( accWeighted, _mm_mul_ps( index, v ) );
+		accTotal = _mm_add_ps( accTotal, v );
+		index = _mm_add_ps( index, step );
+	}
+	*weighted += horizontalSumSse2( accWeighted );
+	*total += horizontalSumSse2( accTotal );
+	weightedSumGeneric( array + i, length - i, firstIndex + i, weighted, total );
+}
+
+CI_SIMD_TARGET_AVX2 inline __m128 foldAvx2( __m256 v )
+{
+	return _mm_add_ps( _mm256_castps256_ps128( v ), _mm256_extractf128_ps( v, 1 ) );
+}
+
+CI_SIMD_TARGET_AVX2 void fillAvx2( float value, float *array, size_t length )
+{
+	const __m256 v = _mm256_set1_ps( value );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( array + i, v );
+	fillGeneric( value, array + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 void addAvx2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m256 s = _mm256_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_add_ps( _mm256_loadu_ps( array + i ), s ) );
+	addGeneric( array + i, scalar, result + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 void addAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_add_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+	addGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 void subAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_sub_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+	subGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 void mulAvx2( const float *array, float scalar, float *result, size_t length )
+{
+	const __m256 s = _mm256_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_mul_ps( _mm256_loadu_ps( array + i ), s ) );
+	mulGeneric( array + i, scalar, result + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 void mulAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_mul_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+	mulGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 void divideAvx2( const float *arrayA, const float *arrayB, float *result, size_t length )
+{
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_div_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ) );
+	divideGeneric( arrayA + i, arrayB + i, result + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 void addMulAvx2( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
+{
+	// separate add and mul rather than fma, so results match the other kernels exactly
+	const __m256 s = _mm256_set1_ps( scalar );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		_mm256_storeu_ps( result + i, _mm256_mul_ps( _mm256_add_ps( _mm256_loadu_ps( arrayA + i ), _mm256_loadu_ps( arrayB + i ) ), s ) );
+	addMulGeneric( arrayA + i, arrayB + i, scalar, result + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 float sumAvx2( const float *array, size_t length )
+{
+	__m256 acc = _mm256_setzero_ps();
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		acc = _mm256_add_ps( acc, _mm256_loadu_ps( array + i ) );
+	return horizontalSumSse2( foldAvx2( acc ) ) + sumGeneric( array + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 float sumSquaresAvx2( const float *array, size_t length )
+{
+	__m256 acc = _mm256_setzero_ps();
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m256 v = _mm256_loadu_ps( array + i );
+		acc = _mm256_add_ps( acc, _mm256_mul_ps( v, v ) );
+	}
+	return horizontalSumSse2( foldAvx2( acc ) ) + sumSquaresGeneric( array + i, length - i );
+}
+
+CI_SIMD_TARGET_AVX2 float maxAvx2( const float *array, size_t length )
+{
+	__m256 acc = _mm256_set1_ps( std::numeric_limits<float>::lowest() );
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 )
+		acc = _mm256_max_ps( acc, _mm256_loadu_ps( array + i ) );
+	const __m128 folded = _mm_max_ps( _mm256_castps256_ps128( acc ), _mm256_extractf128_ps( acc, 1 ) );
+	return std::max( horizontalMaxSse2( folded ), maxGeneric( array + i, length - i ) );
+}
+
+CI_SIMD_TARGET_AVX2 void weightedSumAvx2( const float *array, size_t length, size_t firstIndex, float *weighted, float *total )
+{
+	__m256 index = _mm256_add_ps( _mm256_set1_ps( float( firstIndex ) ), _mm256_setr_ps( 0, 1, 2, 3, 4, 5, 6, 7 ) );
+	const __m256 step = _mm256_set1_ps( 8 );
+	__m256 accWeighted = _mm256_setzero_ps(), accTotal = _mm256_setzero_ps();
+	size_t i = 0;
+	for( ; i + 8 <= length; i += 8 ) {
+		const __m256 v = _mm256_loadu_ps( array + i );
+		accWeighted = _mm256_add_ps( accWeighted, _mm256_mul_ps( index, v ) );
+		accTotal = _mm256_add_ps( accTotal, v );
+		index = _mm256_add_ps( index, step );
+	}
+	*weighted += horizontalSumSse2( foldAvx2( accWeighted ) );
+	*total += horizontalSumSse2( foldAvx2( accTotal ) );
+	weightedSumGeneric( array + i, length - i, firstIndex + i, weighted, total );
+}
+
+#endif
+
+// The vector math kernels, selected once at runtime based on the CPU. Element-wise results are identical for every variant,
+// while sums are accumulated in a different order and can differ by rounding.
+struct VectorKernels {
+	VectorKernels();
+
+	void	(*fill)( float value, float *array, size_t length );
+	void	(*addScalar)( const float *array, float scalar, float *result, size_t length );
+	void	(*add)( const float *arrayA, const float *arrayB, float *result, size_t length );
+	void	(*sub)( const float *arrayA, const float *arrayB, float *result, size_t length );
+	void	(*mulScalar)( const float *array, float scalar, float *result, size_t length );
+	void	(*mul)( const float *arrayA, const float *arrayB, float *result, size_t length );
+	void	(*divide)( const float *arrayA, const float *arrayB, float *result, size_t length );
+	void	(*addMul)( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length );
+	float	(*sum)( const float *array, size_t length );
+	float	(*sumSquares)( const float *array, size_t length );
+	float	(*max)( const float *array, size_t length );
+	void	(*weightedSum)( const float *array, size_t length, size_t firstIndex, float *weighted, float *total );
+};
+
+VectorKernels::VectorKernels()
+	: fill( &fillGeneric ), addScalar( &addGeneric ), add( &addGeneric ), sub( &subGeneric ), mulScalar( &mulGeneric ), mul( &mulGeneric ),
+		divide( &divideGeneric ), addMul( &addMulGeneric ), sum( &sumGeneric ), sumSquares( &sumSquaresGeneric ), max( &maxGeneric ), weightedSum( &weightedSumGeneric )
+{
+#if defined( CINDER_SIMD_SSE2 )
+	if( System::hasAvx2() ) {
+		fill = &fillAvx2;
+		addScalar = &addAvx2;
+		add = &addAvx2;
+		sub = &subAvx2;
+		mulScalar = &mulAvx2;
+		mul = &mulAvx2;
+		divide = &divideAvx2;
+		addMul = &addMulAvx2;
+		sum = &sumAvx2;
+		sumSquares = &sumSquaresAvx2;
+		max = &maxAvx2;
+		weightedSum = &weightedSumAvx2;
+	}
+	else {
+		fill = &fillSse2;
+		addScalar = &addSse2;
+		add = &addSse2;
+		sub = &subSse2;
+		mulScalar = &mulSse2;
+		mul = &mulSse2;
+		divide = &divideSse2;
+		addMul = &addMulSse2;
+		sum = &sumSse2;
+		sumSquares = &sumSquaresSse2;
+		max = &maxSse2;
+		weightedSum = &weightedSumSse2;
+	}
+#endif
+}
+
+const VectorKernels& getKernels()
+{
+	static const VectorKernels sKernels;
+	return sKernels;
+}
+
+} // anonymous namespace
+
+void fill( float value, float *array, size_t length )
+{
+	getKernels().fill( value, array, length );
+}
+
+float sum( const float *array, size_t length )
+{
+	return getKernels().sum( array, length );
+}
+
+void add( const float *array, float scalar, float *result, size_t length )
+{
+	getKernels().addScalar( array, scalar, result, length );
 }
 
 void add( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] + arrayB[i];
+	getKernels().add( arrayA, arrayB, result, length );
 }
 
 void sub( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] - scalar;
+	getKernels().addScalar( array, -scalar, result, length );
 }
 
 void sub( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] - arrayB[i];
+	getKernels().sub( arrayA, arrayB, result, length );
 }
 
 float rms( const float *array, size_t length )
 {
-	float sumSquared( 0.0f );
-	for( size_t i = 0; i < length; i++ ) {
-		float val = array[i];
-		sumSquared += val * val;
-	}
-
-	return math<float>::sqrt( sumSquared / (float)length );
+	return math<float>::sqrt( getKernels().sumSquares( array, length ) / (float)length );
 }
 
 void mul( const float *array, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = array[i] * scalar;
+	getKernels().mulScalar( array, scalar, result, length );
 }
 
 void mul( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] * arrayB[i];
+	getKernels().mul( arrayA, arrayB, result, length );
 }
 
 void divide( const float *array, float scalar, float *result, size_t length )
@@ -234,26 +666,17 @@ void divide( const float *array, float scalar, float *result, size_t length )
 
 void divide( const float *arrayA, const float *arrayB, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = arrayA[i] / arrayB[i];
+	getKernels().divide( arrayA, arrayB, result, length );
 }
 
 void addMul( const float *arrayA, const float *arrayB, float scalar, float *result, size_t length )
 {
-	for( size_t i = 0; i < length; i++ )
-		result[i] = ( arrayA[i] + arrayB[i] ) * scalar;
+	getKernels().addMul( arrayA, arrayB, scalar, result, length );
 }
 
-#endif // ! defined( CINDER_AUDIO_VDSP )
-
 void normalize( float *array, size_t length, float maxValue )
 {
-	float max = 0;
-	for( size_t i = 0; i < length; i++ ) {
-		if( max < array[i] )
-			max = array[i];
-	}
-
+	const float max = getKernels().max( array, length );
 	if( max > 0.00001f ) {
 		mul( array, maxValue / max, array, length );
 	}
@@ -262,21 +685,16 @@ void normalize( float *array, size_t length, float maxValue )
 float spectralCentroid( const float *magArray, size_t magArrayLength, size_t sampleRate )
 {
 	float binToFreq = (float)sampleRate / (float)(magArrayLength * 2 ); // sr / fft size
-	float FA = 0;	// f(n) * x(n)
+	float FA = 0;	// n * x(n), scaled to f(n) * x(n) below
 	float A = 0;	// x(n)
-
-	for( size_t n = 0; n < magArrayLength; n++ ) {
-		float freq = n * binToFreq;
-		float mag = magArray[n];
-
-		FA += freq * mag;
-		A += mag;
-	}
+	getKernels().weightedSum( magArray, magArrayLength, 0, &FA, &A );
 
 	if( A < EPSILON )
 		return 0;
 
-	return FA / A;
+	return FA * binToFreq / A;
 }
 
+#endif // ! defined( CINDER_AUDIO_VDSP )
+
 } } } // namespace cinder::audio::dsp
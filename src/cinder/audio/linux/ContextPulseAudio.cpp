@@ -767,21 +767,21 @@ void OutputDeviceNodePulseAudio::renderInputs()
 	if( ! ctx )
 		return;
 
-	std::lock_guard<std::mutex> lock( ctx->getMutex() );
-
-	// verify context still exists, since its destructor may have been holding the lock
-	ctx = getContext();
-	if( ! ctx )
-		return;
-
-	ctx->preProcess();
+	// the lock is only held on the user thread while it replaces resources that processing depends on, output silence meanwhile
+	std::unique_lock<std::mutex> lock( ctx->getMutex(), std::try_to_lock );
 
 	auto internalBuffer = getInternalBuffer();
 	internalBuffer->zero();
-	pullInputs( internalBuffer );
 
-	if( checkNotClipping() )
-		internalBuffer->zero();
+	// verify context still exists, since its destructor may have been holding the lock
+	ctx = lock.owns_lock() ? getContext() : nullptr;
+	if( ctx ) {
+		ctx->preProcess();
+		pullInputs( internalBuffer );
+
+		if( checkNotClipping() )
+			internalBuffer->zero();
+	}
 
 	dsp::interleaveBuffer( internalBuffer, &mInterleavedBuffer );
 	bool writeSuccess = mImpl->mRingBuffer->write( mInterleavedBuffer.getData(), mInterleavedBuffer.getSize() );
@@ -789,7 +789,8 @@ void OutputDeviceNodePulseAudio::renderInputs()
 
 	mImpl->mNumFramesBuffered += mInterleavedBuffer.getNumFrames();
 
-	ctx->postProcess();
+	if( ctx )
+		ctx->postProcess();
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -489,7 +489,7 @@ SourceFileAudioLoader::~SourceFileAudioLoader()
 
 void SourceFileAudioLoader::init()
 {
-	if( mDataSource->isFilePath() ) {
+	if( mDataSource->isFilePath() && ! mDataSource->isMapped() ) {
 		//std::cout << "Loading into stream: " << mDataSource->getFilePath().string() << std::endl;
 		mStream = ci::loadFileStream( mDataSource->getFilePath() );
 	}
@@ -834,21 +834,21 @@ void OutputDeviceNodeWasapi::renderInputs()
 	if( ! ctx )
 		return;
 
-	lock_guard<mutex> lock( ctx->getMutex() );
-
-	// verify context still exists, since its destructor may have been holding the lock
-	ctx = getContext();
-	if( ! ctx )
-		return;
-
-	ctx->preProcess();
+	// the lock is only held on the user thread while it replaces resources that processing depends on, output silence meanwhile
+	unique_lock<mutex> lock( ctx->getMutex(), try_to_lock );
 
 	auto internalBuffer = getInternalBuffer();
 	internalBuffer->zero();
-	pullInputs( internalBuffer );
 
-	if( checkNotClipping() )
-		internalBuffer->zero();
+	// verify context still exists, since its destructor may have been holding the lock
+	ctx = lock.owns_lock() ? getContext() : nullptr;
+	if( ctx ) {
+		ctx->preProcess();
+		pullInputs( internalBuffer );
+
+		if( checkNotClipping() )
+			internalBuffer->zero();
+	}
 
 	const auto &sampleType = mRenderImpl->mSampleType;
 	const size_t numFrames = internalBuffer->getNumFrames();
@@ -868,7 +868,8 @@ void OutputDeviceNodeWasapi::renderInputs()
 	CI_ASSERT( writeSuccess ); // Since this is sync read / write, the write should always succeed.
 
 	mRenderImpl->mNumFramesBuffered += numFrames;
-	ctx->postProcess();
+	if( ctx )
+		ctx->postProcess();
 }
 
 // ----------------------------------------------------------------------------------------------------
@@ -23,6 +23,11 @@
 
 #include "cinder/ip/Blend.h"
 #include "cinder/ip/Fill.h"
+#include "cinder/ip/Parallel.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Simd.h"
+
+#include <algorithm>
 
 using namespace std;
 
@@ -35,15 +40,140 @@ namespace cinder { namespace ip {
 	αr×Cr = (1–αs)×Cd + (1–αd)×Cs + B(Cd, αd, Cs, αs)				Premult * Premult
 */
 
+namespace {
+
+#if defined( CINDER_SIMD_SSE2 )
+
+// Exact floor( x / 255 ) for each 16-bit lane x <= 255 * 255
+inline __m128i div255Sse2( __m128i x )
+{
+	return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( x, _mm_set1_epi16( 1 ) ), _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+// Premult * premult -> premult for 4 interleaved pixels at a time, where source and destination share a channel order
+// with the alpha at offset ALPHA. Matches the scalar path in blendImpl() exactly. Returns the number of pixels processed.
+template<int ALPHA>
+int32_t blendPremultRowSse2( uint8_t *dst, const uint8_t *src, int32_t width )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i max = _mm_set1_epi16( 255 );
+	const __m128i alphaMask = _mm_setr_epi16( ALPHA == 0 ? -1 : 0, 0, 0, ALPHA == 3 ? -1 : 0, ALPHA == 0 ? -1 : 0, 0, 0, ALPHA == 3 ? -1 : 0 );
+	auto blend16 = [&]( __m128i d, __m128i s ) {
+		const __m128i invAlphaS = _mm_sub_epi16( max, _mm_shufflehi_epi16( _mm_shufflelo_epi16( s, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ), _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ) );
+		const __m128i invAlphaD = _mm_sub_epi16( max, _mm_shufflehi_epi16( _mm_shufflelo_epi16( d, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ), _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ) );
+		const __m128i alphaR = _mm_sub_epi16( max, div255Sse2( _mm_mullo_epi16( invAlphaS, invAlphaD ) ) );
+		// ( invAlphaS * Cd + 255 * Cs ) / 255, truncated to 8 bits like the scalar path
+		const __m128i color = _mm_and_si128( _mm_add_epi16( s, div255Sse2( _mm_mullo_epi16( invAlphaS, d ) ) ), max );
+		__m128i result = _mm_or_si128( _mm_and_si128( alphaMask, alphaR ), _mm_andnot_si128( alphaMask, color ) );
+		// pixels whose resulting alpha is zero keep their color
+		const __m128i keep = _mm_cmpeq_epi16( alphaR, zero );
+		return _mm_or_si128( _mm_and_si128( keep, d ), _mm_andnot_si128( keep, result ) );
+	};
+
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		__m128i *dstPtr = reinterpret_cast<__m128i*>( dst + x * 4 );
+		const __m128i d = _mm_loadu_si128( dstPtr );
+		const __m128i s = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + x * 4 ) );
+		const __m128i lo = blend16( _mm_unpacklo_epi8( d, zero ), _mm_unpacklo_epi8( s, zero ) );
+		const __m128i hi = blend16( _mm_unpackhi_epi8( d, zero ), _mm_unpackhi_epi8( s, zero ) );
+		_mm_storeu_si128( dstPtr, _mm_packus_epi16( lo, hi ) );
+	}
+	return x;
+}
+
+template<int ALPHA>
+int32_t blendPremultRowSse2( float *dst, const float *src, int32_t width )
+{
+	const __m128 one = _mm_set1_ps( 1.0f ), zero = _mm_setzero_ps();
+	const __m128 alphaMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? -1 : 0, 0, 0, ALPHA == 3 ? -1 : 0 ) );
+	for( int32_t x = 0; x < width; ++x ) {
+		const __m128 d = _mm_loadu_ps( dst + x * 4 );
+		const __m128 s = _mm_loadu_ps( src + x * 4 );
+		const __m128 alphaS = _mm_shuffle_ps( s, s, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		const __m128 alphaD = _mm_shuffle_ps( d, d, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		const __m128 invAlphaS = _mm_sub_ps( one, alphaS ), invAlphaD = _mm_sub_ps( one, alphaD );
+		const __m128 alphaR = _mm_sub_ps( one, _mm_mul_ps( invAlphaS, invAlphaD ) );
+		const __m128 color = _mm_add_ps( _mm_add_ps( _mm_mul_ps( invAlphaS, d ), _mm_mul_ps( invAlphaD, s ) ), _mm_mul_ps( alphaD, s ) );
+		__m128 result = _mm_or_ps( _mm_and_ps( alphaMask, alphaR ), _mm_andnot_ps( alphaMask, color ) );
+		const __m128 keep = _mm_cmpeq_ps( alphaR, zero );
+		_mm_storeu_ps( dst + x * 4, _mm_or_ps( _mm_and_ps( keep, d ), _mm_andnot_ps( keep, result ) ) );
+	}
+	return width;
+}
+
+#elif defined( CINDER_SIMD_NEON )
+
+int32_t blendPremultRowNeon( uint8_t *dst, const uint8_t *src, int32_t width, uint8_t alphaOffset )
+{
+	const uint16x8_t one = vdupq_n_u16( 1 );
+	auto div255 = [&]( uint16x8_t x ) { return vshrn_n_u16( vaddq_u16( vaddq_u16( x, one ), vshrq_n_u16( x, 8 ) ), 8 ); };
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8 ) {
+		uint8x8x4_t d = vld4_u8( dst + x * 4 );
+		const uint8x8x4_t s = vld4_u8( src + x * 4 );
+		const uint8x8_t invAlphaS = vmvn_u8( s.val[alphaOffset] ), invAlphaD = vmvn_u8( d.val[alphaOffset] );
+		const uint8x8_t alphaR = vmvn_u8( div255( vmull_u8( invAlphaS, invAlphaD ) ) );
+		const uint8x8_t keep = vceq_u8( alphaR, vdup_n_u8( 0 ) );
+		for( uint8_t c = 0; c < 4; ++c ) {
+			if( c != alphaOffset )
+				d.val[c] = vbsl_u8( keep, d.val[c], vadd_u8( s.val[c], div255( vmull_u8( invAlphaS, d.val[c] ) ) ) );
+		}
+		d.val[alphaOffset] = alphaR;
+		vst4_u8( dst + x * 4, d );
+	}
+	return x;
+}
+
+int32_t blendPremultRowNeon( float *dst, const float *src, int32_t width, uint8_t alphaOffset )
+{
+	const float32x4_t one = vdupq_n_f32( 1.0f );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		float32x4x4_t d = vld4q_f32( dst + x * 4 );
+		const float32x4x4_t s = vld4q_f32( src + x * 4 );
+		const float32x4_t alphaD = d.val[alphaOffset];
+		const float32x4_t invAlphaS = vsubq_f32( one, s.val[alphaOffset] ), invAlphaD = vsubq_f32( one, alphaD );
+		const float32x4_t alphaR = vsubq_f32( one, vmulq_f32( invAlphaS, invAlphaD ) );
+		const uint32x4_t keep = vceqq_f32( alphaR, vdupq_n_f32( 0 ) );
+		for( uint8_t c = 0; c < 4; ++c ) {
+			if( c != alphaOffset ) {
+				const float32x4_t color = vaddq_f32( vaddq_f32( vmulq_f32( invAlphaS, d.val[c] ), vmulq_f32( invAlphaD, s.val[c] ) ), vmulq_f32( alphaD, s.val[c] ) );
+				d.val[c] = vbslq_f32( keep, d.val[c], color );
+			}
+		}
+		d.val[alphaOffset] = alphaR;
+		vst4q_f32( dst + x * 4, d );
+	}
+	return x;
+}
+
+#endif
+
+// Runs the SIMD premult * premult kernel over as much of the row as possible, returning the number of pixels handled
+template<typename T>
+int32_t blendPremultRowSimd( SurfaceT<T> *background, const SurfaceT<T> &foreground, T *dst, const T *src, int32_t width )
+{
+	if( background->getPixelInc() != 4 || background->getChannelOrder().getCode() != foreground.getChannelOrder().getCode() )
+		return 0;
+#if defined( CINDER_SIMD_SSE2 )
+	return ( background->getAlphaOffset() == 0 ) ? blendPremultRowSse2<0>( dst, src, width ) : blendPremultRowSse2<3>( dst, src, width );
+#elif defined( CINDER_SIMD_NEON )
+	return blendPremultRowNeon( dst, src, width, background->getAlphaOffset() );
+#else
+	return 0;
+#endif
+}
+
+// Blends rows [rowBegin, rowEnd) of srcArea, which is relative to foreground, onto background at absOffset. Assumes foreground has alpha.
 template<bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
-void blendImpl_u8( Surface8u *background, const Surface8u &foreground, const Area &srcArea, ivec2 absOffset )
+void blendImpl( Surface8u *background, const Surface8u &foreground, const Area &srcArea, ivec2 absOffset, int32_t rowBegin, int32_t rowEnd )
 {
-	bool SRCALPHA = foreground.hasAlpha();
 	const ptrdiff_t srcRowBytes = foreground.getRowBytes();
 	const uint8_t sR = foreground.getChannelOrder().getRedOffset();
 	const uint8_t sG = foreground.getChannelOrder().getGreenOffset();
 	const uint8_t sB = foreground.getChannelOrder().getBlueOffset();
-	const uint8_t sA = SRCALPHA ? (foreground.getChannelOrder().getAlphaOffset()) : 0;	
+	const uint8_t sA = foreground.getChannelOrder().getAlphaOffset();
 	const uint8_t srcInc = foreground.getPixelInc();
 	const ptrdiff_t dstRowBytes = background->getRowBytes();
 	const uint8_t dR = background->getChannelOrder().getRedOffset();
@@ -53,20 +183,18 @@ void blendImpl_u8( Surface8u *background, const Surface8u &foreground, const Are
 	const uint8_t dstInc = background->getPixelInc();
 	const int32_t width = srcArea.getWidth();
 	
-	if( ! SRCALPHA ) {// normal blend with no src alpha is a copy
-		ivec2 relativeOffset = absOffset - srcArea.getUL();
-		background->copyFrom( foreground, srcArea, relativeOffset );
-		if( DSTALPHA )
-			ip::fill( &background->getChannelAlpha(), (uint8_t)255 );
-		return;
-	}
-	
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const uint8_t *src = reinterpret_cast<const uint8_t*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		uint8_t *dst = reinterpret_cast<uint8_t*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
-		for( int32_t x = 0; x < width; ++x ) {
-			const uint8_t alphaS = (SRCALPHA) ? src[sA] : 255;
-			const uint8_t invAlphaS = (SRCALPHA) ? CHANTRAIT<uint8_t>::inverse(src[sA]) : 0;
+	for( int32_t y = rowBegin; y < rowEnd; ++y ) {
+		const uint8_t *src = reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * srcInc ) + ( srcArea.y1 + y ) * srcRowBytes;
+		uint8_t *dst = reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * dstInc ) + ( y + absOffset.y ) * dstRowBytes;
+		int32_t x = 0;
+		if( DSTALPHA && DSTPREMULT && SRCPREMULT ) {
+			x = blendPremultRowSimd( background, foreground, dst, src, width );
+			src += x * srcInc;
+			dst += x * dstInc;
+		}
+		for( ; x < width; ++x ) {
+			const uint8_t alphaS = src[sA];
+			const uint8_t invAlphaS = CHANTRAIT<uint8_t>::inverse(src[sA]);
 			const uint8_t alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<uint8_t>::max();
 			const uint8_t invAlphaD = (DSTALPHA) ? CHANTRAIT<uint8_t>::inverse(dst[dA]) : 0;
 			if( DSTALPHA )
@@ -110,14 +238,13 @@ void blendImpl_u8( Surface8u *background, const Surface8u &foreground, const Are
 }
 
 template<bool DSTALPHA, bool DSTPREMULT, bool SRCPREMULT>
-void blendImpl_float( Surface32f *background, const Surface32f &foreground, const Area &srcArea, ivec2 absOffset )
+void blendImpl( Surface32f *background, const Surface32f &foreground, const Area &srcArea, ivec2 absOffset, int32_t rowBegin, int32_t rowEnd )
 {
-	bool SRCALPHA = foreground.hasAlpha();
 	const ptrdiff_t srcRowBytes = foreground.getRowBytes();
 	const uint8_t sR = foreground.getChannelOrder().getRedOffset();
 	const uint8_t sG = foreground.getChannelOrder().getGreenOffset();
 	const uint8_t sB = foreground.getChannelOrder().getBlueOffset();
-	const uint8_t sA = SRCALPHA ? (foreground.getChannelOrder().getAlphaOffset()) : 0;	
+	const uint8_t sA = foreground.getChannelOrder().getAlphaOffset();
 	const uint8_t srcInc = foreground.getPixelInc();
 	const ptrdiff_t dstRowBytes = background->getRowBytes();
 	const uint8_t dR = background->getChannelOrder().getRedOffset();
@@ -127,20 +254,18 @@ void blendImpl_float( Surface32f *background, const Surface32f &foreground, cons
 	const uint8_t dstInc = background->getPixelInc();	
 	const int32_t width = srcArea.getWidth();
 	
-	if( ! SRCALPHA ) {// normal blend with no src alpha is a copy
-		ivec2 relativeOffset = absOffset - srcArea.getUL();
-		background->copyFrom( foreground, srcArea, relativeOffset );
-		if( DSTALPHA )
-			ip::fill( &background->getChannelAlpha(), 1.0f );
-		return;
-	}
-	
-	for( int32_t y = 0; y < srcArea.getHeight(); ++y ) {
-		const float *src = reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * 4 ) + ( srcArea.y1 + y ) * srcRowBytes );
-		float *dst = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * 4 ) + ( y + absOffset.y ) * dstRowBytes );
-		for( int32_t x = 0; x < width; ++x ) {
-			const float alphaS = (SRCALPHA) ? src[sA] : 1;
-			const float invAlphaS = (SRCALPHA) ? CHANTRAIT<float>::inverse(src[sA]) : 0;
+	for( int32_t y = rowBegin; y < rowEnd; ++y ) {
+		const float *src = reinterpret_cast<const float*>( reinterpret_cast<const uint8_t*>( foreground.getData() + srcArea.x1 * srcInc ) + ( srcArea.y1 + y ) * srcRowBytes );
+		float *dst = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( background->getData() + absOffset.x * dstInc ) + ( y + absOffset.y ) * dstRowBytes );
+		int32_t x = 0;
+		if( DSTALPHA && DSTPREMULT && SRCPREMULT ) {
+			x = blendPremultRowSimd( background, foreground, dst, src, width );
+			src += x * srcInc;
+			dst += x * dstInc;
+		}
+		for( ; x < width; ++x ) {
+			const float alphaS = src[sA];
+			const float invAlphaS = CHANTRAIT<float>::inverse(src[sA]);
 			const float alphaD = (DSTALPHA) ? dst[dA] : CHANTRAIT<float>::max();
 			const float invAlphaD = (DSTALPHA) ? CHANTRAIT<float>::inverse(dst[dA]) : 0;
 			if( DSTALPHA )
@@ -185,54 +310,100 @@ void blendImpl_float( Surface32f *background, const Surface32f &foreground, cons
 	}
 }
 
-void blend( Surface8u *background, const Surface8u &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
+// Blends rows [rowBegin, rowEnd) of an already clipped srcArea, selecting the implementation for the surfaces' alpha and premultiplication
+template<typename T>
+void blendRows( SurfaceT<T> *background, const SurfaceT<T> &foreground, const Area &srcArea, const ivec2 &absOffset, int32_t rowBegin, int32_t rowEnd )
 {
-	pair<Area,ivec2> srcDst = clippedSrcDst( foreground.getBounds(), srcArea, background->getBounds(), srcArea.getUL() + dstRelativeOffset );	
+	if( ! foreground.hasAlpha() ) { // normal blend with no src alpha is a copy
+		const Area rowsArea( srcArea.x1, srcArea.y1 + rowBegin, srcArea.x2, srcArea.y1 + rowEnd );
+		background->copyFrom( foreground, rowsArea, absOffset - srcArea.getUL() );
+		if( background->hasAlpha() )
+			ip::fill( &background->getChannelAlpha(), CHANTRAIT<T>::max(), Area( absOffset.x, absOffset.y + rowBegin, absOffset.x + srcArea.getWidth(), absOffset.y + rowEnd ) );
+		return;
+	}
+
 	if( background->hasAlpha() ) {
 		if( background->isPremultiplied() ) {
 			if( foreground.isPremultiplied() )
-				blendImpl_u8<true, true, true>( background, foreground, srcDst.first, srcDst.second );
+				blendImpl<true, true, true>( background, foreground, srcArea, absOffset, rowBegin, rowEnd );
 			else
-				blendImpl_u8<true, true, false>( background, foreground, srcDst.first, srcDst.second );
+				blendImpl<true, true, false>( background, foreground, srcArea, absOffset, rowBegin, rowEnd );
 		}
 		else { // background unpremult
 			if( foreground.isPremultiplied() )
-				blendImpl_u8<true, false, true>( background, foreground, srcDst.first, srcDst.second );
+				blendImpl<true, false, true>( background, foreground, srcArea, absOffset, rowBegin, rowEnd );
 			else
-				blendImpl_u8<true, false, false>( background, foreground, srcDst.first, srcDst.second );
+				blendImpl<true, false, false>( background, foreground, srcArea, absOffset, rowBegin, rowEnd );
 		}
 	}
 	else { // background no alpha
 		if( foreground.isPremultiplied() )
-			blendImpl_u8<false, false, true>( background, foreground, srcDst.first, srcDst.second );
+			blendImpl<false, false, true>( background, foreground, srcArea, absOffset, rowBegin, rowEnd );
 		else
-			blendImpl_u8<false, false, false>( background, foreground, srcDst.first, srcDst.second );	
+			blendImpl<false, false, false>( background, foreground, srcArea, absOffset, rowBegin, rowEnd );
+	}
+}
+
+template<typename T>
+void blendLayers( SurfaceT<T> *background, const std::vector<const SurfaceT<T>*> &layers, const Options &options )
+{
+	struct ClippedLayer {
+		const SurfaceT<T>	*surface;
+		Area				srcArea;
+		ivec2				absOffset;
+	};
+
+	vector<ClippedLayer> clipped;
+	for( const SurfaceT<T> *layer : layers ) {
+		pair<Area,ivec2> srcDst = clippedSrcDst( layer->getBounds(), layer->getBounds(), background->getBounds(), ivec2() );
+		if( srcDst.first.getWidth() > 0 && srcDst.first.getHeight() > 0 )
+			clipped.push_back( { layer, srcDst.first, srcDst.second } );
 	}
+	if( clipped.empty() )
+		return;
+
+	// each tile of the background is composited with every layer before moving on, so it stays in cache across layers
+	const int32_t tileRows = std::max<int32_t>( 1, (int32_t)( ( 256 * 1024 ) / std::max<ptrdiff_t>( background->getRowBytes(), 1 ) ) );
+	const Area bounds = background->getBounds();
+	parallelForRows( bounds.y1, bounds.y2, options, [&]( int32_t bandBegin, int32_t bandEnd ) {
+		for( int32_t tileBegin = bandBegin; tileBegin < bandEnd; tileBegin += tileRows ) {
+			const int32_t tileEnd = std::min( tileBegin + tileRows, bandEnd );
+			for( const ClippedLayer &layer : clipped ) {
+				const int32_t rowBegin = std::max( tileBegin, layer.absOffset.y ) - layer.absOffset.y;
+				const int32_t rowEnd = std::min( tileEnd, layer.absOffset.y + layer.srcArea.getHeight() ) - layer.absOffset.y;
+				if( rowBegin < rowEnd )
+					blendRows( background, *layer.surface, layer.srcArea, layer.absOffset, rowBegin, rowEnd );
+			}
+		}
+	} );
+}
+
+} // anonymous namespace
+
+void blend( Surface8u *background, const Surface8u &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
+{
+	background->detach();
+	pair<Area,ivec2> srcDst = clippedSrcDst( foreground.getBounds(), srcArea, background->getBounds(), srcArea.getUL() + dstRelativeOffset );	
+	blendRows( background, foreground, srcDst.first, srcDst.second, 0, srcDst.first.getHeight() );
 }
 
 void blend( Surface32f *background, const Surface32f &foreground, const Area &srcArea, const ivec2 &dstRelativeOffset )
 {
+	background->detach();
 	pair<Area,ivec2> srcDst = clippedSrcDst( foreground.getBounds(), srcArea, background->getBounds(), srcArea.getUL() + dstRelativeOffset );
-	if( background->hasAlpha() ) {
-		if( background->isPremultiplied() ) {
-			if( foreground.isPremultiplied() )
-				blendImpl_float<true, true, true>( background, foreground, srcDst.first, srcDst.second );
-			else
-				blendImpl_float<true, true, false>( background, foreground, srcDst.first, srcDst.second );
-		}
-		else {
-			if( foreground.isPremultiplied() )
-				blendImpl_float<true, false, true>( background, foreground, srcDst.first, srcDst.second );
-			else
-				blendImpl_float<true, false, false>( background, foreground, srcDst.first, srcDst.second );
-		}
-	}
-	else { // background no alpha
-		if( foreground.isPremultiplied() )
-			blendImpl_float<false, false, true>( background, foreground, srcDst.first, srcDst.second );
-		else
-			blendImpl_float<false, false, false>( background, foreground, srcDst.first, srcDst.second );	
-	}
+	blendRows( background, foreground, srcDst.first, srcDst.second, 0, srcDst.first.getHeight() );
+}
+
+void blend( Surface8u *background, const std::vector<const Surface8u*> &layers, const Options &options )
+{
+	background->detach();
+	blendLayers( background, layers, options );
+}
+
+void blend( Surface32f *background, const std::vector<const Surface32f*> &layers, const Options &options )
+{
+	background->detach();
+	blendLayers( background, layers, options );
 }
 
 } } // namespace cinder::ip
@@ -21,6 +21,15 @@
 */
 
 #include "cinder/ip/Blur.h"
+#include "cinder/Simd.h"
+#include "cinder/SurfacePool.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <numeric>
+#include <type_traits>
+#include <vector>
 
 namespace cinder { namespace ip { 
 
@@ -208,6 +217,19 @@ void stackBlur_impl( const IMAGET &srcSurface, IMAGET *dstSurface, const Area &a
 	free( tempPixelData );
 }
 
+// clone() which draws from the SurfacePool in \a options when there is one
+template<typename T>
+SurfaceT<T> cloneSurface( const SurfaceT<T> &surface, bool copyPixels, const Options &options )
+{
+	if( ! options.getPool() )
+		return surface.clone( copyPixels );
+
+	SurfaceT<T> result = options.getPool()->acquire<T>( surface.getWidth(), surface.getHeight(), surface.hasAlpha(), surface.getChannelOrder() );
+	if( copyPixels )
+		result.copyFrom( surface, surface.getBounds() );
+	return result;
+}
+
 } // anonymous namespace
 
 ///////////////////////////////////////////////////////////////////////////////////
@@ -217,6 +239,7 @@ void stackBlur( Surface8u *surface, int radius )
 	if( radius < 1 )
 		return;
 
+	surface->detach();
 	if( surface->hasAlpha() )
 		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( *surface, surface, surface->getBounds(), radius );
 	else
@@ -228,6 +251,7 @@ void stackBlur( Surface8u *surface, const Area &area, int radius )
 	if( radius < 1 )
 		return;
 
+	surface->detach();
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	if( surface->hasAlpha() )
 		stackBlur_impl<uint8_t,int32_t,Surface8u,4>( *surface, surface, clippedArea, radius );
@@ -282,6 +306,7 @@ void stackBlur( Surface16u *surface, int radius )
 	if( radius < 1 )
 		return;
 
+	surface->detach();
 	if( surface->hasAlpha() )
 		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( *surface, surface, surface->getBounds(), radius );
 	else
@@ -293,6 +318,7 @@ void stackBlur( Surface16u *surface, const Area &area, int radius )
 	if( radius < 1 )
 		return;
 
+	surface->detach();
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	if( surface->hasAlpha() )
 		stackBlur_impl<uint16_t,int64_t,Surface16u,4>( *surface, surface, clippedArea, radius );
@@ -347,6 +373,7 @@ void stackBlur( Surface32f *surface, int radius )
 	if( radius < 1 )
 		return;
 
+	surface->detach();
 	if( surface->hasAlpha() )
 		stackBlur_impl<float,float,Surface32f,4>( *surface, surface, surface->getBounds(), radius );
 	else
@@ -358,6 +385,7 @@ void stackBlur( Surface32f *surface, const Area &area, int radius )
 	if( radius < 1 )
 		return;
 
+	surface->detach();
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	if( surface->hasAlpha() )
 		stackBlur_impl<float,float,Surface32f,4>( *surface, surface, clippedArea, radius );
@@ -405,4 +433,498 @@ Channel32f stackBlurCopy( const Channel32f &channel, int radius )
 	return result;
 }
 
+///////////////////////////////////////////////////////////////////////////////////
+// Separable blur engine used by gaussianBlur() and boxBlur()
+//
+// The image is processed as lines of interleaved float lanes: 1 lane for a Channel and 4 for a Surface (the 4th is
+// padding when there is no alpha, which keeps every pixel a single SIMD vector). The image is blurred in tiles of rows.
+// The horizontal pass over a tile's rows, plus the rows within the filter's support above and below it, is written
+// transposed into a scratch buffer the size of the tile, so that the vertical pass can also run over contiguous memory
+// rather than striding down columns. Tiles are distributed across threads in bands.
+namespace {
+
+const int32_t BLUR_TILE_SIZE = 16;
+// the minimum number of rows in a tile; tiles are at least twice the filter's support, so that rereading the rows
+// around a tile costs at most as much as the tile itself
+const int32_t BLUR_TILE_MIN_ROWS = 64;
+// from this sigma up, gaussianBlur() approximates the Gaussian with box passes, whose cost per pixel doesn't grow with sigma. Below it
+// the exact kernel is short enough to be cheaper, and the box approximation's error of a few percent of the peak is more visible.
+const float		GAUSSIAN_BOX_MIN_SIGMA = 8.0f;
+const int32_t	GAUSSIAN_BOX_PASSES = 5;
+
+// Describes the pixels of an Area of a Surface or Channel as up to 4 interleaved channels
+template<typename T>
+struct BlurImageView {
+	BlurImageView( const SurfaceT<T> &surface, const Area &area )
+		: mData( reinterpret_cast<const uint8_t*>( surface.getData( area.getUL() ) ) ), mRowBytes( surface.getRowBytes() ), mPixelInc( surface.getPixelInc() ),
+		mWidth( area.getWidth() ), mHeight( area.getHeight() ), mNumLanes( 4 ), mNumChannels( surface.hasAlpha() ? 4 : 3 )
+	{
+		mOffsets[0] = surface.getRedOffset();
+		mOffsets[1] = surface.getGreenOffset();
+		mOffsets[2] = surface.getBlueOffset();
+		mOffsets[3] = surface.hasAlpha() ? surface.getAlphaOffset() : 0;
+	}
+
+	BlurImageView( const ChannelT<T> &channel, const Area &area )
+		: mData( reinterpret_cast<const uint8_t*>( channel.getData( area.getUL() ) ) ), mRowBytes( channel.getRowBytes() ), mPixelInc( channel.getIncrement() ),
+		mWidth( area.getWidth() ), mHeight( area.getHeight() ), mNumLanes( 1 ), mNumChannels( 1 )
+	{
+		mOffsets[0] = mOffsets[1] = mOffsets[2] = mOffsets[3] = 0;
+	}
+
+	const T*	getPixel( int32_t x, int32_t y ) const { return reinterpret_cast<const T*>( mData + y * mRowBytes ) + x * mPixelInc; }
+	T*			getPixel( int32_t x, int32_t y ) { return const_cast<T*>( reinterpret_cast<const T*>( mData + y * mRowBytes ) + x * mPixelInc ); }
+
+	const uint8_t	*mData;
+	ptrdiff_t		mRowBytes;
+	uint8_t			mPixelInc;
+	int32_t			mWidth, mHeight;
+	int32_t			mNumLanes, mNumChannels;
+	uint8_t			mOffsets[4];
+};
+
+template<typename T>
+inline T blurFloatToChannel( float v )
+{
+	if( std::numeric_limits<T>::is_integer )
+		return static_cast<T>( std::min<float>( std::max<float>( v + 0.5f, 0.0f ), (float)std::numeric_limits<T>::max() ) );
+	else
+		return static_cast<T>( v );
+}
+
+// Copies \a n lanes-wide values to \a padded starting at \a radius pixels in, and replicates the edge pixels \a radius times on either side
+inline void blurPadLine( float *padded, int32_t n, int32_t numLanes, int32_t radius )
+{
+	float *first = padded + radius * numLanes, *last = padded + ( radius + n - 1 ) * numLanes;
+	for( int32_t i = 0; i < radius; ++i ) {
+		std::copy( first, first + numLanes, padded + i * numLanes );
+		std::copy( last, last + numLanes, last + ( i + 1 ) * numLanes );
+	}
+}
+
+// Convolves the padded line \a in with the symmetric \a kernel of size 2 * radius + 1. Each output element only depends on
+// the same lane of its neighbors, so the line is processed as a flat array which vectorizes regardless of the lane count.
+void blurConvolveLine( const float *in, float *out, int32_t n, int32_t numLanes, const float *kernel, int32_t radius )
+{
+	const int32_t size = n * numLanes, kernelSize = 2 * radius + 1;
+	int32_t j = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	for( ; j + 4 <= size; j += 4 ) {
+		__m128 sum = _mm_setzero_ps();
+		for( int32_t k = 0; k < kernelSize; ++k )
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( kernel[k] ), _mm_loadu_ps( in + j + k * numLanes ) ) );
+		_mm_storeu_ps( out + j, sum );
+	}
+#elif defined( CINDER_SIMD_NEON )
+	for( ; j + 4 <= size; j += 4 ) {
+		float32x4_t sum = vdupq_n_f32( 0 );
+		for( int32_t k = 0; k < kernelSize; ++k )
+			sum = vaddq_f32( sum, vmulq_n_f32( vld1q_f32( in + j + k * numLanes ), kernel[k] ) );
+		vst1q_f32( out + j, sum );
+	}
+#endif
+	for( ; j < size; ++j ) {
+		float sum = 0;
+		for( int32_t k = 0; k < kernelSize; ++k )
+			sum += kernel[k] * in[j + k * numLanes];
+		out[j] = sum;
+	}
+}
+
+// Box filters the padded line \a in with a sliding sum, which costs O(1) per pixel regardless of \a radius
+void blurBoxLine( const float *in, float *out, int32_t n, int32_t numLanes, int32_t radius )
+{
+	const float scale = 1.0f / ( 2 * radius + 1 );
+	const int32_t window = ( 2 * radius + 1 ) * numLanes;
+#if defined( CINDER_SIMD_SSE2 )
+	if( numLanes == 4 ) {
+		const __m128 scaleV = _mm_set1_ps( scale );
+		__m128 sum = _mm_setzero_ps();
+		for( int32_t i = 0; i < window; i += 4 )
+			sum = _mm_add_ps( sum, _mm_loadu_ps( in + i ) );
+		for( int32_t x = 0; x < n; ++x, in += 4, out += 4 ) {
+			_mm_storeu_ps( out, _mm_mul_ps( sum, scaleV ) );
+			if( x + 1 < n )
+				sum = _mm_add_ps( sum, _mm_sub_ps( _mm_loadu_ps( in + window ), _mm_loadu_ps( in ) ) );
+		}
+		return;
+	}
+#elif defined( CINDER_SIMD_NEON )
+	if( numLanes == 4 ) {
+		float32x4_t sum = vdupq_n_f32( 0 );
+		for( int32_t i = 0; i < window; i += 4 )
+			sum = vaddq_f32( sum, vld1q_f32( in + i ) );
+		for( int32_t x = 0; x < n; ++x, in += 4, out += 4 ) {
+			vst1q_f32( out, vmulq_n_f32( sum, scale ) );
+			if( x + 1 < n )
+				sum = vaddq_f32( sum, vsubq_f32( vld1q_f32( in + window ), vld1q_f32( in ) ) );
+		}
+		return;
+	}
+#endif
+	for( int32_t l = 0; l < numLanes; ++l ) {
+		float sum = 0;
+		for( int32_t i = l; i < window; i += numLanes )
+			sum += in[i];
+		for( int32_t x = 0; x < n; ++x ) {
+			const int32_t j = x * numLanes + l;
+			out[j] = sum * scale;
+			if( x + 1 < n )
+				sum += in[j + window] - in[j];
+		}
+	}
+}
+
+// Blurs a single line in place in \a line (which has room for padding on either side); \a scratch is the same size as \a line.
+// Either convolves with \a kernel, or applies a box filter of each of \a boxRadii in turn.
+struct BlurLineFilter {
+	BlurLineFilter( const std::vector<float> &kernel, const std::vector<int32_t> &boxRadii )
+		: mKernel( kernel ), mBoxRadii( boxRadii )
+	{}
+
+	int32_t		getPadding() const { return mKernel.empty() ? *std::max_element( mBoxRadii.begin(), mBoxRadii.end() ) : (int32_t)mKernel.size() / 2; }
+	//! the number of pixels on either side of an output pixel that affect it, which is the sum of the radii of the box passes
+	int32_t		getSupport() const { return mKernel.empty() ? std::accumulate( mBoxRadii.begin(), mBoxRadii.end(), 0 ) : (int32_t)mKernel.size() / 2; }
+
+	// \a line holds the unpadded input starting at getPadding() pixels in; returns a pointer to the unpadded result
+	const float*	apply( float *line, float *scratch, int32_t n, int32_t numLanes ) const
+	{
+		const int32_t padding = getPadding();
+		if( ! mKernel.empty() ) {
+			blurPadLine( line, n, numLanes, padding );
+			blurConvolveLine( line, scratch, n, numLanes, mKernel.data(), padding );
+			return scratch;
+		}
+
+		for( int32_t radius : mBoxRadii ) {
+			blurPadLine( line, n, numLanes, padding );
+			blurBoxLine( line + ( padding - radius ) * numLanes, scratch + padding * numLanes, n, numLanes, radius );
+			std::swap( line, scratch );
+		}
+		return line + padding * numLanes;
+	}
+
+	std::vector<float>		mKernel;
+	std::vector<int32_t>	mBoxRadii;
+};
+
+// Copies of the source rows [mBegin, mEnd), for blurring in place, where the tile that writes those rows may run before a tile that reads them
+template<typename T>
+struct BlurSavedRows {
+	BlurSavedRows()
+		: mBegin( 0 ), mEnd( 0 ), mRowElements( 0 )
+	{}
+
+	void save( const BlurImageView<T> &src, int32_t begin, int32_t end )
+	{
+		mBegin = std::max<int32_t>( begin, 0 );
+		mEnd = std::min<int32_t>( end, src.mHeight );
+		mRowElements = (size_t)src.mWidth * src.mPixelInc;
+		mData.resize( mRowElements * std::max<int32_t>( mEnd - mBegin, 0 ) );
+		for( int32_t y = mBegin; y < mEnd; ++y )
+			std::copy( src.getPixel( 0, y ), src.getPixel( 0, y ) + mRowElements, mData.data() + ( y - mBegin ) * mRowElements );
+	}
+
+	bool		contains( int32_t y ) const { return y >= mBegin && y < mEnd; }
+	const T*	getRow( int32_t y ) const { return mData.data() + ( y - mBegin ) * mRowElements; }
+
+	int32_t			mBegin, mEnd;
+	size_t			mRowElements;
+	std::vector<T>	mData;
+};
+
+template<typename T>
+void separableBlur( const BlurImageView<T> &src, BlurImageView<T> *dst, const BlurLineFilter &filter, const Options &options )
+{
+	const int32_t width = src.mWidth, height = src.mHeight, numLanes = src.mNumLanes, numChannels = src.mNumChannels;
+	if( width <= 0 || height <= 0 )
+		return;
+
+	const int32_t padding = filter.getPadding(), support = filter.getSupport();
+	const int32_t tileRows = std::max<int32_t>( BLUR_TILE_MIN_ROWS, 2 * support );
+	const int32_t numTiles = ( height + tileRows - 1 ) / tileRows;
+	// tiles are grouped into one band per thread, so that a band knows which of its neighbors' rows it reads
+	const int numBands = options.getNumThreadsForRows( numTiles );
+	auto bandBegin = [=]( int band ) { return std::min<int32_t>( height, (int32_t)( (int64_t)numTiles * band / numBands ) * tileRows ); };
+
+	// when blurring in place, the rows each band reads from its neighbors are saved before any band writes
+	const bool inPlace = ( src.mData == dst->mData );
+	std::vector<BlurSavedRows<T>> boundaryRows( inPlace ? numBands + 1 : 0 );
+	for( int band = 1; inPlace && band < numBands; ++band )
+		boundaryRows[band].save( src, bandBegin( band ) - support, bandBegin( band ) + support );
+
+	parallelForRows( 0, numBands, options, [&]( int32_t bandsBegin, int32_t bandsEnd ) {
+		const int32_t scratchRows = tileRows + 2 * support;
+		std::vector<float> line( ( std::max( width, scratchRows ) + 2 * padding ) * numLanes, 0.0f ), scratch( line.size(), 0.0f );
+		std::vector<float> tile( (size_t)BLUR_TILE_SIZE * std::max( width, scratchRows ) * numLanes );
+		// the horizontal result of the tile's rows and their support, stored transposed: row j of column x lives at ( x * numRows + j ) * numLanes.
+		// It stays in float, as rounding integer types here would add an error of up to half a step to each sample before the vertical pass.
+		std::vector<float> transposed( (size_t)width * scratchRows * numLanes );
+		// in place, the last rows written by this band's previous tile, as the next tile reads them too
+		BlurSavedRows<T> previousRows;
+
+		for( int band = bandsBegin; band < bandsEnd; ++band ) {
+			auto sourceRow = [&]( int32_t y ) -> const T* {
+				if( inPlace ) {
+					if( previousRows.contains( y ) )
+						return previousRows.getRow( y );
+					if( boundaryRows[band].contains( y ) )
+						return boundaryRows[band].getRow( y );
+					if( boundaryRows[band + 1].contains( y ) )
+						return boundaryRows[band + 1].getRow( y );
+				}
+				return src.getPixel( 0, y );
+			};
+
+			for( int32_t y0 = bandBegin( band ); y0 < bandBegin( band + 1 ); y0 += tileRows ) {
+				const int32_t y1 = std::min( y0 + tileRows, height );
+				const int32_t rowsBegin = std::max<int32_t>( 0, y0 - support ), rowsEnd = std::min<int32_t>( height, y1 + support );
+				const int32_t numRows = rowsEnd - rowsBegin;
+
+				// horizontal pass, in groups of rows which are written transposed; each column of a group is contiguous in the destination
+				for( int32_t g0 = 0; g0 < numRows; g0 += BLUR_TILE_SIZE ) {
+					const int32_t rows = std::min( BLUR_TILE_SIZE, numRows - g0 );
+					for( int32_t j = 0; j < rows; ++j ) {
+						const T *srcRow = sourceRow( rowsBegin + g0 + j );
+						float *lineData = line.data() + padding * numLanes;
+						for( int32_t x = 0; x < width; ++x ) {
+							const T *pixel = srcRow + x * src.mPixelInc;
+							for( int32_t c = 0; c < numChannels; ++c )
+								lineData[x * numLanes + c] = static_cast<float>( pixel[src.mOffsets[c]] );
+						}
+						const float *result = filter.apply( line.data(), scratch.data(), width, numLanes );
+						std::copy( result, result + width * numLanes, tile.data() + j * width * numLanes );
+					}
+					for( int32_t x = 0; x < width; ++x ) {
+						float *dstColumn = transposed.data() + ( (size_t)x * numRows + g0 ) * numLanes;
+						for( int32_t j = 0; j < rows; ++j ) {
+							const float *v = tile.data() + ( j * width + x ) * numLanes;
+							std::copy( v, v + numLanes, dstColumn + j * numLanes );
+						}
+					}
+				}
+
+				// in place, the next tile rereads the last rows of this one, which are about to be overwritten
+				if( inPlace && y1 < bandBegin( band + 1 ) )
+					previousRows.save( src, y1 - support, y1 );
+
+				// vertical pass, in groups of columns, each of which is a contiguous line of the transposed rows. The rows within the
+				// support at either end are only read, and are blurred against replicated edges only where they are the image's edges.
+				for( int32_t x0 = 0; x0 < width; x0 += BLUR_TILE_SIZE ) {
+					const int32_t columns = std::min( BLUR_TILE_SIZE, width - x0 );
+					for( int32_t j = 0; j < columns; ++j ) {
+						const float *srcColumn = transposed.data() + (size_t)( x0 + j ) * numRows * numLanes;
+						std::copy( srcColumn, srcColumn + numRows * numLanes, line.data() + padding * numLanes );
+						const float *result = filter.apply( line.data(), scratch.data(), numRows, numLanes );
+						std::copy( result, result + numRows * numLanes, tile.data() + j * numRows * numLanes );
+					}
+					for( int32_t y = y0; y < y1; ++y ) {
+						for( int32_t j = 0; j < columns; ++j ) {
+							const float *v = tile.data() + ( j * numRows + y - rowsBegin ) * numLanes;
+							T *pixel = dst->getPixel( x0 + j, y );
+							for( int32_t c = 0; c < numChannels; ++c )
+								pixel[dst->mOffsets[c]] = blurFloatToChannel<T>( v[c] );
+						}
+					}
+				}
+			}
+		}
+	} );
+}
+
+std::vector<float> makeGaussianKernel( float sigma )
+{
+	const int32_t radius = std::max<int32_t>( 1, (int32_t)std::ceil( sigma * 3.0f ) );
+	std::vector<float> kernel( 2 * radius + 1 );
+	float sum = 0;
+	for( int32_t i = -radius; i <= radius; ++i ) {
+		kernel[i + radius] = std::exp( -( i * i ) / ( 2.0f * sigma * sigma ) );
+		sum += kernel[i + radius];
+	}
+	for( auto &k : kernel )
+		k /= sum;
+
+	return kernel;
+}
+
+// Returns the radii of GAUSSIAN_BOX_PASSES box filters whose combined variance is closest to sigma^2, after Kovesi, "Fast Almost-Gaussian
+// Filtering" (2010): the passes use the two odd widths around the ideal width, as many of the smaller as brings the variance closest.
+std::vector<int32_t> makeGaussianBoxRadii( float sigma )
+{
+	const int32_t n = GAUSSIAN_BOX_PASSES;
+	const float variance12 = 12.0f * sigma * sigma;
+	int32_t lower = (int32_t)std::sqrt( variance12 / n + 1.0f );
+	if( lower % 2 == 0 )
+		--lower;
+	const int32_t numLower = std::clamp<int32_t>( (int32_t)std::lround( ( variance12 - n * lower * lower - 4 * n * lower - 3 * n ) / ( -4.0f * lower - 4.0f ) ), 0, n );
+
+	std::vector<int32_t> radii( n, ( lower + 1 ) / 2 );
+	std::fill( radii.begin(), radii.begin() + numLower, ( lower - 1 ) / 2 );
+	return radii;
+}
+
+template<typename IMAGET>
+void gaussianBlurImpl( const IMAGET &src, const Area &srcArea, IMAGET *dst, const Area &dstArea, float sigma, const Options &options )
+{
+	typedef typename std::remove_reference<decltype( *src.getData() )>::type CONST_T;
+	typedef typename std::remove_const<CONST_T>::type T;
+	if( sigma <= 0 )
+		return;
+
+	BlurImageView<T> srcView( src, srcArea );
+	BlurImageView<T> dstView( *dst, dstArea );
+	if( sigma < GAUSSIAN_BOX_MIN_SIGMA )
+		separableBlur( srcView, &dstView, BlurLineFilter( makeGaussianKernel( sigma ), {} ), options );
+	else
+		separableBlur( srcView, &dstView, BlurLineFilter( {}, makeGaussianBoxRadii( sigma ) ), options );
+}
+
+template<typename IMAGET>
+void boxBlurImpl( const IMAGET &src, const Area &srcArea, IMAGET *dst, const Area &dstArea, int radius, int passes, const Options &options )
+{
+	typedef typename std::remove_reference<decltype( *src.getData() )>::type CONST_T;
+	typedef typename std::remove_const<CONST_T>::type T;
+	if( radius < 1 || passes < 1 )
+		return;
+
+	BlurImageView<T> srcView( src, srcArea );
+	BlurImageView<T> dstView( *dst, dstArea );
+	separableBlur( srcView, &dstView, BlurLineFilter( {}, std::vector<int32_t>( passes, radius ) ), options );
+}
+
+} // anonymous namespace
+
+template<typename T>
+void gaussianBlur( SurfaceT<T> *surface, float sigma, const Options &options )
+{
+	surface->detach();
+	gaussianBlurImpl( *surface, surface->getBounds(), surface, surface->getBounds(), sigma, options );
+}
+
+template<typename T>
+void gaussianBlur( SurfaceT<T> *surface, const Area &area, float sigma, const Options &options )
+{
+	surface->detach();
+	const Area clippedArea = area.getClipBy( surface->getBounds() );
+	gaussianBlurImpl( *surface, clippedArea, surface, clippedArea, sigma, options );
+}
+
+template<typename T>
+SurfaceT<T> gaussianBlurCopy( const SurfaceT<T> &surface, float sigma, const Options &options )
+{
+	SurfaceT<T> result = cloneSurface( surface, sigma <= 0, options );
+	gaussianBlurImpl( surface, surface.getBounds(), &result, result.getBounds(), sigma, options );
+	return result;
+}
+
+template<typename T>
+void gaussianBlur( ChannelT<T> *channel, float sigma, const Options &options )
+{
+	gaussianBlurImpl( *channel, channel->getBounds(), channel, channel->getBounds(), sigma, options );
+}
+
+template<typename T>
+void gaussianBlur( ChannelT<T> *channel, const Area &area, float sigma, const Options &options )
+{
+	const Area clippedArea = area.getClipBy( channel->getBounds() );
+	gaussianBlurImpl( *channel, clippedArea, channel, clippedArea, sigma, options );
+}
+
+template<typename T>
+ChannelT<T> gaussianBlurCopy( const ChannelT<T> &channel, float sigma, const Options &options )
+{
+	ChannelT<T> result = channel.clone( sigma <= 0 );
+	gaussianBlurImpl( channel, channel.getBounds(), &result, result.getBounds(), sigma, options );
+	return result;
+}
+
+template<typename T>
+void boxBlur( SurfaceT<T> *surface, int radius, int passes, const Options &options )
+{
+	surface->detach();
+	boxBlurImpl( *surface, surface->getBounds(), surface, surface->getBounds(), radius, passes, options );
+}
+
+template<typename T>
+void boxBlur( SurfaceT<T> *surface, const Area &area, int radius, int passes, const Options &options )
+{
+	surface->detach();
+	const Area clippedArea = area.getClipBy( surface->getBounds() );
+	boxBlurImpl( *surface, clippedArea, surface, clippedArea, radius, passes, options );
+}
+
+template<typename T>
+SurfaceT<T> boxBlurCopy( const SurfaceT<T> &surface, int radius, int passes, const Options &options )
+{
+	SurfaceT<T> result = cloneSurface( surface, radius < 1 || passes < 1, options );
+	boxBlurImpl( surface, surface.getBounds(), &result, result.getBounds(), radius, passes, options );
+	return result;
+}
+
+template<typename T>
+void boxBlur( ChannelT<T> *channel, int radius, int passes, const Options &options )
+{
+	boxBlurImpl( *channel, channel->getBounds(), channel, channel->getBounds(), radius, passes, options );
+}
+
+template<typename T>
+void boxBlur( ChannelT<T> *channel, const Area &area, int radius, int passes, const Options &options )
+{
+	const Area clippedArea = area.getClipBy( channel->getBounds() );
+	boxBlurImpl( *channel, clippedArea, channel, clippedArea, radius, passes, options );
+}
+
+template<typename T>
+ChannelT<T> boxBlurCopy( const ChannelT<T> &channel, int radius, int passes, const Options &options )
+{
+	ChannelT<T> result = channel.clone( radius < 1 || passes < 1 );
+	boxBlurImpl( channel, channel.getBounds(), &result, result.getBounds(), radius, passes, options );
+	return result;
+}
+
+template<typename T>
+void boxBlur( const IntegralImageT<T> &integralImage, int radius, ChannelT<T> *dstChannel, const Options &options )
+{
+	typedef typename IntegralImageT<T>::SumT SumT;
+	const int32_t width = std::min( integralImage.getWidth(), dstChannel->getWidth() );
+	const int32_t height = std::min( integralImage.getHeight(), dstChannel->getHeight() );
+	const int32_t imageWidth = integralImage.getWidth(), imageHeight = integralImage.getHeight();
+	const uint8_t dstInc = dstChannel->getIncrement();
+
+	parallelForRows( 0, height, options, [&]( int32_t rowBegin, int32_t rowEnd ) {
+		for( int32_t y = rowBegin; y < rowEnd; ++y ) {
+			const int32_t y1 = std::max( 0, y - radius ), y2 = std::min( imageHeight, y + radius + 1 );
+			T *dst = dstChannel->getData( 0, y );
+			for( int32_t x = 0; x < width; ++x, dst += dstInc ) {
+				const int32_t x1 = std::max( 0, x - radius ), x2 = std::min( imageWidth, x + radius + 1 );
+				const SumT count = (SumT)( x2 - x1 ) * ( y2 - y1 );
+				const SumT sum = integralImage.getSum( x1, y1, x2, y2 );
+				if( std::is_integral<T>::value )
+					*dst = static_cast<T>( ( sum + count / 2 ) / count );
+				else
+					*dst = static_cast<T>( sum / count );
+			}
+		}
+	} );
+}
+
+#define separableBlur_PROTOTYPES(T)\
+	template CI_API void gaussianBlur( SurfaceT<T> *surface, float sigma, const Options &options ); \
+	template CI_API void gaussianBlur( SurfaceT<T> *surface, const Area &area, float sigma, const Options &options ); \
+	template CI_API SurfaceT<T> gaussianBlurCopy( const SurfaceT<T> &surface, float sigma, const Options &options ); \
+	template CI_API void gaussianBlur( ChannelT<T> *channel, float sigma, const Options &options ); \
+	template CI_API void gaussianBlur( ChannelT<T> *channel, const Area &area, float sigma, const Options &options ); \
+	template CI_API ChannelT<T> gaussianBlurCopy( const ChannelT<T> &channel, float sigma, const Options &options ); \
+	template CI_API void boxBlur( SurfaceT<T> *surface, int radius, int passes, const Options &options ); \
+	template CI_API void boxBlur( SurfaceT<T> *surface, const Area &area, int radius, int passes, const Options &options ); \
+	template CI_API SurfaceT<T> boxBlurCopy( const SurfaceT<T> &surface, int radius, int passes, const Options &options ); \
+	template CI_API void boxBlur( ChannelT<T> *channel, int radius, int passes, const Options &options ); \
+	template CI_API void boxBlur( ChannelT<T> *channel, const Area &area, int radius, int passes, const Options &options ); \
+	template CI_API ChannelT<T> boxBlurCopy( const ChannelT<T> &channel, int radius, int passes, const Options &options ); \
+	template CI_API void boxBlur( const IntegralImageT<T> &integralImage, int radius, ChannelT<T> *dstChannel, const Options &options );
+
+separableBlur_PROTOTYPES(uint8_t)
+separableBlur_PROTOTYPES(uint16_t)
+separableBlur_PROTOTYPES(float)
+
 } } // namespace cinder::ip
@@ -98,16 +98,19 @@ Surface32f checkerboard32f( int32_t width, int32_t height, int32_t tileSize, con
 
 void checkerboard( Surface8u *surface, const Area &area, int32_t tileSize, const ColorA8u &evenColor, const ColorA8u &oddColor )
 {
+	surface->detach();
 	checkerboard_impl( surface, area, tileSize, evenColor, oddColor );
 }
 
 void checkerboard( Surface16u *surface, const Area &area, int32_t tileSize, const ColorAT<uint16_t> &evenColor, const ColorAT<uint16_t> &oddColor )
 {
+	surface->detach();
 	checkerboard_impl( surface, area, tileSize, evenColor, oddColor );
 }
 
 void checkerboard( Surface32f *surface, const Area &area, int32_t tileSize, const ColorAf &evenColor, const ColorAf &oddColor )
 {
+	surface->detach();
 	checkerboard_impl( surface, area, tileSize, evenColor, oddColor );
 }
 
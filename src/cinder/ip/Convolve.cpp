@@ -0,0 +1,641 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/Convolve.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/CinderAssert.h"
+#include "cinder/Simd.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace cinder { namespace ip {
+
+ConvolutionKernel::ConvolutionKernel( int32_t width, int32_t height, const std::vector<float> &weights, float bias )
+	: mWidth( width ), mHeight( height ), mBias( bias ), mSeparable( false ), mWeights( weights )
+{
+	CI_ASSERT_MSG( width > 0 && height > 0 && ( width & 1 ) && ( height & 1 ), "ConvolutionKernel width and height must be odd" );
+	CI_ASSERT_MSG( weights.size() == (size_t)width * height, "ConvolutionKernel requires width * height weights" );
+	mWeights.resize( (size_t)width * height, 0.0f );
+	detectSeparable();
+}
+
+ConvolutionKernel::ConvolutionKernel( int32_t width, int32_t height, std::initializer_list<float> weights, float bias )
+	: ConvolutionKernel( width, height, std::vector<float>( weights ), bias )
+{
+}
+
+ConvolutionKernel ConvolutionKernel::separable( const std::vector<float> &rowWeights, const std::vector<float> &columnWeights, float bias )
+{
+	std::vector<float> weights( rowWeights.size() * columnWeights.size() );
+	for( size_t y = 0; y < columnWeights.size(); ++y ) {
+		for( size_t x = 0; x < rowWeights.size(); ++x )
+			weights[y * rowWeights.size() + x] = columnWeights[y] * rowWeights[x];
+	}
+
+	ConvolutionKernel result( (int32_t)rowWeights.size(), (int32_t)columnWeights.size(), weights, bias );
+	// keep the factors as given rather than as recovered from their product
+	if( result.mWidth > 1 && result.mHeight > 1 ) {
+		result.mSeparable = true;
+		result.mRowWeights = rowWeights;
+		result.mColumnWeights = columnWeights;
+	}
+	return result;
+}
+
+ConvolutionKernel ConvolutionKernel::sobelX()
+{
+	return ConvolutionKernel( 3, 3, { -1, 0, 1,
+									  -2, 0, 2,
+									  -1, 0, 1 } );
+}
+
+ConvolutionKernel ConvolutionKernel::sobelY()
+{
+	return ConvolutionKernel( 3, 3, {  1,  2,  1,
+									   0,  0,  0,
+									  -1, -2, -1 } );
+}
+
+ConvolutionKernel& ConvolutionKernel::normalize()
+{
+	float sum = 0;
+	for( float w : mWeights )
+		sum += w;
+	if( sum != 0 ) {
+		for( float &w : mWeights )
+			w /= sum;
+		for( float &w : mRowWeights )
+			w /= sum;
+	}
+
+	return *this;
+}
+
+// A kernel is separable when it has rank 1. Taking the row and column through its largest weight as the factors,
+// every weight must then equal the product of the corresponding factors.
+void ConvolutionKernel::detectSeparable()
+{
+	mSeparable = false;
+	mRowWeights.clear();
+	mColumnWeights.clear();
+	// 1D kernels gain nothing from being split
+	if( mWidth == 1 || mHeight == 1 )
+		return;
+
+	size_t pivot = 0;
+	for( size_t i = 1; i < mWeights.size(); ++i ) {
+		if( std::fabs( mWeights[i] ) > std::fabs( mWeights[pivot] ) )
+			pivot = i;
+	}
+	const float pivotWeight = mWeights[pivot];
+	if( pivotWeight == 0 )
+		return;
+
+	const int32_t pivotRow = (int32_t)pivot / mWidth, pivotColumn = (int32_t)pivot % mWidth;
+	std::vector<float> rowWeights( mWeights.begin() + pivotRow * mWidth, mWeights.begin() + ( pivotRow + 1 ) * mWidth ), columnWeights( mHeight );
+	for( int32_t y = 0; y < mHeight; ++y )
+		columnWeights[y] = mWeights[y * mWidth + pivotColumn] / pivotWeight;
+
+	const float tolerance = std::fabs( pivotWeight ) * 1e-6f;
+	for( int32_t y = 0; y < mHeight; ++y ) {
+		for( int32_t x = 0; x < mWidth; ++x ) {
+			if( std::fabs( columnWeights[y] * rowWeights[x] - mWeights[y * mWidth + x] ) > tolerance )
+				return;
+		}
+	}
+
+	mSeparable = true;
+	mRowWeights.swap( rowWeights );
+	mColumnWeights.swap( columnWeights );
+}
+
+// Convolution converts each source row to a line of floats once, padded on either side by the kernel radius with the
+// border applied, and keeps the most recent kernel-height lines in a ring buffer. Each output row is then a weighted sum of
+// the lines in the ring, which is computed over the row as a flat array of interleaved lanes so that it vectorizes
+// regardless of the number of channels. Separable kernels store horizontally filtered lines in the ring instead, and
+// only the vertical factor is applied per output row. Bands of output rows are distributed across threads.
+namespace {
+
+// Returns the index in [0, n) sampled for index \a i under \a border, or -1 for a zero sample
+int32_t borderIndex( int32_t i, int32_t n, BorderMode border )
+{
+	if( i >= 0 && i < n )
+		return i;
+
+	switch( border ) {
+		case BorderMode::CLAMP:
+			return ( i < 0 ) ? 0 : n - 1;
+		case BorderMode::WRAP:
+			i %= n;
+			return ( i < 0 ) ? i + n : i;
+		case BorderMode::MIRROR: {
+			if( n == 1 )
+				return 0;
+			const int32_t period = 2 * n - 2;
+			i %= period;
+			if( i < 0 )
+				i += period;
+			return ( i < n ) ? i : period - i;
+		}
+		default:
+			return -1;
+	}
+}
+
+// Describes the pixels of a Surface or Channel as up to 4 interleaved lanes
+template<typename T>
+struct ConvolveImage {
+	ConvolveImage( const SurfaceT<T> &surface, bool alpha )
+		: mData( reinterpret_cast<const uint8_t*>( surface.getData() ) ), mRowBytes( surface.getRowBytes() ), mPixelInc( surface.getPixelInc() ),
+		mWidth( surface.getWidth() ), mHeight( surface.getHeight() ), mNumLanes( alpha ? 4 : 3 )
+	{
+		mOffsets[0] = surface.getRedOffset();
+		mOffsets[1] = surface.getGreenOffset();
+		mOffsets[2] = surface.getBlueOffset();
+		mOffsets[3] = alpha ? surface.getAlphaOffset() : 0;
+	}
+
+	ConvolveImage( const ChannelT<T> &channel )
+		: mData( reinterpret_cast<const uint8_t*>( channel.getData() ) ), mRowBytes( channel.getRowBytes() ), mPixelInc( channel.getIncrement() ),
+		mWidth( channel.getWidth() ), mHeight( channel.getHeight() ), mNumLanes( 1 )
+	{
+		mOffsets[0] = mOffsets[1] = mOffsets[2] = mOffsets[3] = 0;
+	}
+
+	const T*	getRow( int32_t y ) const { return reinterpret_cast<const T*>( mData + y * mRowBytes ); }
+	T*			getRow( int32_t y ) { return const_cast<T*>( reinterpret_cast<const T*>( mData + y * mRowBytes ) ); }
+	//! Returns whether each pixel is exactly its lanes in order, so that a run of pixels is a run of lanes
+	bool		isContiguous() const
+	{
+		for( int32_t c = 0; c < mNumLanes; ++c ) {
+			if( mOffsets[c] != c )
+				return false;
+		}
+		return mPixelInc == mNumLanes;
+	}
+	//! Returns the number of bytes from mData to the end of the last lane of the last row, which for a Channel of an interleaved Surface is less than mHeight * mRowBytes
+	size_t		getSpanBytes() const
+	{
+		const int32_t lastOffset = *std::max_element( mOffsets, mOffsets + mNumLanes );
+		return ( mHeight - 1 ) * mRowBytes + ( ( mWidth - 1 ) * mPixelInc + lastOffset + 1 ) * sizeof(T);
+	}
+	//! Returns whether the memory spanned by this image overlaps that of \a other
+	bool		overlaps( const ConvolveImage &other ) const
+	{
+		return mData < other.mData + other.getSpanBytes() && other.mData < mData + getSpanBytes();
+	}
+
+	const uint8_t	*mData;
+	ptrdiff_t		mRowBytes;
+	uint8_t			mPixelInc;
+	int32_t			mWidth, mHeight;
+	int32_t			mNumLanes;
+	uint8_t			mOffsets[4];
+};
+
+template<typename T>
+inline T convolveFloatToChannel( float v )
+{
+	if( std::numeric_limits<T>::is_integer )
+		return static_cast<T>( std::min<float>( std::max<float>( v + 0.5f, 0.0f ), (float)std::numeric_limits<T>::max() ) );
+	else
+		return static_cast<T>( v );
+}
+
+// Converts \a n contiguous values to float
+void convertToFloat( const uint8_t *src, float *dst, int32_t n )
+{
+	int32_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	const __m128i zero = _mm_setzero_si128();
+	for( ; i + 16 <= n; i += 16 ) {
+		__m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+		__m128i lo = _mm_unpacklo_epi8( v, zero ), hi = _mm_unpackhi_epi8( v, zero );
+		_mm_storeu_ps( dst + i, _mm_cvtepi32_ps( _mm_unpacklo_epi16( lo, zero ) ) );
+		_mm_storeu_ps( dst + i + 4, _mm_cvtepi32_ps( _mm_unpackhi_epi16( lo, zero ) ) );
+		_mm_storeu_ps( dst + i + 8, _mm_cvtepi32_ps( _mm_unpacklo_epi16( hi, zero ) ) );
+		_mm_storeu_ps( dst + i + 12, _mm_cvtepi32_ps( _mm_unpackhi_epi16( hi, zero ) ) );
+	}
+#elif defined( CINDER_SIMD_NEON )
+	for( ; i + 16 <= n; i += 16 ) {
+		uint8x16_t v = vld1q_u8( src + i );
+		uint16x8_t lo = vmovl_u8( vget_low_u8( v ) ), hi = vmovl_u8( vget_high_u8( v ) );
+		vst1q_f32( dst + i, vcvtq_f32_u32( vmovl_u16( vget_low_u16( lo ) ) ) );
+		vst1q_f32( dst + i + 4, vcvtq_f32_u32( vmovl_u16( vget_high_u16( lo ) ) ) );
+		vst1q_f32( dst + i + 8, vcvtq_f32_u32( vmovl_u16( vget_low_u16( hi ) ) ) );
+		vst1q_f32( dst + i + 12, vcvtq_f32_u32( vmovl_u16( vget_high_u16( hi ) ) ) );
+	}
+#endif
+	for( ; i < n; ++i )
+		dst[i] = src[i];
+}
+
+void convertToFloat( const uint16_t *src, float *dst, int32_t n )
+{
+	int32_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	const __m128i zero = _mm_setzero_si128();
+	for( ; i + 8 <= n; i += 8 ) {
+		__m128i v = _mm_loadu_si128( reinterpret_cast<const __m128i*>( src + i ) );
+		_mm_storeu_ps( dst + i, _mm_cvtepi32_ps( _mm_unpacklo_epi16( v, zero ) ) );
+		_mm_storeu_ps( dst + i + 4, _mm_cvtepi32_ps( _mm_unpackhi_epi16( v, zero ) ) );
+	}
+#elif defined( CINDER_SIMD_NEON )
+	for( ; i + 8 <= n; i += 8 ) {
+		uint16x8_t v = vld1q_u16( src + i );
+		vst1q_f32( dst + i, vcvtq_f32_u32( vmovl_u16( vget_low_u16( v ) ) ) );
+		vst1q_f32( dst + i + 4, vcvtq_f32_u32( vmovl_u16( vget_high_u16( v ) ) ) );
+	}
+#endif
+	for( ; i < n; ++i )
+		dst[i] = src[i];
+}
+
+void convertToFloat( const float *src, float *dst, int32_t n )
+{
+	std::copy( src, src + n, dst );
+}
+
+// Converts \a n floats to contiguous channel values, rounding and clamping like convolveFloatToChannel()
+void convertFromFloat( const float *src, uint8_t *dst, int32_t n )
+{
+	int32_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	const __m128 half = _mm_set1_ps( 0.5f ), zero = _mm_setzero_ps(), maxV = _mm_set1_ps( 255.0f );
+	auto convert = [&]( const float *p ) { return _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_add_ps( _mm_loadu_ps( p ), half ), zero ), maxV ) ); };
+	for( ; i + 16 <= n; i += 16 ) {
+		__m128i lo = _mm_packs_epi32( convert( src + i ), convert( src + i + 4 ) );
+		__m128i hi = _mm_packs_epi32( convert( src + i + 8 ), convert( src + i + 12 ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_packus_epi16( lo, hi ) );
+	}
+#elif defined( CINDER_SIMD_NEON )
+	const float32x4_t half = vdupq_n_f32( 0.5f ), zero = vdupq_n_f32( 0 ), maxV = vdupq_n_f32( 255.0f );
+	auto convert = [&]( const float *p ) { return vmovn_u32( vcvtq_u32_f32( vminq_f32( vmaxq_f32( vaddq_f32( vld1q_f32( p ), half ), zero ), maxV ) ) ); };
+	for( ; i + 16 <= n; i += 16 ) {
+		uint8x8_t lo = vmovn_u16( vcombine_u16( convert( src + i ), convert( src + i + 4 ) ) );
+		uint8x8_t hi = vmovn_u16( vcombine_u16( convert( src + i + 8 ), convert( src + i + 12 ) ) );
+		vst1q_u8( dst + i, vcombine_u8( lo, hi ) );
+	}
+#endif
+	for( ; i < n; ++i )
+		dst[i] = convolveFloatToChannel<uint8_t>( src[i] );
+}
+
+void convertFromFloat( const float *src, uint16_t *dst, int32_t n )
+{
+	int32_t i = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	// SSE2 has no unsigned 32 -> 16 bit pack, so values are biased into the signed range and back
+	const __m128 half = _mm_set1_ps( 0.5f ), zero = _mm_setzero_ps(), maxV = _mm_set1_ps( 65535.0f );
+	const __m128i bias32 = _mm_set1_epi32( 32768 ), bias16 = _mm_set1_epi16( (short)0x8000 );
+	auto convert = [&]( const float *p ) { return _mm_sub_epi32( _mm_cvttps_epi32( _mm_min_ps( _mm_max_ps( _mm_add_ps( _mm_loadu_ps( p ), half ), zero ), maxV ) ), bias32 ); };
+	for( ; i + 8 <= n; i += 8 )
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( dst + i ), _mm_xor_si128( _mm_packs_epi32( convert( src + i ), convert( src + i + 4 ) ), bias16 ) );
+#elif defined( CINDER_SIMD_NEON )
+	const float32x4_t half = vdupq_n_f32( 0.5f ), zero = vdupq_n_f32( 0 ), maxV = vdupq_n_f32( 65535.0f );
+	auto convert = [&]( const float *p ) { return vmovn_u32( vcvtq_u32_f32( vminq_f32( vmaxq_f32( vaddq_f32( vld1q_f32( p ), half ), zero ), maxV ) ) ); };
+	for( ; i + 8 <= n; i += 8 )
+		vst1q_u16( dst + i, vcombine_u16( convert( src + i ), convert( src + i + 4 ) ) );
+#endif
+	for( ; i < n; ++i )
+		dst[i] = convolveFloatToChannel<uint16_t>( src[i] );
+}
+
+void convertFromFloat( const float *src, float *dst, int32_t n )
+{
+	std::copy( src, src + n, dst );
+}
+
+// Computes out[j] = bias + sum( weights[ky * kernelWidth + kx] * rows[ky][j + kx * numLanes] ) for j in [0, size). KW and KH are
+// the kernel size when it is known at compile time, which lets the compiler unroll the taps and hoist the broadcast weights.
+template<int KW, int KH>
+void convolveLine( const float * const *rows, const float *weights, int32_t kernelWidth, int32_t kernelHeight, float bias, float *out, int32_t size, int32_t numLanes )
+{
+	const int32_t kw = KW ? KW : kernelWidth, kh = KH ? KH : kernelHeight;
+	int32_t j = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	if( KW && KH ) {
+		// out may alias nothing the compiler can prove, so the broadcast weights are hoisted by hand
+		__m128 w[KW && KH ? KW * KH : 1];
+		for( int32_t k = 0; k < kw * kh; ++k )
+			w[k] = _mm_set1_ps( weights[k] );
+		for( ; j + 4 <= size; j += 4 ) {
+			__m128 sum = _mm_set1_ps( bias );
+			for( int32_t ky = 0; ky < kh; ++ky ) {
+				const float *row = rows[ky] + j;
+				for( int32_t kx = 0; kx < kw; ++kx )
+					sum = _mm_add_ps( sum, _mm_mul_ps( w[ky * kw + kx], _mm_loadu_ps( row + kx * numLanes ) ) );
+			}
+			_mm_storeu_ps( out + j, sum );
+		}
+	}
+	for( ; j + 4 <= size; j += 4 ) {
+		__m128 sum = _mm_set1_ps( bias );
+		for( int32_t ky = 0; ky < kh; ++ky ) {
+			const float *row = rows[ky] + j, *w = weights + ky * kw;
+			for( int32_t kx = 0; kx < kw; ++kx )
+				sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( w[kx] ), _mm_loadu_ps( row + kx * numLanes ) ) );
+		}
+		_mm_storeu_ps( out + j, sum );
+	}
+#elif defined( CINDER_SIMD_NEON )
+	if( KW && KH ) {
+		float w[KW && KH ? KW * KH : 1];
+		std::copy( weights, weights + kw * kh, w );
+		for( ; j + 4 <= size; j += 4 ) {
+			float32x4_t sum = vdupq_n_f32( bias );
+			for( int32_t ky = 0; ky < kh; ++ky ) {
+				const float *row = rows[ky] + j;
+				for( int32_t kx = 0; kx < kw; ++kx )
+					sum = vmlaq_n_f32( sum, vld1q_f32( row + kx * numLanes ), w[ky * kw + kx] );
+			}
+			vst1q_f32( out + j, sum );
+		}
+	}
+	for( ; j + 4 <= size; j += 4 ) {
+		float32x4_t sum = vdupq_n_f32( bias );
+		for( int32_t ky = 0; ky < kh; ++ky ) {
+			const float *row = rows[ky] + j, *w = weights + ky * kw;
+			for( int32_t kx = 0; kx < kw; ++kx )
+				sum = vaddq_f32( sum, vmulq_n_f32( vld1q_f32( row + kx * numLanes ), w[kx] ) );
+		}
+		vst1q_f32( out + j, sum );
+	}
+#endif
+	for( ; j < size; ++j ) {
+		float sum = bias;
+		for( int32_t ky = 0; ky < kh; ++ky ) {
+			for( int32_t kx = 0; kx < kw; ++kx )
+				sum += weights[ky * kw + kx] * rows[ky][j + kx * numLanes];
+		}
+		out[j] = sum;
+	}
+}
+
+typedef void (*ConvolveLineFn)( const float * const *rows, const float *weights, int32_t kernelWidth, int32_t kernelHeight, float bias, float *out, int32_t size, int32_t numLanes );
+
+ConvolveLineFn selectConvolveLine( int32_t kernelWidth, int32_t kernelHeight )
+{
+	if( kernelWidth == 3 && kernelHeight == 3 )
+		return convolveLine<3, 3>;
+	else if( kernelWidth == 5 && kernelHeight == 5 )
+		return convolveLine<5, 5>;
+	else if( kernelWidth == 3 && kernelHeight == 1 )
+		return convolveLine<3, 1>;
+	else if( kernelWidth == 5 && kernelHeight == 1 )
+		return convolveLine<5, 1>;
+	else if( kernelWidth == 1 && kernelHeight == 3 )
+		return convolveLine<1, 3>;
+	else if( kernelWidth == 1 && kernelHeight == 5 )
+		return convolveLine<1, 5>;
+	else
+		return convolveLine<0, 0>;
+}
+
+// Replaces a[j] with sqrt( a[j]^2 + b[j]^2 ), clamped to \a maxValue
+void magnitudeLine( float *a, const float *b, int32_t size, float maxValue )
+{
+	int32_t j = 0;
+#if defined( CINDER_SIMD_SSE2 )
+	const __m128 maxV = _mm_set1_ps( maxValue );
+	for( ; j + 4 <= size; j += 4 ) {
+		__m128 va = _mm_loadu_ps( a + j ), vb = _mm_loadu_ps( b + j );
+		_mm_storeu_ps( a + j, _mm_min_ps( _mm_sqrt_ps( _mm_add_ps( _mm_mul_ps( va, va ), _mm_mul_ps( vb, vb ) ) ), maxV ) );
+	}
+#elif defined( CINDER_SIMD_NEON ) && defined( __aarch64__ )
+	const float32x4_t maxV = vdupq_n_f32( maxValue );
+	for( ; j + 4 <= size; j += 4 ) {
+		float32x4_t va = vld1q_f32( a + j ), vb = vld1q_f32( b + j );
+		vst1q_f32( a + j, vminq_f32( vsqrtq_f32( vaddq_f32( vmulq_f32( va, va ), vmulq_f32( vb, vb ) ) ), maxV ) );
+	}
+#endif
+	for( ; j < size; ++j )
+		a[j] = std::min( std::sqrt( a[j] * a[j] + b[j] * b[j] ), maxValue );
+}
+
+// Convolves rows [rowBegin, rowEnd) of \a area of \a src with each of \a kernels, which share one size, and calls
+// store( row, results ) for each, where results holds area.getWidth() * numLanes values per kernel, one kernel after another
+template<typename T, typename StoreFn>
+void convolveRows( const ConvolveImage<T> &src, const Area &area, const ConvolutionKernel * const *kernels, int32_t numKernels, BorderMode border, int32_t rowBegin, int32_t rowEnd, const StoreFn &store )
+{
+	const ConvolutionKernel &kernel = *kernels[0];
+	const int32_t kw = kernel.getWidth(), kh = kernel.getHeight(), rx = kernel.getRadiusX(), ry = kernel.getRadiusY();
+	const int32_t width = area.getWidth(), numLanes = src.mNumLanes;
+	const int32_t paddedSize = ( width + 2 * rx ) * numLanes, lineSize = width * numLanes;
+	bool separable = true;
+	for( int32_t k = 0; k < numKernels; ++k )
+		separable = separable && kernels[k]->isSeparable();
+
+	// the source column sampled by each pixel of a padded line, and the range of the padded line which lies within the source
+	const int32_t paddedWidth = width + 2 * rx;
+	std::vector<int32_t> columns( paddedWidth );
+	for( int32_t i = 0; i < paddedWidth; ++i )
+		columns[i] = borderIndex( area.x1 - rx + i, src.mWidth, border );
+	const int32_t interiorBegin = std::min( paddedWidth, std::max( 0, rx - area.x1 ) );
+	const int32_t interiorEnd = std::max( interiorBegin, std::min( paddedWidth, src.mWidth - area.x1 + rx ) );
+	const bool contiguous = src.isContiguous();
+
+	// separable kernels keep one horizontally filtered line per kernel in each slot of the ring, others the padded source line
+	const int32_t ringLineSize = separable ? lineSize * numKernels : paddedSize;
+	std::vector<float> ring( (size_t)ringLineSize * kh ), padded( separable ? paddedSize : 0 ), results( (size_t)lineSize * numKernels );
+	std::vector<int32_t> ringRows( kh, std::numeric_limits<int32_t>::min() );
+	std::vector<const float*> lines( kh );
+
+	auto loadPixel = [&]( const T *row, int32_t i, float *out ) {
+		if( columns[i] < 0 )
+			std::fill( out, out + numLanes, 0.0f );
+		else {
+			const T *pixel = row + columns[i] * src.mPixelInc;
+			for( int32_t c = 0; c < numLanes; ++c )
+				out[c] = static_cast<float>( pixel[src.mOffsets[c]] );
+		}
+	};
+
+	auto loadLine = [&]( int32_t y, float *out ) {
+		const int32_t srcY = borderIndex( y, src.mHeight, border );
+		if( srcY < 0 ) {
+			std::fill( out, out + paddedSize, 0.0f );
+			return;
+		}
+		const T *row = src.getRow( srcY );
+		if( contiguous ) {
+			// only the pixels beyond the edges of the source need the border applied
+			convertToFloat( row + ( area.x1 - rx + interiorBegin ) * numLanes, out + interiorBegin * numLanes, ( interiorEnd - interiorBegin ) * numLanes );
+			for( int32_t i = 0; i < interiorBegin; ++i )
+				loadPixel( row, i, out + i * numLanes );
+			for( int32_t i = interiorEnd; i < paddedWidth; ++i )
+				loadPixel( row, i, out + i * numLanes );
+		}
+		else {
+			for( int32_t i = 0; i < paddedWidth; ++i )
+				loadPixel( row, i, out + i * numLanes );
+		}
+	};
+
+	const ConvolveLineFn lineFn = selectConvolveLine( kw, kh );
+	const ConvolveLineFn horizontalFn = selectConvolveLine( kw, 1 ), verticalFn = selectConvolveLine( 1, kh );
+	for( int32_t y = rowBegin; y < rowEnd; ++y ) {
+		for( int32_t ky = 0; ky < kh; ++ky ) {
+			// consecutive source rows map to consecutive slots, so the window always fits the ring
+			const int32_t srcY = area.y1 + y + ky - ry;
+			const int32_t slot = ( ( srcY % kh ) + kh ) % kh;
+			float *line = ring.data() + (size_t)slot * ringLineSize;
+			if( ringRows[slot] != srcY ) {
+				if( separable ) {
+					loadLine( srcY, padded.data() );
+					const float *paddedLine = padded.data();
+					for( int32_t k = 0; k < numKernels; ++k )
+						horizontalFn( &paddedLine, kernels[k]->getRowWeights().data(), kw, 1, 0.0f, line + (size_t)k * lineSize, lineSize, numLanes );
+				}
+				else
+					loadLine( srcY, line );
+				ringRows[slot] = srcY;
+			}
+			lines[ky] = line;
+		}
+
+		for( int32_t k = 0; k < numKernels; ++k ) {
+			float *result = results.data() + (size_t)k * lineSize;
+			if( separable ) {
+				// the lines of kernel k are offset by k * lineSize within each slot
+				for( int32_t ky = 0; ky < kh; ++ky )
+					lines[ky] += ( k > 0 ) ? lineSize : 0;
+				verticalFn( lines.data(), kernels[k]->getColumnWeights().data(), 1, kh, kernels[k]->getBias(), result, lineSize, numLanes );
+			}
+			else
+				lineFn( lines.data(), kernels[k]->getWeights().data(), kw, kh, kernels[k]->getBias(), result, lineSize, numLanes );
+		}
+		store( y, results.data() );
+	}
+}
+
+// Clips \a srcArea, copies the source if it overlaps the destination, and runs convolveRows() over bands of rows.
+// With two kernels the stored result is the magnitude of their responses.
+template<typename T>
+void convolveImpl( ConvolveImage<T> src, const Area &srcBounds, const Area &srcArea, const ivec2 &dstLT, ConvolveImage<T> dst, const Area &dstBounds,
+		const ConvolutionKernel * const *kernels, int32_t numKernels, BorderMode border, const Options &options )
+{
+	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcBounds, srcArea, dstBounds, dstLT );
+	const Area &area = srcDst.first;
+	const ivec2 &dstOffset = srcDst.second;
+	if( area.getWidth() <= 0 || area.getHeight() <= 0 )
+		return;
+
+	// rows of the source are read after rows above them have been written, so in-place convolution works from a copy
+	std::vector<uint8_t> srcCopy;
+	if( src.overlaps( dst ) ) {
+		srcCopy.assign( src.mData, src.mData + src.getSpanBytes() );
+		src.mData = srcCopy.data();
+	}
+
+	// lanes are filtered independently, so when both images share a layout the lanes can follow it, whatever the channel order
+	if( src.mPixelInc == src.mNumLanes && dst.mPixelInc == dst.mNumLanes && std::equal( src.mOffsets, src.mOffsets + src.mNumLanes, dst.mOffsets ) ) {
+		// mNumLanes never exceeds the 4 offsets; bounding the loop lets the compiler see that too
+		for( int32_t c = 0; c < std::min<int32_t>( src.mNumLanes, 4 ); ++c )
+			src.mOffsets[c] = dst.mOffsets[c] = (uint8_t)c;
+	}
+
+	const int32_t width = area.getWidth(), numLanes = src.mNumLanes;
+	const bool dstContiguous = dst.isContiguous();
+	const float maxValue = (float)CHANTRAIT<T>::max();
+	parallelForRows( 0, area.getHeight(), options, [&]( int32_t rowBegin, int32_t rowEnd ) {
+		convolveRows( src, area, kernels, numKernels, border, rowBegin, rowEnd, [&]( int32_t y, float *results ) {
+			if( numKernels == 2 )
+				magnitudeLine( results, results + width * numLanes, width * numLanes, maxValue );
+			T *dstPixel = dst.getRow( dstOffset.y + y ) + dstOffset.x * dst.mPixelInc;
+			if( dstContiguous ) {
+				convertFromFloat( results, dstPixel, width * numLanes );
+				return;
+			}
+			for( int32_t x = 0; x < width; ++x, dstPixel += dst.mPixelInc, results += numLanes ) {
+				for( int32_t c = 0; c < numLanes; ++c )
+					dstPixel[dst.mOffsets[c]] = convolveFloatToChannel<T>( results[c] );
+			}
+		} );
+	} );
+}
+
+} // anonymous namespace
+
+template<typename T>
+void convolve( const ChannelT<T> &srcChannel, const ConvolutionKernel &kernel, ChannelT<T> *dstChannel, BorderMode border, const Options &options )
+{
+	convolve( srcChannel, srcChannel.getBounds(), ivec2(), kernel, dstChannel, border, options );
+}
+
+template<typename T>
+void convolve( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernel, ChannelT<T> *dstChannel, BorderMode border, const Options &options )
+{
+	const ConvolutionKernel *kernels[] = { &kernel };
+	convolveImpl( ConvolveImage<T>( srcChannel ), srcChannel.getBounds(), srcArea, dstLT, ConvolveImage<T>( *dstChannel ), dstChannel->getBounds(), kernels, 1, border, options );
+}
+
+template<typename T>
+void convolve( const SurfaceT<T> &srcSurface, const ConvolutionKernel &kernel, SurfaceT<T> *dstSurface, BorderMode border, const Options &options )
+{
+	convolve( srcSurface, srcSurface.getBounds(), ivec2(), kernel, dstSurface, border, options );
+}
+
+template<typename T>
+void convolve( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernel, SurfaceT<T> *dstSurface, BorderMode border, const Options &options )
+{
+	dstSurface->detach();
+	const bool alpha = srcSurface.hasAlpha() && dstSurface->hasAlpha();
+	const ConvolutionKernel *kernels[] = { &kernel };
+	convolveImpl( ConvolveImage<T>( srcSurface, alpha ), srcSurface.getBounds(), srcArea, dstLT, ConvolveImage<T>( *dstSurface, alpha ), dstSurface->getBounds(), kernels, 1, border, options );
+}
+
+template<typename T>
+void convolveMagnitude( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernelA, const ConvolutionKernel &kernelB, ChannelT<T> *dstChannel, BorderMode border, const Options &options )
+{
+	CI_ASSERT_MSG( kernelA.getWidth() == kernelB.getWidth() && kernelA.getHeight() == kernelB.getHeight(), "convolveMagnitude() requires kernels of the same size" );
+	const ConvolutionKernel *kernels[] = { &kernelA, &kernelB };
+	convolveImpl( ConvolveImage<T>( srcChannel ), srcChannel.getBounds(), srcArea, dstLT, ConvolveImage<T>( *dstChannel ), dstChannel->getBounds(), kernels, 2, border, options );
+}
+
+template<typename T>
+void convolveMagnitude( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernelA, const ConvolutionKernel &kernelB, SurfaceT<T> *dstSurface, BorderMode border, const Options &options )
+{
+	dstSurface->detach();
+	CI_ASSERT_MSG( kernelA.getWidth() == kernelB.getWidth() && kernelA.getHeight() == kernelB.getHeight(), "convolveMagnitude() requires kernels of the same size" );
+	const bool alpha = srcSurface.hasAlpha() && dstSurface->hasAlpha();
+	const ConvolutionKernel *kernels[] = { &kernelA, &kernelB };
+	convolveImpl( ConvolveImage<T>( srcSurface, alpha ), srcSurface.getBounds(), srcArea, dstLT, ConvolveImage<T>( *dstSurface, alpha ), dstSurface->getBounds(), kernels, 2, border, options );
+}
+
+#define convolve_PROTOTYPES(T)\
+	template CI_API void convolve( const ChannelT<T> &srcChannel, const ConvolutionKernel &kernel, ChannelT<T> *dstChannel, BorderMode border, const Options &options ); \
+	template CI_API void convolve( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernel, ChannelT<T> *dstChannel, BorderMode border, const Options &options ); \
+	template CI_API void convolve( const SurfaceT<T> &srcSurface, const ConvolutionKernel &kernel, SurfaceT<T> *dstSurface, BorderMode border, const Options &options ); \
+	template CI_API void convolve( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernel, SurfaceT<T> *dstSurface, BorderMode border, const Options &options ); \
+	template CI_API void convolveMagnitude( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernelA, const ConvolutionKernel &kernelB, ChannelT<T> *dstChannel, BorderMode border, const Options &options ); \
+	template CI_API void convolveMagnitude( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, const ConvolutionKernel &kernelA, const ConvolutionKernel &kernelB, SurfaceT<T> *dstSurface, BorderMode border, const Options &options );
+
+convolve_PROTOTYPES(uint8_t)
+convolve_PROTOTYPES(uint16_t)
+convolve_PROTOTYPES(float)
+
+} } // namespace cinder::ip
@@ -21,8 +21,8 @@
 */
 
 #include "cinder/ip/EdgeDetect.h"
+#include "cinder/ip/Convolve.h"
 #include "cinder/Surface.h"
-#include "cinder/CinderMath.h"
 
 namespace cinder { namespace ip {
 
@@ -30,66 +30,39 @@ namespace cinder { namespace ip {
 // -1  0  1     1  2  1
 // -2  0  2     0  0  0
 // -1  0  1    -1 -2 -1
-// NOTE: this leaves garbage in the top and bottom rows, as well as the left and right columns
 
 template<typename T>
-void edgeDetectSobel( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, ChannelT<T> *dstChannel )
+void edgeDetectSobel( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, ChannelT<T> *dstChannel, const Options &options )
 {
-	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcChannel.getBounds(), srcArea, dstChannel->getBounds(), dstLT );
-	const Area &area( srcDst.first );
-	const ivec2 &dstOffset( srcDst.second );
-	typename CHANTRAIT<T>::SignedSum sumX, sumY;
-
-	ptrdiff_t srcRowInc = srcChannel.getRowBytes() / sizeof(T);
-	uint8_t srcPixelInc = srcChannel.getIncrement();
-	uint8_t dstPixelInc = dstChannel->getIncrement();
-	const T maxValue = CHANTRAIT<T>::max();
-	for( int32_t y = 1; y < area.getHeight() - 1; ++y ) {
-		const T *srcLine = srcChannel.getData( area.getX1() + 1, area.getY1() + y );
-		T *dstLine = dstChannel->getData( dstOffset.x + area.getX1() + 1, dstOffset.y + y );
-		for( int32_t x = area.getX1() + 1; x < area.getX2() - 1; ++x ) {
-			sumX = -*(srcLine-srcRowInc-srcPixelInc) + *(srcLine-srcRowInc+srcPixelInc) - 2 * *(srcLine-srcPixelInc)
-							+ 2 * *(srcLine+srcPixelInc) - *(srcLine+srcRowInc-srcPixelInc) + *(srcLine+srcRowInc+srcPixelInc);
-			sumY = *(srcLine-srcRowInc-srcPixelInc) + 2 * *(srcLine-srcRowInc) + *(srcLine-srcRowInc+srcPixelInc)
-							- *(srcLine+srcRowInc-srcPixelInc) - 2 * *(srcLine+srcPixelInc) - *(srcLine+srcRowInc+srcPixelInc);
-			sumX = (typename CHANTRAIT<T>::SignedSum)math<float>::sqrt( (float)sumX * sumX + (float)sumY * sumY );
-			if( sumX > maxValue )
-				sumX = maxValue;
-			*dstLine = static_cast<T>( sumX );
-			dstLine += dstPixelInc;
-			srcLine += srcPixelInc;
-		}
-	}
+	static const ConvolutionKernel sobelX = ConvolutionKernel::sobelX(), sobelY = ConvolutionKernel::sobelY();
+	convolveMagnitude( srcChannel, srcArea, dstLT, sobelX, sobelY, dstChannel, BorderMode::CLAMP, options );
 }
 
 template<typename T>
-void edgeDetectSobel( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, SurfaceT<T> *dstSurface )
+void edgeDetectSobel( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, SurfaceT<T> *dstSurface, const Options &options )
 {
-	edgeDetectSobel( srcSurface.getChannelRed(), srcArea, dstLT, &dstSurface->getChannelRed() );
-	edgeDetectSobel( srcSurface.getChannelGreen(), srcArea, dstLT, &dstSurface->getChannelGreen() );
-	edgeDetectSobel( srcSurface.getChannelBlue(), srcArea, dstLT, &dstSurface->getChannelBlue() );
-	if( srcSurface.hasAlpha() && dstSurface->hasAlpha() )
-		edgeDetectSobel( srcSurface.getChannelAlpha(), srcArea, dstLT, &dstSurface->getChannelAlpha() );
+	static const ConvolutionKernel sobelX = ConvolutionKernel::sobelX(), sobelY = ConvolutionKernel::sobelY();
+	convolveMagnitude( srcSurface, srcArea, dstLT, sobelX, sobelY, dstSurface, BorderMode::CLAMP, options );
 }
 
 template<typename T>
-void edgeDetectSobel( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel )
+void edgeDetectSobel( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const Options &options )
 {
-	edgeDetectSobel( srcChannel, srcChannel.getBounds(), ivec2(), dstChannel );
+	edgeDetectSobel( srcChannel, srcChannel.getBounds(), ivec2(), dstChannel, options );
 }
 
 template<typename T>
-void edgeDetectSobel( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSuface )
+void edgeDetectSobel( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSuface, const Options &options )
 {
-	edgeDetectSobel( srcSurface, srcSurface.getBounds(), ivec2(), dstSuface );
+	edgeDetectSobel( srcSurface, srcSurface.getBounds(), ivec2(), dstSuface, options );
 }
 
 
 #define edgeDetect_PROTOTYPES(T)\
-	template CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, ChannelT<T> *dstChannel ); \
-	template CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, SurfaceT<T> *dstSurface ); \
-	template CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel );	\
-	template CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface );	
+	template CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, const Area &srcArea, const ivec2 &dstLT, ChannelT<T> *dstChannel, const Options &options ); \
+	template CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstLT, SurfaceT<T> *dstSurface, const Options &options ); \
+	template CI_API void edgeDetectSobel( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const Options &options );	\
+	template CI_API void edgeDetectSobel( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const Options &options );	
 
 edgeDetect_PROTOTYPES(uint8_t)
 edgeDetect_PROTOTYPES(uint16_t)
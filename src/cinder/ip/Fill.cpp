@@ -74,6 +74,7 @@ void fill_impl( SurfaceT<T> *surface, const ColorAT<T> &color, const Area &area
 template<typename T, typename Y>
 void fill( SurfaceT<T> *surface, const ColorT<Y> &color )
 {
+	surface->detach();
 	ColorT<T> nativeColor( color );
 	fill_impl( surface, nativeColor, surface->getBounds() );
 }
@@ -81,6 +82,7 @@ void fill( SurfaceT<T> *surface, const ColorT<Y> &color )
 template<typename T, typename Y>
 void fill( SurfaceT<T> *surface, const ColorT<Y> &color, const Area &area )
 {
+	surface->detach();
 	ColorT<T> nativeColor( color );
 	fill_impl( surface, nativeColor, area );
 }
@@ -88,6 +90,7 @@ void fill( SurfaceT<T> *surface, const ColorT<Y> &color, const Area &area )
 template<typename T, typename Y>
 void fill( SurfaceT<T> *surface, const ColorAT<Y> &color )
 {
+	surface->detach();
 	ColorAT<T> nativeColor( color );
 	fill_impl( surface, nativeColor, surface->getBounds() );
 }
@@ -95,6 +98,7 @@ void fill( SurfaceT<T> *surface, const ColorAT<Y> &color )
 template<typename T, typename Y>
 void fill( SurfaceT<T> *surface, const ColorAT<Y> &color, const Area &area )
 {
+	surface->detach();
 	ColorAT<T> nativeColor( color );
 	fill_impl( surface, nativeColor, area );
 }
@@ -141,4 +145,8 @@ fill_PROTOTYPES(uint8_t)
 fill_PROTOTYPES(uint16_t)
 fill_PROTOTYPES(float)
 
+// half_float has no color arithmetic; Surface16f only relies on filling its alpha channel
+template CI_API void fill<half_float>( ChannelT<half_float> *channel, const half_float value, const Area &area );
+template CI_API void fill<half_float>( ChannelT<half_float> *channel, const half_float value );
+
 } } // namespace cinder::ip
@@ -29,6 +29,7 @@ namespace cinder { namespace ip {
 template<typename T>
 void flipVertical( SurfaceT<T> *surface )
 {
+	surface->detach();
 	const ptrdiff_t rowBytes = surface->getRowBytes();
 	unique_ptr<uint8_t[]> buffer( new uint8_t[rowBytes] );
 	
@@ -139,6 +140,7 @@ void flipVerticalRawRgb( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface
 template<typename T>
 void flipVertical( const SurfaceT<T> &srcSurface, SurfaceT<T> *destSurface )
 {
+	destSurface->detach();
 	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcSurface.getBounds(), destSurface->getBounds(), destSurface->getBounds(), ivec2(0,0) );
 	
 	if( destSurface->getChannelOrder() == srcSurface.getChannelOrder() )
@@ -184,6 +186,7 @@ void flipVertical( const ChannelT<T> &srcChannel, ChannelT<T> *destChannel )
 template<typename T>
 void flipHorizontal( SurfaceT<T> *surface )
 {
+	surface->detach();
 	const int32_t height = surface->getHeight();
 	const int32_t width = surface->getWidth();
 	const int32_t halfWidth = width / 2;
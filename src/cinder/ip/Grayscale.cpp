@@ -28,6 +28,7 @@ namespace cinder { namespace ip {
 template<typename T>
 void grayscale( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface )
 {
+	dstSurface->detach();
 	Area area = srcSurface.getBounds().getClipBy( dstSurface->getBounds() );
 
 	int8_t srcPixelInc = srcSurface.getPixelInc();
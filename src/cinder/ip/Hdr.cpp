@@ -30,6 +30,7 @@ namespace cinder { namespace ip {
 
 void hdrNormalize( Surface32f *surface )
 {
+	surface->detach();
 	// first take histogram to find the minimum and maximum values present
 	float minVal = *(surface->getDataRed( ivec2() )), maxVal = *(surface->getDataRed( ivec2() ));
 
@@ -0,0 +1,178 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/CinderMath.h"
+
+#include <cmath>
+
+using namespace std;
+
+namespace cinder { namespace ip {
+
+template<typename T>
+IntegralImageT<T>::IntegralImageT( const ChannelT<T> &channel, bool squaredSums, const Options &options )
+	: mWidth( 0 ), mHeight( 0 ), mHasSquaredSums( false )
+{
+	update( channel, squaredSums, options );
+}
+
+template<typename T>
+void IntegralImageT<T>::update( const ChannelT<T> &channel, bool squaredSums, const Options &options )
+{
+	mWidth = channel.getWidth();
+	mHeight = channel.getHeight();
+	mHasSquaredSums = squaredSums;
+
+	const size_t stride = mWidth + 1;
+	mSums.resize( stride * ( mHeight + 1 ) );
+	std::fill( mSums.begin(), mSums.begin() + stride, SumT( 0 ) );
+	if( squaredSums ) {
+		mSquaredSums.resize( mSums.size() );
+		std::fill( mSquaredSums.begin(), mSquaredSums.begin() + stride, SquaredSumT( 0 ) );
+	}
+	else
+		mSquaredSums.clear();
+
+	// prefix sum each row independently
+	const uint8_t inc = channel.getIncrement();
+	parallelForRows( 0, mHeight, options, [&]( int32_t rowBegin, int32_t rowEnd ) {
+		for( int32_t y = rowBegin; y < rowEnd; ++y ) {
+			const T *src = channel.getData( 0, y );
+			SumT *sums = &mSums[( y + 1 ) * stride];
+			SumT sum = 0;
+			sums[0] = 0;
+			for( int32_t x = 0; x < mWidth; ++x ) {
+				sum += src[x * inc];
+				sums[x + 1] = sum;
+			}
+			if( squaredSums ) {
+				SquaredSumT *squares = &mSquaredSums[( y + 1 ) * stride];
+				SquaredSumT squaredSum = 0;
+				squares[0] = 0;
+				for( int32_t x = 0; x < mWidth; ++x ) {
+					const SquaredSumT value = src[x * inc];
+					squaredSum += value * value;
+					squares[x + 1] = squaredSum;
+				}
+			}
+		}
+	} );
+
+	// then accumulate down the columns, with each thread taking a band of columns
+	parallelForRows( 1, (int32_t)stride, options, [&]( int32_t colBegin, int32_t colEnd ) {
+		for( int32_t y = 2; y <= mHeight; ++y ) {
+			SumT *sums = &mSums[y * stride];
+			const SumT *above = sums - stride;
+			for( int32_t x = colBegin; x < colEnd; ++x )
+				sums[x] += above[x];
+			if( squaredSums ) {
+				SquaredSumT *squares = &mSquaredSums[y * stride];
+				const SquaredSumT *squaresAbove = squares - stride;
+				for( int32_t x = colBegin; x < colEnd; ++x )
+					squares[x] += squaresAbove[x];
+			}
+		}
+	} );
+}
+
+template<typename T>
+double IntegralImageT<T>::getMean( const Area &area ) const
+{
+	const Area a = area.getClipBy( getBounds() );
+	const double count = (double)a.getWidth() * a.getHeight();
+	if( a.getWidth() <= 0 || a.getHeight() <= 0 )
+		return 0;
+
+	return (double)getSum( a.x1, a.y1, a.x2, a.y2 ) / count;
+}
+
+template<typename T>
+double IntegralImageT<T>::getVariance( const Area &area ) const
+{
+	const Area a = area.getClipBy( getBounds() );
+	const double count = (double)a.getWidth() * a.getHeight();
+	if( a.getWidth() <= 0 || a.getHeight() <= 0 )
+		return 0;
+
+	const double mean = (double)getSum( a.x1, a.y1, a.x2, a.y2 ) / count;
+	return std::max( 0.0, (double)getSquaredSum( a.x1, a.y1, a.x2, a.y2 ) / count - mean * mean );
+}
+
+namespace {
+
+// 8 and 16-bit results map z-scores of +/-4 onto the full range
+inline void storeZScore( double z, uint8_t *dst )	{ *dst = static_cast<uint8_t>( constrain( 128.0 + 32.0 * z + 0.5, 0.0, 255.0 ) ); }
+inline void storeZScore( double z, uint16_t *dst )	{ *dst = static_cast<uint16_t>( constrain( 32768.0 + 8192.0 * z + 0.5, 0.0, 65535.0 ) ); }
+inline void storeZScore( double z, float *dst )		{ *dst = static_cast<float>( z ); }
+
+} // anonymous namespace
+
+template<typename T>
+void normalizeLocalContrast( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int radius, ChannelT<T> *dstChannel, const Options &options )
+{
+	CI_ASSERT_MSG( integralImage.hasSquaredSums(), "normalizeLocalContrast() requires an IntegralImage built with squared sums" );
+	if( ! integralImage.hasSquaredSums() )
+		return;
+
+	const int32_t width = std::min( { srcChannel.getWidth(), dstChannel->getWidth(), integralImage.getWidth() } );
+	const int32_t height = std::min( { srcChannel.getHeight(), dstChannel->getHeight(), integralImage.getHeight() } );
+	const int32_t imageWidth = integralImage.getWidth(), imageHeight = integralImage.getHeight();
+	// a flat window would divide by zero, so the deviation is floored at one 8-bit gray level
+	const double minStdDev = CHANTRAIT<T>::max() / 255.0;
+	const uint8_t srcInc = srcChannel.getIncrement(), dstInc = dstChannel->getIncrement();
+
+	parallelForRows( 0, height, options, [&]( int32_t rowBegin, int32_t rowEnd ) {
+		for( int32_t y = rowBegin; y < rowEnd; ++y ) {
+			const int32_t y1 = std::max( 0, y - radius ), y2 = std::min( imageHeight, y + radius + 1 );
+			const T *src = srcChannel.getData( 0, y );
+			T *dst = dstChannel->getData( 0, y );
+			for( int32_t x = 0; x < width; ++x, src += srcInc, dst += dstInc ) {
+				const int32_t x1 = std::max( 0, x - radius ), x2 = std::min( imageWidth, x + radius + 1 );
+				const double count = (double)( x2 - x1 ) * ( y2 - y1 );
+				const double mean = (double)integralImage.getSum( x1, y1, x2, y2 ) / count;
+				const double variance = std::max( 0.0, (double)integralImage.getSquaredSum( x1, y1, x2, y2 ) / count - mean * mean );
+				storeZScore( ( *src - mean ) / std::max( std::sqrt( variance ), minStdDev ), dst );
+			}
+		}
+	} );
+}
+
+template<typename T>
+void normalizeLocalContrast( const ChannelT<T> &srcChannel, int radius, ChannelT<T> *dstChannel, const Options &options )
+{
+	IntegralImageT<T> integralImage( srcChannel, true, options );
+	normalizeLocalContrast( srcChannel, integralImage, radius, dstChannel, options );
+}
+
+#define integralImage_PROTOTYPES(T)\
+	template class CI_API IntegralImageT<T>; \
+	template CI_API void normalizeLocalContrast( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int radius, ChannelT<T> *dstChannel, const Options &options ); \
+	template CI_API void normalizeLocalContrast( const ChannelT<T> &srcChannel, int radius, ChannelT<T> *dstChannel, const Options &options );
+
+integralImage_PROTOTYPES(uint8_t)
+integralImage_PROTOTYPES(uint16_t)
+integralImage_PROTOTYPES(float)
+
+} } // namespace cinder::ip
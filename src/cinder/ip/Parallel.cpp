@@ -0,0 +1,196 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/Parallel.h"
+#include "cinder/Thread.h"
+
+#include <algorithm>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <mutex>
+#include <system_error>
+#include <thread>
+#include <vector>
+
+namespace cinder { namespace ip {
+
+namespace {
+
+// The bands of one parallelForRows() call. Bands are claimed under the pool's mutex by the workers and by the calling thread.
+struct RowJob {
+	RowJob( int32_t rowBegin, int32_t numRows, int numBands, const std::function<void( int32_t, int32_t )> &fn )
+		: mFn( fn ), mRowBegin( rowBegin ), mBandRows( numRows / numBands ), mRemainder( numRows % numBands ),
+			mNumBands( numBands ), mNextBand( 0 ), mNumDone( 0 ), mExceptions( numBands )
+	{}
+
+	// distributes the remainder across the first bands so that no two bands differ by more than one row
+	int32_t	bandBegin( int band ) const	{ return mRowBegin + band * mBandRows + std::min<int32_t>( band, mRemainder ); }
+
+	void run( int band )
+	{
+		try {
+			mFn( bandBegin( band ), bandBegin( band + 1 ) );
+		}
+		catch( ... ) {
+			mExceptions[band] = std::current_exception();
+		}
+	}
+
+	const std::function<void( int32_t, int32_t )>	&mFn;
+	const int32_t					mRowBegin, mBandRows, mRemainder;
+	const int						mNumBands;
+	int								mNextBand, mNumDone;
+	std::vector<std::exception_ptr>	mExceptions;
+	std::condition_variable			mDoneCondition;
+};
+
+// Persistent workers shared by every parallelForRows() call, so that no call pays for starting threads. The calling thread
+// claims bands too, which guarantees progress when the workers are busy or missing, and when parallelForRows() is nested.
+class RowThreadPool {
+  public:
+	static RowThreadPool*	get()
+	{
+		static RowThreadPool sInstance;
+		return &sInstance;
+	}
+
+	~RowThreadPool()
+	{
+		{
+			std::lock_guard<std::mutex> lock( mMutex );
+			mShutdown = true;
+		}
+		mJobCondition.notify_all();
+
+		for( auto &thread : mThreads )
+			thread.join();
+	}
+
+	void run( RowJob *job )
+	{
+		std::unique_lock<std::mutex> lock( mMutex );
+		mJobs.push_back( job );
+		lock.unlock();
+		for( int band = 1; band < job->mNumBands; ++band )
+			mJobCondition.notify_one();
+
+		lock.lock();
+		int band;
+		while( claim( job, &band ) ) {
+			lock.unlock();
+			job->run( band );
+			lock.lock();
+			++job->mNumDone;
+		}
+
+		job->mDoneCondition.wait( lock, [job] { return job->mNumDone == job->mNumBands; } );
+	}
+
+  private:
+	RowThreadPool()
+		: mShutdown( false )
+	{
+		const int numThreads = (int)std::thread::hardware_concurrency() - 1;
+		try {
+			for( int t = 0; t < numThreads; ++t )
+				mThreads.emplace_back( &RowThreadPool::threadFn, this );
+		}
+		catch( std::system_error & ) {
+			// the threads which did start are used, and the calling thread processes whatever they don't claim
+		}
+	}
+
+	// claims the next band of \a job, removing it from the queue once its last band is claimed. Expects mMutex to be locked.
+	bool claim( RowJob *job, int *band )
+	{
+		if( job->mNextBand == job->mNumBands )
+			return false;
+
+		*band = job->mNextBand++;
+		if( job->mNextBand == job->mNumBands )
+			mJobs.erase( std::find( mJobs.begin(), mJobs.end(), job ) );
+		return true;
+	}
+
+	void threadFn()
+	{
+		ThreadSetup threadSetup;
+
+		std::unique_lock<std::mutex> lock( mMutex );
+		while( true ) {
+			mJobCondition.wait( lock, [this] { return mShutdown || ! mJobs.empty(); } );
+			if( mShutdown )
+				return;
+
+			RowJob *job = mJobs.front();
+			int band;
+			claim( job, &band );
+			lock.unlock();
+			job->run( band );
+			lock.lock();
+			if( ++job->mNumDone == job->mNumBands )
+				job->mDoneCondition.notify_all();
+		}
+	}
+
+	std::vector<std::thread>	mThreads;
+	std::mutex					mMutex;
+	std::condition_variable		mJobCondition;
+	std::deque<RowJob*>			mJobs;
+	bool						mShutdown;
+};
+
+} // anonymous namespace
+
+int Options::getNumThreadsForRows( int32_t numRows ) const
+{
+	int result = mNumThreads;
+	if( result <= 0 )
+		result = std::max<int>( 1, (int)std::thread::hardware_concurrency() );
+
+	return std::max<int>( 1, std::min<int>( result, numRows ) );
+}
+
+void parallelForRows( int32_t rowBegin, int32_t rowEnd, const Options &options, const std::function<void( int32_t, int32_t )> &fn )
+{
+	const int32_t numRows = rowEnd - rowBegin;
+	if( numRows <= 0 )
+		return;
+
+	const int numThreads = options.getNumThreadsForRows( numRows );
+	if( numThreads == 1 ) {
+		fn( rowBegin, rowEnd );
+		return;
+	}
+
+	RowJob job( rowBegin, numRows, numThreads, fn );
+	RowThreadPool::get()->run( &job );
+
+	for( auto &exc : job.mExceptions ) {
+		if( exc )
+			std::rethrow_exception( exc );
+	}
+}
+
+} } // namespace cinder::ip
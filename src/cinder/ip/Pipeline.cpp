@@ -0,0 +1,235 @@
+/*
+ Copyright (c) 2026, The Cinder Project, All rights reserved.
+
+ This code is intended for use with the Cinder C++ library: http://libcinder.org
+
+ Redistribution and use in source and binary forms, with or without modification, are permitted provided that
+ the following conditions are met:
+
+	* Redistributions of source code must retain the above copyright notice, this list of conditions and
+	the following disclaimer.
+	* Redistributions in binary form must reproduce the above copyright notice, this list of conditions and
+	the following disclaimer in the documentation and/or other materials provided with the distribution.
+
+ THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS "AS IS" AND ANY EXPRESS OR IMPLIED
+ WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A
+ PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE COPYRIGHT HOLDER OR CONTRIBUTORS BE LIABLE FOR
+ ANY DIRECT, INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING, BUT NOT LIMITED
+ TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+ HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT LIABILITY, OR TORT (INCLUDING
+ NEGLIGENCE OR OTHERWISE) ARISING IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ POSSIBILITY OF SUCH DAMAGE.
+*/
+
+#include "cinder/ip/Pipeline.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ChanTraits.h"
+
+#include <algorithm>
+
+using namespace std;
+
+namespace cinder { namespace ip {
+
+namespace {
+
+// Tiles are sized so that a tile of the RGBA working buffer stays within a typical L2 cache
+const size_t TILE_BYTES = 256 * 1024;
+
+} // anonymous namespace
+
+template<typename T>
+PipelineT<T>::PipelineT( const SurfaceT<T> &source )
+	: mSource( &source ), mFlipVertical( false ), mFlipHorizontal( false )
+{
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::addOperation( OperationType type, const ColorAT<T> &value )
+{
+	mOperations.push_back( { type, value } );
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::grayscale()
+{
+	return addOperation( GRAYSCALE );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::threshold( T value )
+{
+	return addOperation( THRESHOLD, ColorAT<T>( value, value, value, value ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::premultiply()
+{
+	return addOperation( PREMULTIPLY );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::unpremultiply()
+{
+	return addOperation( UNPREMULTIPLY );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::fill( const ColorT<T> &color )
+{
+	return addOperation( FILL, ColorAT<T>( color.r, color.g, color.b, CHANTRAIT<T>::max() ) );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::fill( const ColorAT<T> &color )
+{
+	return addOperation( FILL, color );
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::flipVertical()
+{
+	mFlipVertical = ! mFlipVertical;
+	return *this;
+}
+
+template<typename T>
+PipelineT<T>& PipelineT<T>::flipHorizontal()
+{
+	mFlipHorizontal = ! mFlipHorizontal;
+	return *this;
+}
+
+// Loads rows [rowBegin, rowEnd) of the destination from the source into an RGBA working buffer, applies each operation
+// to the whole buffer using the standalone ip:: functions and stores the result. Flips only change which source pixel is loaded.
+template<typename T>
+void PipelineT<T>::processTile( const SurfaceT<T> &source, SurfaceT<T> *dstSurface, const ivec2 &size, int32_t rowBegin, int32_t rowEnd, std::vector<T> *tileBuffer ) const
+{
+	const int32_t numRows = rowEnd - rowBegin;
+	const int32_t width = size.x;
+	tileBuffer->resize( (size_t)numRows * width * 4 );
+	SurfaceT<T> tile( tileBuffer->data(), width, numRows, width * 4 * sizeof(T), SurfaceChannelOrder::RGBA );
+
+	// a fill discards everything before it, including the source pixels
+	size_t firstOperation = 0;
+	bool loadSource = true;
+	for( size_t op = 0; op < mOperations.size(); ++op ) {
+		if( mOperations[op].mType == FILL ) {
+			firstOperation = op;
+			loadSource = false;
+		}
+	}
+
+	if( loadSource ) {
+		const uint8_t srcInc = source.getPixelInc();
+		const uint8_t srcRed = source.getRedOffset(), srcGreen = source.getGreenOffset(), srcBlue = source.getBlueOffset();
+		const bool srcAlpha = source.hasAlpha();
+		const uint8_t srcAlphaOffset = srcAlpha ? source.getAlphaOffset() : 0;
+		const ptrdiff_t srcStep = mFlipHorizontal ? -srcInc : srcInc;
+		for( int32_t row = 0; row < numRows; ++row ) {
+			const int32_t srcY = mFlipVertical ? ( size.y - 1 - ( rowBegin + row ) ) : ( rowBegin + row );
+			const T *src = source.getData( ivec2( mFlipHorizontal ? width - 1 : 0, srcY ) );
+			T *dst = tileBuffer->data() + (size_t)row * width * 4;
+			for( int32_t x = 0; x < width; ++x, src += srcStep, dst += 4 ) {
+				dst[0] = src[srcRed];
+				dst[1] = src[srcGreen];
+				dst[2] = src[srcBlue];
+				dst[3] = srcAlpha ? src[srcAlphaOffset] : CHANTRAIT<T>::max();
+			}
+		}
+	}
+
+	for( size_t op = firstOperation; op < mOperations.size(); ++op ) {
+		const Operation &operation = mOperations[op];
+		switch( operation.mType ) {
+			case GRAYSCALE:
+				ip::grayscale( tile, &tile );
+			break;
+			case THRESHOLD: { // matches ip::threshold(), which is only instantiated for 8-bit
+				const T value = operation.mValue.r, maxValue = CHANTRAIT<T>::max();
+				T *ptr = tileBuffer->data();
+				for( size_t p = 0; p < (size_t)numRows * width; ++p, ptr += 4 ) {
+					ptr[0] = ( ptr[0] > value ) ? maxValue : 0;
+					ptr[1] = ( ptr[1] > value ) ? maxValue : 0;
+					ptr[2] = ( ptr[2] > value ) ? maxValue : 0;
+				}
+			}
+			break;
+			case PREMULTIPLY:
+				ip::premultiply( &tile );
+			break;
+			case UNPREMULTIPLY:
+				ip::unpremultiply( &tile );
+			break;
+			case FILL:
+				ip::fill( &tile, operation.mValue );
+			break;
+		}
+	}
+
+	const uint8_t dstInc = dstSurface->getPixelInc();
+	const uint8_t dstRed = dstSurface->getRedOffset(), dstGreen = dstSurface->getGreenOffset(), dstBlue = dstSurface->getBlueOffset();
+	const bool dstAlpha = dstSurface->hasAlpha();
+	const uint8_t dstAlphaOffset = dstAlpha ? dstSurface->getAlphaOffset() : 0;
+	for( int32_t row = 0; row < numRows; ++row ) {
+		const T *src = tileBuffer->data() + (size_t)row * width * 4;
+		T *dst = dstSurface->getData( ivec2( 0, rowBegin + row ) );
+		for( int32_t x = 0; x < width; ++x, src += 4, dst += dstInc ) {
+			dst[dstRed] = src[0];
+			dst[dstGreen] = src[1];
+			dst[dstBlue] = src[2];
+			if( dstAlpha )
+				dst[dstAlphaOffset] = src[3];
+		}
+	}
+}
+
+template<typename T>
+void PipelineT<T>::run( SurfaceT<T> *dstSurface, const Options &options ) const
+{
+	const ivec2 size( std::min( mSource->getWidth(), dstSurface->getWidth() ), std::min( mSource->getHeight(), dstSurface->getHeight() ) );
+	if( size.x <= 0 || size.y <= 0 )
+		return;
+
+	dstSurface->detach();
+	// a vertical flip in-place would read rows that another tile has already written
+	SurfaceT<T> sourceCopy;
+	const SurfaceT<T> *source = mSource;
+	if( mFlipVertical && mSource->getData() == dstSurface->getData() ) {
+		sourceCopy = mSource->clone();
+		source = &sourceCopy;
+	}
+
+	const int32_t tileRows = std::max<int32_t>( 1, (int32_t)( TILE_BYTES / ( (size_t)size.x * 4 * sizeof(T) ) ) );
+	parallelForRows( 0, size.y, options, [&]( int32_t bandBegin, int32_t bandEnd ) {
+		std::vector<T> tileBuffer;
+		for( int32_t tileBegin = bandBegin; tileBegin < bandEnd; tileBegin += tileRows )
+			processTile( *source, dstSurface, size, tileBegin, std::min( tileBegin + tileRows, bandEnd ), &tileBuffer );
+	} );
+
+	bool premultiplied = mSource->isPremultiplied();
+	for( const auto &operation : mOperations ) {
+		if( operation.mType == PREMULTIPLY )
+			premultiplied = true;
+		else if( operation.mType == UNPREMULTIPLY )
+			premultiplied = false;
+	}
+	dstSurface->setPremultiplied( premultiplied );
+}
+
+template<typename T>
+SurfaceT<T> PipelineT<T>::run( const Options &options ) const
+{
+	SurfaceT<T> result( mSource->getWidth(), mSource->getHeight(), mSource->hasAlpha(), mSource->getChannelOrder() );
+	run( &result, options );
+	return result;
+}
+
+// These should match CHANNEL_TYPES
+template class CI_API PipelineT<uint8_t>;
+template class CI_API PipelineT<float>;
+
+} } // namespace cinder::ip
@@ -22,12 +22,205 @@
 
 #include "cinder/ip/Premultiply.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/Simd.h"
 
 #include <algorithm>
+#include <array>
 
 namespace cinder { namespace ip {
 
-// this is a candidate for sse2
+namespace {
+
+// ( c * table[alpha] ) >> 16 reproduces c * 255 / alpha exactly for every 8-bit c and non-zero alpha, replacing the per-channel divide
+constexpr std::array<uint32_t, 256> makeUnpremultiplyTable()
+{
+	std::array<uint32_t, 256> result = {};
+	for( uint32_t alpha = 1; alpha < 256; ++alpha )
+		result[alpha] = ( ( 255u << 16 ) + alpha - 1 ) / alpha;
+	return result;
+}
+
+constexpr std::array<uint32_t, 256> sUnpremultiplyTable = makeUnpremultiplyTable();
+
+#if defined( CINDER_SIMD_SSE2 )
+
+// Exact floor( x / 255 ) for each 16-bit lane x <= 255 * 255
+inline __m128i div255Sse2( __m128i x )
+{
+	return _mm_srli_epi16( _mm_add_epi16( _mm_add_epi16( x, _mm_set1_epi16( 1 ) ), _mm_srli_epi16( x, 8 ) ), 8 );
+}
+
+// Premultiplies 4 interleaved pixels at a time; ALPHA is the alpha offset within the pixel, which is either 0 or 3. Returns the number of pixels processed.
+template<int ALPHA>
+int32_t premultiplyRowSse2( uint8_t *row, int32_t width )
+{
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i alphaMask = _mm_setr_epi16( ALPHA == 0 ? -1 : 0, 0, 0, ALPHA == 3 ? -1 : 0, ALPHA == 0 ? -1 : 0, 0, 0, ALPHA == 3 ? -1 : 0 );
+	auto premultiply16 = [&]( __m128i v ) {
+		__m128i alpha = _mm_shufflehi_epi16( _mm_shufflelo_epi16( v, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ), _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		__m128i result = div255Sse2( _mm_mullo_epi16( v, alpha ) );
+		return _mm_or_si128( _mm_and_si128( alphaMask, v ), _mm_andnot_si128( alphaMask, result ) );
+	};
+
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		__m128i *ptr = reinterpret_cast<__m128i*>( row + x * 4 );
+		__m128i pixels = _mm_loadu_si128( ptr );
+		__m128i lo = premultiply16( _mm_unpacklo_epi8( pixels, zero ) );
+		__m128i hi = premultiply16( _mm_unpackhi_epi8( pixels, zero ) );
+		_mm_storeu_si128( ptr, _mm_packus_epi16( lo, hi ) );
+	}
+	return x;
+}
+
+template<int ALPHA>
+int32_t premultiplyRowSse2( float *row, int32_t width )
+{
+	const __m128 alphaMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? -1 : 0, 0, 0, ALPHA == 3 ? -1 : 0 ) );
+	for( int32_t x = 0; x < width; ++x ) {
+		float *ptr = row + x * 4;
+		__m128 pixel = _mm_loadu_ps( ptr );
+		__m128 result = _mm_mul_ps( pixel, _mm_shuffle_ps( pixel, pixel, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) ) );
+		_mm_storeu_ps( ptr, _mm_or_ps( _mm_and_ps( alphaMask, pixel ), _mm_andnot_ps( alphaMask, result ) ) );
+	}
+	return width;
+}
+
+template<int ALPHA>
+int32_t unpremultiplyRowSse2( float *row, int32_t width )
+{
+	const __m128 alphaMask = _mm_castsi128_ps( _mm_setr_epi32( ALPHA == 0 ? -1 : 0, 0, 0, ALPHA == 3 ? -1 : 0 ) );
+	const __m128 one = _mm_set1_ps( 1.0f ), zero = _mm_setzero_ps();
+	for( int32_t x = 0; x < width; ++x ) {
+		float *ptr = row + x * 4;
+		__m128 pixel = _mm_loadu_ps( ptr );
+		__m128 alpha = _mm_shuffle_ps( pixel, pixel, _MM_SHUFFLE( ALPHA, ALPHA, ALPHA, ALPHA ) );
+		__m128 result = _mm_mul_ps( pixel, _mm_div_ps( one, alpha ) );
+		// keep the alpha lane, and the whole pixel when alpha is zero
+		__m128 keep = _mm_or_ps( alphaMask, _mm_cmpeq_ps( alpha, zero ) );
+		_mm_storeu_ps( ptr, _mm_or_ps( _mm_and_ps( keep, pixel ), _mm_andnot_ps( keep, result ) ) );
+	}
+	return width;
+}
+
+#elif defined( CINDER_SIMD_NEON )
+
+// Premultiplies 8 interleaved pixels at a time. Returns the number of pixels processed.
+int32_t premultiplyRowNeon( uint8_t *row, int32_t width, uint8_t alphaOffset )
+{
+	const uint16x8_t one = vdupq_n_u16( 1 );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8 ) {
+		uint8x8x4_t pixels = vld4_u8( row + x * 4 );
+		const uint8x8_t alpha = pixels.val[alphaOffset];
+		for( uint8_t c = 0; c < 4; ++c ) {
+			if( c == alphaOffset )
+				continue;
+			uint16x8_t product = vmull_u8( pixels.val[c], alpha );
+			pixels.val[c] = vshrn_n_u16( vaddq_u16( vaddq_u16( product, one ), vshrq_n_u16( product, 8 ) ), 8 );
+		}
+		vst4_u8( row + x * 4, pixels );
+	}
+	return x;
+}
+
+int32_t premultiplyRowNeon( float *row, int32_t width, uint8_t alphaOffset )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		float32x4x4_t pixels = vld4q_f32( row + x * 4 );
+		const float32x4_t alpha = pixels.val[alphaOffset];
+		for( uint8_t c = 0; c < 4; ++c ) {
+			if( c != alphaOffset )
+				pixels.val[c] = vmulq_f32( pixels.val[c], alpha );
+		}
+		vst4q_f32( row + x * 4, pixels );
+	}
+	return x;
+}
+
+#if defined( __aarch64__ ) || defined( _M_ARM64 )
+int32_t unpremultiplyRowNeon( float *row, int32_t width, uint8_t alphaOffset )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		float32x4x4_t pixels = vld4q_f32( row + x * 4 );
+		const float32x4_t alpha = pixels.val[alphaOffset];
+		const float32x4_t invAlpha = vdivq_f32( vdupq_n_f32( 1.0f ), alpha );
+		const uint32x4_t zeroAlpha = vceqq_f32( alpha, vdupq_n_f32( 0 ) );
+		for( uint8_t c = 0; c < 4; ++c ) {
+			if( c != alphaOffset )
+				pixels.val[c] = vbslq_f32( zeroAlpha, pixels.val[c], vmulq_f32( pixels.val[c], invAlpha ) );
+		}
+		vst4q_f32( row + x * 4, pixels );
+	}
+	return x;
+}
+#endif
+
+#endif
+
+// Processes as much of an interleaved RGBA row as the available SIMD kernels allow, returning the number of pixels handled
+template<typename T>
+int32_t premultiplyRowSimd( T * /*row*/, int32_t /*width*/, uint8_t /*pixelInc*/, uint8_t /*alphaOffset*/ )
+{
+	return 0;
+}
+
+template<typename T>
+int32_t unpremultiplyRowSimd( T * /*row*/, int32_t /*width*/, uint8_t /*pixelInc*/, uint8_t /*alphaOffset*/ )
+{
+	return 0;
+}
+
+#if defined( CINDER_SIMD_SSE2 )
+template<>
+int32_t premultiplyRowSimd<uint8_t>( uint8_t *row, int32_t width, uint8_t pixelInc, uint8_t alphaOffset )
+{
+	if( pixelInc != 4 )
+		return 0;
+	return ( alphaOffset == 0 ) ? premultiplyRowSse2<0>( row, width ) : premultiplyRowSse2<3>( row, width );
+}
+
+template<>
+int32_t premultiplyRowSimd<float>( float *row, int32_t width, uint8_t pixelInc, uint8_t alphaOffset )
+{
+	if( pixelInc != 4 )
+		return 0;
+	return ( alphaOffset == 0 ) ? premultiplyRowSse2<0>( row, width ) : premultiplyRowSse2<3>( row, width );
+}
+
+template<>
+int32_t unpremultiplyRowSimd<float>( float *row, int32_t width, uint8_t pixelInc, uint8_t alphaOffset )
+{
+	if( pixelInc != 4 )
+		return 0;
+	return ( alphaOffset == 0 ) ? unpremultiplyRowSse2<0>( row, width ) : unpremultiplyRowSse2<3>( row, width );
+}
+#elif defined( CINDER_SIMD_NEON )
+template<>
+int32_t premultiplyRowSimd<uint8_t>( uint8_t *row, int32_t width, uint8_t pixelInc, uint8_t alphaOffset )
+{
+	return ( pixelInc == 4 ) ? premultiplyRowNeon( row, width, alphaOffset ) : 0;
+}
+
+template<>
+int32_t premultiplyRowSimd<float>( float *row, int32_t width, uint8_t pixelInc, uint8_t alphaOffset )
+{
+	return ( pixelInc == 4 ) ? premultiplyRowNeon( row, width, alphaOffset ) : 0;
+}
+
+#if defined( __aarch64__ ) || defined( _M_ARM64 )
+template<>
+int32_t unpremultiplyRowSimd<float>( float *row, int32_t width, uint8_t pixelInc, uint8_t alphaOffset )
+{
+	return ( pixelInc == 4 ) ? unpremultiplyRowNeon( row, width, alphaOffset ) : 0;
+}
+#endif
+#endif
+
+} // anonymous namespace
+
 template<typename T>
 void premultiply( SurfaceT<T> *surface )
 {
@@ -36,6 +229,7 @@ void premultiply( SurfaceT<T> *surface )
 	if( ! surface->hasAlpha() )
 		return;
 
+	surface->detach();
 	surface->setPremultiplied( true );
 
 	ptrdiff_t rowBytes = surface->getRowBytes();
@@ -43,7 +237,9 @@ void premultiply( SurfaceT<T> *surface )
 	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
 	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
 		T *dstPtr = reinterpret_cast<T*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
+		const int32_t simdWidth = premultiplyRowSimd( dstPtr, clippedArea.getWidth(), pixelInc, alphaOffset );
+		dstPtr += simdWidth * pixelInc;
+		for( int32_t x = simdWidth; x < clippedArea.getWidth(); ++x ) {
 			// The basic formula for unpremultiplication is to divide by the alpha
 			T alpha = dstPtr[alphaOffset];
 			
@@ -55,7 +251,6 @@ void premultiply( SurfaceT<T> *surface )
 	}
 }
 
-// this is a candidate for sse2
 template<>
 void unpremultiply<uint8_t>( SurfaceT<uint8_t> *surface )
 {
@@ -64,6 +259,7 @@ void unpremultiply<uint8_t>( SurfaceT<uint8_t> *surface )
 	if( ! surface->hasAlpha() )
 		return;
 
+	surface->detach();
 	surface->setPremultiplied( false );
 
 	ptrdiff_t rowBytes = surface->getRowBytes();
@@ -76,9 +272,10 @@ void unpremultiply<uint8_t>( SurfaceT<uint8_t> *surface )
 			// which in 8bit pixel arithmetic is to multiply by 255 and divide by the alpha
 			uint8_t alpha = dstPtr[alphaOffset];
 			if( alpha ) {
-				dstPtr[redOffset] = std::min<int>( dstPtr[redOffset] * 255 / alpha, 255 );
-				dstPtr[greenOffset] = std::min<int>( dstPtr[greenOffset] * 255 / alpha, 255 );
-				dstPtr[blueOffset] = std::min<int>( dstPtr[blueOffset] * 255 / alpha, 255 );
+				const uint32_t recip = sUnpremultiplyTable[alpha];
+				dstPtr[redOffset] = std::min<uint32_t>( ( dstPtr[redOffset] * recip ) >> 16, 255 );
+				dstPtr[greenOffset] = std::min<uint32_t>( ( dstPtr[greenOffset] * recip ) >> 16, 255 );
+				dstPtr[blueOffset] = std::min<uint32_t>( ( dstPtr[blueOffset] * recip ) >> 16, 255 );
 			}
 			dstPtr += pixelInc;
 		}
@@ -93,6 +290,7 @@ void unpremultiply<float>( SurfaceT<float> *surface )
 	if( ! surface->hasAlpha() )
 		return;
 
+	surface->detach();
 	surface->setPremultiplied( false );
 
 	ptrdiff_t rowBytes = surface->getRowBytes();
@@ -100,7 +298,9 @@ void unpremultiply<float>( SurfaceT<float> *surface )
 	uint8_t redOffset = surface->getRedOffset(), greenOffset = surface->getGreenOffset(), blueOffset = surface->getBlueOffset(), alphaOffset = surface->getAlphaOffset();
 	for( int32_t y = clippedArea.getY1(); y < clippedArea.getY2(); ++y ) {
 		float *dstPtr = reinterpret_cast<float*>( reinterpret_cast<uint8_t*>( surface->getData() + clippedArea.getX1() * pixelInc ) + y * rowBytes );
-		for( int32_t x = 0; x < clippedArea.getWidth(); ++x ) {
+		const int32_t simdWidth = unpremultiplyRowSimd( dstPtr, clippedArea.getWidth(), pixelInc, alphaOffset );
+		dstPtr += simdWidth * pixelInc;
+		for( int32_t x = simdWidth; x < clippedArea.getWidth(); ++x ) {
 			// The basic formula for unpremultiplication is to divide by the alpha
 			if( dstPtr[alphaOffset] != 0 ) {
 				float invAlpha = 1.0f / dstPtr[alphaOffset];
@@ -22,9 +22,13 @@
 
 #include "cinder/Surface.h"
 #include "cinder/ip/Resize.h"
+#include "cinder/ip/Parallel.h"
+#include "cinder/SurfacePool.h"
 #include "cinder/Filter.h"
 #include "cinder/Rect.h"
 #include "cinder/ChanTraits.h"
+#include "cinder/Simd.h"
+#include "cinder/System.h"
 
 #include <math.h>
 #include <vector>
@@ -34,6 +38,7 @@ using std::unique_ptr;
 #include <limits>
 #include <fstream>
 #include <algorithm>
+#include <cstring>
 
 namespace cinder { namespace ip {
 
@@ -92,13 +97,12 @@ class WeightTable {		/* SAMPLED FILTER WEIGHT TABLE */
     T		*weight;		/* weight[i] goes with pixel at start+i */
 };
 
-template<typename LT, typename AT>
-void scanlineAccumulate( LT weight, LT *lineBuffer, int32_t lineBufferWidth, AT *accum );
 template<typename T, typename WT>
 void makeWeightTable( int32_t b, float cen, const FilterBase &filter, const FilterParams *params, int32_t len, bool trimzeros, WeightTable<WT> *wtab );
 
+// writes lane \a lane of \a accum (which holds \a numLanes values per pixel) to a row of \a channel
 template<typename AT, typename T>
-void scanlineShiftAccumToChannel( AT *accum, int32_t x1, int32_t y, int32_t width, ChannelT<T> *channel )
+void scanlineShiftAccumToChannel( const AT *accum, int32_t lane, int32_t numLanes, int32_t x1, int32_t y, int32_t width, ChannelT<T> *channel )
 {
 	AT result;
 	T *dst;
@@ -106,24 +110,24 @@ void scanlineShiftAccumToChannel( AT *accum, int32_t x1, int32_t y, int32_t widt
 	dst = channel->getData( x1, y );
 	int8_t pixelStride = channel->getIncrement();
 
+	accum += lane;
 	for( int32_t i = 0; i < width; i++ ) {
-		result = SCALETRAIT<T>::ACCUMTOCHANNEL( *accum++ );
+		result = SCALETRAIT<T>::ACCUMTOCHANNEL( *accum );
 		*dst = static_cast<T>( result );
 		dst += pixelStride;
+		accum += numLanes;
 	}
 }
 
+// filters a single channel, writing every \a lineStride'th element of \a lineBuffer
 template<typename T, typename WT, typename AT>
-void scanlineFilterChannelToBuffer( WeightTable<WT> *weights, int32_t x, int32_t y, const ChannelT<T> &channel, AT *lineBuffer, int32_t width )
+void scanlineFilterChannelToBuffer( const WeightTable<WT> *weights, const T *srcLine, int8_t pixelStride, AT *lineBuffer, int32_t lineStride, int32_t width )
 {
 	int32_t b, af;
 	AT sum;
-	AT *wp;
-	const T *srcLine, *src;
-
-	srcLine = channel.getData( x, y );
+	const WT *wp;
+	const T *src;
 
-	int8_t pixelStride = channel.getIncrement();
 	for ( b = 0; b < width; b++ ) {
 		if( std::numeric_limits<AT>::is_integer )
 			sum = 1 << 7;
@@ -135,15 +139,241 @@ void scanlineFilterChannelToBuffer( WeightTable<WT> *weights, int32_t x, int32_t
 			sum += *wp++ * *src;
 			src += pixelStride;
 		}
-		*lineBuffer++ = SCALETRAIT<T>::CHANNELTOBUFFER( sum );
+		*lineBuffer = SCALETRAIT<T>::CHANNELTOBUFFER( sum );
+		lineBuffer += lineStride;
 		weights++;
 	}	
 }
 
+// filters every channel of a line of interleaved PIXELINC-element pixels in one pass, writing PIXELINC lanes per dest pixel
+template<int PIXELINC, typename T, typename WT, typename AT>
+void scanlineFilterPixelsToBuffer( const WeightTable<WT> *weights, const T *srcLine, AT *lineBuffer, int32_t width )
+{
+	for( int32_t b = 0; b < width; b++, weights++ ) {
+		AT sum[PIXELINC];
+		for( int c = 0; c < PIXELINC; c++ )
+			sum[c] = std::numeric_limits<AT>::is_integer ? AT( 1 << 7 ) : AT( 0 );
+
+		const T *src = srcLine + weights->start * PIXELINC;
+		const WT *wp = weights->weight;
+		for( int32_t af = weights->start; af < weights->end; af++, src += PIXELINC ) {
+			const WT w = *wp++;
+			for( int c = 0; c < PIXELINC; c++ )
+				sum[c] += w * src[c];
+		}
+
+		for( int c = 0; c < PIXELINC; c++ )
+			*lineBuffer++ = SCALETRAIT<T>::CHANNELTOBUFFER( sum[c] );
+	}
+}
+
+template<typename LT, typename AT>
+void scanlineAccumulate( LT weight, const LT *lineBuffer, int32_t width, AT *accum )
+{
+	AT *dest = accum;
+	int32_t x;
+
+	for ( x = 0; x < width; x++ )
+		*dest++ += *lineBuffer++ * weight;
+}
+
+namespace {
+
+#if defined( CINDER_SIMD_SSE2 )
+
+// 8-bit RGBA: taps are processed in pairs with _mm_madd_epi16, which requires every weight to fit in 16 bits
+void scanlineFilterPixelsToBufferSse2( const WeightTable<int32_t> *weights, const uint8_t *srcLine, int32_t *lineBuffer, int32_t width )
+{
+	const __m128i zero = _mm_setzero_si128();
+	for( int32_t b = 0; b < width; b++, weights++, lineBuffer += 4 ) {
+		__m128i sum = _mm_set1_epi32( 1 << 7 );
+		const uint8_t *src = srcLine + weights->start * 4;
+		const int32_t *wp = weights->weight;
+		const int32_t numTaps = weights->end - weights->start;
+		int32_t t = 0;
+		for( ; t + 1 < numTaps; t += 2, src += 8 ) {
+			__m128i pixels = _mm_unpacklo_epi8( _mm_loadl_epi64( reinterpret_cast<const __m128i*>( src ) ), zero );
+			// interleave the two pixels so each 32-bit lane holds the same channel of both: ( p0.c, p1.c )
+			__m128i pairs = _mm_unpacklo_epi16( pixels, _mm_unpackhi_epi64( pixels, pixels ) );
+			__m128i w = _mm_set1_epi32( (int32_t)( ( (uint32_t)wp[t] & 0xFFFF ) | ( (uint32_t)wp[t + 1] << 16 ) ) );
+			sum = _mm_add_epi32( sum, _mm_madd_epi16( pairs, w ) );
+		}
+		if( t < numTaps ) {
+			int32_t pixel;
+			memcpy( &pixel, src, sizeof( pixel ) );
+			__m128i pairs = _mm_unpacklo_epi16( _mm_unpacklo_epi8( _mm_cvtsi32_si128( pixel ), zero ), zero );
+			sum = _mm_add_epi32( sum, _mm_madd_epi16( pairs, _mm_set1_epi32( wp[t] & 0xFFFF ) ) );
+		}
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( lineBuffer ), _mm_srai_epi32( sum, 8 ) );
+	}
+}
+
+void scanlineFilterPixelsToBufferSse2( const WeightTable<float> *weights, const float *srcLine, float *lineBuffer, int32_t width )
+{
+	for( int32_t b = 0; b < width; b++, weights++, lineBuffer += 4 ) {
+		__m128 sum = _mm_setzero_ps();
+		const float *src = srcLine + weights->start * 4;
+		const float *wp = weights->weight;
+		for( int32_t af = weights->start; af < weights->end; af++, src += 4 )
+			sum = _mm_add_ps( sum, _mm_mul_ps( _mm_set1_ps( *wp++ ), _mm_loadu_ps( src ) ) );
+		_mm_storeu_ps( lineBuffer, sum );
+	}
+}
+
+CI_SIMD_TARGET_SSE4_1 void scanlineAccumulateSse4_1( int32_t weight, const int32_t *lineBuffer, int32_t width, int32_t *accum )
+{
+	const __m128i w = _mm_set1_epi32( weight );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 ) {
+		__m128i line = _mm_loadu_si128( reinterpret_cast<const __m128i*>( lineBuffer + x ) );
+		__m128i acc = _mm_loadu_si128( reinterpret_cast<const __m128i*>( accum + x ) );
+		_mm_storeu_si128( reinterpret_cast<__m128i*>( accum + x ), _mm_add_epi32( acc, _mm_mullo_epi32( line, w ) ) );
+	}
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
+
+void scanlineAccumulateSse2( float weight, const float *lineBuffer, int32_t width, float *accum )
+{
+	const __m128 w = _mm_set1_ps( weight );
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 )
+		_mm_storeu_ps( accum + x, _mm_add_ps( _mm_loadu_ps( accum + x ), _mm_mul_ps( _mm_loadu_ps( lineBuffer + x ), w ) ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
+
+CI_SIMD_TARGET_AVX2 void scanlineAccumulateAvx2( int32_t weight, const int32_t *lineBuffer, int32_t width, int32_t *accum )
+{
+	const __m256i w = _mm256_set1_epi32( weight );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8 ) {
+		__m256i line = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( lineBuffer + x ) );
+		__m256i acc = _mm256_loadu_si256( reinterpret_cast<const __m256i*>( accum + x ) );
+		_mm256_storeu_si256( reinterpret_cast<__m256i*>( accum + x ), _mm256_add_epi32( acc, _mm256_mullo_epi32( line, w ) ) );
+	}
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
+
+CI_SIMD_TARGET_AVX2 void scanlineAccumulateAvx2( float weight, const float *lineBuffer, int32_t width, float *accum )
+{
+	const __m256 w = _mm256_set1_ps( weight );
+	int32_t x = 0;
+	for( ; x + 8 <= width; x += 8 )
+		_mm256_storeu_ps( accum + x, _mm256_add_ps( _mm256_loadu_ps( accum + x ), _mm256_mul_ps( _mm256_loadu_ps( lineBuffer + x ), w ) ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
+
+#elif defined( CINDER_SIMD_NEON )
+
+void scanlineFilterPixelsToBufferNeon( const WeightTable<int32_t> *weights, const uint8_t *srcLine, int32_t *lineBuffer, int32_t width )
+{
+	for( int32_t b = 0; b < width; b++, weights++, lineBuffer += 4 ) {
+		int32x4_t sum = vdupq_n_s32( 1 << 7 );
+		const uint8_t *src = srcLine + weights->start * 4;
+		const int32_t *wp = weights->weight;
+		for( int32_t af = weights->start; af < weights->end; af++, src += 4 ) {
+			uint32_t pixel;
+			memcpy( &pixel, src, sizeof( pixel ) );
+			int32x4_t p = vreinterpretq_s32_u32( vmovl_u16( vget_low_u16( vmovl_u8( vreinterpret_u8_u32( vdup_n_u32( pixel ) ) ) ) ) );
+			sum = vmlaq_n_s32( sum, p, *wp++ );
+		}
+		vst1q_s32( lineBuffer, vshrq_n_s32( sum, 8 ) );
+	}
+}
+
+void scanlineFilterPixelsToBufferNeon( const WeightTable<float> *weights, const float *srcLine, float *lineBuffer, int32_t width )
+{
+	for( int32_t b = 0; b < width; b++, weights++, lineBuffer += 4 ) {
+		float32x4_t sum = vdupq_n_f32( 0 );
+		const float *src = srcLine + weights->start * 4;
+		const float *wp = weights->weight;
+		for( int32_t af = weights->start; af < weights->end; af++, src += 4 )
+			sum = vaddq_f32( sum, vmulq_n_f32( vld1q_f32( src ), *wp++ ) );
+		vst1q_f32( lineBuffer, sum );
+	}
+}
+
+void scanlineAccumulateNeon( int32_t weight, const int32_t *lineBuffer, int32_t width, int32_t *accum )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 )
+		vst1q_s32( accum + x, vmlaq_n_s32( vld1q_s32( accum + x ), vld1q_s32( lineBuffer + x ), weight ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
+
+void scanlineAccumulateNeon( float weight, const float *lineBuffer, int32_t width, float *accum )
+{
+	int32_t x = 0;
+	for( ; x + 4 <= width; x += 4 )
+		vst1q_f32( accum + x, vaddq_f32( vld1q_f32( accum + x ), vmulq_n_f32( vld1q_f32( lineBuffer + x ), weight ) ) );
+	for( ; x < width; x++ )
+		accum[x] += lineBuffer[x] * weight;
+}
+
+#endif
+
+} // anonymous namespace
+
+// The kernels used for a resample, selected at runtime based on the CPU. All variants produce identical results.
+template<typename T>
+struct ResampleKernels {
+	typedef typename SCALETRAIT<T>::SUMT SUMT;
+	typedef void (*FilterPixelsFn)( const WeightTable<SUMT> *weights, const T *srcLine, SUMT *lineBuffer, int32_t width );
+	typedef void (*AccumulateFn)( SUMT weight, const SUMT *lineBuffer, int32_t width, SUMT *accum );
+
+	// \a weightsFitInt16 reports whether every x weight can be represented in 16 bits
+	ResampleKernels( bool weightsFitInt16 );
+
+	FilterPixelsFn	filterPixels4;
+	AccumulateFn	accumulate;
+};
+
+template<>
+ResampleKernels<uint8_t>::ResampleKernels( bool weightsFitInt16 )
+	: filterPixels4( &scanlineFilterPixelsToBuffer<4,uint8_t,int32_t,int32_t> ), accumulate( &scanlineAccumulate<int32_t,int32_t> )
+{
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasSse4_1 = System::hasSse4_1();
+	static const bool sHasAvx2 = System::hasAvx2();
+	if( weightsFitInt16 )
+		filterPixels4 = &scanlineFilterPixelsToBufferSse2;
+	if( sHasAvx2 )
+		accumulate = &scanlineAccumulateAvx2;
+	else if( sHasSse4_1 )
+		accumulate = &scanlineAccumulateSse4_1;
+#elif defined( CINDER_SIMD_NEON )
+	filterPixels4 = &scanlineFilterPixelsToBufferNeon;
+	accumulate = &scanlineAccumulateNeon;
+#endif
+}
+
+template<>
+ResampleKernels<float>::ResampleKernels( bool /*weightsFitInt16*/ )
+	: filterPixels4( &scanlineFilterPixelsToBuffer<4,float,float,float> ), accumulate( &scanlineAccumulate<float,float> )
+{
+#if defined( CINDER_SIMD_SSE2 )
+	static const bool sHasAvx2 = System::hasAvx2();
+	filterPixels4 = &scanlineFilterPixelsToBufferSse2;
+	if( sHasAvx2 )
+		accumulate = &scanlineAccumulateAvx2;
+	else
+		accumulate = &scanlineAccumulateSse2;
+#elif defined( CINDER_SIMD_NEON )
+	filterPixels4 = &scanlineFilterPixelsToBufferNeon;
+	accumulate = &scanlineAccumulateNeon;
+#endif
+}
+
 // assumes channels are of same dimensions
 template<typename T>
-void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &filter, const Area &srcArea, const Area &dstArea, const vector<ChannelT<T>*> &dstChannels )
+void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &filter, const Area &srcArea, const Area &dstArea, const vector<ChannelT<T>*> &dstChannels, const Options &options )
 {
+	typedef typename SCALETRAIT<T>::SUMT SUMT;
+
 	Rectf clippedSrcRect;
 	Area clippedDstArea;
 	getClippedScaledRects( srcChannels[0]->getBounds(), Rectf( srcArea ), dstChannels[0]->getBounds(), dstArea, &clippedSrcRect, &clippedDstArea );
@@ -158,7 +388,6 @@ void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &
 	int32_t srcWidth = (int32_t)clippedSrcRect.getWidth(), srcHeight = (int32_t)clippedSrcRect.getHeight();
 	int32_t srcOffsetX = static_cast<int32_t>( floor( clippedSrcRect.getX1() ) );
 	int32_t srcOffsetY = static_cast<int32_t>( floor( clippedSrcRect.getY1() ) );
-	vector<pair<int32_t,unique_ptr<typename SCALETRAIT<T>::SUMT[]>>> linesBuffer;
 
 	m.sx = dstWidth / (float)srcWidth;
 	m.sy = dstHeight / (float)srcHeight;
@@ -175,56 +404,87 @@ void resample( const vector<const ChannelT<T>*> &srcChannels, const FilterBase &
 	filterParamsY.supp = std::max( 0.5f, filterParamsY.scale * filter.getSupport() );
 	filterParamsY.width = (int32_t)ceil( 2.0f * filterParamsY.supp );
 
-	for( int32_t i = 0; i < filterParamsY.width; i++ )
-		linesBuffer.push_back( std::make_pair( -1, unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] ) ) );
-
-	WeightTable<typename SCALETRAIT<T>::SUMT> *xWeights, yWeights;
-	typename SCALETRAIT<T>::SUMT *xWeightBuffer, *xWeightPtr;
-	xWeights = (WeightTable<typename SCALETRAIT<T>::SUMT>*)malloc( sizeof(WeightTable<int32_t>) * dstWidth );
-	xWeightBuffer = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * dstWidth * filterParamsX.width );
-	yWeights.weight = (typename SCALETRAIT<T>::SUMT*)malloc( sizeof(typename SCALETRAIT<T>::SUMT) * filterParamsY.width );
-	unique_ptr<typename SCALETRAIT<T>::SUMT[]> accum = unique_ptr<typename SCALETRAIT<T>::SUMT[]>( new typename SCALETRAIT<T>::SUMT[dstWidth] );
-
-	xWeightPtr = xWeightBuffer;
+	// the x weights only depend on the dest column, so they are computed once and shared read-only by every row band
+	vector<WeightTable<SUMT>> xWeights( dstWidth );
+	unique_ptr<SUMT[]> xWeightBuffer( new SUMT[dstWidth * filterParamsX.width] );
+	SUMT *xWeightPtr = xWeightBuffer.get();
+	bool weightsFitInt16 = true;
 	for ( int32_t bx = 0; bx < dstWidth; bx++, xWeightPtr += filterParamsX.width ) {
 		xWeights[bx].weight = xWeightPtr;
-		makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &xWeights[bx] );
+		makeWeightTable<T,SUMT>( MAP(bx, m.sx, m.ux), filter, &filterParamsX, srcWidth, true, &xWeights[bx] );
+		for( int32_t i = 0; i < xWeights[bx].end - xWeights[bx].start; ++i )
+			weightsFitInt16 = weightsFitInt16 && ( xWeights[bx].weight[i] >= -32768 ) && ( xWeights[bx].weight[i] <= 32767 );
+	}
+
+	const ResampleKernels<T> kernels( weightsFitInt16 );
+
+	// Channels which are interleaved within the same pixel (a Surface's RGB(A) channels) are filtered together in a single
+	// pass over each source line. A filtered line then holds numLanes values per dest pixel, with channel c in lane[c].
+	const size_t numChannels = srcChannels.size();
+	const int32_t srcIncrement = srcChannels[0]->getIncrement();
+	const T *srcPixel = srcChannels[0]->getData();
+	for( size_t c = 1; c < numChannels; ++c )
+		srcPixel = std::min( srcPixel, srcChannels[c]->getData() );
+
+	bool interleaved = ( numChannels > 1 ) && ( numChannels <= 4 ) && ( srcIncrement == 3 || srcIncrement == 4 );
+	for( size_t c = 0; c < numChannels && interleaved; ++c ) {
+		const ptrdiff_t offset = srcChannels[c]->getData() - srcPixel;
+		interleaved = ( srcChannels[c]->getIncrement() == srcIncrement ) && ( srcChannels[c]->getRowBytes() == srcChannels[0]->getRowBytes() ) && ( offset < srcIncrement );
 	}
 
-	for( size_t chan = 0; chan < srcChannels.size(); ++chan ) {
-		for ( int32_t dstY = 0; dstY < dstHeight; ++dstY ) {     // loop over dest scanlines
+	const int32_t numLanes = interleaved ? srcIncrement : (int32_t)numChannels;
+	vector<int32_t> lanes( numChannels );
+	for( size_t c = 0; c < numChannels; ++c )
+		lanes[c] = interleaved ? (int32_t)( srcChannels[c]->getData() - srcPixel ) : (int32_t)c;
+
+	auto filterLine = [&]( int32_t srcY, SUMT *line ) {
+		if( interleaved ) {
+			const ptrdiff_t srcRowOffset = reinterpret_cast<const uint8_t*>( srcChannels[0]->getData( srcOffsetX, srcY ) ) - reinterpret_cast<const uint8_t*>( srcChannels[0]->getData() );
+			const T *srcLine = reinterpret_cast<const T*>( reinterpret_cast<const uint8_t*>( srcPixel ) + srcRowOffset );
+			if( numLanes == 4 )
+				kernels.filterPixels4( xWeights.data(), srcLine, line, dstWidth );
+			else
+				scanlineFilterPixelsToBuffer<3>( xWeights.data(), srcLine, line, dstWidth );
+		}
+		else {
+			for( size_t c = 0; c < numChannels; ++c )
+				scanlineFilterChannelToBuffer( xWeights.data(), srcChannels[c]->getData( srcOffsetX, srcY ), srcChannels[c]->getIncrement(), line + lanes[c], numLanes, dstWidth );
+		}
+	};
+
+	// each band of dest rows is independent: it caches its own filtered source lines and accumulates into its own buffer,
+	// so the result is identical regardless of how the rows are split
+	const int32_t lineSize = dstWidth * numLanes;
+	parallelForRows( 0, dstHeight, options, [&]( int32_t dstYBegin, int32_t dstYEnd ) {
+		vector<pair<int32_t,unique_ptr<SUMT[]>>> linesBuffer;
+		for( int32_t i = 0; i < filterParamsY.width; i++ )
+			linesBuffer.push_back( std::make_pair( -1, unique_ptr<SUMT[]>( new SUMT[lineSize] ) ) );
+
+		WeightTable<SUMT> yWeights;
+		unique_ptr<SUMT[]> yWeightBuffer( new SUMT[filterParamsY.width] );
+		yWeights.weight = yWeightBuffer.get();
+		unique_ptr<SUMT[]> accum( new SUMT[lineSize] );
+
+		for ( int32_t dstY = dstYBegin; dstY < dstYEnd; ++dstY ) {     // loop over dest scanlines
 			// prepare a weight table for dest y position by
-			makeWeightTable<T,typename SCALETRAIT<T>::SUMT>( MAP(dstY, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &yWeights );
+			makeWeightTable<T,SUMT>( MAP(dstY, m.sy, m.uy), filter, &filterParamsY, srcHeight, false, &yWeights );
 
-			memset( accum.get(), 0, sizeof(int32_t) * dstWidth );
+			memset( accum.get(), 0, sizeof(SUMT) * lineSize );
 
 			// loop over source scanlines that influence this dest scanline
 			for ( int32_t ayf = yWeights.start; ayf < yWeights.end; ayf++ ) {
-				typename SCALETRAIT<T>::SUMT *line = linesBuffer[ayf % filterParamsY.width].second.get();
+				SUMT *line = linesBuffer[ayf % filterParamsY.width].second.get();
 				if( linesBuffer[ayf % filterParamsY.width].first != ayf ) {
-					scanlineFilterChannelToBuffer( xWeights, srcOffsetX, srcOffsetY + ayf, *(srcChannels[chan]), line, dstWidth );
+					filterLine( srcOffsetY + ayf, line );
 					linesBuffer[ayf % filterParamsY.width].first = ayf;
 				}
-				scanlineAccumulate<typename SCALETRAIT<T>::SUMT,typename SCALETRAIT<T>::SUMT>( yWeights.weight[ayf - yWeights.start], line, dstWidth, accum.get() );
+				kernels.accumulate( yWeights.weight[ayf - yWeights.start], line, lineSize, accum.get() );
 			}
 
-			scanlineShiftAccumToChannel( accum.get(), clippedDstArea.getX1(), clippedDstArea.getY1() + dstY, dstWidth, dstChannels[chan] );
+			for( size_t c = 0; c < numChannels; ++c )
+				scanlineShiftAccumToChannel( accum.get(), lanes[c], numLanes, clippedDstArea.getX1(), clippedDstArea.getY1() + dstY, dstWidth, dstChannels[c] );
 		}
-	}
-
-	free( xWeights );
-	free( xWeightBuffer );
-	free( yWeights.weight );
-}
-
-template<typename LT, typename AT>
-void scanlineAccumulate( LT weight, LT *lineBuffer, int32_t width, AT *accum )
-{
-	AT *dest = accum;
-	int32_t x;
-
-	for ( x = 0; x < width; x++ )
-		*dest++ += *lineBuffer++ * weight;
+	} );
 }
 
 template<typename T, typename WT>
@@ -308,8 +568,9 @@ void makeWeightTable( float cen, const FilterBase &filter, const FilterParams *p
 }
 
 template<typename T>
-void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter )
+void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter, const Options &options )
 {
+	dstSurface->detach();
 	vector<const ChannelT<T>*> srcChannels;
 	vector<ChannelT<T>*> dstChannels;
 
@@ -324,11 +585,11 @@ void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *ds
 		dstChannels.push_back( &dstSurface->getChannelAlpha() );	
 	}
 
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+	resample( srcChannels, filter, srcArea, dstArea, dstChannels, options );
 }
 
 template<typename T>
-void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter )
+void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter, const Options &options )
 {
 	vector<const ChannelT<T>*> srcChannels;
 	vector<ChannelT<T>*> dstChannels;
@@ -336,35 +597,36 @@ void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *ds
 	srcChannels.push_back( &srcChannel );
 	dstChannels.push_back( dstChannel );
 	
-	resample( srcChannels, filter, srcArea, dstArea, dstChannels );
+	resample( srcChannels, filter, srcArea, dstArea, dstChannels, options );
 }
 
 template<typename T>
-void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const FilterBase &filter )
+void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const FilterBase &filter, const Options &options )
 {
-	resize( srcSurface, srcSurface.getBounds(), dstSurface, dstSurface->getBounds(), filter );
+	resize( srcSurface, srcSurface.getBounds(), dstSurface, dstSurface->getBounds(), filter, options );
 }
 
 template<typename T>
-SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter )
+SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter, const Options &options )
 {
-	SurfaceT<T> result( dstSize.x, dstSize.y, srcSurface.hasAlpha(), srcSurface.getChannelOrder() );
-	resize( srcSurface, srcArea, &result, result.getBounds(), filter );
+	SurfaceT<T> result = ( options.getPool() ) ? options.getPool()->acquire<T>( dstSize.x, dstSize.y, srcSurface.hasAlpha(), srcSurface.getChannelOrder() )
+								: SurfaceT<T>( dstSize.x, dstSize.y, srcSurface.hasAlpha(), srcSurface.getChannelOrder() );
+	resize( srcSurface, srcArea, &result, result.getBounds(), filter, options );
 	return result;
 }
 
 template<typename T>
-void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter )
+void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter, const Options &options )
 {
-	resize( srcChannel, srcChannel.getBounds(), dstChannel, dstChannel->getBounds(), filter );
+	resize( srcChannel, srcChannel.getBounds(), dstChannel, dstChannel->getBounds(), filter, options );
 }
 
 #define resize_PROTOTYPES(T)\
-	template CI_API void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const FilterBase &filter ); \
-	template CI_API void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter ); \
-	template CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter ); \
-	template CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter ); \
-	template CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter );
+	template CI_API void resize( const SurfaceT<T> &srcSurface, SurfaceT<T> *dstSurface, const FilterBase &filter, const Options &options ); \
+	template CI_API void resize( const SurfaceT<T> &srcSurface, const Area &srcArea, SurfaceT<T> *dstSurface, const Area &dstArea, const FilterBase &filter, const Options &options ); \
+	template CI_API void resize( const ChannelT<T> &srcChannel, ChannelT<T> *dstChannel, const FilterBase &filter, const Options &options ); \
+	template CI_API SurfaceT<T> resizeCopy( const SurfaceT<T> &srcSurface, const Area &srcArea, const ivec2 &dstSize, const FilterBase &filter, const Options &options ); \
+	template CI_API void resize( const ChannelT<T> &srcChannel, const Area &srcArea, ChannelT<T> *dstChannel, const Area &dstArea, const FilterBase &filter, const Options &options );
 
 // These should match CHANNEL_TYPES
 resize_PROTOTYPES(uint8_t)
@@ -30,6 +30,7 @@ namespace cinder { namespace ip {
 template<typename T>
 void thresholdImpl( SurfaceT<T> *surface, T value, const Area &area )
 {
+	surface->detach();
 	const Area clippedArea = area.getClipBy( surface->getBounds() );
 	ptrdiff_t rowBytes = surface->getRowBytes();
 	uint8_t pixelInc = surface->getPixelInc();
@@ -49,6 +50,7 @@ void thresholdImpl( SurfaceT<T> *surface, T value, const Area &area )
 template<typename T>
 void thresholdImpl( const SurfaceT<T> &srcSurface, T value, const Area &srcArea, const ivec2 &dstLT, SurfaceT<T> *dstSurface )
 {
+	dstSurface->detach();
 	std::pair<Area,ivec2> srcDst = clippedSrcDst( srcSurface.getBounds(), srcArea, dstSurface->getBounds(), dstLT );
 	const Area &area( srcDst.first );
 	const ivec2 &dstOffset( srcDst.second );
@@ -118,10 +120,11 @@ void threshold( const ChannelT<T> &srcChannel, T value, ChannelT<T> *dstChannel
 	thresholdImpl( srcChannel, value, srcChannel.getBounds(), ivec2(), dstChannel );
 }
 
+// The integral image is padded by one row and column, so the window (x1, x2] x (y1, y2] of Bradley & Roth is the table rectangle [x1 + 1, x2 + 1) x [y1 + 1, y2 + 1)
 template<typename T>
-void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
+void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
+	typedef typename IntegralImageT<T>::SumT SUMT; 
 
 	int32_t imageWidth = srcChannel->getWidth();
 	int32_t imageHeight = srcChannel->getHeight();
@@ -134,42 +137,38 @@ void calculateAdaptiveThreshold( const ChannelT<T> *srcChannel, typename CHANTRA
 	const T maxValue = CHANTRAIT<T>::max();
 
 	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			*dst = ( (SUMT)(*src * count) < (sum * comparisonMult / 256) ) ? 0 : maxValue;
-			dst += dstInc;
-			src += srcInc;
+	parallelForRows( 0, imageHeight, options, [&]( int32_t rowBegin, int32_t rowEnd ) {
+		for( int32_t j = rowBegin; j < rowEnd; j++ ) {
+			T *dst = dstChannel->getData( 0, j );
+			const T *src = srcChannel->getData( 0, j );
+			for( int32_t i = 0; i< imageWidth; i++ ) {
+
+				// set the SxS region
+				int32_t x1 = i - s2, x2 = i + s2;
+				int32_t y1 = j - s2, y2 = j + s2;
+
+				// check the border
+				if( x1 < 0 ) x1 = 0;
+				if( x2 >= imageWidth ) x2 = imageWidth - 1;
+				if( y1 < 0 ) y1 = 0;
+				if( y2 >= imageHeight ) y2 = imageHeight - 1;
+				
+				int32_t count = ( x2 - x1 ) * ( y2 - y1 );
+
+				SUMT sum = integralImage.getSum( x1 + 1, y1 + 1, x2 + 1, y2 + 1 );
+
+				*dst = ( (SUMT)(*src * count) < (sum * comparisonMult / 256) ) ? 0 : maxValue;
+				dst += dstInc;
+				src += srcInc;
+			}
 		}
-	}
+	} );
 }
 
 template<typename T>
-void calculateAdaptiveThresholdZero( const ChannelT<T> *srcChannel, typename CHANTRAIT<T>::Accum *integralImage, int32_t windowSize, ChannelT<T> *dstChannel )
+void calculateAdaptiveThresholdZero( const ChannelT<T> *srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, ChannelT<T> *dstChannel, const Options &options )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
+	typedef typename IntegralImageT<T>::SumT SUMT; 
 
 	int32_t imageWidth = srcChannel->getWidth();
 	int32_t imageHeight = srcChannel->getHeight();
@@ -178,171 +177,84 @@ void calculateAdaptiveThresholdZero( const ChannelT<T> *srcChannel, typename CHA
 	uint8_t dstInc = dstChannel->getIncrement();
 
 	// perform thresholding
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		T *dstLine = dstChannel->getData( 0, j );
-		T *dst = dstLine;
-		const T *srcLine = srcChannel->getData( 0, j );
-		const T *src = srcLine;
-		for( int32_t i = 0; i< imageWidth; i++ ) {
-
-			// set the SxS region
-			int32_t x1 = i - s2, x2 = i + s2;
-			int32_t y1 = j - s2, y2 = j + s2;
-
-			// check the border
-			if( x1 < 0 ) x1 = 0;
-			if( x2 >= imageWidth ) x2 = imageWidth - 1;
-			if( y1 < 0 ) y1 = 0;
-			if( y2 >= imageHeight ) y2 = imageHeight - 1;
-			
-			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
-
-			// I(x,y)=s(x2,y2)-s(x1,y2)-s(x2,y1)+s(x1,x1)
-			SUMT sum =	integralImage[y2 * imageWidth + x2] -
-						integralImage[y1 * imageWidth + x2] -
-						integralImage[y2 * imageWidth + x1] +
-						integralImage[y1 * imageWidth + x1];
-
-			//*dst = ( (*dst * count) < sum ) ? 0 : maxValue;
-			int32_t diffSignExtended = (int32_t)( sum - *src * count );
-			diffSignExtended >>= 31;
-			*dst = (T)(diffSignExtended & 0xFF);
-			dst += dstInc;
-			src += srcInc;
+	parallelForRows( 0, imageHeight, options, [&]( int32_t rowBegin, int32_t rowEnd ) {
+		for( int32_t j = rowBegin; j < rowEnd; j++ ) {
+			T *dst = dstChannel->getData( 0, j );
+			const T *src = srcChannel->getData( 0, j );
+			for( int32_t i = 0; i< imageWidth; i++ ) {
+
+				// set the SxS region
+				int32_t x1 = i - s2, x2 = i + s2;
+				int32_t y1 = j - s2, y2 = j + s2;
+
+				// check the border
+				if( x1 < 0 ) x1 = 0;
+				if( x2 >= imageWidth ) x2 = imageWidth - 1;
+				if( y1 < 0 ) y1 = 0;
+				if( y2 >= imageHeight ) y2 = imageHeight - 1;
+				
+				int32_t count = ( x2 - x1 ) * ( y2 - y1 );
+
+				SUMT sum = integralImage.getSum( x1 + 1, y1 + 1, x2 + 1, y2 + 1 );
+
+				//*dst = ( (*dst * count) < sum ) ? 0 : maxValue;
+				int32_t diffSignExtended = (int32_t)( sum - *src * count );
+				diffSignExtended >>= 31;
+				*dst = (T)(diffSignExtended & 0xFF);
+				dst += dstInc;
+				src += srcInc;
+			}
 		}
-	}
-
+	} );
 }
 
 template<typename T>
-void calculateIntegralImage( const ChannelT<T> &channel, typename CHANTRAIT<T>::Accum *integralImage )
+void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options )
 {
-	int32_t imageWidth = channel.getWidth(), imageHeight = channel.getHeight();
-	ptrdiff_t srcRowBytes = channel.getRowBytes();
-	uint8_t srcInc = channel.getIncrement();
-	const T *src = channel.getData();
-	/*for( int32_t i = 0; i < imageWidth; i++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t j = 0; j < imageHeight; j++ ) {
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( i == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-1] + sum;
-		}
-	}*/
-	for( int32_t j = 0; j < imageHeight; j++ ) {
-		// reset this column sum
-		typename CHANTRAIT<T>::Accum sum = 0;
-
-		for( int32_t i = 0; i < imageWidth; i++ ) {		
-			uint32_t index = j * imageWidth + i;
-
-			sum += src[j*srcRowBytes+i*srcInc];
-			if( j == 0 )
-				integralImage[index] = sum;
-			else
-				integralImage[index] = integralImage[index-imageWidth] + sum;
-		}
-	}
+	IntegralImageT<T> integralImage( srcChannel, false, options );
+	calculateAdaptiveThreshold( &srcChannel, integralImage, windowSize, percentageDelta, dstChannel, options );
 }
 
 template<typename T>
-void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
+void adaptiveThreshold( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
-	calculateAdaptiveThreshold( &srcChannel, integralImage, windowSize, percentageDelta, dstChannel );
-
-	free( integralImage );	
+	calculateAdaptiveThreshold( &srcChannel, integralImage, windowSize, percentageDelta, dstChannel, options );
 }
 
 template<typename T>
-void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta )
+void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta, const Options &options )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-
-	calculateAdaptiveThreshold( channel, integralImage, windowSize, percentageDelta, channel );
-
-	free( integralImage );	
+	IntegralImageT<T> integralImage( *channel, false, options );
+	calculateAdaptiveThreshold( channel, integralImage, windowSize, percentageDelta, channel, options );
 }
 
 template<typename T>
-void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize )
+void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize, const Options &options )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = channel->getWidth();
-	int32_t imageHeight = channel->getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( *channel, integralImage );
-	
-	calculateAdaptiveThresholdZero( channel, integralImage, windowSize, channel );
-
-	free( integralImage );	
+	IntegralImageT<T> integralImage( *channel, false, options );
+	calculateAdaptiveThresholdZero( channel, integralImage, windowSize, channel, options );
 }
 
 template<typename T>
-void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel )
+void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel, const Options &options )
 {
-	typedef typename CHANTRAIT<T>::Accum SUMT; 
-
-	int32_t imageWidth = srcChannel.getWidth();
-	int32_t imageHeight = srcChannel.getHeight();
-	SUMT *integralImage;
-
-	// create the integral image
-	integralImage = (SUMT*)malloc( imageWidth * imageHeight * sizeof( typename CHANTRAIT<T>::Accum ) );
-	calculateIntegralImage( srcChannel, integralImage );
-	
-	calculateAdaptiveThresholdZero( &srcChannel, integralImage, windowSize, dstChannel );
-
-	free( integralImage );	
+	IntegralImageT<T> integralImage( srcChannel, false, options );
+	calculateAdaptiveThresholdZero( &srcChannel, integralImage, windowSize, dstChannel, options );
 }
 
 template<typename T>
-AdaptiveThresholdT<T>::AdaptiveThresholdT( const ChannelT<T> *channel )
-	: mChannel( channel )
+AdaptiveThresholdT<T>::AdaptiveThresholdT( const ChannelT<T> *channel, const Options &options )
+	: mChannel( channel ), mIntegralImage( *channel, false, options )
 {
-	mImageWidth = mChannel->getWidth();
-	mImageHeight = mChannel->getHeight();
-	mIncrement = mChannel->getIncrement();
-
-	// create the integral image
-	mIntegralImage.resize( mImageWidth * mImageHeight );
-	calculateIntegralImage( *channel, mIntegralImage.data() );
 }
 
 template<typename T>
-void AdaptiveThresholdT<T>::calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel )
+void AdaptiveThresholdT<T>::calculate( int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options )
 {
 	if( percentageDelta < 0.0001f ) {
-		calculateAdaptiveThresholdZero( mChannel, mIntegralImage.data(), windowSize, dstChannel );
+		calculateAdaptiveThresholdZero( mChannel, mIntegralImage, windowSize, dstChannel, options );
 	} else {
-		calculateAdaptiveThreshold( mChannel, mIntegralImage.data(), windowSize, percentageDelta, dstChannel );
+		calculateAdaptiveThreshold( mChannel, mIntegralImage, windowSize, percentageDelta, dstChannel, options );
 	}
 }
 
@@ -354,10 +266,11 @@ template class CI_API AdaptiveThresholdT<float>;
 	template CI_API void threshold( SurfaceT<T> *surface, T value, const Area &area ); \
 	template CI_API void threshold( const SurfaceT<T> &srcSurface, T value, SurfaceT<T> *dstSurface );\
 	template CI_API void threshold( const ChannelT<T> &srcChannel, T value, ChannelT<T> *dstChannel );\
-	template CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel ); \
-	template CI_API void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta ); \
-	template CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize ); \
-	template CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel );
+	template CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options ); \
+	template CI_API void adaptiveThreshold( const ChannelT<T> &srcChannel, const IntegralImageT<T> &integralImage, int32_t windowSize, float percentageDelta, ChannelT<T> *dstChannel, const Options &options ); \
+	template CI_API void adaptiveThreshold( ChannelT<T> *channel, int32_t windowSize, float percentageDelta, const Options &options ); \
+	template CI_API void adaptiveThresholdZero( ChannelT<T> *channel, int32_t windowSize, const Options &options ); \
+	template CI_API void adaptiveThresholdZero( const ChannelT<T> &srcChannel, int32_t windowSize, ChannelT<T> *dstChannel, const Options &options );
 
 threshold_PROTOTYPES(uint8_t)
 
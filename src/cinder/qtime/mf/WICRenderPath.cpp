@@ -31,6 +31,7 @@
 
 #include "cinder/qtime/mf/WICRenderPath.h"
 #include "cinder/Log.h"
+#include "cinder/SurfacePool.h"
 
 using namespace ci;
 
@@ -53,7 +54,8 @@ bool WICRenderPath::initializeRenderTarget( const ci::ivec2& size )
 	if( ! mWicBitmap || size != mSize ) {
 		mSize = size;
 
-		mOwner.mSurface = Surface8u::create( size.x, size.y, true, SurfaceChannelOrder::BGRA );
+		// each frame is copied into the same Surface, so the pool only comes into play when the video size changes
+		mOwner.mSurface = SurfacePool::getDefault()->acquireRef<uint8_t>( size.x, size.y, true, SurfaceChannelOrder::BGRA );
 		return SUCCEEDED( mWicFactory->CreateBitmap( size.x, size.y, GUID_WICPixelFormat32bppBGRA, WICBitmapCacheOnDemand, mWicBitmap.GetAddressOf() ) );
 	}
 
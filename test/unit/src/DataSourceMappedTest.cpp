@@ -0,0 +1,80 @@
+#include "catch.hpp"
+
+#include "cinder/DataSource.h"
+#include "cinder/Utilities.h"
+
+#include <fstream>
+
+using namespace ci;
+
+namespace {
+
+fs::path writeTestFile( const std::string &name, const std::string &contents )
+{
+	fs::path path = fs::temp_directory_path() / name;
+	std::ofstream( path.string(), std::ios::binary ) << contents;
+	return path;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "DataSourceMapped" )
+{
+	std::string contents;
+	for( int i = 0; i < 10000; ++i )
+		contents += std::to_string( i ) + ( i % 10 == 9 ? '\n' : ' ' );
+	const fs::path path = writeTestFile( "cinder_DataSourceMappedTest.txt", contents );
+
+	SECTION( "the buffer views the file and outlives the DataSource" )
+	{
+		DataSourceRef source = loadFileMapped( path );
+		REQUIRE( source->isFilePath() );
+		REQUIRE( source->isMapped() );
+		REQUIRE( source->getFilePath() == path );
+		REQUIRE( loadString( source ) == contents );
+
+		BufferRef buffer = source->getBuffer();
+		REQUIRE( source->getBuffer() == buffer );
+		REQUIRE( buffer->getData() == std::static_pointer_cast<DataSourceMapped>( source )->getMappedFile()->getData() );
+		source.reset();
+		REQUIRE( std::string( static_cast<const char*>( buffer->getData() ), buffer->getSize() ) == contents );
+
+	}
+
+	SECTION( "the mapping is viewed through const Buffers" )
+	{
+		DataSourceRef source = loadFile( path );
+		std::shared_ptr<const Buffer> buffer = loadBufferMapped( source );
+		REQUIRE( buffer->getSize() == contents.size() );
+		REQUIRE( std::string( static_cast<const char*>( buffer->getData() ), buffer->getSize() ) == contents );
+
+		MappedFileRef mapping = MappedFile::create( path );
+		REQUIRE( mapping->createBuffer()->getData() == mapping->getData() );
+	}
+
+	SECTION( "streams share the mapping" )
+	{
+		DataSourceMappedRef source = DataSourceMapped::create( path, MappedFile::ACCESS_RANDOM );
+		IStreamRef first = source->createStream(), second = source->createStream();
+		REQUIRE( first->size() == (off_t)contents.size() );
+		REQUIRE( first->getFileName() == path );
+		REQUIRE( std::static_pointer_cast<IStreamMapped>( first )->getMappedFile() == std::static_pointer_cast<IStreamMapped>( second )->getMappedFile() );
+
+		second->seekAbsolute( -5 );
+		REQUIRE( first->readLine() == "0 1 2 3 4 5 6 7 8 9" );
+		std::string tail;
+		second->readFixedString( &tail, 5 );
+		REQUIRE( tail == contents.substr( contents.size() - 5 ) );
+		REQUIRE( second->isEof() );
+	}
+
+	SECTION( "empty and missing files" )
+	{
+		DataSourceRef empty = loadFileMapped( writeTestFile( "cinder_DataSourceMappedTest_empty.txt", "" ) );
+		REQUIRE( empty->getBuffer()->getSize() == 0 );
+		REQUIRE( empty->createStream()->isEof() );
+
+		DataSourceRef missing = loadFileMapped( fs::temp_directory_path() / "cinder_DataSourceMappedTest_missing.txt" );
+		REQUIRE_THROWS_AS( missing->getBuffer(), StreamExc );
+	}
+}
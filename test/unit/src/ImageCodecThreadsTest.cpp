@@ -0,0 +1,164 @@
+#include "catch.hpp"
+
+#include "cinder/ImageIo.h"
+#include "cinder/ImageSourceFileQoi.h"
+#include "cinder/ImageTargetFileQoi.h"
+#include "cinder/ImageSourceFileRadiance.h"
+#include "cinder/DataTarget.h"
+#include "cinder/Stream.h"
+#include "cinder/Rand.h"
+
+#define QOI_NO_STDIO
+#include "qoi/qoi.h"
+
+#include <cmath>
+#include <cstdlib>
+
+using namespace ci;
+
+namespace {
+
+// flat areas, gradients and noise, so that every QOI op is exercised
+Surface8u mixedSurface( int32_t width, int32_t height, bool alpha, uint32_t seed )
+{
+	Surface8u result( width, height, alpha, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB );
+	Rand rnd( seed );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			ColorA8u c;
+			if( ( y / 7 ) % 3 == 0 )
+				c = ColorA8u( 40, 80, 120, 255 );
+			else if( ( y / 7 ) % 3 == 1 )
+				c = ColorA8u( x * 2, x + y, y, 255 - x );
+			else
+				c = ColorA8u( rnd.nextInt( 256 ), rnd.nextInt( 4 ), rnd.nextInt( 256 ), rnd.nextInt( 2 ) ? 255 : rnd.nextInt( 256 ) );
+			result.setPixel( ivec2( x, y ), c );
+		}
+	}
+	return result;
+}
+
+bool surfacesEqual( const Surface8u &a, const Surface8u &b, const ivec2 &offsetA = ivec2() )
+{
+	for( int32_t y = 0; y < b.getHeight(); ++y ) {
+		for( int32_t x = 0; x < b.getWidth(); ++x ) {
+			if( a.getPixel( ivec2( x, y ) + offsetA ) != b.getPixel( ivec2( x, y ) ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+BufferRef encodeQoi( const Surface8u &surface, int threads )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = (ImageSourceRef)surface;
+	writeImage( ImageTargetFileQoi::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options().threads( threads ), "qoi" ), source );
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return buffer;
+}
+
+// a run length encoded Radiance file with a spread of exponents
+DataSourceRef encodeRadiance( int32_t width, int32_t height, std::vector<float> *pixels )
+{
+	std::string header = "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y " + std::to_string( height ) + " +X " + std::to_string( width ) + "\n";
+	std::vector<uint8_t> bytes( header.begin(), header.end() );
+	Rand rnd( 9 );
+	std::vector<uint8_t> scanline( width * 4 );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			// runs of equal pixels every other few columns
+			const bool repeat = x > 0 && ( x / 5 ) % 2 == 1;
+			for( int c = 0; c < 4; ++c )
+				scanline[x * 4 + c] = repeat ? scanline[( x - 1 ) * 4 + c] : (uint8_t)( c < 3 ? rnd.nextInt( 256 ) : 120 + rnd.nextInt( 16 ) );
+			for( int c = 0; c < 3; ++c )
+				pixels->push_back( std::ldexp( scanline[x * 4 + c] / 256.0f, scanline[x * 4 + 3] - 128 ) );
+		}
+
+		bytes.insert( bytes.end(), { 2, 2, (uint8_t)( width >> 8 ), (uint8_t)( width & 0xff ) } );
+		for( int c = 0; c < 4; ++c ) {
+			for( int32_t x = 0; x < width; ) {
+				int32_t runLength = 1;
+				while( x + runLength < width && runLength < 127 && scanline[( x + runLength ) * 4 + c] == scanline[x * 4 + c] )
+					++runLength;
+				if( runLength > 2 ) {
+					bytes.push_back( (uint8_t)( 128 + runLength ) );
+					bytes.push_back( scanline[x * 4 + c] );
+					x += runLength;
+				}
+				else {
+					bytes.push_back( 1 );
+					bytes.push_back( scanline[x * 4 + c] );
+					x += 1;
+				}
+			}
+		}
+	}
+	BufferRef buffer = Buffer::create( bytes.size() );
+	memcpy( buffer->getData(), bytes.data(), bytes.size() );
+	return DataSourceBuffer::create( buffer );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageIo/threads" )
+{
+	SECTION( "chunked QOI round trips and remains standard QOI" )
+	{
+		for( bool alpha : { true, false } ) {
+			Surface8u full = mixedSurface( 61, 700, alpha, 3 );
+			BufferRef chunked = encodeQoi( full, 4 );
+			REQUIRE( memcmp( (const uint8_t*)chunked->getData() + chunked->getSize() - 4, "qoic", 4 ) == 0 );
+
+			for( int threads : { 1, 3, 0 } ) {
+				ImageSourceRef source = ImageSourceFileQoi::create( DataSourceBuffer::create( chunked ), ImageSource::Options().threads( threads ) );
+				REQUIRE( surfacesEqual( full, Surface8u( source ) ) );
+			}
+
+			const Area area( 7, 95, 50, 433 );
+			ImageSourceRef cropped = ImageSourceFileQoi::create( DataSourceBuffer::create( chunked ), ImageSource::Options().area( area ).threads( 0 ) );
+			REQUIRE( ivec2( cropped->getWidth(), cropped->getHeight() ) == area.getSize() );
+			REQUIRE( surfacesEqual( full, Surface8u( cropped ), area.getUL() ) );
+
+			qoi_desc desc;
+			void *decoded = qoi_decode( chunked->getData(), (int)chunked->getSize(), &desc, 0 );
+			REQUIRE( decoded );
+			REQUIRE( desc.channels == ( alpha ? 4 : 3 ) );
+			Surface8u standard( (uint8_t*)decoded, 61, 700, 61 * desc.channels, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB );
+			REQUIRE( surfacesEqual( full, standard ) );
+			free( decoded );
+		}
+	}
+
+	SECTION( "Radiance decodes identically on any number of threads" )
+	{
+		std::vector<float> pixels;
+		DataSourceRef data = encodeRadiance( 45, 130, &pixels );
+
+		Surface32f serial( ImageSourceFileRadiance::create( data ) );
+		bool exact = true;
+		for( int32_t y = 0; y < 130; ++y ) {
+			for( int32_t x = 0; x < 45; ++x ) {
+				for( int c = 0; c < 3; ++c )
+					exact = exact && serial.getPixel( ivec2( x, y ) )[c] == pixels[( y * 45 + x ) * 3 + c];
+			}
+		}
+		REQUIRE( exact );
+
+		for( int threads : { 2, 0 } ) {
+			for( int32_t factor : { 1, 3 } ) {
+				const auto options = ImageSource::Options().area( Area( 2, 9, 44, 127 ) ).downscale( factor );
+				Surface32f expected( ImageSourceFileRadiance::create( data, options ) );
+				Surface32f parallel( ImageSourceFileRadiance::create( data, ImageSource::Options( options ).threads( threads ) ) );
+				REQUIRE( parallel.getSize() == expected.getSize() );
+				bool matches = true;
+				for( int32_t y = 0; y < expected.getHeight(); ++y ) {
+					for( int32_t x = 0; x < expected.getWidth(); ++x )
+						matches = matches && parallel.getPixel( ivec2( x, y ) ) == expected.getPixel( ivec2( x, y ) );
+				}
+				REQUIRE( matches );
+			}
+		}
+	}
+}
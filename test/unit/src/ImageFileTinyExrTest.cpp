@@ -0,0 +1,225 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ImageFileTinyExr.h"
+#include "cinder/DataTarget.h"
+#include "cinder/Stream.h"
+#include "cinder/Rand.h"
+
+#include "tinyexr/tinyexr.h"
+
+#include <cstdlib>
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+// random bytes scaled to multiples of 1/64 below 4, and alpha to multiples of 1/256 below 1, which are exact as half floats
+Surface32f randomHalfSurface( int32_t width, int32_t height, bool alpha, uint32_t seed )
+{
+	const Surface8u bytes = randomSurface<uint8_t>( width, height, alpha ? SurfaceChannelOrder::RGBA : SurfaceChannelOrder::RGB, seed );
+	Surface32f result( width, height, alpha, bytes.getChannelOrder() );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			const ColorA8u c = bytes.getPixel( ivec2( x, y ) );
+			result.setPixel( ivec2( x, y ), ColorAf( c.r / 64.0f, c.g / 64.0f, c.b / 64.0f, c.a / 256.0f ) );
+		}
+	}
+	return result;
+}
+
+bool surfacesEqual( const Surface32f &a, const Surface32f &b, const ivec2 &offsetA = ivec2() )
+{
+	if( a.hasAlpha() != b.hasAlpha() )
+		return false;
+	for( int32_t y = 0; y < b.getHeight(); ++y ) {
+		for( int32_t x = 0; x < b.getWidth(); ++x ) {
+			if( a.getPixel( ivec2( x, y ) + offsetA ) != b.getPixel( ivec2( x, y ) ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+DataSourceRef toDataSource( const OStreamMemRef &stream )
+{
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+DataSourceRef encodeExr( const Surface32f &surface, const ImageTargetFileTinyExr::Format &format, int threads )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = (ImageSourceRef)surface;
+	writeImage( ImageTargetFileTinyExr::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options().threads( threads ), format ), source );
+	return toDataSource( stream );
+}
+
+// the samples of encodeChannels()
+float channelValue( int channel, int32_t x, int32_t y )
+{
+	return channel + x / 100.0f + y;
+}
+
+// a float EXR written directly through TinyEXR, with the named channels, optionally tiled
+DataSourceRef encodeChannels( int32_t width, int32_t height, const std::vector<std::string> &names, int tileSize )
+{
+	const int numChannels = (int)names.size();
+	std::vector<EXRChannelInfo> info( numChannels );
+	std::vector<int> pixelTypes( numChannels, TINYEXR_PIXELTYPE_FLOAT );
+	for( int c = 0; c < numChannels; ++c )
+		strncpy( info[c].name, names[c].c_str(), 255 );
+
+	EXRHeader header;
+	InitEXRHeader( &header );
+	header.num_channels = numChannels;
+	header.channels = info.data();
+	header.pixel_types = pixelTypes.data();
+	header.requested_pixel_types = pixelTypes.data();
+	header.compression_type = TINYEXR_COMPRESSIONTYPE_ZIP;
+
+	EXRImage image;
+	InitEXRImage( &image );
+	image.num_channels = numChannels;
+	image.width = width;
+	image.height = height;
+
+	std::vector<std::vector<float>> planes;
+	std::vector<std::vector<unsigned char*>> planePointers;
+	std::vector<EXRTile> tiles;
+	if( tileSize == 0 ) {
+		planePointers.emplace_back();
+		for( int c = 0; c < numChannels; ++c ) {
+			planes.emplace_back();
+			for( int32_t y = 0; y < height; ++y )
+				for( int32_t x = 0; x < width; ++x )
+					planes.back().push_back( channelValue( c, x, y ) );
+			planePointers.back().push_back( reinterpret_cast<unsigned char*>( planes.back().data() ) );
+		}
+		image.images = planePointers.back().data();
+	}
+	else {
+		header.tiled = 1;
+		header.tile_size_x = header.tile_size_y = tileSize;
+		header.tile_level_mode = TINYEXR_TILE_ONE_LEVEL;
+		header.tile_rounding_mode = TINYEXR_TILE_ROUND_DOWN;
+		// the tile count is derived from the data window
+		header.data_window.max_x = header.display_window.max_x = width - 1;
+		header.data_window.max_y = header.display_window.max_y = height - 1;
+		const int32_t tilesX = ( width + tileSize - 1 ) / tileSize, tilesY = ( height + tileSize - 1 ) / tileSize;
+		planes.reserve( tilesX * tilesY * numChannels );
+		planePointers.reserve( tilesX * tilesY );
+		for( int32_t ty = 0; ty < tilesY; ++ty ) {
+			for( int32_t tx = 0; tx < tilesX; ++tx ) {
+				EXRTile tile = {};
+				tile.offset_x = tx;
+				tile.offset_y = ty;
+				tile.width = std::min( tileSize, width - tx * tileSize );
+				tile.height = std::min( tileSize, height - ty * tileSize );
+				planePointers.emplace_back();
+				for( int c = 0; c < numChannels; ++c ) {
+					planes.emplace_back( tileSize * tileSize );
+					for( int32_t y = 0; y < tile.height; ++y )
+						for( int32_t x = 0; x < tile.width; ++x )
+							planes.back()[y * tileSize + x] = channelValue( c, tx * tileSize + x, ty * tileSize + y );
+					planePointers.back().push_back( reinterpret_cast<unsigned char*>( planes.back().data() ) );
+				}
+				tile.images = planePointers.back().data();
+				tiles.push_back( tile );
+			}
+		}
+		image.tiles = tiles.data();
+		image.num_tiles = (int)tiles.size();
+	}
+
+	unsigned char *memory = nullptr;
+	const char *error = nullptr;
+	size_t size = SaveEXRImageToMemory( &image, &header, &memory, &error );
+	INFO( ( error ? error : "" ) );
+	REQUIRE( size > 0 );
+	BufferRef buffer = Buffer::create( size );
+	memcpy( buffer->getData(), memory, size );
+	free( memory );
+	return DataSourceBuffer::create( buffer );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageFileTinyExr" )
+{
+	SECTION( "round trips through every compression and surface type" )
+	{
+		Surface32f source = randomHalfSurface( 45, 70, true, 1 );
+		for( auto compression : { ImageTargetFileTinyExr::COMPRESSION_NONE, ImageTargetFileTinyExr::COMPRESSION_ZIP, ImageTargetFileTinyExr::COMPRESSION_PIZ } ) {
+			DataSourceRef data = encodeExr( source, ImageTargetFileTinyExr::Format().compression( compression ), 0 );
+
+			ImageSourceRef exr = ImageSourceFileTinyExr::create( data, ImageSource::Options().threads( 0 ) );
+			REQUIRE( exr->getDataType() == ImageIo::FLOAT16 );
+			REQUIRE( surfacesEqual( source, Surface32f( exr ) ) );
+
+			// half samples land in a Surface16f untouched, and convert exactly back to float
+			Surface16f half( ImageSourceFileTinyExr::create( data ) );
+			REQUIRE( halfToFloat( half.getPixel( ivec2( 7, 9 ) ).g ) == source.getPixel( ivec2( 7, 9 ) ).g );
+			REQUIRE( surfacesEqual( source, Surface32f( (ImageSourceRef)half ) ) );
+
+			// a target without alpha, through the generic conversion
+			Surface8u bytes( ImageSourceFileTinyExr::create( data ), SurfaceConstraintsDefault(), false );
+			REQUIRE( bytes.getPixel( ivec2( 3, 4 ) ).r == CHANTRAIT<uint8_t>::convert( source.getPixel( ivec2( 3, 4 ) ).r ) );
+		}
+
+		// full floats survive exactly
+		Surface32f precise( 19, 23, false, SurfaceChannelOrder::RGB );
+		Rand rnd( 4 );
+		for( int32_t y = 0; y < 23; ++y )
+			for( int32_t x = 0; x < 19; ++x )
+				precise.setPixel( ivec2( x, y ), Colorf( rnd.nextFloat(), rnd.nextFloat( -100, 100 ), rnd.nextFloat() ) );
+		DataSourceRef data = encodeExr( precise, ImageTargetFileTinyExr::Format().halfFloat( false ), 2 );
+		REQUIRE( ImageSourceFileTinyExr::create( data )->getDataType() == ImageIo::FLOAT32 );
+		REQUIRE( surfacesEqual( precise, Surface32f( ImageSourceFileTinyExr::create( data ) ) ) );
+	}
+
+	SECTION( "reads only the rows of an area" )
+	{
+		Surface32f source = randomHalfSurface( 50, 100, false, 2 );
+		for( auto compression : { ImageTargetFileTinyExr::COMPRESSION_ZIP, ImageTargetFileTinyExr::COMPRESSION_PIZ, ImageTargetFileTinyExr::COMPRESSION_RLE } ) {
+			DataSourceRef data = encodeExr( source, ImageTargetFileTinyExr::Format().compression( compression ), 1 );
+			for( const Area &area : { Area( 3, 20, 40, 70 ), Area( 0, 99, 50, 100 ), Area( 10, 0, 11, 33 ) } ) {
+				ImageSourceRef exr = ImageSourceFileTinyExr::create( data, ImageSource::Options().area( area ) );
+				REQUIRE( surfacesEqual( source, Surface32f( exr ), area.getUL() ) );
+			}
+		}
+	}
+
+	SECTION( "selects layers and channels" )
+	{
+		DataSourceRef data = encodeChannels( 21, 35, { "A", "diffuse.B", "diffuse.G", "diffuse.R", "depth", "spec.A", "spec.B", "spec.G", "spec.R" }, 0 );
+
+		ImageSourceRef beauty = ImageSourceFileTinyExr::create( data, ImageSource::Options(), ImageSourceFileTinyExr::Format().layer( "spec" ) );
+		REQUIRE( std::static_pointer_cast<ImageSourceFileTinyExr>( beauty )->getChannelNames().size() == 9 );
+		REQUIRE( beauty->hasAlpha() );
+		Surface32f spec( beauty );
+		REQUIRE( spec.getPixel( ivec2( 20, 34 ) ) == ColorAf( channelValue( 8, 20, 34 ), channelValue( 7, 20, 34 ), channelValue( 6, 20, 34 ), channelValue( 5, 20, 34 ) ) );
+
+		Channel32f depth( ImageSourceFileTinyExr::create( data, ImageSource::Options(), ImageSourceFileTinyExr::Format().channels( { "depth" } ) ) );
+		REQUIRE( depth.getValue( ivec2( 10, 3 ) ) == channelValue( 4, 10, 3 ) );
+
+		REQUIRE_THROWS_AS( ImageSourceFileTinyExr::create( data ), ImageIoExceptionFailedLoadTinyExr );
+	}
+
+	SECTION( "reassembles tiled files" )
+	{
+		DataSourceRef data = encodeChannels( 37, 29, { "B", "G", "R" }, 16 );
+		Surface32f tiled( ImageSourceFileTinyExr::create( data, ImageSource::Options().threads( 0 ) ) );
+		REQUIRE( tiled.getSize() == ivec2( 37, 29 ) );
+		bool matches = true;
+		for( int32_t y = 0; y < 29; ++y )
+			for( int32_t x = 0; x < 37; ++x )
+				matches = matches && tiled.getPixel( ivec2( x, y ) ) == ColorAf( channelValue( 2, x, y ), channelValue( 1, x, y ), channelValue( 0, x, y ), 1 );
+		REQUIRE( matches );
+
+		Surface32f cropped( ImageSourceFileTinyExr::create( data, ImageSource::Options().area( Area( 5, 17, 30, 20 ) ) ) );
+		REQUIRE( surfacesEqual( tiled, cropped, ivec2( 5, 17 ) ) );
+	}
+}
@@ -0,0 +1,219 @@
+#include "catch.hpp"
+
+#include "cinder/ImageLoader.h"
+#include "cinder/ImageSourceFileStbImage.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+struct TestImageDesc {
+	int32_t		id, width, height;
+	bool		gate, fail;
+};
+
+std::mutex					sOrderMutex;
+std::vector<int32_t>		sOrder;
+std::shared_future<void>	sGate;
+std::atomic<int>			sNumDecoding( 0 ), sMaxDecoding( 0 );
+
+// an uncompressed test format, which records the order in which images are opened and can block on sGate
+class ImageSourceTest : public ImageSource {
+  public:
+	static ImageSourceRef create( DataSourceRef dataSource, ImageSource::Options /*options*/ )
+	{
+		return ImageSourceRef( new ImageSourceTest( dataSource ) );
+	}
+
+	ImageSourceTest( const DataSourceRef &dataSource )
+	{
+		std::memcpy( &mDesc, dataSource->getBuffer()->getData(), sizeof( mDesc ) );
+		{
+			std::lock_guard<std::mutex> lock( sOrderMutex );
+			sOrder.push_back( mDesc.id );
+		}
+		if( mDesc.gate )
+			sGate.wait();
+		if( mDesc.fail )
+			throw ImageIoExceptionFailedLoad( "test failure" );
+
+		setSize( mDesc.width, mDesc.height );
+		setDataType( ImageIo::UINT8 );
+		setColorModel( ImageIo::CM_RGB );
+		setChannelOrder( ImageIo::RGB );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		const int numDecoding = ++sNumDecoding;
+		int maxDecoding = sMaxDecoding;
+		while( numDecoding > maxDecoding && ! sMaxDecoding.compare_exchange_weak( maxDecoding, numDecoding ) )
+			;
+
+		ImageSource::RowFunc func = setupRowFunc( target );
+		std::vector<uint8_t> row( mDesc.width * 3, (uint8_t)mDesc.id );
+		for( int32_t y = 0; y < mDesc.height; ++y )
+			( this->*func )( target, y, row.data() );
+		std::this_thread::sleep_for( std::chrono::milliseconds( 2 ) );
+
+		--sNumDecoding;
+	}
+
+	TestImageDesc	mDesc;
+};
+
+DataSourceRef testImage( int32_t id, int32_t width, int32_t height, bool gate = false, bool fail = false )
+{
+	TestImageDesc desc = { id, width, height, gate, fail };
+	BufferRef buffer = Buffer::create( sizeof( desc ) );
+	std::memcpy( buffer->getData(), &desc, sizeof( desc ) );
+	return DataSourceBuffer::create( buffer );
+}
+
+// an uncompressed, top-down 24-bit TGA, which stb_image can probe before opening
+DataSourceRef tgaImage( int32_t width, int32_t height )
+{
+	const uint8_t header[18] = { 0, 0, 2, 0, 0, 0, 0, 0, 0, 0, 0, 0, uint8_t( width ), uint8_t( width >> 8 ), uint8_t( height ), uint8_t( height >> 8 ), 24, 0x20 };
+	BufferRef buffer = Buffer::create( sizeof( header ) + width * height * 3 );
+	uint8_t *data = (uint8_t*)buffer->getData();
+	std::memcpy( data, header, sizeof( header ) );
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			uint8_t *pixel = data + sizeof( header ) + ( y * width + x ) * 3;
+			pixel[0] = uint8_t( x + y ); // BGR
+			pixel[1] = uint8_t( y );
+			pixel[2] = uint8_t( x );
+		}
+	}
+	return DataSourceBuffer::create( buffer );
+}
+
+const ImageLoader::Request sTestRequest = ImageLoader::Request().extension( "imageloadertest" );
+
+} // anonymous namespace
+
+TEST_CASE( "ImageLoader" )
+{
+	ImageIoRegistrar::registerSourceType( "imageloadertest", ImageSourceTest::create );
+	sOrder.clear();
+
+	SECTION( "batches decode into futures" )
+	{
+		auto pool = SurfacePool::create();
+		auto loader = ImageLoader::create( ImageLoader::Format().threads( 4 ).surfacePool( pool ) );
+		REQUIRE( loader->getNumThreads() == 4 );
+
+		std::vector<DataSourceRef> sources;
+		for( int32_t i = 0; i < 24; ++i )
+			sources.push_back( testImage( i, 10 + i, 5 ) );
+		auto futures = loader->load( sources, sTestRequest );
+
+		REQUIRE( futures.size() == 24 );
+		for( int32_t i = 0; i < 24; ++i ) {
+			Surface8u surface = futures[i].get();
+			REQUIRE( surface.getSize() == ivec2( 10 + i, 5 ) );
+			REQUIRE( surface.getPixel( ivec2( 9, 4 ) ) == ColorA8u( i, i, i, 255 ) );
+		}
+		REQUIRE( pool->getNumMisses() >= 1 );
+		REQUIRE( loader->getInFlightBytes() == 0 );
+	}
+
+	SECTION( "priorities order pending requests and groups cancel them" )
+	{
+		auto loader = ImageLoader::create( ImageLoader::Format().threads( 1 ) );
+		std::promise<void> gate;
+		sGate = gate.get_future().share();
+
+		auto blocking = loader->load( testImage( 0, 4, 4, true ), sTestRequest );
+		while( loader->getNumPending() > 0 )
+			std::this_thread::yield();
+
+		auto low = loader->load( testImage( 1, 4, 4 ), ImageLoader::Request( sTestRequest ).group( 1 ) );
+		auto high = loader->load( testImage( 2, 4, 4 ), ImageLoader::Request( sTestRequest ).priority( 5 ) );
+		auto canceledA = loader->load( testImage( 3, 4, 4 ), ImageLoader::Request( sTestRequest ).priority( 9 ).group( 2 ) );
+		auto canceledB = loader->load( testImage( 4, 4, 4 ), ImageLoader::Request( sTestRequest ).group( 2 ) );
+		auto lowAfter = loader->load( testImage( 5, 4, 4 ), ImageLoader::Request( sTestRequest ).group( 1 ) );
+		REQUIRE( loader->getNumPending() == 5 );
+		REQUIRE( loader->cancel( 2 ) == 2 );
+		REQUIRE( loader->getNumPending() == 3 );
+
+		gate.set_value();
+		loader->waitForIdle();
+		REQUIRE( sOrder == std::vector<int32_t>( { 0, 2, 1, 5 } ) );
+		REQUIRE_THROWS_AS( canceledA.get(), ImageLoaderCanceledExc );
+		REQUIRE_THROWS_AS( canceledB.get(), ImageLoaderCanceledExc );
+		REQUIRE( high.get().getPixel( ivec2( 0, 0 ) ) == ColorA8u( 2, 2, 2, 255 ) );
+		REQUIRE( blocking.valid() );
+		blocking.get();
+		low.get();
+		lowAfter.get();
+	}
+
+	SECTION( "decoding failures are rethrown by the future" )
+	{
+		auto loader = ImageLoader::create( ImageLoader::Format().threads( 2 ) );
+		auto failed = loader->load( testImage( 0, 4, 4, false, true ), sTestRequest );
+		auto good = loader->load( testImage( 2, 4, 4 ), sTestRequest );
+		REQUIRE_THROWS_AS( failed.get(), ImageIoException );
+		REQUIRE( good.get().getWidth() == 4 );
+	}
+
+	SECTION( "in-flight bytes are capped" )
+	{
+		// each image is 64 * 64 * 3 bytes, so only one fits at a time
+		auto loader = ImageLoader::create( ImageLoader::Format().threads( 4 ).maxInFlightBytes( 64 * 64 * 3 + 100 ) );
+		sNumDecoding = sMaxDecoding = 0;
+		std::vector<DataSourceRef> sources;
+		for( int32_t i = 0; i < 12; ++i )
+			sources.push_back( testImage( i, 64, 64 ) );
+		for( auto &future : loader->load( sources, sTestRequest ) )
+			future.get();
+		REQUIRE( sMaxDecoding == 1 );
+
+		// an image larger than the budget still decodes, alone
+		REQUIRE( loader->load( testImage( 99, 128, 128 ), sTestRequest ).get().getSize() == ivec2( 128, 128 ) );
+	}
+
+	SECTION( "stb_image formats are probed before opening" )
+	{
+		ImageSourceFileStbImage::registerSelf();
+		int32_t width, height, numComponents;
+		bool isFloat;
+		REQUIRE( ImageSourceFileStbImage::probe( tgaImage( 40, 30 ), &width, &height, &numComponents, &isFloat ) );
+		REQUIRE( ( width == 40 && height == 30 && numComponents == 3 && ! isFloat ) );
+		REQUIRE_FALSE( ImageSourceFileStbImage::probe( testImage( 0, 4, 4 ), &width, &height, &numComponents, &isFloat ) );
+
+		// the budget fits only one image, counting the decoder's pixels as well as the Surface's
+		auto loader = ImageLoader::create( ImageLoader::Format().threads( 2 ).maxInFlightBytes( 40 * 30 * 6 ) );
+		std::vector<DataSourceRef> sources( 6, tgaImage( 40, 30 ) );
+		for( auto &future : loader->load( sources, ImageLoader::Request().extension( "tga" ) ) ) {
+			Surface8u surface = future.get();
+			REQUIRE( surface.getSize() == ivec2( 40, 30 ) );
+			REQUIRE( surface.getPixel( ivec2( 7, 5 ) ) == ColorA8u( 7, 5, 12, 255 ) );
+		}
+		REQUIRE( loader->getInFlightBytes() == 0 );
+	}
+
+	SECTION( "destruction cancels pending requests" )
+	{
+		std::promise<void> gate;
+		sGate = gate.get_future().share();
+		std::future<Surface8u> blocking, pending;
+		{
+			auto loader = ImageLoader::create( ImageLoader::Format().threads( 1 ) );
+			blocking = loader->load( testImage( 0, 4, 4, true ), sTestRequest );
+			while( loader->getNumPending() > 0 )
+				std::this_thread::yield();
+			pending = loader->load( testImage( 1, 4, 4 ), sTestRequest );
+			std::thread release( [&gate] { std::this_thread::sleep_for( std::chrono::milliseconds( 20 ) ); gate.set_value(); } );
+			loader.reset();
+			release.join();
+		}
+		REQUIRE_THROWS_AS( pending.get(), ImageLoaderCanceledExc );
+		REQUIRE( blocking.get().getWidth() == 4 );
+	}
+}
@@ -0,0 +1,114 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ImageSourcePng.h"
+#include "cinder/ImageTargetPng.h"
+#include "cinder/DataTarget.h"
+#include "cinder/Stream.h"
+
+using namespace ci;
+
+namespace {
+
+template<typename T>
+bool surfacesEqual( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() || a.hasAlpha() != b.hasAlpha() )
+		return false;
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( a.getPixel( ivec2( x, y ) ) != b.getPixel( ivec2( x, y ) ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+template<typename T>
+BufferRef encodePng( const SurfaceT<T> &surface )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = (ImageSourceRef)surface;
+	writeImage( ImageTargetPng::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options(), "png" ), source );
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return buffer;
+}
+
+template<typename T>
+SurfaceT<T> decodePng( const BufferRef &buffer, int32_t bandRows )
+{
+	ImageSourcePngRef source = ImageSourcePng::createRef( DataSourceBuffer::create( buffer ) );
+	source->setBandRows( bandRows );
+	return SurfaceT<T>( (ImageSourceRef)source );
+}
+
+// a 19x13 RGBA image with Adam7 interlacing, whose pixels are ( x * 13, y * 19, ( x ^ y ) * 7, 255 - x - y )
+const uint8_t sInterlacedPng[] = {
+	0x89, 0x50, 0x4e, 0x47, 0x0d, 0x0a, 0x1a, 0x0a, 0x00, 0x00, 0x00, 0x0d, 0x49, 0x48, 0x44, 0x52,
+	0x00, 0x00, 0x00, 0x13, 0x00, 0x00, 0x00, 0x0d, 0x08, 0x06, 0x00, 0x00, 0x01, 0x3c, 0x8b, 0x65,
+	0xb1, 0x00, 0x00, 0x00, 0xf1, 0x49, 0x44, 0x41, 0x54, 0x28, 0xcf, 0xa5, 0x8e, 0xb1, 0x6d, 0xc3,
+	0x30, 0x10, 0x45, 0x1f, 0x01, 0x01, 0xae, 0xc4, 0x26, 0x70, 0x23, 0xb0, 0x33, 0xe0, 0xc2, 0xb5,
+	0x0a, 0x4e, 0xe0, 0xca, 0x65, 0x86, 0x70, 0x99, 0x41, 0x32, 0x40, 0x2a, 0x4f, 0xe0, 0x41, 0x3c,
+	0x81, 0x27, 0xd0, 0x04, 0xaa, 0x68, 0x98, 0xbe, 0x4b, 0x21, 0x3a, 0x21, 0x1d, 0x49, 0x09, 0x9c,
+	0xe2, 0xf0, 0xf4, 0xef, 0x1f, 0xbf, 0xbe, 0x01, 0x74, 0x8f, 0x0f, 0x7b, 0x7c, 0xa8, 0xf8, 0xf0,
+	0x01, 0x4e, 0x01, 0xde, 0x82, 0x69, 0x71, 0xd7, 0x62, 0x6b, 0xd8, 0xb9, 0x6b, 0x4b, 0x17, 0x5b,
+	0x5e, 0xe3, 0x9d, 0xc9, 0xed, 0x22, 0x9c, 0xe2, 0xc0, 0xf7, 0x68, 0x1a, 0xec, 0xad, 0xc5, 0xc5,
+	0x7c, 0x2a, 0x76, 0x2e, 0x5d, 0xf8, 0x2f, 0xa6, 0xa5, 0x8f, 0x70, 0x8c, 0xe0, 0x22, 0xe5, 0xe5,
+	0x37, 0x0d, 0x6b, 0x7b, 0x6b, 0xe8, 0xa5, 0x61, 0x23, 0x73, 0x4c, 0xaf, 0x7b, 0x81, 0x4e, 0x06,
+	0x6e, 0x65, 0x4c, 0x67, 0x87, 0x9b, 0x64, 0x1c, 0xa5, 0xd4, 0x4e, 0xa0, 0x17, 0x53, 0xb3, 0x90,
+	0x06, 0x3b, 0x3b, 0x15, 0x6b, 0x5b, 0xbc, 0x1a, 0x63, 0x3a, 0x72, 0x02, 0x67, 0x01, 0x9b, 0xa6,
+	0xd4, 0x59, 0xd2, 0x34, 0xb3, 0xa4, 0x7b, 0xca, 0x21, 0xfb, 0xfe, 0x91, 0xe4, 0x1e, 0x12, 0xdc,
+	0x58, 0xd2, 0x74, 0x27, 0xc3, 0xcb, 0x42, 0x6a, 0x2e, 0x5a, 0xb3, 0xd4, 0xff, 0x32, 0xfd, 0xf1,
+	0xa2, 0xd0, 0xeb, 0xc0, 0x95, 0x3e, 0xab, 0xb3, 0xb0, 0x65, 0x5a, 0x9e, 0xb5, 0xd4, 0x56, 0xff,
+	0xea, 0x8f, 0x34, 0xb3, 0xfa, 0xac, 0x1e, 0x69, 0xf6, 0xc8, 0x83, 0xce, 0xfb, 0xb3, 0xcd, 0x56,
+	0xbf, 0x34, 0x99, 0xf6, 0x3f, 0x01, 0x08, 0x77, 0x7d, 0x2b, 0xc6, 0x9a, 0x1c, 0xbf, 0x00, 0x00,
+	0x00, 0x00, 0x49, 0x45, 0x4e, 0x44, 0xae, 0x42, 0x60, 0x82,
+};
+
+} // anonymous namespace
+
+TEST_CASE( "ImagePng" )
+{
+	SECTION( "images taller than a band round trip through the pipelined decoder" )
+	{
+		Surface8u surface = randomSurface<uint8_t>( 37, 100, SurfaceChannelOrder::RGBA, 3 );
+		BufferRef png = encodePng( surface );
+		REQUIRE( surfacesEqual( decodePng<uint8_t>( png, 8 ), surface ) );
+		REQUIRE( surfacesEqual( decodePng<uint8_t>( png, 33 ), surface ) );
+	}
+
+	SECTION( "images within one band round trip" )
+	{
+		Surface8u surface = randomSurface<uint8_t>( 41, 20, SurfaceChannelOrder::RGB, 4 );
+		REQUIRE( surfacesEqual( decodePng<uint8_t>( encodePng( surface ), 32 ), surface ) );
+	}
+
+	SECTION( "16-bit images round trip" )
+	{
+		Surface16u surface = randomSurface<uint16_t>( 29, 70, SurfaceChannelOrder::RGB, 5 );
+		REQUIRE( surfacesEqual( decodePng<uint16_t>( encodePng( surface ), 16 ), surface ) );
+	}
+
+	SECTION( "interlaced images are decoded whole" )
+	{
+		BufferRef png = Buffer::create( sizeof( sInterlacedPng ) );
+		memcpy( png->getData(), sInterlacedPng, sizeof( sInterlacedPng ) );
+		Surface8u expected( 19, 13, true, SurfaceChannelOrder::RGBA );
+		for( int32_t y = 0; y < 13; ++y ) {
+			for( int32_t x = 0; x < 19; ++x )
+				expected.setPixel( ivec2( x, y ), ColorA8u( x * 13, y * 19, ( x ^ y ) * 7, 255 - x - y ) );
+		}
+
+		// a band smaller than the image would take the pipelined path if it weren't interlaced
+		REQUIRE( surfacesEqual( decodePng<uint8_t>( png, 4 ), expected ) );
+		REQUIRE( surfacesEqual( decodePng<uint8_t>( png, 32 ), expected ) );
+	}
+
+	SECTION( "truncated data fails in the decoder thread" )
+	{
+		BufferRef png = encodePng( randomSurface<uint8_t>( 37, 100, SurfaceChannelOrder::RGBA, 6 ) );
+		png->setSize( png->getSize() / 2 );
+		REQUIRE_THROWS_AS( decodePng<uint8_t>( png, 8 ), ImageIoException );
+	}
+}
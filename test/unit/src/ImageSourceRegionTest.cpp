@@ -0,0 +1,201 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ImageIo.h"
+#include "cinder/ImageSourceFileQoi.h"
+#include "cinder/ImageTargetFileQoi.h"
+#include "cinder/ImageSourceFileRadiance.h"
+#include "cinder/DataTarget.h"
+#include "cinder/Stream.h"
+#include "cinder/Rand.h"
+
+#include <cmath>
+
+using namespace ci;
+
+namespace {
+
+// the expected result of Options().area( area ).downscale( factor ), with rounded averages over the clipped blocks
+Surface8u referenceRegion( const Surface8u &full, Area area, int32_t factor )
+{
+	area.clipBy( full.getBounds() );
+	Surface8u result( ( area.getWidth() + factor - 1 ) / factor, ( area.getHeight() + factor - 1 ) / factor, full.hasAlpha(), full.getChannelOrder() );
+	for( int32_t y = 0; y < result.getHeight(); ++y ) {
+		for( int32_t x = 0; x < result.getWidth(); ++x ) {
+			Area block = Area( area.x1 + x * factor, area.y1 + y * factor, area.x1 + ( x + 1 ) * factor, area.y1 + ( y + 1 ) * factor ).getClipBy( area );
+			uint32_t sums[4] = { 0, 0, 0, 0 };
+			for( int32_t by = block.y1; by < block.y2; ++by ) {
+				for( int32_t bx = block.x1; bx < block.x2; ++bx ) {
+					ColorA8u c = full.getPixel( ivec2( bx, by ) );
+					sums[0] += c.r; sums[1] += c.g; sums[2] += c.b; sums[3] += c.a;
+				}
+			}
+			const uint32_t n = (uint32_t)block.calcArea();
+			result.setPixel( ivec2( x, y ), ColorA8u( ( sums[0] + n / 2 ) / n, ( sums[1] + n / 2 ) / n, ( sums[2] + n / 2 ) / n, ( sums[3] + n / 2 ) / n ) );
+		}
+	}
+	return result;
+}
+
+bool surfacesEqual( const Surface8u &a, const Surface8u &b )
+{
+	if( a.getSize() != b.getSize() )
+		return false;
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( a.getPixel( ivec2( x, y ) ) != b.getPixel( ivec2( x, y ) ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+DataSourceRef encodeQoi( const Surface8u &surface )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	ImageSourceRef source = (ImageSourceRef)surface;
+	writeImage( ImageTargetFileQoi::create( DataTargetStream::createRef( stream ), source, ImageTarget::Options(), "qoi" ), source );
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+// an uncompressed Radiance file, whose pixels are exact multiples of 1/256
+DataSourceRef encodeRadiance( int32_t width, int32_t height, std::vector<float> *pixels )
+{
+	std::string header = "#?RADIANCE\nFORMAT=32-bit_rle_rgbe\n\n-Y " + std::to_string( height ) + " +X " + std::to_string( width ) + "\n";
+	std::vector<uint8_t> bytes( header.begin(), header.end() );
+	Rand rnd( 5 );
+	for( int32_t i = 0; i < width * height; ++i ) {
+		uint8_t rgb[3] = { (uint8_t)( 2 + rnd.nextInt( 250 ) ), (uint8_t)( 2 + rnd.nextInt( 250 ) ), (uint8_t)( 2 + rnd.nextInt( 250 ) ) };
+		for( uint8_t v : rgb ) {
+			bytes.push_back( v );
+			pixels->push_back( v / 256.0f );
+		}
+		bytes.push_back( 128 ); // exponent 0
+	}
+	BufferRef buffer = Buffer::create( bytes.size() );
+	memcpy( buffer->getData(), bytes.data(), bytes.size() );
+	return DataSourceBuffer::create( buffer );
+}
+
+// a decoder which knows nothing about regions, so loadImage() has to reduce its rows
+class RegionTestSource : public ImageSource {
+  public:
+	static ImageSourceRef create( DataSourceRef, ImageSource::Options ) { return std::make_shared<RegionTestSource>(); }
+
+	RegionTestSource()
+		: mSurface( randomSurface<uint8_t>( 37, 29, SurfaceChannelOrder::RGBA, 11 ) )
+	{
+		setSize( mSurface.getWidth(), mSurface.getHeight() );
+		setColorModel( ImageIo::CM_RGB );
+		setDataType( ImageIo::UINT8 );
+		setChannelOrder( ImageIo::RGBA );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		RowFunc func = setupRowFunc( target );
+		for( int32_t row = 0; row < mHeight; ++row )
+			((*this).*func)( target, row, mSurface.getData( ivec2( 0, row ) ) );
+	}
+
+	Surface8u	mSurface;
+};
+
+// a white 16 bit decoder, large enough that a block of it sums past 32 bits
+class WhiteSource16 : public ImageSource {
+  public:
+	static ImageSourceRef create( DataSourceRef, ImageSource::Options ) { return std::make_shared<WhiteSource16>(); }
+
+	WhiteSource16()
+	{
+		setSize( 300, 300 );
+		setColorModel( ImageIo::CM_RGB );
+		setDataType( ImageIo::UINT16 );
+		setChannelOrder( ImageIo::RGB );
+	}
+
+	void load( ImageTargetRef target ) override
+	{
+		RowFunc func = setupRowFunc( target );
+		const std::vector<uint16_t> row( (size_t)mWidth * 3, 65535 );
+		for( int32_t y = 0; y < mHeight; ++y )
+			((*this).*func)( target, y, row.data() );
+	}
+};
+
+} // anonymous namespace
+
+TEST_CASE( "ImageSource/region" )
+{
+	SECTION( "QOI decodes areas and downscales natively" )
+	{
+		Surface8u full = randomSurface<uint8_t>( 53, 41, SurfaceChannelOrder::RGBA, 1 );
+		DataSourceRef data = encodeQoi( full );
+
+		ImageSourceRef whole = ImageSourceFileQoi::create( data, ImageSource::Options() );
+		REQUIRE( surfacesEqual( Surface8u( whole ), full ) );
+
+		const Area areas[] = { Area( 0, 0, 53, 41 ), Area( 5, 7, 30, 20 ), Area( 40, 30, 100, 100 ), Area( 52, 40, 53, 41 ) };
+		for( const Area &area : areas ) {
+			for( int32_t factor : { 1, 2, 4, 3 } ) {
+				ImageSourceRef source = ImageSourceFileQoi::create( data, ImageSource::Options().area( area ).downscale( factor ) );
+				REQUIRE( source->isRegionApplied() );
+				REQUIRE( surfacesEqual( Surface8u( source ), referenceRegion( full, area, factor ) ) );
+			}
+		}
+
+		REQUIRE_THROWS_AS( ImageSourceFileQoi::create( data, ImageSource::Options().area( Area( 60, 0, 70, 10 ) ) ), ImageIoExceptionFailedLoad );
+	}
+
+	SECTION( "Radiance stores only the reduced image" )
+	{
+		std::vector<float> pixels;
+		DataSourceRef data = encodeRadiance( 6, 5, &pixels );
+
+		ImageSourceRef source = ImageSourceFileRadiance::create( data, ImageSource::Options().area( Area( 1, 1, 6, 5 ) ).downscale( 2 ) );
+		REQUIRE( source->getWidth() == 3 );
+		REQUIRE( source->getHeight() == 2 );
+		Surface32f result( source );
+
+		// the top left block covers (1,1)-(3,3); the right column blocks are one pixel wide
+		auto pixel = [&]( int x, int y, int c ) { return pixels[( y * 6 + x ) * 3 + c]; };
+		for( int c = 0; c < 3; ++c ) {
+			REQUIRE( result.getPixel( ivec2( 0, 0 ) )[c] == Approx( ( pixel( 1, 1, c ) + pixel( 2, 1, c ) + pixel( 1, 2, c ) + pixel( 2, 2, c ) ) / 4 ) );
+			REQUIRE( result.getPixel( ivec2( 2, 1 ) )[c] == Approx( ( pixel( 5, 3, c ) + pixel( 5, 4, c ) ) / 2 ) );
+		}
+	}
+
+	SECTION( "other decoders are reduced by loadImage()" )
+	{
+		ImageIoRegistrar::registerSourceType( "regiontest", RegionTestSource::create );
+		Surface8u full = RegionTestSource().mSurface;
+		DataSourceRef data = DataSourceBuffer::create( Buffer::create( 1 ) );
+
+		ImageSourceRef unchanged = loadImage( data, ImageSource::Options(), "regiontest" );
+		REQUIRE_FALSE( unchanged->isRegionApplied() );
+		REQUIRE( unchanged->getWidth() == full.getWidth() );
+
+		for( int32_t factor : { 1, 2, 8 } ) {
+			ImageSourceRef source = loadImage( data, ImageSource::Options().area( Area( 3, 2, 35, 27 ) ).downscale( factor ), "regiontest" );
+			REQUIRE( source->isRegionApplied() );
+			REQUIRE( surfacesEqual( Surface8u( source ), referenceRegion( full, Area( 3, 2, 35, 27 ), factor ) ) );
+		}
+	}
+
+	SECTION( "large 16 bit blocks don't overflow" )
+	{
+		ImageIoRegistrar::registerSourceType( "regiontest16", WhiteSource16::create );
+		DataSourceRef data = DataSourceBuffer::create( Buffer::create( 1 ) );
+
+		for( int32_t factor : { 257, 300, 1000 } ) {
+			Surface16u result( loadImage( data, ImageSource::Options().downscale( factor ), "regiontest16" ) );
+			REQUIRE( result.getSize() == ivec2( ( 300 + factor - 1 ) / factor ) );
+			for( int32_t y = 0; y < result.getHeight(); ++y ) {
+				for( int32_t x = 0; x < result.getWidth(); ++x )
+					REQUIRE( result.getPixel( ivec2( x, y ) ) == ColorAT<uint16_t>( 65535, 65535, 65535 ) );
+			}
+		}
+	}
+}
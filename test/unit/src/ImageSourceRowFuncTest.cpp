@@ -0,0 +1,142 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ImageIo.h"
+#include "cinder/ChanTraits.h"
+#include "cinder/Timer.h"
+#include "cinder/Log.h"
+
+using namespace ci;
+
+namespace {
+
+// converts 'source' into rows of 'channelOrder', comparing each pixel to the per-sample conversion
+template<typename SD, typename TD>
+bool convertsExactly( const SurfaceT<SD> &source, ImageIo::ChannelOrder channelOrder )
+{
+	int8_t red, green, blue, alpha, inc;
+	ImageIo::translateRgbColorModelToOffsets( channelOrder, &red, &green, &blue, &alpha, &inc );
+	const int8_t srcAlpha = source.getChannelOrder().getAlphaOffset();
+
+	bool matches = true;
+	ImageIo::DataType dataType = std::is_same<TD, float>::value ? ImageIo::FLOAT32 : ImageIo::UINT8;
+	auto target = ImageTargetCallback::create( source.getWidth(), source.getHeight(), dataType, channelOrder, [&]( int32_t firstRow, int32_t numRows, const void *data, size_t rowBytes ) {
+		for( int32_t row = 0; row < numRows; ++row ) {
+			const TD *pixel = reinterpret_cast<const TD*>( reinterpret_cast<const uint8_t*>( data ) + row * rowBytes );
+			for( int32_t x = 0; x < source.getWidth(); ++x, pixel += inc ) {
+				const SD *s = source.getData( ivec2( x, firstRow + row ) );
+				matches = matches && pixel[red] == CHANTRAIT<TD>::convert( s[source.getRedOffset()] );
+				matches = matches && pixel[green] == CHANTRAIT<TD>::convert( s[source.getGreenOffset()] );
+				matches = matches && pixel[blue] == CHANTRAIT<TD>::convert( s[source.getBlueOffset()] );
+				if( alpha >= 0 )
+					matches = matches && pixel[alpha] == ( srcAlpha >= 0 ? CHANTRAIT<TD>::convert( s[srcAlpha] ) : CHANTRAIT<TD>::max() );
+			}
+		}
+	} );
+	writeImage( target, (ImageSourceRef)source );
+	return matches;
+}
+
+bool grayConvertsExactly( const Channel8u &source, ImageIo::ChannelOrder channelOrder )
+{
+	int8_t red, green, blue, alpha, inc;
+	ImageIo::translateRgbColorModelToOffsets( channelOrder, &red, &green, &blue, &alpha, &inc );
+
+	bool matches = true;
+	auto target = ImageTargetCallback::create( source.getWidth(), source.getHeight(), ImageIo::UINT8, channelOrder, [&]( int32_t firstRow, int32_t numRows, const void *data, size_t rowBytes ) {
+		for( int32_t row = 0; row < numRows; ++row ) {
+			const uint8_t *pixel = reinterpret_cast<const uint8_t*>( data ) + row * rowBytes;
+			for( int32_t x = 0; x < source.getWidth(); ++x, pixel += inc ) {
+				const uint8_t v = *source.getData( x, firstRow + row );
+				matches = matches && pixel[red] == v && pixel[green] == v && pixel[blue] == v && ( alpha < 0 || pixel[alpha] == 255 );
+			}
+		}
+	} );
+	writeImage( target, (ImageSourceRef)source );
+	return matches;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ImageSource/rowFunc" )
+{
+	const SurfaceChannelOrder sourceOrders[] = { SurfaceChannelOrder::RGB, SurfaceChannelOrder::BGR, SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::RGBX };
+	const ImageIo::ChannelOrder targetOrders[] = { ImageIo::RGBA, ImageIo::BGRA, ImageIo::ARGB, ImageIo::RGB, ImageIo::BGR, ImageIo::RGBX };
+	// widths on either side of the 4 and 8 pixel SIMD blocks, so that the scalar tails are exercised too
+	const int32_t widths[] = { 1, 3, 5, 8, 13, 37, 64 };
+
+	SECTION( "8-bit layouts" )
+	{
+		bool matches = true;
+		for( const auto &sourceOrder : sourceOrders )
+			for( int32_t width : widths )
+				for( ImageIo::ChannelOrder targetOrder : targetOrders )
+					matches = matches && convertsExactly<uint8_t, uint8_t>( randomSurface<uint8_t>( width, 3, sourceOrder, width ), targetOrder );
+		REQUIRE( matches );
+	}
+
+	SECTION( "16-bit to 8-bit" )
+	{
+		bool matches = true;
+		for( const auto &sourceOrder : sourceOrders )
+			for( int32_t width : widths )
+				for( ImageIo::ChannelOrder targetOrder : targetOrders )
+					matches = matches && convertsExactly<uint16_t, uint8_t>( randomSurface<uint16_t>( width, 3, sourceOrder, width ), targetOrder );
+		REQUIRE( matches );
+
+		// every 16-bit value
+		Surface16u ramp( 256, 256, false, SurfaceChannelOrder::RGB );
+		for( int32_t y = 0; y < 256; ++y )
+			for( int32_t x = 0; x < 256; ++x )
+				ramp.setPixel( ivec2( x, y ), ColorT<uint16_t>( (uint16_t)( y * 256 + x ), (uint16_t)( 65535 - y * 256 - x ), (uint16_t)x ) );
+		REQUIRE( convertsExactly<uint16_t, uint8_t>( ramp, ImageIo::RGBA ) );
+	}
+
+	SECTION( "8-bit to float" )
+	{
+		bool matches = true;
+		for( const auto &sourceOrder : sourceOrders )
+			for( int32_t width : widths )
+				for( ImageIo::ChannelOrder targetOrder : targetOrders )
+					matches = matches && convertsExactly<uint8_t, float>( randomSurface<uint8_t>( width, 3, sourceOrder, width ), targetOrder );
+		REQUIRE( matches );
+	}
+
+	SECTION( "gray to RGB" )
+	{
+		bool matches = true;
+		for( int32_t width : widths ) {
+			Channel8u channel( width, 3 );
+			fillRandom( &channel, width );
+			for( ImageIo::ChannelOrder targetOrder : targetOrders )
+				matches = matches && grayConvertsExactly( channel, targetOrder );
+		}
+		REQUIRE( matches );
+	}
+}
+
+TEST_CASE( "ImageSource/rowFunc/benchmark", "[.][benchmark]" )
+{
+	const int32_t width = 4096, height = 2048;
+	auto run = [&]( const char *name, const ImageSourceRef &source, ImageIo::DataType dataType, ImageIo::ChannelOrder channelOrder ) {
+		auto target = ImageTargetCallback::create( width, height, dataType, channelOrder, []( int32_t, int32_t, const void*, size_t ) {} );
+		Timer timer( true );
+		writeImage( target, source );
+		double ms = timer.getSeconds() * 1000.0;
+		CI_LOG_I( name << ": " << ms << " ms, " << ( width * height / 1.0e6 ) / ( ms / 1000.0 ) << " Mpixels/s" );
+	};
+
+	Surface8u rgb = randomSurface<uint8_t>( width, height, SurfaceChannelOrder::RGB, 1 );
+	Surface8u bgra = randomSurface<uint8_t>( width, height, SurfaceChannelOrder::BGRA, 2 );
+	Surface8u rgba = randomSurface<uint8_t>( width, height, SurfaceChannelOrder::RGBA, 3 );
+	Surface16u rgba16 = randomSurface<uint16_t>( width, height, SurfaceChannelOrder::RGBA, 4 );
+	Channel8u gray( width, height );
+
+	run( "RGB8 -> RGBA8", (ImageSourceRef)rgb, ImageIo::UINT8, ImageIo::RGBA );
+	run( "BGRA8 -> RGBA8", (ImageSourceRef)bgra, ImageIo::UINT8, ImageIo::RGBA );
+	run( "RGBA8 -> RGBA32F", (ImageSourceRef)rgba, ImageIo::FLOAT32, ImageIo::RGBA );
+	run( "RGBA16 -> RGBA8", (ImageSourceRef)rgba16, ImageIo::UINT8, ImageIo::RGBA );
+	run( "Y8 -> RGBA8", (ImageSourceRef)gray, ImageIo::UINT8, ImageIo::RGBA );
+	// a layout without a SIMD path, for comparison
+	run( "RGBA16 -> RGBA16", (ImageSourceRef)rgba16, ImageIo::UINT16, ImageIo::RGBA );
+}
@@ -0,0 +1,45 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ImageIo.h"
+
+using namespace ci;
+
+TEST_CASE( "ImageTargetCallback" )
+{
+	Surface8u source = randomSurface<uint8_t>( 23, 70, SurfaceChannelOrder::BGRA, 17 );
+
+	SECTION( "rows arrive in bands, converted to the target format" )
+	{
+		std::vector<std::pair<int32_t, int32_t>> bands;
+		bool matches = true;
+		auto target = ImageTargetCallback::create( 23, 70, ImageIo::UINT8, ImageIo::RGB, [&]( int32_t firstRow, int32_t numRows, const void *data, size_t rowBytes ) {
+			bands.emplace_back( firstRow, numRows );
+			REQUIRE( rowBytes == 23 * 3 );
+			for( int32_t row = 0; row < numRows; ++row ) {
+				const uint8_t *rgb = reinterpret_cast<const uint8_t*>( data ) + row * rowBytes;
+				for( int32_t x = 0; x < 23; ++x, rgb += 3 ) {
+					ColorA8u expected = source.getPixel( ivec2( x, firstRow + row ) );
+					matches = matches && ( rgb[0] == expected.r ) && ( rgb[1] == expected.g ) && ( rgb[2] == expected.b );
+				}
+			}
+		}, 32 );
+
+		writeImage( target, (ImageSourceRef)source );
+		REQUIRE( matches );
+		REQUIRE( bands == std::vector<std::pair<int32_t, int32_t>>{ { 0, 32 }, { 32, 32 }, { 64, 6 } } );
+	}
+
+	SECTION( "format can mirror the source" )
+	{
+		ImageSourceRef imageSource = (ImageSourceRef)source;
+		int32_t rows = 0;
+		auto target = ImageTargetCallback::create( imageSource, [&]( int32_t, int32_t numRows, const void*, size_t rowBytes ) {
+			rows += numRows;
+			REQUIRE( rowBytes == 23 * 4 );
+		} );
+		REQUIRE( target->getChannelOrder() == imageSource->getChannelOrder() );
+		writeImage( target, imageSource );
+		REQUIRE( rows == 70 );
+	}
+}
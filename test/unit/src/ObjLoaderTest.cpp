@@ -2,6 +2,10 @@
 #include "catch.hpp"
 #include "cinder/ObjLoader.h"
 #include "cinder/TriMesh.h"
+#include "cinder/Utilities.h"
+
+#include <cstring>
+#include <locale>
 
 using namespace cinder;
 
@@ -95,3 +99,174 @@ SECTION( "ObjLoader successfully parses faces with line continuations." )
 }
 
 } // ObjLoader tests
+
+namespace {
+
+// a file large enough to be split into several chunks, using groups, materials, relative indices, CRLF endings and line continuations
+std::string makeLargeObj( int numQuads )
+{
+	std::string result = "# generated\r\nmtllib test.mtl\r\n";
+	for( int q = 0; q < numQuads; ++q ) {
+		if( q % 500 == 0 )
+			result += "g group" + std::to_string( q / 500 ) + "\n";
+		if( q % 700 == 0 )
+			result += std::string( "usemtl " ) + ( q % 1400 == 0 ? "red" : "blue" ) + "\n";
+		for( int v = 0; v < 4; ++v ) {
+			const float x = (float)( q % 100 ) + ( v & 1 ), y = (float)( q / 100 ) + ( v >> 1 );
+			result += "v " + std::to_string( x ) + " " + std::to_string( y ) + ( v == 2 ? " \\\n 0.5\n" : " 0.5\r\n" );
+			result += "vt " + std::to_string( x / 100 ) + " " + std::to_string( y / 100 ) + "\n";
+		}
+		result += "vn 0 0 1\n";
+		// relative indices count back from the start of the group
+		if( q % 3 == 0 && q >= 500 )
+			result += "f -4/-4/-1 -3/-3/-1 -1/-1/-1 -2/-2/-1\n";
+		else {
+			const std::string n = std::to_string( q + 1 );
+			const int base = q * 4;
+			result += "f";
+			for( int v : { 1, 2, 4, 3 } )
+				result += " " + std::to_string( base + v ) + "/" + std::to_string( base + v ) + "/" + n;
+			result += "\n";
+		}
+	}
+	return result;
+}
+
+const std::string sMaterials = "newmtl red\nKd 1 0 0\nnewmtl blue\nKd 0 0 1\n";
+
+DataSourceRef toDataSource( const std::string &str )
+{
+	BufferRef buffer = Buffer::create( str.size() );
+	memcpy( buffer->getData(), str.data(), str.size() );
+	return DataSourceBuffer::create( buffer );
+}
+
+bool meshesEqual( const TriMesh &a, const TriMesh &b )
+{
+	return a.getNumVertices() == b.getNumVertices() && a.getIndices() == b.getIndices()
+		&& std::equal( a.getPositions<3>(), a.getPositions<3>() + a.getNumVertices(), b.getPositions<3>() )
+		&& a.getNormals() == b.getNormals() && a.getColors<3>() != nullptr && b.getColors<3>() != nullptr
+		&& std::equal( a.getColors<3>(), a.getColors<3>() + a.getNumVertices(), b.getColors<3>() )
+		&& std::equal( a.getTexCoords0<2>(), a.getTexCoords0<2>() + a.getNumVertices(), b.getTexCoords0<2>() );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ObjLoader/Options" )
+{
+	const std::string obj = makeLargeObj( 12000 );
+	REQUIRE( obj.size() > 4 * 256 * 1024 );
+
+	ObjLoader serial( toDataSource( obj ), toDataSource( sMaterials ) );
+	TriMesh expected( serial );
+	REQUIRE( expected.getNumTriangles() == 24000 );
+	REQUIRE( serial.getNumGroups() == 24 );
+
+	SECTION( "parsing in chunks matches the stream parser" )
+	{
+		for( int threads : { 1, 3, 4, 0 } ) {
+			ObjLoader parallel( toDataSource( obj ), toDataSource( sMaterials ), ObjLoader::Options().threads( threads ) );
+			REQUIRE( meshesEqual( expected, TriMesh( parallel ) ) );
+
+			REQUIRE( parallel.getNumGroups() == serial.getNumGroups() );
+			for( size_t g = 0; g < serial.getNumGroups(); ++g ) {
+				const ObjLoader::Group &a = serial.getGroups()[g], &b = parallel.getGroups()[g];
+				REQUIRE( a.mName == b.mName );
+				REQUIRE( a.mBaseVertexOffset == b.mBaseVertexOffset );
+				REQUIRE( a.mFaces.size() == b.mFaces.size() );
+				REQUIRE( a.mFaces.back().mVertexIndices == b.mFaces.back().mVertexIndices );
+				REQUIRE( a.mFaces.back().mMaterial->mName == b.mFaces.back().mMaterial->mName );
+			}
+
+			parallel.groupName( "group7" );
+			serial.groupName( "group7" );
+			REQUIRE( meshesEqual( TriMesh( serial ), TriMesh( parallel ) ) );
+			serial.groupIndex( 0 );
+		}
+	}
+
+	SECTION( "the cache is reused only for the same contents and options" )
+	{
+		const fs::path objPath = fs::temp_directory_path() / "cinder_ObjLoaderTest.obj";
+		const fs::path cachePath = fs::temp_directory_path() / "cinder_ObjLoaderTest.objcache";
+		writeString( objPath, obj );
+		fs::remove( cachePath );
+
+		const auto options = ObjLoader::Options().threads( 2 ).cacheFile( cachePath );
+		ObjLoader first( loadFile( objPath ), toDataSource( sMaterials ), options );
+		REQUIRE_FALSE( first.isLoadedFromCache() );
+		REQUIRE( fs::exists( cachePath ) );
+
+		ObjLoader second( loadFile( objPath ), toDataSource( sMaterials ), options );
+		REQUIRE( second.isLoadedFromCache() );
+		REQUIRE( meshesEqual( expected, TriMesh( second ) ) );
+
+		// groups are cached too, so selecting one gives the same mesh as from a parsed file
+		REQUIRE( second.getNumGroups() == serial.getNumGroups() );
+		REQUIRE( second.getGroups()[7].mName == serial.getGroups()[7].mName );
+		REQUIRE( second.getGroups()[7].mFaces.back().mMaterial->mName == serial.getGroups()[7].mFaces.back().mMaterial->mName );
+		second.groupName( "group7" );
+		serial.groupName( "group7" );
+		REQUIRE( meshesEqual( TriMesh( serial ), TriMesh( second ) ) );
+
+		ObjLoader unoptimized( loadFile( objPath ), toDataSource( sMaterials ), ObjLoader::Options( options ).optimize( false ) );
+		REQUIRE_FALSE( unoptimized.isLoadedFromCache() );
+		REQUIRE( TriMesh( unoptimized ).getNumVertices() == 48000 );
+
+		writeString( objPath, obj + "v 0 0 0\n" );
+		ObjLoader changed( loadFile( objPath ), toDataSource( sMaterials ), options );
+		REQUIRE_FALSE( changed.isLoadedFromCache() );
+		REQUIRE( meshesEqual( expected, TriMesh( changed ) ) );
+	}
+
+	SECTION( "a cache that can't be written doesn't fail the load" )
+	{
+		// the cache's parent is a file, so neither it nor the cache can be created
+		const fs::path parentPath = fs::temp_directory_path() / "cinder_ObjLoaderTest_notADirectory";
+		writeString( parentPath, "" );
+
+		ObjLoader loader( toDataSource( obj ), toDataSource( sMaterials ), ObjLoader::Options().cacheFile( parentPath / "cinder_ObjLoaderTest.objcache" ) );
+		REQUIRE_FALSE( loader.isLoadedFromCache() );
+		REQUIRE( meshesEqual( expected, TriMesh( loader ) ) );
+		REQUIRE( fs::is_regular_file( parentPath ) );
+	}
+}
+
+namespace {
+
+// a decimal comma and digit grouping, as in many European locales
+struct CommaNumpunct : std::numpunct<char> {
+	char			do_decimal_point() const override	{ return ','; }
+	char			do_thousands_sep() const override	{ return '.'; }
+	std::string		do_grouping() const override		{ return "\3"; }
+};
+
+// installs \a locale as the global locale for its lifetime, restoring the previous one even when a check throws
+class ScopedGlobalLocale {
+  public:
+	ScopedGlobalLocale( const std::locale &locale ) : mPrevious( std::locale::global( locale ) ) {}
+	~ScopedGlobalLocale() { std::locale::global( mPrevious ); }
+
+  private:
+	std::locale		mPrevious;
+};
+
+} // anonymous namespace
+
+TEST_CASE( "ObjLoader/locale" )
+{
+	ScopedGlobalLocale commaLocale( std::locale( std::locale::classic(), new CommaNumpunct ) );
+
+	// 41 x 41 vertices, so that indices exceed 1000, at fractional positions
+	const auto plane = geom::Plane().subdivisions( ivec2( 40 ) ).size( vec2( 2.5f ) );
+	const fs::path objPath = fs::temp_directory_path() / "cinder_ObjLoaderLocaleTest.obj";
+	writeObj( writeFile( objPath ), plane, true, false );
+	ObjLoader loader( loadFile( objPath ) );
+	TriMesh mesh( loader );
+
+	const TriMesh expected( plane );
+	REQUIRE( mesh.getNumTriangles() == expected.getNumTriangles() );
+	REQUIRE( mesh.getNumVertices() == 41 * 41 );
+	REQUIRE( mesh.calcBoundingBox().getMin() == expected.calcBoundingBox().getMin() );
+	REQUIRE( mesh.calcBoundingBox().getMax() == expected.calcBoundingBox().getMax() );
+}
@@ -0,0 +1,96 @@
+#include "catch.hpp"
+
+#include "cinder/Stream.h"
+#include "cinder/Utilities.h"
+
+#include <cstdio>
+#include <fstream>
+
+using namespace ci;
+
+namespace {
+
+// every combination of line ending, including lines longer than the smallest buffers below
+const std::string sText = "first\nsecond\r\nthird\rfourth line, which is longer than a buffer\r\n\nlast";
+const std::vector<std::string> sLines = { "first", "second", "third", "fourth line, which is longer than a buffer", "", "last" };
+
+std::vector<std::string> readLines( IStreamCinder *stream )
+{
+	std::vector<std::string> result;
+	std::string_view line;
+	while( stream->readLine( &line ) )
+		result.emplace_back( line );
+	return result;
+}
+
+fs::path writeTestFile( const std::string &contents )
+{
+	fs::path path = fs::temp_directory_path() / "cinder_StreamTest.txt";
+	std::ofstream( path.string(), std::ios::binary ) << contents;
+	return path;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "Stream/readLine" )
+{
+	SECTION( "memory streams return views into their data" )
+	{
+		IStreamMemRef stream = IStreamMem::create( sText.data(), sText.size() );
+		std::string_view line;
+		REQUIRE( stream->readLine( &line ) );
+		REQUIRE( line.data() == sText.data() );
+		stream->seekAbsolute( 0 );
+		REQUIRE( readLines( stream.get() ) == sLines );
+		REQUIRE( stream->isEof() );
+		REQUIRE_FALSE( stream->readLine( &line ) );
+	}
+
+	SECTION( "file streams read across buffer refills" )
+	{
+		const fs::path path = writeTestFile( sText );
+		// a CRLF split by a refill is consumed as one line ending whatever the buffer size
+		for( int32_t bufferSize : { 1, 2, 3, 7, 13, 2048 } ) {
+			IStreamFileRef stream = IStreamFile::create( fopen( path.string().c_str(), "rb" ), true, bufferSize );
+			REQUIRE( readLines( stream.get() ) == sLines );
+		}
+
+		// reads before and after a line continue from where the line ended
+		IStreamFileRef stream = IStreamFile::create( fopen( path.string().c_str(), "rb" ), true, 4 );
+		char ch;
+		stream->read( &ch );
+		REQUIRE( ch == 'f' );
+		REQUIRE( stream->readLine() == "irst" );
+		REQUIRE( stream->readLine() == "second" );
+		stream->read( &ch );
+		REQUIRE( ch == 't' );
+		REQUIRE( stream->tell() == 15 );
+	}
+
+	SECTION( "trailing line endings don't add a line" )
+	{
+		for( const std::string &text : { std::string( "a\r\n" ), std::string( "a\r" ), std::string( "a\n" ) } ) {
+			IStreamMemRef stream = IStreamMem::create( text.data(), text.size() );
+			REQUIRE( readLines( stream.get() ) == std::vector<std::string>{ "a" } );
+		}
+		IStreamMemRef empty = IStreamMem::create( sText.data(), 0 );
+		REQUIRE( readLines( empty.get() ).empty() );
+	}
+}
+
+TEST_CASE( "nextToken" )
+{
+	std::string_view str = "  v 1.5\t-2   3 ";
+	std::vector<std::string_view> tokens;
+	for( std::string_view token; ! ( token = nextToken( &str ) ).empty(); )
+		tokens.push_back( token );
+	REQUIRE( tokens == std::vector<std::string_view>{ "v", "1.5", "-2", "3" } );
+	REQUIRE( str.empty() );
+
+	std::string_view path = "a/b//c";
+	REQUIRE( nextToken( &path, "/" ) == "a" );
+	REQUIRE( path == "/b//c" );
+	REQUIRE( nextToken( &path, "/" ) == "b" );
+	REQUIRE( nextToken( &path, "/" ) == "c" );
+	REQUIRE( nextToken( &path, "/" ).empty() );
+}
@@ -0,0 +1,120 @@
+#include "catch.hpp"
+
+#include "cinder/SurfacePool.h"
+#include "cinder/ImageIo.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Resize.h"
+
+#include <thread>
+#include <vector>
+
+using namespace ci;
+
+TEST_CASE( "SurfacePool" )
+{
+	SECTION( "storage is recycled once the last reference drops" )
+	{
+		auto pool = SurfacePool::create();
+		const uint8_t *pixels;
+		{
+			Surface8u surface = pool->acquire<uint8_t>( 33, 20, false );
+			REQUIRE( surface.getChannelOrder() == SurfaceChannelOrder::RGB );
+			REQUIRE( surface.getRowBytes() % 64 == 0 );
+			REQUIRE( surface.getRowBytes() >= 33 * 3 );
+			REQUIRE( reinterpret_cast<uintptr_t>( surface.getData() ) % 64 == 0 );
+			pixels = surface.getData();
+			REQUIRE( pool->getNumInUse() == 1 );
+
+			// a view keeps the storage in use after its Surface is gone
+			Surface8u view = surface.getView( Area( 0, 0, 8, 8 ) );
+			surface = Surface8u();
+			REQUIRE( pool->getNumIdle() == 0 );
+		}
+		REQUIRE( pool->getNumInUse() == 0 );
+		REQUIRE( pool->getNumIdle() == 1 );
+		REQUIRE( pool->getIdleBytes() > 0 );
+
+		auto surfaceRef = pool->acquireRef<uint8_t>( 33, 20, false );
+		REQUIRE( surfaceRef->getData() == pixels );
+		REQUIRE( pool->getNumHits() == 1 );
+		REQUIRE( pool->getNumMisses() == 1 );
+
+		// a different channel order, size or data type is a miss
+		Surface8u bgr = pool->acquire<uint8_t>( 33, 20, false, SurfaceChannelOrder::BGR );
+		Surface16u wide = pool->acquire<uint16_t>( 33, 20, false );
+		REQUIRE( pool->getNumMisses() == 3 );
+		REQUIRE( wide.getRowBytes() >= 33 * 3 * 2 );
+	}
+
+	SECTION( "caps evict the least recently returned storage" )
+	{
+		auto pool = SurfacePool::create( SurfacePool::Format().maxIdleSurfaces( 2 ) );
+		{
+			std::vector<Surface32f> surfaces;
+			for( int i = 0; i < 5; ++i )
+				surfaces.push_back( pool->acquire<float>( 16, 16, true ) );
+		}
+		REQUIRE( pool->getNumIdle() == 2 );
+		REQUIRE( pool->getNumEvictions() == 3 );
+
+		const size_t surfaceBytes = pool->getIdleBytes() / 2;
+		auto bytePool = SurfacePool::create( SurfacePool::Format().maxIdleBytes( surfaceBytes * 3 ) );
+		{
+			std::vector<Surface32f> surfaces;
+			for( int i = 0; i < 2; ++i )
+				surfaces.push_back( bytePool->acquire<float>( 16, 16, true ) );
+			for( int i = 0; i < 2; ++i )
+				surfaces.push_back( bytePool->acquire<float>( 16, 16, false ) );
+		}
+		REQUIRE( bytePool->getIdleBytes() <= surfaceBytes * 3 );
+		REQUIRE( bytePool->getNumEvictions() == 1 );
+
+		bytePool->clear();
+		REQUIRE( bytePool->getNumIdle() == 0 );
+		REQUIRE( bytePool->getIdleBytes() == 0 );
+	}
+
+	SECTION( "surfaces may outlive their pool" )
+	{
+		auto pool = SurfacePool::create();
+		Surface8u surface = pool->acquire<uint8_t>( 10, 10, true );
+		pool.reset();
+		ip::fill( &surface, ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE( surface.getPixel( ivec2( 9, 9 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+	}
+
+	SECTION( "concurrent acquisition and release" )
+	{
+		auto pool = SurfacePool::create( SurfacePool::Format().maxIdleSurfaces( 4 ) );
+		std::vector<std::thread> threads;
+		for( int t = 0; t < 4; ++t ) {
+			threads.emplace_back( [pool] {
+				for( int i = 0; i < 200; ++i ) {
+					Surface8u surface = pool->acquire<uint8_t>( 64, 64, true );
+					ip::fill( &surface, ColorA8u( 0, 0, 0, 0 ) );
+				}
+			} );
+		}
+		for( auto &thread : threads )
+			thread.join();
+		REQUIRE( pool->getNumInUse() == 0 );
+		REQUIRE( pool->getNumHits() + pool->getNumMisses() == 800 );
+		REQUIRE( pool->getNumMisses() <= 4 + pool->getNumEvictions() );
+	}
+
+	SECTION( "ip copies and image loading draw from a pool" )
+	{
+		auto pool = SurfacePool::create();
+		Surface8u source( 40, 30, true );
+		ip::fill( &source, ColorA8u( 10, 20, 30, 40 ) );
+
+		Surface8u resized = ip::resizeCopy( source, source.getBounds(), ivec2( 20, 15 ), FilterBox(), ip::Options().pool( pool ) );
+		REQUIRE( pool->getNumInUse() == 1 );
+		REQUIRE( resized.getPixel( ivec2( 10, 7 ) ) == ColorA8u( 10, 20, 30, 40 ) );
+
+		Surface8u loaded = pool->load<uint8_t>( (ImageSourceRef)source );
+		REQUIRE( pool->getNumInUse() == 2 );
+		REQUIRE( loaded.hasAlpha() );
+		REQUIRE( loaded.getPixel( ivec2( 39, 29 ) ) == ColorA8u( 10, 20, 30, 40 ) );
+	}
+}
@@ -0,0 +1,173 @@
+#include "catch.hpp"
+
+#include "cinder/Surface.h"
+#include "cinder/SurfacePool.h"
+#include "cinder/ip/Fill.h"
+
+#include <thread>
+
+using namespace ci;
+
+TEST_CASE( "Surface" )
+{
+	Surface8u surface( 64, 48, true, SurfaceChannelOrder::RGBA );
+	ip::fill( &surface, ColorA8u( 1, 2, 3, 4 ) );
+
+	SECTION( "views alias their parent" )
+	{
+		Surface8u view = surface.getView( Area( 10, 20, 30, 25 ) );
+		REQUIRE( view.getSize() == ivec2( 20, 5 ) );
+		REQUIRE( view.getRowBytes() == surface.getRowBytes() );
+		REQUIRE( view.getData() == surface.getData( ivec2( 10, 20 ) ) );
+		REQUIRE( view.getDataStore() == surface.getDataStore() );
+
+		ip::fill( &view, ColorA8u( 9, 8, 7, 6 ) );
+		REQUIRE( surface.getPixel( ivec2( 10, 20 ) ) == ColorA8u( 9, 8, 7, 6 ) );
+		REQUIRE( surface.getPixel( ivec2( 29, 24 ) ) == ColorA8u( 9, 8, 7, 6 ) );
+		REQUIRE( surface.getPixel( ivec2( 30, 24 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE( surface.getPixel( ivec2( 10, 25 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE( view.getChannelGreen().getValue( ivec2( 0, 0 ) ) == 8 );
+
+		// views are clipped, and keep the pixels alive after their parent is gone
+		Surface8u clipped = surface.getView( Area( 60, 40, 100, 100 ) );
+		REQUIRE( clipped.getSize() == ivec2( 4, 8 ) );
+		surface = Surface8u();
+		REQUIRE( clipped.getPixel( ivec2( 3, 7 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+	}
+
+	SECTION( "shared surfaces copy on write" )
+	{
+		const uint8_t *pixels = static_cast<const Surface8u&>( surface ).getData();
+		Surface8u encoder = surface.share();
+		const Surface8u analysis = surface.share();
+		REQUIRE( surface.isShared() );
+		REQUIRE( analysis.getData() == pixels );
+
+		// const reads do not detach
+		REQUIRE( analysis.getPixel( ivec2( 5, 5 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE( static_cast<const Surface8u&>( encoder ).getData() == pixels );
+
+		ip::fill( &encoder, ColorA8u( 50, 60, 70, 80 ) );
+		REQUIRE_FALSE( encoder.isShared() );
+		REQUIRE( encoder.getData() != pixels );
+		REQUIRE( encoder.getRowBytes() == static_cast<const Surface8u&>( surface ).getRowBytes() );
+		REQUIRE( encoder.getPixel( ivec2( 5, 5 ) ) == ColorA8u( 50, 60, 70, 80 ) );
+		REQUIRE( analysis.getPixel( ivec2( 5, 5 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+
+		// the last two sharers still share; once one of them writes, the other owns the original pixels outright
+		surface.setPixel( ivec2( 0, 0 ), ColorA8u( 0, 0, 0, 0 ) );
+		REQUIRE( analysis.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE( analysis.getData() == pixels );
+		REQUIRE_FALSE( analysis.isShared() );
+		REQUIRE( surface.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 0, 0, 0, 0 ) );
+	}
+
+	SECTION( "shared areas detach only their own pixels" )
+	{
+		Surface8u area = surface.share( Area( 8, 8, 24, 16 ) );
+		REQUIRE( area.getSize() == ivec2( 16, 8 ) );
+		REQUIRE( area.getDataStore() == surface.getDataStore() );
+
+		// const accessors do not detach
+		const Surface8u &constArea = area, &constSurface = surface;
+		REQUIRE( constArea.getData() == constSurface.getData( ivec2( 8, 8 ) ) );
+		REQUIRE( constArea.getRowBytes() == constSurface.getRowBytes() );
+		REQUIRE( area.isShared() );
+
+		// writing through an Iter detaches first, copying only the area, into packed rows
+		auto iter = area.getIter();
+		while( iter.line() ) {
+			while( iter.pixel() )
+				iter.r() = 200;
+		}
+		REQUIRE( area.getDataStore() != surface.getDataStore() );
+		REQUIRE( area.getRowBytes() == 16 * 4 );
+		REQUIRE( area.getPixel( ivec2( 15, 7 ) ) == ColorA8u( 200, 2, 3, 4 ) );
+		REQUIRE( area.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 200, 2, 3, 4 ) );
+		REQUIRE( surface.getPixel( ivec2( 8, 8 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE_FALSE( surface.isShared() );
+	}
+
+	SECTION( "moves keep wrapped and shared pixels" )
+	{
+		uint8_t external[4 * 4 * 3] = {};
+		Surface8u wrapped( external, 4, 4, 4 * 3, SurfaceChannelOrder::RGB );
+		Surface8u moved( std::move( wrapped ) );
+		REQUIRE( moved.getData() == external );
+
+		const Surface8u shared = surface.share();
+		Surface8u movedShared( surface.share() );
+		REQUIRE( movedShared.isShared() );
+		REQUIRE( static_cast<const Surface8u&>( movedShared ).getData() == shared.getData() );
+	}
+
+	SECTION( "sharers may be released on other threads" )
+	{
+		Surface8u shared = surface.share();
+		ColorA8u read;
+		std::thread reader( [&read, copy = surface.share()] { read = copy.getPixel( ivec2( 3, 3 ) ); } );
+		reader.join();
+		REQUIRE( read == ColorA8u( 1, 2, 3, 4 ) );
+
+		// the reader's share is gone, so writing through shared detaches from surface alone
+		REQUIRE( shared.isShared() );
+		shared.setPixel( ivec2( 3, 3 ), ColorA8u( 5, 5, 5, 5 ) );
+		REQUIRE( surface.getPixel( ivec2( 3, 3 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE_FALSE( surface.isShared() );
+	}
+
+	SECTION( "views taken before a share make the share a copy" )
+	{
+		Surface8u view = surface.getView( Area( 0, 0, 16, 16 ) );
+		const Surface8u shared = surface.share();
+		REQUIRE_FALSE( surface.isShared() );
+		REQUIRE( shared.getDataStore() != surface.getDataStore() );
+
+		ip::fill( &view, ColorA8u( 9, 9, 9, 9 ) );
+		REQUIRE( surface.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 9, 9, 9, 9 ) );
+		REQUIRE( shared.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+	}
+
+	SECTION( "writes through non-const accessors detach" )
+	{
+		Surface8u channelWriter = surface.share();
+		channelWriter.getChannelRed().setValue( ivec2( 1, 1 ), 100 );
+		REQUIRE_FALSE( channelWriter.isShared() );
+		REQUIRE( channelWriter.getPixel( ivec2( 1, 1 ) ) == ColorA8u( 100, 2, 3, 4 ) );
+		REQUIRE( channelWriter.getPixel( ivec2( 2, 1 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+
+		Surface8u dataWriter = surface.share();
+		dataWriter.getData( ivec2( 1, 1 ) )[0] = 101;
+		REQUIRE( dataWriter.getPixel( ivec2( 1, 1 ) ) == ColorA8u( 101, 2, 3, 4 ) );
+		REQUIRE( surface.getPixel( ivec2( 1, 1 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE_FALSE( surface.isShared() );
+	}
+
+	SECTION( "detaching packs the rows of a narrow area" )
+	{
+		Surface8u wide( 4096, 8, true );
+		ip::fill( &wide, ColorA8u( 1, 2, 3, 4 ) );
+		Surface8u narrow = wide.share( Area( 100, 2, 103, 6 ) );
+		narrow.setPixel( ivec2( 0, 0 ), ColorA8u( 5, 6, 7, 8 ) );
+		REQUIRE( narrow.getRowBytes() < wide.getRowBytes() );
+		REQUIRE( narrow.getRowBytes() >= 3 * 4 );
+		REQUIRE( narrow.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 5, 6, 7, 8 ) );
+		REQUIRE( narrow.getPixel( ivec2( 2, 3 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+		REQUIRE( wide.getPixel( ivec2( 100, 2 ) ) == ColorA8u( 1, 2, 3, 4 ) );
+	}
+
+	SECTION( "detaching keeps the alignment" )
+	{
+		auto pool = SurfacePool::create();
+		Surface8u pooled = pool->acquire<uint8_t>( 33, 20, false );
+		ip::fill( &pooled, Color8u( 7, 8, 9 ) );
+		const Surface8u shared = pooled.share();
+
+		ip::fill( &pooled, Color8u( 1, 1, 1 ), Area( 0, 0, 1, 1 ) );
+		REQUIRE( pooled.getDataStore() != shared.getDataStore() );
+		REQUIRE( pooled.getRowBytes() == shared.getRowBytes() );
+		REQUIRE( reinterpret_cast<uintptr_t>( pooled.getData() ) % 64 == 0 );
+		REQUIRE( pooled.getPixel( ivec2( 32, 19 ) ) == ColorA8u( 7, 8, 9, 255 ) );
+		REQUIRE( shared.getPixel( ivec2( 0, 0 ) ) == ColorA8u( 7, 8, 9, 255 ) );
+	}
+}
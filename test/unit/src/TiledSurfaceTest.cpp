@@ -0,0 +1,108 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/TiledSurface.h"
+#include "cinder/ImageIo.h"
+#include "cinder/ip/Fill.h"
+
+using namespace ci;
+
+namespace {
+
+bool surfacesEqual( const Surface8u &a, const Area &areaA, const Surface8u &b, const ivec2 &offsetB )
+{
+	for( int32_t y = areaA.y1; y < areaA.y2; ++y ) {
+		for( int32_t x = areaA.x1; x < areaA.x2; ++x ) {
+			if( a.getPixel( ivec2( x, y ) ) != b.getPixel( ivec2( x, y ) + offsetB ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TiledSurface" )
+{
+	// 32x32 RGBA tiles are 4KB, so this budget holds 6 of the 30 tiles
+	const auto format = TiledSurface8u::Format().tileSize( 32 ).memoryBudget( 6 * 4096 );
+
+	SECTION( "written pixels survive paging" )
+	{
+		Surface8u source = randomSurface<uint8_t>( 170, 150, SurfaceChannelOrder::RGBA, 1 );
+		TiledSurface8u tiled( 170, 150, true, format );
+		REQUIRE( tiled.getNumTiles() == ivec2( 6, 5 ) );
+		REQUIRE( tiled.getTileBounds( ivec2( 5, 4 ) ) == Area( 160, 128, 170, 150 ) );
+
+		tiled.writeArea( source );
+		REQUIRE( tiled.getNumPageOuts() > 0 );
+		REQUIRE( tiled.getResidentBytes() <= 6 * 4096 );
+
+		Surface8u whole = tiled.readArea( tiled.getBounds() );
+		REQUIRE( surfacesEqual( source, source.getBounds(), whole, ivec2() ) );
+		REQUIRE( tiled.getNumPageIns() > 0 );
+		REQUIRE( tiled.getResidentBytes() <= 6 * 4096 );
+
+		// an unaligned crop straddling tiles, into a surface of another channel order
+		Surface8u crop( 100, 100, true, SurfaceChannelOrder::BGRA );
+		tiled.readArea( Area( 17, 45, 117, 145 ), &crop );
+		REQUIRE( surfacesEqual( source, Area( 17, 45, 117, 145 ), crop, ivec2( -17, -45 ) ) );
+	}
+
+	SECTION( "unwritten tiles read as zero without memory" )
+	{
+		TiledSurface8u tiled( 4000, 4000, true, format );
+		Surface8u crop = tiled.readArea( Area( 1000, 1000, 1100, 1100 ) );
+		REQUIRE( crop.getPixel( ivec2( 50, 50 ) ) == ColorA8u( 0, 0, 0, 0 ) );
+		REQUIRE( tiled.getNumResidentTiles() == 0 );
+
+		Surface8u patch = randomSurface<uint8_t>( 10, 10, SurfaceChannelOrder::RGBA, 2 );
+		tiled.writeArea( patch, ivec2( 3990, 3990 ) );
+		REQUIRE( tiled.getNumResidentTiles() == 1 );
+		REQUIRE( surfacesEqual( patch, patch.getBounds(), tiled.readArea( Area( 3990, 3990, 4000, 4000 ) ), ivec2() ) );
+	}
+
+	SECTION( "tile views are written back" )
+	{
+		TiledSurface8u tiled( 100, 70, false, format );
+		int numTiles = 0;
+		tiled.forEachTile( Area( 10, 10, 90, 60 ), true, [&]( Surface8u &tileSurface, const Area &tileArea ) {
+			ip::fill( &tileSurface, Color8u( 10, 20, 30 ) );
+			REQUIRE( tileSurface.getSize() == tileArea.getSize() );
+			++numTiles;
+		} );
+		REQUIRE( numTiles == 3 * 2 );
+
+		Surface8u result = tiled.readArea( tiled.getBounds() );
+		REQUIRE( result.getPixel( ivec2( 10, 10 ) ) == ColorA8u( 10, 20, 30, 255 ) );
+		REQUIRE( result.getPixel( ivec2( 89, 59 ) ) == ColorA8u( 10, 20, 30, 255 ) );
+		REQUIRE( result.getPixel( ivec2( 9, 10 ) ) == ColorA8u( 0, 0, 0, 255 ) );
+		REQUIRE( result.getPixel( ivec2( 90, 60 ) ) == ColorA8u( 0, 0, 0, 255 ) );
+	}
+
+	SECTION( "image sources are streamed into tiles" )
+	{
+		Surface8u source = randomSurface<uint8_t>( 150, 130, SurfaceChannelOrder::RGBA, 3 );
+		TiledSurface8u tiled( (ImageSourceRef)source, format );
+		REQUIRE( tiled.hasAlpha() );
+		REQUIRE( tiled.getSize() == source.getSize() );
+		REQUIRE( tiled.getResidentBytes() <= 6 * 4096 );
+		REQUIRE( surfacesEqual( source, source.getBounds(), tiled.readArea( tiled.getBounds() ), ivec2() ) );
+	}
+
+	SECTION( "prefetched tiles are read without paging" )
+	{
+		Surface8u source = randomSurface<uint8_t>( 192, 160, SurfaceChannelOrder::RGBA, 4 );
+		TiledSurface8u tiled( 192, 160, true, format );
+		tiled.writeArea( source );
+		// touch the bottom rows so that the top left tiles are paged out
+		tiled.readArea( Area( 0, 96, 192, 160 ) );
+
+		const Area area( 0, 0, 64, 32 );
+		tiled.prefetch( area );
+		tiled.waitForPrefetch();
+		const size_t pageIns = tiled.getNumPageIns();
+		REQUIRE( surfacesEqual( source, area, tiled.readArea( area ), ivec2() ) );
+		REQUIRE( tiled.getNumPageIns() == pageIns );
+	}
+}
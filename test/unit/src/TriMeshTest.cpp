@@ -0,0 +1,118 @@
+#include "catch.hpp"
+
+#include "cinder/TriMesh.h"
+#include "cinder/Stream.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+TriMeshRef createMesh( int subdivisions )
+{
+	TriMeshRef result = TriMesh::create( geom::Sphere().radius( 3 ).subdivisions( subdivisions ), TriMesh::Format().positions().normals().texCoords().tangents() );
+	result->recalculateTangents();
+	return result;
+}
+
+// writes through \a write into memory, and returns the result as a DataSource
+template<typename WriteFn>
+DataSourceRef writeToMemory( const WriteFn &write )
+{
+	OStreamMemRef stream = OStreamMem::create();
+	write( DataTargetStream::createRef( stream ) );
+	BufferRef buffer = Buffer::create( (size_t)stream->tell() );
+	memcpy( buffer->getData(), stream->getBuffer(), buffer->getSize() );
+	return DataSourceBuffer::create( buffer );
+}
+
+float maxDifference( const float *a, const float *b, size_t count )
+{
+	float result = 0;
+	for( size_t i = 0; i < count; ++i )
+		result = std::max( result, std::abs( a[i] - b[i] ) );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "TriMesh/binary" )
+{
+	TriMeshRef mesh = createMesh( 40 );
+	const size_t numFloats = mesh->getNumVertices() * 3;
+
+	SECTION( "the chunked format round trips exactly without quantization" )
+	{
+		DataSourceRef data = writeToMemory( [&]( const DataTargetRef &target ) { mesh->write( target, TriMesh::WriteOptions() ); } );
+		TriMesh result;
+		result.read( data );
+		REQUIRE( result.getIndices() == mesh->getIndices() );
+		REQUIRE( result.getBufferPositions() == mesh->getBufferPositions() );
+		REQUIRE( result.getNormals() == mesh->getNormals() );
+		REQUIRE( result.getTangents() == mesh->getTangents() );
+		REQUIRE( result.getBufferTexCoords0() == mesh->getBufferTexCoords0() );
+		REQUIRE( result.getAttribDims( geom::COLOR ) == 0 );
+		REQUIRE( TriMesh::readNumLods( data ) == 1 );
+	}
+
+	SECTION( "quantization stays within its precision" )
+	{
+		DataSourceRef data = writeToMemory( [&]( const DataTargetRef &target ) { mesh->write( target, TriMesh::WriteOptions().compact() ); } );
+		DataSourceRef raw = writeToMemory( [&]( const DataTargetRef &target ) { mesh->write( target ); } );
+		REQUIRE( data->getBuffer()->getSize() * 2 < raw->getBuffer()->getSize() );
+
+		TriMesh result;
+		result.read( data );
+		REQUIRE( result.getIndices() == mesh->getIndices() );
+		REQUIRE( maxDifference( result.getBufferPositions().data(), mesh->getBufferPositions().data(), numFloats ) <= 6.0f / 65535 );
+		REQUIRE( maxDifference( &result.getNormals()[0].x, &mesh->getNormals()[0].x, numFloats ) < 1e-4f );
+		// tangents keep only their direction, and degenerate ones at the poles have none
+		bool tangentsMatch = true;
+		for( size_t v = 0; v < mesh->getNumVertices(); ++v ) {
+			const vec3 &expected = mesh->getTangents()[v];
+			if( length( expected ) > 0.1f )
+				tangentsMatch = tangentsMatch && distance( normalize( expected ), result.getTangents()[v] ) < 1e-4f;
+		}
+		REQUIRE( tangentsMatch );
+		REQUIRE( maxDifference( result.getBufferTexCoords0().data(), mesh->getBufferTexCoords0().data(), mesh->getNumVertices() * 2 ) <= 1.0f / 2048 );
+	}
+
+	SECTION( "attribute subsets and levels of detail" )
+	{
+		TriMeshRef coarse = createMesh( 6 );
+		DataSourceRef data = writeToMemory( [&]( const DataTargetRef &target ) {
+			TriMesh::write( target, { mesh, coarse }, TriMesh::WriteOptions().compressIndices().attribs( { geom::POSITION, geom::NORMAL } ) );
+		} );
+		REQUIRE( TriMesh::readNumLods( data ) == 2 );
+
+		TriMesh result;
+		result.read( data, TriMesh::ReadOptions().lod( 1 ).attribs( { geom::POSITION } ) );
+		REQUIRE( result.getIndices() == coarse->getIndices() );
+		REQUIRE( result.getBufferPositions() == coarse->getBufferPositions() );
+		REQUIRE( result.getAttribDims( geom::NORMAL ) == 0 );
+		REQUIRE( result.getNormals().empty() );
+		REQUIRE( result.getAttribDims( geom::TEX_COORD_0 ) == 0 );
+
+		result.read( data );
+		REQUIRE( result.getNumVertices() == mesh->getNumVertices() );
+		REQUIRE( result.getNormals() == mesh->getNormals() );
+
+		REQUIRE_THROWS_AS( result.read( data, TriMesh::ReadOptions().lod( 2 ) ), Exception );
+	}
+
+	SECTION( "older files and invalid contents" )
+	{
+		DataSourceRef v2 = writeToMemory( [&]( const DataTargetRef &target ) { mesh->write( target ); } );
+		TriMesh result;
+		result.read( v2 );
+		REQUIRE( result.getBufferPositions() == mesh->getBufferPositions() );
+		REQUIRE( TriMesh::readNumLods( v2 ) == 1 );
+		REQUIRE_THROWS_AS( result.read( v2, TriMesh::ReadOptions().lod( 1 ) ), Exception );
+
+		BufferRef truncated = Buffer::create( 100 );
+		DataSourceRef v3 = writeToMemory( [&]( const DataTargetRef &target ) { mesh->write( target, TriMesh::WriteOptions().compact() ); } );
+		memcpy( truncated->getData(), v3->getBuffer()->getData(), truncated->getSize() );
+		REQUIRE_THROWS_AS( result.read( DataSourceBuffer::create( truncated ) ), Exception );
+	}
+}
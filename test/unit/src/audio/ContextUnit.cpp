@@ -0,0 +1,626 @@
+#include "catch.hpp"
+
+#include "cinder/audio/Context.h"
+#include "cinder/audio/ChannelRouterNode.h"
+#include "cinder/audio/GenNode.h"
+#include "cinder/audio/OfflineContext.h"
+#include "cinder/audio/OutputNode.h"
+#include "cinder/audio/Param.h"
+#include "cinder/audio/dsp/Dsp.h"
+#include "cinder/Log.h"
+#include "cinder/Timer.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <set>
+#include <thread>
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+// A Context without devices, rendered by TestOutputNode on whichever thread calls render()
+class TestContext : public Context {
+  public:
+	OutputDeviceNodeRef	createOutputDeviceNode( const DeviceRef &device, const Node::Format &format ) override	{ return nullptr; }
+	InputDeviceNodeRef	createInputDeviceNode( const DeviceRef &device, const Node::Format &format ) override	{ return nullptr; }
+};
+
+class TestOutputNode : public OutputNode {
+  public:
+	TestOutputNode( size_t numChannels = 1 ) : OutputNode( Format().channels( numChannels ) )	{}
+
+	size_t getOutputSampleRate() override		{ return 44100; }
+	size_t getOutputFramesPerBlock() override	{ return 512; }
+
+	// Renders one block the way the device OutputNode's do, returns false if it was rendered as silence during a graph edit.
+	bool render()
+	{
+		auto ctx = getContext();
+		unique_lock<mutex> lock( ctx->getMutex(), try_to_lock );
+
+		audio::Buffer *internalBuffer = getInternalBuffer();
+		internalBuffer->zero();
+		if( ! lock.owns_lock() )
+			return false;
+
+		ctx->preProcess();
+		pullInputs( internalBuffer );
+		ctx->postProcess();
+		return true;
+	}
+
+	bool isConstant( float value ) const
+	{
+		const audio::Buffer *buffer = getInternalBuffer();
+		for( size_t i = 0; i < buffer->getSize(); i++ ) {
+			if( std::abs( buffer->getData()[i] - value ) > 1e-5f )
+				return false;
+		}
+		return true;
+	}
+
+  protected:
+	// like the device OutputNode's, so that there is always an internal buffer to render into
+	bool supportsProcessInPlace() const override	{ return false; }
+};
+
+class ConstantNode : public Node {
+  public:
+	ConstantNode( float value ) : Node( Format().channels( 1 ) ), mValue( this, value )	{}
+
+	Param* getParamValue()	{ return &mValue; }
+
+  protected:
+	void process( audio::Buffer *buffer ) override
+	{
+		if( mValue.eval() )
+			memcpy( buffer->getData(), mValue.getValueArray(), buffer->getNumFrames() * sizeof( float ) );
+		else
+			std::fill( buffer->getData(), buffer->getData() + buffer->getNumFrames(), mValue.getValue() );
+	}
+
+	Param	mValue;
+};
+
+// Counts its process() calls and remembers the buffer of the last one, and the threads they were made on
+class CountingNode : public Node {
+  public:
+	CountingNode( bool processInPlace = true ) : Node( Format().channels( 1 ) ), mProcessInPlace( processInPlace )	{}
+
+	size_t			mNumProcessed = 0;
+	audio::Buffer*	mLastBuffer = nullptr;
+	set<thread::id>	mProcessThreadIds;
+	bool			mProcessedOffAudioThread = false;
+	// when set, process() sleeps, which leaves the render threads some of the voices even on a single core
+	bool			mSlow = false;
+
+	// when set to the thread calling render(), process() submits a command that checks where it runs
+	thread::id	mCommandThreadId;
+	size_t		mNumCommandsRun = 0;
+	bool		mCommandRanOnRenderThread = false;
+
+  protected:
+	bool supportsProcessInPlace() const override	{ return mProcessInPlace; }
+
+	void process( audio::Buffer *buffer ) override
+	{
+		mNumProcessed++;
+		mLastBuffer = buffer;
+		mProcessThreadIds.insert( this_thread::get_id() );
+		if( ! getContext()->isAudioThread() )
+			mProcessedOffAudioThread = true;
+
+		if( mSlow )
+			this_thread::sleep_for( chrono::microseconds( 100 ) );
+
+		if( mCommandThreadId != thread::id() ) {
+			getContext()->submitCommand( [this] {
+				mNumCommandsRun++;
+				if( this_thread::get_id() != mCommandThreadId )
+					mCommandRanOnRenderThread = true;
+			} );
+		}
+	}
+
+	bool	mProcessInPlace;
+};
+
+// Doubles the sum of its inputs by overriding the deprecated sumInputs()
+class SummingOverrideNode : public Node {
+  public:
+	SummingOverrideNode() : Node( Format().channels( 1 ) )	{}
+
+	size_t	mNumSumInputs = 0;
+
+  protected:
+	bool supportsProcessInPlace() const override	{ return false; }
+
+	void sumInputs() override
+	{
+		mNumSumInputs++;
+		dsp::mul( getSummingBuffer()->getData(), 2.0f, getSummingBuffer()->getData(), getSummingBuffer()->getSize() );
+		Node::sumInputs();
+	}
+};
+
+// Multiplies its input by whatever mSidechain renders, pulling it from within process()
+class SidechainNode : public Node {
+  public:
+	SidechainNode( const NodeRef &sidechain ) : Node( Format().channels( 1 ) ), mSidechain( sidechain )	{}
+
+  protected:
+	void initialize() override
+	{
+		mSidechainBuffer.setSize( getFramesPerBlock(), 1 );
+	}
+
+	void process( audio::Buffer *buffer ) override
+	{
+		mSidechain->pullInputs( &mSidechainBuffer );
+		dsp::mul( buffer->getData(), mSidechainBuffer.getData(), buffer->getData(), buffer->getNumFrames() );
+	}
+
+	NodeRef			mSidechain;
+	BufferDynamic	mSidechainBuffer;
+};
+
+typedef shared_ptr<TestOutputNode>	TestOutputNodeRef;
+typedef shared_ptr<ConstantNode>	ConstantNodeRef;
+typedef shared_ptr<CountingNode>	CountingNodeRef;
+
+// Constant voices through in-place chains, summed by a CountingNode. The last voice's value is driven by a Param processor.
+vector<CountingNodeRef> makeVoices( const ContextRef &ctx, const NodeRef &output, size_t numVoices )
+{
+	auto sum = ctx->makeNode( new CountingNode( false ) );
+	vector<CountingNodeRef> result = { sum };
+	for( size_t i = 0; i < numVoices; i++ ) {
+		auto constant = ctx->makeNode( new ConstantNode( 1.0f / float( i + 3 ) ) );
+		result.push_back( ctx->makeNode( new CountingNode ) );
+		constant >> result.back() >> sum;
+	}
+
+	auto modulated = ctx->makeNode( new ConstantNode( 0 ) );
+	modulated->getParamValue()->setProcessor( ctx->makeNode( new ConstantNode( 0.1f ) ) );
+	modulated >> sum;
+
+	sum >> output;
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/Context" )
+{
+	auto ctx = make_shared<TestContext>();
+	auto output = ctx->makeNode( new TestOutputNode );
+	output->enableClipDetection( false );
+	ctx->setOutput( output );
+
+SECTION( "commands" )
+{
+	int value = 0;
+	ctx->submitCommand( [&] { value = 1; } );
+	REQUIRE( value == 1 );
+
+	ctx->enable();
+	ctx->submitCommand( [&] { value = 2; } );
+	ctx->submitCommand( [&] { value *= 3; } );
+	REQUIRE( value == 1 );
+
+	REQUIRE( output->render() );
+	REQUIRE( value == 6 );
+
+	// pending commands run before a command submitted once disabled
+	ctx->submitCommand( [&] { value = 7; } );
+	ctx->disable();
+	ctx->submitCommand( [&] { value += 1; } );
+	REQUIRE( value == 8 );
+}
+
+SECTION( "connections reach the next block" )
+{
+	auto a = ctx->makeNode( new ConstantNode( 0.25f ) );
+	auto b = ctx->makeNode( new ConstantNode( 0.5f ) );
+	ctx->enable();
+
+	a >> output;
+	REQUIRE( output->render() );
+	REQUIRE( output->isConstant( 0.25f ) );
+
+	b >> output;
+	REQUIRE( output->render() );
+	REQUIRE( output->isConstant( 0.75f ) );
+
+	a->disconnectAll();
+	REQUIRE( output->render() );
+	REQUIRE( output->isConstant( 0.5f ) );
+
+	b->getParamValue()->setValue( 0.125f );
+	REQUIRE( output->render() );
+	REQUIRE( output->isConstant( 0.125f ) );
+
+	// edits made while disabled are compiled when enabled
+	ctx->disable();
+	b->disconnectAll();
+	a >> output;
+	ctx->enable();
+	REQUIRE( output->render() );
+	REQUIRE( output->isConstant( 0.25f ) );
+}
+
+SECTION( "a Node with several outputs is processed once per block" )
+{
+	auto constant = ctx->makeNode( new ConstantNode( 0.25f ) );
+	auto shared = ctx->makeNode( new CountingNode( false ) );
+	auto left = ctx->makeNode( new CountingNode );
+	auto right = ctx->makeNode( new CountingNode );
+	constant >> shared;
+	shared >> left >> output;
+	shared >> right >> output;
+	ctx->enable();
+
+	REQUIRE( output->render() );
+	REQUIRE( output->render() );
+	REQUIRE( shared->mNumProcessed == 2 );
+	REQUIRE( left->mNumProcessed == 2 );
+	REQUIRE( output->isConstant( 0.5f ) );
+
+	// disabled Node's pass their input through
+	shared->disable();
+	REQUIRE( output->render() );
+	REQUIRE( shared->mNumProcessed == 2 );
+	REQUIRE( output->isConstant( 0.5f ) );
+}
+
+SECTION( "sibling inputs reuse the same buffer" )
+{
+	vector<CountingNodeRef> chains;
+	for( int i = 0; i < 8; i++ ) {
+		auto constant = ctx->makeNode( new ConstantNode( 0.125f ) );
+		chains.push_back( ctx->makeNode( new CountingNode ) );
+		constant >> chains.back() >> output;
+	}
+	ctx->enable();
+
+	REQUIRE( output->render() );
+	REQUIRE( output->isConstant( 1.0f ) );
+	for( const auto &chain : chains ) {
+		REQUIRE( chain->mNumProcessed == 1 );
+		REQUIRE( chain->mLastBuffer == chains.front()->mLastBuffer );
+	}
+	REQUIRE( chains.front()->mLastBuffer != output->getInternalBuffer() );
+}
+
+SECTION( "sumInputs() is called on summing Node's" )
+{
+	auto summing = ctx->makeNode( new SummingOverrideNode );
+	ctx->makeNode( new ConstantNode( 0.25f ) ) >> summing >> output;
+	ctx->makeNode( new ConstantNode( 0.5f ) ) >> summing;
+	ctx->enable();
+
+	REQUIRE( output->render() );
+	REQUIRE( summing->mNumSumInputs == 1 );
+	REQUIRE( output->isConstant( 1.5f ) );
+}
+
+SECTION( "a Node can pull other Node's of the graph" )
+{
+	auto sidechain = ctx->makeNode( new CountingNode( false ) );
+	ctx->makeNode( new ConstantNode( 0.25f ) ) >> sidechain >> output;
+	ctx->makeNode( new ConstantNode( 0.25f ) ) >> sidechain;
+	ctx->makeNode( new ConstantNode( 1.0f ) ) >> ctx->makeNode( new SidechainNode( sidechain ) ) >> output;
+	ctx->enable();
+
+	REQUIRE( output->render() );
+	REQUIRE( sidechain->mNumProcessed == 1 );
+	REQUIRE( output->isConstant( 1.0f ) );
+}
+
+SECTION( "routes" )
+{
+	// a stereo output which doesn't process in place, so its buffer is the router's output rather than an alias of it
+	auto stereoOutput = ctx->makeNode( new TestOutputNode( 2 ) );
+	stereoOutput->enableClipDetection( false );
+	ctx->setOutput( stereoOutput );
+
+	auto router = ctx->makeNode( new ChannelRouterNode( Node::Format().channels( 2 ) ) );
+	auto left = ctx->makeNode( new ConstantNode( 0.25f ) );
+	auto right = ctx->makeNode( new ConstantNode( 0.5f ) );
+	right >> router->route( 0, 1 );
+	router >> stereoOutput;
+	ctx->enable();
+
+	auto channelIsConstant = [&]( size_t channel, float value ) {
+		const audio::Buffer *buffer = stereoOutput->getInternalBuffer();
+		return all_of( buffer->getChannel( channel ), buffer->getChannel( channel ) + buffer->getNumFrames(), [value]( float sample ) { return sample == value; } );
+	};
+
+	REQUIRE( stereoOutput->render() );
+	REQUIRE( channelIsConstant( 0, 0.0f ) );
+	REQUIRE( channelIsConstant( 1, 0.5f ) );
+
+	left >> router->route( 0, 0 );
+	REQUIRE( stereoOutput->render() );
+	REQUIRE( channelIsConstant( 0, 0.25f ) );
+	REQUIRE( channelIsConstant( 1, 0.5f ) );
+
+	// a second route to the same channel is summed
+	left >> router->route( 0, 1 );
+	REQUIRE( stereoOutput->render() );
+	REQUIRE( channelIsConstant( 0, 0.25f ) );
+	REQUIRE( channelIsConstant( 1, 0.75f ) );
+
+	left->disconnect( router );
+	REQUIRE( stereoOutput->render() );
+	REQUIRE( channelIsConstant( 0, 0.0f ) );
+	REQUIRE( channelIsConstant( 1, 0.5f ) );
+
+	router->disconnectAllInputs();
+	REQUIRE( stereoOutput->render() );
+	REQUIRE( channelIsConstant( 0, 0.0f ) );
+	REQUIRE( channelIsConstant( 1, 0.0f ) );
+}
+
+SECTION( "rendering in parallel matches rendering serially" )
+{
+	const size_t numVoices = 64;
+	auto voices = makeVoices( ctx, output, numVoices );
+	for( size_t i = 1; i < voices.size(); i++ )
+		voices[i]->mSlow = true;
+	ctx->enable();
+
+	REQUIRE( output->render() );
+	const vector<float> serial( output->getInternalBuffer()->getData(), output->getInternalBuffer()->getData() + output->getInternalBuffer()->getSize() );
+	REQUIRE_FALSE( output->isConstant( 0.0f ) );
+
+	ctx->setNumRenderThreads( 3 );
+	REQUIRE( ctx->getNumRenderThreads() == 3 );
+
+	// inputs are summed in the same order, so the results are identical rather than close
+	bool identical = true;
+	for( int block = 0; block < 50; block++ ) {
+		REQUIRE( output->render() );
+		identical = identical && equal( serial.begin(), serial.end(), output->getInternalBuffer()->getData() );
+	}
+	REQUIRE( identical );
+	set<thread::id> workerThreadIds;
+	for( const auto &voice : voices ) {
+		REQUIRE( voice->mNumProcessed == 51 );
+		workerThreadIds.insert( voice->mProcessThreadIds.begin(), voice->mProcessThreadIds.end() );
+	}
+
+	// the thread calling render() takes part too, the rest are workers, which count as audio threads
+	workerThreadIds.erase( this_thread::get_id() );
+	REQUIRE( workerThreadIds.size() > 1 );
+	for( const auto &voice : voices )
+		REQUIRE_FALSE( voice->mProcessedOffAudioThread );
+
+	// voices render into buffers of their own
+	REQUIRE( voices[1]->mLastBuffer != voices[2]->mLastBuffer );
+
+	ctx->setNumRenderThreads( 0 );
+	REQUIRE( output->render() );
+	REQUIRE( equal( serial.begin(), serial.end(), output->getInternalBuffer()->getData() ) );
+	REQUIRE( voices[1]->mLastBuffer == voices[2]->mLastBuffer );
+}
+
+SECTION( "commands submitted on render threads run at the start of the next block" )
+{
+	auto voices = makeVoices( ctx, output, 64 );
+	for( size_t i = 1; i < voices.size(); i++ ) {
+		voices[i]->mCommandThreadId = this_thread::get_id();
+		voices[i]->mSlow = true;
+	}
+
+	ctx->setNumRenderThreads( 3 );
+	ctx->enable();
+
+	const size_t numBlocks = 10;
+	for( size_t block = 0; block < numBlocks; block++ )
+		REQUIRE( output->render() );
+
+	// the last block's commands are still queued, unless they were submitted by the rendering thread itself
+	for( size_t i = 1; i < voices.size(); i++ ) {
+		REQUIRE( voices[i]->mNumCommandsRun >= numBlocks - 1 );
+		REQUIRE( voices[i]->mNumCommandsRun <= numBlocks );
+		REQUIRE_FALSE( voices[i]->mCommandRanOnRenderThread );
+	}
+}
+
+	ctx->disable();
+	ctx->disconnectAllNodes();
+}
+
+// Rendered through an OfflineContext, which pulls its output on the thread calling render() as fast as it can
+TEST_CASE( "audio/Context/reconfiguring while rendering" )
+{
+	auto ctx = OfflineContext::create( 44100, 512, 1 );
+	auto output = ctx->getOutput();
+
+	const size_t numConstants = 4;
+	vector<ConstantNodeRef> constants;
+	for( size_t i = 0; i < numConstants; i++ )
+		constants.push_back( ctx->makeNode( new ConstantNode( float( i + 1 ) / 16.0f ) ) );
+
+	auto router = ctx->makeNode( new ChannelRouterNode( Node::Format().channels( 1 ) ) );
+	auto sine = ctx->makeNode( new GenSineNode( 440 ) );
+	router >> output;
+
+	ctx->setNumRenderThreads( 2 );
+	ctx->enable();
+
+	atomic<bool> rendering( true ), allFinite( true );
+	atomic<size_t> numRendered( 0 ), numContended( 0 );
+	thread renderThread( [&] {
+		BufferDynamic block;
+		while( rendering ) {
+			// a device output renders silence when it finds the mutex held, where the offline one waits for it
+			if( ! unique_lock<mutex>( ctx->getMutex(), try_to_lock ).owns_lock() )
+				numContended++;
+
+			ctx->render( ctx->getFramesPerBlock(), &block );
+			numRendered++;
+			if( ! all_of( block.getData(), block.getData() + block.getSize(), []( float sample ) { return std::isfinite( sample ); } ) )
+				allFinite = false;
+		}
+	} );
+
+	// paced at 2,000 edits a second, which leaves the render thread room to run even on a single core
+	const auto editInterval = chrono::microseconds( 500 );
+	const auto startTime = chrono::steady_clock::now();
+	size_t numEdits = 0;
+	while( chrono::steady_clock::now() < startTime + chrono::seconds( 1 ) ) {
+		const size_t i = numEdits % numConstants;
+		auto &constant = constants[i];
+		switch( numEdits % 5 ) {
+			case 0:
+				if( constant->isConnectedToOutput( output ) )
+					constant->disconnectAll();
+				else
+					constant >> output;
+				break;
+			case 1:
+				constant->getParamValue()->applyRamp( float( i ) / 8.0f, 0.01 );
+				break;
+			case 2:
+				sine->getParamFreq()->setValue( 220.0f + numEdits % 1000 );
+				if( sine->isConnectedToOutput( output ) )
+					sine->disconnectAll();
+				else
+					sine >> output;
+				break;
+			case 3:
+				if( constant->isConnectedToOutput( router ) )
+					constant->disconnect( router );
+				else
+					constant >> router->route( 0, 0 );
+				break;
+			case 4:
+				constant->getParamValue()->appendRamp( 0.5f, 0.005 );
+				break;
+		}
+
+		numEdits++;
+		this_thread::sleep_until( startTime + numEdits * editInterval );
+	}
+	const double editSeconds = chrono::duration<double>( chrono::steady_clock::now() - startTime ).count();
+
+	rendering = false;
+	renderThread.join();
+
+	INFO( "edits: " << numEdits << " in " << editSeconds << " s, blocks rendered: " << numRendered << ", contended: " << numContended );
+	REQUIRE( numEdits / editSeconds >= 1000.0 );
+	REQUIRE( numRendered > 0 );
+	// connections and Param edits are published without taking the mutex, so no block would have been silenced. The Node's that sum (the
+	// router and the output) were initialized before rendering started, so nothing here needs suspendProcessingForGraphEdit().
+	REQUIRE( numContended == 0 );
+	REQUIRE( allFinite );
+
+	// settle on a known graph: the first two constants, one of them routed
+	sine->disconnectAll();
+	for( auto &constant : constants ) {
+		constant->disconnectAll();
+		constant->getParamValue()->setValue( 0.125f );
+	}
+	constants[0] >> output;
+	constants[1] >> router->route( 0, 0 );
+
+	BufferDynamic block;
+	ctx->render( ctx->getFramesPerBlock(), &block );
+	REQUIRE( all_of( block.getData(), block.getData() + block.getSize(), []( float sample ) { return sample == 0.25f; } ) );
+
+	ctx->disable();
+	ctx->disconnectAllNodes();
+}
+
+TEST_CASE( "audio/Context/editing from several threads" )
+{
+	auto ctx = make_shared<TestContext>();
+	auto output = ctx->makeNode( new TestOutputNode );
+	output->enableClipDetection( false );
+	ctx->setOutput( output );
+
+	const size_t numThreads = 2;
+	const size_t numEditsPerThread = 500;
+	vector<ConstantNodeRef> constants;
+	for( size_t i = 0; i < numThreads; i++ )
+		constants.push_back( ctx->makeNode( new ConstantNode( 0.25f ) ) );
+
+	atomic<size_t> numCommandsRun( 0 );
+	auto edit = [&]( size_t threadIndex ) {
+		auto &constant = constants[threadIndex];
+		for( size_t i = 0; i < numEditsPerThread; i++ ) {
+			ScopedGraphEdit scopedEdit( ctx );
+			// the first thread also suspends processing, which used to let the other one run commands without the mutex
+			if( threadIndex == 0 )
+				ctx->suspendProcessingForGraphEdit();
+
+			constant >> output;
+			ctx->submitCommand( [&] { numCommandsRun++; } );
+			constant->disconnectAll();
+		}
+	};
+
+	auto runEditThreads = [&] {
+		vector<thread> threads;
+		for( size_t i = 0; i < numThreads; i++ )
+			threads.emplace_back( edit, i );
+		for( auto &t : threads )
+			t.join();
+	};
+
+	// commands submitted while disabled are run by the submitting thread
+	runEditThreads();
+	REQUIRE( numCommandsRun == numThreads * numEditsPerThread );
+
+	ctx->enable();
+	atomic<bool> rendering( true );
+	thread renderThread( [&] {
+		while( rendering )
+			output->render();
+	} );
+
+	runEditThreads();
+	rendering = false;
+	renderThread.join();
+
+	// the last commands reach the next block, and every edit left the graph as it found it
+	REQUIRE( output->render() );
+	REQUIRE( numCommandsRun == 2 * numThreads * numEditsPerThread );
+	REQUIRE( output->isConstant( 0 ) );
+	for( const auto &constant : constants )
+		REQUIRE( ! constant->isConnectedToOutput( output ) );
+
+	constants[0] >> output;
+	REQUIRE( output->render() );
+	REQUIRE( output->isConstant( 0.25f ) );
+
+	ctx->disable();
+	ctx->disconnectAllNodes();
+}
+
+TEST_CASE( "audio/Context/benchmark", "[.][benchmark]" )
+{
+	// 400 voices, each a constant through an in-place chain, summed by one Node
+	auto ctx = make_shared<TestContext>();
+	auto output = ctx->makeNode( new TestOutputNode );
+	output->enableClipDetection( false );
+	ctx->setOutput( output );
+	makeVoices( ctx, output, 400 );
+	ctx->enable();
+
+	const int numBlocks = 2000;
+	output->render();
+
+	Timer timer( true );
+	for( int block = 0; block < numBlocks; block++ )
+		output->render();
+	CI_LOG_I( "400 voices: " << timer.getSeconds() * 1e6 / numBlocks << " us per 512 frame block" );
+
+	ctx->disable();
+	ctx->disconnectAllNodes();
+}
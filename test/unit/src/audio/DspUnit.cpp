@@ -0,0 +1,311 @@
+#include "catch.hpp"
+
+#include "cinder/audio/dsp/Dsp.h"
+#include "cinder/audio/dsp/Converter.h"
+#include "cinder/audio/Utilities.h"
+#include "cinder/CinderMath.h"
+#include "cinder/Rand.h"
+
+#include <cmath>
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+// lengths that exercise the SIMD bodies, their tails and the purely scalar cases
+const vector<size_t> sLengths = { 0, 1, 3, 4, 7, 8, 9, 15, 16, 17, 33, 512, 515 };
+
+vector<float> randomSamples( size_t length, uint32_t seed, float minValue = -1, float maxValue = 1 )
+{
+	Rand rnd( seed );
+	vector<float> result( length );
+	for( auto &sample : result )
+		sample = rnd.nextFloat( minValue, maxValue );
+	return result;
+}
+
+bool nearlyEqual( float a, float b, float relativeError )
+{
+	return fabs( a - b ) <= relativeError * max( 1.0f, max( fabs( a ), fabs( b ) ) );
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/Dsp" )
+{
+	SECTION( "element-wise math matches scalar loops exactly" )
+	{
+		for( size_t length : sLengths ) {
+			// offset by one sample so the arrays aren't aligned
+			vector<float> a = randomSamples( length + 1, 1 ), b = randomSamples( length + 1, 2, 0.5f, 2 );
+			const float *pa = a.data() + 1, *pb = b.data() + 1;
+			vector<float> result( length + 1 );
+			float *r = result.data() + 1;
+			bool equal = true;
+
+			dsp::fill( 0.25f, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == 0.25f;
+			dsp::add( pa, 0.5f, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] + 0.5f;
+			dsp::add( pa, pb, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] + pb[i];
+			dsp::sub( pa, 0.5f, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] - 0.5f;
+			dsp::sub( pa, pb, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] - pb[i];
+			dsp::mul( pa, 0.3f, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] * 0.3f;
+			dsp::mul( pa, pb, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] * pb[i];
+			dsp::divide( pa, pb, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] / pb[i];
+			dsp::addMul( pa, pb, 0.7f, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == ( pa[i] + pb[i] ) * 0.7f;
+
+			// in place
+			result = a;
+			dsp::add( r, pb, r, length );
+			for( size_t i = 0; i < length; i++ )
+				equal = equal && r[i] == pa[i] + pb[i];
+
+			REQUIRE( equal );
+			REQUIRE( result[0] == a[0] );
+		}
+	}
+
+	SECTION( "reductions" )
+	{
+		for( size_t length : sLengths ) {
+			if( length == 0 )
+				continue;
+
+			vector<float> a = randomSamples( length, 3 );
+			double sum = 0, sumSquares = 0, maxValue = a[0];
+			for( float sample : a ) {
+				sum += sample;
+				sumSquares += sample * sample;
+				maxValue = max<double>( maxValue, sample );
+			}
+
+			REQUIRE( fabs( dsp::sum( a.data(), length ) - sum ) < 1e-4 );
+			REQUIRE( nearlyEqual( dsp::rms( a.data(), length ), (float)sqrt( sumSquares / length ), 1e-5f ) );
+
+			dsp::normalize( a.data(), length, 0.5f );
+			float normalizedMax = a[0];
+			for( float sample : a )
+				normalizedMax = max( normalizedMax, sample );
+			REQUIRE( ( maxValue <= 0.00001 || nearlyEqual( normalizedMax, 0.5f, 1e-6f ) ) );
+		}
+
+		// the centroid of a single bin is that bin's frequency
+		vector<float> mag( 513, 0.0f );
+		mag[100] = 2;
+		REQUIRE( nearlyEqual( dsp::spectralCentroid( mag.data(), mag.size(), 44100 ), 100 * 44100.0f / 1026.0f, 1e-6f ) );
+
+		mag = randomSamples( 513, 4, 0, 1 );
+		double weighted = 0, total = 0;
+		for( size_t i = 0; i < mag.size(); i++ ) {
+			weighted += i * ( 44100.0 / 1026.0 ) * mag[i];
+			total += mag[i];
+		}
+		REQUIRE( nearlyEqual( dsp::spectralCentroid( mag.data(), mag.size(), 44100 ), float( weighted / total ), 1e-5f ) );
+		REQUIRE( dsp::spectralCentroid( mag.data(), 0, 44100 ) == 0 );
+	}
+
+	SECTION( "windows match their definition" )
+	{
+		for( size_t length : { 2, 7, 512 } ) {
+			vector<float> window( length );
+			dsp::generateWindow( dsp::WindowType::HANN, window.data(), length );
+			bool matches = true;
+			for( size_t i = 0; i < length; i++ ) {
+				const float expected = float( 0.5 * ( 1.0 - cos( 2.0 * M_PI * i / double( length - 1 ) ) ) );
+				matches = matches && nearlyEqual( window[i], expected, 1e-6f ) && nearlyEqual( window[i], window[length - 1 - i], 1e-6f );
+			}
+			REQUIRE( matches );
+
+			dsp::generateWindow( dsp::WindowType::RECT, window.data(), length );
+			REQUIRE( window[length - 1] == 1 );
+		}
+	}
+
+	SECTION( "decibel conversion" )
+	{
+		for( size_t length : sLengths ) {
+			vector<float> gains = randomSamples( length, 5, 0, 1.5f );
+			if( length > 4 ) {
+				gains[1] = 0;
+				gains[2] = 0.000005f;
+				gains[3] = 1;
+				// NaN is inaudible in both the SIMD bodies and the scalar tails
+				gains[4] = NAN;
+				gains[length - 1] = NAN;
+			}
+
+			vector<float> db = gains;
+			linearToDecibel( db.data(), length );
+			bool matches = true;
+			for( size_t i = 0; i < length; i++ )
+				matches = matches && nearlyEqual( db[i], linearToDecibel( gains[i] ), 1e-6f ) && ( db[i] == 0 ) == ( linearToDecibel( gains[i] ) == 0 );
+			REQUIRE( matches );
+
+			vector<float> linear = db;
+			decibelToLinear( linear.data(), length );
+			for( size_t i = 0; i < length; i++ )
+				matches = matches && nearlyEqual( linear[i], decibelToLinear( db[i] ), 1e-5f ) && ( linear[i] == 0 ) == ( decibelToLinear( db[i] ) == 0 );
+			REQUIRE( matches );
+		}
+
+		REQUIRE( linearToDecibel( NAN ) == 0 );
+		REQUIRE( decibelToLinear( NAN ) == 0 );
+	}
+}
+
+TEST_CASE( "audio/Converter" )
+{
+	SECTION( "int16" )
+	{
+		for( size_t length : sLengths ) {
+			vector<float> samples = randomSamples( length, 6 );
+			if( length > 4 ) {
+				samples[0] = 1.0f;
+				samples[1] = -1.5f;
+				samples[2] = 2.0f;
+				samples[3] = NAN;
+				samples[length - 1] = NAN;
+			}
+
+			vector<int16_t> ints( length );
+			dsp::convert( samples.data(), ints.data(), length );
+			bool matches = true;
+			for( size_t i = 0; i < length; i++ )
+				matches = matches && ints[i] == ( std::isnan( samples[i] ) ? -32768 : int16_t( min( max( samples[i] * 32768.0f, -32768.0f ), 32767.0f ) ) );
+			REQUIRE( matches );
+
+			// the double overload clips the same way
+			vector<double> doubles( samples.begin(), samples.end() );
+			vector<int16_t> intsFromDouble( length );
+			dsp::convert( doubles.data(), intsFromDouble.data(), length );
+			REQUIRE( intsFromDouble == ints );
+
+			vector<float> floats( length );
+			dsp::convert( ints.data(), floats.data(), length );
+			for( size_t i = 0; i < length; i++ )
+				matches = matches && floats[i] == ints[i] / 32768.0f;
+			REQUIRE( matches );
+		}
+	}
+
+	SECTION( "int24" )
+	{
+		for( size_t length : sLengths ) {
+			vector<float> samples = randomSamples( length, 7 );
+			if( length > 4 ) {
+				samples[0] = 1.0f;
+				samples[1] = -1.0f;
+				samples[2] = 3.0f;
+				samples[3] = NAN;
+			}
+
+			vector<char> bytes( length * 3 );
+			dsp::convertFloatToInt24( samples.data(), bytes.data(), length );
+			vector<float> floats( length );
+			dsp::convertInt24ToFloat( bytes.data(), floats.data(), length );
+			bool matches = true;
+			for( size_t i = 0; i < length; i++ ) {
+				const int32_t expected = std::isnan( samples[i] ) ? -8388608 : int32_t( min( max( samples[i] * 8388607.0f, -8388608.0f ), 8388607.0f ) );
+				matches = matches && floats[i] == (float)expected * ( 1.0f / 8388607.0f );
+			}
+			REQUIRE( matches );
+
+			// the double overload clips the same way, rounding in double precision
+			vector<double> doubles( samples.begin(), samples.end() );
+			dsp::convertFloatToInt24( doubles.data(), bytes.data(), length );
+			dsp::convertInt24ToFloat( bytes.data(), floats.data(), length );
+			for( size_t i = 0; i < length; i++ ) {
+				const int32_t expected = std::isnan( doubles[i] ) ? -8388608 : int32_t( min( max( doubles[i] * 8388607.0, -8388608.0 ), 8388607.0 ) );
+				matches = matches && floats[i] == (float)expected * ( 1.0f / 8388607.0f );
+			}
+			REQUIRE( matches );
+		}
+	}
+
+	SECTION( "interleaving round trips for every channel count" )
+	{
+		for( size_t numChannels = 1; numChannels <= 5; numChannels++ ) {
+			for( size_t numFrames : { 1, 4, 9, 17, 512 } ) {
+				// the non-interleaved layout has room for more frames than are copied
+				const size_t numFramesPerChannel = numFrames + 3;
+				vector<float> planar = randomSamples( numFramesPerChannel * numChannels, 8 );
+				vector<float> interleaved( numFrames * numChannels );
+				dsp::interleave( planar.data(), interleaved.data(), numFramesPerChannel, numChannels, numFrames );
+
+				bool matches = true;
+				for( size_t ch = 0; ch < numChannels; ch++ )
+					for( size_t i = 0; i < numFrames; i++ )
+						matches = matches && interleaved[i * numChannels + ch] == planar[ch * numFramesPerChannel + i];
+				REQUIRE( matches );
+
+				vector<float> roundTrip( planar.size(), 5.0f );
+				dsp::deinterleave( interleaved.data(), roundTrip.data(), numFramesPerChannel, numChannels, numFrames );
+				for( size_t ch = 0; ch < numChannels; ch++ ) {
+					for( size_t i = 0; i < numFramesPerChannel; i++ )
+						matches = matches && roundTrip[ch * numFramesPerChannel + i] == ( i < numFrames ? planar[ch * numFramesPerChannel + i] : 5.0f );
+				}
+				REQUIRE( matches );
+
+				vector<int16_t> interleavedInt16( numFrames * numChannels );
+				dsp::interleave( planar.data(), interleavedInt16.data(), numFramesPerChannel, numChannels, numFrames );
+				vector<int16_t> expectedInt16( interleavedInt16.size() );
+				for( size_t ch = 0; ch < numChannels; ch++ )
+					for( size_t i = 0; i < numFrames; i++ )
+						dsp::convert( &planar[ch * numFramesPerChannel + i], &expectedInt16[i * numChannels + ch], 1 );
+				REQUIRE( interleavedInt16 == expectedInt16 );
+
+				dsp::deinterleave( interleavedInt16.data(), roundTrip.data(), numFramesPerChannel, numChannels, numFrames );
+				for( size_t ch = 0; ch < numChannels; ch++ )
+					for( size_t i = 0; i < numFrames; i++ )
+						matches = matches && roundTrip[ch * numFramesPerChannel + i] == interleavedInt16[i * numChannels + ch] / 32768.0f;
+				REQUIRE( matches );
+
+				vector<char> interleavedInt24( numFrames * numChannels * 3 );
+				dsp::convertFloatToInt24( interleaved.data(), interleavedInt24.data(), interleaved.size() );
+				vector<float> expected( interleaved.size() );
+				dsp::convertInt24ToFloat( interleavedInt24.data(), expected.data(), expected.size() );
+				dsp::deinterleaveInt24ToFloat( interleavedInt24.data(), roundTrip.data(), numFramesPerChannel, numChannels, numFrames );
+				for( size_t ch = 0; ch < numChannels; ch++ )
+					for( size_t i = 0; i < numFrames; i++ )
+						matches = matches && roundTrip[ch * numFramesPerChannel + i] == expected[i * numChannels + ch];
+				REQUIRE( matches );
+			}
+		}
+	}
+
+	SECTION( "stereo Buffer helpers" )
+	{
+		audio::Buffer planar( 37, 2 );
+		const vector<float> samples = randomSamples( planar.getSize(), 9 );
+		memcpy( planar.getData(), samples.data(), samples.size() * sizeof( float ) );
+
+		BufferInterleaved interleaved( 37, 2 );
+		dsp::interleaveStereoBuffer( &planar, &interleaved );
+		REQUIRE( interleaved.getData()[2 * 20 + 1] == planar.getChannel( 1 )[20] );
+
+		audio::Buffer roundTrip( 37, 2 );
+		dsp::deinterleaveStereoBuffer( &interleaved, &roundTrip );
+		REQUIRE( memcmp( roundTrip.getData(), planar.getData(), planar.getSize() * sizeof( float ) ) == 0 );
+	}
+}
@@ -0,0 +1,141 @@
+#include "catch.hpp"
+
+#include "cinder/audio/OfflineContext.h"
+#include "cinder/audio/GenNode.h"
+#include "cinder/audio/Exception.h"
+
+#include <cstring>
+#include <vector>
+
+using namespace std;
+using namespace ci;
+using namespace ci::audio;
+
+namespace {
+
+// Captures everything written to it in memory
+class TargetMemory : public TargetFile {
+  public:
+	TargetMemory( size_t sampleRate, size_t numChannels )
+		: TargetFile( sampleRate, numChannels, SampleType::FLOAT_32 ), mChannels( numChannels )
+	{}
+
+	audio::Buffer getBuffer() const
+	{
+		audio::Buffer result( mChannels[0].size(), mChannels.size() );
+		for( size_t ch = 0; ch < mChannels.size(); ch++ )
+			memcpy( result.getChannel( ch ), mChannels[ch].data(), mChannels[ch].size() * sizeof( float ) );
+		return result;
+	}
+
+  protected:
+	void performWrite( const audio::Buffer *buffer, size_t numFrames, size_t frameOffset ) override
+	{
+		for( size_t ch = 0; ch < mChannels.size(); ch++ )
+			mChannels[ch].insert( mChannels[ch].end(), buffer->getChannel( ch ) + frameOffset, buffer->getChannel( ch ) + frameOffset + numFrames );
+	}
+
+	vector<vector<float>> mChannels;
+};
+
+OfflineContextRef makeSineContext( size_t framesPerBlock )
+{
+	auto ctx = OfflineContext::create( 48000, framesPerBlock, 2 );
+	auto sine = ctx->makeNode( new GenSineNode( 440 ) );
+	sine >> ctx->getOutput();
+	sine->enable();
+	ctx->enable();
+	return ctx;
+}
+
+bool framesEqual( const audio::Buffer &a, size_t offsetA, const audio::Buffer &b, size_t offsetB, size_t numFrames )
+{
+	for( size_t ch = 0; ch < a.getNumChannels(); ch++ ) {
+		if( memcmp( a.getChannel( ch ) + offsetA, b.getChannel( ch ) + offsetB, numFrames * sizeof( float ) ) != 0 )
+			return false;
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "audio/OfflineContext" )
+{
+	SECTION( "renders the same frames however they are split" )
+	{
+		BufferDynamic whole;
+		makeSineContext( 256 )->render( 1000, &whole );
+		REQUIRE( whole.getNumFrames() == 1000 );
+		REQUIRE( whole.getNumChannels() == 2 );
+		REQUIRE( whole.getChannel( 1 )[100] != 0 );
+
+		auto ctx = makeSineContext( 256 );
+		BufferDynamic first, second;
+		ctx->render( 300, &first );
+		ctx->render( 700, &second );
+		REQUIRE( framesEqual( whole, 0, first, 0, 300 ) );
+		REQUIRE( framesEqual( whole, 300, second, 0, 700 ) );
+
+		// the block size doesn't change what is rendered
+		BufferDynamic otherBlocks;
+		makeSineContext( 64 )->render( 1000, &otherBlocks );
+		REQUIRE( framesEqual( whole, 0, otherBlocks, 0, 1000 ) );
+	}
+
+	SECTION( "nothing is rendered until the Context is enabled" )
+	{
+		auto ctx = makeSineContext( 128 );
+		ctx->disable();
+
+		BufferDynamic buffer;
+		ctx->render( 256, &buffer );
+		REQUIRE( buffer.getChannel( 0 )[200] == 0 );
+		REQUIRE( ctx->getNumProcessedFrames() == 0 );
+	}
+
+	SECTION( "scheduled events land on their block" )
+	{
+		const size_t framesPerBlock = 128;
+		auto ctx = OfflineContext::create( 48000, framesPerBlock, 1 );
+		auto triangle = ctx->makeNode( new GenTriangleNode( 100 ) );
+		triangle >> ctx->getOutput();
+		ctx->enable();
+
+		// enable after exactly 10 blocks
+		triangle->enable( double( 10 * framesPerBlock ) / 48000.0 );
+
+		BufferDynamic buffer;
+		ctx->render( 20 * framesPerBlock, &buffer );
+		const float *data = buffer.getData();
+		bool silentBefore = true;
+		for( size_t i = 0; i < 10 * framesPerBlock; i++ )
+			silentBefore = silentBefore && data[i] == 0;
+
+		REQUIRE( silentBefore );
+		REQUIRE( data[10 * framesPerBlock + 1] != 0 );
+		REQUIRE( ctx->getNumProcessedFrames() == 20 * framesPerBlock );
+	}
+
+	SECTION( "writes to a TargetFile" )
+	{
+		BufferDynamic expected;
+		makeSineContext( 512 )->render( 2000, &expected );
+
+		auto ctx = makeSineContext( 512 );
+		TargetMemory target( 48000, 2 );
+		ctx->render( 1500, &target );
+		ctx->render( 500, &target );
+		REQUIRE( target.getBuffer().getNumFrames() == 2000 );
+		REQUIRE( framesEqual( expected, 0, target.getBuffer(), 0, 2000 ) );
+
+		TargetMemory mono( 48000, 1 );
+		REQUIRE_THROWS_AS( ctx->render( 100, &mono ), AudioFormatExc );
+	}
+
+	SECTION( "has no devices" )
+	{
+		auto ctx = OfflineContext::create();
+		REQUIRE_THROWS_AS( ctx->createOutputDeviceNode( nullptr ), AudioContextExc );
+		REQUIRE_THROWS_AS( ctx->setOutput( nullptr ), AudioContextExc );
+	}
+}
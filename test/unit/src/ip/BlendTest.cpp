@@ -0,0 +1,296 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ip/Blend.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/Rand.h"
+#include "cinder/Timer.h"
+#include "cinder/Log.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+// makes about a quarter of the pixels fully transparent, which the premultiply and blend kernels handle separately
+template<typename T>
+void clearRandomAlpha( SurfaceT<T> *surface, uint32_t seed )
+{
+	Rand rnd( seed );
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			if( rnd.nextInt( 4 ) == 0 )
+				iter.a() = 0;
+		}
+	}
+}
+
+template<typename T>
+bool identical( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() || a.getPixelBytes() != b.getPixelBytes() )
+		return false;
+
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		if( memcmp( a.getData( ivec2( 0, y ) ), b.getData( ivec2( 0, y ) ), a.getWidth() * a.getPixelBytes() ) != 0 )
+			return false;
+	}
+
+	return true;
+}
+
+// straightforward per-pixel versions of the formulas in Premultiply.cpp and Blend.cpp, used to check the SIMD paths
+void premultiplyReference( Surface8u *surface )
+{
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = iter.a() * iter.r() / 255;
+			iter.g() = iter.a() * iter.g() / 255;
+			iter.b() = iter.a() * iter.b() / 255;
+		}
+	}
+}
+
+void premultiplyReference( Surface32f *surface )
+{
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() *= iter.a();
+			iter.g() *= iter.a();
+			iter.b() *= iter.a();
+		}
+	}
+}
+
+void blendPremultReference( Surface8u *background, const Surface8u &foreground )
+{
+	auto dst = background->getIter();
+	auto src = foreground.getIter();
+	while( dst.line() && src.line() ) {
+		while( dst.pixel() && src.pixel() ) {
+			const int invAlphaS = 255 - src.a(), alphaD = dst.a(), invAlphaD = 255 - dst.a();
+			dst.a() = 255 - invAlphaS * invAlphaD / 255;
+			if( dst.a() ) {
+				dst.r() = ( invAlphaS * dst.r() + invAlphaD * src.r() + alphaD * src.r() ) / 255;
+				dst.g() = ( invAlphaS * dst.g() + invAlphaD * src.g() + alphaD * src.g() ) / 255;
+				dst.b() = ( invAlphaS * dst.b() + invAlphaD * src.b() + alphaD * src.b() ) / 255;
+			}
+		}
+	}
+}
+
+void blendPremultReference( Surface32f *background, const Surface32f &foreground )
+{
+	auto dst = background->getIter();
+	auto src = foreground.getIter();
+	while( dst.line() && src.line() ) {
+		while( dst.pixel() && src.pixel() ) {
+			const float invAlphaS = 1.0f - src.a(), alphaD = dst.a(), invAlphaD = 1.0f - dst.a();
+			dst.a() = 1 - invAlphaS * invAlphaD;
+			if( dst.a() ) {
+				dst.r() = invAlphaS * dst.r() + invAlphaD * src.r() + alphaD * src.r();
+				dst.g() = invAlphaS * dst.g() + invAlphaD * src.g() + alphaD * src.g();
+				dst.b() = invAlphaS * dst.b() + invAlphaD * src.b() + alphaD * src.b();
+			}
+		}
+	}
+}
+
+// clone() does not carry over the premultiplied flag, which selects the blend path
+template<typename T>
+SurfaceT<T> cloneSurface( const SurfaceT<T> &surface )
+{
+	SurfaceT<T> result = surface.clone();
+	result.setPremultiplied( surface.isPremultiplied() );
+	return result;
+}
+
+template<typename T>
+SurfaceT<T> makeRandom( int32_t width, int32_t height, SurfaceChannelOrder order, uint32_t seed, bool premultiplied )
+{
+	SurfaceT<T> result( width, height, order.hasAlpha(), order );
+	fillRandom( &result, seed );
+	if( result.hasAlpha() )
+		clearRandomAlpha( &result, seed + 1 );
+	if( premultiplied && result.hasAlpha() )
+		premultiplyReference( &result );
+	result.setPremultiplied( premultiplied );
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Premultiply" )
+{
+	SECTION( "8-bit premultiply matches the reference for every alpha position" )
+	{
+		// odd widths exercise the scalar tail after the SIMD kernels
+		for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB, SurfaceChannelOrder::ABGR } ) {
+			Surface8u surface = makeRandom<uint8_t>( 37, 5, order, 1, false );
+			Surface8u expected = surface.clone();
+			premultiplyReference( &expected );
+			ip::premultiply( &surface );
+			REQUIRE( surface.isPremultiplied() );
+			REQUIRE( identical( surface, expected ) );
+		}
+	}
+
+	SECTION( "8-bit unpremultiply is exact for every value and alpha" )
+	{
+		// x is the color, y is the alpha, so every combination is covered
+		Surface8u surface( 256, 256, true, SurfaceChannelOrder::RGBA );
+		auto iter = surface.getIter();
+		while( iter.line() ) {
+			while( iter.pixel() ) {
+				iter.r() = iter.x();
+				iter.g() = 255 - iter.x();
+				iter.b() = iter.x() / 2;
+				iter.a() = iter.y();
+			}
+		}
+		Surface8u expected = surface.clone();
+		ip::unpremultiply( &surface );
+		REQUIRE( ! surface.isPremultiplied() );
+
+		auto expIter = expected.getIter();
+		while( expIter.line() ) {
+			while( expIter.pixel() ) {
+				const int alpha = expIter.a();
+				if( alpha ) {
+					expIter.r() = std::min( expIter.r() * 255 / alpha, 255 );
+					expIter.g() = std::min( expIter.g() * 255 / alpha, 255 );
+					expIter.b() = std::min( expIter.b() * 255 / alpha, 255 );
+				}
+			}
+		}
+		REQUIRE( identical( surface, expected ) );
+	}
+
+	SECTION( "float premultiply and unpremultiply match the reference" )
+	{
+		for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::ARGB } ) {
+			Surface32f surface = makeRandom<float>( 13, 3, order, 2, false );
+			Surface32f expected = surface.clone();
+			premultiplyReference( &expected );
+			ip::premultiply( &surface );
+			REQUIRE( identical( surface, expected ) );
+
+			auto iter = expected.getIter();
+			while( iter.line() ) {
+				while( iter.pixel() ) {
+					if( iter.a() != 0 ) {
+						const float invAlpha = 1.0f / iter.a();
+						iter.r() *= invAlpha;
+						iter.g() *= invAlpha;
+						iter.b() *= invAlpha;
+					}
+				}
+			}
+			ip::unpremultiply( &surface );
+			REQUIRE( identical( surface, expected ) );
+		}
+	}
+}
+
+TEST_CASE( "ip/Blend" )
+{
+	SECTION( "premultiplied 8-bit blend matches the reference" )
+	{
+		for( auto order : { SurfaceChannelOrder::RGBA, SurfaceChannelOrder::BGRA, SurfaceChannelOrder::ARGB } ) {
+			Surface8u background = makeRandom<uint8_t>( 41, 7, order, 3, true );
+			Surface8u foreground = makeRandom<uint8_t>( 41, 7, order, 4, true );
+			Surface8u expected = cloneSurface( background );
+			blendPremultReference( &expected, foreground );
+			ip::blend( &background, foreground );
+			REQUIRE( identical( background, expected ) );
+		}
+	}
+
+	SECTION( "premultiplied float blend matches the reference" )
+	{
+		Surface32f background = makeRandom<float>( 19, 4, SurfaceChannelOrder::RGBA, 5, true );
+		Surface32f foreground = makeRandom<float>( 19, 4, SurfaceChannelOrder::RGBA, 6, true );
+		Surface32f expected = cloneSurface( background );
+		blendPremultReference( &expected, foreground );
+		ip::blend( &background, foreground );
+		REQUIRE( identical( background, expected ) );
+	}
+
+	SECTION( "batched blend matches blending each layer in turn" )
+	{
+		Surface8u background = makeRandom<uint8_t>( 300, 211, SurfaceChannelOrder::RGBA, 7, true );
+		std::vector<Surface8u> layers;
+		layers.push_back( makeRandom<uint8_t>( 300, 211, SurfaceChannelOrder::RGBA, 8, true ) );
+		layers.push_back( makeRandom<uint8_t>( 120, 90, SurfaceChannelOrder::BGRA, 9, false ) );
+		layers.push_back( makeRandom<uint8_t>( 64, 300, SurfaceChannelOrder::RGB, 10, false ) );
+		layers.push_back( makeRandom<uint8_t>( 300, 211, SurfaceChannelOrder::ARGB, 11, true ) );
+
+		Surface8u expected = cloneSurface( background );
+		std::vector<const Surface8u*> layerPtrs;
+		for( const auto &layer : layers ) {
+			ip::blend( &expected, layer, layer.getBounds() );
+			layerPtrs.push_back( &layer );
+		}
+
+		for( int threads : { 1, 2, 3, 0 } ) {
+			Surface8u batched = cloneSurface( background );
+			ip::blend( &batched, layerPtrs, ip::Options().threads( threads ) );
+			REQUIRE( identical( batched, expected ) );
+		}
+	}
+
+	SECTION( "batched float blend matches blending each layer in turn" )
+	{
+		Surface32f background = makeRandom<float>( 97, 61, SurfaceChannelOrder::RGB, 12, false );
+		std::vector<Surface32f> layers;
+		layers.push_back( makeRandom<float>( 97, 61, SurfaceChannelOrder::RGBA, 13, false ) );
+		layers.push_back( makeRandom<float>( 50, 80, SurfaceChannelOrder::RGBA, 14, true ) );
+
+		Surface32f expected = cloneSurface( background );
+		std::vector<const Surface32f*> layerPtrs;
+		for( const auto &layer : layers ) {
+			ip::blend( &expected, layer, layer.getBounds() );
+			layerPtrs.push_back( &layer );
+		}
+
+		Surface32f batched = cloneSurface( background );
+		ip::blend( &batched, layerPtrs, ip::Options().threads( 2 ) );
+		REQUIRE( identical( batched, expected ) );
+	}
+}
+
+TEST_CASE( "ip/Blend benchmark", "[.][benchmark]" )
+{
+	const ivec2 size( 1920, 1080 );
+	const int numLayers = 16;
+	Surface8u background = makeRandom<uint8_t>( size.x, size.y, SurfaceChannelOrder::RGBA, 1, true );
+	std::vector<Surface8u> layers;
+	std::vector<const Surface8u*> layerPtrs;
+	for( int i = 0; i < numLayers; ++i )
+		layers.push_back( makeRandom<uint8_t>( size.x, size.y, SurfaceChannelOrder::RGBA, 2 + i, true ) );
+	for( const auto &layer : layers )
+		layerPtrs.push_back( &layer );
+
+	Surface8u sequential = cloneSurface( background );
+	Timer timer( true );
+	for( const auto &layer : layers )
+		ip::blend( &sequential, layer );
+	CI_LOG_I( numLayers << " layers, one blend() per layer: " << timer.getSeconds() * 1000 << "ms" );
+
+	for( int threads : { 1, 2, 4, 8 } ) {
+		Surface8u batched = cloneSurface( background );
+		timer.start();
+		ip::blend( &batched, layerPtrs, ip::Options().threads( threads ) );
+		CI_LOG_I( numLayers << " layers, batched, " << threads << " threads: " << timer.getSeconds() * 1000 << "ms" );
+		REQUIRE( identical( batched, sequential ) );
+	}
+
+	timer.start();
+	ip::unpremultiply( &background );
+	ip::premultiply( &background );
+	CI_LOG_I( "unpremultiply + premultiply: " << timer.getSeconds() * 1000 << "ms" );
+}
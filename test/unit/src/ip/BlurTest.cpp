@@ -0,0 +1,194 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ip/Blur.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/Timer.h"
+#include "cinder/Log.h"
+
+#include <cstring>
+
+using namespace ci;
+
+namespace {
+
+// brute-force box blur with edge pixels extended, for reference
+Channel32f referenceBoxBlur( const Channel32f &src, int radius )
+{
+	auto clampedValue = [&]( int32_t x, int32_t y ) {
+		return src.getValue( ivec2( x, y ) );
+	};
+
+	Channel32f horizontal( src.getWidth(), src.getHeight() ), result( src.getWidth(), src.getHeight() );
+	for( int32_t y = 0; y < src.getHeight(); ++y ) {
+		for( int32_t x = 0; x < src.getWidth(); ++x ) {
+			float sum = 0;
+			for( int i = -radius; i <= radius; ++i )
+				sum += clampedValue( x + i, y );
+			*horizontal.getData( x, y ) = sum / ( 2 * radius + 1 );
+		}
+	}
+	for( int32_t y = 0; y < src.getHeight(); ++y ) {
+		for( int32_t x = 0; x < src.getWidth(); ++x ) {
+			float sum = 0;
+			for( int i = -radius; i <= radius; ++i )
+				sum += horizontal.getValue( ivec2( x, y + i ) );
+			*result.getData( x, y ) = sum / ( 2 * radius + 1 );
+		}
+	}
+
+	return result;
+}
+
+float maxDifference( const Channel32f &a, const Channel32f &b )
+{
+	float result = 0;
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x )
+			result = std::max( result, std::fabs( *a.getData( x, y ) - *b.getData( x, y ) ) );
+	}
+	return result;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Blur" )
+{
+	SECTION( "box blur matches brute force" )
+	{
+		Channel32f src( 61, 43 );
+		fillRandom( &src, 5678 );
+		for( int radius : { 1, 4, 30, 100 } ) {
+			Channel32f result = ip::boxBlurCopy( src, radius );
+			REQUIRE( maxDifference( result, referenceBoxBlur( src, radius ) ) < 1e-4f );
+		}
+	}
+
+	SECTION( "constant surfaces are unchanged" )
+	{
+		Surface8u surface8u( 90, 50, true );
+		ip::fill( &surface8u, ColorA8u( 10, 200, 77, 128 ) );
+		ip::gaussianBlur( &surface8u, 6.5f );
+		ip::boxBlur( &surface8u, 9, 3 );
+		REQUIRE( surface8u.getPixel( ivec2( 45, 25 ) ) == ColorA8u( 10, 200, 77, 128 ) );
+		REQUIRE( surface8u.getPixel( ivec2( 0, 49 ) ) == ColorA8u( 10, 200, 77, 128 ) );
+
+		Surface16u surface16u( 40, 70, false );
+		ip::fill( &surface16u, Color( 0.25f, 0.5f, 1.0f ) );
+		const ColorAT<uint16_t> expected = surface16u.getPixel( ivec2( 0, 0 ) );
+		ip::gaussianBlur( &surface16u, 3.0f );
+		REQUIRE( surface16u.getPixel( ivec2( 20, 35 ) ) == expected );
+	}
+
+	SECTION( "integer images are rounded once" )
+	{
+		// row sums of 52, 52, 57, 57, 52 average 10.4 or 11.4 horizontally; rounding those before the vertical pass would give 10, not 10.8
+		const uint8_t rows[5][5] = { { 10, 10, 10, 11, 11 }, { 10, 10, 10, 11, 11 }, { 11, 11, 11, 12, 12 }, { 11, 11, 11, 12, 12 }, { 10, 10, 10, 11, 11 } };
+		Channel8u channel( 5, 5 );
+		for( int32_t y = 0; y < 5; ++y )
+			std::memcpy( channel.getData( 0, y ), rows[y], 5 );
+
+		ip::boxBlur( &channel, 2 );
+		REQUIRE( channel.getValue( ivec2( 2, 2 ) ) == 11 );
+	}
+
+	SECTION( "gaussian preserves energy and is symmetric" )
+	{
+		Channel32f impulse( 101, 101 );
+		ip::fill( &impulse, 0.0f, impulse.getBounds() );
+		*impulse.getData( 50, 50 ) = 1.0f;
+		ip::gaussianBlur( &impulse, 4.0f );
+
+		float sum = 0;
+		for( int32_t y = 0; y < 101; ++y )
+			for( int32_t x = 0; x < 101; ++x )
+				sum += *impulse.getData( x, y );
+		REQUIRE( sum == Approx( 1.0f ).epsilon( 1e-4 ) );
+		REQUIRE( *impulse.getData( 46, 50 ) == Approx( *impulse.getData( 50, 54 ) ) );
+		REQUIRE( *impulse.getData( 46, 50 ) == Approx( *impulse.getData( 54, 50 ) ) );
+	}
+
+	SECTION( "large gaussians are close to the exact kernel" )
+	{
+		// from sigma 8 up the blur uses box passes, which match the Gaussian to within a few percent of its peak
+		const float sigma = 20.0f;
+		Channel32f impulse( 241, 241 );
+		ip::fill( &impulse, 0.0f, impulse.getBounds() );
+		*impulse.getData( 120, 120 ) = 1.0f;
+		ip::gaussianBlur( &impulse, sigma );
+
+		float sum = 0, maxError = 0;
+		const float peak = 1.0f / ( 2.0f * (float)M_PI * sigma * sigma );
+		for( int32_t y = 0; y < 241; ++y ) {
+			for( int32_t x = 0; x < 241; ++x ) {
+				const float r2 = float( ( x - 120 ) * ( x - 120 ) + ( y - 120 ) * ( y - 120 ) );
+				sum += *impulse.getData( x, y );
+				maxError = std::max( maxError, std::fabs( *impulse.getData( x, y ) - peak * std::exp( -r2 / ( 2 * sigma * sigma ) ) ) );
+			}
+		}
+		REQUIRE( sum == Approx( 1.0f ).epsilon( 1e-3 ) );
+		REQUIRE( maxError < 0.08f * peak );
+		REQUIRE( *impulse.getData( 100, 120 ) == Approx( *impulse.getData( 120, 140 ) ) );
+	}
+
+	SECTION( "area is respected" )
+	{
+		Surface8u surface( 64, 64, false );
+		ip::fill( &surface, Color8u( 0, 0, 0 ) );
+		ip::fill( &surface, Color8u( 255, 255, 255 ), Area( 32, 0, 64, 64 ) );
+		ip::boxBlur( &surface, Area( 0, 0, 32, 64 ), 8 );
+		REQUIRE( surface.getPixel( ivec2( 31, 10 ) ) == ColorA8u( 0, 0, 0, 255 ) );
+		REQUIRE( surface.getPixel( ivec2( 32, 10 ) ) == ColorA8u( 255, 255, 255, 255 ) );
+	}
+
+	SECTION( "threaded blur is identical to serial" )
+	{
+		Channel32f src( 157, 93 );
+		fillRandom( &src, 5678 );
+		Channel32f serial = ip::gaussianBlurCopy( src, 2.5f );
+		Channel32f threaded = ip::gaussianBlurCopy( src, 2.5f, ip::Options().threads( 4 ) );
+		REQUIRE( maxDifference( serial, threaded ) == 0 );
+
+		serial = ip::boxBlurCopy( src, 7, 3 );
+		threaded = ip::boxBlurCopy( src, 7, 3, ip::Options().threads( 0 ) );
+		REQUIRE( maxDifference( serial, threaded ) == 0 );
+	}
+
+	SECTION( "blurring in place matches the copy across tiles and bands" )
+	{
+		Surface8u src( 37, 523, true );
+		fillRandom( &src, 1234 );
+		for( int threads : { 1, 3, 0 } ) {
+			Surface8u copy = ip::gaussianBlurCopy( src, 3.0f, ip::Options().threads( threads ) );
+			Surface8u inPlace = src.clone();
+			ip::gaussianBlur( &inPlace, 3.0f, ip::Options().threads( threads ) );
+			REQUIRE( inPlace.getData() != src.getData() );
+			for( int32_t y = 0; y < src.getHeight(); ++y )
+				REQUIRE( memcmp( copy.getData( ivec2( 0, y ) ), inPlace.getData( ivec2( 0, y ) ), src.getWidth() * src.getPixelBytes() ) == 0 );
+
+			Channel32f channel( 19, 611 );
+			fillRandom( &channel, 5678 );
+			Channel32f boxCopy = ip::boxBlurCopy( channel, 20, 3, ip::Options().threads( threads ) );
+			ip::boxBlur( &channel, 20, 3, ip::Options().threads( threads ) );
+			REQUIRE( maxDifference( boxCopy, channel ) == 0 );
+		}
+	}
+}
+
+TEST_CASE( "ip/Blur/benchmark", "[.][benchmark]" )
+{
+	Surface8u src( 3840, 2160, true );
+	ip::fill( &src, ColorA8u( 30, 60, 90, 255 ) );
+
+	for( int radius : { 4, 16, 64 } ) {
+		Timer timer( true );
+		Surface8u stack = ip::stackBlurCopy( src, radius );
+		CI_LOG_I( "stackBlur, radius " << radius << ": " << timer.getSeconds() * 1000.0 << " ms" );
+
+		for( int threads : { 1, 4, 0 } ) {
+			timer.start();
+			Surface8u box = ip::boxBlurCopy( src, radius / 2, 3, ip::Options().threads( threads ) );
+			CI_LOG_I( "boxBlur x3, radius " << radius / 2 << ", " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+		}
+	}
+}
@@ -0,0 +1,243 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ip/Convolve.h"
+#include "cinder/ip/EdgeDetect.h"
+#include "cinder/Timer.h"
+#include "cinder/Log.h"
+
+#include <cmath>
+
+using namespace ci;
+
+namespace {
+
+int32_t referenceBorderIndex( int32_t i, int32_t n, ip::BorderMode border )
+{
+	if( i >= 0 && i < n )
+		return i;
+	switch( border ) {
+		case ip::BorderMode::CLAMP: return std::min( std::max( i, 0 ), n - 1 );
+		case ip::BorderMode::WRAP: return ( ( i % n ) + n ) % n;
+		case ip::BorderMode::MIRROR: {
+			while( i < 0 || i >= n )
+				i = ( i < 0 ) ? -i : 2 * ( n - 1 ) - i;
+			return i;
+		}
+		default: return -1;
+	}
+}
+
+// brute-force convolution in double precision, for reference
+template<typename T>
+std::vector<double> referenceConvolve( const ChannelT<T> &src, const ip::ConvolutionKernel &kernel, ip::BorderMode border )
+{
+	std::vector<double> result( src.getWidth() * src.getHeight() );
+	for( int32_t y = 0; y < src.getHeight(); ++y ) {
+		for( int32_t x = 0; x < src.getWidth(); ++x ) {
+			double sum = kernel.getBias();
+			for( int32_t ky = 0; ky < kernel.getHeight(); ++ky ) {
+				for( int32_t kx = 0; kx < kernel.getWidth(); ++kx ) {
+					int32_t sx = referenceBorderIndex( x + kx - kernel.getRadiusX(), src.getWidth(), border );
+					int32_t sy = referenceBorderIndex( y + ky - kernel.getRadiusY(), src.getHeight(), border );
+					if( sx >= 0 && sy >= 0 )
+						sum += kernel.getWeights()[ky * kernel.getWidth() + kx] * (double)*src.getData( sx, sy );
+				}
+			}
+			result[y * src.getWidth() + x] = sum;
+		}
+	}
+	return result;
+}
+
+// returns the largest difference between \a channel and \a reference, after rounding and clamping \a reference like convolve()
+template<typename T>
+double maxDifference( const ChannelT<T> &channel, const std::vector<double> &reference )
+{
+	double result = 0;
+	for( int32_t y = 0; y < channel.getHeight(); ++y ) {
+		for( int32_t x = 0; x < channel.getWidth(); ++x ) {
+			double expected = reference[y * channel.getWidth() + x];
+			if( std::is_integral<T>::value )
+				expected = std::min<double>( std::max<double>( std::floor( expected + 0.5 ), 0 ), std::numeric_limits<T>::max() );
+			result = std::max( result, std::abs( *channel.getData( x, y ) - expected ) );
+		}
+	}
+	return result;
+}
+
+template<typename T>
+bool channelsEqual( const ChannelT<T> &a, const ChannelT<T> &b )
+{
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( *a.getData( x, y ) != *b.getData( x, y ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+std::vector<ip::ConvolutionKernel> testKernels()
+{
+	return {
+		ip::ConvolutionKernel( 3, 3, { 0, -1, 0, -1, 5, -1, 0, -1, 0 } ),
+		ip::ConvolutionKernel( 3, 3, { 1, 2, 1, 2, 4, 2, 1, 2, 1 } ).normalize(),
+		ip::ConvolutionKernel( 5, 5, { 1, 0, 2, 0, 1,  0, 3, 0, 3, 0,  -1, 0, 4, 0, -1,  0, 3, 0, 3, 0,  1, 0, 2, 0, 1 } ).normalize(),
+		ip::ConvolutionKernel( 5, 3, { 1, 2, 3, 2, 1,  0, 1, -8, 1, 0,  1, 2, 3, 2, 1 }, 0.25f ),
+		ip::ConvolutionKernel( 5, 1, { 1, 4, 6, 4, 1 } ).normalize(),
+		ip::ConvolutionKernel::separable( { 1, 6, 15, 20, 15, 6, 1 }, { 1, 2, 1 } ).normalize(),
+		ip::ConvolutionKernel::sobelX()
+	};
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Convolve" )
+{
+	SECTION( "separable kernels are detected" )
+	{
+		REQUIRE( ip::ConvolutionKernel::sobelX().isSeparable() );
+		REQUIRE( ip::ConvolutionKernel::sobelY().isSeparable() );
+		REQUIRE( ip::ConvolutionKernel( 3, 3, { 1, 2, 1, 2, 4, 2, 1, 2, 1 } ).isSeparable() );
+		REQUIRE_FALSE( ip::ConvolutionKernel( 3, 3, { 0, -1, 0, -1, 5, -1, 0, -1, 0 } ).isSeparable() );
+		REQUIRE_FALSE( ip::ConvolutionKernel( 5, 1, { 1, 4, 6, 4, 1 } ).isSeparable() );
+
+		ip::ConvolutionKernel gaussian = ip::ConvolutionKernel::separable( { 1, 2, 1 }, { 1, 4, 6, 4, 1 } ).normalize();
+		REQUIRE( gaussian.getWidth() == 3 );
+		REQUIRE( gaussian.getHeight() == 5 );
+		REQUIRE( gaussian.getWeights()[1 * 3 + 1] == Approx( 8 / 64.0f ) );
+	}
+
+	SECTION( "channels match brute force for every border mode" )
+	{
+		Channel8u channel8u( 37, 23 );
+		fillRandom( &channel8u, 1 );
+		Channel16u channel16u( 37, 23 );
+		fillRandom( &channel16u, 2 );
+		Channel32f channel32f( 37, 23 );
+		fillRandom( &channel32f, 3 );
+
+		for( const auto &kernel : testKernels() ) {
+			for( auto border : { ip::BorderMode::CLAMP, ip::BorderMode::MIRROR, ip::BorderMode::WRAP, ip::BorderMode::ZERO } ) {
+				Channel8u result8u( 37, 23 );
+				ip::convolve( channel8u, kernel, &result8u, border );
+				REQUIRE( maxDifference( result8u, referenceConvolve( channel8u, kernel, border ) ) <= 1 );
+
+				Channel16u result16u( 37, 23 );
+				ip::convolve( channel16u, kernel, &result16u, border );
+				REQUIRE( maxDifference( result16u, referenceConvolve( channel16u, kernel, border ) ) <= 1 );
+
+				Channel32f result32f( 37, 23 );
+				ip::convolve( channel32f, kernel, &result32f, border );
+				REQUIRE( maxDifference( result32f, referenceConvolve( channel32f, kernel, border ) ) < 1e-4 );
+			}
+		}
+	}
+
+	SECTION( "surfaces convolve each channel" )
+	{
+		Surface8u surface = randomSurface<uint8_t>( 29, 17, SurfaceChannelOrder::RGBA, 9 );
+		Surface8u dst( 29, 17, true, SurfaceChannelOrder::BGRA );
+
+		const ip::ConvolutionKernel kernel = ip::ConvolutionKernel( 5, 5, { 1, 0, 2, 0, 1,  0, 3, 0, 3, 0,  -1, 0, 4, 0, -1,  0, 3, 0, 3, 0,  1, 0, 2, 0, 1 } ).normalize();
+		ip::convolve( surface, kernel, &dst, ip::BorderMode::MIRROR, ip::Options().threads( 3 ) );
+		REQUIRE( maxDifference( dst.getChannelRed(), referenceConvolve( Channel8u( surface.getChannelRed() ), kernel, ip::BorderMode::MIRROR ) ) <= 1 );
+		REQUIRE( maxDifference( dst.getChannelGreen(), referenceConvolve( Channel8u( surface.getChannelGreen() ), kernel, ip::BorderMode::MIRROR ) ) <= 1 );
+		REQUIRE( maxDifference( dst.getChannelBlue(), referenceConvolve( Channel8u( surface.getChannelBlue() ), kernel, ip::BorderMode::MIRROR ) ) <= 1 );
+		REQUIRE( maxDifference( dst.getChannelAlpha(), referenceConvolve( Channel8u( surface.getChannelAlpha() ), kernel, ip::BorderMode::MIRROR ) ) <= 1 );
+
+		// surfaces sharing a channel order are converted whole rows at a time, which must agree with the per-channel path
+		Surface8u sameOrder( 29, 17, true, SurfaceChannelOrder::RGBA );
+		ip::convolve( surface, kernel, &sameOrder, ip::BorderMode::MIRROR );
+		REQUIRE( channelsEqual( Channel8u( sameOrder.getChannelRed() ), Channel8u( dst.getChannelRed() ) ) );
+		REQUIRE( channelsEqual( Channel8u( sameOrder.getChannelAlpha() ), Channel8u( dst.getChannelAlpha() ) ) );
+
+		// a channel view ends before its Surface's last row does, so an in-place copy must not read past it
+		const std::vector<double> alphaReference = referenceConvolve( Channel8u( surface.getChannelAlpha() ), kernel, ip::BorderMode::MIRROR );
+		Channel8u &alpha = surface.getChannelAlpha();
+		ip::convolve( alpha, kernel, &alpha, ip::BorderMode::MIRROR );
+		REQUIRE( maxDifference( surface.getChannelAlpha(), alphaReference ) <= 1 );
+	}
+
+	SECTION( "threaded and in-place results are identical to serial" )
+	{
+		Channel32f channel( 211, 97 );
+		fillRandom( &channel, 4 );
+		for( const auto &kernel : testKernels() ) {
+			Channel32f serial( 211, 97 ), threaded( 211, 97 );
+			ip::convolve( channel, kernel, &serial );
+			ip::convolve( channel, kernel, &threaded, ip::BorderMode::CLAMP, ip::Options().threads( 4 ) );
+			REQUIRE( channelsEqual( serial, threaded ) );
+
+			Channel32f inPlace = channel.clone();
+			ip::convolve( inPlace, kernel, &inPlace, ip::BorderMode::CLAMP, ip::Options().threads( 2 ) );
+			REQUIRE( channelsEqual( serial, inPlace ) );
+		}
+	}
+
+	SECTION( "areas sample beyond their edges" )
+	{
+		Channel8u channel( 40, 30 );
+		fillRandom( &channel, 5 );
+		const ip::ConvolutionKernel kernel( 3, 3, { 0, -1, 0, -1, 5, -1, 0, -1, 0 } );
+		Channel8u full( 40, 30 ), part( 40, 30 );
+		ip::convolve( channel, kernel, &full );
+		for( int32_t y = 0; y < 30; ++y )
+			for( int32_t x = 0; x < 40; ++x )
+				*part.getData( x, y ) = 0;
+		ip::convolve( channel, Area( 10, 5, 30, 25 ), ivec2( 0, 0 ), kernel, &part );
+
+		bool matches = true;
+		for( int32_t y = 0; y < 20; ++y )
+			for( int32_t x = 0; x < 20; ++x )
+				matches = matches && ( *part.getData( x, y ) == *full.getData( x + 10, y + 5 ) );
+		REQUIRE( matches );
+		REQUIRE( *part.getData( 25, 25 ) == 0 );
+	}
+
+	SECTION( "sobel matches the gradient magnitude" )
+	{
+		Channel8u channel( 64, 48 ), edges( 64, 48 );
+		fillRandom( &channel, 6 );
+		ip::edgeDetectSobel( channel, &edges, ip::Options().threads( 2 ) );
+
+		auto gx = referenceConvolve( channel, ip::ConvolutionKernel::sobelX(), ip::BorderMode::CLAMP );
+		auto gy = referenceConvolve( channel, ip::ConvolutionKernel::sobelY(), ip::BorderMode::CLAMP );
+		std::vector<double> magnitude( gx.size() );
+		for( size_t i = 0; i < gx.size(); ++i )
+			magnitude[i] = std::sqrt( gx[i] * gx[i] + gy[i] * gy[i] );
+		REQUIRE( maxDifference( edges, magnitude ) <= 1 );
+
+		// a vertical step edge
+		Channel32f step( 16, 16 ), stepEdges( 16, 16 );
+		for( int32_t y = 0; y < 16; ++y )
+			for( int32_t x = 0; x < 16; ++x )
+				*step.getData( x, y ) = ( x < 8 ) ? 0.0f : 0.125f;
+		ip::edgeDetectSobel( step, &stepEdges );
+		REQUIRE( *stepEdges.getData( 7, 8 ) == Approx( 0.5f ) );
+		REQUIRE( *stepEdges.getData( 8, 8 ) == Approx( 0.5f ) );
+		REQUIRE( *stepEdges.getData( 3, 8 ) == 0 );
+		REQUIRE( *stepEdges.getData( 12, 0 ) == 0 );
+	}
+}
+
+TEST_CASE( "ip/Convolve/benchmark", "[.][benchmark]" )
+{
+	Channel8u channel( 1920, 1080 ), dst( 1920, 1080 );
+	fillRandom( &channel, 1 );
+	const ip::ConvolutionKernel sharpen( 3, 3, { 0, -1, 0, -1, 5, -1, 0, -1, 0 } );
+	const ip::ConvolutionKernel gaussian = ip::ConvolutionKernel::separable( { 1, 4, 6, 4, 1 }, { 1, 4, 6, 4, 1 } ).normalize();
+
+	for( int threads : { 1, 0 } ) {
+		Timer timer( true );
+		ip::edgeDetectSobel( channel, &dst, ip::Options().threads( threads ) );
+		CI_LOG_I( "edgeDetectSobel, " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+		timer.start();
+		ip::convolve( channel, sharpen, &dst, ip::BorderMode::CLAMP, ip::Options().threads( threads ) );
+		CI_LOG_I( "convolve 3x3, " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+		timer.start();
+		ip::convolve( channel, gaussian, &dst, ip::BorderMode::CLAMP, ip::Options().threads( threads ) );
+		CI_LOG_I( "convolve 5x5 separable, " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+	}
+}
@@ -0,0 +1,205 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ip/IntegralImage.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/ip/Blur.h"
+#include "cinder/Timer.h"
+#include "cinder/Log.h"
+
+#include <cmath>
+
+using namespace ci;
+
+namespace {
+
+template<typename T>
+double bruteForceSum( const ChannelT<T> &channel, const Area &area, bool squared )
+{
+	double result = 0;
+	for( int32_t y = area.y1; y < area.y2; ++y ) {
+		for( int32_t x = area.x1; x < area.x2; ++x ) {
+			double v = *channel.getData( x, y );
+			result += squared ? v * v : v;
+		}
+	}
+	return result;
+}
+
+// the single-threaded algorithm adaptiveThreshold() used before IntegralImage, for reference
+Channel8u referenceAdaptiveThreshold( const Channel8u &src, int32_t windowSize, float percentageDelta )
+{
+	const int32_t w = src.getWidth(), h = src.getHeight();
+	std::vector<uint32_t> integral( w * h );
+	for( int32_t y = 0; y < h; ++y ) {
+		uint32_t rowSum = 0;
+		for( int32_t x = 0; x < w; ++x ) {
+			rowSum += *src.getData( x, y );
+			integral[y * w + x] = rowSum + ( y > 0 ? integral[(y - 1) * w + x] : 0 );
+		}
+	}
+
+	Channel8u result( w, h );
+	const int32_t s2 = windowSize / 2;
+	const uint32_t comparisonMult = (uint32_t)( 256 * ( 1.0f - percentageDelta ) );
+	for( int32_t j = 0; j < h; ++j ) {
+		for( int32_t i = 0; i < w; ++i ) {
+			int32_t x1 = std::max( 0, i - s2 ), x2 = std::min( w - 1, i + s2 );
+			int32_t y1 = std::max( 0, j - s2 ), y2 = std::min( h - 1, j + s2 );
+			int32_t count = ( x2 - x1 ) * ( y2 - y1 );
+			uint32_t sum = integral[y2 * w + x2] - integral[y1 * w + x2] - integral[y2 * w + x1] + integral[y1 * w + x1];
+			*result.getData( i, j ) = ( (uint32_t)( *src.getData( i, j ) * count ) < ( sum * comparisonMult / 256 ) ) ? 0 : 255;
+		}
+	}
+
+	return result;
+}
+
+template<typename T>
+bool channelsEqual( const ChannelT<T> &a, const ChannelT<T> &b )
+{
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			if( *a.getData( x, y ) != *b.getData( x, y ) )
+				return false;
+		}
+	}
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/IntegralImage" )
+{
+	SECTION( "rectangle sums match brute force" )
+	{
+		Channel8u channel8u( 97, 61 );
+		fillRandom( &channel8u, 1234 );
+		ip::IntegralImage8u integral8u( channel8u, true );
+		Channel32f channel32f( 97, 61 );
+		fillRandom( &channel32f, 1234 );
+		ip::IntegralImage32f integral32f( channel32f, true );
+
+		REQUIRE( integral8u.getSize() == ivec2( 97, 61 ) );
+		const Area areas[] = { Area( 0, 0, 97, 61 ), Area( 0, 0, 1, 1 ), Area( 13, 7, 50, 44 ), Area( 96, 60, 97, 61 ), Area( 40, 20, 41, 60 ) };
+		for( const Area &area : areas ) {
+			REQUIRE( integral8u.getSum( area ) == (uint32_t)bruteForceSum( channel8u, area, false ) );
+			REQUIRE( integral8u.getSquaredSum( area ) == (uint64_t)bruteForceSum( channel8u, area, true ) );
+			REQUIRE( integral32f.getSum( area ) == Approx( bruteForceSum( channel32f, area, false ) ) );
+			REQUIRE( integral32f.getSquaredSum( area ) == Approx( bruteForceSum( channel32f, area, true ) ) );
+
+			double count = (double)area.calcArea();
+			double mean = bruteForceSum( channel8u, area, false ) / count;
+			REQUIRE( integral8u.getMean( area ) == Approx( mean ) );
+			REQUIRE( integral8u.getVariance( area ) == Approx( bruteForceSum( channel8u, area, true ) / count - mean * mean ).margin( 1e-9 ) );
+		}
+
+		// areas are clipped to the image
+		REQUIRE( integral8u.getSum( Area( -10, -10, 200, 200 ) ) == integral8u.getSum( integral8u.getBounds() ) );
+		REQUIRE( integral8u.getSum( Area( 200, 200, 300, 300 ) ) == 0 );
+		REQUIRE( integral8u.getMean( Area( 200, 200, 300, 300 ) ) == 0 );
+	}
+
+	SECTION( "threaded build is identical to serial" )
+	{
+		Channel16u channel( 333, 211 );
+		fillRandom( &channel, 42 );
+
+		ip::IntegralImage16u serial( channel, true ), threaded( channel, true, ip::Options().threads( 4 ) );
+		const size_t count = ( channel.getWidth() + 1 ) * ( channel.getHeight() + 1 );
+		REQUIRE( std::equal( serial.getSums(), serial.getSums() + count, threaded.getSums() ) );
+		REQUIRE( std::equal( serial.getSquaredSums(), serial.getSquaredSums() + count, threaded.getSquaredSums() ) );
+
+		ip::IntegralImage16u withoutSquares( channel );
+		REQUIRE_FALSE( withoutSquares.hasSquaredSums() );
+		REQUIRE( withoutSquares.getSquaredSums() == nullptr );
+	}
+
+	SECTION( "adaptive threshold is unchanged" )
+	{
+		Channel8u channel( 160, 90 );
+		fillRandom( &channel, 99 );
+		Channel8u reference = referenceAdaptiveThreshold( channel, 15, 0.15f );
+
+		Channel8u serial( 160, 90 ), threaded( 160, 90 ), shared( 160, 90 );
+		ip::adaptiveThreshold( channel, 15, 0.15f, &serial );
+		ip::adaptiveThreshold( channel, 15, 0.15f, &threaded, ip::Options().threads( 3 ) );
+		ip::IntegralImage8u integral( channel );
+		ip::adaptiveThreshold( channel, integral, 15, 0.15f, &shared );
+		REQUIRE( channelsEqual( serial, reference ) );
+		REQUIRE( channelsEqual( threaded, reference ) );
+		REQUIRE( channelsEqual( shared, reference ) );
+
+		ip::AdaptiveThresholdT<uint8_t> adaptive( &channel );
+		Channel8u calculated( 160, 90 );
+		adaptive.calculate( 15, 0.15f, &calculated );
+		REQUIRE( channelsEqual( calculated, reference ) );
+	}
+
+	SECTION( "box blur matches clipped brute force" )
+	{
+		Channel8u channel( 71, 53 );
+		fillRandom( &channel, 7 );
+		ip::IntegralImage8u integral( channel );
+		Channel8u blurred( 71, 53 );
+		const int radius = 4;
+		ip::boxBlur( integral, radius, &blurred, ip::Options().threads( 2 ) );
+
+		bool matches = true;
+		for( int32_t y = 0; y < channel.getHeight(); ++y ) {
+			for( int32_t x = 0; x < channel.getWidth(); ++x ) {
+				Area window = Area( x - radius, y - radius, x + radius + 1, y + radius + 1 ).getClipBy( channel.getBounds() );
+				double mean = bruteForceSum( channel, window, false ) / window.calcArea();
+				matches = matches && ( std::abs( (double)*blurred.getData( x, y ) - mean ) <= 0.5 );
+			}
+		}
+		REQUIRE( matches );
+	}
+
+	SECTION( "local contrast normalization" )
+	{
+		Channel32f channel( 64, 48 );
+		fillRandom( &channel, 31 );
+		Channel32f normalized( 64, 48 );
+		ip::normalizeLocalContrast( channel, 5, &normalized );
+
+		// z-scores over the full window of an interior pixel average to ~0 with unit variance
+		double sum = 0, squaredSum = 0;
+		int count = 0;
+		for( int32_t y = 10; y < 38; ++y ) {
+			for( int32_t x = 10; x < 54; ++x, ++count ) {
+				sum += *normalized.getData( x, y );
+				squaredSum += *normalized.getData( x, y ) * *normalized.getData( x, y );
+			}
+		}
+		REQUIRE( std::abs( sum / count ) < 0.1 );
+		REQUIRE( squaredSum / count == Approx( 1.0 ).epsilon( 0.2 ) );
+
+		// constant input has no contrast and maps to the midpoint
+		Channel8u flat( 32, 32 ), flatNormalized( 32, 32 );
+		for( int32_t y = 0; y < 32; ++y )
+			for( int32_t x = 0; x < 32; ++x )
+				*flat.getData( x, y ) = 77;
+		ip::normalizeLocalContrast( flat, 3, &flatNormalized );
+		REQUIRE( *flatNormalized.getData( 0, 0 ) == 128 );
+		REQUIRE( *flatNormalized.getData( 16, 16 ) == 128 );
+	}
+}
+
+TEST_CASE( "ip/IntegralImage/benchmark", "[.][benchmark]" )
+{
+	Channel8u channel( 1920, 1080 ), dst( 1920, 1080 );
+	fillRandom( &channel, 1 );
+
+	for( int threads : { 1, 0 } ) {
+		Timer timer( true );
+		ip::IntegralImage8u integral( channel, true, ip::Options().threads( threads ) );
+		CI_LOG_I( "IntegralImage build, " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+		timer.start();
+		ip::adaptiveThreshold( channel, integral, 31, 0.1f, &dst, ip::Options().threads( threads ) );
+		CI_LOG_I( "adaptiveThreshold, " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+		timer.start();
+		ip::boxBlur( integral, 15, &dst, ip::Options().threads( threads ) );
+		CI_LOG_I( "boxBlur (integral), radius 15, " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+	}
+}
@@ -0,0 +1,150 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ip/Pipeline.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/ip/Flip.h"
+#include "cinder/ip/Grayscale.h"
+#include "cinder/ip/Premultiply.h"
+#include "cinder/ip/Threshold.h"
+#include "cinder/Timer.h"
+#include "cinder/Log.h"
+
+using namespace ci;
+
+namespace {
+
+// compares pixel values, so the surfaces may have different channel orders
+template<typename T>
+bool samePixels( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() )
+		return false;
+
+	const bool compareAlpha = a.hasAlpha() && b.hasAlpha();
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		for( int32_t x = 0; x < a.getWidth(); ++x ) {
+			const ColorAT<T> pa = a.getPixel( ivec2( x, y ) ), pb = b.getPixel( ivec2( x, y ) );
+			if( pa.r != pb.r || pa.g != pb.g || pa.b != pb.b || ( compareAlpha && pa.a != pb.a ) )
+				return false;
+		}
+	}
+
+	return true;
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Pipeline" )
+{
+	Surface8u src( 131, 97, true, SurfaceChannelOrder::BGRA );
+	fillRandom( &src, 1234 );
+
+	SECTION( "matches the standalone ip functions applied in turn" )
+	{
+		Surface8u expected = src.clone();
+		ip::grayscale( expected, &expected );
+		ip::threshold( &expected, (uint8_t)128 );
+		ip::flipVertical( &expected );
+
+		Surface8u result = ip::Pipeline( src ).grayscale().threshold( 128 ).flipVertical().run();
+		REQUIRE( result.getChannelOrder().getCode() == src.getChannelOrder().getCode() );
+		REQUIRE( samePixels( result, expected ) );
+	}
+
+	SECTION( "premultiply, unpremultiply and horizontal flips" )
+	{
+		Surface8u expected = src.clone();
+		ip::premultiply( &expected );
+		ip::flipHorizontal( &expected );
+
+		Surface8u result = ip::Pipeline( src ).premultiply().flipHorizontal().run();
+		REQUIRE( result.isPremultiplied() );
+		REQUIRE( samePixels( result, expected ) );
+
+		ip::unpremultiply( &expected );
+		ip::Pipeline( result ).unpremultiply().run( &result );
+		REQUIRE( ! result.isPremultiplied() );
+		REQUIRE( samePixels( result, expected ) );
+	}
+
+	SECTION( "writes into a destination with a different channel order" )
+	{
+		Surface8u expected = src.clone();
+		ip::grayscale( expected, &expected );
+
+		Surface8u dst( src.getWidth(), src.getHeight(), false, SurfaceChannelOrder::RGB );
+		ip::Pipeline( src ).grayscale().run( &dst );
+		REQUIRE( samePixels( dst, expected ) );
+	}
+
+	SECTION( "fill discards earlier operations" )
+	{
+		Surface8u result = ip::Pipeline( src ).grayscale().fill( ColorA8u( 10, 20, 30, 40 ) ).threshold( 15 ).run();
+		Surface8u expected( src.getWidth(), src.getHeight(), true, SurfaceChannelOrder::BGRA );
+		ip::fill( &expected, ColorA8u( 0, 255, 255, 40 ) );
+		REQUIRE( samePixels( result, expected ) );
+	}
+
+	SECTION( "in-place with a vertical flip" )
+	{
+		Surface8u expected = src.clone();
+		ip::flipVertical( &expected );
+		ip::threshold( &expected, (uint8_t)100 );
+
+		Surface8u inPlace = src.clone();
+		ip::Pipeline( inPlace ).flipVertical().threshold( 100 ).run( &inPlace, ip::Options().threads( 3 ) );
+		REQUIRE( samePixels( inPlace, expected ) );
+	}
+
+	SECTION( "threaded output matches serial" )
+	{
+		Surface8u wide( 1200, 300, false );
+		fillRandom( &wide, 1234 );
+		ip::Pipeline pipeline( wide );
+		pipeline.grayscale().flipVertical().flipHorizontal().threshold( 90 );
+		Surface8u serial = pipeline.run();
+		for( int threads : { 2, 3, 0 } )
+			REQUIRE( samePixels( serial, pipeline.run( ip::Options().threads( threads ) ) ) );
+	}
+
+	SECTION( "float" )
+	{
+		Surface32f src32f( 33, 21, true );
+		fillRandom( &src32f, 1234 );
+		Surface32f expected = src32f.clone();
+		ip::premultiply( &expected );
+		ip::grayscale( expected, &expected );
+		ip::unpremultiply( &expected );
+
+		Surface32f result = ip::Pipeline32f( src32f ).premultiply().grayscale().unpremultiply().run();
+		REQUIRE( samePixels( result, expected ) );
+	}
+}
+
+TEST_CASE( "ip/Pipeline benchmark", "[.][benchmark]" )
+{
+	Surface8u src( 3840, 2160, true );
+	fillRandom( &src, 1234 );
+
+	// a 12 stage chain, run as separate passes and then fused
+	Timer timer( true );
+	Surface8u separate = src.clone();
+	for( int i = 0; i < 3; ++i ) {
+		ip::premultiply( &separate );
+		ip::grayscale( separate, &separate );
+		ip::unpremultiply( &separate );
+		ip::flipVertical( &separate );
+	}
+	CI_LOG_I( "12 separate passes: " << timer.getSeconds() * 1000 << "ms" );
+
+	ip::Pipeline pipeline( src );
+	for( int i = 0; i < 3; ++i )
+		pipeline.premultiply().grayscale().unpremultiply().flipVertical();
+	for( int threads : { 1, 2, 4, 8 } ) {
+		timer.start();
+		Surface8u fused = pipeline.run( ip::Options().threads( threads ) );
+		CI_LOG_I( "fused, " << threads << " threads: " << timer.getSeconds() * 1000 << "ms" );
+		REQUIRE( samePixels( fused, separate ) );
+	}
+}
@@ -0,0 +1,161 @@
+#include "catch.hpp"
+#include "utils.h"
+
+#include "cinder/ip/Resize.h"
+#include "cinder/ip/Parallel.h"
+#include "cinder/ip/Fill.h"
+#include "cinder/Timer.h"
+#include "cinder/Log.h"
+
+#include <atomic>
+#include <cstring>
+#include <stdexcept>
+#include <vector>
+
+using namespace ci;
+
+namespace {
+
+template<typename T>
+bool identical( const SurfaceT<T> &a, const SurfaceT<T> &b )
+{
+	if( a.getSize() != b.getSize() || a.getPixelBytes() != b.getPixelBytes() )
+		return false;
+
+	for( int32_t y = 0; y < a.getHeight(); ++y ) {
+		if( memcmp( a.getData( ivec2( 0, y ) ), b.getData( ivec2( 0, y ) ), a.getWidth() * a.getPixelBytes() ) != 0 )
+			return false;
+	}
+
+	return true;
+}
+
+template<typename T>
+void checkThreadedMatchesSerial( const SurfaceT<T> &src, const ivec2 &dstSize, const FilterBase &filter )
+{
+	SurfaceT<T> serial = ip::resizeCopy( src, src.getBounds(), dstSize, filter );
+	for( int threads : { 2, 3, 8, 0 } ) {
+		SurfaceT<T> threaded = ip::resizeCopy( src, src.getBounds(), dstSize, filter, ip::Options().threads( threads ) );
+		REQUIRE( identical( serial, threaded ) );
+	}
+}
+
+// resizes each channel of \a src separately as a planar Channel, which goes through the scalar per-channel path
+template<typename T>
+void checkInterleavedMatchesPlanar( const SurfaceT<T> &src, const ivec2 &dstSize, const FilterBase &filter )
+{
+	SurfaceT<T> interleaved = ip::resizeCopy( src, src.getBounds(), dstSize, filter );
+
+	const int numChannels = src.hasAlpha() ? 4 : 3;
+	for( int c = 0; c < numChannels; ++c ) {
+		const ChannelT<T> &srcChannel = ( c == 0 ) ? src.getChannelRed() : ( c == 1 ) ? src.getChannelGreen() : ( c == 2 ) ? src.getChannelBlue() : src.getChannelAlpha();
+		const ChannelT<T> &resultChannel = ( c == 0 ) ? interleaved.getChannelRed() : ( c == 1 ) ? interleaved.getChannelGreen() : ( c == 2 ) ? interleaved.getChannelBlue() : interleaved.getChannelAlpha();
+		ChannelT<T> planarSrc( srcChannel );
+		ChannelT<T> planarDst( dstSize.x, dstSize.y );
+		ip::resize( planarSrc, &planarDst, filter );
+		for( int32_t y = 0; y < dstSize.y; ++y ) {
+			for( int32_t x = 0; x < dstSize.x; ++x )
+				REQUIRE( *planarDst.getData( x, y ) == *resultChannel.getData( x, y ) );
+		}
+	}
+}
+
+} // anonymous namespace
+
+TEST_CASE( "ip/Resize" )
+{
+	SECTION( "threaded resize is identical to serial (8u)" )
+	{
+		Surface8u src( 317, 211, true );
+		fillRandom( &src, 1234 );
+		checkThreadedMatchesSerial( src, ivec2( 101, 67 ), FilterTriangle() );
+		checkThreadedMatchesSerial( src, ivec2( 640, 480 ), FilterGaussian() );
+		checkThreadedMatchesSerial( src, ivec2( 317, 5 ), FilterCubic() );
+	}
+
+	SECTION( "threaded resize is identical to serial (32f)" )
+	{
+		Surface32f src( 129, 97, false );
+		fillRandom( &src, 1234 );
+		checkThreadedMatchesSerial( src, ivec2( 64, 48 ), FilterSincBlackman() );
+		checkThreadedMatchesSerial( src, ivec2( 300, 200 ), FilterTriangle() );
+	}
+
+	SECTION( "interleaved surfaces match per-channel resizing" )
+	{
+		Surface8u rgba( 203, 117, true, SurfaceChannelOrder::BGRA );
+		fillRandom( &rgba, 1234 );
+		checkInterleavedMatchesPlanar( rgba, ivec2( 67, 39 ), FilterTriangle() );
+		checkInterleavedMatchesPlanar( rgba, ivec2( 411, 250 ), FilterCatmullRom() );
+
+		Surface8u rgb( 203, 117, false, SurfaceChannelOrder::RGB );
+		fillRandom( &rgb, 1234 );
+		checkInterleavedMatchesPlanar( rgb, ivec2( 67, 39 ), FilterBox() );
+
+		Surface32f rgbaFloat( 99, 71, true );
+		fillRandom( &rgbaFloat, 1234 );
+		checkInterleavedMatchesPlanar( rgbaFloat, ivec2( 40, 30 ), FilterGaussian() );
+	}
+
+	SECTION( "each channel is filtered independently" )
+	{
+		// upsampling a surface shorter than the filter support must not reuse lines filtered from another channel
+		Surface8u src( 4, 2, false );
+		ip::fill( &src, Color8u( 255, 0, 0 ) );
+		Surface8u dst = ip::resizeCopy( src, src.getBounds(), ivec2( 8, 8 ) );
+		auto iter = dst.getIter();
+		while( iter.line() ) {
+			while( iter.pixel() ) {
+				REQUIRE( iter.r() == 255 );
+				REQUIRE( iter.g() == 0 );
+				REQUIRE( iter.b() == 0 );
+			}
+		}
+	}
+}
+
+TEST_CASE( "ip/parallelForRows" )
+{
+	SECTION( "every row is processed once, including by nested calls" )
+	{
+		std::vector<std::atomic<int>> visits( 97 * 13 );
+		for( auto &v : visits )
+			v = 0;
+
+		ip::parallelForRows( 0, 97, ip::Options().threads( 0 ), [&]( int32_t rowBegin, int32_t rowEnd ) {
+			for( int32_t row = rowBegin; row < rowEnd; ++row ) {
+				ip::parallelForRows( 0, 13, ip::Options().threads( 4 ), [&, row]( int32_t colBegin, int32_t colEnd ) {
+					for( int32_t col = colBegin; col < colEnd; ++col )
+						++visits[row * 13 + col];
+				} );
+			}
+		} );
+
+		for( auto &v : visits )
+			REQUIRE( v == 1 );
+	}
+
+	SECTION( "exceptions are rethrown after every band completes" )
+	{
+		std::atomic<int> numBands( 0 );
+		auto fn = [&]( int32_t rowBegin, int32_t rowEnd ) {
+			++numBands;
+			if( rowBegin == 0 )
+				throw std::runtime_error( "band failed" );
+		};
+		REQUIRE_THROWS_AS( ip::parallelForRows( 0, 64, ip::Options().threads( 8 ), fn ), std::runtime_error );
+		REQUIRE( numBands == 8 );
+	}
+}
+
+TEST_CASE( "ip/Resize/benchmark", "[.][benchmark]" )
+{
+	Surface8u src( 7680, 4320, true );
+	fillRandom( &src, 1234 );
+
+	for( int threads : { 1, 2, 4, 8, 16 } ) {
+		Timer timer( true );
+		Surface8u dst = ip::resizeCopy( src, src.getBounds(), ivec2( 1920, 1080 ), FilterTriangle(), ip::Options().threads( threads ) );
+		CI_LOG_I( "8K -> 1080p, " << threads << " thread(s): " << timer.getSeconds() * 1000.0 << " ms" );
+	}
+}
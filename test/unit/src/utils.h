@@ -0,0 +1,57 @@
+#pragma once
+
+#include "cinder/Channel.h"
+#include "cinder/Surface.h"
+#include "cinder/Rand.h"
+
+#include <limits>
+#include <type_traits>
+
+// Fills every channel of surface with random values in [0, 1], converted to T
+template<typename T>
+inline void fillRandom( ci::SurfaceT<T> *surface, uint32_t seed )
+{
+	ci::Rand rnd( seed );
+	auto iter = surface->getIter();
+	while( iter.line() ) {
+		while( iter.pixel() ) {
+			iter.r() = ci::CHANTRAIT<T>::convert( rnd.nextFloat() );
+			iter.g() = ci::CHANTRAIT<T>::convert( rnd.nextFloat() );
+			iter.b() = ci::CHANTRAIT<T>::convert( rnd.nextFloat() );
+			if( surface->hasAlpha() )
+				iter.a() = ci::CHANTRAIT<T>::convert( rnd.nextFloat() );
+		}
+	}
+}
+
+// Fills channel with random values: any value of T for integer types, [0, 1) for floats
+template<typename T>
+inline void fillRandom( ci::ChannelT<T> *channel, uint32_t seed )
+{
+	ci::Rand rnd( seed );
+	for( int32_t y = 0; y < channel->getHeight(); ++y ) {
+		for( int32_t x = 0; x < channel->getWidth(); ++x ) {
+			if( std::is_integral<T>::value )
+				*channel->getData( x, y ) = (T)rnd.nextInt( (int32_t)std::numeric_limits<T>::max() + 1 );
+			else
+				*channel->getData( x, y ) = (T)rnd.nextFloat();
+		}
+	}
+}
+
+// Returns a surface with the channels of order, whose samples are random values of T, which should be an integer type
+template<typename T>
+inline ci::SurfaceT<T> randomSurface( int32_t width, int32_t height, ci::SurfaceChannelOrder order, uint32_t seed )
+{
+	ci::SurfaceT<T> result( width, height, order.hasAlpha(), order );
+	ci::Rand rnd( seed );
+	const int32_t range = (int32_t)std::numeric_limits<T>::max() + 1;
+	for( int32_t y = 0; y < height; ++y ) {
+		for( int32_t x = 0; x < width; ++x ) {
+			T *pixel = result.getData( ci::ivec2( x, y ) );
+			for( uint8_t c = 0; c < result.getPixelInc(); ++c )
+				pixel[c] = (T)rnd.nextInt( range );
+		}
+	}
+	return result;
+}